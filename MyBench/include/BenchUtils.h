@@ -0,0 +1,130 @@
+// ======================================================================
+#ifndef __BENCH_UTILS_H__
+#define __BENCH_UTILS_H__
+// ======================================================================
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+// ======================================================================
+
+// 基准程序公用的计时与结果输出
+namespace Bench
+{
+    typedef std::chrono::high_resolution_clock Clock;
+
+    // 计时循环的结果写到这里，避免被编译器整个优化掉
+    inline volatile double g_sink = 0.0;
+
+    // 自检：条件不成立时输出失败项
+    inline bool Check(bool condition, const char *what)
+    {
+        if (!condition)
+            printf("[FAIL] %s\n", what);
+        return condition;
+    }
+
+    // 重复 repeat 次取最快一次，返回单次操作耗时（ns）
+    template <typename Fn>
+    double TimeNsPerOp(size_t ops, int repeat, Fn fn)
+    {
+        double best = 1e30;
+        for (int r = 0; r < repeat; ++r)
+        {
+            Clock::time_point start = Clock::now();
+            fn();
+            double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            if (ns < best)
+                best = ns;
+        }
+        return best / (double)ops;
+    }
+
+    // 进程启动以来的堆分配次数（operator new 各形式），由 AllocCounter.cpp 提供，只有链接了它的基准可用
+    size_t GetAllocationCount();
+
+    // 命令行中是否带有某个开关
+    inline bool HasFlag(int argc, char **argv, const char *flag)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            if (strcmp(argv[i], flag) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    // 取 "--name value" 形式的参数，没有时返回 fallback
+    inline const char *GetOption(int argc, char **argv, const char *name, const char *fallback)
+    {
+        for (int i = 1; i + 1 < argc; ++i)
+        {
+            if (strcmp(argv[i], name) == 0)
+                return argv[i + 1];
+        }
+        return fallback;
+    }
+
+    // ======================================================================
+    // 结果记录：表格（人读）/ CSV / JSON（回归比对脚本读）
+    // ======================================================================
+    struct Result
+    {
+        std::string name;
+        size_t batch;    // 每次调用处理的元素数（单个运算为 1）
+        double nsPerOp;  // 单个元素耗时
+    };
+
+    class Report
+    {
+    public:
+        void Add(const std::string &name, size_t batch, double nsPerOp)
+        {
+            Result r = {name, batch, nsPerOp};
+            m_results.push_back(r);
+        }
+
+        const std::vector<Result> &GetResults() const { return m_results; }
+
+        // format: "table" / "csv" / "json"
+        void Write(FILE *file, const char *format, const char *path) const
+        {
+            if (strcmp(format, "csv") == 0)
+            {
+                fprintf(file, "name,path,batch,ns_per_op,mops_per_sec\n");
+                for (size_t i = 0; i < m_results.size(); ++i)
+                {
+                    const Result &r = m_results[i];
+                    fprintf(file, "%s,%s,%zu,%.4f,%.4f\n", r.name.c_str(), path, r.batch, r.nsPerOp, 1e3 / r.nsPerOp);
+                }
+            }
+            else if (strcmp(format, "json") == 0)
+            {
+                fprintf(file, "{\n  \"path\": \"%s\",\n  \"results\": [\n", path);
+                for (size_t i = 0; i < m_results.size(); ++i)
+                {
+                    const Result &r = m_results[i];
+                    fprintf(file, "    {\"name\": \"%s\", \"batch\": %zu, \"ns_per_op\": %.4f, \"mops_per_sec\": %.4f}%s\n",
+                            r.name.c_str(), r.batch, r.nsPerOp, 1e3 / r.nsPerOp, i + 1 < m_results.size() ? "," : "");
+                }
+                fprintf(file, "  ]\n}\n");
+            }
+            else
+            {
+                fprintf(file, "%-32s %10s %12s %12s\n", "name", "batch", "ns/op", "Mops/s");
+                for (size_t i = 0; i < m_results.size(); ++i)
+                {
+                    const Result &r = m_results[i];
+                    fprintf(file, "%-32s %10zu %12.3f %12.2f\n", r.name.c_str(), r.batch, r.nsPerOp, 1e3 / r.nsPerOp);
+                }
+            }
+        }
+
+    private:
+        std::vector<Result> m_results;
+    };
+}
+
+#endif // __BENCH_UTILS_H__
@@ -0,0 +1,47 @@
+// ======================================================================
+#ifndef __STDAFX_H__
+#define __STDAFX_H__
+// ======================================================================
+// MyBench 预编译头替身
+// 基准程序在无窗口环境（Linux/CI）下直接编译引擎数学源码，
+// 这里只提供 Win32 基础类型与数学库，不引入 windows.h / OpenGL
+// ======================================================================
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+typedef float FLOAT;
+typedef int INT;
+typedef int BOOL;
+typedef unsigned int UINT;
+typedef unsigned long DWORD;
+#ifndef TRUE
+#define TRUE 1
+#endif
+#ifndef FALSE
+#define FALSE 0
+#endif
+#endif
+
+// ======================================================================
+// C++标准库 头文件
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+// ======================================================================
+// 数学库
+#include "Math/MathUtils.h"
+#include "Math/Vector2.h"
+#include "Math/Vector3.h"
+#include "Math/Vector4.h"
+#include "Math/Matrix4.h"
+#include "Math/Quaternion.h"
+
+#endif // __STDAFX_H__
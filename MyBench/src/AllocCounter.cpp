@@ -0,0 +1,78 @@
+#include "stdafx.h"
+#include "BenchUtils.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// ======================================================================
+// 替换全局 operator new/delete（普通 / 数组、带大小、nothrow、对齐），统计堆分配次数
+// 单独一个编译单元：替换函数不会内联到调用处，分配与释放在编译器看来始终成对
+// ======================================================================
+
+namespace
+{
+    std::atomic<size_t> g_allocations(0);
+
+    void *CountedAlloc(size_t size)
+    {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        return malloc(size ? size : 1);
+    }
+
+    void *CountedAlignedAlloc(size_t size, std::align_val_t alignment)
+    {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        size_t align = (size_t)alignment;
+        size = (size + align - 1) / align * align; // aligned_alloc 要求大小是对齐的整数倍
+#ifdef _MSC_VER
+        return _aligned_malloc(size ? size : align, align);
+#else
+        return aligned_alloc(align, size ? size : align);
+#endif
+    }
+
+    void AlignedFree(void *p)
+    {
+#ifdef _MSC_VER
+        _aligned_free(p);
+#else
+        free(p);
+#endif
+    }
+
+    void *CheckedAlloc(void *p)
+    {
+        if (!p)
+            throw std::bad_alloc();
+        return p;
+    }
+}
+
+size_t Bench::GetAllocationCount()
+{
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+void *operator new(size_t size) { return CheckedAlloc(CountedAlloc(size)); }
+void *operator new[](size_t size) { return CheckedAlloc(CountedAlloc(size)); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept { return CountedAlloc(size); }
+void *operator new[](size_t size, const std::nothrow_t &) noexcept { return CountedAlloc(size); }
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { free(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { free(p); }
+
+void *operator new(size_t size, std::align_val_t alignment) { return CheckedAlloc(CountedAlignedAlloc(size, alignment)); }
+void *operator new[](size_t size, std::align_val_t alignment) { return CheckedAlloc(CountedAlignedAlloc(size, alignment)); }
+void *operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept { return CountedAlignedAlloc(size, alignment); }
+void *operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept { return CountedAlignedAlloc(size, alignment); }
+
+void operator delete(void *p, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete(void *p, size_t, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete[](void *p, size_t, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete(void *p, std::align_val_t, const std::nothrow_t &) noexcept { AlignedFree(p); }
+void operator delete[](void *p, std::align_val_t, const std::nothrow_t &) noexcept { AlignedFree(p); }
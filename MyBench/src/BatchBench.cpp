@@ -0,0 +1,146 @@
+#include "stdafx.h"
+#include "BenchUtils.h"
+#include "Math/MathBatch.h"
+#include "Math/MathSIMD.h"
+#include <cstring>
+#include <random>
+
+// ======================================================================
+// 批量点/方向/包围盒变换
+//   BatchBench [--quick]
+// 对比逐个 Matrix4 * Vector3、AoS 批量、SoA 批量与多线程拆分
+// ======================================================================
+
+namespace
+{
+    using Bench::TimeNsPerOp;
+
+    bool Near(const Vector3 &a, const Vector3 &b, float eps)
+    {
+        return Math::SIMD::NearlyEqual(&a.x, &b.x, 3, eps);
+    }
+
+    // ======================================================================
+    // 正确性校验
+    // ======================================================================
+    bool Verify(const Matrix4 &m, const std::vector<Vector3> &points)
+    {
+        int failures = 0;
+        size_t count = points.size();
+
+        std::vector<Vector3> aos(count), dirs(count), normals(count);
+        Math::Batch::TransformPoints(m, points.data(), aos.data(), count);
+        Math::Batch::TransformDirections(m, points.data(), dirs.data(), count);
+        Math::Batch::TransformNormals(m, points.data(), normals.data(), count);
+
+        Math::Batch::Vector3SoA soaIn, soaOut;
+        soaIn.FromAoS(points.data(), count);
+        Math::Batch::TransformPoints(m, soaIn, soaOut);
+
+        Matrix4 normalMat = m.InversedAffine().Transposed();
+        for (size_t i = 0; i < count; ++i)
+        {
+            Vector3 ref = m * points[i];
+            Vector4 dir = m * Vector4(points[i].x, points[i].y, points[i].z, 0.0f);
+            Vector4 n = normalMat * Vector4(points[i].x, points[i].y, points[i].z, 0.0f);
+            Vector3 refNormal = Vector3(n.x, n.y, n.z).Normalized();
+
+            if (!Near(ref, aos[i], 1e-5f) || !Near(ref, soaOut.Get(i), 1e-5f))
+                ++failures;
+            if (!Near(Vector3(dir.x, dir.y, dir.z), dirs[i], 1e-5f))
+                ++failures;
+            if (!Near(refNormal, normals[i], 1e-4f))
+                ++failures;
+        }
+
+        // 原地变换
+        std::vector<Vector3> inPlace = points;
+        Math::Batch::TransformPoints(m, inPlace.data(), inPlace.data(), count);
+        if (memcmp(inPlace.data(), aos.data(), count * sizeof(Vector3)) != 0)
+            ++failures;
+
+        // 包围盒：变换后的 AABB 必须包含变换后的 8 个角点
+        AABB local = Math::Batch::ComputeBounds(points.data(), count);
+        AABB localSoA = Math::Batch::ComputeBounds(soaIn);
+        if (!Near(local.min, localSoA.min, 0.0f) || !Near(local.max, localSoA.max, 0.0f))
+            ++failures;
+
+        AABB world = Math::Batch::TransformAABB(m, local);
+        AABB grown = AABB::FromCenterExtents(world.GetCenter(), world.GetExtents() + Vector3(1e-3f));
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            Vector3 p((corner & 1) ? local.max.x : local.min.x,
+                      (corner & 2) ? local.max.y : local.min.y,
+                      (corner & 4) ? local.max.z : local.min.z);
+            if (!grown.Contains(m * p))
+                ++failures;
+        }
+
+        if (failures > 0)
+            printf("[FAIL] %d batch transform mismatches\n", failures);
+        else
+            printf("[ OK ] batch %s kernels match Matrix4 * Vector3\n", Math::SIMD::PathName());
+        return failures == 0;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--quick") == 0)
+            quick = true;
+    }
+
+    std::mt19937 rng(777);
+    std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+
+    Matrix4 m = Matrix4::TRS(Vector3(3.0f, -2.0f, 7.5f),
+                             Quaternion(0.2f, 0.7f, -0.1f, 0.6f).Normalized(),
+                             Vector3(1.5f, 0.5f, 2.0f));
+
+    std::vector<Vector3> check(1027);
+    for (size_t i = 0; i < check.size(); ++i)
+        check[i] = Vector3(dist(rng), dist(rng), dist(rng));
+    if (!Verify(m, check))
+        return 1;
+
+    // 超过并行阈值的批次也要与单线程结果一致
+    std::vector<Vector3> big(Math::Batch::PARALLEL_THRESHOLD * 3 + 5);
+    for (size_t i = 0; i < big.size(); ++i)
+        big[i] = Vector3(dist(rng), dist(rng), dist(rng));
+    if (!Verify(m, big))
+        return 1;
+
+    const size_t sizes[] = {1000, 10000, 100000, 1000000};
+    const int repeat = quick ? 2 : 10;
+
+    printf("%10s %14s %14s %14s\n", "points", "Mat*Vec3", "AoS batch", "SoA batch");
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        size_t count = sizes[s];
+        if (quick && count > 100000)
+            break;
+
+        std::vector<Vector3> in(count), out(count);
+        for (size_t i = 0; i < count; ++i)
+            in[i] = Vector3(dist(rng), dist(rng), dist(rng));
+        Math::Batch::Vector3SoA soaIn, soaOut;
+        soaIn.FromAoS(in.data(), count);
+
+        double single = TimeNsPerOp(count, repeat, [&]() {
+            for (size_t i = 0; i < count; ++i)
+                out[i] = m * in[i];
+        });
+        double aos = TimeNsPerOp(count, repeat, [&]() {
+            Math::Batch::TransformPoints(m, in.data(), out.data(), count);
+        });
+        double soa = TimeNsPerOp(count, repeat, [&]() {
+            Math::Batch::TransformPoints(m, soaIn, soaOut);
+        });
+
+        printf("%10zu %11.2f ns %11.2f ns %11.2f ns\n", count, single, aos, soa);
+    }
+    return 0;
+}
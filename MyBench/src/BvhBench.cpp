@@ -0,0 +1,516 @@
+#include "stdafx.h"
+#include "BenchUtils.h"
+#include "Core/DynamicBVH.h"
+#include "Core/SpatialIndex.h"
+#include "Math/Random.h"
+#include <algorithm>
+#include <cmath>
+
+// ======================================================================
+// CDynamicBVH / CSpatialIndex 正确性与查询耗时
+//   BvhBench [--quick]
+// 校验：插入、移动、删除、批量构建后树结构有效；AABB/球/射线/视锥查询与逐个扫描的结果一致
+//       CSpatialIndex 随 CTransformStore 的世界矩阵同步包围盒，查询按紧包围盒过滤
+// 对比：10k~100k 个物体，逐个扫描与 BVH 查询；逐个插入与批量构建（耗时与表面积比）；
+//       每帧 10% 物体移动时的包围盒同步开销
+// ======================================================================
+
+namespace
+{
+    typedef CDynamicBVH::ProxyId ProxyId;
+
+    const float WORLD_SIZE = 1000.0f;
+
+    AABB RandomBox(Math::RandomGenerator &rng, float maxSize)
+    {
+        Vector3 center = rng.NextVector3(Vector3(-WORLD_SIZE, -50.0f, -WORLD_SIZE), Vector3(WORLD_SIZE, 50.0f, WORLD_SIZE));
+        Vector3 extents = rng.NextVector3(Vector3(0.1f, 0.1f, 0.1f), Vector3(maxSize, maxSize, maxSize));
+        return AABB::FromCenterExtents(center, extents);
+    }
+
+    Frustum MakeFrustum(const Vector3 &eye, const Vector3 &target, float farClip)
+    {
+        Matrix4 view = Matrix4::LookAt(eye, target, Vector3::Up());
+        Matrix4 projection = Matrix4::Perspective(Math::PI / 3.0f, 16.0f / 9.0f, 0.5f, farClip);
+        return Frustum::FromMatrix(projection * view);
+    }
+
+    float RayEnter(const AABB &box, const Vector3 &origin, const Vector3 &direction)
+    {
+        float tMin = 0.0f, tMax = Math::FLOAT_MAX;
+        const float o[3] = {origin.x, origin.y, origin.z};
+        const float d[3] = {direction.x, direction.y, direction.z};
+        const float lo[3] = {box.min.x, box.min.y, box.min.z};
+        const float hi[3] = {box.max.x, box.max.y, box.max.z};
+        for (int i = 0; i < 3; ++i)
+        {
+            float inv = 1.0f / d[i];
+            float t1 = (lo[i] - o[i]) * inv;
+            float t2 = (hi[i] - o[i]) * inv;
+            tMin = std::max(tMin, std::min(t1, t2));
+            tMax = std::min(tMax, std::max(t1, t2));
+        }
+        return tMin <= tMax ? tMin : -1.0f;
+    }
+
+    bool SphereHits(const AABB &box, const Vector3 &center, float radius)
+    {
+        Vector3 closest = Vector3::Max(box.min, Vector3::Min(center, box.max));
+        return (closest - center).LengthSquared() <= radius * radius;
+    }
+
+    // ======================================================================
+    // 树与逐个扫描对比
+    // ======================================================================
+    bool SameSet(std::vector<ProxyId> a, std::vector<ProxyId> b)
+    {
+        std::sort(a.begin(), a.end());
+        std::sort(b.begin(), b.end());
+        return a == b;
+    }
+
+    // 查询结果按放大盒判断，与逐个扫描放大盒一致
+    bool VerifyQueries(const CDynamicBVH &tree, const std::vector<ProxyId> &live, Math::RandomGenerator &rng, const char *stage)
+    {
+        bool ok = true;
+        int wrongBox = 0, wrongSphere = 0, wrongRay = 0, wrongFrustum = 0;
+        for (int q = 0; q < 50; ++q)
+        {
+            AABB box = RandomBox(rng, 100.0f);
+            std::vector<ProxyId> expected, found;
+            for (size_t i = 0; i < live.size(); ++i)
+            {
+                if (tree.GetFatAABB(live[i]).Intersects(box))
+                    expected.push_back(live[i]);
+            }
+            tree.QueryAABB(box, [&](ProxyId id) { found.push_back(id); return true; });
+            wrongBox += SameSet(expected, found) ? 0 : 1;
+
+            Vector3 center = box.GetCenter();
+            float radius = rng.NextFloat(10.0f, 150.0f);
+            expected.clear();
+            found.clear();
+            for (size_t i = 0; i < live.size(); ++i)
+            {
+                if (SphereHits(tree.GetFatAABB(live[i]), center, radius))
+                    expected.push_back(live[i]);
+            }
+            tree.QuerySphere(center, radius, [&](ProxyId id) { found.push_back(id); return true; });
+            wrongSphere += SameSet(expected, found) ? 0 : 1;
+
+            // 射线：最近的放大盒
+            Vector3 origin = rng.NextVector3(Vector3(-WORLD_SIZE, -40.0f, -WORLD_SIZE), Vector3(WORLD_SIZE, 40.0f, WORLD_SIZE));
+            Vector3 direction = rng.NextVector3(Vector3(-1.0f, -0.2f, -1.0f), Vector3(1.0f, 0.2f, 1.0f)).Normalized();
+            float best = 2000.0f;
+            for (size_t i = 0; i < live.size(); ++i)
+            {
+                float t = RayEnter(tree.GetFatAABB(live[i]), origin, direction);
+                if (t >= 0.0f && t < best)
+                    best = t;
+            }
+            float hit = 2000.0f;
+            tree.RayCast(origin, direction, 2000.0f, [&](ProxyId, float enter) {
+                hit = std::min(hit, enter);
+                return enter;
+            });
+            wrongRay += std::fabs(best - hit) <= 1e-3f * std::max(1.0f, best) ? 0 : 1;
+
+            Frustum frustum = MakeFrustum(origin, origin + direction, rng.NextFloat(100.0f, 800.0f));
+            expected.clear();
+            found.clear();
+            for (size_t i = 0; i < live.size(); ++i)
+            {
+                if (frustum.Intersects(tree.GetFatAABB(live[i])))
+                    expected.push_back(live[i]);
+            }
+            int insideWrong = 0;
+            tree.QueryFrustum(frustum, [&](ProxyId id, bool fullyInside) {
+                found.push_back(id);
+                uint32_t mask = Frustum::ALL_PLANES;
+                if (fullyInside && frustum.Classify(tree.GetFatAABB(id), mask) != Frustum::Inside)
+                    ++insideWrong;
+                return true;
+            });
+            wrongFrustum += (SameSet(expected, found) && insideWrong == 0) ? 0 : 1;
+        }
+
+        char what[128];
+        snprintf(what, sizeof(what), "%s: AABB query matches scan", stage);
+        ok = Bench::Check(wrongBox == 0, what) && ok;
+        snprintf(what, sizeof(what), "%s: sphere query matches scan", stage);
+        ok = Bench::Check(wrongSphere == 0, what) && ok;
+        snprintf(what, sizeof(what), "%s: ray cast finds nearest", stage);
+        ok = Bench::Check(wrongRay == 0, what) && ok;
+        snprintf(what, sizeof(what), "%s: frustum query matches scan", stage);
+        ok = Bench::Check(wrongFrustum == 0, what) && ok;
+        return ok;
+    }
+
+    bool VerifyTree()
+    {
+        bool ok = true;
+        Math::RandomGenerator rng(17);
+        CDynamicBVH tree;
+        std::vector<ProxyId> live;
+        std::vector<AABB> boxes;
+
+        for (uint32_t i = 0; i < 3000; ++i)
+        {
+            boxes.push_back(RandomBox(rng, 8.0f));
+            live.push_back(tree.CreateProxy(boxes.back(), i));
+        }
+        ok = Bench::Check(tree.Validate() && tree.GetProxyCount() == 3000, "incremental insert keeps tree valid") && ok;
+        ok = Bench::Check(tree.GetHeight() < 40, "incremental insert keeps tree balanced") && ok;
+        ok = VerifyQueries(tree, live, rng, "insert") && ok;
+
+        // 移动：小位移大多留在放大盒内，大位移重新插入
+        size_t reinserted = 0, small = 0;
+        for (size_t i = 0; i < live.size(); i += 2)
+        {
+            bool far = (i % 6) == 0;
+            Vector3 offset = far ? rng.NextVector3(Vector3(-200, -5, -200), Vector3(200, 5, 200))
+                                 : rng.NextVector3(Vector3(-0.05f, -0.05f, -0.05f), Vector3(0.05f, 0.05f, 0.05f));
+            AABB moved(boxes[i].min + offset, boxes[i].max + offset);
+            bool changed = tree.MoveProxy(live[i], moved, offset);
+            reinserted += changed ? 1 : 0;
+            small += (!far && !changed) ? 1 : 0;
+            boxes[i] = moved;
+            if (!tree.GetFatAABB(live[i]).Contains(moved))
+                ok = Bench::Check(false, "fat box contains moved box") && ok;
+        }
+        ok = Bench::Check(small > 900 && reinserted >= 250, "small moves stay inside fat boxes") && ok;
+        ok = Bench::Check(tree.Validate(), "move keeps tree valid") && ok;
+        ok = VerifyQueries(tree, live, rng, "move") && ok;
+
+        // 删除三分之一
+        std::vector<ProxyId> kept;
+        for (size_t i = 0; i < live.size(); ++i)
+        {
+            if (i % 3 == 1)
+                tree.DestroyProxy(live[i]);
+            else
+                kept.push_back(live[i]);
+        }
+        live.swap(kept);
+        ok = Bench::Check(tree.Validate() && tree.GetProxyCount() == live.size(), "remove keeps tree valid") && ok;
+        ok = VerifyQueries(tree, live, rng, "remove") && ok;
+
+        // 重建后代理号与用户数据不变
+        float before = tree.GetAreaRatio();
+        tree.Rebuild();
+        ok = Bench::Check(tree.Validate(), "rebuild keeps tree valid") && ok;
+        ok = Bench::Check(tree.GetAreaRatio() <= before, "rebuild does not worsen area ratio") && ok;
+        ok = VerifyQueries(tree, live, rng, "rebuild") && ok;
+
+        // 批量：少量加入走逐个插入，期间新代理不可查询
+        tree.BeginBulk();
+        std::vector<ProxyId> added;
+        for (uint32_t i = 0; i < 100; ++i)
+            added.push_back(tree.CreateProxy(RandomBox(rng, 8.0f), 10000 + i));
+        tree.DestroyProxy(added.back());
+        added.pop_back();
+        size_t visible = 0;
+        tree.QueryAABB(AABB(Vector3(-1e6f, -1e6f, -1e6f), Vector3(1e6f, 1e6f, 1e6f)), [&](ProxyId) { ++visible; return true; });
+        ok = Bench::Check(visible == live.size(), "pending proxies are not in the tree") && ok;
+        tree.EndBulk();
+        live.insert(live.end(), added.begin(), added.end());
+        ok = Bench::Check(tree.Validate() && tree.GetProxyCount() == live.size(), "bulk append keeps tree valid") && ok;
+        ok = VerifyQueries(tree, live, rng, "bulk append") && ok;
+
+        // 提前结束
+        int visits = 0;
+        tree.QueryAABB(AABB(Vector3(-1e6f, -1e6f, -1e6f), Vector3(1e6f, 1e6f, 1e6f)), [&](ProxyId) { return ++visits < 5; });
+        ok = Bench::Check(visits == 5, "callback can stop query") && ok;
+
+        // 空盒与重复清空
+        tree.Clear();
+        ok = Bench::Check(tree.Validate() && tree.GetProxyCount() == 0 && tree.GetHeight() == 0, "clear") && ok;
+        ProxyId single = tree.CreateProxy(AABB(Vector3(0, 0, 0), Vector3(1, 1, 1)), 7);
+        ok = Bench::Check(tree.GetUserData(single) == 7 && tree.Validate(), "single proxy") && ok;
+        return ok;
+    }
+
+    // ======================================================================
+    // CSpatialIndex：包围盒随世界矩阵同步
+    // ======================================================================
+    bool VerifySpatialIndex()
+    {
+        bool ok = true;
+        Math::RandomGenerator rng(29);
+        CTransformStore store;
+        CSpatialIndex index(store);
+
+        // 每 4 个一组：组长为根，其余 3 个挂在组长下（偏移 5）
+        const size_t count = 2000;
+        std::vector<CTransformStore::Handle> transforms;
+        std::vector<CSpatialIndex::Handle> handles;
+        const AABB local(Vector3(-1, -1, -1), Vector3(1, 1, 1));
+        index.BeginBulk();
+        for (size_t i = 0; i < count; ++i)
+        {
+            CTransformStore::Handle h = store.Create();
+            if (i % 4 != 0)
+            {
+                store.SetParent(h, transforms[i - i % 4]);
+                store.SetLocalPosition(h, Vector3(5.0f * (i % 4), 0, 0));
+            }
+            else
+                store.SetLocalPosition(h, rng.NextVector3(Vector3(-WORLD_SIZE, 0, -WORLD_SIZE), Vector3(WORLD_SIZE, 0, WORLD_SIZE)));
+            transforms.push_back(h);
+            handles.push_back(index.Add((unsigned int)i + 1, h, local));
+        }
+        index.EndBulk();
+        ok = Bench::Check(index.GetTree().Validate() && index.GetCount() == count, "spatial index bulk build") && ok;
+
+        // 移动一部分根节点：子节点的包围盒跟随
+        for (size_t i = 0; i < count; i += 8)
+            store.SetLocalPosition(transforms[i], rng.NextVector3(Vector3(-WORLD_SIZE, 0, -WORLD_SIZE), Vector3(WORLD_SIZE, 0, WORLD_SIZE)));
+        store.UpdateWorldMatrices();
+        size_t changed = index.Update();
+        ok = Bench::Check(changed == count / 2, "only moved subtrees are refreshed") && ok;
+        ok = Bench::Check(index.Update() == 0, "unchanged frame refreshes nothing") && ok;
+
+        // 删除一部分，改一个局部包围盒
+        for (size_t i = 1; i < count; i += 5)
+        {
+            index.Remove(handles[i]);
+            handles[i] = CSpatialIndex::INVALID_HANDLE;
+        }
+        index.SetLocalBounds(handles[0], AABB(Vector3(-30, -1, -30), Vector3(30, 1, 30)));
+        ok = Bench::Check(index.GetTree().Validate(), "spatial index valid after remove") && ok;
+
+        // 与逐个扫描世界包围盒（由世界矩阵重新计算）对比
+        int wrongBounds = 0, wrongSphere = 0, wrongRay = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (handles[i] == CSpatialIndex::INVALID_HANDLE)
+                continue;
+            Vector3 center = index.GetWorldBounds(handles[i]).GetCenter();
+            if ((center - store.GetWorldMatrix(transforms[i]).GetTranslation()).Length() > 1e-3f)
+                ++wrongBounds;
+        }
+        for (int q = 0; q < 50; ++q)
+        {
+            Vector3 center = rng.NextVector3(Vector3(-WORLD_SIZE, 0, -WORLD_SIZE), Vector3(WORLD_SIZE, 0, WORLD_SIZE));
+            float radius = rng.NextFloat(5.0f, 100.0f);
+            std::vector<unsigned int> expected, found;
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (handles[i] != CSpatialIndex::INVALID_HANDLE && SphereHits(index.GetWorldBounds(handles[i]), center, radius))
+                    expected.push_back((unsigned int)i + 1);
+            }
+            index.QuerySphere(center, radius, found);
+            wrongSphere += SameSet(expected, found) ? 0 : 1;
+
+            Vector3 origin(center.x, 0.0f, center.z);
+            Vector3 direction = rng.NextVector3(Vector3(-1, 0, -1), Vector3(1, 0, 1)).Normalized();
+            unsigned int nearest = 0;
+            float best = 500.0f;
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (handles[i] == CSpatialIndex::INVALID_HANDLE)
+                    continue;
+                float t = RayEnter(index.GetWorldBounds(handles[i]), origin, direction);
+                if (t >= 0.0f && t < best)
+                {
+                    best = t;
+                    nearest = (unsigned int)i + 1;
+                }
+            }
+            float distance = -1.0f;
+            unsigned int hit = index.RayCast(origin, direction, 500.0f, &distance);
+            if (hit != nearest || (hit && std::fabs(distance - best) > 1e-3f))
+                ++wrongRay;
+        }
+        ok = Bench::Check(wrongBounds == 0, "world bounds follow transforms") && ok;
+        ok = Bench::Check(wrongSphere == 0, "spatial sphere query matches scan") && ok;
+        ok = Bench::Check(wrongRay == 0, "spatial ray cast finds nearest") && ok;
+        return ok;
+    }
+
+    // ======================================================================
+    // 基准
+    // ======================================================================
+    void BenchBuild(bool quick)
+    {
+        const size_t sizes[] = {10000, 100000};
+        printf("%-10s %14s %10s %8s %14s %10s %8s\n", "proxies", "insert ms", "area", "height", "bulk ms", "area", "height");
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+        {
+            const size_t count = sizes[s];
+            if (quick && count > 10000)
+                break;
+
+            Math::RandomGenerator rng(5);
+            std::vector<AABB> boxes(count);
+            for (size_t i = 0; i < count; ++i)
+                boxes[i] = RandomBox(rng, 4.0f);
+
+            CDynamicBVH incremental, bulk;
+            double insertNs = Bench::TimeNsPerOp(1, 3, [&]() {
+                incremental.Clear();
+                for (size_t i = 0; i < count; ++i)
+                    incremental.CreateProxy(boxes[i], (uint32_t)i);
+            });
+            double bulkNs = Bench::TimeNsPerOp(1, 3, [&]() {
+                bulk.Clear();
+                bulk.BeginBulk();
+                for (size_t i = 0; i < count; ++i)
+                    bulk.CreateProxy(boxes[i], (uint32_t)i);
+                bulk.EndBulk();
+            });
+            printf("%-10zu %14.2f %10.1f %8d %14.2f %10.1f %8d\n", count,
+                   insertNs * 1e-6, incremental.GetAreaRatio(), incremental.GetHeight(),
+                   bulkNs * 1e-6, bulk.GetAreaRatio(), bulk.GetHeight());
+        }
+    }
+
+    void BenchQueries(bool quick)
+    {
+        const size_t sizes[] = {10000, 100000};
+        const int queries = quick ? 100 : 1000;
+        printf("\n%-10s %-8s %14s %14s %10s\n", "proxies", "query", "scan ns", "bvh ns", "speedup");
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+        {
+            const size_t count = sizes[s];
+            if (quick && count > 10000)
+                break;
+
+            Math::RandomGenerator rng(9);
+            std::vector<AABB> boxes(count);
+            CDynamicBVH tree;
+            tree.BeginBulk();
+            for (size_t i = 0; i < count; ++i)
+            {
+                boxes[i] = RandomBox(rng, 4.0f);
+                tree.CreateProxy(boxes[i], (uint32_t)i);
+            }
+            tree.EndBulk();
+
+            std::vector<AABB> regions(queries);
+            std::vector<Vector3> origins(queries), directions(queries);
+            std::vector<Frustum> frustums(queries);
+            for (int q = 0; q < queries; ++q)
+            {
+                regions[q] = RandomBox(rng, 40.0f);
+                origins[q] = rng.NextVector3(Vector3(-WORLD_SIZE, 0, -WORLD_SIZE), Vector3(WORLD_SIZE, 0, WORLD_SIZE));
+                directions[q] = rng.NextVector3(Vector3(-1, -0.1f, -1), Vector3(1, 0.1f, 1)).Normalized();
+                frustums[q] = MakeFrustum(origins[q], origins[q] + directions[q], 300.0f);
+            }
+
+            size_t hits = 0;
+            double scanBox = Bench::TimeNsPerOp(queries, 3, [&]() {
+                for (int q = 0; q < queries; ++q)
+                    for (size_t i = 0; i < count; ++i)
+                        hits += boxes[i].Intersects(regions[q]) ? 1 : 0;
+            });
+            double bvhBox = Bench::TimeNsPerOp(queries, 3, [&]() {
+                for (int q = 0; q < queries; ++q)
+                    tree.QueryAABB(regions[q], [&](ProxyId) { ++hits; return true; });
+            });
+            printf("%-10zu %-8s %14.0f %14.0f %9.1fx\n", count, "aabb", scanBox, bvhBox, scanBox / bvhBox);
+
+            double scanRay = Bench::TimeNsPerOp(queries, 3, [&]() {
+                for (int q = 0; q < queries; ++q)
+                {
+                    float best = 500.0f;
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        float t = RayEnter(boxes[i], origins[q], directions[q]);
+                        if (t >= 0.0f && t < best)
+                            best = t;
+                    }
+                    hits += best < 500.0f ? 1 : 0;
+                }
+            });
+            double bvhRay = Bench::TimeNsPerOp(queries, 3, [&]() {
+                for (int q = 0; q < queries; ++q)
+                {
+                    float best = 500.0f;
+                    tree.RayCast(origins[q], directions[q], 500.0f, [&](ProxyId, float enter) {
+                        best = std::min(best, enter);
+                        return enter;
+                    });
+                    hits += best < 500.0f ? 1 : 0;
+                }
+            });
+            printf("%-10zu %-8s %14.0f %14.0f %9.1fx\n", count, "ray", scanRay, bvhRay, scanRay / bvhRay);
+
+            double scanFrustum = Bench::TimeNsPerOp(queries, 3, [&]() {
+                for (int q = 0; q < queries; ++q)
+                    for (size_t i = 0; i < count; ++i)
+                        hits += frustums[q].Intersects(boxes[i]) ? 1 : 0;
+            });
+            double bvhFrustum = Bench::TimeNsPerOp(queries, 3, [&]() {
+                for (int q = 0; q < queries; ++q)
+                    tree.QueryFrustum(frustums[q], [&](ProxyId, bool) { ++hits; return true; });
+            });
+            printf("%-10zu %-8s %14.0f %14.0f %9.1fx\n", count, "frustum", scanFrustum, bvhFrustum, scanFrustum / bvhFrustum);
+            Bench::g_sink = hits;
+        }
+    }
+
+    void BenchUpdate(bool quick)
+    {
+        const size_t sizes[] = {10000, 100000};
+        const int frames = quick ? 10 : 100;
+        printf("\n%-10s %10s %16s %14s\n", "entities", "moving", "update ns/frame", "reinserted");
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+        {
+            const size_t count = sizes[s];
+            if (quick && count > 10000)
+                break;
+
+            Math::RandomGenerator rng(13);
+            CTransformStore store;
+            CSpatialIndex index(store);
+            std::vector<CTransformStore::Handle> transforms(count);
+            std::vector<Vector3> positions(count), velocities(count);
+            const AABB local(Vector3(-1, -1, -1), Vector3(1, 1, 1));
+            index.BeginBulk();
+            for (size_t i = 0; i < count; ++i)
+            {
+                transforms[i] = store.Create();
+                positions[i] = rng.NextVector3(Vector3(-WORLD_SIZE, 0, -WORLD_SIZE), Vector3(WORLD_SIZE, 0, WORLD_SIZE));
+                velocities[i] = rng.NextVector3(Vector3(-0.2f, 0, -0.2f), Vector3(0.2f, 0, 0.2f));
+                store.SetLocalPosition(transforms[i], positions[i]);
+                index.Add((unsigned int)i + 1, transforms[i], local);
+            }
+            index.EndBulk();
+            store.UpdateWorldMatrices();
+            index.Update();
+
+            // 每帧 10% 的实体按各自速度移动；只计包围盒同步，不计世界矩阵
+            size_t reinserted = 0;
+            double total = 0.0;
+            for (int f = 0; f < frames; ++f)
+            {
+                for (size_t i = (size_t)f % 10; i < count; i += 10)
+                {
+                    positions[i] = positions[i] + velocities[i];
+                    store.SetLocalPosition(transforms[i], positions[i]);
+                }
+                store.UpdateWorldMatrices();
+                total += Bench::TimeNsPerOp(1, 1, [&]() { index.Update(); });
+                reinserted += index.GetLastReinsertedCount();
+            }
+            printf("%-10zu %10zu %16.0f %14.1f\n", count, count / 10, total / frames, (double)reinserted / frames);
+            Bench::g_sink = reinserted;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = Bench::HasFlag(argc, argv, "--quick");
+
+    bool ok = VerifyTree();
+    ok = VerifySpatialIndex() && ok;
+    if (!ok)
+        return 1;
+
+    BenchBuild(quick);
+    BenchQueries(quick);
+    BenchUpdate(quick);
+    return 0;
+}
@@ -0,0 +1,417 @@
+#include "stdafx.h"
+#include "BenchUtils.h"
+#include "Core/ComponentStore.h"
+#include "Core/EntityComponents.h"
+#include "Core/JobSystem.h"
+#include "Math/Random.h"
+#include <cmath>
+#include <map>
+#include <memory>
+
+// ======================================================================
+// CComponentStore 正确性与批量系统耗时
+//   ComponentBench [--quick]
+// 校验：随机增删实体/组件后与参考实现一致（数据随原型搬移、交换删除不串行）、
+//       旧 ID 失效、查询覆盖所有匹配原型、并行遍历与串行结果一致
+// 对比：虚函数对象模型（每个对象单独分配，逐个调用虚 Update）与按块遍历组件数组
+//       的匀速运动、粒子、自动贴地三种系统
+// ======================================================================
+
+namespace
+{
+    typedef CComponentStore::Entity Entity;
+
+    struct Position
+    {
+        Vector3 value;
+    };
+
+    struct Velocity
+    {
+        Vector3 value;
+    };
+
+    struct Lifetime
+    {
+        float remaining;
+    };
+
+    struct Tag
+    {
+        int value;
+    };
+
+    // ======================================================================
+    // 校验
+    // ======================================================================
+    struct Expected
+    {
+        bool hasPosition = false, hasVelocity = false, hasTag = false;
+        Vector3 position, velocity;
+        int tag = 0;
+    };
+
+    bool Matches(CComponentStore &store, Entity e, const Expected &x)
+    {
+        Position *p = store.Get<Position>(e);
+        Velocity *v = store.Get<Velocity>(e);
+        Tag *t = store.Get<Tag>(e);
+        if ((p != nullptr) != x.hasPosition || (v != nullptr) != x.hasVelocity || (t != nullptr) != x.hasTag)
+            return false;
+        if (p && !(p->value == x.position))
+            return false;
+        if (v && !(v->value == x.velocity))
+            return false;
+        return !t || t->value == x.tag;
+    }
+
+    bool VerifyRandomOps()
+    {
+        CComponentStore store;
+        Math::RandomGenerator rng(21);
+        std::map<Entity, Expected> ref;
+        std::vector<Entity> live, dead;
+        int mismatches = 0;
+
+        for (int step = 0; step < 60000; ++step)
+        {
+            int op = live.empty() ? 0 : rng.NextInt(0, 8);
+            if (op <= 1)
+            {
+                Expected x;
+                Entity e;
+                if (rng.NextInt(0, 2))
+                {
+                    x.hasPosition = x.hasTag = true;
+                    x.position = rng.NextVector3(Vector3(-9.0f, -9.0f, -9.0f), Vector3(9.0f, 9.0f, 9.0f));
+                    x.tag = step;
+                    Position p = {x.position};
+                    Tag t = {x.tag};
+                    e = store.Create(p, t);
+                }
+                else
+                    e = store.Create();
+                ref[e] = x;
+                live.push_back(e);
+                continue;
+            }
+
+            size_t k = (size_t)rng.NextInt(0, (int)live.size());
+            Entity e = live[k];
+            Expected &x = ref[e];
+            switch (op)
+            {
+            case 2:
+                x.hasVelocity = true;
+                x.velocity = rng.NextVector3(Vector3(-1.0f, -1.0f, -1.0f), Vector3(1.0f, 1.0f, 1.0f));
+                store.Add<Velocity>(e, Velocity{x.velocity});
+                break;
+            case 3:
+                x.hasPosition = true;
+                x.position = Vector3((float)step, 0.0f, 0.0f);
+                store.Add<Position>(e, Position{x.position});
+                break;
+            case 4:
+                x.hasVelocity = false;
+                store.Remove<Velocity>(e);
+                break;
+            case 5:
+                x.hasTag = false;
+                store.Remove<Tag>(e);
+                break;
+            case 6:
+                x.hasTag = true;
+                x.tag = -step;
+                store.Add<Tag>(e, Tag{x.tag});
+                break;
+            default:
+                store.Destroy(e);
+                ref.erase(e);
+                live[k] = live.back();
+                live.pop_back();
+                dead.push_back(e);
+                break;
+            }
+
+            if (step % 1000 == 0)
+            {
+                for (size_t i = 0; i < live.size(); ++i)
+                    mismatches += Matches(store, live[i], ref[live[i]]) ? 0 : 1;
+            }
+        }
+
+        bool ok = Bench::Check(mismatches == 0, "components survive archetype moves and swap-removes");
+        ok = Bench::Check(store.GetEntityCount() == live.size(), "entity count") && ok;
+
+        bool staleRejected = true;
+        for (size_t i = 0; i < dead.size(); ++i)
+            staleRejected = staleRejected && (ref.count(dead[i]) || (!store.IsAlive(dead[i]) && !store.Get<Position>(dead[i])));
+        ok = Bench::Check(staleRejected, "destroyed ids are rejected") && ok;
+
+        // 查询：每个带 Position 的实体恰好访问一次
+        size_t expectedPositions = 0;
+        for (size_t i = 0; i < live.size(); ++i)
+            expectedPositions += ref[live[i]].hasPosition ? 1 : 0;
+        size_t visited = 0;
+        bool entityMatches = true;
+        store.EachChunk<Position>([&](size_t count, const Entity *entities, Position *positions) {
+            for (size_t i = 0; i < count; ++i)
+                entityMatches = entityMatches && store.Get<Position>(entities[i]) == &positions[i];
+            visited += count;
+        });
+        ok = Bench::Check(visited == expectedPositions && entityMatches, "query visits every matching entity once") && ok;
+
+        size_t both = 0, expectedBoth = 0;
+        for (size_t i = 0; i < live.size(); ++i)
+            expectedBoth += ref[live[i]].hasPosition && ref[live[i]].hasVelocity ? 1 : 0;
+        store.Each<Position, Velocity>([&both](Position &, Velocity &) { ++both; });
+        ok = Bench::Check(both == expectedBoth, "multi-component query") && ok;
+
+        size_t withoutTag = 0, expectedWithoutTag = 0;
+        for (size_t i = 0; i < live.size(); ++i)
+            expectedWithoutTag += ref[live[i]].hasPosition && !ref[live[i]].hasTag ? 1 : 0;
+        store.Each<Position>([&withoutTag](Position &) { ++withoutTag; }, CComponentStore::MaskOf<Tag>());
+        ok = Bench::Check(withoutTag == expectedWithoutTag, "query with excluded component") && ok;
+
+        store.Clear();
+        ok = Bench::Check(store.GetEntityCount() == 0 && !store.IsAlive(live.empty() ? 0 : live[0]), "Clear") && ok;
+        return ok;
+    }
+
+    void Integrate(size_t count, Position *positions, const Velocity *velocities, float dt)
+    {
+        for (size_t i = 0; i < count; ++i)
+            positions[i].value = positions[i].value + velocities[i].value * dt;
+    }
+
+    bool VerifyParallel()
+    {
+        const size_t count = 50000;
+        CComponentStore serial, parallel;
+        Math::RandomGenerator rng(5);
+        for (size_t i = 0; i < count; ++i)
+        {
+            Position p = {rng.NextVector3(Vector3(-50.0f, 0.0f, -50.0f), Vector3(50.0f, 10.0f, 50.0f))};
+            Velocity v = {rng.NextVector3(Vector3(-1.0f, -1.0f, -1.0f), Vector3(1.0f, 1.0f, 1.0f))};
+            serial.Create(p, v);
+            parallel.Create(p, v);
+        }
+
+        CJobSystem jobs(3);
+        for (int frame = 0; frame < 10; ++frame)
+        {
+            serial.EachChunk<Position, Velocity>([](size_t n, const Entity *, Position *p, Velocity *v) { Integrate(n, p, v, 0.016f); });
+            parallel.EachChunkParallel<Position, Velocity>(&jobs, [](size_t n, const Entity *, Position *p, Velocity *v) { Integrate(n, p, v, 0.016f); });
+        }
+
+        std::vector<Vector3> a, b;
+        serial.Each<Position>([&a](Position &p) { a.push_back(p.value); });
+        parallel.Each<Position>([&b](Position &p) { b.push_back(p.value); });
+        return Bench::Check(a.size() == count && a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(Vector3)) == 0,
+                     "parallel chunks match serial");
+    }
+
+    bool Verify()
+    {
+        bool ok = VerifyRandomOps();
+        ok = VerifyParallel() && ok;
+        if (ok)
+            printf("[ OK ] component store random ops, queries and parallel iteration\n");
+        return ok;
+    }
+
+    // ======================================================================
+    // 对照：虚函数对象模型
+    // ======================================================================
+    class CObject
+    {
+    public:
+        virtual ~CObject() = default;
+        virtual void Update(float dt) = 0;
+        Vector3 m_position;
+        Vector3 m_velocity;
+        float m_padding[16]; // 对象中其它成员（名称、子节点、标志位等）
+    };
+
+    class CMover : public CObject
+    {
+    public:
+        virtual void Update(float dt) override { m_position = m_position + m_velocity * dt; }
+    };
+
+    class CParticle : public CObject
+    {
+    public:
+        virtual void Update(float dt) override
+        {
+            m_life -= dt;
+            if (m_life <= 0.0f)
+            {
+                m_position = Vector3::Zero();
+                m_life = 2.0f;
+            }
+            m_velocity.y -= 9.8f * dt;
+            m_position = m_position + m_velocity * dt;
+        }
+        float m_life = 2.0f;
+    };
+
+    float Height(float x, float z)
+    {
+        return sinf(x * 0.1f) * cosf(z * 0.1f) * 5.0f;
+    }
+
+    void ParticleChunk(size_t n, Position *p, Velocity *v, Lifetime *life, float dt)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            life[i].remaining -= dt;
+            if (life[i].remaining <= 0.0f)
+            {
+                p[i].value = Vector3::Zero();
+                life[i].remaining = 2.0f;
+            }
+            v[i].value.y -= 9.8f * dt;
+            p[i].value = p[i].value + v[i].value * dt;
+        }
+    }
+
+    void BenchSystems(bool quick)
+    {
+        const size_t count = quick ? 20000 : 100000;
+        const int repeat = quick ? 3 : 10;
+        const float dt = 0.016f;
+        Math::RandomGenerator rng(8);
+
+        // 对象模型：打乱分配顺序，模拟运行一段时间后的堆布局
+        std::vector<std::unique_ptr<CObject>> objects;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (i & 1)
+                objects.push_back(std::unique_ptr<CObject>(new CParticle()));
+            else
+                objects.push_back(std::unique_ptr<CObject>(new CMover()));
+            objects.back()->m_velocity = rng.NextVector3(Vector3(-1.0f, 0.0f, -1.0f), Vector3(1.0f, 5.0f, 1.0f));
+        }
+        for (size_t i = count; i > 1; --i)
+            std::swap(objects[i - 1], objects[(size_t)rng.NextInt(0, (int)i)]);
+
+        CComponentStore store;
+        for (size_t i = 0; i < count; ++i)
+        {
+            Position p = {Vector3::Zero()};
+            Velocity v = {rng.NextVector3(Vector3(-1.0f, 0.0f, -1.0f), Vector3(1.0f, 5.0f, 1.0f))};
+            if (i & 1)
+                store.Create(p, v, Lifetime{2.0f});
+            else
+                store.Create(p, v);
+        }
+
+        CJobSystem jobs;
+        double objectNs = Bench::TimeNsPerOp(count, repeat, [&]() {
+            for (size_t i = 0; i < objects.size(); ++i)
+                objects[i]->Update(dt);
+        });
+        // 粒子处理带 Lifetime 的原型，匀速运动排除带 Lifetime 的原型
+        const CComponentStore::ComponentMask lifeMask = CComponentStore::MaskOf<Lifetime>();
+        auto runSystems = [&](CJobSystem *pJobs) {
+            store.EachChunkParallel<Position, Velocity, Lifetime>(pJobs, [dt](size_t n, const Entity *, Position *p, Velocity *v, Lifetime *l) {
+                ParticleChunk(n, p, v, l, dt);
+            });
+            store.EachChunkParallel<Position, Velocity>(pJobs, [dt](size_t n, const Entity *, Position *p, Velocity *v) {
+                Integrate(n, p, v, dt);
+            }, lifeMask);
+        };
+        double ecsNs = Bench::TimeNsPerOp(count, repeat, [&]() { runSystems(nullptr); });
+        double ecsParallelNs = Bench::TimeNsPerOp(count, repeat, [&]() { runSystems(&jobs); });
+
+        // 自动贴地：对象模型逐个取位置/偏移/上次位置；组件方式读 CTransformStore + TerrainSnap（偏移为常量）
+        CTransformStore transforms;
+        CComponentStore snapStore;
+        struct SnapObject
+        {
+            virtual ~SnapObject() = default;
+            virtual Vector3 GetPosition() const { return position; }
+            virtual void SetPosition(const Vector3 &p) { position = p; }
+            Vector3 position, lastSnap;
+            float offset = 0.5f;
+            float padding[24];
+        };
+        std::vector<std::unique_ptr<SnapObject>> snapObjects;
+        for (size_t i = 0; i < count; ++i)
+        {
+            Vector3 pos = rng.NextVector3(Vector3(-100.0f, 0.0f, -100.0f), Vector3(100.0f, 0.0f, 100.0f));
+            snapObjects.push_back(std::unique_ptr<SnapObject>(new SnapObject()));
+            snapObjects.back()->position = pos;
+            snapObjects.back()->lastSnap = Vector3(99999.0f, 99999.0f, 99999.0f);
+
+            CTransformStore::Handle h = transforms.Create();
+            transforms.SetLocalPosition(h, pos);
+            snapStore.Create(EntityLink{(unsigned int)i + 1, h}, TerrainSnap{99999.0f, 99999.0f});
+        }
+        for (size_t i = count; i > 1; --i)
+            std::swap(snapObjects[i - 1], snapObjects[(size_t)rng.NextInt(0, (int)i)]);
+
+        // 每帧约 1% 的对象移动
+        const float snapOffset = 0.5f;
+        const float thresholdSq = 0.1f * 0.1f;
+        size_t frame = 0;
+        double snapObjectNs = Bench::TimeNsPerOp(count, repeat, [&]() {
+            for (size_t i = 0; i < snapObjects.size(); ++i)
+            {
+                SnapObject &o = *snapObjects[i];
+                Vector3 pos = o.GetPosition();
+                if (i % 100 == frame % 100)
+                    pos.x += 1.0f;
+                float dx = pos.x - o.lastSnap.x, dz = pos.z - o.lastSnap.z;
+                if (dx * dx + dz * dz > thresholdSq)
+                {
+                    o.SetPosition(Vector3(pos.x, Height(pos.x, pos.z) + o.offset, pos.z));
+                    o.lastSnap = pos;
+                }
+            }
+            ++frame;
+        });
+        frame = 0;
+        double snapEcsNs = Bench::TimeNsPerOp(count, repeat, [&]() {
+            size_t base = 0;
+            snapStore.EachChunk<EntityLink, TerrainSnap>([&](size_t n, const Entity *, EntityLink *links, TerrainSnap *snaps) {
+                for (size_t i = 0; i < n; ++i)
+                {
+                    Vector3 pos = transforms.GetLocalPosition(links[i].transform);
+                    if ((base + i) % 100 == frame % 100)
+                        pos.x += 1.0f;
+                    float dx = pos.x - snaps[i].lastX, dz = pos.z - snaps[i].lastZ;
+                    if (dx * dx + dz * dz > thresholdSq)
+                    {
+                        transforms.SetLocalPosition(links[i].transform, Vector3(pos.x, Height(pos.x, pos.z) + snapOffset, pos.z));
+                        snaps[i].lastX = pos.x;
+                        snaps[i].lastZ = pos.z;
+                    }
+                }
+                base += n;
+            });
+            ++frame;
+        });
+
+        float acc = 0.0f;
+        store.Each<Position>([&acc](Position &p) { acc += p.value.y; });
+        Bench::g_sink = acc + objects[0]->m_position.x;
+
+        printf("objects: %zu, archetypes: %zu, chunks: %zu, threads: %u\n", count, store.GetArchetypeCount(), store.GetChunkCount(), jobs.GetThreadCount());
+        printf("%-36s %14s %14s %14s\n", "system", "objects ns", "chunks ns", "parallel ns");
+        printf("%-36s %14.2f %14.2f %14.2f\n", "movers + particles", objectNs, ecsNs, ecsParallelNs);
+        printf("%-36s %14.2f %14.2f %14s\n", "auto snapping", snapObjectNs, snapEcsNs, "-");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = Bench::HasFlag(argc, argv, "--quick");
+
+    if (!Verify())
+        return 1;
+
+    BenchSystems(quick);
+    return 0;
+}
@@ -0,0 +1,351 @@
+#include "stdafx.h"
+#include "BenchUtils.h"
+#include "Core/EntityPool.h"
+#include "Core/TransformStore.h"
+#include <algorithm>
+#include <unordered_map>
+
+// ======================================================================
+// 实体对象池与带代数 ID
+//   EntityBench [--quick]
+// 校验：CHandleTable 槽位复用与旧 ID 失效、CBlockPool 地址连续与复用、
+//       池化实体预热后创建/遍历/销毁不再调用 operator new
+// 对比：旧 CEntity 方式（每个实体单独 new、子节点 vector + unordered_map 双份记录、类内自增 ID）
+//       与池化方式在 10 万实体下的创建、Update 遍历、销毁耗时和每实体分配次数
+// CEntity 依赖 Win32/OpenGL，这里用结构相同的替身类
+// ======================================================================
+
+namespace
+{
+    typedef CTransformStore::Handle Handle;
+
+    // ======================================================================
+    // 旧方式替身
+    // ======================================================================
+    class COldEntity : public std::enable_shared_from_this<COldEntity>
+    {
+    public:
+        static std::shared_ptr<COldEntity> Create(CTransformStore &store)
+        {
+            auto entity = std::shared_ptr<COldEntity>(new COldEntity(store));
+            entity->m_uID = ++s_nextID;
+            return entity;
+        }
+
+        COldEntity(CTransformStore &store) : m_uID(++s_nextID), m_name(L"New Entity"), m_store(store), m_hTransform(store.Create()) {}
+        virtual ~COldEntity() { m_store.Destroy(m_hTransform); }
+
+        void AddChild(const std::shared_ptr<COldEntity> &pChild)
+        {
+            pChild->m_pParent = shared_from_this();
+            m_store.SetParent(pChild->m_hTransform, m_hTransform);
+            if (m_childrenMap.find(pChild->m_uID) == m_childrenMap.end())
+            {
+                m_children.push_back(pChild);
+                m_childrenMap[pChild->m_uID] = pChild;
+            }
+        }
+
+        void ClearChildren()
+        {
+            m_childrenMap.clear();
+            m_children.clear();
+        }
+
+        virtual float Update(float dt)
+        {
+            float sum = m_value * dt;
+            for (auto &pChild : m_children)
+                sum += pChild->Update(dt);
+            return sum;
+        }
+
+        static unsigned int s_nextID;
+        unsigned int m_uID;
+        std::wstring m_name;
+        CTransformStore &m_store;
+        Handle m_hTransform;
+        float m_value = 1.0f;
+        std::weak_ptr<COldEntity> m_pParent;
+        std::vector<std::shared_ptr<COldEntity>> m_children;
+        std::unordered_map<unsigned int, std::shared_ptr<COldEntity>> m_childrenMap;
+    };
+    unsigned int COldEntity::s_nextID = 0;
+
+    class COldModel : public COldEntity
+    {
+    public:
+        static std::shared_ptr<COldModel> Create(CTransformStore &store)
+        {
+            auto entity = std::shared_ptr<COldModel>(new COldModel(store));
+            entity->m_uID = ++s_nextID;
+            return entity;
+        }
+
+        COldModel(CTransformStore &store) : COldEntity(store) {}
+        virtual float Update(float dt) override { return COldEntity::Update(dt) + m_extra[0]; }
+
+        float m_extra[8] = {};
+    };
+
+    // ======================================================================
+    // 池化方式替身（与 CEntity 相同：CPoolAllocator + CHandleTable + 单份子节点列表）
+    // ======================================================================
+    class CPooledEntity : public std::enable_shared_from_this<CPooledEntity>
+    {
+        template <typename>
+        friend class ::CPoolAllocator;
+
+    public:
+        typedef CHandleTable<CPooledEntity> Registry;
+
+        static std::shared_ptr<CPooledEntity> Create(CTransformStore &store) { return Allocate<CPooledEntity>(store); }
+        static Registry &GetRegistry()
+        {
+            static Registry s_registry;
+            return s_registry;
+        }
+
+        virtual ~CPooledEntity()
+        {
+            m_store.Destroy(m_hTransform);
+            GetRegistry().Release(m_uID);
+        }
+
+        void AddChild(const std::shared_ptr<CPooledEntity> &pChild)
+        {
+            pChild->m_pParent = shared_from_this();
+            m_store.SetParent(pChild->m_hTransform, m_hTransform);
+            m_children.push_back(pChild);
+        }
+
+        void ClearChildren() { m_children.clear(); }
+
+        virtual float Update(float dt)
+        {
+            float sum = m_value * dt;
+            for (auto &pChild : m_children)
+                sum += pChild->Update(dt);
+            return sum;
+        }
+
+        unsigned int m_uID;
+        std::wstring m_name;
+        CTransformStore &m_store;
+        Handle m_hTransform;
+        float m_value = 1.0f;
+        std::weak_ptr<CPooledEntity> m_pParent;
+        std::vector<std::shared_ptr<CPooledEntity>> m_children;
+
+    protected:
+        CPooledEntity(CTransformStore &store) : m_uID(GetRegistry().Allocate(this)), m_store(store), m_hTransform(store.Create()) {}
+
+        template <typename T, typename... Args>
+        static std::shared_ptr<T> Allocate(Args &&...args)
+        {
+            return std::allocate_shared<T>(CPoolAllocator<T>(), std::forward<Args>(args)...);
+        }
+    };
+
+    class CPooledModel : public CPooledEntity
+    {
+        template <typename>
+        friend class ::CPoolAllocator;
+
+    public:
+        static std::shared_ptr<CPooledModel> Create(CTransformStore &store) { return Allocate<CPooledModel>(store); }
+        virtual float Update(float dt) override { return CPooledEntity::Update(dt) + m_extra[0]; }
+
+        float m_extra[8] = {};
+
+    protected:
+        CPooledModel(CTransformStore &store) : CPooledEntity(store) {}
+    };
+
+    // ======================================================================
+    // 校验
+    // ======================================================================
+    bool VerifyHandleTable()
+    {
+        bool ok = true;
+        int objects[4] = {0, 1, 2, 3};
+        CHandleTable<int> table;
+
+        CHandleTable<int>::Id a = table.Allocate(&objects[0]);
+        CHandleTable<int>::Id b = table.Allocate(&objects[1]);
+        ok = Bench::Check(a != CHandleTable<int>::INVALID_ID && b != CHandleTable<int>::INVALID_ID && a != b, "ids are distinct and valid") && ok;
+        ok = Bench::Check(table.Get(a) == &objects[0] && table.Get(b) == &objects[1] && table.GetCount() == 2, "Get resolves live ids") && ok;
+
+        table.Release(a);
+        ok = Bench::Check(table.Get(a) == nullptr && !table.IsValid(a) && table.GetCount() == 1, "released id is invalid") && ok;
+        table.Release(a); // 重复释放无效
+        ok = Bench::Check(table.GetCount() == 1, "double release ignored") && ok;
+
+        CHandleTable<int>::Id c = table.Allocate(&objects[2]);
+        ok = Bench::Check(CHandleTable<int>::GetIndex(c) == CHandleTable<int>::GetIndex(a) && c != a, "slot reused with new generation") && ok;
+        ok = Bench::Check(table.Get(a) == nullptr && table.Get(c) == &objects[2], "stale id does not alias reused slot") && ok;
+        ok = Bench::Check(table.GetSlotCount() == 2, "free list reuses slots") && ok;
+
+        // 同一槽位反复复用，代数回绕后也不会产生 INVALID_ID
+        bool neverInvalid = true;
+        for (int i = 0; i < 10000; ++i)
+        {
+            table.Release(c);
+            c = table.Allocate(&objects[3]);
+            neverInvalid = neverInvalid && c != CHandleTable<int>::INVALID_ID && table.Get(c) == &objects[3];
+        }
+        ok = Bench::Check(neverInvalid && table.GetSlotCount() == 2, "generation wrap-around") && ok;
+
+        int visited = 0;
+        table.ForEach([&visited](int *) { ++visited; });
+        ok = Bench::Check(visited == 2, "ForEach visits live objects") && ok;
+        return ok;
+    }
+
+    bool VerifyBlockPool()
+    {
+        bool ok = true;
+        CBlockPool pool(40, 16, 64);
+        ok = Bench::Check(pool.GetBlockSize() == 48, "block size rounded to alignment") && ok;
+
+        std::vector<char *> blocks;
+        bool aligned = true, contiguous = true;
+        for (int i = 0; i < 64; ++i)
+        {
+            blocks.push_back((char *)pool.Allocate());
+            aligned = aligned && ((uintptr_t)blocks.back() % 16) == 0;
+            if (i > 0)
+                contiguous = contiguous && blocks[i] == blocks[i - 1] + 48;
+        }
+        ok = Bench::Check(aligned, "blocks aligned") && ok;
+        ok = Bench::Check(contiguous && pool.GetChunkCount() == 1, "first chunk handed out in address order") && ok;
+
+        pool.Deallocate(blocks[10]);
+        ok = Bench::Check(pool.Allocate() == blocks[10] && pool.GetChunkCount() == 1, "freed block reused before growing") && ok;
+
+        pool.Allocate();
+        ok = Bench::Check(pool.GetChunkCount() == 2 && pool.GetUsedCount() == 65 && pool.GetCapacity() == 128, "pool grows by chunks") && ok;
+
+        pool.Reserve(300);
+        ok = Bench::Check(pool.GetCapacity() >= 300, "Reserve") && ok;
+        return ok;
+    }
+
+    // 一轮：在常驻根节点下创建 count 个实体（一半为子类），遍历，全部销毁
+    template <typename Base, typename Model>
+    float RunRound(CTransformStore &store, const std::shared_ptr<Base> &root, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (i & 1)
+                root->AddChild(Model::Create(store));
+            else
+                root->AddChild(Base::Create(store));
+        }
+        float sum = root->Update(0.016f);
+        root->ClearChildren();
+        return sum;
+    }
+
+    bool VerifyPooledEntities()
+    {
+        bool ok = true;
+        CTransformStore store;
+        CPooledEntity::Registry &registry = CPooledEntity::GetRegistry();
+        std::shared_ptr<CPooledEntity> root = CPooledEntity::Create(store);
+        const size_t count = 10000;
+
+        // 预热：对象池、ID 槽位、子节点列表、变换数组达到峰值容量
+        RunRound<CPooledEntity, CPooledModel>(store, root, count);
+        store.UpdateWorldMatrices();
+        ok = Bench::Check(registry.GetCount() == 1, "destroyed entities release their ids") && ok;
+
+        size_t slotsAfterWarmup = registry.GetSlotCount();
+        size_t before = Bench::GetAllocationCount();
+        float sum = RunRound<CPooledEntity, CPooledModel>(store, root, count);
+        size_t allocations = Bench::GetAllocationCount() - before;
+        ok = Bench::Check(allocations == 0, "pooled create/update/destroy is allocation-free after warm-up") && ok;
+        ok = Bench::Check(registry.GetSlotCount() == slotsAfterWarmup, "id slots reused") && ok;
+        ok = Bench::Check(sum > 0.0f, "update visits children") && ok;
+
+        // 旧 ID 在实体销毁后失效，新实体复用槽位但 ID 不同
+        std::shared_ptr<CPooledEntity> first = CPooledEntity::Create(store);
+        unsigned int staleID = first->m_uID;
+        first.reset();
+        std::shared_ptr<CPooledEntity> second = CPooledEntity::Create(store);
+        ok = Bench::Check(registry.Get(staleID) == nullptr && registry.Get(second->m_uID) == second.get(), "stale entity id rejected") && ok;
+        ok = Bench::Check(CPooledEntity::Registry::GetIndex(staleID) == CPooledEntity::Registry::GetIndex(second->m_uID), "entity slot reused") && ok;
+        return ok;
+    }
+
+    bool Verify()
+    {
+        bool ok = VerifyHandleTable();
+        ok = VerifyBlockPool() && ok;
+        ok = VerifyPooledEntities() && ok;
+        if (ok)
+            printf("[ OK ] handle table, block pool and allocation-free pooled entities\n");
+        return ok;
+    }
+
+    // ======================================================================
+    // 耗时对比
+    // ======================================================================
+    template <typename Base, typename Model>
+    void BenchScheme(const char *name, size_t count, int repeat)
+    {
+        CTransformStore store;
+        std::shared_ptr<Base> root = Base::Create(store);
+        RunRound<Base, Model>(store, root, count); // 预热
+        store.UpdateWorldMatrices();
+
+        double createNs = 1e30, updateNs = 1e30, destroyNs = 1e30;
+        size_t allocations = 0;
+        float acc = 0.0f;
+        for (int r = 0; r < repeat; ++r)
+        {
+            size_t before = Bench::GetAllocationCount();
+            Bench::Clock::time_point t0 = Bench::Clock::now();
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (i & 1)
+                    root->AddChild(Model::Create(store));
+                else
+                    root->AddChild(Base::Create(store));
+            }
+            Bench::Clock::time_point t1 = Bench::Clock::now();
+            acc += root->Update(0.016f);
+            Bench::Clock::time_point t2 = Bench::Clock::now();
+            root->ClearChildren();
+            Bench::Clock::time_point t3 = Bench::Clock::now();
+            allocations = Bench::GetAllocationCount() - before;
+            store.UpdateWorldMatrices();
+
+            createNs = std::min(createNs, std::chrono::duration<double, std::nano>(t1 - t0).count() / count);
+            updateNs = std::min(updateNs, std::chrono::duration<double, std::nano>(t2 - t1).count() / count);
+            destroyNs = std::min(destroyNs, std::chrono::duration<double, std::nano>(t3 - t2).count() / count);
+        }
+        Bench::g_sink = acc;
+        printf("%-28s %10zu %12.1f %12.1f %12.1f %14.2f\n", name, count, createNs, updateNs, destroyNs, (double)allocations / count);
+    }
+
+    void BenchEntities(bool quick)
+    {
+        const size_t count = quick ? 20000 : 100000;
+        const int repeat = quick ? 2 : 5;
+        printf("%-28s %10s %12s %12s %12s %14s\n", "scheme", "entities", "create ns", "update ns", "destroy ns", "allocs/entity");
+        BenchScheme<COldEntity, COldModel>("shared_ptr + map (old)", count, repeat);
+        BenchScheme<CPooledEntity, CPooledModel>("pooled + generational id", count, repeat);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = Bench::HasFlag(argc, argv, "--quick");
+
+    if (!Verify())
+        return 1;
+
+    BenchEntities(quick);
+    return 0;
+}
@@ -0,0 +1,243 @@
+#include "stdafx.h"
+#include "BenchUtils.h"
+#include "Math/FastMath.h"
+#include <cstring>
+#include <random>
+
+// ======================================================================
+// Math::Fast 精度与吞吐量（对照 libm）
+//   FastMathBench [--quick]
+// 先以 double 精度的 libm 为参考检查误差上限，再输出 libm / 快速标量 / 快速数组的单次耗时
+// ======================================================================
+
+namespace
+{
+    using Bench::TimeNsPerOp;
+
+    // 防止计时循环被整体优化掉
+    struct ErrorStat
+    {
+        double maxError;
+        float worstInput;
+
+        ErrorStat() : maxError(0.0), worstInput(0.0f) {}
+
+        void Add(double error, float input)
+        {
+            if (error > maxError)
+            {
+                maxError = error;
+                worstInput = input;
+            }
+        }
+    };
+
+    bool Report(const char *name, const ErrorStat &scalar, const ErrorStat &array, float bound)
+    {
+        bool ok = scalar.maxError <= bound && array.maxError <= bound;
+        printf("[%s] %-8s scalar %.3g (x=%g)  array %.3g (x=%g)  bound %.3g\n", ok ? " OK " : "FAIL", name,
+               scalar.maxError, scalar.worstInput, array.maxError, array.worstInput, bound);
+        return ok;
+    }
+
+    // ======================================================================
+    // 精度校验
+    // ======================================================================
+    bool VerifySinCos(size_t count)
+    {
+        std::vector<float> in(count), outSin(count), outCos(count);
+        // 一半覆盖 [-2π, 2π] 的稠密采样，一半覆盖整个有效区间
+        for (size_t i = 0; i < count; ++i)
+        {
+            float t = (float)i / (float)(count - 1) * 2.0f - 1.0f;
+            in[i] = (i & 1) ? t * Math::Fast::SIN_COS_MAX_INPUT : t * Math::TWO_PI;
+        }
+        Math::Fast::SinCos(in.data(), outSin.data(), outCos.data(), count);
+
+        ErrorStat sinScalar, sinArray, cosScalar, cosArray;
+        for (size_t i = 0; i < count; ++i)
+        {
+            double refSin = sin((double)in[i]);
+            double refCos = cos((double)in[i]);
+            sinScalar.Add(fabs(Math::Fast::Sin(in[i]) - refSin), in[i]);
+            cosScalar.Add(fabs(Math::Fast::Cos(in[i]) - refCos), in[i]);
+            sinArray.Add(fabs(outSin[i] - refSin), in[i]);
+            cosArray.Add(fabs(outCos[i] - refCos), in[i]);
+        }
+        bool ok = Report("Sin", sinScalar, sinArray, Math::Fast::SIN_COS_MAX_ERROR);
+        ok = Report("Cos", cosScalar, cosArray, Math::Fast::SIN_COS_MAX_ERROR) && ok;
+        return ok;
+    }
+
+    bool VerifySqrt(size_t count)
+    {
+        // 对数均匀分布于 [1e-30, 1e30]
+        std::vector<float> in(count), outInv(count), outSqrt(count);
+        for (size_t i = 0; i < count; ++i)
+            in[i] = (float)pow(10.0, -30.0 + 60.0 * (double)i / (double)(count - 1));
+        Math::Fast::InvSqrt(in.data(), outInv.data(), count);
+        Math::Fast::Sqrt(in.data(), outSqrt.data(), count);
+
+        ErrorStat invScalar, invArray, sqrtScalar, sqrtArray;
+        for (size_t i = 0; i < count; ++i)
+        {
+            double ref = sqrt((double)in[i]);
+            invScalar.Add(fabs(Math::Fast::InvSqrt(in[i]) * ref - 1.0), in[i]);
+            invArray.Add(fabs(outInv[i] * ref - 1.0), in[i]);
+            sqrtScalar.Add(fabs(Math::Fast::Sqrt(in[i]) / ref - 1.0), in[i]);
+            sqrtArray.Add(fabs(outSqrt[i] / ref - 1.0), in[i]);
+        }
+        bool ok = Report("InvSqrt", invScalar, invArray, Math::Fast::INV_SQRT_MAX_REL_ERROR);
+        ok = Report("Sqrt", sqrtScalar, sqrtArray, Math::Fast::INV_SQRT_MAX_REL_ERROR) && ok;
+
+        // 0 与负数
+        float zeros[4] = {0.0f, -0.0f, -1.0f, -1e10f};
+        float sq[4];
+        Math::Fast::Sqrt(zeros, sq, 4);
+        for (int i = 0; i < 4; ++i)
+        {
+            if (sq[i] != 0.0f || Math::Fast::Sqrt(zeros[i]) != 0.0f)
+            {
+                printf("[FAIL] Sqrt(%g) should be 0\n", zeros[i]);
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
+    bool VerifyAtan2(size_t count)
+    {
+        // 各种半径下覆盖完整一圈，另加坐标轴与原点
+        std::vector<float> y, x;
+        const float radii[] = {1e-20f, 1e-3f, 1.0f, 7.5f, 1e4f, 1e20f};
+        for (size_t r = 0; r < sizeof(radii) / sizeof(radii[0]); ++r)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                double angle = -Math::PI + 2.0 * Math::PI * (double)i / (double)count;
+                y.push_back(radii[r] * (float)sin(angle));
+                x.push_back(radii[r] * (float)cos(angle));
+            }
+        }
+        const float axes[][2] = {{0.0f, 0.0f}, {0.0f, 1.0f}, {1.0f, 0.0f}, {0.0f, -1.0f}, {-1.0f, 0.0f}, {2.0f, 2.0f}};
+        for (size_t i = 0; i < sizeof(axes) / sizeof(axes[0]); ++i)
+        {
+            y.push_back(axes[i][0]);
+            x.push_back(axes[i][1]);
+        }
+
+        size_t n = y.size();
+        std::vector<float> out(n);
+        Math::Fast::Atan2(y.data(), x.data(), out.data(), n);
+
+        ErrorStat scalar, array;
+        for (size_t i = 0; i < n; ++i)
+        {
+            double ref = atan2((double)y[i], (double)x[i]);
+            // ±π 为同一方向
+            double e0 = fabs(Math::Fast::Atan2(y[i], x[i]) - ref);
+            double e1 = fabs(out[i] - ref);
+            if (fabs(ref) > 3.14)
+            {
+                e0 = Math::Min(e0, fabs(fabs(Math::Fast::Atan2(y[i], x[i])) - fabs(ref)));
+                e1 = Math::Min(e1, fabs(fabs(out[i]) - fabs(ref)));
+            }
+            scalar.Add(e0, y[i] / (x[i] != 0.0f ? x[i] : 1.0f));
+            array.Add(e1, y[i] / (x[i] != 0.0f ? x[i] : 1.0f));
+        }
+        return Report("Atan2", scalar, array, Math::Fast::ATAN2_MAX_ERROR);
+    }
+
+    void PrintRow(size_t count, const char *op, double libm, double scalar, double array)
+    {
+        printf("%8zu %-8s %9.2f ns %9.2f ns %9.2f ns %7.2fx %7.2fx\n", count, op, libm, scalar, array,
+               libm / scalar, libm / array);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--quick") == 0)
+            quick = true;
+    }
+
+    printf("path: %s\n", Math::SIMD::PathName());
+    bool ok = VerifySinCos(quick ? 200003 : 2000003);
+    ok = VerifySqrt(quick ? 100003 : 1000003) && ok;
+    ok = VerifyAtan2(quick ? 10007 : 100003) && ok;
+    if (!ok)
+        return 1;
+
+    const size_t sizes[] = {1000, 100000};
+    const int repeat = quick ? 2 : 10;
+    std::mt19937 rng(2024);
+
+    printf("%8s %-8s %12s %12s %12s %8s %8s\n", "count", "op", "libm", "fast", "fast[]", "scalar", "array");
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        size_t count = sizes[s];
+        std::uniform_real_distribution<float> angle(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> positive(1e-3f, 1e3f);
+        std::vector<float> a(count), b(count), out(count), out2(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            a[i] = angle(rng);
+            b[i] = positive(rng);
+        }
+
+        double libm = TimeNsPerOp(count, repeat, [&]() {
+            for (size_t i = 0; i < count; ++i)
+                out[i] = sinf(a[i]);
+        });
+        double scalar = TimeNsPerOp(count, repeat, [&]() {
+            for (size_t i = 0; i < count; ++i)
+                out[i] = Math::Fast::Sin(a[i]);
+        });
+        double array = TimeNsPerOp(count, repeat, [&]() { Math::Fast::Sin(a.data(), out.data(), count); });
+        PrintRow(count, "Sin", libm, scalar, array);
+
+        libm = TimeNsPerOp(count, repeat, [&]() {
+            for (size_t i = 0; i < count; ++i)
+            {
+                out[i] = sinf(a[i]);
+                out2[i] = cosf(a[i]);
+            }
+        });
+        scalar = TimeNsPerOp(count, repeat, [&]() {
+            for (size_t i = 0; i < count; ++i)
+                Math::Fast::SinCos(a[i], &out[i], &out2[i]);
+        });
+        array = TimeNsPerOp(count, repeat, [&]() { Math::Fast::SinCos(a.data(), out.data(), out2.data(), count); });
+        PrintRow(count, "SinCos", libm, scalar, array);
+
+        libm = TimeNsPerOp(count, repeat, [&]() {
+            for (size_t i = 0; i < count; ++i)
+                out[i] = 1.0f / sqrtf(b[i]);
+        });
+        scalar = TimeNsPerOp(count, repeat, [&]() {
+            for (size_t i = 0; i < count; ++i)
+                out[i] = Math::Fast::InvSqrt(b[i]);
+        });
+        array = TimeNsPerOp(count, repeat, [&]() { Math::Fast::InvSqrt(b.data(), out.data(), count); });
+        PrintRow(count, "InvSqrt", libm, scalar, array);
+
+        libm = TimeNsPerOp(count, repeat, [&]() {
+            for (size_t i = 0; i < count; ++i)
+                out[i] = atan2f(a[i], b[i] - 500.0f);
+        });
+        for (size_t i = 0; i < count; ++i)
+            out2[i] = b[i] - 500.0f;
+        scalar = TimeNsPerOp(count, repeat, [&]() {
+            for (size_t i = 0; i < count; ++i)
+                out[i] = Math::Fast::Atan2(a[i], out2[i]);
+        });
+        array = TimeNsPerOp(count, repeat, [&]() { Math::Fast::Atan2(a.data(), out2.data(), out.data(), count); });
+        PrintRow(count, "Atan2", libm, scalar, array);
+
+        Bench::g_sink = out[count / 2];
+    }
+    return 0;
+}
@@ -0,0 +1,223 @@
+#include "stdafx.h"
+#include "BenchUtils.h"
+#include "Core/JobSystem.h"
+#include "Math/MathBatch.h"
+#include "Math/Random.h"
+#include <atomic>
+#include <cstring>
+
+// ======================================================================
+// CJobSystem 正确性与扩展性
+//   JobBench [--quick]
+// 校验：计数器、ParallelFor 覆盖每个下标恰好一次、任务内嵌套 ParallelFor（边等边干）、
+//       ScheduleAfter 依赖顺序、外部线程提交、作为 Math::Batch 执行器结果与单线程一致
+// 扩展性：不同工作线程数下的粗粒度（批量变换）与细粒度（大量小任务）耗时
+// ======================================================================
+
+namespace
+{
+    using Bench::TimeNsPerOp;
+
+    bool VerifyCounters(CJobSystem &jobs)
+    {
+        std::atomic<int> sum(0);
+        CJobCounter counter;
+        for (int i = 0; i < 10000; ++i)
+            jobs.Schedule([&sum, i]() { sum.fetch_add(i, std::memory_order_relaxed); }, &counter);
+        jobs.Wait(counter);
+        return Bench::Check(counter.IsDone() && sum.load() == 10000 * 9999 / 2, "Schedule + Wait");
+    }
+
+    bool VerifyParallelFor(CJobSystem &jobs)
+    {
+        bool ok = true;
+        const size_t counts[] = {0, 1, 7, 1000, 65537, 1000000};
+        const size_t grains[] = {1, 64, 4096};
+        for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c)
+        {
+            for (size_t g = 0; g < sizeof(grains) / sizeof(grains[0]); ++g)
+            {
+                std::vector<int> hits(counts[c], 0);
+                jobs.ParallelFor(counts[c], grains[g], [&hits](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i)
+                        ++hits[i];
+                });
+                bool once = true;
+                for (size_t i = 0; i < hits.size(); ++i)
+                    once = once && hits[i] == 1;
+                ok = Bench::Check(once, "ParallelFor visits every index once") && ok;
+            }
+        }
+
+        // 嵌套：外层每块内部再 ParallelFor，等待中的线程必须帮忙执行内层任务
+        std::atomic<long long> total(0);
+        jobs.ParallelFor(64, 1, [&](size_t begin, size_t end) {
+            for (size_t outer = begin; outer < end; ++outer)
+            {
+                jobs.ParallelFor(1000, 10, [&](size_t b, size_t e) {
+                    long long local = 0;
+                    for (size_t i = b; i < e; ++i)
+                        local += (long long)i;
+                    total.fetch_add(local, std::memory_order_relaxed);
+                });
+            }
+        });
+        ok = Bench::Check(total.load() == 64LL * (999LL * 1000 / 2), "nested ParallelFor") && ok;
+        return ok;
+    }
+
+    bool VerifyDependencies(CJobSystem &jobs)
+    {
+        bool ok = true;
+
+        // 链式：A -> B -> C
+        std::atomic<int> step(0);
+        std::atomic<bool> orderOk(true);
+        CJobCounter a, b, c;
+        jobs.Schedule([&]() {
+            for (volatile int spin = 0; spin < 100000; ++spin)
+                ;
+            if (step.exchange(1) != 0)
+                orderOk = false;
+        }, &a);
+        jobs.ScheduleAfter(a, [&]() {
+            if (step.exchange(2) != 1)
+                orderOk = false;
+        }, &b);
+        jobs.ScheduleAfter(b, [&]() {
+            if (step.exchange(3) != 2)
+                orderOk = false;
+        }, &c);
+        jobs.Wait(c);
+        ok = Bench::Check(orderOk.load() && step.load() == 3 && a.IsDone() && b.IsDone(), "ScheduleAfter chain order") && ok;
+
+        // 汇合：100 个任务全部完成后才执行
+        std::atomic<int> done(0);
+        int seenByJoin = -1;
+        CJobCounter fan, join;
+        for (int i = 0; i < 100; ++i)
+            jobs.Schedule([&done]() { done.fetch_add(1); }, &fan);
+        jobs.ScheduleAfter(fan, [&]() { seenByJoin = done.load(); }, &join);
+        jobs.Wait(join);
+        ok = Bench::Check(seenByJoin == 100, "ScheduleAfter fan-in") && ok;
+
+        // 依赖已完成时立即提交
+        CJobCounter finished, after;
+        bool ran = false;
+        jobs.ScheduleAfter(finished, [&ran]() { ran = true; }, &after);
+        jobs.Wait(after);
+        ok = Bench::Check(ran, "ScheduleAfter on finished counter") && ok;
+        return ok;
+    }
+
+    bool VerifyExternalThread(CJobSystem &jobs)
+    {
+        std::atomic<int> sum(0);
+        std::thread external([&]() {
+            CJobCounter counter;
+            for (int i = 0; i < 1000; ++i)
+                jobs.Schedule([&sum]() { sum.fetch_add(1); }, &counter);
+            jobs.Wait(counter);
+        });
+        external.join();
+        return Bench::Check(sum.load() == 1000, "jobs from external thread");
+    }
+
+    bool VerifyBatchExecutor(CJobSystem &jobs)
+    {
+        const size_t count = 200000;
+        std::vector<Vector3> points(count), expected(count), actual(count);
+        Math::RandomGenerator(3).Fill(points.data(), count, Vector3(-10.0f, -10.0f, -10.0f), Vector3(10.0f, 10.0f, 10.0f));
+        Matrix4 m = Matrix4::TRS(Vector3(1.0f, 2.0f, 3.0f), Quaternion::FromEuler(0.3f, 0.2f, 0.1f), Vector3(2.0f, 2.0f, 2.0f));
+
+        Math::Batch::SetParallelExecutor([](size_t n, size_t, const Math::Batch::RangeFunc &func) { func(0, n); });
+        Math::Batch::TransformPoints(m, points.data(), expected.data(), count);
+        Math::Batch::SetParallelExecutor([&jobs](size_t n, size_t grain, const Math::Batch::RangeFunc &func) {
+            jobs.ParallelFor(n, grain, func);
+        });
+        Math::Batch::TransformPoints(m, points.data(), actual.data(), count);
+        Math::Batch::SetParallelExecutor(nullptr);
+
+        return Bench::Check(memcmp(expected.data(), actual.data(), count * sizeof(Vector3)) == 0, "Math::Batch executor matches single thread");
+    }
+
+    bool Verify()
+    {
+        bool ok = true;
+        const unsigned workerCounts[] = {1, 3};
+        for (size_t w = 0; w < 2; ++w)
+        {
+            CJobSystem jobs(workerCounts[w]);
+            ok = VerifyCounters(jobs) && ok;
+            ok = VerifyParallelFor(jobs) && ok;
+            ok = VerifyDependencies(jobs) && ok;
+            ok = VerifyExternalThread(jobs) && ok;
+            ok = VerifyBatchExecutor(jobs) && ok;
+        }
+        if (ok)
+            printf("[ OK ] job system counters, ParallelFor, nesting, dependencies and batch executor\n");
+        return ok;
+    }
+
+    // ======================================================================
+    // 扩展性
+    // ======================================================================
+    void BenchScaling(bool quick)
+    {
+        const size_t points = quick ? 200000 : 4000000;
+        const size_t smallJobs = quick ? 20000 : 200000;
+        const int repeat = quick ? 2 : 5;
+        std::vector<Vector3> in(points), out(points);
+        Math::RandomGenerator(9).Fill(in.data(), points, Vector3(-10.0f, -10.0f, -10.0f), Vector3(10.0f, 10.0f, 10.0f));
+        Matrix4 m = Matrix4::TRS(Vector3(1.0f, 2.0f, 3.0f), Quaternion::FromEuler(0.3f, 0.2f, 0.1f), Vector3::One());
+
+        // 单线程基准
+        Math::Batch::SetParallelExecutor([](size_t n, size_t, const Math::Batch::RangeFunc &func) { func(0, n); });
+        double serial = TimeNsPerOp(points, repeat, [&]() { Math::Batch::TransformPoints(m, in.data(), out.data(), points); });
+        Math::Batch::SetParallelExecutor(nullptr);
+        double spawn = TimeNsPerOp(points, repeat, [&]() { Math::Batch::TransformPoints(m, in.data(), out.data(), points); });
+
+        printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+        printf("%-28s %8s %14s %10s %16s\n", "executor", "threads", "ns/point", "speedup", "ns/small job");
+        printf("%-28s %8d %14.3f %10.2f %16s\n", "serial", 1, serial, 1.0, "-");
+        printf("%-28s %8u %14.3f %10.2f %16s\n", "std::thread per call", std::thread::hardware_concurrency(), spawn, serial / spawn, "-");
+
+        unsigned maxWorkers = std::thread::hardware_concurrency();
+        if (maxWorkers < 2)
+            maxWorkers = 2;
+        float acc = 0.0f;
+        for (unsigned workers = 1; workers <= maxWorkers; workers *= 2)
+        {
+            CJobSystem jobs(workers);
+            Math::Batch::SetParallelExecutor([&jobs](size_t n, size_t grain, const Math::Batch::RangeFunc &func) {
+                jobs.ParallelFor(n, grain, func);
+            });
+            double ns = TimeNsPerOp(points, repeat, [&]() { Math::Batch::TransformPoints(m, in.data(), out.data(), points); });
+            Math::Batch::SetParallelExecutor(nullptr);
+            acc += out[points / 2].x;
+
+            // 细粒度：大量独立小任务，衡量调度开销
+            std::atomic<int> sum(0);
+            double perJob = TimeNsPerOp(smallJobs, repeat, [&]() {
+                CJobCounter counter;
+                for (size_t i = 0; i < smallJobs; ++i)
+                    jobs.Schedule([&sum]() { sum.fetch_add(1, std::memory_order_relaxed); }, &counter);
+                jobs.Wait(counter);
+            });
+
+            printf("%-28s %8u %14.3f %10.2f %16.1f\n", "CJobSystem", jobs.GetThreadCount(), ns, serial / ns, perJob);
+        }
+        Bench::g_sink = acc;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = Bench::HasFlag(argc, argv, "--quick");
+
+    if (!Verify())
+        return 1;
+
+    BenchScaling(quick);
+    return 0;
+}
@@ -0,0 +1,371 @@
+#include "stdafx.h"
+#include "BenchUtils.h"
+#include "Core/LODController.h"
+#include "Core/MeshSimplifier.h"
+#include "Math/Random.h"
+#include <cmath>
+#include <map>
+
+// ======================================================================
+// 网格细节级别
+//   LODBench [--quick]
+// 校验：球面逐级简化后三角形数按目标减半、误差单调不减、表面偏离不超过误差的数倍、朝向不翻转；
+//       平面网格的开放边界与面积保持不变；UV 接缝上的顶点不被折叠；
+//       级别选择随距离单调，在切换距离附近来回移动时不抖动
+// 对比：简化耗时（每个输入三角形），大量模型按屏幕误差选择级别后的三角形数
+// ======================================================================
+
+namespace
+{
+    struct TestMesh
+    {
+        std::vector<Vector3> positions;
+        std::vector<unsigned int> indices;
+    };
+
+    // 单位球：正二十面体逐级细分，顶点共享、闭合
+    TestMesh MakeSphere(int subdivisions)
+    {
+        const float t = (1.0f + std::sqrt(5.0f)) * 0.5f;
+        TestMesh mesh;
+        const float base[12][3] = {{-1, t, 0}, {1, t, 0}, {-1, -t, 0}, {1, -t, 0}, {0, -1, t}, {0, 1, t},
+                                   {0, -1, -t}, {0, 1, -t}, {t, 0, -1}, {t, 0, 1}, {-t, 0, -1}, {-t, 0, 1}};
+        for (int i = 0; i < 12; ++i)
+            mesh.positions.push_back(Vector3(base[i][0], base[i][1], base[i][2]).Normalized());
+        mesh.indices = {0, 11, 5, 0, 5, 1, 0, 1, 7, 0, 7, 10, 0, 10, 11, 1, 5, 9, 5, 11, 4, 11, 10, 2, 10, 7, 6, 7, 1, 8,
+                        3, 9, 4, 3, 4, 2, 3, 2, 6, 3, 6, 8, 3, 8, 9, 4, 9, 5, 2, 4, 11, 6, 2, 10, 8, 6, 7, 9, 8, 1};
+
+        for (int s = 0; s < subdivisions; ++s)
+        {
+            std::map<std::pair<unsigned int, unsigned int>, unsigned int> midpoints;
+            auto midpoint = [&](unsigned int a, unsigned int b) {
+                std::pair<unsigned int, unsigned int> key(std::min(a, b), std::max(a, b));
+                auto it = midpoints.find(key);
+                if (it != midpoints.end())
+                    return it->second;
+                unsigned int index = (unsigned int)mesh.positions.size();
+                mesh.positions.push_back(((mesh.positions[a] + mesh.positions[b]) * 0.5f).Normalized());
+                midpoints[key] = index;
+                return index;
+            };
+            std::vector<unsigned int> next;
+            for (size_t i = 0; i < mesh.indices.size(); i += 3)
+            {
+                unsigned int a = mesh.indices[i], b = mesh.indices[i + 1], c = mesh.indices[i + 2];
+                unsigned int ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
+                unsigned int tris[12] = {a, ab, ca, b, bc, ab, c, ca, bc, ab, bc, ca};
+                next.insert(next.end(), tris, tris + 12);
+            }
+            mesh.indices.swap(next);
+        }
+        return mesh;
+    }
+
+    // y = 0 平面上 n × n 格的网格，法线朝 +y；seam 时 x = n/2 一列的顶点复制一份给右半边使用（UV 接缝）
+    TestMesh MakeGrid(int n, bool seam, std::vector<unsigned int> *seamVertices = nullptr)
+    {
+        TestMesh mesh;
+        for (int z = 0; z <= n; ++z)
+        {
+            for (int x = 0; x <= n; ++x)
+                mesh.positions.push_back(Vector3((float)x, 0.0f, (float)z));
+        }
+        std::vector<unsigned int> right((size_t)(n + 1), 0);
+        for (int z = 0; z <= n && seam; ++z)
+        {
+            unsigned int original = (unsigned int)(z * (n + 1) + n / 2);
+            right[z] = (unsigned int)mesh.positions.size();
+            mesh.positions.push_back(mesh.positions[original]);
+            if (seamVertices)
+            {
+                seamVertices->push_back(original);
+                seamVertices->push_back(right[z]);
+            }
+        }
+
+        auto vertex = [&](int x, int z, bool rightSide) {
+            if (seam && rightSide && x == n / 2)
+                return right[z];
+            return (unsigned int)(z * (n + 1) + x);
+        };
+        for (int z = 0; z < n; ++z)
+        {
+            for (int x = 0; x < n; ++x)
+            {
+                bool rightSide = x >= n / 2;
+                unsigned int a = vertex(x, z, rightSide), b = vertex(x + 1, z, rightSide);
+                unsigned int c = vertex(x, z + 1, rightSide), d = vertex(x + 1, z + 1, rightSide);
+                unsigned int quad[6] = {a, c, b, b, c, d};
+                mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+            }
+        }
+        return mesh;
+    }
+
+    Vector3 TriangleNormal(const TestMesh &mesh, const std::vector<unsigned int> &indices, size_t t)
+    {
+        const Vector3 &a = mesh.positions[indices[t]];
+        return (mesh.positions[indices[t + 1]] - a).Cross(mesh.positions[indices[t + 2]] - a);
+    }
+
+    bool IndicesValid(const TestMesh &mesh, const std::vector<unsigned int> &indices)
+    {
+        if (indices.size() % 3 != 0)
+            return false;
+        for (size_t t = 0; t < indices.size(); t += 3)
+        {
+            unsigned int a = indices[t], b = indices[t + 1], c = indices[t + 2];
+            if (a >= mesh.positions.size() || b >= mesh.positions.size() || c >= mesh.positions.size() ||
+                a == b || b == c || a == c)
+                return false;
+        }
+        return true;
+    }
+
+    // ======================================================================
+    // 正确性
+    // ======================================================================
+    bool VerifySphereChain()
+    {
+        TestMesh sphere = MakeSphere(5);
+        CMeshSimplifier simplifier(&sphere.positions[0].x, sphere.positions.size(), sizeof(Vector3),
+                                   sphere.indices.data(), sphere.indices.size());
+
+        int wrongCount = 0, wrongError = 0, wrongSurface = 0, wrongFacing = 0, wrongIndex = 0;
+        size_t previous = sphere.indices.size();
+        float previousError = 0.0f;
+        for (int level = 1; level <= 4; ++level)
+        {
+            size_t target = previous / 6 * 3;
+            simplifier.Simplify(target, 1.0f);
+            const std::vector<unsigned int> &indices = simplifier.GetIndices();
+            float error = simplifier.GetError();
+
+            if (indices.size() > target || indices.size() < target / 2)
+                ++wrongCount;
+            if (!(error >= previousError) || error <= 0.0f)
+                ++wrongError;
+            if (!IndicesValid(sphere, indices))
+                ++wrongIndex;
+
+            // 顶点都在球面上，简化后的三角形重心向内偏离球面；偏离量与误差同一量级
+            for (size_t t = 0; t < indices.size(); t += 3)
+            {
+                Vector3 centroid = (sphere.positions[indices[t]] + sphere.positions[indices[t + 1]] +
+                                    sphere.positions[indices[t + 2]]) * (1.0f / 3.0f);
+                if (1.0f - centroid.Length() > error * 4.0f + 1e-4f)
+                    ++wrongSurface;
+                if (TriangleNormal(sphere, indices, t).Dot(centroid) <= 0.0f)
+                    ++wrongFacing;
+            }
+            previous = indices.size();
+            previousError = error;
+        }
+
+        bool ok = Bench::Check(wrongCount == 0, "each level halves the triangle count");
+        ok = Bench::Check(wrongError == 0, "error grows along the chain") && ok;
+        ok = Bench::Check(wrongIndex == 0, "indices stay valid and non-degenerate") && ok;
+        ok = Bench::Check(wrongSurface == 0, "surface deviation bounded by the reported error") && ok;
+        ok = Bench::Check(wrongFacing == 0, "no triangle flips inside out") && ok;
+        return ok;
+    }
+
+    bool VerifyFlatGrid(bool seam)
+    {
+        const int n = 32;
+        std::vector<unsigned int> seamVertices;
+        TestMesh grid = MakeGrid(n, seam, &seamVertices);
+        CMeshSimplifier simplifier(&grid.positions[0].x, grid.positions.size(), sizeof(Vector3),
+                                   grid.indices.data(), grid.indices.size());
+        simplifier.Simplify(0, 1e-3f);
+        const std::vector<unsigned int> &indices = simplifier.GetIndices();
+
+        // 平面上折叠没有误差：面积不变且全部朝上，说明边界没有内缩、三角形没有重叠或翻转
+        float area = 0.0f;
+        int wrongFacing = 0;
+        for (size_t t = 0; t < indices.size(); t += 3)
+        {
+            Vector3 normal = TriangleNormal(grid, indices, t);
+            area += normal.Length() * 0.5f;
+            if (normal.y <= 0.0f || std::fabs(normal.x) + std::fabs(normal.z) > 1e-4f)
+                ++wrongFacing;
+        }
+
+        std::vector<uint8_t> referenced(grid.positions.size(), 0);
+        for (size_t i = 0; i < indices.size(); ++i)
+            referenced[indices[i]] = 1;
+        int lostSeam = 0;
+        for (size_t i = 0; i < seamVertices.size(); ++i)
+            lostSeam += referenced[seamVertices[i]] ? 0 : 1;
+        const bool corners = referenced[0] && referenced[n] && referenced[n * (n + 1)] && referenced[n * (n + 1) + n];
+
+        const char *what = seam ? "seamed grid keeps area and orientation" : "flat grid keeps area and orientation";
+        bool ok = Bench::Check(IndicesValid(grid, indices) && std::fabs(area - (float)(n * n)) < 1e-2f && wrongFacing == 0, what);
+        ok = Bench::Check(corners && simplifier.GetError() < 1e-4f, "flat collapses are free and keep the corners") && ok;
+        if (seam)
+        {
+            // 接缝上的顶点全部保留，两侧的每条接缝边至少还连着一个三角形
+            ok = Bench::Check(lostSeam == 0 && indices.size() / 3 >= (size_t)(2 * n), "seam vertices are never collapsed") && ok;
+        }
+        else
+        {
+            // 只剩边界：边界上的顶点只能沿边界合并，最终应远少于原来的 2n² 个三角形
+            ok = Bench::Check(indices.size() / 3 <= (size_t)(8 * n), "interior of a flat grid collapses away") && ok;
+        }
+        return ok;
+    }
+
+    bool VerifySelection()
+    {
+        CLODController controller;
+        const Matrix4 projection = Matrix4::Perspective(Math::ToRadians(60.0f), 1.0f, 0.1f, 1000.0f);
+        controller.SetView(Vector3::Zero(), projection, 1000.0f);
+        const float errors[4] = {0.0f, 0.01f, 0.04f, 0.16f};
+        const float radius = 1.0f;
+
+        // 像素换算与投影矩阵的实际结果一致：距离 10 处高 1 单位的线段在 1000 像素高的视口中的长度
+        Vector4 clip = projection * Vector4(0.0f, 1.0f, -10.0f, 1.0f);
+        float projectedPixels = clip.y / clip.w * 1000.0f * 0.5f;
+        float estimatedPixels = controller.ErrorToPixels(Matrix4::Identity(), Vector3(0.0f, 0.0f, -10.0f), 0.0f);
+        bool matchesProjection = Math::Abs(projectedPixels - estimatedPixels) < 1e-3f * projectedPixels;
+
+        // 由近到远级别只增不减，由远到近只减不增；每一步选中级别的屏幕误差不超过阈值
+        int wrongOrder = 0, wrongError = 0;
+        size_t level = 0;
+        std::vector<size_t> outward;
+        for (int step = 0; step <= 400; ++step)
+        {
+            Matrix4 world = Matrix4::Translation(Vector3(0.0f, 0.0f, -2.0f - (float)step * 2.0f));
+            size_t next = controller.Select(errors, 4, world, Vector3::Zero(), radius, level);
+            if (next < level)
+                ++wrongOrder;
+            if (errors[next] * controller.ErrorToPixels(world, Vector3::Zero(), radius) > controller.GetThreshold())
+                ++wrongError;
+            level = next;
+            outward.push_back(level);
+        }
+        bool reachedCoarsest = level == 3;
+        for (int step = 400; step >= 0; --step)
+        {
+            Matrix4 world = Matrix4::Translation(Vector3(0.0f, 0.0f, -2.0f - (float)step * 2.0f));
+            size_t next = controller.Select(errors, 4, world, Vector3::Zero(), radius, level);
+            if (next > level)
+                ++wrongOrder;
+            if (errors[next] * controller.ErrorToPixels(world, Vector3::Zero(), radius) > controller.GetThreshold())
+                ++wrongError;
+            level = next;
+        }
+
+        // 在 0→1 级的切换距离（误差降到阈值的 75%）附近 ±3% 来回：切到 1 级之后不再切回
+        float pixelsAtUnit = controller.ErrorToPixels(Matrix4::Identity(), Vector3(0.0f, 0.0f, -1.0f - radius), radius);
+        float switchDistance = errors[1] * pixelsAtUnit / (controller.GetThreshold() * 0.75f) + radius;
+        int switches = 0;
+        level = 0;
+        for (int i = 0; i < 100; ++i)
+        {
+            float distance = switchDistance * (i % 2 ? 1.03f : 0.97f);
+            Matrix4 world = Matrix4::Translation(Vector3(0.0f, 0.0f, -distance));
+            size_t next = controller.Select(errors, 4, world, Vector3::Zero(), radius, level);
+            if (next != level)
+                ++switches;
+            level = next;
+        }
+
+        bool ok = Bench::Check(matchesProjection, "pixel error matches the projection matrix");
+        ok = Bench::Check(wrongOrder == 0 && reachedCoarsest && level <= 1, "level follows distance monotonically") && ok;
+        ok = Bench::Check(wrongError == 0, "selected level stays under the pixel threshold") && ok;
+        ok = Bench::Check(switches == 1 && level == 1, "hysteresis stops flicker near a switch distance") && ok;
+        return ok;
+    }
+
+    // ======================================================================
+    // 基准
+    // ======================================================================
+    void BenchSimplify(bool quick)
+    {
+        printf("%-10s %12s %14s %40s\n", "triangles", "ns/tri", "levels", "triangles per level (error)");
+        for (int subdivisions = 5; subdivisions <= 7; ++subdivisions)
+        {
+            if (quick && subdivisions > 5)
+                break;
+            TestMesh sphere = MakeSphere(subdivisions);
+            const size_t triangles = sphere.indices.size() / 3;
+
+            std::string levels;
+            double ns = Bench::TimeNsPerOp(triangles, quick ? 1 : 3, [&]() {
+                CMeshSimplifier simplifier(&sphere.positions[0].x, sphere.positions.size(), sizeof(Vector3),
+                                           sphere.indices.data(), sphere.indices.size());
+                levels.clear();
+                size_t previous = sphere.indices.size();
+                for (int level = 1; level < 4; ++level)
+                {
+                    simplifier.Simplify(previous / 6 * 3, 0.1f);
+                    previous = simplifier.GetIndices().size();
+                    char text[64];
+                    snprintf(text, sizeof(text), " %zu (%.4f)", previous / 3, simplifier.GetError());
+                    levels += text;
+                }
+            });
+            printf("%-10zu %12.1f %14d %40s\n", triangles, ns, 4, levels.c_str());
+        }
+    }
+
+    // 大量同一模型（半径 10）散布在相机前方 15~500 单位，按 1 像素阈值选择级别
+    void BenchField(bool quick)
+    {
+        TestMesh sphere = MakeSphere(5);
+        CMeshSimplifier simplifier(&sphere.positions[0].x, sphere.positions.size(), sizeof(Vector3),
+                                   sphere.indices.data(), sphere.indices.size());
+        float errors[4] = {0.0f};
+        size_t triangles[4] = {sphere.indices.size() / 3};
+        for (int level = 1; level < 4; ++level)
+        {
+            simplifier.Simplify(triangles[level - 1] / 2 * 3, 0.1f);
+            errors[level] = simplifier.GetError();
+            triangles[level] = simplifier.GetIndices().size() / 3;
+        }
+
+        const size_t count = quick ? 2000 : 20000;
+        Math::RandomGenerator rng(5);
+        std::vector<Matrix4> worlds(count);
+        std::vector<size_t> levels(count, 0);
+        for (size_t i = 0; i < count; ++i)
+        {
+            Vector3 position = rng.NextVector3(Vector3(-200.0f, -10.0f, -500.0f), Vector3(200.0f, 10.0f, -15.0f));
+            worlds[i] = Matrix4::Translation(position) * Matrix4::Scale(10.0f);
+        }
+
+        CLODController controller;
+        controller.SetView(Vector3::Zero(), Matrix4::Perspective(Math::ToRadians(45.0f), 16.0f / 9.0f, 0.1f, 1000.0f), 1080.0f);
+        double ns = Bench::TimeNsPerOp(count, quick ? 2 : 5, [&]() {
+            controller.Begin();
+            for (size_t i = 0; i < count; ++i)
+            {
+                levels[i] = controller.Select(errors, 4, worlds[i], Vector3::Zero(), 1.0f, levels[i]);
+                controller.Record(levels[i], triangles[0], triangles[levels[i]]);
+            }
+            controller.End();
+        });
+
+        const LODStats &stats = controller.GetStats();
+        printf("%-10s %12s %14s %14s %10s\n", "models", "select ns", "reduced", "triangles", "of full");
+        printf("%-10zu %12.1f %14zu %14zu %9.1f%%\n", count, ns, stats.reduced, stats.drawnTriangles,
+               100.0 * (double)stats.drawnTriangles / (double)stats.fullTriangles);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = Bench::HasFlag(argc, argv, "--quick");
+
+    bool ok = VerifySphereChain();
+    ok = VerifyFlatGrid(false) && ok;
+    ok = VerifyFlatGrid(true) && ok;
+    ok = VerifySelection() && ok;
+    if (!ok)
+        return 1;
+
+    BenchSimplify(quick);
+    BenchField(quick);
+    return 0;
+}
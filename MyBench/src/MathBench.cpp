@@ -0,0 +1,276 @@
+#include "stdafx.h"
+#include "BenchUtils.h"
+#include "Math/MathBatch.h"
+#include "Math/QuaternionBatch.h"
+#include "Math/FastMath.h"
+#include "Math/MathSIMD.h"
+#include "Math/Random.h"
+#include <cmath>
+#include <string>
+
+// ======================================================================
+// 数学库回归基准：覆盖常用单个运算与不同规模的批量变换
+//   MathBench [--quick] [--format table|csv|json] [--out <file>] [--filter <substr>]
+// 每行结果：名称、批量大小、单个元素 ns、吞吐量（Mops/s），CSV/JSON 附带 SIMD 路径，
+// 便于把不同提交/不同路径（FORCE_SCALAR / SSE / AVX）的结果直接对比
+// ======================================================================
+
+namespace
+{
+    using Bench::TimeNsPerOp;
+
+    // 单个运算的输入池：大小为 2 的幂，避免编译器把输入当作常量折叠
+    const size_t POOL = 1024;
+
+    struct Inputs
+    {
+        std::vector<Matrix4> mats;
+        std::vector<Vector3> points;
+        std::vector<Vector3> scales;
+        std::vector<Quaternion> quats;
+        std::vector<float> t;
+    };
+
+    void MakeInputs(Inputs &in, size_t count)
+    {
+        Math::RandomGenerator rng(2024);
+        in.mats.resize(count);
+        in.points.resize(count);
+        in.scales.resize(count);
+        in.quats.resize(count);
+        in.t.resize(count);
+        rng.Fill(in.points.data(), count, Vector3(-100.0f, -100.0f, -100.0f), Vector3(100.0f, 100.0f, 100.0f));
+        rng.Fill(in.scales.data(), count, Vector3(0.5f, 0.5f, 0.5f), Vector3(2.0f, 2.0f, 2.0f));
+        rng.Fill(in.t.data(), count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            Vector3 axis = rng.NextVector3(Vector3(-1.0f, -1.0f, -1.0f), Vector3(1.0f, 1.0f, 1.0f));
+            if (axis.LengthSquared() < 1e-4f)
+                axis = Vector3::Up();
+            in.quats[i] = Quaternion::FromAxisAngle(axis.Normalized(), rng.NextFloat(-Math::PI, Math::PI));
+            in.mats[i] = Matrix4::TRS(in.points[i], in.quats[i], in.scales[i]);
+        }
+    }
+
+    struct Context
+    {
+        Bench::Report report;
+        const char *filter;
+        int repeat;
+        size_t singleOps; // 单个运算每轮执行次数
+
+        bool Enabled(const char *name) const
+        {
+            return filter == NULL || strstr(name, filter) != NULL;
+        }
+    };
+
+    // 单个运算：fn(i) 处理输入池中第 i 个元素
+    template <typename Fn>
+    void RunSingle(Context &ctx, const char *name, Fn fn)
+    {
+        if (!ctx.Enabled(name))
+            return;
+        size_t ops = ctx.singleOps;
+        double ns = TimeNsPerOp(ops, ctx.repeat, [&]() {
+            for (size_t i = 0; i < ops; ++i)
+                fn(i & (POOL - 1));
+        });
+        ctx.report.Add(name, 1, ns);
+    }
+
+    // 批量运算：fn() 处理 batch 个元素，重复到总量约 singleOps 个
+    template <typename Fn>
+    void RunBatch(Context &ctx, const char *name, size_t batch, Fn fn)
+    {
+        if (!ctx.Enabled(name))
+            return;
+        size_t calls = ctx.singleOps / batch;
+        if (calls == 0)
+            calls = 1;
+        double ns = TimeNsPerOp(calls * batch, ctx.repeat, [&]() {
+            for (size_t c = 0; c < calls; ++c)
+                fn();
+        });
+        ctx.report.Add(name, batch, ns);
+    }
+
+    // ======================================================================
+    // 单个运算
+    // ======================================================================
+    void BenchSingle(Context &ctx, const Inputs &in)
+    {
+        Matrix4 accM = Matrix4::Zero();
+        Vector3 accV = Vector3::Zero();
+        Quaternion accQ = Quaternion::Zero();
+        float acc = 0.0f;
+
+        RunSingle(ctx, "Matrix4::operator*(Matrix4)", [&](size_t i) {
+            accM += in.mats[i] * in.mats[(i + 1) & (POOL - 1)];
+        });
+        RunSingle(ctx, "Matrix4::MulMatrix4_Scalar", [&](size_t i) {
+            Matrix4 r;
+            Math::SIMD::MulMatrix4_Scalar(in.mats[i].m, in.mats[(i + 1) & (POOL - 1)].m, r.m);
+            accM += r;
+        });
+        RunSingle(ctx, "Matrix4::operator*(Vector3)", [&](size_t i) {
+            accV += in.mats[i] * in.points[i];
+        });
+        RunSingle(ctx, "Matrix4::Inversed", [&](size_t i) {
+            accM += in.mats[i].Inversed();
+        });
+        RunSingle(ctx, "Matrix4::InversedAffine", [&](size_t i) {
+            accM += in.mats[i].InversedAffine();
+        });
+        RunSingle(ctx, "Matrix4::TRS", [&](size_t i) {
+            accM += Matrix4::TRS(in.points[i], in.quats[i], in.scales[i]);
+        });
+        RunSingle(ctx, "Matrix4::LookAt", [&](size_t i) {
+            accM += Matrix4::LookAt(in.points[i], in.points[(i + 1) & (POOL - 1)], Vector3::Up());
+        });
+        RunSingle(ctx, "Matrix4::Perspective", [&](size_t i) {
+            accM += Matrix4::Perspective(0.5f + in.t[i], 16.0f / 9.0f, 0.1f, 1000.0f);
+        });
+        RunSingle(ctx, "Quaternion::Slerp", [&](size_t i) {
+            accQ = accQ + Quaternion::Slerp(in.quats[i], in.quats[(i + 1) & (POOL - 1)], in.t[i]);
+        });
+        RunSingle(ctx, "Quaternion::Nlerp", [&](size_t i) {
+            accQ = accQ + Quaternion::Nlerp(in.quats[i], in.quats[(i + 1) & (POOL - 1)], in.t[i]);
+        });
+        RunSingle(ctx, "Vector3::Normalized", [&](size_t i) {
+            accV += in.points[i].Normalized();
+        });
+        RunSingle(ctx, "Math::Fast::Normalized", [&](size_t i) {
+            accV += Math::Fast::Normalized(in.points[i]);
+        });
+        RunSingle(ctx, "Math::Lerp+Clamp", [&](size_t i) {
+            acc += Math::Clamp(Math::Lerp(in.points[i].x, in.points[i].y, in.t[i]), -50.0f, 50.0f);
+        });
+
+        Bench::g_sink = accM.m[0] + accV.x + accQ.w + acc;
+    }
+
+    // ======================================================================
+    // 批量运算
+    // ======================================================================
+    void BenchBatch(Context &ctx, const Inputs &in, const std::vector<size_t> &sizes)
+    {
+        size_t maxSize = sizes.back();
+        Math::RandomGenerator rng(7);
+        std::vector<Vector3> points(maxSize), out(maxSize);
+        rng.Fill(points.data(), maxSize, Vector3(-100.0f, -100.0f, -100.0f), Vector3(100.0f, 100.0f, 100.0f));
+
+        std::vector<Quaternion> qa(maxSize), qb(maxSize);
+        for (size_t i = 0; i < maxSize; ++i)
+        {
+            qa[i] = in.quats[i & (POOL - 1)];
+            qb[i] = in.quats[(i * 7 + 3) & (POOL - 1)];
+        }
+
+        const Matrix4 &m = in.mats[0];
+        float acc = 0.0f;
+
+        for (size_t s = 0; s < sizes.size(); ++s)
+        {
+            size_t n = sizes[s];
+
+            RunBatch(ctx, "Batch::TransformPoints AoS", n, [&]() {
+                Math::Batch::TransformPoints(m, points.data(), out.data(), n);
+            });
+            acc += out[n - 1].x;
+
+            RunBatch(ctx, "Batch::TransformDirections AoS", n, [&]() {
+                Math::Batch::TransformDirections(m, points.data(), out.data(), n);
+            });
+            acc += out[n - 1].y;
+
+            Math::Batch::Vector3SoA soaIn, soaOut;
+            soaIn.FromAoS(points.data(), n);
+            soaOut.Resize(n);
+            RunBatch(ctx, "Batch::TransformPoints SoA", n, [&]() {
+                Math::Batch::TransformPoints(m, soaIn, soaOut);
+            });
+            acc += soaOut.x[n - 1];
+
+            Math::Batch::QuaternionSoA a, b, r;
+            a.FromAoS(qa.data(), n);
+            b.FromAoS(qb.data(), n);
+            r.Resize(n);
+            RunBatch(ctx, "Batch::Slerp SoA", n, [&]() {
+                Math::Batch::Slerp(a, b, 0.35f, r);
+            });
+            acc += r.w[n - 1];
+
+            RunBatch(ctx, "Batch::Nlerp SoA", n, [&]() {
+                Math::Batch::Nlerp(a, b, 0.35f, r);
+            });
+            acc += r.w[n - 1];
+        }
+
+        Bench::g_sink = acc;
+    }
+
+    // 结果必须都是有限正数，否则说明计时或用例出错
+    bool Validate(const Bench::Report &report)
+    {
+        const std::vector<Bench::Result> &results = report.GetResults();
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            if (!(results[i].nsPerOp > 0.0) || !std::isfinite(results[i].nsPerOp))
+            {
+                fprintf(stderr, "[FAIL] %s: invalid timing %g\n", results[i].name.c_str(), results[i].nsPerOp);
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = Bench::HasFlag(argc, argv, "--quick");
+    const char *format = Bench::GetOption(argc, argv, "--format", "table");
+    const char *outPath = Bench::GetOption(argc, argv, "--out", NULL);
+
+    if (strcmp(format, "table") != 0 && strcmp(format, "csv") != 0 && strcmp(format, "json") != 0)
+    {
+        fprintf(stderr, "unknown format '%s' (table|csv|json)\n", format);
+        return 2;
+    }
+
+    Context ctx;
+    ctx.filter = Bench::GetOption(argc, argv, "--filter", NULL);
+    ctx.repeat = quick ? 2 : 10;
+    ctx.singleOps = quick ? 20000 : 1000000;
+
+    std::vector<size_t> sizes;
+    sizes.push_back(16);
+    sizes.push_back(256);
+    sizes.push_back(4096);
+    sizes.push_back(65536);
+    if (!quick)
+        sizes.push_back(1 << 20);
+
+    Inputs in;
+    MakeInputs(in, POOL);
+    BenchSingle(ctx, in);
+    BenchBatch(ctx, in, sizes);
+
+    if (!Validate(ctx.report))
+        return 1;
+
+    FILE *file = stdout;
+    if (outPath != NULL)
+    {
+        file = fopen(outPath, "w");
+        if (file == NULL)
+        {
+            fprintf(stderr, "cannot open '%s'\n", outPath);
+            return 2;
+        }
+    }
+    ctx.report.Write(file, format, Math::SIMD::PathName());
+    if (file != stdout)
+        fclose(file);
+    return 0;
+}
@@ -0,0 +1,226 @@
+#include "stdafx.h"
+#include "BenchUtils.h"
+#include "Math/MathSIMD.h"
+#include <cstring>
+#include <random>
+
+// ======================================================================
+// Matrix4 标量 / SIMD 路径对比
+//   MatrixBench [--quick]
+// 先校验两条路径结果一致（MATH_SIMD_EPSILON），再分别计时
+// ======================================================================
+
+namespace
+{
+    using Bench::TimeNsPerOp;
+
+    struct BenchData
+    {
+        std::vector<Matrix4> a;
+        std::vector<Matrix4> b;
+        std::vector<Matrix4> out;
+        std::vector<Vector4> vecs;
+        std::vector<Vector3> pos;
+        std::vector<Quaternion> rot;
+        std::vector<Vector3> scl;
+    };
+
+    void FillRandom(BenchData &data, size_t count)
+    {
+        std::mt19937 rng(12345);
+        std::uniform_real_distribution<float> dist(-2.0f, 2.0f);
+
+        data.a.resize(count);
+        data.b.resize(count);
+        data.out.resize(count);
+        data.vecs.resize(count);
+        data.pos.resize(count);
+        data.rot.resize(count);
+        data.scl.resize(count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            for (int k = 0; k < 16; ++k)
+            {
+                data.a[i].m[k] = dist(rng);
+                data.b[i].m[k] = dist(rng);
+            }
+            data.vecs[i] = Vector4(dist(rng), dist(rng), dist(rng), 1.0f);
+            data.pos[i] = Vector3(dist(rng), dist(rng), dist(rng)) * 50.0f;
+            data.rot[i] = Quaternion(dist(rng), dist(rng), dist(rng), dist(rng)).Normalized();
+            data.scl[i] = Vector3(1.0f + dist(rng) * 0.25f, 1.0f + dist(rng) * 0.25f, 1.0f + dist(rng) * 0.25f);
+        }
+    }
+
+    // ======================================================================
+    // 正确性校验
+    // ======================================================================
+    bool VerifyKernels(const BenchData &data)
+    {
+        int failures = 0;
+        for (size_t i = 0; i < data.a.size(); ++i)
+        {
+            float ref[16], simd[16];
+            Math::SIMD::MulMatrix4_Scalar(data.a[i].m, data.b[i].m, ref);
+            Math::SIMD::MulMatrix4(data.a[i].m, data.b[i].m, simd);
+            if (!Math::SIMD::NearlyEqual(ref, simd, 16))
+                ++failures;
+
+            // 原地相乘（out 与输入重叠）
+            Matrix4 inPlace = data.a[i];
+            inPlace *= data.b[i];
+            if (!Math::SIMD::NearlyEqual(ref, inPlace.m, 16))
+                ++failures;
+
+            float v[4] = {data.vecs[i].x, data.vecs[i].y, data.vecs[i].z, data.vecs[i].w};
+            float vr[4], vs[4];
+            Math::SIMD::TransformVec4_Scalar(data.a[i].m, v, vr);
+            Math::SIMD::TransformVec4(data.a[i].m, v, vs);
+            if (!Math::SIMD::NearlyEqual(vr, vs, 4))
+                ++failures;
+
+            // TRS 闭式结果与 T * R * S 三次构造相乘一致
+            Matrix4 trs = Matrix4::TRS(data.pos[i], data.rot[i], data.scl[i]);
+            Matrix4 composed = Matrix4::Translation(data.pos[i]) * Matrix4::Rotation(data.rot[i]) * Matrix4::Scale(data.scl[i]);
+            if (!Math::SIMD::NearlyEqual(trs.m, composed.m, 16))
+                ++failures;
+        }
+
+        // 逆矩阵：M * M^-1 ≈ I（通用逆用随机矩阵，仿射逆用 TRS）
+        const float identity[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+        for (size_t i = 0; i < data.a.size(); ++i)
+        {
+            float inv[16], prod[16];
+            if (Math::SIMD::InverseMatrix4_Scalar(data.a[i].m, inv) != 0.0f)
+            {
+                Math::SIMD::MulMatrix4(data.a[i].m, inv, prod);
+                if (!Math::SIMD::NearlyEqual(prod, identity, 16, 1e-3f))
+                    ++failures;
+
+                float simdInv[16];
+                Math::SIMD::InverseMatrix4(data.a[i].m, simdInv);
+                if (!Math::SIMD::NearlyEqual(inv, simdInv, 16, 1e-3f))
+                    ++failures;
+            }
+
+            Matrix4 trs = Matrix4::TRS(data.pos[i], data.rot[i], data.scl[i]);
+            Matrix4 affine = trs.InversedAffine();
+            Matrix4 general = trs.Inversed();
+            if (!Math::SIMD::NearlyEqual(affine.m, general.m, 16, 1e-4f) ||
+                !Math::SIMD::NearlyEqual((trs * affine).m, identity, 16, 1e-4f))
+                ++failures;
+        }
+
+        if (failures > 0)
+            printf("[FAIL] %d kernel mismatches (eps = %g)\n", failures, MATH_SIMD_EPSILON);
+        else
+            printf("[ OK ] scalar and %s paths agree within %g\n", Math::SIMD::PathName(), MATH_SIMD_EPSILON);
+        return failures == 0;
+    }
+
+    // ======================================================================
+    // 计时
+    // ======================================================================
+
+    float Checksum(const std::vector<Matrix4> &mats)
+    {
+        float sum = 0.0f;
+        for (size_t i = 0; i < mats.size(); ++i)
+            sum += mats[i].m[0] + mats[i].m[15];
+        return sum;
+    }
+
+    void Report(const char *name, double scalarNs, double simdNs)
+    {
+        printf("%-20s scalar %8.2f ns/op   %-6s %8.2f ns/op   x%.2f\n",
+               name, scalarNs, Math::SIMD::PathName(), simdNs, scalarNs / simdNs);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--quick") == 0)
+            quick = true;
+    }
+
+    const size_t count = quick ? 1024 : 16384;
+    const int repeat = quick ? 3 : 20;
+
+    BenchData data;
+    FillRandom(data, count);
+
+    if (!VerifyKernels(data))
+        return 1;
+
+    double scalarNs = TimeNsPerOp(count, repeat, [&]() {
+        for (size_t i = 0; i < count; ++i)
+            Math::SIMD::MulMatrix4_Scalar(data.a[i].m, data.b[i].m, data.out[i].m);
+    });
+    float sink = Checksum(data.out);
+    double simdNs = TimeNsPerOp(count, repeat, [&]() {
+        for (size_t i = 0; i < count; ++i)
+            Math::SIMD::MulMatrix4(data.a[i].m, data.b[i].m, data.out[i].m);
+    });
+    sink += Checksum(data.out);
+    Report("Matrix4 * Matrix4", scalarNs, simdNs);
+
+    std::vector<Vector4> vout(count);
+    scalarNs = TimeNsPerOp(count, repeat, [&]() {
+        for (size_t i = 0; i < count; ++i)
+            Math::SIMD::TransformVec4_Scalar(data.a[i].m, &data.vecs[i].x, &vout[i].x);
+    });
+    sink += vout[count / 2].x;
+    simdNs = TimeNsPerOp(count, repeat, [&]() {
+        for (size_t i = 0; i < count; ++i)
+            Math::SIMD::TransformVec4(data.a[i].m, &data.vecs[i].x, &vout[i].x);
+    });
+    sink += vout[count / 2].x;
+    Report("Matrix4 * Vector4", scalarNs, simdNs);
+
+    // TRS: 旧实现（三次构造 + 两次矩阵乘）对比闭式合成
+    scalarNs = TimeNsPerOp(count, repeat, [&]() {
+        for (size_t i = 0; i < count; ++i)
+            data.out[i] = Matrix4::Translation(data.pos[i]) * Matrix4::Rotation(data.rot[i]) * Matrix4::Scale(data.scl[i]);
+    });
+    sink += Checksum(data.out);
+    simdNs = TimeNsPerOp(count, repeat, [&]() {
+        for (size_t i = 0; i < count; ++i)
+            data.out[i] = Matrix4::TRS(data.pos[i], data.rot[i], data.scl[i]);
+    });
+    sink += Checksum(data.out);
+    Report("TRS (T*R*S vs TRS)", scalarNs, simdNs);
+
+    scalarNs = TimeNsPerOp(count, repeat, [&]() {
+        for (size_t i = 0; i < count; ++i)
+            Math::SIMD::InverseMatrix4_Scalar(data.a[i].m, data.out[i].m);
+    });
+    sink += Checksum(data.out);
+    simdNs = TimeNsPerOp(count, repeat, [&]() {
+        for (size_t i = 0; i < count; ++i)
+            Math::SIMD::InverseMatrix4(data.a[i].m, data.out[i].m);
+    });
+    sink += Checksum(data.out);
+    Report("Inverse (general)", scalarNs, simdNs);
+
+    // 仿射逆：标量通用逆 vs SIMD 仿射逆
+    std::vector<Matrix4> trs(count);
+    for (size_t i = 0; i < count; ++i)
+        trs[i] = Matrix4::TRS(data.pos[i], data.rot[i], data.scl[i]);
+    scalarNs = TimeNsPerOp(count, repeat, [&]() {
+        for (size_t i = 0; i < count; ++i)
+            Math::SIMD::InverseMatrix4_Scalar(trs[i].m, data.out[i].m);
+    });
+    sink += Checksum(data.out);
+    simdNs = TimeNsPerOp(count, repeat, [&]() {
+        for (size_t i = 0; i < count; ++i)
+            Math::SIMD::InverseAffine(trs[i].m, data.out[i].m);
+    });
+    sink += Checksum(data.out);
+    Report("Inverse (affine)", scalarNs, simdNs);
+
+    printf("checksum %g\n", sink);
+    return 0;
+}
@@ -0,0 +1,269 @@
+#include "stdafx.h"
+#include "BenchUtils.h"
+#include "Core/NameIndex.h"
+#include "Math/Random.h"
+#include <algorithm>
+#include <memory>
+
+// ======================================================================
+// CNameIndex 正确性与查找耗时
+//   NameIndexBench [--quick]
+// 校验：随机增删名称/标签、改名后，按名称/标签查询结果与逐个比较一致；驻留编号稳定；
+//       默认名称与显式同名共用一个桶，空名称不进入索引
+// 对比：旧 FindChildByName（递归深度优先、逐个比较字符串）与索引查找，场景 1k~100k 实体
+// CEntity 依赖 Win32/OpenGL，这里用只有名称与子节点的替身树
+// ======================================================================
+
+namespace
+{
+    typedef CNameIndex::NameId NameId;
+
+    std::wstring MakeName(const wchar_t *prefix, int i)
+    {
+        return prefix + std::to_wstring(i);
+    }
+
+    bool SameSet(std::vector<unsigned int> a, std::vector<unsigned int> b)
+    {
+        std::sort(a.begin(), a.end());
+        std::sort(b.begin(), b.end());
+        return a == b;
+    }
+
+    bool VerifyIntern()
+    {
+        bool ok = true;
+        NameId a = CNameIndex::Intern(L"Player");
+        NameId b = CNameIndex::Intern(std::wstring(L"Play") + L"er");
+        ok = Bench::Check(a != CNameIndex::INVALID_NAME && a == b, "same string interns to same id") && ok;
+        ok = Bench::Check(CNameIndex::Intern(L"Enemy") != a, "different strings differ") && ok;
+        ok = Bench::Check(CNameIndex::Intern(L"") == CNameIndex::INVALID_NAME, "empty string is invalid") && ok;
+        ok = Bench::Check(CNameIndex::FindName(L"never interned name") == CNameIndex::INVALID_NAME, "FindName does not intern") && ok;
+
+        // 大量驻留后早先返回的引用仍然有效
+        const std::wstring &player = CNameIndex::GetString(a);
+        for (int i = 0; i < 20000; ++i)
+            CNameIndex::Intern(MakeName(L"intern_", i));
+        ok = Bench::Check(player == L"Player" && CNameIndex::GetString(CNameIndex::FindName(L"intern_123")) == L"intern_123", "interned strings stay valid") && ok;
+        return ok;
+    }
+
+    bool VerifyIndex()
+    {
+        const int entityCount = 3000;
+        const int nameCount = 200;
+        const int tagCount = 8;
+        Math::RandomGenerator rng(14);
+        CNameIndex index;
+
+        // 参考：逐个实体记录名称与标签
+        std::vector<NameId> nameOf(entityCount + 1, CNameIndex::INVALID_NAME);
+        std::vector<std::vector<NameId>> tagsOf(entityCount + 1);
+        std::vector<NameId> names, tags;
+        for (int i = 0; i < nameCount; ++i)
+            names.push_back(CNameIndex::Intern(MakeName(L"name_", i)));
+        for (int i = 0; i < tagCount; ++i)
+            tags.push_back(CNameIndex::Intern(MakeName(L"tag_", i)));
+
+        int mismatches = 0;
+        for (int step = 0; step < 50000; ++step)
+        {
+            unsigned int id = (unsigned int)rng.NextInt(1, entityCount + 1);
+            switch (rng.NextInt(0, 4))
+            {
+            case 0: // 改名（含首次命名）
+            {
+                NameId name = names[rng.NextInt(0, nameCount)];
+                index.RemoveName(id, nameOf[id]);
+                index.AddName(id, name);
+                nameOf[id] = name;
+                break;
+            }
+            case 1: // 离开索引
+                index.RemoveName(id, nameOf[id]);
+                nameOf[id] = CNameIndex::INVALID_NAME;
+                break;
+            case 2:
+            {
+                NameId tag = tags[rng.NextInt(0, tagCount)];
+                index.AddTag(id, tag); // 重复添加应被忽略
+                if (std::find(tagsOf[id].begin(), tagsOf[id].end(), tag) == tagsOf[id].end())
+                    tagsOf[id].push_back(tag);
+                break;
+            }
+            default:
+            {
+                NameId tag = tags[rng.NextInt(0, tagCount)];
+                index.RemoveTag(id, tag);
+                tagsOf[id].erase(std::remove(tagsOf[id].begin(), tagsOf[id].end(), tag), tagsOf[id].end());
+                break;
+            }
+            }
+
+            if (step % 5000 == 0 || step == 49999)
+            {
+                for (int n = 0; n < nameCount; ++n)
+                {
+                    std::vector<unsigned int> expected;
+                    for (unsigned int e = 1; e <= (unsigned int)entityCount; ++e)
+                        if (nameOf[e] == names[n])
+                            expected.push_back(e);
+                    mismatches += SameSet(index.FindAll(names[n]), expected) ? 0 : 1;
+                    unsigned int first = index.FindFirst(names[n]);
+                    mismatches += (expected.empty() ? first == 0 : nameOf[first] == names[n]) ? 0 : 1;
+                }
+                for (int t = 0; t < tagCount; ++t)
+                {
+                    std::vector<unsigned int> expected;
+                    for (unsigned int e = 1; e <= (unsigned int)entityCount; ++e)
+                        if (std::find(tagsOf[e].begin(), tagsOf[e].end(), tags[t]) != tagsOf[e].end())
+                            expected.push_back(e);
+                    mismatches += SameSet(index.FindTagged(tags[t]), expected) ? 0 : 1;
+                }
+            }
+        }
+
+        bool ok = Bench::Check(mismatches == 0, "name/tag buckets match brute force after random edits");
+        ok = Bench::Check(index.FindAll(CNameIndex::Intern(L"unused name")).empty(), "unknown name yields empty bucket") && ok;
+        index.Clear();
+        ok = Bench::Check(index.GetEntryCount() == 0 && index.FindFirst(names[0]) == 0, "Clear") && ok;
+        return ok;
+    }
+
+    // CEntity 的默认名称 "New Entity" 是普通的驻留名称：未改名的实体与显式取同名的实体都能查到；
+    // SetName(L"") 得到 INVALID_NAME，不进入索引
+    bool VerifyDefaultName()
+    {
+        CNameIndex index;
+        NameId defaultName = CNameIndex::Intern(L"New Entity");
+        index.AddName(1, defaultName);                      // 未改名
+        index.AddName(2, CNameIndex::Intern(L"New Entity")); // 显式取默认名称
+        index.AddName(3, CNameIndex::Intern(L"Player"));
+        index.AddName(4, CNameIndex::Intern(L""));
+
+        bool ok = Bench::Check(SameSet(index.FindAll(CNameIndex::FindName(L"New Entity")), {1, 2}), "default name is indexed like any other name");
+        ok = Bench::Check(index.FindAll(CNameIndex::INVALID_NAME).empty() && index.GetEntryCount() == 3, "empty name is not indexed") && ok;
+
+        index.RemoveName(4, CNameIndex::INVALID_NAME); // 空名称改名时照常先移除
+        index.RemoveName(2, defaultName);
+        ok = Bench::Check(index.FindFirst(defaultName) == 1 && index.GetEntryCount() == 2, "renaming away from default name") && ok;
+        return ok;
+    }
+
+    bool Verify()
+    {
+        bool ok = VerifyIntern();
+        ok = VerifyIndex() && ok;
+        ok = VerifyDefaultName() && ok;
+        if (ok)
+            printf("[ OK ] interning, name index, tag index and default name\n");
+        return ok;
+    }
+
+    // ======================================================================
+    // 对照：旧的递归查找
+    // ======================================================================
+    struct Node
+    {
+        unsigned int id;
+        std::wstring name;
+        std::vector<std::unique_ptr<Node>> children;
+    };
+
+    const Node *FindByName(const Node *node, const std::wstring &name)
+    {
+        if (node->name == name)
+            return node;
+        for (size_t i = 0; i < node->children.size(); ++i)
+        {
+            if (const Node *found = FindByName(node->children[i].get(), name))
+                return found;
+        }
+        return nullptr;
+    }
+
+    void CollectTagged(const Node *node, unsigned int tagEvery, std::vector<unsigned int> &out)
+    {
+        if (node->id % tagEvery == 0)
+            out.push_back(node->id);
+        for (size_t i = 0; i < node->children.size(); ++i)
+            CollectTagged(node->children[i].get(), tagEvery, out);
+    }
+
+    void BenchLookup(bool quick)
+    {
+        const size_t sizes[] = {1000, 10000, 100000};
+        const int lookups = quick ? 200 : 2000;
+        printf("%-10s %18s %18s %18s %18s\n", "entities", "DFS find ns", "index find ns", "DFS tag ns", "index tag ns");
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+        {
+            const size_t count = sizes[s];
+            if (quick && count > 10000)
+                break;
+
+            // 父节点从最近创建的 512 个节点中随机选取，每 100 个实体带一个 "Enemy" 标签
+            Math::RandomGenerator rng(3);
+            CNameIndex index;
+            NameId enemy = CNameIndex::Intern(L"Enemy");
+            Node root;
+            root.id = 1;
+            root.name = L"Root";
+            std::vector<Node *> nodes(1, &root);
+            for (size_t i = 1; i < count; ++i)
+            {
+                Node *parent = nodes[(size_t)rng.NextInt(std::max(0, (int)nodes.size() - 8 * 64), (int)nodes.size())];
+                std::unique_ptr<Node> node(new Node());
+                node->id = (unsigned int)i + 1;
+                node->name = MakeName(L"Entity_", (int)i);
+                index.AddName(node->id, CNameIndex::Intern(node->name));
+                if (node->id % 100 == 0)
+                    index.AddTag(node->id, enemy);
+                nodes.push_back(node.get());
+                parent->children.push_back(std::move(node));
+            }
+
+            std::vector<std::wstring> queries;
+            for (int q = 0; q < lookups; ++q)
+                queries.push_back(MakeName(L"Entity_", rng.NextInt(1, (int)count)));
+
+            // 递归查找在大场景下很慢，只取一部分查询
+            size_t dfsLookups = std::max<size_t>(20, lookups * 1000 / count);
+            size_t acc = 0;
+            double dfs = Bench::TimeNsPerOp(dfsLookups, 1, [&]() {
+                for (size_t q = 0; q < dfsLookups; ++q)
+                    acc += FindByName(&root, queries[q])->id;
+            });
+            double indexed = Bench::TimeNsPerOp(lookups, 3, [&]() {
+                for (size_t q = 0; q < queries.size(); ++q)
+                    acc += index.FindFirst(CNameIndex::FindName(queries[q]));
+            });
+
+            std::vector<unsigned int> tagged;
+            double dfsTag = Bench::TimeNsPerOp(1, 3, [&]() {
+                tagged.clear();
+                CollectTagged(&root, 100, tagged);
+            });
+            size_t expectedTagged = tagged.size();
+            double indexTag = Bench::TimeNsPerOp(1, 3, [&]() {
+                tagged.clear();
+                const std::vector<unsigned int> &ids = index.FindTagged(enemy);
+                tagged.insert(tagged.end(), ids.begin(), ids.end());
+            });
+            acc += tagged.size() == expectedTagged ? 0 : 1;
+            Bench::g_sink = acc;
+
+            printf("%-10zu %18.1f %18.1f %18.1f %18.1f\n", count, dfs, indexed, dfsTag, indexTag);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = Bench::HasFlag(argc, argv, "--quick");
+
+    if (!Verify())
+        return 1;
+
+    BenchLookup(quick);
+    return 0;
+}
@@ -0,0 +1,365 @@
+#include "stdafx.h"
+#include "BenchUtils.h"
+#include "Core/JobSystem.h"
+#include "Core/OcclusionBuffer.h"
+#include "Math/MathSIMD.h"
+#include "Math/Random.h"
+#include <algorithm>
+#include <cmath>
+
+// ======================================================================
+// 软件遮挡剔除
+//   OcclusionBench [--quick]
+// 校验：平面遮挡体的深度与投影一致，背面剔除，近平面裁剪；
+//       随机三角形与逐像素参考实现一致；多线程与单线程结果逐位相同；
+//       判为被遮住的包围盒表面采样点都在深度图之后
+// 对比：起伏地形作遮挡体，单线程 / 任务系统的光栅化耗时与包围盒测试耗时
+// ======================================================================
+
+namespace
+{
+    const float FOV = Math::PI / 3.0f;
+    const float NEAR_CLIP = 0.5f;
+    const float FAR_CLIP = 500.0f;
+
+    Matrix4 MakeViewProjection(const Vector3 &eye, const Vector3 &target)
+    {
+        return Matrix4::Perspective(FOV, 16.0f / 9.0f, NEAR_CLIP, FAR_CLIP) * Matrix4::LookAt(eye, target, Vector3::Up());
+    }
+
+    // 深度图中 (x, y) 像素，越界时返回 -1
+    float DepthAt(const std::vector<float> &depth, const COcclusionBuffer &buffer, int x, int y)
+    {
+        if (x < 0 || y < 0 || x >= buffer.GetWidth() || y >= buffer.GetHeight())
+            return -1.0f;
+        return depth[(size_t)y * buffer.GetWidth() + x];
+    }
+
+    // 世界空间点投影到像素坐标与 [0, 1] 深度，在近平面后方时返回 false
+    bool Project(const Matrix4 &viewProjection, const COcclusionBuffer &buffer, const Vector3 &p, float &x, float &y, float &z)
+    {
+        Vector4 clip = viewProjection * Vector4(p.x, p.y, p.z, 1.0f);
+        if (clip.w <= 0.0f || clip.z < -clip.w)
+            return false;
+        x = (clip.x / clip.w * 0.5f + 0.5f) * buffer.GetWidth();
+        y = (clip.y / clip.w * 0.5f + 0.5f) * buffer.GetHeight();
+        z = clip.z / clip.w * 0.5f + 0.5f;
+        return true;
+    }
+
+    // 起伏地形：(n + 1)^2 个顶点，跨度 size，中心在原点；从上方看逆时针
+    float TerrainHeight(float x, float z)
+    {
+        return 8.0f * std::sin(x * 0.05f) * std::cos(z * 0.04f) + 4.0f * std::sin(z * 0.11f + 1.0f);
+    }
+
+    void MakeTerrain(int n, float size, std::vector<Vector3> &positions, std::vector<unsigned int> &indices)
+    {
+        positions.clear();
+        indices.clear();
+        for (int z = 0; z <= n; ++z)
+        {
+            for (int x = 0; x <= n; ++x)
+            {
+                float px = (x / (float)n - 0.5f) * size, pz = (z / (float)n - 0.5f) * size;
+                positions.push_back(Vector3(px, TerrainHeight(px, pz), pz));
+            }
+        }
+        for (int z = 0; z < n; ++z)
+        {
+            for (int x = 0; x < n; ++x)
+            {
+                unsigned int i0 = z * (n + 1) + x, i1 = i0 + n + 1, i2 = i0 + 1, i3 = i1 + 1;
+                unsigned int quad[6] = {i0, i1, i2, i2, i1, i3};
+                indices.insert(indices.end(), quad, quad + 6);
+            }
+        }
+    }
+
+    // ======================================================================
+    // 正确性
+    // ======================================================================
+    // 相机在原点看 -z，z = -10 处 10x10 的正方形
+    bool VerifyQuad()
+    {
+        COcclusionBuffer buffer;
+        Matrix4 viewProjection = MakeViewProjection(Vector3::Zero(), Vector3(0, 0, -1));
+        const Vector3 quad[4] = {Vector3(-5, -5, -10), Vector3(5, -5, -10), Vector3(5, 5, -10), Vector3(-5, 5, -10)};
+        const unsigned int front[6] = {0, 1, 2, 0, 2, 3};
+        const unsigned int back[6] = {0, 2, 1, 0, 3, 2};
+
+        buffer.Begin(viewProjection);
+        buffer.AddOccluder(&quad[0].x, 4, sizeof(Vector3), front, 6, Matrix4::Identity());
+        buffer.Rasterize();
+        std::vector<float> depth;
+        buffer.ReadDepth(depth);
+
+        float cx, cy, cz;
+        Project(viewProjection, buffer, Vector3(0, 0, -10), cx, cy, cz);
+        const int w = buffer.GetWidth(), h = buffer.GetHeight();
+        bool ok = Bench::Check(std::fabs(DepthAt(depth, buffer, w / 2, h / 2) - cz) < 1e-5f, "quad depth matches projection");
+        ok = Bench::Check(DepthAt(depth, buffer, 0, 0) == 1.0f && DepthAt(depth, buffer, w - 1, h - 1) == 1.0f, "pixels outside quad stay clear") && ok;
+        ok = Bench::Check(buffer.GetStats().rasterized == 2, "both quad triangles rasterized") && ok;
+
+        // 正方形后方（z = -20 时覆盖 [-10, 10]）
+        ok = Bench::Check(buffer.IsOccluded(AABB(Vector3(-1, -1, -21), Vector3(1, 1, -19))), "box behind quad occluded") && ok;
+        ok = Bench::Check(!buffer.IsOccluded(AABB(Vector3(-1, -1, -6), Vector3(1, 1, -4))), "box in front of quad visible") && ok;
+        ok = Bench::Check(!buffer.IsOccluded(AABB(Vector3(15, -1, -21), Vector3(17, 1, -19))), "box beside quad visible") && ok;
+        ok = Bench::Check(!buffer.IsOccluded(AABB(Vector3(8, -1, -21), Vector3(12, 1, -19))), "box straddling quad edge visible") && ok;
+        ok = Bench::Check(!buffer.IsOccluded(AABB(Vector3(-1, -1, -1), Vector3(1, 1, 1))), "box across near plane visible") && ok;
+        ok = Bench::Check(!buffer.IsOccluded(AABB(Vector3(-1, -1, -10.5f), Vector3(1, 1, -9.5f))), "box through quad visible") && ok;
+
+        // 背面：默认剔除，关闭后照常光栅化
+        buffer.Begin(viewProjection);
+        buffer.AddOccluder(&quad[0].x, 4, sizeof(Vector3), back, 6, Matrix4::Identity());
+        buffer.Rasterize();
+        buffer.ReadDepth(depth);
+        ok = Bench::Check(DepthAt(depth, buffer, w / 2, h / 2) == 1.0f && buffer.GetStats().rasterized == 0, "back faces culled") && ok;
+
+        buffer.SetBackfaceCulling(false);
+        buffer.Begin(viewProjection);
+        buffer.AddOccluder(&quad[0].x, 4, sizeof(Vector3), back, 6, Matrix4::Identity());
+        buffer.Rasterize();
+        buffer.ReadDepth(depth);
+        ok = Bench::Check(std::fabs(DepthAt(depth, buffer, w / 2, h / 2) - cz) < 1e-5f, "back faces drawn without culling") && ok;
+
+        // world 变换：同一正方形平移到 z = -30
+        buffer.SetBackfaceCulling(true);
+        buffer.Begin(viewProjection);
+        buffer.AddOccluder(&quad[0].x, 4, sizeof(Vector3), front, 6, Matrix4::Translation(Vector3(0, 0, -20)));
+        buffer.Rasterize();
+        buffer.ReadDepth(depth);
+        Project(viewProjection, buffer, Vector3(0, 0, -30), cx, cy, cz);
+        ok = Bench::Check(std::fabs(DepthAt(depth, buffer, w / 2, h / 2) - cz) < 1e-5f, "occluder world transform applied") && ok;
+        return ok;
+    }
+
+    // 穿过相机下方的大地面：近平面裁剪后下半屏有深度、上半屏为空，深度向地平线增大
+    bool VerifyNearClip()
+    {
+        COcclusionBuffer buffer;
+        Matrix4 viewProjection = MakeViewProjection(Vector3::Zero(), Vector3(0, 0, -1));
+        const Vector3 ground[4] = {Vector3(-1000, -2, 1000), Vector3(1000, -2, 1000), Vector3(1000, -2, -1000), Vector3(-1000, -2, -1000)};
+        const unsigned int indices[6] = {0, 1, 2, 0, 2, 3};
+
+        buffer.Begin(viewProjection);
+        buffer.AddOccluder(&ground[0].x, 4, sizeof(Vector3), indices, 6, Matrix4::Identity());
+        buffer.Rasterize();
+        std::vector<float> depth;
+        buffer.ReadDepth(depth);
+
+        const int w = buffer.GetWidth(), h = buffer.GetHeight();
+        bool finite = true, monotonic = true;
+        for (size_t i = 0; i < depth.size(); ++i)
+            finite = finite && std::isfinite(depth[i]) && depth[i] >= 0.0f && depth[i] <= 1.0f;
+        for (int y = 1; y < h / 2 - 1; ++y)
+            monotonic = monotonic && DepthAt(depth, buffer, w / 2, y) >= DepthAt(depth, buffer, w / 2, y - 1);
+
+        bool ok = Bench::Check(finite, "clipped ground depth finite and in range");
+        ok = Bench::Check(DepthAt(depth, buffer, w / 2, 0) < 1.0f && DepthAt(depth, buffer, 0, 0) < 1.0f, "ground covers bottom row") && ok;
+        ok = Bench::Check(DepthAt(depth, buffer, w / 2, h - 1) == 1.0f, "sky stays clear") && ok;
+        ok = Bench::Check(monotonic, "ground depth grows toward horizon") && ok;
+        ok = Bench::Check(buffer.IsOccluded(AABB(Vector3(-1, -6, -30), Vector3(1, -4, -28))), "box under ground occluded") && ok;
+        ok = Bench::Check(!buffer.IsOccluded(AABB(Vector3(-1, -1.5f, -30), Vector3(1, 0, -28))), "box on ground visible") && ok;
+        return ok;
+    }
+
+    // 随机三角形与逐像素的参考实现比较：像素中心用重心坐标判断，深度按屏幕空间线性插值
+    bool VerifyReference()
+    {
+        Math::RandomGenerator rng(17);
+        COcclusionBuffer buffer(160, 96);
+        Matrix4 viewProjection = MakeViewProjection(Vector3::Zero(), Vector3(0, 0, -1));
+        buffer.SetBackfaceCulling(false);
+
+        std::vector<Vector3> positions;
+        std::vector<unsigned int> indices;
+        for (int t = 0; t < 300; ++t)
+        {
+            Vector3 center = rng.NextVector3(Vector3(-40, -25, -80), Vector3(40, 25, -5));
+            for (int k = 0; k < 3; ++k)
+            {
+                indices.push_back((unsigned int)positions.size());
+                positions.push_back(center + rng.NextVector3(Vector3(-8, -8, -4), Vector3(8, 8, 4)));
+            }
+        }
+        // 全部在近平面前方，参考实现不需要裁剪
+        for (size_t i = 0; i < positions.size(); ++i)
+            positions[i].z = std::min(positions[i].z, -1.0f);
+
+        buffer.Begin(viewProjection);
+        buffer.AddOccluder(&positions[0].x, positions.size(), sizeof(Vector3), indices.data(), indices.size(), Matrix4::Identity());
+        buffer.Rasterize();
+        std::vector<float> depth;
+        buffer.ReadDepth(depth);
+
+        const int w = buffer.GetWidth(), h = buffer.GetHeight();
+        std::vector<float> reference((size_t)w * h, 1.0f);
+        std::vector<uint8_t> ambiguous((size_t)w * h, 0);
+        for (size_t t = 0; t < indices.size(); t += 3)
+        {
+            float x[3], y[3], z[3];
+            for (int k = 0; k < 3; ++k)
+                Project(viewProjection, buffer, positions[indices[t + k]], x[k], y[k], z[k]);
+            float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+            if (area == 0.0f)
+                continue;
+            for (int py = 0; py < h; ++py)
+            {
+                for (int px = 0; px < w; ++px)
+                {
+                    float cx = px + 0.5f, cy = py + 0.5f;
+                    float b[3];
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        int n = (k + 1) % 3, o = (k + 2) % 3;
+                        b[o] = ((x[n] - x[k]) * (cy - y[k]) - (y[n] - y[k]) * (cx - x[k])) / area;
+                    }
+                    size_t i = (size_t)py * w + px;
+                    // 像素中心离边很近时两种算法的舍入可能不同
+                    float edge = std::min(b[0], std::min(b[1], b[2])) * std::fabs(area) /
+                                 std::max(std::max(std::fabs(x[1] - x[0]), std::fabs(x[2] - x[1])), 1.0f);
+                    if (std::fabs(edge) < 1e-3f)
+                        ambiguous[i] = 1;
+                    if (b[0] >= 0.0f && b[1] >= 0.0f && b[2] >= 0.0f)
+                        reference[i] = std::min(reference[i], b[0] * z[0] + b[1] * z[1] + b[2] * z[2]);
+                }
+            }
+        }
+
+        size_t wrong = 0, covered = 0;
+        for (size_t i = 0; i < depth.size(); ++i)
+        {
+            covered += reference[i] < 1.0f;
+            if (!ambiguous[i] && std::fabs(depth[i] - reference[i]) > 1e-4f)
+                ++wrong;
+        }
+        if (wrong != 0)
+            printf("       %zu of %zu pixels differ\n", wrong, depth.size());
+        bool ok = Bench::Check(covered > depth.size() / 4, "reference scene covers the buffer");
+        return Bench::Check(wrong == 0, "rasterizer matches per-pixel reference") && ok;
+    }
+
+    // 多线程与单线程结果逐位相同；被遮住的包围盒表面采样点都在深度图之后
+    bool VerifyTerrain(CJobSystem &jobs)
+    {
+        std::vector<Vector3> positions;
+        std::vector<unsigned int> indices;
+        MakeTerrain(96, 400.0f, positions, indices);
+        Vector3 eye(0.0f, TerrainHeight(0.0f, 0.0f) + 2.0f, 0.0f);
+        Matrix4 viewProjection = MakeViewProjection(eye, eye + Vector3(0.2f, -0.05f, -1.0f));
+
+        COcclusionBuffer serial, parallel;
+        serial.Begin(viewProjection);
+        parallel.Begin(viewProjection);
+        serial.AddOccluder(&positions[0].x, positions.size(), sizeof(Vector3), indices.data(), indices.size(), Matrix4::Identity());
+        parallel.AddOccluder(&positions[0].x, positions.size(), sizeof(Vector3), indices.data(), indices.size(), Matrix4::Identity());
+        serial.Rasterize();
+        parallel.Rasterize(&jobs);
+
+        std::vector<float> a, b;
+        serial.ReadDepth(a);
+        parallel.ReadDepth(b);
+        bool ok = Bench::Check(a == b, "threaded rasterization matches serial");
+
+        Math::RandomGenerator rng(23);
+        std::vector<AABB> boxes(5000);
+        for (size_t i = 0; i < boxes.size(); ++i)
+        {
+            float x = rng.NextFloat(-150.0f, 150.0f), z = rng.NextFloat(-190.0f, 5.0f);
+            Vector3 base(x, TerrainHeight(x, z), z);
+            boxes[i] = AABB(base - Vector3(0.5f, 0.0f, 0.5f), base + Vector3(0.5f, 1.5f, 0.5f));
+        }
+        std::vector<uint8_t> flags(boxes.size());
+        size_t hidden = parallel.TestAABBs(boxes.data(), boxes.size(), flags.data(), &jobs);
+
+        size_t mismatched = 0, leaking = 0;
+        for (size_t i = 0; i < boxes.size(); ++i)
+        {
+            mismatched += (flags[i] != 0) != serial.IsOccluded(boxes[i]);
+            if (!flags[i])
+                continue;
+            for (int s = 0; s < 64; ++s)
+            {
+                Vector3 p = rng.NextVector3(boxes[i].min, boxes[i].max);
+                float px, py, pz;
+                if (!Project(viewProjection, serial, p, px, py, pz))
+                    continue;
+                float d = DepthAt(a, serial, (int)std::floor(px), (int)std::floor(py));
+                if (d >= 0.0f && d >= pz)
+                    ++leaking;
+            }
+        }
+        ok = Bench::Check(mismatched == 0, "TestAABBs matches IsOccluded") && ok;
+        ok = Bench::Check(hidden > 0 && hidden < boxes.size(), "terrain hides some boxes") && ok;
+        ok = Bench::Check(leaking == 0, "occluded boxes lie behind the depth buffer") && ok;
+        return ok;
+    }
+
+    // ======================================================================
+    // 基准
+    // ======================================================================
+    void BenchTerrain(CJobSystem &jobs, bool quick)
+    {
+        const int grids[] = {64, 128, 256};
+        const size_t boxCount = quick ? 10000 : 100000;
+        printf("SIMD path: %s, buffer %dx%d, %u threads\n", Math::SIMD::PathName(), COcclusionBuffer().GetWidth(),
+               COcclusionBuffer().GetHeight(), jobs.GetThreadCount());
+        printf("%-10s %12s %12s %12s %10s %12s %12s %10s\n", "triangles", "raster ms", "jobs ms", "rasterized",
+               "boxes", "test ns", "jobs ns", "occluded");
+
+        Math::RandomGenerator rng(29);
+        std::vector<AABB> boxes(boxCount);
+        for (size_t i = 0; i < boxCount; ++i)
+        {
+            float x = rng.NextFloat(-200.0f, 200.0f), z = rng.NextFloat(-200.0f, 200.0f);
+            Vector3 base(x, TerrainHeight(x, z), z);
+            boxes[i] = AABB(base - Vector3(0.5f, 0.0f, 0.5f), base + Vector3(0.5f, 2.0f, 0.5f));
+        }
+        std::vector<uint8_t> flags(boxCount);
+
+        for (size_t g = 0; g < sizeof(grids) / sizeof(grids[0]); ++g)
+        {
+            if (quick && grids[g] > 128)
+                break;
+            std::vector<Vector3> positions;
+            std::vector<unsigned int> indices;
+            MakeTerrain(grids[g], 400.0f, positions, indices);
+            Vector3 eye(-20.0f, TerrainHeight(-20.0f, 150.0f) + 3.0f, 150.0f);
+            Matrix4 viewProjection = MakeViewProjection(eye, eye + Vector3(0.1f, -0.05f, -1.0f));
+
+            COcclusionBuffer buffer;
+            auto raster = [&](CJobSystem *pJobs) {
+                buffer.Begin(viewProjection);
+                buffer.AddOccluder(&positions[0].x, positions.size(), sizeof(Vector3), indices.data(), indices.size(), Matrix4::Identity());
+                buffer.Rasterize(pJobs);
+            };
+            double serialMs = Bench::TimeNsPerOp(1, quick ? 3 : 10, [&]() { raster(nullptr); }) * 1e-6;
+            double jobsMs = Bench::TimeNsPerOp(1, quick ? 3 : 10, [&]() { raster(&jobs); }) * 1e-6;
+
+            size_t hidden = 0;
+            double testNs = Bench::TimeNsPerOp(boxCount, 3, [&]() { hidden = buffer.TestAABBs(boxes.data(), boxCount, flags.data()); });
+            double jobsNs = Bench::TimeNsPerOp(boxCount, 3, [&]() { hidden = buffer.TestAABBs(boxes.data(), boxCount, flags.data(), &jobs); });
+            Bench::g_sink = hidden;
+
+            printf("%-10zu %12.3f %12.3f %12zu %10zu %12.1f %12.1f %9.1f%%\n", indices.size() / 3, serialMs, jobsMs,
+                   buffer.GetStats().rasterized, boxCount, testNs, jobsNs, 100.0 * (double)hidden / (double)boxCount);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = Bench::HasFlag(argc, argv, "--quick");
+    CJobSystem jobs(3);
+
+    bool ok = VerifyQuad();
+    ok = VerifyNearClip() && ok;
+    ok = VerifyReference() && ok;
+    ok = VerifyTerrain(jobs) && ok;
+    if (!ok)
+        return 1;
+
+    BenchTerrain(jobs, quick);
+    return 0;
+}
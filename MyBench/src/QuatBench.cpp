@@ -0,0 +1,173 @@
+#include "stdafx.h"
+#include "BenchUtils.h"
+#include "Math/QuaternionBatch.h"
+#include "Math/MathSIMD.h"
+#include <cstring>
+#include <random>
+
+// ======================================================================
+// 四元数批量 Slerp/Nlerp/FromEuler/ToMatrix
+//   QuatBench [--quick]
+// 每个规模输出逐个调用与批量调用的单元素耗时
+// ======================================================================
+
+namespace
+{
+    using Bench::TimeNsPerOp;
+
+    struct QuatData
+    {
+        std::vector<Quaternion> a, b;
+        std::vector<float> t;
+        std::vector<Vector3> eulers;
+        Math::Batch::QuaternionSoA soaA, soaB, soaOut;
+        Math::Batch::Vector3SoA soaEulers;
+    };
+
+    void Fill(QuatData &data, size_t count, std::mt19937 &rng)
+    {
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        std::uniform_real_distribution<float> angle(-Math::PI, Math::PI);
+        data.a.resize(count);
+        data.b.resize(count);
+        data.t.resize(count);
+        data.eulers.resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            data.a[i] = Quaternion(dist(rng), dist(rng), dist(rng), dist(rng)).Normalized();
+            data.b[i] = Quaternion(dist(rng), dist(rng), dist(rng), dist(rng)).Normalized();
+            data.t[i] = dist(rng) * 0.5f + 0.5f;
+            data.eulers[i] = Vector3(angle(rng), angle(rng), angle(rng));
+        }
+        // 几组近似平行的四元数，覆盖 Slerp 的小角度分支
+        for (size_t i = 0; i < count; i += 7)
+            data.b[i] = Quaternion(data.a[i].x + 1e-4f, data.a[i].y, data.a[i].z, data.a[i].w).Normalized();
+
+        data.soaA.FromAoS(data.a.data(), count);
+        data.soaB.FromAoS(data.b.data(), count);
+        data.soaEulers.FromAoS(data.eulers.data(), count);
+    }
+
+    bool QuatNear(const Quaternion &p, const Quaternion &q, float eps)
+    {
+        // q 与 -q 表示同一旋转
+        float d0 = Math::Abs(p.x - q.x) + Math::Abs(p.y - q.y) + Math::Abs(p.z - q.z) + Math::Abs(p.w - q.w);
+        float d1 = Math::Abs(p.x + q.x) + Math::Abs(p.y + q.y) + Math::Abs(p.z + q.z) + Math::Abs(p.w + q.w);
+        return Math::Min(d0, d1) <= eps;
+    }
+
+    // ======================================================================
+    // 正确性校验
+    // ======================================================================
+    bool Verify(QuatData &data)
+    {
+        size_t count = data.a.size();
+        int failures = 0;
+
+        Math::Batch::Slerp(data.soaA, data.soaB, data.t.data(), data.soaOut);
+        for (size_t i = 0; i < count; ++i)
+        {
+            // 多项式近似的权重误差上限约 2.6e-5，四个分量累计放宽到 1e-4
+            if (!QuatNear(data.soaOut.Get(i), Quaternion::Slerp(data.a[i], data.b[i], data.t[i]), 1e-4f))
+                ++failures;
+        }
+
+        Math::Batch::Nlerp(data.soaA, data.soaB, 0.3f, data.soaOut);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!QuatNear(data.soaOut.Get(i), Quaternion::Nlerp(data.a[i], data.b[i], 0.3f), 1e-5f))
+                ++failures;
+        }
+
+        Math::Batch::FromEuler(data.soaEulers, data.soaOut);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Vector3 &e = data.eulers[i];
+            if (!QuatNear(data.soaOut.Get(i), Quaternion::FromEuler(e.x, e.y, e.z), 1e-5f))
+                ++failures;
+        }
+
+        std::vector<Matrix4> mats(count);
+        Math::Batch::ToMatrix(data.soaA, mats.data());
+        for (size_t i = 0; i < count; ++i)
+        {
+            Matrix4 ref = Matrix4::Rotation(data.a[i]);
+            if (!Math::SIMD::NearlyEqual(ref.m, mats[i].m, 16))
+                ++failures;
+        }
+
+        if (failures > 0)
+            printf("[FAIL] %d quaternion batch mismatches\n", failures);
+        else
+            printf("[ OK ] quaternion batch (%s) matches single-element results\n", Math::SIMD::PathName());
+        return failures == 0;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--quick") == 0)
+            quick = true;
+    }
+
+    std::mt19937 rng(2024);
+    {
+        QuatData check;
+        Fill(check, 1021, rng);
+        if (!Verify(check))
+            return 1;
+    }
+
+    const size_t sizes[] = {1000, 10000, 100000};
+    const int repeat = quick ? 2 : 10;
+
+    printf("%8s %-10s %12s %12s %8s\n", "count", "op", "single", "batch", "speedup");
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        size_t count = sizes[s];
+        QuatData data;
+        Fill(data, count, rng);
+        std::vector<Quaternion> out(count);
+        std::vector<Matrix4> mats(count);
+
+        double single = TimeNsPerOp(count, repeat, [&]() {
+            for (size_t i = 0; i < count; ++i)
+                out[i] = Quaternion::Slerp(data.a[i], data.b[i], data.t[i]);
+        });
+        double batch = TimeNsPerOp(count, repeat, [&]() {
+            Math::Batch::Slerp(data.soaA, data.soaB, data.t.data(), data.soaOut);
+        });
+        printf("%8zu %-10s %9.2f ns %9.2f ns %7.2fx\n", count, "Slerp", single, batch, single / batch);
+
+        single = TimeNsPerOp(count, repeat, [&]() {
+            for (size_t i = 0; i < count; ++i)
+                out[i] = Quaternion::Nlerp(data.a[i], data.b[i], data.t[i]);
+        });
+        batch = TimeNsPerOp(count, repeat, [&]() {
+            Math::Batch::Nlerp(data.soaA, data.soaB, data.t.data(), data.soaOut);
+        });
+        printf("%8zu %-10s %9.2f ns %9.2f ns %7.2fx\n", count, "Nlerp", single, batch, single / batch);
+
+        single = TimeNsPerOp(count, repeat, [&]() {
+            for (size_t i = 0; i < count; ++i)
+                out[i] = Quaternion::FromEuler(data.eulers[i].x, data.eulers[i].y, data.eulers[i].z);
+        });
+        batch = TimeNsPerOp(count, repeat, [&]() {
+            Math::Batch::FromEuler(data.soaEulers, data.soaOut);
+        });
+        printf("%8zu %-10s %9.2f ns %9.2f ns %7.2fx\n", count, "FromEuler", single, batch, single / batch);
+
+        single = TimeNsPerOp(count, repeat, [&]() {
+            for (size_t i = 0; i < count; ++i)
+                mats[i] = Matrix4::Rotation(data.a[i]);
+        });
+        batch = TimeNsPerOp(count, repeat, [&]() {
+            Math::Batch::ToMatrix(data.soaA, mats.data());
+        });
+        printf("%8zu %-10s %9.2f ns %9.2f ns %7.2fx\n", count, "ToMatrix", single, batch, single / batch);
+    }
+    return 0;
+}
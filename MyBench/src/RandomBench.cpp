@@ -0,0 +1,181 @@
+#include "stdafx.h"
+#include "BenchUtils.h"
+#include "Math/Random.h"
+#include "Math/MathSIMD.h"
+#include <cstring>
+#include <random>
+#include <thread>
+
+// ======================================================================
+// Math::RandomGenerator 正确性与吞吐量
+//   RandomBench [--quick]
+// 校验：固定种子的序列校验和（跨平台/跨 SIMD 路径一致）、分段批量与一次批量一致、
+//       分布与取值范围、线程默认流互不相同；随后对比 std::mt19937 / rand() 的单次耗时
+// ======================================================================
+
+namespace
+{
+    using Bench::TimeNsPerOp;
+
+    // FNV-1a
+    uint32_t Checksum(const uint32_t *data, size_t count)
+    {
+        uint32_t h = 2166136261u;
+        for (size_t i = 0; i < count; ++i)
+        {
+            h ^= data[i];
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    // ======================================================================
+    // 正确性校验
+    // ======================================================================
+    bool Verify()
+    {
+        bool ok = true;
+        const size_t count = 1000;
+        std::vector<uint32_t> a(count), b(count);
+
+        // 1. 固定种子的校验和：单个与批量序列在所有平台/路径上必须相同
+        Math::RandomGenerator rng(12345, 7);
+        for (size_t i = 0; i < count; ++i)
+            a[i] = rng.NextUInt();
+        rng.FillUInt(b.data(), count);
+        uint32_t singleSum = Checksum(a.data(), count);
+        uint32_t batchSum = Checksum(b.data(), count);
+        ok = Bench::Check(singleSum == 0xc3f74854u, "NextUInt checksum") && ok;
+        ok = Bench::Check(batchSum == 0x77da5c2cu, "FillUInt checksum") && ok;
+        if (!ok)
+            printf("       checksums: single 0x%08x batch 0x%08x\n", singleSum, batchSum);
+
+        // 2. 分段批量（每段 4 的倍数）与一次批量一致
+        Math::RandomGenerator whole(99), parts(99);
+        whole.FillUInt(a.data(), count);
+        parts.FillUInt(b.data(), 4);
+        parts.FillUInt(b.data() + 4, 96);
+        parts.FillUInt(b.data() + 100, count - 100);
+        ok = Bench::Check(memcmp(a.data(), b.data(), count * sizeof(uint32_t)) == 0, "chunked FillUInt matches single call") && ok;
+
+        // 3. 不同流互不相同
+        Math::RandomGenerator s0(99, 0), s1(99, 1);
+        ok = Bench::Check(s0.NextUInt() != s1.NextUInt() || s0.NextUInt() != s1.NextUInt(), "streams differ") && ok;
+
+        // 4. 分布：均值与 16 桶卡方（自由度 15，阈值取 p ≈ 0.001 的 37.7）
+        const size_t samples = 1 << 20;
+        std::vector<float> f(samples);
+        Math::RandomGenerator dist(2024);
+        dist.Fill(f.data(), samples);
+        double sum = 0.0;
+        size_t buckets[16] = {0};
+        bool inRange = true;
+        for (size_t i = 0; i < samples; ++i)
+        {
+            inRange = inRange && f[i] >= 0.0f && f[i] < 1.0f;
+            sum += f[i];
+            buckets[(int)(f[i] * 16.0f)]++;
+        }
+        double chi2 = 0.0;
+        double expected = samples / 16.0;
+        for (int i = 0; i < 16; ++i)
+            chi2 += (buckets[i] - expected) * (buckets[i] - expected) / expected;
+        ok = Bench::Check(inRange, "Fill in [0, 1)") && ok;
+        ok = Bench::Check(fabs(sum / samples - 0.5) < 2e-3, "Fill mean") && ok;
+        ok = Bench::Check(chi2 < 37.7, "Fill chi-square") && ok;
+
+        // 5. 取值范围
+        std::vector<Vector3> v(1001);
+        dist.Fill(v.data(), v.size(), Vector3(-1.0f, 2.0f, 10.0f), Vector3(1.0f, 3.0f, 10.5f));
+        bool vecOk = true;
+        for (size_t i = 0; i < v.size(); ++i)
+        {
+            vecOk = vecOk && v[i].x >= -1.0f && v[i].x <= 1.0f && v[i].y >= 2.0f && v[i].y <= 3.0f &&
+                    v[i].z >= 10.0f && v[i].z <= 10.5f;
+        }
+        ok = Bench::Check(vecOk, "Fill Vector3 range") && ok;
+        bool intOk = true;
+        for (int i = 0; i < 10000; ++i)
+        {
+            int n = dist.NextInt(-3, 4);
+            intOk = intOk && n >= -3 && n < 4;
+        }
+        ok = Bench::Check(intOk && dist.NextInt(5, 5) == 5, "NextInt range") && ok;
+
+        // 6. 线程默认流：固定全局种子后调用线程可复现，其它线程拿到不同的流
+        Math::RandomGenerator::SetGlobalSeed(42);
+        float first = Math::Random();
+        Math::RandomGenerator::SetGlobalSeed(42);
+        ok = Bench::Check(Math::Random() == first, "SetGlobalSeed reproducible") && ok;
+        float other = first;
+        std::thread worker([&]() { other = Math::Random(); });
+        worker.join();
+        ok = Bench::Check(other != first, "thread streams differ") && ok;
+
+        if (ok)
+            printf("[ OK ] random generator (%s) deterministic and in range, chi2 = %.1f\n", Math::SIMD::PathName(), chi2);
+        return ok;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--quick") == 0)
+            quick = true;
+    }
+
+    if (!Verify())
+        return 1;
+
+    const size_t count = quick ? 100000 : 1000000;
+    const int repeat = quick ? 2 : 10;
+    std::vector<float> out(count);
+    std::vector<Vector3> vecs(count);
+
+    std::mt19937 mt(2024);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    Math::RandomGenerator rng(2024);
+
+    printf("%-28s %10s\n", "op", "ns/op");
+    double ns = TimeNsPerOp(count, repeat, [&]() {
+        for (size_t i = 0; i < count; ++i)
+            out[i] = uniform(mt);
+    });
+    printf("%-28s %10.2f\n", "mt19937 + uniform_real", ns);
+
+    ns = TimeNsPerOp(count, repeat, [&]() {
+        for (size_t i = 0; i < count; ++i)
+            out[i] = (float)rand() / RAND_MAX;
+    });
+    printf("%-28s %10.2f\n", "rand()", ns);
+
+    ns = TimeNsPerOp(count, repeat, [&]() {
+        for (size_t i = 0; i < count; ++i)
+            out[i] = rng.NextFloat();
+    });
+    printf("%-28s %10.2f\n", "NextFloat", ns);
+
+    ns = TimeNsPerOp(count, repeat, [&]() {
+        for (size_t i = 0; i < count; ++i)
+            out[i] = Math::Random();
+    });
+    printf("%-28s %10.2f\n", "Math::Random (thread local)", ns);
+
+    ns = TimeNsPerOp(count, repeat, [&]() { rng.Fill(out.data(), count, -1.0f, 1.0f); });
+    printf("%-28s %10.2f\n", "Fill float", ns);
+
+    ns = TimeNsPerOp(count, repeat, [&]() {
+        for (size_t i = 0; i < count; ++i)
+            vecs[i] = rng.NextVector3(Vector3(-1.0f, -1.0f, -1.0f), Vector3(1.0f, 1.0f, 1.0f));
+    });
+    printf("%-28s %10.2f\n", "NextVector3", ns);
+
+    ns = TimeNsPerOp(count, repeat, [&]() { rng.Fill(vecs.data(), count, Vector3(-1.0f, -1.0f, -1.0f), Vector3(1.0f, 1.0f, 1.0f)); });
+    printf("%-28s %10.2f\n", "Fill Vector3", ns);
+
+    Bench::g_sink = out[count / 2] + vecs[count / 3].x;
+    return 0;
+}
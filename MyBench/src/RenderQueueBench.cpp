@@ -0,0 +1,307 @@
+#include "stdafx.h"
+#include "BenchUtils.h"
+#include "Core/RenderQueue.h"
+#include "Math/Random.h"
+#include <algorithm>
+#include <cstring>
+
+// ======================================================================
+// 渲染队列排序
+//   RenderQueueBench [--quick]
+// 校验：CRenderQueue::SortEntries 与 std::stable_sort 结果一致；
+//       不透明物体在前且由近到远、半透明物体由远到近、同材质同纹理同网格相邻；
+//       批次覆盖全部绘制项、批内状态一致、实例矩阵与排序后顺序一致
+// 对比：1k~100k 个绘制项，基数排序与 std::sort；排序前后的材质/纹理切换次数；
+//       大量相同物件合批后的绘制调用数
+// ======================================================================
+
+namespace
+{
+    const int MATERIAL_COUNT = 40;
+    const int TEXTURE_COUNT = 24;
+    const int MESH_COUNT = 16;
+    const float FAR_DISTANCE = 1000.0f;
+
+    // 队列只比较网格指针、从不解引用，这里用数组元素的地址充当不同的网格
+    char g_meshTags[MESH_COUNT + 1];
+    const CMesh *FakeMesh(uint32_t meshID) { return reinterpret_cast<const CMesh *>(&g_meshTags[meshID]); }
+
+    // 随机场景：相机在原点看向 -Z（观察矩阵为单位阵），物体在前方，约 1/8 半透明，细节级别随机
+    void FillQueue(CRenderQueue &queue, Math::RandomGenerator &rng, size_t count)
+    {
+        queue.SetView(Matrix4::Identity(), FAR_DISTANCE);
+        queue.Begin();
+        for (size_t i = 0; i < count; ++i)
+        {
+            Vector3 center = rng.NextVector3(Vector3(-200.0f, -20.0f, -FAR_DISTANCE), Vector3(200.0f, 20.0f, 0.0f));
+            uint32_t material = (uint32_t)rng.NextInt(1, MATERIAL_COUNT + 1);
+            uint32_t texture = (uint32_t)rng.NextInt(0, TEXTURE_COUNT);
+            uint32_t meshID = (uint32_t)rng.NextInt(1, MESH_COUNT + 1);
+            bool translucent = rng.NextInt(0, 8) == 0;
+            uint32_t lod = (uint32_t)rng.NextInt(0, 4);
+            queue.Add(FakeMesh(meshID), meshID, Matrix4::Translation(center), center, material, texture, translucent,
+                      RenderPass::World, lod);
+        }
+        queue.End();
+    }
+
+    void RandomEntries(Math::RandomGenerator &rng, size_t count, std::vector<CRenderQueue::SortEntry> &entries)
+    {
+        entries.resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            float depth = rng.NextFloat();
+            entries[i].key = CRenderQueue::MakeKey(RenderPass::World, rng.NextInt(0, 8) == 0,
+                                                   (uint32_t)rng.NextInt(1, MATERIAL_COUNT + 1),
+                                                   (uint32_t)rng.NextInt(0, TEXTURE_COUNT),
+                                                   (uint32_t)rng.NextInt(1, MESH_COUNT + 1), depth);
+            entries[i].index = (uint32_t)i;
+        }
+    }
+
+    bool LessKey(const CRenderQueue::SortEntry &a, const CRenderQueue::SortEntry &b) { return a.key < b.key; }
+
+    // 按顺序提交时的状态切换次数（与 CRenderer::SubmitQueue 的判断一致）
+    size_t CountChanges(const std::vector<const CRenderQueue::Item *> &items)
+    {
+        size_t changes = 0;
+        uint32_t material = 0, texture = 0;
+        bool blending = false;
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            changes += items[i]->material != material ? 1 : 0;
+            changes += items[i]->texture != texture ? 1 : 0;
+            changes += items[i]->translucent != blending ? 1 : 0;
+            material = items[i]->material;
+            texture = items[i]->texture;
+            blending = items[i]->translucent;
+        }
+        return changes;
+    }
+
+    // ======================================================================
+    // 正确性
+    // ======================================================================
+    bool VerifySort()
+    {
+        Math::RandomGenerator rng(5);
+        int wrong = 0;
+        const size_t sizes[] = {0, 1, 2, 7, 255, 256, 257, 5000, 40000};
+        std::vector<CRenderQueue::SortEntry> entries, expected, scratch;
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+        {
+            RandomEntries(rng, sizes[s], entries);
+            // 键值重复很多的情况：检查稳定性
+            for (size_t i = 0; i < entries.size(); i += 3)
+                entries[i].key = entries[i / 2].key;
+
+            expected = entries;
+            std::stable_sort(expected.begin(), expected.end(), LessKey);
+            scratch.resize(entries.size());
+            CRenderQueue::SortEntries(entries.data(), scratch.data(), entries.size());
+            for (size_t i = 0; i < entries.size(); ++i)
+            {
+                if (entries[i].key != expected[i].key || entries[i].index != expected[i].index)
+                {
+                    ++wrong;
+                    break;
+                }
+            }
+        }
+        return Bench::Check(wrong == 0, "radix sort matches std::stable_sort");
+    }
+
+    bool VerifyOrder()
+    {
+        Math::RandomGenerator rng(9);
+        CRenderQueue queue;
+        FillQueue(queue, rng, 20000);
+
+        int wrongPass = 0, wrongDepth = 0, wrongGroup = 0;
+        bool seenTranslucent = false;
+        for (size_t i = 0; i < queue.GetCount(); ++i)
+        {
+            const CRenderQueue::Item &item = queue.GetSorted(i);
+            if (seenTranslucent && !item.translucent)
+                ++wrongPass;
+            seenTranslucent = seenTranslucent || item.translucent;
+            if (i == 0)
+                continue;
+
+            const CRenderQueue::Item &prev = queue.GetSorted(i - 1);
+            // 深度只在同一组内比较（半透明量化为 24 位，不透明 10 位，相等时保持加入顺序）
+            float depth = -item.world.GetTranslation().z;
+            float prevDepth = -prev.world.GetTranslation().z;
+            if (item.translucent && prev.translucent)
+            {
+                if (depth > prevDepth + FAR_DISTANCE / 16777215.0f)
+                    ++wrongDepth;
+            }
+            else if (!item.translucent && item.material == prev.material && item.texture == prev.texture &&
+                     item.pMesh == prev.pMesh && item.lod == prev.lod)
+            {
+                if (depth + FAR_DISTANCE / 1023.0f < prevDepth)
+                    ++wrongDepth;
+            }
+        }
+
+        // 不透明部分每个（材质, 纹理, 网格）组合只出现在一段连续区间内
+        auto groupOf = [](const CRenderQueue::Item &item) {
+            uint32_t mesh = (uint32_t)(reinterpret_cast<const char *>(item.pMesh) - g_meshTags);
+            return (item.material * TEXTURE_COUNT + item.texture) * (MESH_COUNT + 1) + mesh;
+        };
+        std::vector<uint8_t> closed((MATERIAL_COUNT + 1) * TEXTURE_COUNT * (MESH_COUNT + 1), 0);
+        for (size_t i = 1; i < queue.GetCount(); ++i)
+        {
+            const CRenderQueue::Item &prev = queue.GetSorted(i - 1);
+            const CRenderQueue::Item &item = queue.GetSorted(i);
+            if (item.translucent)
+                break;
+            if (groupOf(item) != groupOf(prev))
+            {
+                closed[groupOf(prev)] = 1;
+                if (closed[groupOf(item)])
+                    ++wrongGroup;
+            }
+        }
+
+        bool ok = Bench::Check(wrongPass == 0, "opaque items before translucent items");
+        ok = Bench::Check(wrongDepth == 0, "opaque front-to-back, translucent back-to-front") && ok;
+        ok = Bench::Check(wrongGroup == 0, "opaque items grouped by material, texture and mesh") && ok;
+        return ok;
+    }
+
+    bool VerifyBatches()
+    {
+        Math::RandomGenerator rng(21);
+        CRenderQueue queue;
+        FillQueue(queue, rng, 20000);
+
+        // 批次首尾相接覆盖全部绘制项；批内状态一致；相邻批次状态不同（否则本应合并）
+        int wrongCover = 0, wrongState = 0, wrongSplit = 0, wrongMatrix = 0;
+        size_t next = 0;
+        for (size_t b = 0; b < queue.GetBatchCount(); ++b)
+        {
+            const CRenderQueue::Batch &batch = queue.GetBatch(b);
+            if (batch.first != next || batch.count == 0)
+                ++wrongCover;
+            next = batch.first + batch.count;
+
+            const CRenderQueue::Item &head = queue.GetSorted(batch.first);
+            for (uint32_t i = 1; i < batch.count && next <= queue.GetCount(); ++i)
+            {
+                const CRenderQueue::Item &item = queue.GetSorted(batch.first + i);
+                if (item.pMesh != head.pMesh || item.lod != head.lod || item.material != head.material ||
+                    item.texture != head.texture || item.translucent != head.translucent)
+                    ++wrongState;
+            }
+            if (b > 0 && next <= queue.GetCount())
+            {
+                const CRenderQueue::Item &prev = queue.GetSorted(batch.first - 1);
+                if (prev.pMesh == head.pMesh && prev.lod == head.lod && prev.material == head.material &&
+                    prev.texture == head.texture && prev.translucent == head.translucent)
+                    ++wrongSplit;
+            }
+        }
+        if (next != queue.GetCount())
+            ++wrongCover;
+
+        const Matrix4 *instances = queue.GetInstanceMatrices();
+        for (size_t i = 0; i < queue.GetCount(); ++i)
+        {
+            if (std::memcmp(instances[i].GetData(), queue.GetSorted(i).world.GetData(), 16 * sizeof(float)) != 0)
+                ++wrongMatrix;
+        }
+
+        bool ok = Bench::Check(wrongCover == 0, "batches cover every item in sorted order");
+        ok = Bench::Check(wrongState == 0 && wrongSplit == 0, "batches split exactly at mesh/LOD/state changes") && ok;
+        ok = Bench::Check(wrongMatrix == 0, "instance matrices follow sorted order") && ok;
+        return ok;
+    }
+
+    // ======================================================================
+    // 基准
+    // ======================================================================
+    // 大量相同物件：少数几种网格、每种一个材质，随机摆放
+    void BenchProps(bool quick)
+    {
+        const size_t count = quick ? 5000 : 50000;
+        const uint32_t kinds = 4;
+        Math::RandomGenerator rng(17);
+        CRenderQueue queue;
+        queue.SetView(Matrix4::Identity(), FAR_DISTANCE);
+
+        size_t batches = 0;
+        double ns = Bench::TimeNsPerOp(count, quick ? 3 : 20, [&]() {
+            queue.Begin();
+            for (size_t i = 0; i < count; ++i)
+            {
+                Vector3 center = rng.NextVector3(Vector3(-500.0f, 0.0f, -FAR_DISTANCE), Vector3(500.0f, 0.0f, 0.0f));
+                uint32_t kind = (uint32_t)rng.NextInt(1, kinds + 1);
+                queue.Add(FakeMesh(kind), kind, Matrix4::Translation(center), center, kind, kind, false);
+            }
+            queue.End();
+            batches = queue.GetBatchCount();
+        });
+        printf("%zu props of %u kinds: %zu draw calls with instancing (%.1f ns/item to queue, sort and batch)\n\n",
+               count, kinds, batches, ns);
+    }
+
+    void BenchSort(bool quick)
+    {
+        const size_t sizes[] = {1000, 10000, 100000};
+        const int repeat = quick ? 3 : 20;
+        printf("%-10s %14s %14s %14s %16s %16s\n", "items", "radix ns", "std::sort ns", "speedup",
+               "changes unsorted", "changes sorted");
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+        {
+            const size_t count = sizes[s];
+            if (quick && count > 10000)
+                break;
+
+            Math::RandomGenerator rng(13);
+            std::vector<CRenderQueue::SortEntry> source, work, scratch(count);
+            RandomEntries(rng, count, source);
+
+            uint64_t check = 0;
+            double radix = Bench::TimeNsPerOp(count, repeat, [&]() {
+                work = source;
+                CRenderQueue::SortEntries(work.data(), scratch.data(), count);
+                check += work[count / 2].key;
+            });
+            double stdSort = Bench::TimeNsPerOp(count, repeat, [&]() {
+                work = source;
+                std::sort(work.begin(), work.end(), LessKey);
+                check += work[count / 2].key;
+            });
+            Bench::g_sink = check;
+
+            // 遍历顺序（加入顺序）与排序后提交的状态切换次数
+            CRenderQueue queue;
+            FillQueue(queue, rng, count);
+            std::vector<const CRenderQueue::Item *> sorted(count), unsorted(count);
+            for (size_t i = 0; i < count; ++i)
+                sorted[i] = &queue.GetSorted(i);
+            unsorted = sorted;
+            std::sort(unsorted.begin(), unsorted.end());
+
+            printf("%-10zu %14.1f %14.1f %13.2fx %16zu %16zu\n", count, radix, stdSort, stdSort / radix,
+                   CountChanges(unsorted), CountChanges(sorted));
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = Bench::HasFlag(argc, argv, "--quick");
+
+    bool ok = VerifySort();
+    ok = VerifyOrder() && ok;
+    ok = VerifyBatches() && ok;
+    if (!ok)
+        return 1;
+
+    BenchProps(quick);
+    BenchSort(quick);
+    return 0;
+}
@@ -0,0 +1,349 @@
+#include "stdafx.h"
+#include "BenchUtils.h"
+#include "Core/SceneSnapshot.h"
+#include "Math/Random.h"
+#include <cstring>
+#include <cwchar>
+
+// ======================================================================
+// 场景快照正确性与加载耗时
+//   SnapshotBench [--quick]
+// 校验：写入 -> 文件 -> 映射读回逐字段一致；损坏的魔数、截断、越界重定位、错误父下标都被拒绝
+// 对比：程序化构建（正弦地形高度 + 法线 + N 个带名称/标签/变换的实体）与映射快照后重建同样的数据
+// CEntity 依赖 Win32/OpenGL，这里用替身节点承接两条路径的结果
+// ======================================================================
+
+namespace
+{
+    const uint32_t TYPE_ENTITY = 0;
+    const uint32_t TYPE_MODEL = 1;
+    const uint32_t TYPE_TERRAIN = 2;
+
+    // 替身节点：与 CEntity 读回快照后持有的数据相当
+    struct Node
+    {
+        uint32_t type;
+        int32_t parent;
+        uint32_t flags;
+        std::wstring name;
+        std::wstring resource;
+        std::vector<std::wstring> tags;
+        float trs[10]; // 位置、旋转 (x, y, z, w)、缩放
+        std::vector<float> heights;
+        std::vector<Vector3> normals;
+    };
+
+    struct TerrainHeader
+    {
+        int32_t width;
+        int32_t height;
+        float cellSize;
+        float maxHeight;
+    };
+
+    // 与 CTerrainEntity 相同：按格子中心差分求法线（两条路径都要做）
+    void ComputeNormals(Node &terrain, int width, int height, float cellSize)
+    {
+        terrain.normals.resize((size_t)width * height);
+        const float *h = terrain.heights.data();
+        for (int z = 0; z < height; ++z)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                float l = h[z * width + (x > 0 ? x - 1 : x)];
+                float r = h[z * width + (x < width - 1 ? x + 1 : x)];
+                float d = h[(z > 0 ? z - 1 : z) * width + x];
+                float u = h[(z < height - 1 ? z + 1 : z) * width + x];
+                Vector3 n(l - r, 2.0f * cellSize, d - u);
+                terrain.normals[z * width + x] = n.Normalized();
+            }
+        }
+    }
+
+    // ======================================================================
+    // 程序化构建
+    // ======================================================================
+    void BuildProcedural(std::vector<Node> &nodes, size_t entityCount, int terrainSize)
+    {
+        nodes.clear();
+        nodes.reserve(entityCount + 2);
+
+        Node root = {};
+        root.type = TYPE_ENTITY;
+        root.parent = -1;
+        root.name = L"DemoSceneRoot";
+        root.trs[6] = 1.0f;
+        root.trs[7] = root.trs[8] = root.trs[9] = 1.0f;
+        nodes.push_back(root);
+
+        // 地形：与 GenerateProceduralTerrain 相同的正弦组合
+        Node terrain = {};
+        terrain.type = TYPE_TERRAIN;
+        terrain.parent = 0;
+        terrain.flags = SNAPSHOT_FLAG_VISIBLE;
+        terrain.name = L"WorldTerrain";
+        terrain.resource = L"res/Textures/Terrain/grass.jpg";
+        terrain.trs[6] = 1.0f;
+        terrain.trs[7] = terrain.trs[8] = terrain.trs[9] = 1.0f;
+        const float size = 300.0f, maxHeight = 15.0f;
+        const float cellSize = size / (terrainSize - 1);
+        terrain.heights.resize((size_t)terrainSize * terrainSize);
+        for (int z = 0; z < terrainSize; ++z)
+        {
+            for (int x = 0; x < terrainSize; ++x)
+            {
+                float noise1 = sinf(x * 0.1f) * cosf(z * 0.1f) * 2.0f;
+                float noise2 = sinf(x * 0.05f + 1.3f) * 1.5f;
+                float noise3 = cosf(z * 0.07f + 0.7f) * 1.2f;
+                terrain.heights[z * terrainSize + x] = (noise1 + noise2 + noise3) * maxHeight * 0.1f;
+            }
+        }
+        ComputeNormals(terrain, terrainSize, terrainSize, cellSize);
+        nodes.push_back(std::move(terrain));
+
+        // 道具：名称、标签、随机变换
+        Math::RandomGenerator rng(1234);
+        wchar_t name[32];
+        int32_t group = 0; // 每 16 个道具挂在同一个组节点下
+        for (size_t i = 0; i < entityCount; ++i)
+        {
+            Node prop = {};
+            prop.type = TYPE_MODEL;
+            prop.parent = (i % 16 == 0) ? 0 : group;
+            if (i % 16 == 0)
+                group = (int32_t)nodes.size();
+            prop.flags = SNAPSHOT_FLAG_VISIBLE | ((i % 4 == 0) ? SNAPSHOT_FLAG_SNAP_TO_TERRAIN : 0);
+            swprintf(name, 32, L"Prop_%zu", i);
+            prop.name = name;
+            prop.resource = (i % 3 == 0) ? L"Duck/glTF/Duck.gltf" : L"Crate/crate.obj";
+            prop.tags.push_back(L"prop");
+            prop.tags.push_back((i % 4 == 0) ? L"dynamic" : L"static");
+            Vector3 pos = rng.NextVector3(Vector3(-150.0f, 0.0f, -150.0f), Vector3(150.0f, 10.0f, 150.0f));
+            Quaternion rot = Quaternion::FromEuler(0.0f, rng.NextFloat(0.0f, 360.0f), 0.0f);
+            float scale = rng.NextFloat(0.5f, 2.0f);
+            float trs[10] = {pos.x, pos.y, pos.z, rot.x, rot.y, rot.z, rot.w, scale, scale, scale};
+            memcpy(prop.trs, trs, sizeof(trs));
+            nodes.push_back(std::move(prop));
+        }
+    }
+
+    // ======================================================================
+    // 快照写入与读回
+    // ======================================================================
+    void WriteSnapshot(const std::vector<Node> &nodes, CSceneSnapshotWriter &writer, int terrainSize)
+    {
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            const Node &node = nodes[i];
+            uint32_t index = writer.AddEntity(node.type, node.parent);
+            SnapshotEntity &record = writer.GetEntity(index);
+            record.flags = node.flags;
+            record.tickInterval = 0;
+            memcpy(record.position, node.trs, sizeof(float) * 3);
+            memcpy(record.rotation, node.trs + 3, sizeof(float) * 4);
+            memcpy(record.scale, node.trs + 7, sizeof(float) * 3);
+
+            writer.SetName(index, node.name);
+            if (!node.resource.empty())
+                writer.SetResource(index, node.resource);
+            if (!node.tags.empty())
+                writer.SetTags(index, node.tags);
+            if (!node.heights.empty())
+            {
+                TerrainHeader header = {terrainSize, terrainSize, 300.0f / (terrainSize - 1), 15.0f};
+                std::vector<uint8_t> data(sizeof(header) + node.heights.size() * sizeof(float));
+                memcpy(data.data(), &header, sizeof(header));
+                memcpy(data.data() + sizeof(header), node.heights.data(), node.heights.size() * sizeof(float));
+                writer.SetData(index, data.data(), data.size());
+            }
+        }
+    }
+
+    void ReadSnapshot(const CSceneSnapshot &snapshot, std::vector<Node> &nodes)
+    {
+        uint32_t count = snapshot.GetEntityCount();
+        const SnapshotEntity *pRecords = snapshot.GetEntities();
+        nodes.clear();
+        nodes.resize(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const SnapshotEntity &record = pRecords[i];
+            Node &node = nodes[i];
+            node.type = record.type;
+            node.parent = record.parent;
+            node.flags = record.flags;
+            memcpy(node.trs, record.position, sizeof(float) * 3);
+            memcpy(node.trs + 3, record.rotation, sizeof(float) * 4);
+            memcpy(node.trs + 7, record.scale, sizeof(float) * 3);
+            if (!record.name.IsNull())
+                node.name = record.name.Get();
+            if (!record.resource.IsNull())
+                node.resource = record.resource.Get();
+            for (uint32_t t = 0; t < record.tagCount; ++t)
+                node.tags.push_back(record.tags.Get()[t].Get());
+
+            if (record.type == TYPE_TERRAIN && record.dataSize >= sizeof(TerrainHeader))
+            {
+                TerrainHeader header;
+                memcpy(&header, record.data.Get(), sizeof(header));
+                const float *pHeights = reinterpret_cast<const float *>(record.data.Get() + sizeof(header));
+                node.heights.assign(pHeights, pHeights + (size_t)header.width * header.height);
+                ComputeNormals(node, header.width, header.height, header.cellSize);
+            }
+        }
+    }
+
+    bool SameNodes(const std::vector<Node> &a, const std::vector<Node> &b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (a[i].type != b[i].type || a[i].parent != b[i].parent || a[i].flags != b[i].flags ||
+                a[i].name != b[i].name || a[i].resource != b[i].resource || a[i].tags != b[i].tags ||
+                memcmp(a[i].trs, b[i].trs, sizeof(a[i].trs)) != 0 || a[i].heights != b[i].heights ||
+                a[i].normals.size() != b[i].normals.size())
+                return false;
+        }
+        return true;
+    }
+
+    std::string TempPath()
+    {
+        const char *dir = getenv("TMPDIR");
+        return std::string(dir ? dir : "/tmp") + "/mybench_scene.snap";
+    }
+
+    // ======================================================================
+    // 校验
+    // ======================================================================
+    bool Verify()
+    {
+        bool ok = true;
+        const int terrainSize = 33;
+        std::vector<Node> original;
+        BuildProcedural(original, 200, terrainSize);
+
+        CSceneSnapshotWriter writer;
+        WriteSnapshot(original, writer, terrainSize);
+        std::string path = TempPath();
+        ok = Bench::Check(writer.Save(path), "save snapshot") && ok;
+
+        // 1. 映射读回
+        {
+            CSceneSnapshot snapshot;
+            ok = Bench::Check(snapshot.Load(path), "load snapshot") && ok;
+            std::vector<Node> loaded;
+            ReadSnapshot(snapshot, loaded);
+            ok = Bench::Check(SameNodes(original, loaded), "round trip keeps hierarchy, names, tags, transforms and data") && ok;
+            ok = Bench::Check(snapshot.GetEntities()[5].tags.Get()[0].Get() == snapshot.GetEntities()[6].tags.Get()[0].Get(),
+                       "identical strings are stored once") && ok;
+        }
+        remove(path.c_str());
+
+        // 2. 损坏的文件在重定位前后被拒绝
+        std::vector<uint8_t> bytes;
+        writer.Finish(bytes);
+        SnapshotHeader header;
+        memcpy(&header, bytes.data(), sizeof(header));
+        {
+            std::vector<uint8_t> copy = bytes;
+            ok = Bench::Check(CSceneSnapshot::Relocate(copy.data(), copy.size()), "intact bytes relocate") && ok;
+        }
+        {
+            std::vector<uint8_t> copy = bytes;
+            copy[0] ^= 0xFF;
+            ok = Bench::Check(!CSceneSnapshot::Relocate(copy.data(), copy.size()), "bad magic rejected") && ok;
+        }
+        {
+            std::vector<uint8_t> copy(bytes.begin(), bytes.begin() + bytes.size() / 2);
+            ok = Bench::Check(!CSceneSnapshot::Relocate(copy.data(), copy.size()), "truncated file rejected") && ok;
+        }
+        {
+            // 重定位项指向重定位表本身
+            std::vector<uint8_t> copy = bytes;
+            uint64_t position = header.relocationOffset;
+            memcpy(&copy[header.relocationOffset], &position, sizeof(position));
+            ok = Bench::Check(!CSceneSnapshot::Relocate(copy.data(), copy.size()), "relocation outside data rejected") && ok;
+        }
+        {
+            // 指针偏移超出文件
+            std::vector<uint8_t> copy = bytes;
+            uint64_t value = copy.size() + 64;
+            memcpy(&copy[header.entityOffset + offsetof(SnapshotEntity, name)], &value, sizeof(value));
+            ok = Bench::Check(!CSceneSnapshot::Relocate(copy.data(), copy.size()), "pointer past end rejected") && ok;
+        }
+        {
+            // 父下标指向自身之后
+            std::vector<uint8_t> copy = bytes;
+            int32_t parent = 7;
+            memcpy(&copy[header.entityOffset + 3 * sizeof(SnapshotEntity) + offsetof(SnapshotEntity, parent)], &parent, sizeof(parent));
+            ok = Bench::Check(!CSceneSnapshot::Relocate(copy.data(), copy.size()), "forward parent rejected") && ok;
+        }
+        {
+            CSceneSnapshot snapshot;
+            ok = Bench::Check(!snapshot.Load(path) && !snapshot.IsLoaded(), "missing file fails cleanly") && ok;
+        }
+
+        if (ok)
+            printf("[ OK ] round trip, string sharing, corrupt header/size/relocation/parent rejected\n");
+        return ok;
+    }
+
+    // ======================================================================
+    // 加载耗时
+    // ======================================================================
+    void BenchLoad(bool quick)
+    {
+        const size_t counts[] = {1000, 10000, 100000};
+        const int terrainSize = 257;
+        const int repeat = quick ? 2 : 5;
+        std::string path = TempPath();
+
+        // map ms：只映射与重定位；snapshot ms：另外把记录转换成替身节点（字符串拷贝、法线）
+        printf("%-10s %8s %10s %15s %10s %13s %9s\n", "entities", "terrain", "file KB", "procedural ms", "map ms", "snapshot ms", "speedup");
+        for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c)
+        {
+            const size_t count = counts[c];
+            if (quick && count > 10000)
+                break;
+
+            std::vector<Node> nodes;
+            BuildProcedural(nodes, count, terrainSize);
+            CSceneSnapshotWriter writer;
+            WriteSnapshot(nodes, writer, terrainSize);
+            writer.Save(path);
+
+            double procedural = Bench::TimeNsPerOp(1, repeat, [&]() {
+                BuildProcedural(nodes, count, terrainSize);
+            });
+            size_t fileSize = 0;
+            double mapped = Bench::TimeNsPerOp(1, repeat, [&]() {
+                CSceneSnapshot snapshot;
+                snapshot.Load(path);
+                fileSize = snapshot.GetFileSize();
+            });
+            double loaded = Bench::TimeNsPerOp(1, repeat, [&]() {
+                CSceneSnapshot snapshot;
+                snapshot.Load(path);
+                ReadSnapshot(snapshot, nodes);
+            });
+            Bench::g_sink = nodes.back().trs[0];
+
+            printf("%-10zu %8d %10zu %15.2f %10.2f %13.2f %8.1fx\n", count, terrainSize, fileSize / 1024,
+                   procedural * 1e-6, mapped * 1e-6, loaded * 1e-6, procedural / loaded);
+        }
+        remove(path.c_str());
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = Bench::HasFlag(argc, argv, "--quick");
+
+    if (!Verify())
+        return 1;
+
+    BenchLoad(quick);
+    return 0;
+}
@@ -0,0 +1,297 @@
+#include "stdafx.h"
+#include "BenchUtils.h"
+#include "Core/StaticBatch.h"
+#include "Math/Random.h"
+#include <cmath>
+
+// ======================================================================
+// 静态合批
+//   StaticBatchBench [--quick]
+// 校验：顶点变换与法线（非均匀缩放）正确；同材质同纹理只有一组、组内区间连续、索引重定位正确；
+//       可见部件的绘制列表覆盖且只覆盖可见区间，全部可见时每组一次绘制
+// 对比：大量静态摆件逐个绘制与合批后的绘制调用数（全部可见 / 只有一块圆形区域可见），合批构建耗时
+// ======================================================================
+
+namespace
+{
+    // 与 CMesh 的 Vertex 成员同名
+    struct MeshVertex
+    {
+        Vector3 Position;
+        Vector3 Normal;
+        Vector2 TexCoords;
+    };
+
+    struct TestMesh
+    {
+        std::vector<MeshVertex> vertices;
+        std::vector<unsigned int> indices;
+        uint32_t material;
+        uint32_t texture;
+    };
+
+    // 单位立方体，每面 4 个顶点
+    TestMesh MakeCube(uint32_t material, uint32_t texture)
+    {
+        static const float normals[6][3] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+        TestMesh mesh;
+        mesh.material = material;
+        mesh.texture = texture;
+        for (int f = 0; f < 6; ++f)
+        {
+            Vector3 n(normals[f][0], normals[f][1], normals[f][2]);
+            Vector3 u = std::fabs(n.y) > 0.5f ? Vector3(1, 0, 0) : Vector3(0, 1, 0);
+            Vector3 v = n.Cross(u);
+            unsigned int base = (unsigned int)mesh.vertices.size();
+            for (int k = 0; k < 4; ++k)
+            {
+                float su = (k & 1) ? 0.5f : -0.5f;
+                float sv = (k & 2) ? 0.5f : -0.5f;
+                MeshVertex vertex;
+                vertex.Position = n * 0.5f + u * su + v * sv;
+                vertex.Normal = n;
+                vertex.TexCoords = Vector2(su + 0.5f, sv + 0.5f);
+                mesh.vertices.push_back(vertex);
+            }
+            const unsigned int quad[6] = {0, 1, 2, 2, 1, 3};
+            for (int k = 0; k < 6; ++k)
+                mesh.indices.push_back(base + quad[k]);
+        }
+        return mesh;
+    }
+
+    void AddMesh(CStaticBatch &batch, const TestMesh &mesh, const Matrix4 &world, unsigned int owner)
+    {
+        batch.Add(mesh.vertices.data(), mesh.vertices.size(), mesh.indices.data(), mesh.indices.size(), world,
+                  nullptr, mesh.material, mesh.texture, owner);
+    }
+
+    // 摆件：kinds 种模型，每种两个子网格（不同材质），随机散布在 extent × extent 的地面上
+    // 实体 ID 从 1 开始，位置记录在 positions[id]
+    void FillDecoration(CStaticBatch &batch, Math::RandomGenerator &rng, size_t count, float extent,
+                        std::vector<Vector3> &positions)
+    {
+        const int kinds = 3;
+        std::vector<TestMesh> meshes;
+        for (int k = 0; k < kinds; ++k)
+        {
+            meshes.push_back(MakeCube(1 + k * 2, 10 + k));
+            meshes.push_back(MakeCube(2 + k * 2, 0));
+        }
+
+        positions.assign(count + 1, Vector3::Zero());
+        for (size_t i = 1; i <= count; ++i)
+        {
+            Vector3 pos = rng.NextVector3(Vector3(-extent * 0.5f, 0.0f, -extent * 0.5f), Vector3(extent * 0.5f, 0.0f, extent * 0.5f));
+            positions[i] = pos;
+            int kind = rng.NextInt(0, kinds);
+            Matrix4 world = Matrix4::Translation(pos) * Matrix4::RotationY(rng.NextFloat(0.0f, 6.28f));
+            AddMesh(batch, meshes[kind * 2], world, (unsigned int)i);
+            AddMesh(batch, meshes[kind * 2 + 1], world * Matrix4::Translation(Vector3(0.0f, 1.0f, 0.0f)), (unsigned int)i);
+        }
+        batch.Build();
+    }
+
+    // ======================================================================
+    // 正确性
+    // ======================================================================
+    bool VerifyTransform()
+    {
+        CStaticBatch batch;
+        TestMesh cube = MakeCube(1, 0);
+        Matrix4 world = Matrix4::Translation(Vector3(3.0f, -2.0f, 5.0f)) * Matrix4::RotationY(0.7f) *
+                        Matrix4::Scale(Vector3(4.0f, 1.0f, 0.25f));
+        AddMesh(batch, cube, world, 1);
+        batch.Build();
+
+        const std::vector<CStaticBatch::Vertex> &vertices = batch.GetVertices();
+        int wrongPosition = 0, wrongNormal = 0;
+        if (vertices.size() != cube.vertices.size())
+            ++wrongPosition;
+        for (size_t i = 0; i < vertices.size() && i < cube.vertices.size(); ++i)
+        {
+            Vector3 expected = world * cube.vertices[i].Position;
+            if ((vertices[i].Position - expected).Length() > 1e-4f)
+                ++wrongPosition;
+        }
+
+        // 每个面的法线为单位长度，并与该面变换后的两条边垂直
+        const std::vector<uint32_t> &indices = batch.GetIndices();
+        for (size_t t = 0; t + 2 < indices.size(); t += 3)
+        {
+            const CStaticBatch::Vertex &a = vertices[indices[t]];
+            const CStaticBatch::Vertex &b = vertices[indices[t + 1]];
+            const CStaticBatch::Vertex &c = vertices[indices[t + 2]];
+            Vector3 e0 = (b.Position - a.Position).Normalized();
+            Vector3 e1 = (c.Position - a.Position).Normalized();
+            if (std::fabs(a.Normal.Length() - 1.0f) > 1e-4f || std::fabs(a.Normal.Dot(e0)) > 1e-4f ||
+                std::fabs(a.Normal.Dot(e1)) > 1e-4f)
+                ++wrongNormal;
+        }
+
+        bool ok = Bench::Check(wrongPosition == 0, "vertices transformed to world space");
+        ok = Bench::Check(wrongNormal == 0, "normals stay unit length and perpendicular under non-uniform scale") && ok;
+        return ok;
+    }
+
+    bool VerifyLayout()
+    {
+        Math::RandomGenerator rng(3);
+        CStaticBatch batch;
+        std::vector<Vector3> positions;
+        FillDecoration(batch, rng, 2000, 400.0f, positions);
+
+        const std::vector<CStaticBatch::Group> &groups = batch.GetGroups();
+        const std::vector<CStaticBatch::Range> &ranges = batch.GetRanges();
+        const std::vector<uint32_t> &indices = batch.GetIndices();
+        const std::vector<CStaticBatch::Vertex> &vertices = batch.GetVertices();
+
+        int wrongGroup = 0, wrongRange = 0, wrongIndex = 0;
+        uint32_t nextRange = 0, nextIndex = 0;
+        for (size_t g = 0; g < groups.size(); ++g)
+        {
+            const CStaticBatch::Group &group = groups[g];
+            for (size_t h = 0; h < g; ++h)
+            {
+                if (groups[h].material == group.material && groups[h].texture == group.texture)
+                    ++wrongGroup;
+            }
+            if (group.firstRange != nextRange || group.firstIndex != nextIndex)
+                ++wrongGroup;
+
+            uint32_t indexInGroup = group.firstIndex;
+            for (uint32_t r = group.firstRange; r < group.firstRange + group.rangeCount; ++r)
+            {
+                const CStaticBatch::Range &range = ranges[r];
+                if (range.firstIndex != indexInGroup || range.indexCount == 0)
+                    ++wrongRange;
+                indexInGroup += range.indexCount;
+
+                // 部件的三角形都落在它自己的包围盒内（索引重定位到了正确的顶点）
+                AABB box = AABB::FromCenterExtents(range.bounds.GetCenter(), range.bounds.GetExtents() + Vector3(1e-3f, 1e-3f, 1e-3f));
+                for (uint32_t k = range.firstIndex; k < range.firstIndex + range.indexCount; ++k)
+                {
+                    if (indices[k] >= vertices.size() || !box.Contains(vertices[indices[k]].Position))
+                    {
+                        ++wrongIndex;
+                        break;
+                    }
+                }
+            }
+            if (indexInGroup != group.firstIndex + group.indexCount)
+                ++wrongRange;
+            nextRange = group.firstRange + group.rangeCount;
+            nextIndex = group.firstIndex + group.indexCount;
+        }
+        if (nextRange != ranges.size() || nextIndex != indices.size() || ranges.size() != 4000)
+            ++wrongRange;
+
+        bool ok = Bench::Check(wrongGroup == 0 && groups.size() == 6, "one contiguous group per material and texture");
+        ok = Bench::Check(wrongRange == 0, "ranges tile each group without gaps") && ok;
+        ok = Bench::Check(wrongIndex == 0, "indices rebased onto each part's own vertices") && ok;
+        return ok;
+    }
+
+    bool VerifyDraws()
+    {
+        Math::RandomGenerator rng(7);
+        CStaticBatch batch;
+        std::vector<Vector3> positions;
+        FillDecoration(batch, rng, 3000, 400.0f, positions);
+        const std::vector<CStaticBatch::Range> &ranges = batch.GetRanges();
+
+        std::vector<CStaticBatch::Draw> draws;
+        size_t all = batch.CollectDraws([](unsigned int) { return true; }, draws);
+        bool ok = Bench::Check(all == ranges.size() && draws.size() == batch.GetGroups().size(), "all visible: one draw per group");
+
+        draws.clear();
+        size_t none = batch.CollectDraws([](unsigned int) { return false; }, draws);
+        ok = Bench::Check(none == 0 && draws.empty(), "nothing visible: no draws") && ok;
+
+        // 随机一半实体可见：绘制覆盖的索引恰好是可见部件的索引
+        std::vector<uint8_t> visible(positions.size(), 0);
+        for (size_t i = 1; i < visible.size(); ++i)
+            visible[i] = (uint8_t)rng.NextInt(0, 2);
+        draws.clear();
+        size_t parts = batch.CollectDraws([&](unsigned int id) { return visible[id] != 0; }, draws);
+
+        std::vector<uint8_t> covered(batch.GetIndices().size(), 0);
+        int wrongDraw = 0;
+        for (size_t d = 0; d < draws.size(); ++d)
+        {
+            const CStaticBatch::Group &group = batch.GetGroups()[draws[d].group];
+            if (draws[d].firstIndex < group.firstIndex ||
+                draws[d].firstIndex + draws[d].indexCount > group.firstIndex + group.indexCount)
+                ++wrongDraw;
+            for (uint32_t k = draws[d].firstIndex; k < draws[d].firstIndex + draws[d].indexCount && k < covered.size(); ++k)
+                ++covered[k];
+        }
+        size_t expectedParts = 0;
+        for (size_t r = 0; r < ranges.size(); ++r)
+        {
+            uint8_t want = visible[ranges[r].ownerID];
+            expectedParts += want;
+            for (uint32_t k = ranges[r].firstIndex; k < ranges[r].firstIndex + ranges[r].indexCount; ++k)
+            {
+                if (covered[k] != want)
+                {
+                    ++wrongDraw;
+                    break;
+                }
+            }
+        }
+        ok = Bench::Check(wrongDraw == 0 && parts == expectedParts, "draws cover exactly the visible parts") && ok;
+        return ok;
+    }
+
+    // ======================================================================
+    // 基准
+    // ======================================================================
+    void BenchDecoration(bool quick)
+    {
+        const size_t sizes[] = {2000, 20000};
+        printf("%-10s %12s %12s %14s %14s %14s\n", "props", "parts", "build ns/v", "draws (all)",
+               "draws (disc)", "parts (disc)");
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+        {
+            const size_t count = sizes[s];
+            if (quick && count > 2000)
+                break;
+
+            std::vector<Vector3> positions;
+            CStaticBatch batch;
+            double ns = Bench::TimeNsPerOp(count * 2 * 24, quick ? 2 : 5, [&]() {
+                Math::RandomGenerator rng(11);
+                batch.Clear();
+                FillDecoration(batch, rng, count, 800.0f, positions);
+            });
+
+            std::vector<CStaticBatch::Draw> draws;
+            batch.CollectDraws([](unsigned int) { return true; }, draws);
+            size_t allDraws = draws.size();
+
+            // 相机只看到偏离中心的一块圆形区域：空间上相邻的部件在组内大多相邻，可见部件合成较少的几段
+            const Vector3 center(100.0f, 0.0f, 60.0f);
+            draws.clear();
+            size_t discParts = batch.CollectDraws([&](unsigned int id) { return (positions[id] - center).Length() < 200.0f; }, draws);
+
+            printf("%-10zu %12zu %12.1f %14zu %14zu %14zu\n", count, batch.GetRanges().size(), ns, allDraws,
+                   draws.size(), discParts);
+        }
+        printf("(without batching every part is its own draw)\n");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = Bench::HasFlag(argc, argv, "--quick");
+
+    bool ok = VerifyTransform();
+    ok = VerifyLayout() && ok;
+    ok = VerifyDraws() && ok;
+    if (!ok)
+        return 1;
+
+    BenchDecoration(quick);
+    return 0;
+}
@@ -0,0 +1,354 @@
+#include "stdafx.h"
+#include "BenchUtils.h"
+#include "Core/JobSystem.h"
+#include "Core/LODController.h"
+#include "Core/TerrainQuadtree.h"
+#include "Math/MathBatch.h"
+#include "Math/Random.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <set>
+
+// ======================================================================
+// 分块地形
+//   TerrainBench [--quick]
+// 校验：每级每种边缘组合的索引都是朝上、面积等于整块、内部边成对的三角网，
+//       对着粗邻块的边只用粗一级的顶点；相邻块级别最多差 1，共用边上的顶点位置完全一致；
+//       平面地形误差为 0、起伏地形误差单调；视锥内的块与逐块测试一致；三角形预算生效
+// 对比：构建耗时（单线程 / 任务系统）、顶点生成耗时、每帧选择耗时与实际绘制的三角形数
+// ======================================================================
+
+namespace
+{
+    const float FOV = 60.0f;
+    const float VIEWPORT_HEIGHT = 720.0f;
+
+    // 起伏地形：几层正弦加少量随机扰动
+    std::vector<float> MakeHeights(int width, int height, float cellSize, uint32_t seed)
+    {
+        Math::RandomGenerator rng(seed);
+        std::vector<float> heights((size_t)width * height);
+        for (int z = 0; z < height; ++z)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                float px = x * cellSize, pz = z * cellSize;
+                heights[(size_t)z * width + x] = 30.0f * std::sin(px * 0.011f) * std::cos(pz * 0.013f) +
+                                                 8.0f * std::sin(px * 0.05f + pz * 0.03f) + rng.NextFloat(-0.3f, 0.3f);
+            }
+        }
+        return heights;
+    }
+
+    // 相机贴近地面朝 -z 看的视锥与 LOD 控制器
+    Frustum MakeView(const Vector3 &eye, const Vector3 &forward, CLODController &lod)
+    {
+        Matrix4 projection = Matrix4::Perspective(Math::ToRadians(FOV), 16.0f / 9.0f, 0.5f, 5000.0f);
+        lod.SetView(eye, projection, VIEWPORT_HEIGHT);
+        Matrix4 viewProjection = projection * Matrix4::LookAt(eye, eye + forward, Vector3::Up());
+        return Frustum::FromMatrix(viewProjection);
+    }
+
+    // ======================================================================
+    // 正确性
+    // ======================================================================
+    // 每级每种边缘组合：三角形朝上、面积之和为整块、内部边正反各一次、边界边的长度与边缘组合一致
+    bool VerifyIndexSets(const CTerrainQuadtree &tree)
+    {
+        const int C = tree.GetChunkCells(), stride = C + 1;
+        const std::vector<uint16_t> &indices = tree.GetIndices();
+        bool oriented = true, area = true, manifold = true, border = true;
+
+        for (int level = 0; level < tree.GetLevelCount(); ++level)
+        {
+            const int s = 1 << level;
+            for (unsigned int edges = 0; edges < 16; ++edges)
+            {
+                const unsigned int effective = (level + 1 < tree.GetLevelCount()) ? edges : 0;
+                const size_t offset = tree.GetIndexOffset(level, edges), count = tree.GetIndexCount(level, edges);
+                double total = 0.0;
+                std::map<std::pair<int, int>, int> directed;
+                for (size_t i = offset; i < offset + count; i += 3)
+                {
+                    int vx[3], vz[3];
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        vx[k] = indices[i + k] % stride;
+                        vz[k] = indices[i + k] / stride;
+                        ++directed[std::make_pair((int)indices[i + k], (int)indices[i + (k + 1) % 3])];
+                    }
+                    // (b - a) x (c - a) 的 y 分量，朝上为正；两条相邻边都拼接时角上会留下投影面积为 0 的竖直三角形，
+                    // 它封住角顶点处的 T 形接缝
+                    int cross = (vz[1] - vz[0]) * (vx[2] - vx[0]) - (vx[1] - vx[0]) * (vz[2] - vz[0]);
+                    oriented = oriented && cross >= 0;
+                    total += 0.5 * cross;
+                }
+                area = area && std::fabs(total - (double)C * C) < 1e-6;
+
+                for (const auto &entry : directed)
+                {
+                    const int a = entry.first.first, b = entry.first.second;
+                    auto reverse = directed.find(std::make_pair(b, a));
+                    if (reverse != directed.end())
+                    {
+                        manifold = manifold && entry.second == 1 && reverse->second == 1;
+                        continue;
+                    }
+                    // 边界边：两端在同一条块边上，长度为本级步长，对着粗邻块时为两倍
+                    const int ax = a % stride, az = a / stride, bx = b % stride, bz = b / stride;
+                    unsigned int side = 0;
+                    if (az == 0 && bz == 0)
+                        side = CTerrainQuadtree::EDGE_NEG_Z;
+                    else if (az == C && bz == C)
+                        side = CTerrainQuadtree::EDGE_POS_Z;
+                    else if (ax == 0 && bx == 0)
+                        side = CTerrainQuadtree::EDGE_NEG_X;
+                    else if (ax == C && bx == C)
+                        side = CTerrainQuadtree::EDGE_POS_X;
+                    const int length = std::abs(ax - bx) + std::abs(az - bz);
+                    border = border && side != 0 && entry.second == 1 && length == ((effective & side) ? 2 * s : s);
+                }
+            }
+        }
+        bool ok = Bench::Check(oriented, "index sets face up");
+        ok = Bench::Check(area, "index sets cover the chunk exactly") && ok;
+        ok = Bench::Check(manifold, "interior edges shared by two triangles") && ok;
+        return Bench::Check(border, "border edges match neighbour resolution") && ok;
+    }
+
+    // 块的某条边上被索引用到的顶点位置（按沿边的顺序）
+    std::vector<Vector3> EdgeVertices(const CTerrainQuadtree &tree, const TerrainChunkDraw &draw, unsigned int side,
+                                      std::vector<TerrainVertex> &scratch)
+    {
+        const int C = tree.GetChunkCells(), stride = C + 1;
+        scratch.resize(tree.GetVerticesPerChunk());
+        tree.BuildChunkVertices(draw.chunk, scratch.data());
+
+        std::set<int> used;
+        const std::vector<uint16_t> &indices = tree.GetIndices();
+        const size_t offset = tree.GetIndexOffset(draw.level, draw.edges), count = tree.GetIndexCount(draw.level, draw.edges);
+        for (size_t i = offset; i < offset + count; ++i)
+        {
+            const int x = indices[i] % stride, z = indices[i] / stride;
+            if ((side == CTerrainQuadtree::EDGE_NEG_Z && z == 0) || (side == CTerrainQuadtree::EDGE_POS_Z && z == C) ||
+                (side == CTerrainQuadtree::EDGE_NEG_X && x == 0) || (side == CTerrainQuadtree::EDGE_POS_X && x == C))
+                used.insert(indices[i]);
+        }
+        std::vector<Vector3> positions;
+        for (int index : used)
+            positions.push_back(Vector3(scratch[index].x, scratch[index].y, scratch[index].z));
+        return positions;
+    }
+
+    // 起伏地形上贴地看远处：相邻块级别差不超过 1，共用边两侧的顶点位置完全相同
+    bool VerifyCrackFree(CJobSystem &jobs)
+    {
+        const int size = 513;
+        std::vector<float> heights = MakeHeights(size, size, 2.0f, 3);
+        CTerrainQuadtree tree;
+        bool ok = Bench::Check(tree.Build(heights.data(), size, size, 2.0f, 16, &jobs), "build 513x513 terrain");
+        ok = Bench::Check(tree.GetChunksX() == 32 && tree.GetLevelCount() == 5, "chunk layout") && ok;
+        ok = VerifyIndexSets(tree) && ok;
+
+        CLODController lod;
+        Vector3 eye(-100.0f, 60.0f, 400.0f);
+        Frustum frustum = MakeView(eye, Vector3(0.3f, -0.25f, -1.0f).Normalized(), lod);
+        std::vector<TerrainChunkDraw> draws;
+        tree.Select(frustum, Matrix4::Identity(), &lod, draws);
+
+        bool balanced = true;
+        for (int z = 0; z < tree.GetChunksZ(); ++z)
+        {
+            for (int x = 0; x < tree.GetChunksX(); ++x)
+            {
+                const int level = tree.GetChunkLevel((size_t)z * tree.GetChunksX() + x);
+                if (x + 1 < tree.GetChunksX())
+                    balanced = balanced && std::abs(level - tree.GetChunkLevel((size_t)z * tree.GetChunksX() + x + 1)) <= 1;
+                if (z + 1 < tree.GetChunksZ())
+                    balanced = balanced && std::abs(level - tree.GetChunkLevel((size_t)(z + 1) * tree.GetChunksX() + x)) <= 1;
+            }
+        }
+
+        std::map<uint32_t, TerrainChunkDraw> visible;
+        for (size_t i = 0; i < draws.size(); ++i)
+            visible[draws[i].chunk] = draws[i];
+
+        size_t stitched = 0, pairs = 0, cracks = 0;
+        std::vector<TerrainVertex> scratch;
+        for (const auto &entry : visible)
+        {
+            const TerrainChunkDraw &draw = entry.second;
+            const uint32_t right = draw.chunk + 1, down = draw.chunk + tree.GetChunksX();
+            stitched += draw.edges != 0;
+            if ((int)(draw.chunk % tree.GetChunksX()) + 1 < tree.GetChunksX() && visible.count(right))
+            {
+                ++pairs;
+                cracks += EdgeVertices(tree, draw, CTerrainQuadtree::EDGE_POS_X, scratch) !=
+                          EdgeVertices(tree, visible[right], CTerrainQuadtree::EDGE_NEG_X, scratch);
+            }
+            if (visible.count(down))
+            {
+                ++pairs;
+                cracks += EdgeVertices(tree, draw, CTerrainQuadtree::EDGE_POS_Z, scratch) !=
+                          EdgeVertices(tree, visible[down], CTerrainQuadtree::EDGE_NEG_Z, scratch);
+            }
+        }
+
+        const TerrainStats &stats = tree.GetStats();
+        ok = Bench::Check(balanced, "neighbour levels differ by at most one") && ok;
+        ok = Bench::Check(stats.reduced > 0 && stats.reduced < stats.visible && stitched > 0, "view mixes levels and stitches") && ok;
+        ok = Bench::Check(pairs > 0 && cracks == 0, "shared edges use identical vertices") && ok;
+        ok = Bench::Check(stats.drawnTriangles < stats.fullTriangles, "LOD reduces triangles") && ok;
+        return ok;
+    }
+
+    // 误差：平面为 0，起伏地形 0 级为 0 且单调；法线与位置
+    bool VerifyErrors()
+    {
+        const int size = 129;
+        std::vector<float> plane((size_t)size * size);
+        for (int z = 0; z < size; ++z)
+        {
+            for (int x = 0; x < size; ++x)
+                plane[(size_t)z * size + x] = 0.25f * x - 0.5f * z + 3.0f;
+        }
+        CTerrainQuadtree flat;
+        flat.Build(plane.data(), size, size, 1.0f, 32);
+        float planeError = 0.0f;
+        for (size_t c = 0; c < flat.GetChunkCount(); ++c)
+            planeError = std::max(planeError, flat.GetChunkError(c, flat.GetLevelCount() - 1));
+
+        CLODController lod;
+        Frustum frustum = MakeView(Vector3(0, 50, 100), Vector3(0, -0.5f, -1).Normalized(), lod);
+        std::vector<TerrainChunkDraw> draws;
+        flat.Select(frustum, Matrix4::Identity(), &lod, draws);
+        bool coarsest = !draws.empty();
+        for (size_t i = 0; i < draws.size(); ++i)
+            coarsest = coarsest && draws[i].level == flat.GetLevelCount() - 1 && draws[i].edges == 0;
+
+        std::vector<float> heights = MakeHeights(size, size, 1.0f, 5);
+        CTerrainQuadtree hills;
+        hills.Build(heights.data(), size, size, 1.0f, 32);
+        bool monotonic = true;
+        for (size_t c = 0; c < hills.GetChunkCount(); ++c)
+        {
+            monotonic = monotonic && hills.GetChunkError(c, 0) == 0.0f && hills.GetChunkError(c, 1) > 0.0f;
+            for (int l = 1; l < hills.GetLevelCount(); ++l)
+                monotonic = monotonic && hills.GetChunkError(c, l) >= hills.GetChunkError(c, l - 1);
+        }
+
+        // 块 (1, 1) 的第一个顶点是高度图的 (32, 32)，平面的法线 ∝ (-0.25, 1, 0.5)
+        std::vector<TerrainVertex> vertices(flat.GetVerticesPerChunk());
+        flat.BuildChunkVertices(1 * flat.GetChunksX() + 1, vertices.data());
+        const TerrainVertex &v = vertices[0];
+        Vector3 n = Vector3(-0.25f, 1.0f, 0.5f).Normalized() * 127.0f;
+        bool vertex = v.x == 32.0f - size * 0.5f && v.z == 32.0f - size * 0.5f && v.y == plane[32 * size + 32] &&
+                      std::abs(v.nx - n.x) <= 1.0f && std::abs(v.ny - n.y) <= 1.0f && std::abs(v.nz - n.z) <= 1.0f;
+
+        bool ok = Bench::Check(planeError < 1e-4f, "planar terrain has no error");
+        ok = Bench::Check(coarsest, "planar terrain selects coarsest level") && ok;
+        ok = Bench::Check(monotonic, "errors start at zero and never decrease") && ok;
+        ok = Bench::Check(vertex, "chunk vertex position and normal") && ok;
+        return ok;
+    }
+
+    // 视锥：层级剔除与逐块测试一致（地形带平移与缩放）；三角形预算
+    bool VerifySelection()
+    {
+        const int size = 1025;
+        std::vector<float> heights = MakeHeights(size, size, 1.0f, 7);
+        CTerrainQuadtree tree;
+        tree.Build(heights.data(), size, size, 1.0f);
+
+        Matrix4 world = Matrix4::Translation(Vector3(100.0f, -20.0f, 50.0f)) * Matrix4::Scale(Vector3(2.0f, 1.5f, 2.0f));
+        CLODController lod;
+        Frustum frustum = MakeView(Vector3(0, 80, 600), Vector3(-0.2f, -0.2f, -1).Normalized(), lod);
+        std::vector<TerrainChunkDraw> draws;
+        tree.Select(frustum, world, &lod, draws);
+
+        std::set<uint32_t> selected, expected;
+        for (size_t i = 0; i < draws.size(); ++i)
+            selected.insert(draws[i].chunk);
+        for (size_t c = 0; c < tree.GetChunkCount(); ++c)
+        {
+            if (frustum.Intersects(Math::Batch::TransformAABB(world, tree.GetChunkBounds(c))))
+                expected.insert((uint32_t)c);
+        }
+        bool ok = Bench::Check(!selected.empty() && selected.size() < tree.GetChunkCount(), "frustum culls some chunks");
+        ok = Bench::Check(selected == expected, "quadtree culling matches per-chunk test") && ok;
+
+        const size_t unbounded = tree.GetStats().drawnTriangles;
+        tree.SetTriangleBudget(unbounded / 4);
+        tree.Select(frustum, world, &lod, draws);
+        size_t drawn = 0;
+        for (size_t i = 0; i < draws.size(); ++i)
+            drawn += tree.GetIndexCount(draws[i].level, draws[i].edges) / 3;
+        ok = Bench::Check(drawn <= unbounded / 4 && drawn == tree.GetStats().drawnTriangles, "triangle budget respected") && ok;
+
+        tree.SetTriangleBudget(0);
+        tree.SetMinLevel(2);
+        tree.Select(frustum, world, &lod, draws);
+        bool minLevel = true;
+        for (size_t i = 0; i < draws.size(); ++i)
+            minLevel = minLevel && draws[i].level >= 2;
+        ok = Bench::Check(minLevel, "minimum level respected") && ok;
+        return ok;
+    }
+
+    // ======================================================================
+    // 基准
+    // ======================================================================
+    void BenchTerrain(CJobSystem &jobs, bool quick)
+    {
+        const int sizes[] = {1025, 2049, 4097};
+        printf("%-10s %8s %12s %12s %12s %12s %10s %14s %14s\n", "heightmap", "chunks", "build ms", "jobs ms",
+               "vertex ns", "select us", "visible", "full tris", "drawn tris");
+
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+        {
+            const int size = sizes[s];
+            if (quick && size > 1025)
+                break;
+            std::vector<float> heights = MakeHeights(size, size, 1.0f, 11);
+            CTerrainQuadtree tree;
+            double serialMs = Bench::TimeNsPerOp(1, 1, [&]() { tree.Build(heights.data(), size, size, 1.0f); }) * 1e-6;
+            double jobsMs = Bench::TimeNsPerOp(1, 1, [&]() { tree.Build(heights.data(), size, size, 1.0f, CTerrainQuadtree::DEFAULT_CHUNK_CELLS, &jobs); }) * 1e-6;
+
+            // 顶点生成：取前 64 块
+            const size_t sample = std::min<size_t>(64, tree.GetChunkCount());
+            std::vector<TerrainVertex> vertices(tree.GetVerticesPerChunk());
+            double vertexNs = Bench::TimeNsPerOp(sample * tree.GetVerticesPerChunk(), 3, [&]() {
+                for (size_t c = 0; c < sample; ++c)
+                    tree.BuildChunkVertices(c, vertices.data());
+            });
+
+            // 相机在地形一角上方朝对角看，远处大量块可见
+            CLODController lod;
+            lod.SetThreshold(2.0f);
+            const float half = size * 0.5f;
+            Frustum frustum = MakeView(Vector3(-half + 20.0f, 60.0f, half - 20.0f), Vector3(1.0f, -0.08f, -1.0f).Normalized(), lod);
+            std::vector<TerrainChunkDraw> draws;
+            double selectUs = Bench::TimeNsPerOp(1, 10, [&]() { tree.Select(frustum, Matrix4::Identity(), &lod, draws); }) * 1e-3;
+
+            const TerrainStats &stats = tree.GetStats();
+            printf("%-10d %8zu %12.1f %12.1f %12.2f %12.1f %10zu %14zu %14zu\n", size, tree.GetChunkCount(), serialMs, jobsMs,
+                   vertexNs, selectUs, stats.visible, stats.fullTriangles, stats.drawnTriangles);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = Bench::HasFlag(argc, argv, "--quick");
+    CJobSystem jobs(3);
+
+    bool ok = VerifyCrackFree(jobs);
+    ok = VerifyErrors() && ok;
+    ok = VerifySelection() && ok;
+    if (!ok)
+        return 1;
+
+    BenchTerrain(jobs, quick);
+    return 0;
+}
@@ -0,0 +1,378 @@
+#include "stdafx.h"
+#include "BenchUtils.h"
+#include "Core/TickScheduler.h"
+#include "Math/Random.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+// ======================================================================
+// CTickScheduler 正确性与每帧开销
+//   TickBench [--quick]
+// 校验：每帧/每 N 帧/按需的执行次数与累计时间、组顺序、回调中增删登记项、子树休眠
+// 对比：旧的逐帧递归 Update 整棵树与按组调度，场景 10k~100k 实体，其中大部分为静态几何
+// CEntity 依赖 Win32/OpenGL，这里的替身节点按 CEntity 的方式维护调度器登记与休眠状态
+// ======================================================================
+
+namespace
+{
+    typedef CTickScheduler::Handle Handle;
+
+    struct Counter
+    {
+        int count = 0;
+        double elapsed = 0.0;
+        int order = -1; // 最近一次执行时的全局序号
+    };
+
+    int g_sequence = 0;
+
+    void CountTick(void *pOwner, float deltaTime)
+    {
+        Counter *pCounter = static_cast<Counter *>(pOwner);
+        ++pCounter->count;
+        pCounter->elapsed += deltaTime;
+        pCounter->order = g_sequence++;
+    }
+
+    bool VerifyFrequency()
+    {
+        bool ok = true;
+        const float dt = 0.01f;
+        const int frames = 100;
+        CTickScheduler scheduler;
+
+        Counter everyFrame, onDemand;
+        std::vector<Counter> everyFour(400);
+        scheduler.Register(&everyFrame, CountTick, TickGroup::Update, 1);
+        Handle hOnDemand = scheduler.Register(&onDemand, CountTick, TickGroup::Update, CTickScheduler::TICK_ON_DEMAND);
+        for (size_t i = 0; i < everyFour.size(); ++i)
+            scheduler.Register(&everyFour[i], CountTick, TickGroup::Update, 4);
+        ok = Bench::Check(scheduler.GetScheduledCount() == 401, "on-demand entry is not scheduled") && ok;
+
+        // 每 4 帧的项按相位错开，每帧执行数量相同
+        int minPerFrame = 1 << 30, maxPerFrame = 0;
+        for (int f = 0; f < frames; ++f)
+        {
+            int before = 0;
+            for (size_t i = 0; i < everyFour.size(); ++i)
+                before += everyFour[i].count;
+            scheduler.Tick(dt);
+            int after = 0;
+            for (size_t i = 0; i < everyFour.size(); ++i)
+                after += everyFour[i].count;
+            minPerFrame = std::min(minPerFrame, after - before);
+            maxPerFrame = std::max(maxPerFrame, after - before);
+        }
+
+        ok = Bench::Check(everyFrame.count == frames && std::fabs(everyFrame.elapsed - frames * dt) < 1e-4, "every-frame count and time") && ok;
+        int wrongFour = 0;
+        for (size_t i = 0; i < everyFour.size(); ++i)
+        {
+            // 累计时间等于最后一次执行时的总时间
+            if (everyFour[i].count != frames / 4 || everyFour[i].elapsed < (frames - 4) * dt - 1e-4 || everyFour[i].elapsed > frames * dt + 1e-4)
+                ++wrongFour;
+        }
+        ok = Bench::Check(wrongFour == 0, "every-4-frames count and accumulated time") && ok;
+        ok = Bench::Check(minPerFrame == 100 && maxPerFrame == 100, "interval phases are staggered evenly") && ok;
+
+        // 按需：请求一次执行一次，重复请求合并
+        ok = Bench::Check(onDemand.count == 0, "on-demand does not tick without request") && ok;
+        scheduler.RequestTick(hOnDemand);
+        scheduler.RequestTick(hOnDemand);
+        scheduler.Tick(dt);
+        scheduler.Tick(dt);
+        ok = Bench::Check(onDemand.count == 1 && std::fabs(onDemand.elapsed - dt) < 1e-6, "on-demand ticks once per request") && ok;
+
+        // 未激活时请求被忽略；每帧执行的项请求后不重复执行
+        scheduler.SetActive(hOnDemand, false);
+        scheduler.RequestTick(hOnDemand);
+        scheduler.Tick(dt);
+        ok = Bench::Check(onDemand.count == 1, "inactive entry ignores requests") && ok;
+        int everyFrameBefore = everyFrame.count;
+        scheduler.RequestTick(0);
+        scheduler.Tick(dt);
+        ok = Bench::Check(everyFrame.count == everyFrameBefore + 1, "request does not double-tick a due entry") && ok;
+
+        // 休眠后重新激活：累计时间从激活时刻开始
+        Counter sleeper;
+        Handle hSleeper = scheduler.Register(&sleeper, CountTick, TickGroup::Update, 4);
+        scheduler.SetActive(hSleeper, false);
+        for (int f = 0; f < 20; ++f)
+            scheduler.Tick(dt);
+        ok = Bench::Check(sleeper.count == 0, "inactive entry does not tick") && ok;
+        scheduler.SetActive(hSleeper, true);
+        for (int f = 0; f < 4; ++f)
+            scheduler.Tick(dt);
+        ok = Bench::Check(sleeper.count == 1 && sleeper.elapsed <= 4 * dt + 1e-4, "reactivated entry accumulates from wake-up") && ok;
+
+        // 改频率与注销
+        scheduler.SetInterval(hSleeper, 1);
+        scheduler.Tick(dt);
+        scheduler.Tick(dt);
+        ok = Bench::Check(sleeper.count == 3, "interval change applies") && ok;
+        scheduler.Unregister(hSleeper);
+        scheduler.Tick(dt);
+        ok = Bench::Check(sleeper.count == 3 && scheduler.GetRegisteredCount() == 402, "unregistered entry stops") && ok;
+        return ok;
+    }
+
+    bool VerifyGroups()
+    {
+        CTickScheduler scheduler;
+        Counter counters[(size_t)TickGroup::Count];
+        for (int g = (int)TickGroup::Count - 1; g >= 0; --g)
+            scheduler.Register(&counters[g], CountTick, (TickGroup)g, 1);
+
+        scheduler.Tick(0.01f);
+        bool ordered = true;
+        for (size_t g = 1; g < (size_t)TickGroup::Count; ++g)
+            ordered = ordered && counters[g - 1].order < counters[g].order;
+        bool ok = Bench::Check(ordered, "groups run in declaration order");
+
+        // 换组后按新组的顺序执行
+        scheduler.SetGroup(0, TickGroup::PrePhysics); // 0 号登记的是 LateCamera 的计数器
+        scheduler.Tick(0.01f);
+        ok = Bench::Check(counters[(size_t)TickGroup::LateCamera].order < counters[(size_t)TickGroup::Update].order, "SetGroup moves entry") && ok;
+        return ok;
+    }
+
+    // 回调中增删登记项
+    struct Mutator
+    {
+        CTickScheduler *pScheduler;
+        Handle self;
+        Handle victim;
+        Counter *pSpawned;
+        Handle spawned;
+        int count;
+    };
+
+    void MutatingTick(void *pOwner, float)
+    {
+        Mutator *pMutator = static_cast<Mutator *>(pOwner);
+        ++pMutator->count;
+        pMutator->pScheduler->Unregister(pMutator->victim);
+        pMutator->spawned = pMutator->pScheduler->Register(pMutator->pSpawned, CountTick, TickGroup::Update, 1);
+        pMutator->pScheduler->Unregister(pMutator->self);
+    }
+
+    bool VerifyMutation()
+    {
+        CTickScheduler scheduler;
+        Counter before, victim, after, spawned;
+        Mutator mutator = {&scheduler, 0, 0, &spawned, 0, 0};
+
+        scheduler.Register(&before, CountTick, TickGroup::Update, 1);
+        mutator.self = scheduler.Register(&mutator, MutatingTick, TickGroup::Update, 1);
+        scheduler.Register(&after, CountTick, TickGroup::Update, 1);
+        mutator.victim = scheduler.Register(&victim, CountTick, TickGroup::Update, 1);
+
+        scheduler.Tick(0.01f);
+        bool ok = Bench::Check(mutator.count == 1 && before.count == 1 && after.count == 1, "entries around a mutating callback still tick");
+        ok = Bench::Check(victim.count == 0, "entry removed during the frame does not tick") && ok;
+        ok = Bench::Check(spawned.count == 0, "entry added during the frame starts next frame") && ok;
+
+        scheduler.Tick(0.01f);
+        ok = Bench::Check(mutator.count == 1 && before.count == 2 && after.count == 2 && spawned.count == 1, "list is consistent after compaction") && ok;
+        ok = Bench::Check(scheduler.GetScheduledCount() == 3 && scheduler.GetRegisteredCount() == 3, "counts after mutation") && ok;
+        return ok;
+    }
+
+    // ======================================================================
+    // 替身实体：按 CEntity 的方式维护登记与子树休眠
+    // ======================================================================
+    struct Node
+    {
+        virtual ~Node() {}
+        virtual void Update(float) {}
+
+        // 旧 CEntity::Update：先更新自己再递归子节点
+        void UpdateRecursive(float deltaTime)
+        {
+            Update(deltaTime);
+            for (size_t i = 0; i < children.size(); ++i)
+                children[i]->UpdateRecursive(deltaTime);
+        }
+
+        Node *AddChild(Node *pChild)
+        {
+            children.push_back(std::unique_ptr<Node>(pChild));
+            pChild->SetTickContext(pScheduler, !IsTickEnabled());
+            return pChild;
+        }
+
+        bool IsTickEnabled() const { return !parentPaused && !sleeping; }
+        void SetSleeping(bool value)
+        {
+            if (sleeping == value)
+                return;
+            sleeping = value;
+            Refresh();
+        }
+
+        void SetTickContext(CTickScheduler *pNewScheduler, bool newParentPaused)
+        {
+            if (pScheduler == pNewScheduler && parentPaused == newParentPaused)
+                return;
+            if (pScheduler != pNewScheduler)
+            {
+                if (pScheduler)
+                    pScheduler->Unregister(handle);
+                handle = pNewScheduler ? pNewScheduler->Register(this, Thunk, TickGroup::Update, interval) : CTickScheduler::INVALID_HANDLE;
+                pScheduler = pNewScheduler;
+            }
+            parentPaused = newParentPaused;
+            Refresh();
+        }
+
+        void Refresh()
+        {
+            bool enabled = IsTickEnabled();
+            if (pScheduler)
+                pScheduler->SetActive(handle, enabled);
+            for (size_t i = 0; i < children.size(); ++i)
+                children[i]->SetTickContext(pScheduler, !enabled);
+        }
+
+        static void Thunk(void *pOwner, float deltaTime) { static_cast<Node *>(pOwner)->Update(deltaTime); }
+
+        std::vector<std::unique_ptr<Node>> children;
+        CTickScheduler *pScheduler = nullptr;
+        Handle handle = CTickScheduler::INVALID_HANDLE;
+        uint32_t interval = CTickScheduler::TICK_ON_DEMAND;
+        bool sleeping = false;
+        bool parentPaused = false;
+    };
+
+    struct Mover : Node
+    {
+        explicit Mover(uint32_t tickInterval) { interval = tickInterval; }
+        virtual void Update(float deltaTime) override
+        {
+            x += speed * deltaTime;
+            ++ticks;
+        }
+
+        float x = 0.0f;
+        float speed = 1.0f;
+        int ticks = 0;
+    };
+
+    bool VerifySubtreeSleep()
+    {
+        CTickScheduler scheduler;
+        Node root;
+        root.SetTickContext(&scheduler, false);
+
+        // root - group - (a, inner - b)
+        Node *group = root.AddChild(new Node());
+        Mover *a = static_cast<Mover *>(group->AddChild(new Mover(1)));
+        Node *inner = group->AddChild(new Node());
+        Mover *b = static_cast<Mover *>(inner->AddChild(new Mover(1)));
+        Mover *c = static_cast<Mover *>(root.AddChild(new Mover(1)));
+
+        scheduler.Tick(0.01f);
+        bool ok = Bench::Check(a->ticks == 1 && b->ticks == 1 && c->ticks == 1 && scheduler.GetScheduledCount() == 3, "static nodes are not scheduled");
+
+        group->SetSleeping(true);
+        scheduler.Tick(0.01f);
+        ok = Bench::Check(a->ticks == 1 && b->ticks == 1 && c->ticks == 2 && scheduler.GetScheduledCount() == 1, "sleeping subtree is skipped") && ok;
+
+        // 祖先醒来时，自身休眠的子树仍然休眠
+        inner->SetSleeping(true);
+        group->SetSleeping(false);
+        scheduler.Tick(0.01f);
+        ok = Bench::Check(a->ticks == 2 && b->ticks == 1, "nested sleep survives ancestor wake-up") && ok;
+        inner->SetSleeping(false);
+        scheduler.Tick(0.01f);
+        ok = Bench::Check(a->ticks == 3 && b->ticks == 2 && scheduler.GetScheduledCount() == 3, "wake-up restores subtree") && ok;
+
+        // 挂到休眠节点下的新子树同样不执行
+        inner->SetSleeping(true);
+        Mover *d = static_cast<Mover *>(inner->AddChild(new Mover(1)));
+        scheduler.Tick(0.01f);
+        ok = Bench::Check(d->ticks == 0 && b->ticks == 2, "child added under sleeping node stays asleep") && ok;
+        return ok;
+    }
+
+    bool Verify()
+    {
+        bool ok = VerifyFrequency();
+        ok = VerifyGroups() && ok;
+        ok = VerifyMutation() && ok;
+        ok = VerifySubtreeSleep() && ok;
+        if (ok)
+            printf("[ OK ] intervals, on-demand, groups, mutation during tick, subtree sleep\n");
+        return ok;
+    }
+
+    // ======================================================================
+    // 每帧开销：1% 每帧更新、2% 每 4 帧更新，其余为静态几何
+    // ======================================================================
+    void BuildScene(Node &root, size_t count, std::vector<Node *> &branches)
+    {
+        Math::RandomGenerator rng(15);
+        std::vector<Node *> nodes(1, &root);
+        for (size_t i = 1; i < count; ++i)
+        {
+            Node *parent = nodes[(size_t)rng.NextInt(std::max(0, (int)nodes.size() - 512), (int)nodes.size())];
+            int kind = rng.NextInt(0, 100);
+            Node *node = kind == 0 ? new Mover(1) : kind <= 2 ? new Mover(4) : new Node();
+            nodes.push_back(parent->AddChild(node));
+            if (parent == &root)
+                branches.push_back(node);
+        }
+    }
+
+    void BenchFrame(bool quick)
+    {
+        const size_t sizes[] = {10000, 100000};
+        const int frames = quick ? 20 : 200;
+        printf("%-10s %12s %18s %18s %18s\n", "entities", "scheduled", "recursive ns/frame", "scheduled ns/frame", "half asleep ns/frame");
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+        {
+            const size_t count = sizes[s];
+            if (quick && count > 10000)
+                break;
+
+            CTickScheduler scheduler;
+            Node root;
+            root.SetTickContext(&scheduler, false);
+            std::vector<Node *> branches;
+            BuildScene(root, count, branches);
+            size_t scheduled = scheduler.GetScheduledCount();
+
+            double recursive = Bench::TimeNsPerOp(frames, 3, [&]() {
+                for (int f = 0; f < frames; ++f)
+                    root.UpdateRecursive(0.016f);
+            });
+            double ticked = Bench::TimeNsPerOp(frames, 3, [&]() {
+                for (int f = 0; f < frames; ++f)
+                    scheduler.Tick(0.016f);
+            });
+
+            // 一半的顶层子树休眠
+            for (size_t i = 0; i < branches.size(); i += 2)
+                branches[i]->SetSleeping(true);
+            double halfAsleep = Bench::TimeNsPerOp(frames, 3, [&]() {
+                for (int f = 0; f < frames; ++f)
+                    scheduler.Tick(0.016f);
+            });
+            Bench::g_sink = (float)scheduler.GetTime();
+
+            printf("%-10zu %12zu %18.0f %18.0f %18.0f\n", count, scheduled, recursive, ticked, halfAsleep);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = Bench::HasFlag(argc, argv, "--quick");
+
+    if (!Verify())
+        return 1;
+
+    BenchFrame(quick);
+    return 0;
+}
@@ -0,0 +1,443 @@
+#include "stdafx.h"
+#include "BenchUtils.h"
+#include "Core/TransformStore.h"
+#include "Core/JobSystem.h"
+#include "Math/Random.h"
+#include <cstring>
+#include <queue>
+
+// ======================================================================
+// CTransformStore 正确性与层级刷新耗时
+//   TransformBench [--quick]
+// 校验：随机改局部变换/改父/销毁/新建后，按需查询与整帧扫描（串行/按子树分组并行）都与逐节点递归计算的结果一致
+// 对比：旧 CEntity 方式（shared_ptr 子节点 + weak_ptr 父节点 + std::queue 传播脏标记 + 递归取父矩阵）
+// 并行：10 万节点的森林/人群/碎片场景，串行扫描与不同线程数的分组并行扫描
+// ======================================================================
+
+namespace
+{
+    using Bench::TimeNsPerOp;
+    typedef CTransformStore::Handle Handle;
+
+    bool NearlyEqual(const Matrix4 &a, const Matrix4 &b)
+    {
+        for (int i = 0; i < 16; ++i)
+        {
+            float tolerance = 1e-3f * (1.0f + fabsf(a.m[i]));
+            if (fabsf(a.m[i] - b.m[i]) > tolerance)
+                return false;
+        }
+        return true;
+    }
+
+    void RandomLocal(Math::RandomGenerator &rng, Vector3 &position, Quaternion &rotation, Vector3 &scale)
+    {
+        position = rng.NextVector3(Vector3(-5.0f, -5.0f, -5.0f), Vector3(5.0f, 5.0f, 5.0f));
+        rotation = Quaternion::FromEuler(rng.NextFloat(-1.0f, 1.0f), rng.NextFloat(-1.0f, 1.0f), rng.NextFloat(-1.0f, 1.0f));
+        float s = rng.NextFloat(0.9f, 1.1f);
+        scale = Vector3(s, s, s);
+    }
+
+    // ======================================================================
+    // 参考实现：句柄 -> 局部变换/父句柄，递归计算
+    // ======================================================================
+    struct Reference
+    {
+        std::vector<Vector3> position, scale;
+        std::vector<Quaternion> rotation;
+        std::vector<Handle> parent;
+        std::vector<bool> alive;
+
+        void Ensure(Handle h)
+        {
+            if (h >= alive.size())
+            {
+                position.resize(h + 1);
+                scale.resize(h + 1);
+                rotation.resize(h + 1);
+                parent.resize(h + 1, CTransformStore::INVALID_HANDLE);
+                alive.resize(h + 1, false);
+            }
+        }
+
+        Matrix4 World(Handle h) const
+        {
+            Matrix4 local = Matrix4::TRS(position[h], rotation[h], scale[h]);
+            Handle p = parent[h];
+            if (p != CTransformStore::INVALID_HANDLE && alive[p])
+                return World(p) * local;
+            return local;
+        }
+    };
+
+    bool IsAncestor(const Reference &ref, Handle ancestor, Handle node)
+    {
+        for (Handle h = node; h != CTransformStore::INVALID_HANDLE && ref.alive[h]; h = ref.parent[h])
+        {
+            if (h == ancestor)
+                return true;
+        }
+        return false;
+    }
+
+    bool Verify()
+    {
+        bool ok = true;
+        CTransformStore store;
+        Reference ref;
+        Math::RandomGenerator rng(11);
+        std::vector<Handle> live;
+        CJobSystem jobs(3);
+
+        auto create = [&]() {
+            Handle h = store.Create();
+            ref.Ensure(h);
+            ref.alive[h] = true;
+            ref.parent[h] = CTransformStore::INVALID_HANDLE;
+            RandomLocal(rng, ref.position[h], ref.rotation[h], ref.scale[h]);
+            store.SetLocal(h, ref.position[h], ref.rotation[h], ref.scale[h]);
+            if (!live.empty() && rng.NextInt(0, 8) != 0)
+            {
+                Handle p = live[rng.NextInt(0, (int)live.size())];
+                store.SetParent(h, p);
+                ref.parent[h] = p;
+            }
+            live.push_back(h);
+        };
+
+        // 节点数超过 PARALLEL_THRESHOLD，奇数轮走并行路径
+        for (int i = 0; i < 10000; ++i)
+            create();
+        store.UpdateWorldMatrices();
+
+        int mismatches = 0;
+        for (int round = 0; round < 20; ++round)
+        {
+            // 随机修改：局部变换、改父（含挂到后创建的节点下，触发重排）、销毁、新建
+            for (int k = 0; k < 50; ++k)
+            {
+                Handle h = live[rng.NextInt(0, (int)live.size())];
+                RandomLocal(rng, ref.position[h], ref.rotation[h], ref.scale[h]);
+                store.SetLocal(h, ref.position[h], ref.rotation[h], ref.scale[h]);
+            }
+            for (int k = 0; k < 10; ++k)
+            {
+                Handle h = live[rng.NextInt(0, (int)live.size())];
+                Handle p = live[rng.NextInt(0, (int)live.size())];
+                bool cycle = IsAncestor(ref, h, p);
+                bool accepted = store.SetParent(h, p);
+                mismatches += accepted == cycle ? 1 : 0;
+                if (accepted)
+                    ref.parent[h] = p;
+            }
+            for (int k = 0; k < 5; ++k)
+            {
+                size_t at = (size_t)rng.NextInt(0, (int)live.size());
+                Handle h = live[at];
+                live[at] = live.back();
+                live.pop_back();
+                store.Destroy(h);
+                ref.alive[h] = false;
+                // 销毁节点的子节点变为根节点
+                for (size_t c = 0; c < live.size(); ++c)
+                {
+                    if (ref.parent[live[c]] == h)
+                        ref.parent[live[c]] = CTransformStore::INVALID_HANDLE;
+                }
+            }
+            for (int k = 0; k < 5; ++k)
+                create();
+
+            // 扫描前按需查询
+            for (int k = 0; k < 50; ++k)
+            {
+                Handle h = live[rng.NextInt(0, (int)live.size())];
+                mismatches += NearlyEqual(store.GetWorldMatrix(h), ref.World(h)) ? 0 : 1;
+            }
+
+            store.UpdateWorldMatrices(round % 2 ? &jobs : nullptr);
+            for (size_t c = 0; c < live.size(); ++c)
+            {
+                Handle h = live[c];
+                mismatches += NearlyEqual(store.GetWorldMatrix(h), ref.World(h)) ? 0 : 1;
+                mismatches += store.GetParent(h) == ref.parent[h] ? 0 : 1;
+            }
+        }
+        ok = Bench::Check(mismatches == 0, "store matches recursive reference") && ok;
+        ok = Bench::Check(store.GetCount() == live.size(), "live count") && ok;
+
+        // 无修改的一帧不重算任何节点
+        store.UpdateWorldMatrices();
+        ok = Bench::Check(store.GetLastUpdatedCount() == 0, "clean frame updates nothing") && ok;
+
+        ok = Bench::Check(store.GetParallelGroupCount() > 1, "parallel groups recorded") && ok;
+
+        if (ok)
+            printf("[ OK ] transform store matches reference (%zu nodes, %zu groups, 20 mutation rounds)\n", live.size(), store.GetParallelGroupCount());
+        else
+            printf("       %d mismatches\n", mismatches);
+        return ok;
+    }
+
+    // ======================================================================
+    // 旧方式：与原 CEntity 的变换部分相同
+    // ======================================================================
+    struct LegacyNode
+    {
+        Vector3 position = Vector3::Zero();
+        Quaternion rotation = Quaternion::Identity();
+        Vector3 scale = Vector3::One();
+        std::weak_ptr<LegacyNode> parent;
+        std::vector<std::shared_ptr<LegacyNode>> children;
+        mutable Matrix4 world = Matrix4::Identity();
+        mutable bool dirty = true;
+
+        Matrix4 GetWorldMatrix() const
+        {
+            if (dirty)
+            {
+                Matrix4 local = Matrix4::TRS(position, rotation, scale);
+                if (auto p = parent.lock())
+                    world = p->GetWorldMatrix() * local;
+                else
+                    world = local;
+                dirty = false;
+            }
+            return world;
+        }
+
+        void MarkDirty()
+        {
+            if (dirty)
+                return;
+            dirty = true;
+            std::queue<LegacyNode *> queue;
+            for (auto &child : children)
+                queue.push(child.get());
+            while (!queue.empty())
+            {
+                LegacyNode *current = queue.front();
+                queue.pop();
+                if (!current->dirty)
+                {
+                    current->dirty = true;
+                    for (auto &child : current->children)
+                        queue.push(child.get());
+                }
+            }
+        }
+    };
+
+    // 层级形状：每个节点的父节点（创建序号），-1 为根
+    std::vector<int> MakeShape(const char *kind, int count)
+    {
+        std::vector<int> parents(count);
+        for (int i = 0; i < count; ++i)
+        {
+            if (strcmp(kind, "deep") == 0)
+                parents[i] = i % 100 == 0 ? -1 : i - 1; // 100 条深 100 的链
+            else
+                parents[i] = i == 0 ? -1 : (i - 1) / 8; // 8 叉树
+        }
+        return parents;
+    }
+
+    void BenchShape(const char *kind, int count, int repeat)
+    {
+        std::vector<int> parents = MakeShape(kind, count);
+        Math::RandomGenerator rng(5);
+
+        std::vector<std::shared_ptr<LegacyNode>> legacy(count);
+        CTransformStore store;
+        std::vector<Handle> handles(count);
+        for (int i = 0; i < count; ++i)
+        {
+            legacy[i] = std::make_shared<LegacyNode>();
+            handles[i] = store.Create();
+            RandomLocal(rng, legacy[i]->position, legacy[i]->rotation, legacy[i]->scale);
+            store.SetLocal(handles[i], legacy[i]->position, legacy[i]->rotation, legacy[i]->scale);
+            if (parents[i] >= 0)
+            {
+                legacy[i]->parent = legacy[parents[i]];
+                legacy[parents[i]]->children.push_back(legacy[i]);
+                store.SetParent(handles[i], handles[parents[i]]);
+            }
+        }
+        store.UpdateWorldMatrices();
+
+        std::vector<int> roots;
+        for (int i = 0; i < count; ++i)
+        {
+            if (parents[i] < 0)
+                roots.push_back(i);
+        }
+        std::vector<int> touched(count / 100);
+        for (size_t i = 0; i < touched.size(); ++i)
+            touched[i] = rng.NextInt(0, count);
+
+        float acc = 0.0f;
+        Vector3 offset(0.01f, 0.0f, 0.0f);
+
+        // 1. 移动所有根节点：整棵树都要重算
+        double legacyAll = TimeNsPerOp(count, repeat, [&]() {
+            for (size_t r = 0; r < roots.size(); ++r)
+            {
+                LegacyNode &node = *legacy[roots[r]];
+                node.position += offset;
+                node.MarkDirty();
+            }
+            for (int i = 0; i < count; ++i)
+                acc += legacy[i]->GetWorldMatrix().m[12];
+        });
+        double storeAll = TimeNsPerOp(count, repeat, [&]() {
+            for (size_t r = 0; r < roots.size(); ++r)
+            {
+                Handle h = handles[roots[r]];
+                store.SetLocalPosition(h, store.GetLocalPosition(h) + offset);
+            }
+            store.UpdateWorldMatrices();
+        });
+        acc += store.GetWorldMatrix(handles[count - 1]).m[12];
+
+        // 2. 随机修改 1% 的节点（子树随之过期）
+        double legacySparse = TimeNsPerOp(count, repeat, [&]() {
+            for (size_t t = 0; t < touched.size(); ++t)
+            {
+                LegacyNode &node = *legacy[touched[t]];
+                node.position += offset;
+                node.MarkDirty();
+            }
+            for (int i = 0; i < count; ++i)
+                acc += legacy[i]->GetWorldMatrix().m[13];
+        });
+        double storeSparse = TimeNsPerOp(count, repeat, [&]() {
+            for (size_t t = 0; t < touched.size(); ++t)
+            {
+                Handle h = handles[touched[t]];
+                store.SetLocalPosition(h, store.GetLocalPosition(h) + offset);
+            }
+            store.UpdateWorldMatrices();
+        });
+        acc += store.GetWorldMatrix(handles[count / 2]).m[13];
+
+        printf("%-6s %8d %14.2f %14.2f %14.2f %14.2f\n", kind, count, legacyAll, storeAll, legacySparse, storeSparse);
+        Bench::g_sink = acc;
+    }
+
+    // ======================================================================
+    // 并行
+    // ======================================================================
+    // 层级形状：每个节点的父节点（创建序号），-1 为根
+    std::vector<int> MakeSceneShape(const char *kind, int count)
+    {
+        std::vector<int> parents(count);
+        for (int i = 0; i < count; ++i)
+        {
+            if (strcmp(kind, "forest") == 0)
+            {
+                // 场景根节点下挂树，每棵树 100 个节点：树干 -> 9 个枝 -> 每枝 10 片叶
+                int j = i - 1, tree = 1 + j / 100 * 100, k = j % 100;
+                parents[i] = i == 0 ? -1 : (k == 0 ? 0 : (k < 10 ? tree : tree + 1 + (k - 10) / 10));
+            }
+            else if (strcmp(kind, "crowd") == 0)
+            {
+                // 每个角色 50 根骨骼的链
+                parents[i] = i % 50 == 0 ? -1 : i - 1;
+            }
+            else
+            {
+                parents[i] = -1; // 碎片：全部是根节点
+            }
+        }
+        return parents;
+    }
+
+    void BuildScene(CTransformStore &store, const std::vector<int> &parents, std::vector<Handle> &handles)
+    {
+        Math::RandomGenerator rng(21);
+        handles.resize(parents.size());
+        for (size_t i = 0; i < parents.size(); ++i)
+        {
+            Vector3 position, scale;
+            Quaternion rotation;
+            RandomLocal(rng, position, rotation, scale);
+            handles[i] = store.Create();
+            store.SetLocal(handles[i], position, rotation, scale);
+            if (parents[i] >= 0)
+                store.SetParent(handles[i], handles[parents[i]]);
+        }
+    }
+
+    bool BenchParallel(const char *kind, int count, int repeat)
+    {
+        std::vector<int> parents = MakeSceneShape(kind, count);
+        CTransformStore serial;
+        std::vector<Handle> serialHandles;
+        BuildScene(serial, parents, serialHandles);
+        serial.UpdateWorldMatrices();
+
+        // 每帧所有节点都有动画：全部标记后重算
+        auto touchAll = [](CTransformStore &store, const std::vector<Handle> &handles) {
+            for (size_t i = 0; i < handles.size(); ++i)
+                store.SetLocalScale(handles[i], store.GetLocalScale(handles[i]));
+        };
+        double serialNs = TimeNsPerOp(count, repeat, [&]() {
+            touchAll(serial, serialHandles);
+            serial.UpdateWorldMatrices();
+        });
+
+        unsigned maxWorkers = std::thread::hardware_concurrency();
+        if (maxWorkers < 2)
+            maxWorkers = 2;
+        bool ok = true;
+        for (unsigned workers = 1; workers <= maxWorkers; workers *= 2)
+        {
+            CJobSystem jobs(workers);
+            CTransformStore store;
+            std::vector<Handle> handles;
+            BuildScene(store, parents, handles);
+            store.UpdateWorldMatrices(&jobs);
+
+            double ns = TimeNsPerOp(count, repeat, [&]() {
+                touchAll(store, handles);
+                store.UpdateWorldMatrices(&jobs);
+            });
+
+            // 并行与串行结果逐位一致
+            bool same = true;
+            for (int i = 0; i < count; ++i)
+                same = same && memcmp(store.GetWorldMatrix(handles[i]).m, serial.GetWorldMatrix(serialHandles[i]).m, sizeof(float) * 16) == 0;
+            ok = Bench::Check(same, "parallel update matches serial") && ok;
+
+            printf("%-8s %8d %8zu %8u %12.2f %12.2f %9.2fx\n", kind, count, store.GetParallelGroupCount(), jobs.GetThreadCount(),
+                   serialNs, ns, serialNs / ns);
+        }
+        return ok;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = Bench::HasFlag(argc, argv, "--quick");
+
+    if (!Verify())
+        return 1;
+
+    const int repeat = quick ? 2 : 10;
+    printf("ns per node per frame\n");
+    printf("%-6s %8s %14s %14s %14s %14s\n", "shape", "nodes", "legacy all", "store all", "legacy 1%", "store 1%");
+    const int sizes[] = {10000, 100000};
+    for (int s = 0; s < (quick ? 1 : 2); ++s)
+    {
+        BenchShape("deep", sizes[s], repeat);
+        BenchShape("wide", sizes[s], repeat);
+    }
+
+    printf("\nparallel update, all nodes animated (hardware threads: %u)\n", std::thread::hardware_concurrency());
+    printf("%-8s %8s %8s %8s %12s %12s %10s\n", "scene", "nodes", "groups", "threads", "serial ns", "parallel ns", "speedup");
+    bool ok = true;
+    ok = BenchParallel("forest", 100000, repeat) && ok;
+    ok = BenchParallel("crowd", 100000, repeat) && ok;
+    ok = BenchParallel("debris", 100000, repeat) && ok;
+    return ok ? 0 : 1;
+}
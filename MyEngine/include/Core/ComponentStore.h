@@ -0,0 +1,248 @@
+// ======================================================================
+#ifndef __COMPONENT_STORE_H__
+#define __COMPONENT_STORE_H__
+// ======================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "Core/JobSystem.h"
+// ======================================================================
+
+// 按原型（archetype）分块存放的组件仓库，与 CEntity 并存，用于大批量的简单对象
+// - 组件组合相同的实体属于同一原型；原型的数据切成 16KB 的块，
+//   块内每种组件一列（SoA），查询按块线性遍历紧密排列的组件数组
+// - 组件必须可平凡复制（搬移原型时按字节复制），对齐不超过 16
+// - 实体 ID 带代数（与 CHandleTable 相同编码），销毁后旧 ID 失效
+// - 增删组件会把实体搬到另一原型；遍历期间不能增删实体或组件
+class CComponentStore
+{
+public:
+    typedef uint32_t Entity;
+    typedef uint64_t ComponentMask;
+
+    static const Entity INVALID_ENTITY = 0;
+    static const uint32_t MAX_COMPONENT_TYPES = 64;
+    static const size_t CHUNK_SIZE = 16 * 1024;
+
+    CComponentStore();
+    ~CComponentStore();
+
+    CComponentStore(const CComponentStore &) = delete;
+    CComponentStore &operator=(const CComponentStore &) = delete;
+
+    // 组件类型编号：进程内按首次使用的顺序分配
+    template <typename T>
+    static uint32_t GetTypeId()
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "组件必须可平凡复制");
+        static_assert(alignof(T) <= 16, "组件对齐不能超过 16");
+        static const uint32_t s_id = RegisterType(sizeof(T));
+        return s_id;
+    }
+
+    template <typename... Ts>
+    static ComponentMask MaskOf()
+    {
+        ComponentMask mask = 0;
+        (void)std::initializer_list<int>{(mask |= ComponentMask(1) << GetTypeId<Ts>(), 0)...};
+        return mask;
+    }
+
+    // ======================================================================
+    // 实体
+    // ======================================================================
+    Entity Create();
+    template <typename... Ts>
+    Entity Create(const Ts &...components)
+    {
+        Entity entity = CreateInArchetype(FindOrCreateArchetype(MaskOf<Ts...>()));
+        (void)std::initializer_list<int>{(memcpy(GetComponent(entity, GetTypeId<Ts>()), &components, sizeof(Ts)), 0)...};
+        return entity;
+    }
+
+    void Destroy(Entity entity);
+    void Clear();
+
+    bool IsAlive(Entity entity) const
+    {
+        uint32_t index = entity & INDEX_MASK;
+        return index < m_records.size() && m_records[index].generation == (entity >> INDEX_BITS) &&
+               m_records[index].archetype != NO_ARCHETYPE;
+    }
+
+    size_t GetEntityCount() const { return m_entityCount; }
+    size_t GetArchetypeCount() const { return m_archetypes.size(); }
+    size_t GetChunkCount() const;
+
+    // ======================================================================
+    // 组件
+    // ======================================================================
+    // 添加组件（已存在时覆盖），返回组件地址；地址在下次增删前有效
+    template <typename T>
+    T *Add(Entity entity, const T &value = T())
+    {
+        void *p = AddComponent(entity, GetTypeId<T>());
+        if (p)
+            memcpy(p, &value, sizeof(T));
+        return static_cast<T *>(p);
+    }
+
+    template <typename T>
+    void Remove(Entity entity) { RemoveComponent(entity, GetTypeId<T>()); }
+
+    template <typename T>
+    bool Has(Entity entity) const { return IsAlive(entity) && (GetMask(entity) & (ComponentMask(1) << GetTypeId<T>())) != 0; }
+
+    // 没有该组件或实体已销毁时返回空
+    template <typename T>
+    T *Get(Entity entity) { return static_cast<T *>(GetComponent(entity, GetTypeId<T>())); }
+
+    ComponentMask GetMask(Entity entity) const;
+
+    // ======================================================================
+    // 查询：遍历所有包含 Ts... 且不含 exclude 中任何组件的原型
+    // ======================================================================
+    // func(size_t count, const Entity *entities, Ts *...columns)，每次一个块
+    template <typename... Ts, typename Func>
+    void EachChunk(Func func, ComponentMask exclude = 0)
+    {
+        const ComponentMask mask = MaskOf<Ts...>();
+        for (size_t a = 0; a < m_archetypes.size(); ++a)
+        {
+            Archetype &arch = m_archetypes[a];
+            if (!arch.Matches(mask, exclude))
+                continue;
+            for (size_t c = 0, used = arch.GetUsedChunkCount(); c < used; ++c)
+                CallChunk<Ts...>(arch, c, func);
+        }
+    }
+
+    // func(Ts &...)，逐个实体
+    template <typename... Ts, typename Func>
+    void Each(Func func, ComponentMask exclude = 0)
+    {
+        EachChunk<Ts...>([&func](size_t count, const Entity *, Ts *...columns) {
+            for (size_t i = 0; i < count; ++i)
+                func(columns[i]...);
+        }, exclude);
+    }
+
+    // 同 EachChunk，各块分给任务系统并行执行；pJobs 为空时串行
+    template <typename... Ts, typename Func>
+    void EachChunkParallel(CJobSystem *pJobs, Func func, ComponentMask exclude = 0)
+    {
+        if (!pJobs)
+        {
+            EachChunk<Ts...>(func, exclude);
+            return;
+        }
+
+        const ComponentMask mask = MaskOf<Ts...>();
+        m_chunkScratch.clear();
+        for (size_t a = 0; a < m_archetypes.size(); ++a)
+        {
+            Archetype &arch = m_archetypes[a];
+            if (!arch.Matches(mask, exclude))
+                continue;
+            for (size_t c = 0, used = arch.GetUsedChunkCount(); c < used; ++c)
+                m_chunkScratch.push_back(ChunkRef{(uint32_t)a, (uint32_t)c});
+        }
+        pJobs->ParallelFor(m_chunkScratch.size(), 1, [this, &func](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k)
+                CallChunk<Ts...>(m_archetypes[m_chunkScratch[k].archetype], m_chunkScratch[k].chunk, func);
+        });
+    }
+
+private:
+    static const uint32_t INDEX_BITS = 20;
+    static const uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+    static const uint32_t GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+    static const uint32_t NO_ARCHETYPE = 0xFFFFFFFFu;
+    static const uint32_t NO_SLOT = 0xFFFFFFFFu;
+
+    struct Column
+    {
+        uint32_t type;
+        uint32_t size;
+        size_t offset; // 列在块内的起始偏移
+    };
+
+    struct Archetype
+    {
+        ComponentMask mask;
+        std::vector<Column> columns;                 // 按类型编号升序
+        int8_t columnOf[MAX_COMPONENT_TYPES];        // 类型编号 -> 列，-1 表示没有
+        uint32_t capacity;                           // 每块行数
+        size_t chunkBytes;
+        std::vector<uint8_t *> chunks;               // 行数为 count，除最后一块外都是满的；多余的空块留作复用
+        size_t count;
+
+        bool Matches(ComponentMask include, ComponentMask exclude) const
+        {
+            return count != 0 && (mask & include) == include && (mask & exclude) == 0;
+        }
+        size_t GetUsedChunkCount() const { return (count + capacity - 1) / capacity; }
+        size_t GetChunkRows(size_t chunk) const
+        {
+            size_t begin = chunk * capacity;
+            return count - begin < capacity ? count - begin : capacity;
+        }
+    };
+
+    struct Record
+    {
+        uint32_t archetype; // NO_ARCHETYPE 表示空闲
+        uint32_t row;
+        uint32_t generation;
+        uint32_t nextFree;
+    };
+
+    struct ChunkRef
+    {
+        uint32_t archetype;
+        uint32_t chunk;
+    };
+
+    template <typename... Ts, typename Func>
+    void CallChunk(Archetype &arch, size_t chunk, Func &func)
+    {
+        uint8_t *data = arch.chunks[chunk];
+        func(arch.GetChunkRows(chunk), reinterpret_cast<const Entity *>(data),
+             reinterpret_cast<Ts *>(data + arch.columns[arch.columnOf[GetTypeId<Ts>()]].offset)...);
+    }
+
+    static uint32_t RegisterType(size_t size);
+    static size_t GetTypeSize(uint32_t type);
+
+    uint32_t FindOrCreateArchetype(ComponentMask mask);
+    Entity CreateInArchetype(uint32_t archetype);
+    uint32_t AllocateRow(Archetype &arch, Entity entity);
+    void RemoveRow(Archetype &arch, uint32_t row);
+    void MoveToArchetype(Entity entity, uint32_t archetype);
+    void *GetComponent(Entity entity, uint32_t type);
+    void *AddComponent(Entity entity, uint32_t type);
+    void RemoveComponent(Entity entity, uint32_t type);
+
+    static Entity *EntityAddress(Archetype &arch, uint32_t row)
+    {
+        return reinterpret_cast<Entity *>(arch.chunks[row / arch.capacity]) + row % arch.capacity;
+    }
+    static uint8_t *ColumnAddress(Archetype &arch, uint32_t row, const Column &column)
+    {
+        return arch.chunks[row / arch.capacity] + column.offset + (size_t)(row % arch.capacity) * column.size;
+    }
+
+    std::vector<Archetype> m_archetypes;
+    std::unordered_map<ComponentMask, uint32_t> m_archetypeOf;
+    std::vector<Record> m_records;
+    uint32_t m_freeHead = NO_SLOT;
+    size_t m_entityCount = 0;
+    std::vector<ChunkRef> m_chunkScratch;
+};
+
+#endif // __COMPONENT_STORE_H__
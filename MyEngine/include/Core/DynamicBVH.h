@@ -0,0 +1,273 @@
+// ======================================================================
+#ifndef __DYNAMIC_BVH_H__
+#define __DYNAMIC_BVH_H__
+// ======================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Math/AABB.h"
+#include "Math/Frustum.h"
+// ======================================================================
+
+// 动态包围体层次（二叉 AABB 树）
+// - 叶子存放放大过的包围盒（四周加 margin，移动时再沿位移方向外扩），
+//   物体在放大盒内移动时 MoveProxy 不改动树，只有移出后才摘下重新插入
+// - 插入按表面积代价（SAH）选择兄弟节点，沿途用 AVL 式旋转保持平衡
+// - 批量插入（BeginBulk/EndBulk）与 Rebuild 使用分箱 SAH 自顶向下整树重建，树的质量高于逐个插入
+// - 代理号即叶子的节点下标，在代理生命周期内稳定（重建只替换内部节点）
+// - 查询返回放大盒与查询体相交的代理，调用方需要时再做精确测试
+// 非线程安全；查询为 const，可在没有修改的前提下多线程并发执行
+class CDynamicBVH
+{
+public:
+    typedef uint32_t ProxyId;
+    static const ProxyId INVALID_PROXY = 0xFFFFFFFFu;
+
+    explicit CDynamicBVH(float margin = 0.1f) : m_margin(margin) {}
+    CDynamicBVH(const CDynamicBVH &) = delete;
+    CDynamicBVH &operator=(const CDynamicBVH &) = delete;
+
+    // ======================================================================
+    // 代理
+    // ======================================================================
+    ProxyId CreateProxy(const AABB &box, uint32_t userData);
+    void DestroyProxy(ProxyId proxy);
+    // box 为新的紧包围盒，displacement 为本次位移（用于预测性外扩）
+    // 返回 true 表示叶子被重新插入；仍在放大盒内时不做任何修改
+    bool MoveProxy(ProxyId proxy, const AABB &box, const Vector3 &displacement);
+
+    uint32_t GetUserData(ProxyId proxy) const { return m_nodes[proxy].userData; }
+    const AABB &GetFatAABB(ProxyId proxy) const { return m_nodes[proxy].box; }
+
+    // ======================================================================
+    // 批量构建
+    // ======================================================================
+    // BeginBulk 之后创建的代理暂不入树（不可查询），EndBulk 时统一入树：
+    // 数量与树中已有叶子相当时整树重建，否则逐个插入
+    void BeginBulk() { m_bBulk = true; }
+    void EndBulk();
+    // 整树重建（分箱 SAH），大量移动后树质量下降时也可调用
+    void Rebuild();
+
+    // ======================================================================
+    // 查询：回调返回 false 时提前结束
+    // ======================================================================
+    // fn(ProxyId) -> bool
+    template <typename Fn>
+    void QueryAABB(const AABB &box, Fn &&fn) const;
+    // fn(ProxyId) -> bool
+    template <typename Fn>
+    void QuerySphere(const Vector3 &center, float radius, Fn &&fn) const;
+    // 按节点距离从近到远访问不保证，回调用返回值裁剪射线：
+    // fn(ProxyId, float enterDistance) -> float：小于 0 忽略该代理，0 结束，正数作为新的最大距离
+    template <typename Fn>
+    void RayCast(const Vector3 &origin, const Vector3 &direction, float maxDistance, Fn &&fn) const;
+    // fn(ProxyId, bool fullyInside) -> bool；整棵子树都在视锥内时不再逐个测试
+    template <typename Fn>
+    void QueryFrustum(const Frustum &frustum, Fn &&fn) const;
+
+    // ======================================================================
+    // 统计与校验
+    // ======================================================================
+    size_t GetProxyCount() const { return m_proxyCount; }
+    int GetHeight() const { return m_root == NULL_NODE ? 0 : m_nodes[m_root].height; }
+    // 内部节点表面积之和 / 根节点表面积，越小说明树越紧凑（SAH 代价的相对值）
+    float GetAreaRatio() const;
+    // 检查父子关系、高度与包围盒，供测试使用
+    bool Validate() const;
+    void Clear();
+
+private:
+    static const uint32_t NULL_NODE = 0xFFFFFFFFu;
+
+    struct Node
+    {
+        AABB box;
+        uint32_t parent; // 空闲节点存放下一个空闲节点
+        uint32_t child1;
+        uint32_t child2;
+        int32_t height; // 叶子为 0，空闲为 -1
+        uint32_t userData;
+        bool pending; // 批量模式下创建、尚未入树
+
+        bool IsLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    // 遍历栈：不超过 64 层时不分配内存
+    template <typename T>
+    class Stack
+    {
+    public:
+        Stack() : m_pData(m_local), m_size(0), m_capacity(64) {}
+        Stack(const Stack &) = delete;
+        Stack &operator=(const Stack &) = delete;
+
+        void Push(const T &value)
+        {
+            if (m_size == m_capacity)
+                Grow();
+            m_pData[m_size++] = value;
+        }
+        T Pop() { return m_pData[--m_size]; }
+        bool IsEmpty() const { return m_size == 0; }
+
+    private:
+        void Grow()
+        {
+            if (m_pData == m_local)
+                m_heap.assign(m_local, m_local + m_size);
+            m_capacity *= 2;
+            m_heap.resize(m_capacity);
+            m_pData = m_heap.data();
+        }
+
+        T m_local[64];
+        std::vector<T> m_heap;
+        T *m_pData;
+        size_t m_size;
+        size_t m_capacity;
+    };
+
+    uint32_t AllocateNode();
+    void FreeNode(uint32_t node);
+    AABB Fatten(const AABB &box, const Vector3 &displacement) const;
+    void InsertLeaf(uint32_t leaf);
+    void RemoveLeaf(uint32_t leaf);
+    uint32_t Balance(uint32_t node);
+    void RefitUpwards(uint32_t node);
+    uint32_t BuildTopDown(std::vector<uint32_t> &leaves);
+    int ValidateNode(uint32_t node, uint32_t parent, size_t &leafCount) const;
+
+    static bool RayHitsBox(const AABB &box, const Vector3 &origin, const Vector3 &invDirection, float maxDistance, float &enter);
+    static bool SphereHitsBox(const AABB &box, const Vector3 &center, float radiusSq);
+
+    std::vector<Node> m_nodes;
+    uint32_t m_root = NULL_NODE;
+    uint32_t m_freeList = NULL_NODE;
+    size_t m_proxyCount = 0;
+    float m_margin;
+
+    bool m_bBulk = false;
+    std::vector<uint32_t> m_pending;     // 批量模式下创建的叶子
+    std::vector<uint32_t> m_buildOrder;  // 重建时按分配顺序记录的内部节点
+};
+
+// ======================================================================
+// 查询实现
+// ======================================================================
+template <typename Fn>
+void CDynamicBVH::QueryAABB(const AABB &box, Fn &&fn) const
+{
+    if (m_root == NULL_NODE)
+        return;
+
+    Stack<uint32_t> stack;
+    stack.Push(m_root);
+    while (!stack.IsEmpty())
+    {
+        const Node &node = m_nodes[stack.Pop()];
+        if (!node.box.Intersects(box))
+            continue;
+        if (node.IsLeaf())
+        {
+            if (!fn((ProxyId)(&node - m_nodes.data())))
+                return;
+        }
+        else
+        {
+            stack.Push(node.child1);
+            stack.Push(node.child2);
+        }
+    }
+}
+
+template <typename Fn>
+void CDynamicBVH::QuerySphere(const Vector3 &center, float radius, Fn &&fn) const
+{
+    if (m_root == NULL_NODE)
+        return;
+
+    const float radiusSq = radius * radius;
+    Stack<uint32_t> stack;
+    stack.Push(m_root);
+    while (!stack.IsEmpty())
+    {
+        const Node &node = m_nodes[stack.Pop()];
+        if (!SphereHitsBox(node.box, center, radiusSq))
+            continue;
+        if (node.IsLeaf())
+        {
+            if (!fn((ProxyId)(&node - m_nodes.data())))
+                return;
+        }
+        else
+        {
+            stack.Push(node.child1);
+            stack.Push(node.child2);
+        }
+    }
+}
+
+template <typename Fn>
+void CDynamicBVH::RayCast(const Vector3 &origin, const Vector3 &direction, float maxDistance, Fn &&fn) const
+{
+    if (m_root == NULL_NODE)
+        return;
+
+    // 分量为 0 时倒数为无穷大，平板测试仍然成立
+    Vector3 invDirection(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+    Stack<uint32_t> stack;
+    stack.Push(m_root);
+    while (!stack.IsEmpty())
+    {
+        const Node &node = m_nodes[stack.Pop()];
+        float enter;
+        if (!RayHitsBox(node.box, origin, invDirection, maxDistance, enter))
+            continue;
+        if (node.IsLeaf())
+        {
+            float result = fn((ProxyId)(&node - m_nodes.data()), enter);
+            if (result == 0.0f)
+                return;
+            if (result > 0.0f)
+                maxDistance = result;
+        }
+        else
+        {
+            stack.Push(node.child1);
+            stack.Push(node.child2);
+        }
+    }
+}
+
+template <typename Fn>
+void CDynamicBVH::QueryFrustum(const Frustum &frustum, Fn &&fn) const
+{
+    if (m_root == NULL_NODE)
+        return;
+
+    // 节点与尚需测试的平面掩码一起入栈；掩码为 0 表示整棵子树都在视锥内
+    Stack<uint64_t> stack;
+    stack.Push(((uint64_t)Frustum::ALL_PLANES << 32) | m_root);
+    while (!stack.IsEmpty())
+    {
+        uint64_t item = stack.Pop();
+        const Node &node = m_nodes[(uint32_t)item];
+        uint32_t mask = (uint32_t)(item >> 32);
+        if (mask != 0 && frustum.Classify(node.box, mask) == Frustum::Outside)
+            continue;
+        if (node.IsLeaf())
+        {
+            if (!fn((ProxyId)(&node - m_nodes.data()), mask == 0))
+                return;
+        }
+        else
+        {
+            stack.Push(((uint64_t)mask << 32) | node.child1);
+            stack.Push(((uint64_t)mask << 32) | node.child2);
+        }
+    }
+}
+
+#endif // __DYNAMIC_BVH_H__
@@ -8,19 +8,45 @@
 #include <memory>
 #include <vector>
 #include <algorithm>
-#include <unordered_map>
 #include "EngineConfig.h"
 #include "GL/gl.h"
 #include "Math/Vector3.h"
 #include "Math/Matrix4.h"
 #include "Math/Quaternion.h"
+#include "Core/TransformStore.h"
+#include "Core/EntityPool.h"
+#include "Core/NameIndex.h"
+#include "Core/SpatialIndex.h"
+#include "Core/TickScheduler.h"
 // ======================================================================
 class CModel;
+class CStaticBatch;
+class COcclusionBuffer;
+class CSceneSnapshotWriter;
+struct SnapshotEntity;
 // ======================================================================
+// 实体类型，写入场景快照用于重建对象；只能在末尾追加
+enum class EntityType : uint32_t
+{
+    Entity,
+    Model,
+    Terrain,
+    Grid,
+    Skybox,
+    Camera
+};
+
+// 实体对象从按类型区分的 CBlockPool 中分配（控制块与对象同块），
+// ID 由全局 CHandleTable 统一分配：带代数、槽位复用，销毁后旧 ID 不会命中新实体
 class CEntity : public std::enable_shared_from_this<CEntity>
 {
+    template <typename>
+    friend class CPoolAllocator;
+
 public:
-    virtual ~CEntity() = default;
+    typedef CHandleTable<CEntity> Registry;
+
+    virtual ~CEntity();
 
     CEntity(const CEntity &) = delete;
     CEntity &operator=(const CEntity &) = delete;
@@ -30,33 +56,98 @@ public:
     BOOL RemoveChild(unsigned int uID);
     const std::vector<std::shared_ptr<CEntity>> &GetChildren() const { return m_children; }
     std::shared_ptr<CEntity> GetChild(size_t index) const;
-    // 递归查找子实体
+    // 查找子树中的同名实体：在场景中时走名称索引，否则递归比较名称编号
     std::shared_ptr<CEntity> FindChildByName(const std::wstring &name);
 
     template <typename... Args>
     static std::shared_ptr<CEntity> Create(Args &&...args)
     {
-        auto entity = std::shared_ptr<CEntity>(new CEntity(std::forward<Args>(args)...));
-        entity->m_uID = ++s_nextID;
-        return entity;
+        return Allocate<CEntity>(std::forward<Args>(args)...);
     }
 
+    // 按 ID 查找存活的实体，ID 已失效（实体已销毁）时返回空
+    static CEntity *Find(unsigned int uID) { return GetRegistry().Get(uID); }
+    static size_t GetAliveCount() { return GetRegistry().GetCount(); }
+
     // 更新与渲染
-    virtual void Update(float deltaTime);
-    virtual void Render()
-    {
-        for (auto &pChild : m_children)
-        {
-            if (pChild)
-                pChild->Render();
-        }
-    };
+    // Update 只处理实体自身的逻辑，由所在场景的 CTickScheduler 按更新组与频率调用，不再递归子节点
+    virtual void Update(float deltaTime) {}
+    virtual void Render() { RenderChildren(); }
 
     unsigned int GetID() const { return m_uID; }
 
-    // 实体名称
-    void SetName(const std::wstring &name) { m_name = name; }
-    const std::wstring &GetName() const { return m_name; }
+    // ======================================================================
+    // 场景快照
+    // ======================================================================
+    virtual EntityType GetType() const { return EntityType::Entity; }
+    // 写入名称、标签、变换与调度状态；子类追加资源引用与私有数据
+    virtual void WriteSnapshot(CSceneSnapshotWriter &writer, uint32_t index) const;
+    // 读取 WriteSnapshot 写入的内容（不含层级，层级由 CScene 按记录顺序重建）
+    virtual void ReadSnapshot(const SnapshotEntity &record);
+    static std::shared_ptr<CEntity> CreateFromSnapshot(const SnapshotEntity &record);
+
+    // 实体名称（驻留为 NameId，实体内只存编号）；初始为 "New Entity"，与其他名称一样进入索引
+    void SetName(const std::wstring &name);
+    const std::wstring &GetName() const { return CNameIndex::GetString(m_nameId); }
+    CNameIndex::NameId GetNameId() const { return m_nameId; }
+
+    // 标签
+    void AddTag(const std::wstring &tag);
+    void RemoveTag(const std::wstring &tag);
+    BOOL HasTag(const std::wstring &tag) const;
+    const std::vector<CNameIndex::NameId> &GetTags() const { return m_tags; }
+
+    // 该实体及其整个子树登记到 pIndex（场景对根节点调用，子节点挂接/摘除时自动跟随父节点）
+    void SetNameIndex(CNameIndex *pIndex);
+    CNameIndex *GetNameIndex() const { return m_pNameIndex; }
+
+    // ======================================================================
+    // 空间索引
+    // ======================================================================
+    // 局部空间包围盒；没有几何的实体返回 FALSE，不进入空间索引
+    virtual BOOL GetLocalBounds(AABB &bounds) const { return FALSE; }
+    // 该实体及其整个子树登记到 pIndex（与 SetNameIndex 相同，随父节点挂接/摘除自动跟随）
+    void SetSpatialIndex(CSpatialIndex *pIndex);
+    CSpatialIndex *GetSpatialIndex() const { return m_pSpatialIndex; }
+    // 空间索引维护的世界包围盒；没有包围盒或不在场景中时返回 FALSE
+    BOOL GetWorldBounds(AABB &bounds) const;
+
+    // ======================================================================
+    // 视锥剔除：场景每帧用相机视锥标记可见的实体（CScene::CullEntities），渲染时跳过其余有包围盒的实体
+    // ======================================================================
+    // 自身在视锥内；没有包围盒、不在场景中或场景尚未做过剔除时总是 TRUE
+    BOOL IsInView() const
+    {
+        return m_hSpatial == CSpatialIndex::INVALID_HANDLE || m_uViewFrame == m_pSpatialIndex->GetViewFrame();
+    }
+    // 自身或任一后代在视锥内；为 FALSE 时整棵子树都不渲染
+    // 挂在有包围盒的实体下、自身没有包围盒的后代随之一起剔除
+    BOOL IsSubtreeInView() const
+    {
+        return m_hSpatial == CSpatialIndex::INVALID_HANDLE || m_uSubtreeViewFrame == m_pSpatialIndex->GetViewFrame();
+    }
+    // 由剔除过程调用：标记自身可见，并沿父链标记祖先的子树可见
+    void MarkInView(uint32_t frame);
+
+    // ======================================================================
+    // 静态合批：放置后不再移动的实体，由场景把几何预先并入共享缓冲（CScene::BuildStaticBatch）
+    // ======================================================================
+    // 合批之后静态实体不能再移动或修改几何，否则须重新 BuildStaticBatch
+    void SetStatic(BOOL isStatic) { m_bStatic = isStatic; }
+    BOOL IsStatic() const { return m_bStatic; }
+    // 几何已在合批中，渲染时不再单独绘制
+    BOOL IsStaticBatched() const { return m_bStaticBatched; }
+    // 该实体及其整个子树中的静态实体并入 pBatch；为空时全部退出合批，恢复单独绘制
+    void CollectStaticBatch(CStaticBatch *pBatch);
+
+    // ======================================================================
+    // 遮挡剔除：遮挡体在视锥内时先画进场景的遮挡缓冲，再剔除被它完全挡住的实体（CScene::CullEntities）
+    // ======================================================================
+    // 只适合大而实的几何（地形、建筑）；遮挡体自身同样接受测试
+    void SetOccluder(BOOL isOccluder) { m_bOccluder = isOccluder; }
+    BOOL IsOccluder() const { return m_bOccluder; }
+    // 是遮挡体时把自身几何加入 buffer，返回是否加入；几何须保持不变到 buffer.Rasterize 返回
+    BOOL AddOccluder(COcclusionBuffer &buffer) const { return m_bOccluder && AddOccluderGeometry(buffer); }
 
     // 变换操作
     void SetPosition(const Vector3 &pos);
@@ -69,30 +160,100 @@ public:
 
     Vector3 GetWorldPosition() const;
     Matrix4 GetWorldMatrix() const;
+    // 在全局 CTransformStore 中的节点，世界矩阵由它统一计算
+    CTransformStore::Handle GetTransformHandle() const { return m_hTransform; }
+
+    // ======================================================================
+    // 逐帧更新调度
+    // ======================================================================
+    // 默认按需（TICK_ON_DEMAND）：没有逐帧逻辑的实体不进入执行列表；有逐帧逻辑的子类在构造时设置频率
+    void SetTickGroup(TickGroup group);
+    TickGroup GetTickGroup() const { return m_tickGroup; }
+    // 1 每帧，N 每 N 帧（Update 收到累计时间），CTickScheduler::TICK_ON_DEMAND 按需
+    void SetTickInterval(unsigned int frames);
+    unsigned int GetTickInterval() const { return m_tickInterval; }
+    // 下一帧执行一次 Update（休眠时忽略）
+    void RequestTick();
 
-    // 可见性控制
-    void SetVisible(BOOL visible) { m_bVisible = visible; }
+    // 休眠：自身与整棵子树都不再更新，直到 WakeUp
+    void Sleep() { SetSleeping(TRUE); }
+    void WakeUp() { SetSleeping(FALSE); }
+    BOOL IsSleeping() const { return m_bSleeping; }
+    // 自身与所有祖先都未休眠且可见时才会被调度
+    BOOL IsTickEnabled() const { return !m_bParentPaused && !IsSelfPaused(); }
+
+    // 该实体及其整个子树登记到 pScheduler（场景对根节点调用，子节点挂接/摘除时自动跟随父节点）
+    void SetTickScheduler(CTickScheduler *pScheduler) { SetTickContext(pScheduler, FALSE); }
+    CTickScheduler *GetTickScheduler() const { return m_pTickScheduler; }
+
+    // 可见性控制（隐藏的实体与子树同样不更新）
+    void SetVisible(BOOL visible);
     BOOL IsVisible() const { return m_bVisible; }
+    // 自身与所有祖先都可见（Render 遇到隐藏的节点不再进入子树，不经 Render 的绘制须用这个判断）
+    BOOL IsVisibleInHierarchy() const;
 
     // 自动贴地
     void SetSnapToTerrain(BOOL enable, float offset = 0.0f);
     BOOL IsAutoSnapEnabled() const { return m_bSnapToTerrain; }
     float GetGroundOffset() const { return m_fTerrainOffset; }
-    void SetLastSnapPos(const Vector3 &pos) { m_LastSnapPos = pos; }
-    Vector3 GetLastSnapPos() const { return m_LastSnapPos; }
 
 protected:
     unsigned int m_uID = 0;
     CEntity();
 
-    static unsigned int s_nextID;
-    std::wstring m_name;
+    // 子类的 Create 统一经由这里从对象池分配
+    template <typename T, typename... Args>
+    static std::shared_ptr<T> Allocate(Args &&...args)
+    {
+        return std::allocate_shared<T>(CPoolAllocator<T>(), std::forward<Args>(args)...);
+    }
+    static Registry &GetRegistry();
+
+    static CNameIndex::NameId GetDefaultNameId();
+    CNameIndex::NameId m_nameId = GetDefaultNameId(); // 空名称为 INVALID_NAME，不进入索引
+    std::vector<CNameIndex::NameId> m_tags;
+    CNameIndex *m_pNameIndex = nullptr; // 所在场景的索引，不在场景中时为空
     std::weak_ptr<CEntity> m_pParent;
     std::vector<std::shared_ptr<CEntity>> m_children;
-    std::unordered_map<unsigned int, std::shared_ptr<CEntity>> m_childrenMap;
 
     void InternalAddChild(std::shared_ptr<CEntity> pChild);
     void InternalRemoveChild(unsigned int uID);
+    std::shared_ptr<CEntity> FindChildByNameId(CNameIndex::NameId nameId);
+
+    // 空间索引：世界包围盒随变换由 CSpatialIndex::Update 维护，局部包围盒变化时子类调用 RefreshBounds
+    CSpatialIndex *m_pSpatialIndex = nullptr; // 所在场景的空间索引，不在场景中时为空
+    CSpatialIndex::Handle m_hSpatial = CSpatialIndex::INVALID_HANDLE; // 没有包围盒时为空
+    uint32_t m_uViewFrame = 0;        // 最近一次被标记在视锥内的剔除帧号
+    uint32_t m_uSubtreeViewFrame = 0; // 最近一次自身或后代被标记在视锥内的剔除帧号
+    void RefreshBounds();
+
+    // 递归渲染子节点，跳过整棵子树都不在视锥内的
+    void RenderChildren();
+
+    // 静态合批
+    BOOL m_bStatic = FALSE;
+    BOOL m_bStaticBatched = FALSE;
+    // 把自身几何加入 batch，返回是否加入；默认没有可合批的几何
+    virtual BOOL AddStaticGeometry(CStaticBatch &batch) const { return FALSE; }
+
+    // 遮挡剔除
+    BOOL m_bOccluder = FALSE;
+    // 把自身几何加入遮挡缓冲，返回是否加入；默认没有可用的几何
+    virtual BOOL AddOccluderGeometry(COcclusionBuffer &buffer) const { return FALSE; }
+
+    // 逐帧更新调度
+    CTickScheduler *m_pTickScheduler = nullptr; // 所在场景的调度器，不在场景中时为空
+    CTickScheduler::Handle m_hTick = CTickScheduler::INVALID_HANDLE;
+    TickGroup m_tickGroup = TickGroup::Update;
+    unsigned int m_tickInterval = CTickScheduler::TICK_ON_DEMAND;
+    BOOL m_bSleeping = FALSE;
+    BOOL m_bParentPaused = FALSE; // 有祖先休眠或隐藏
+
+    BOOL IsSelfPaused() const { return m_bSleeping || !m_bVisible; }
+    void SetSleeping(BOOL sleeping);
+    void SetTickContext(CTickScheduler *pScheduler, BOOL parentPaused);
+    void RefreshTickState();
+    static void TickThunk(void *pOwner, float deltaTime) { static_cast<CEntity *>(pOwner)->Update(deltaTime); }
 
     // 变换属性
     Vector3 m_position;
@@ -101,15 +262,12 @@ protected:
 
     BOOL m_bVisible;
 
-    BOOL m_bSnapToTerrain;                                         // 是否开启自动贴地
-    float m_fTerrainOffset;                                        // 高度偏移
-    Vector3 m_LastSnapPos = Vector3(99999.0f, 99999.0f, 99999.0f); // 初始给个极大值确保第一次必执行
+    BOOL m_bSnapToTerrain;  // 是否开启自动贴地
+    float m_fTerrainOffset; // 高度偏移
 
-    mutable Matrix4 m_cachedWorldMatrix;
-    mutable BOOL m_bWorldDirty;
+    CTransformStore::Handle m_hTransform; // 局部 TRS 的副本与世界矩阵存放在 CTransformStore 中
 
     void ApplyTransform() const;
-    void MarkDirty();
 };
 
 #endif // __ENTITY_H__
\ No newline at end of file
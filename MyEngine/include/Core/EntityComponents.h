@@ -0,0 +1,28 @@
+// ======================================================================
+#ifndef __ENTITY_COMPONENTS_H__
+#define __ENTITY_COMPONENTS_H__
+// ======================================================================
+
+#include "Core/TransformStore.h"
+// ======================================================================
+
+// CComponentStore 中常用的组件（均可平凡复制）
+
+// 桥接组件：组件仓库中的实体对应一个 CEntity
+// entityID 可用 CEntity::Find 取回对象（已销毁时为空），
+// transform 用于直接读写局部变换而不经过 CEntity 的虚函数
+struct EntityLink
+{
+    unsigned int entityID;
+    CTransformStore::Handle transform;
+};
+
+// 自动贴地：水平移动超过阈值后重新采样地形高度
+// 开关与高度偏移仍由 CEntity 持有（SetSnapToTerrain），贴地时读取，组件只记录上次位置
+struct TerrainSnap
+{
+    float lastX; // 上次贴地时的水平位置
+    float lastZ;
+};
+
+#endif // __ENTITY_COMPONENTS_H__
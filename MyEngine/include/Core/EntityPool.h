@@ -0,0 +1,212 @@
+// ======================================================================
+#ifndef __ENTITY_POOL_H__
+#define __ENTITY_POOL_H__
+// ======================================================================
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+// ======================================================================
+
+// 定长块内存池：按块大小一次申请一整段（chunk），空闲块串成单链表复用
+// - 同一类型的对象落在少数几段连续内存中，遍历时缓存友好
+// - 段只增不减，稳态下分配/释放不再触碰系统堆
+// 非线程安全：实体只在主线程创建与销毁
+class CBlockPool
+{
+public:
+    static const size_t DEFAULT_BLOCKS_PER_CHUNK = 256;
+
+    CBlockPool(size_t blockSize, size_t alignment, size_t blocksPerChunk = DEFAULT_BLOCKS_PER_CHUNK);
+    ~CBlockPool();
+
+    CBlockPool(const CBlockPool &) = delete;
+    CBlockPool &operator=(const CBlockPool &) = delete;
+
+    void *Allocate();
+    void Deallocate(void *p);
+    // 预留至少 count 个块，避免运行中扩容
+    void Reserve(size_t count);
+
+    size_t GetBlockSize() const { return m_blockSize; }
+    size_t GetUsedCount() const { return m_used; }
+    size_t GetCapacity() const { return m_capacity; }
+    size_t GetChunkCount() const { return m_chunks.size(); }
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    void AddChunk();
+
+    size_t m_blockSize;
+    size_t m_alignment;
+    size_t m_blocksPerChunk;
+    std::vector<void *> m_chunks; // 原始指针（未对齐），析构时释放
+    FreeBlock *m_freeList = nullptr;
+    size_t m_used = 0;
+    size_t m_capacity = 0;
+};
+
+// 标准库分配器适配：单个对象从按类型区分的 CBlockPool 中分配
+// 配合 std::allocate_shared 使用时控制块与对象在同一块内，
+// 每种实体类型（重绑定后的控制块类型）各自拥有一个池
+// 受保护构造函数的类需声明 template <typename> friend class CPoolAllocator;
+template <typename T>
+class CPoolAllocator
+{
+public:
+    typedef T value_type;
+
+    CPoolAllocator() noexcept {}
+    template <typename U>
+    CPoolAllocator(const CPoolAllocator<U> &) noexcept {}
+
+    T *allocate(size_t n)
+    {
+        if (n == 1)
+            return static_cast<T *>(GetPool().Allocate());
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T *p, size_t n)
+    {
+        if (n == 1)
+            GetPool().Deallocate(p);
+        else
+            std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U, typename... Args>
+    void construct(U *p, Args &&...args)
+    {
+        ::new ((void *)p) U(std::forward<Args>(args)...);
+    }
+
+    template <typename U>
+    void destroy(U *p)
+    {
+        p->~U();
+    }
+
+    // 池对象有意不析构：静态析构期仍可能有实体被释放
+    static CBlockPool &GetPool()
+    {
+        static CBlockPool *s_pPool = new CBlockPool(sizeof(T), alignof(T));
+        return *s_pPool;
+    }
+
+    template <typename U>
+    bool operator==(const CPoolAllocator<U> &) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const CPoolAllocator<U> &) const noexcept { return false; }
+};
+
+// 带代数的句柄表：ID = 代数 << INDEX_BITS | 槽位索引
+// - 释放后槽位代数加一，旧 ID 失效，不会误指向复用该槽位的新对象
+// - 空闲槽位串成链表（存放在槽位内），稳态下分配/释放不申请内存
+// - 代数从 1 开始，INVALID_ID(0) 永远不会被分配
+// - 槽位用尽（同时存活超过 INDEX_MASK + 1 个）时分配失败，返回 INVALID_ID
+template <typename T>
+class CHandleTable
+{
+public:
+    typedef uint32_t Id;
+    static const uint32_t INDEX_BITS = 20; // 最多约 100 万个同时存活的对象
+    static const uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+    static const uint32_t GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+    static const Id INVALID_ID = 0;
+
+    Id Allocate(T *object)
+    {
+        uint32_t index;
+        if (m_freeHead != NO_SLOT)
+        {
+            index = m_freeHead;
+            m_freeHead = m_slots[index].nextFree;
+        }
+        else
+        {
+            // 索引只有 INDEX_BITS 位，再多的槽位会与低位槽位的 ID 混淆
+            if (m_slots.size() > INDEX_MASK)
+            {
+                assert(!"CHandleTable: too many live handles");
+                return INVALID_ID;
+            }
+            index = (uint32_t)m_slots.size();
+            Slot slot = {nullptr, 1, NO_SLOT};
+            m_slots.push_back(slot);
+        }
+
+        Slot &slot = m_slots[index];
+        slot.object = object;
+        slot.nextFree = NO_SLOT;
+        ++m_count;
+        return (slot.generation << INDEX_BITS) | index;
+    }
+
+    void Release(Id id)
+    {
+        if (!IsValid(id))
+            return;
+
+        uint32_t index = id & INDEX_MASK;
+        Slot &slot = m_slots[index];
+        slot.object = nullptr;
+        slot.generation = (slot.generation + 1) & GENERATION_MASK;
+        if (slot.generation == 0)
+            slot.generation = 1;
+        slot.nextFree = m_freeHead;
+        m_freeHead = index;
+        --m_count;
+    }
+
+    T *Get(Id id) const
+    {
+        uint32_t index = id & INDEX_MASK;
+        if (index >= m_slots.size())
+            return nullptr;
+        const Slot &slot = m_slots[index];
+        return slot.object && slot.generation == (id >> INDEX_BITS) ? slot.object : nullptr;
+    }
+
+    bool IsValid(Id id) const { return Get(id) != nullptr; }
+    size_t GetCount() const { return m_count; }
+    size_t GetSlotCount() const { return m_slots.size(); }
+
+    static uint32_t GetIndex(Id id) { return id & INDEX_MASK; }
+    static uint32_t GetGeneration(Id id) { return id >> INDEX_BITS; }
+
+    // 按槽位顺序访问所有存活对象
+    template <typename Func>
+    void ForEach(Func func) const
+    {
+        for (size_t i = 0; i < m_slots.size(); ++i)
+        {
+            if (m_slots[i].object)
+                func(m_slots[i].object);
+        }
+    }
+
+private:
+    static const uint32_t NO_SLOT = 0xFFFFFFFFu;
+
+    struct Slot
+    {
+        T *object;
+        uint32_t generation;
+        uint32_t nextFree; // 空闲时指向下一个空闲槽位
+    };
+
+    std::vector<Slot> m_slots;
+    uint32_t m_freeHead = NO_SLOT;
+    size_t m_count = 0;
+};
+
+#endif // __ENTITY_POOL_H__
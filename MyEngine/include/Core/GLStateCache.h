@@ -0,0 +1,106 @@
+// ======================================================================
+#ifndef __GL_STATE_CACHE_H__
+#define __GL_STATE_CACHE_H__
+// ======================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <Windows.h>
+#include <GL/gl.h>
+// ======================================================================
+
+// OpenGL 状态影子缓存：记录最近一次设置的开关、纹理绑定、混合、材质与顶点数组状态，
+// 与记录相同的设置直接跳过，不进入驱动
+// - 影子只反映经由本类发出的调用。其他代码直接改动状态（包括 glPopAttrib 恢复）之后必须调用 Invalidate，
+//   之后每项状态的第一次设置一定发出
+// - 不查询 OpenGL（glGet* 会让驱动与 GPU 同步），未知状态就当作需要设置
+// - 开关只跟踪下表中的常用项，其余直接透传；纹理单元只跟踪前 MAX_TEXTURE_UNITS 个
+// 引擎只有一个 OpenGL 上下文，因此为单例；CRenderer 每帧开始时 Invalidate 并清零统计（CRenderer::GetStateCache）
+// 非线程安全，只能在渲染线程调用
+class CGLStateCache
+{
+public:
+    static const int MAX_TEXTURE_UNITS = 4;
+
+    // 发出与跳过的调用数，CRenderer::BeginFrame 清零
+    struct Stats
+    {
+        size_t issued;
+        size_t skipped;
+    };
+
+    static CGLStateCache &GetInstance();
+
+    CGLStateCache(const CGLStateCache &) = delete;
+    CGLStateCache &operator=(const CGLStateCache &) = delete;
+
+    void Invalidate(); // 所有状态置为未知
+    void ResetStats() { m_stats.issued = m_stats.skipped = 0; }
+    const Stats &GetStats() const { return m_stats; }
+
+    // ======================================================================
+    // 开关（glEnable/glDisable）；GL_TEXTURE_2D 按当前纹理单元记录
+    // ======================================================================
+    void SetEnabled(GLenum cap, bool enable);
+    void Enable(GLenum cap) { SetEnabled(cap, true); }
+    void Disable(GLenum cap) { SetEnabled(cap, false); }
+
+    // 顶点数组（glEnableClientState/glDisableClientState）
+    void SetClientState(GLenum array, bool enable);
+
+    // ======================================================================
+    // 纹理
+    // ======================================================================
+    void ActiveTexture(GLenum unit);  // GL_TEXTURE0 + i
+    void BindTexture(GLuint texture); // 绑定到当前纹理单元的 GL_TEXTURE_2D
+    void SetTexEnvMode(GLint mode);   // 当前纹理单元的 GL_TEXTURE_ENV_MODE
+
+    // ======================================================================
+    // 混合、颜色、材质、多边形模式
+    // ======================================================================
+    void SetBlendFunc(GLenum src, GLenum dst);
+    void SetColor(float r, float g, float b, float a);
+    // 正面材质（GL_FRONT），各颜色为 RGBA
+    void SetMaterial(const float ambient[4], const float diffuse[4], const float specular[4], float shininess);
+    void SetPolygonMode(GLenum mode); // GL_FRONT_AND_BACK
+
+private:
+    CGLStateCache();
+
+    enum : int8_t
+    {
+        STATE_UNKNOWN = -1,
+        STATE_OFF = 0,
+        STATE_ON = 1,
+    };
+
+    // 跟踪的开关在 m_caps 中的下标，不跟踪时返回 -1
+    static int CapIndex(GLenum cap);
+    static int ClientArrayIndex(GLenum array);
+
+    void Skip(size_t calls = 1) { m_stats.skipped += calls; }
+    void Issue(size_t calls = 1) { m_stats.issued += calls; }
+
+    static const int CAP_COUNT = 10;
+    static const int CLIENT_ARRAY_COUNT = 4;
+
+    int8_t m_caps[CAP_COUNT];
+    int8_t m_clientArrays[CLIENT_ARRAY_COUNT];
+
+    int m_activeUnit;                          // -1 表示未知
+    int8_t m_texture2D[MAX_TEXTURE_UNITS];     // 各单元的 GL_TEXTURE_2D 开关
+    int64_t m_boundTexture[MAX_TEXTURE_UNITS]; // -1 表示未知
+    GLint m_texEnvMode[MAX_TEXTURE_UNITS];     // 0 表示未知
+
+    bool m_blendValid;
+    GLenum m_blendSrc, m_blendDst;
+    bool m_colorValid;
+    float m_color[4];
+    bool m_materialValid;
+    float m_material[13]; // ambient, diffuse, specular, shininess
+    GLenum m_polygonMode; // 0 表示未知
+
+    Stats m_stats;
+};
+
+#endif // __GL_STATE_CACHE_H__
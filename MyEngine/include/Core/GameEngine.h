@@ -5,6 +5,7 @@
 // ======================================================================
 #include <windows.h>
 #include <memory> // 引入智能指针, 用于自动管理动态分配的对象内存.
+#include <vector>
 #include "EngineConfig.h"
 // ======================================================================
 
@@ -17,6 +18,7 @@ class CCamera;
 class CResourceManager;
 class CSceneManager;
 class CUIManager;
+class CJobSystem;
 
 // ======================================================================
 class CGameEngine
@@ -55,6 +57,7 @@ public:
     CCamera *GetMainCamera() const { return m_pMainCamera.get(); }
     CResourceManager *GetResourceManager() const { return m_ResourceManager.get(); }
     CUIManager *GetUIManager() const { return m_UIManager.get(); }
+    CJobSystem *GetJobSystem() const { return m_JobSystem.get(); }
 
     // ======================================================================
     // 测试
@@ -83,6 +86,7 @@ private:
     // 引擎子系统
     // ======================================================================
     // 基础系统
+    std::unique_ptr<CJobSystem> m_JobSystem; // 工作窃取任务系统，最先创建、Shutdown 最后停止
     std::unique_ptr<CWindow> m_Window;
     std::unique_ptr<CRenderer> m_Renderer;
 
@@ -111,6 +115,10 @@ private:
     // TODO: 显示调试信息
     BOOL m_ShowDebugInfo;
     void DisplayDebugInfo();
+    // 遮挡缓冲的深度图（线性化后近暗远亮），显示在右下角
+    BOOL m_ShowOcclusionDepth = FALSE;
+    std::vector<float> m_OcclusionPixels;
+    void DisplayOcclusionDepth();
     void DisplayStatistics();
 
     void RenderSplashScreen(FLOAT deltaTime, BOOL isFadeOut); // 出入场动画
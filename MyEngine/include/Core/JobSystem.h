@@ -0,0 +1,102 @@
+// ======================================================================
+#ifndef __JOB_SYSTEM_H__
+#define __JOB_SYSTEM_H__
+// ======================================================================
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+// ======================================================================
+
+class CJobCounter;
+
+// 工作窃取任务系统
+// - 每个线程一个双端队列：自己从尾部取（后进先出，缓存友好），空闲线程从别人头部窃取
+// - 槽位 0 属于创建任务系统的线程（主线程）及其它外部线程，槽位 1..N 为工作线程
+// - CJobCounter 统计未完成的任务，可作为其它任务的前置依赖
+// - Wait 在等待期间执行队列中的任务（边等边干），在任务内部嵌套等待也不会死锁
+class CJobSystem
+{
+public:
+    typedef std::function<void()> JobFunc;
+    typedef std::function<void(size_t begin, size_t end)> RangeFunc;
+
+    struct Job
+    {
+        JobFunc func;
+        CJobCounter *counter; // 完成时递减，可为空
+    };
+
+    // workerCount 为后台工作线程数，0 表示硬件线程数 - 1
+    explicit CJobSystem(unsigned workerCount = 0);
+    ~CJobSystem();
+
+    CJobSystem(const CJobSystem &) = delete;
+    CJobSystem &operator=(const CJobSystem &) = delete;
+
+    unsigned GetWorkerCount() const { return (unsigned)m_workers.size(); }
+    // 参与执行任务的线程数（工作线程 + 等待中的调用线程）
+    unsigned GetThreadCount() const { return (unsigned)m_workers.size() + 1; }
+
+    // 提交任务；counter 非空时提交即加一、完成时减一
+    void Schedule(JobFunc func, CJobCounter *counter = nullptr);
+    // dependency 归零后才提交 func（已归零则立即提交）
+    void ScheduleAfter(CJobCounter &dependency, JobFunc func, CJobCounter *counter = nullptr);
+
+    // 等待 counter 归零，期间执行可取得的任务；计数器须在 Wait 返回后才能销毁
+    void Wait(CJobCounter &counter);
+
+    // 把 [0, count) 按不小于 grain 的粒度拆分并行执行，返回时全部完成
+    void ParallelFor(size_t count, size_t grain, const RangeFunc &func);
+    // 同上；pJobs 为空时在调用线程上直接执行 func(0, count)
+    static void ParallelFor(CJobSystem *pJobs, size_t count, size_t grain, const RangeFunc &func);
+
+private:
+    struct alignas(64) WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    void WorkerLoop(unsigned index);
+    unsigned CurrentSlot() const;
+    void Push(unsigned slot, Job &&job);
+    bool TryTake(unsigned slot, Job &job);
+    void Execute(Job &job);
+    void Wake(size_t count);
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues; // [0] 主线程槽位，[1..N] 工作线程
+    std::vector<std::thread> m_workers;
+
+    std::atomic<int> m_queued;  // 已入队未取出的任务数，工作线程据此休眠
+    std::atomic<bool> m_bStop;
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wakeCondition;
+};
+
+// 任务计数器：Schedule 时加一，任务完成时减一，归零时提交挂在它上面的后续任务
+class CJobCounter
+{
+public:
+    CJobCounter() : m_count(0) {}
+    CJobCounter(const CJobCounter &) = delete;
+    CJobCounter &operator=(const CJobCounter &) = delete;
+
+    int GetValue() const { return m_count.load(std::memory_order_acquire); }
+    bool IsDone() const { return GetValue() == 0; }
+
+private:
+    friend class CJobSystem;
+
+    std::atomic<int> m_count;
+    std::mutex m_mutex;                          // 保护 m_continuations
+    std::vector<CJobSystem::Job> m_continuations; // 归零后提交
+};
+
+#endif // __JOB_SYSTEM_H__
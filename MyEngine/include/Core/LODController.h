@@ -0,0 +1,66 @@
+// ======================================================================
+#ifndef __LOD_CONTROLLER_H__
+#define __LOD_CONTROLLER_H__
+// ======================================================================
+
+#include <cstddef>
+#include "Math/Matrix4.h"
+#include "Math/Vector3.h"
+// ======================================================================
+
+// 细节级别统计（最近一帧）
+struct LODStats
+{
+    size_t models;         // 参与选择的模型
+    size_t reduced;        // 使用了 1 级及以上的模型
+    size_t fullTriangles;  // 全部按 0 级绘制时的三角形数
+    size_t drawnTriangles; // 实际选中级别的三角形数
+};
+
+// 细节级别选择：按相机把每级的几何误差投影成屏幕像素，选误差不超过阈值的最粗一级
+// - 像素 / 世界单位 = projection(1,1) · 视口高度 / (2 · 到包围球表面的距离)，相机在球内时按最近处理
+//   （透视投影中 projection(1,1) = 1 / tan(fovY/2)；直接取实际使用的投影矩阵，与画面一致）
+// - 滞后：变粗要求误差低于阈值 × (1 - hysteresis)，变细要到误差超过阈值才发生，
+//   物体在阈值附近的距离来回时级别不会逐帧跳动
+// 每帧渲染前由场景设置相机（SetView），实体遍历期间经 GetActive 找到它（与 CRenderQueue 相同）
+class CLODController
+{
+public:
+    CLODController() = default;
+    CLODController(const CLODController &) = delete;
+    CLODController &operator=(const CLODController &) = delete;
+
+    // projection 为相机渲染用的投影矩阵，viewportHeight 为视口高度（像素）
+    void SetView(const Vector3 &cameraPosition, const Matrix4 &projection, float viewportHeight);
+    void SetThreshold(float pixels) { m_threshold = pixels; } // 允许的屏幕误差，默认 1 像素
+    void SetHysteresis(float ratio) { m_hysteresis = ratio; } // 默认 0.25
+    float GetThreshold() const { return m_threshold; }
+
+    // 清空统计并设为当前控制器 / 取消当前控制器
+    void Begin();
+    void End();
+    static CLODController *GetActive() { return s_pActive; }
+
+    // 模型空间中 1 单位的误差在包围球（模型空间的 center、radius 经 world 变换）最近处投影到屏幕的像素数
+    float ErrorToPixels(const Matrix4 &world, const Vector3 &center, float radius) const;
+
+    // 选择级别：errors[0..levelCount) 为各级的模型空间误差（单调不减，0 级为 0），current 为上一帧的级别
+    size_t Select(const float *errors, size_t levelCount, const Matrix4 &world, const Vector3 &center, float radius,
+                  size_t current) const;
+
+    // 记录一个模型的选择结果
+    void Record(size_t level, size_t fullTriangles, size_t drawnTriangles);
+    // Begin/End 之间累计，End 之后为整帧结果
+    const LODStats &GetStats() const { return m_stats; }
+
+private:
+    Vector3 m_cameraPosition = Vector3::Zero();
+    float m_pixelScale = 600.0f / 0.8284271f; // projection(1,1) · 视口高度 / 2，默认 600 像素、45°
+    float m_threshold = 1.0f;
+    float m_hysteresis = 0.25f;
+    LODStats m_stats = {};
+
+    static CLODController *s_pActive;
+};
+
+#endif // __LOD_CONTROLLER_H__
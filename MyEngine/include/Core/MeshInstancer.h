@@ -0,0 +1,56 @@
+// ======================================================================
+#ifndef __MESH_INSTANCER_H__
+#define __MESH_INSTANCER_H__
+// ======================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <Windows.h>
+#include <GL/gl.h>
+#include "Math/Matrix4.h"
+// ======================================================================
+class CMesh;
+// ======================================================================
+
+// 网格实例化绘制：一批相同网格的世界矩阵放在每帧上传一次的顶点缓冲里，一次 glDrawElementsInstanced 画完
+// - 引擎其余部分是固定管线，这里用一个最小的着色器补上实例矩阵：
+//   顶点 = 当前模型视图投影矩阵 × 实例世界矩阵 × 顶点，颜色 = glColor × 纹理（与 GL_MODULATE 一致），不做光照
+//   （与 CModel::Draw 的绘制状态相同）；开启 GL_FOG 时按当前的雾模式与参数逐片元混合，与固定管线的结果一致
+// - 需要 OpenGL 3.3，或 GL_ARB_draw_instanced + GL_ARB_instanced_arrays；着色器编译失败同样视为不支持，
+//   调用方退回逐实例加载矩阵（CRenderer::SubmitQueue）
+// 由 CRenderer 持有，在 OpenGL 上下文创建之后 Initialize，销毁之前 Shutdown；只能在渲染线程调用
+class CMeshInstancer
+{
+public:
+    CMeshInstancer();
+    ~CMeshInstancer();
+
+    CMeshInstancer(const CMeshInstancer &) = delete;
+    CMeshInstancer &operator=(const CMeshInstancer &) = delete;
+
+    bool Initialize(); // 检测支持并创建着色器与实例缓冲，返回是否可用
+    void Shutdown();   // 释放 OpenGL 对象
+    bool IsSupported() const { return m_program != 0; }
+
+    // 上传本帧的全部实例矩阵（CRenderQueue::GetInstanceMatrices），每次提交一次
+    void Upload(const Matrix4 *matrices, size_t count);
+
+    // Begin/End 之间启用着色器与实例属性；Begin 时读取雾的开关与模式，期间纹理开关只能经 SetTextured 告知着色器
+    void Begin();
+    void SetTextured(bool textured);
+    // 绘制上传数据中 [first, first + count) 的实例，lod 为网格的细节级别；网格顶点数组须已启用
+    void Draw(const CMesh &mesh, uint32_t first, uint32_t count, size_t lod = 0);
+    void End();
+
+private:
+    static bool CheckSupport();
+    static GLuint CompileShader(GLenum type, const char *source);
+
+    GLuint m_program;
+    GLuint m_instanceBuffer;
+    GLint m_useTextureLocation;
+    GLint m_fogModeLocation;
+    int m_textured; // 上一次告知着色器的纹理开关，-1 表示未知
+};
+
+#endif // __MESH_INSTANCER_H__
@@ -0,0 +1,89 @@
+// ======================================================================
+#ifndef __MESH_SIMPLIFIER_H__
+#define __MESH_SIMPLIFIER_H__
+// ======================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Math/Vector3.h"
+// ======================================================================
+
+// 网格简化：二次误差度量（QEM）的边折叠，只输出新的索引，顶点数组不变（各级 LOD 共用同一份顶点）
+// - 顶点沿边折叠到邻居上（不生成新位置），代价为被折叠的表面到新位置的面积加权均方距离
+// - 每一轮每个顶点取代价最小的一条边，按代价排序后从小到大折叠一批（每个顶点一轮只参与一次），
+//   再压缩索引、去掉退化三角形
+// - 开放边界上的顶点只能沿边界折叠，并附加垂直于边界的平面，轮廓不会被侵蚀
+// - 位置相同但属性不同的顶点（UV、法线接缝）与非流形顶点不移动，可作为折叠目标
+// - 折叠会让相邻三角形法线翻转超过约 75° 的不做
+// 可以在同一个对象上逐级调用 Simplify 生成 LOD 链，误差沿链累积
+class CMeshSimplifier
+{
+public:
+    // positions 指向第一个顶点位置的 x，stride 为相邻顶点的字节间隔（可直接传 CMesh 的 Vertex 数组）
+    CMeshSimplifier(const float *positions, size_t vertexCount, size_t stride,
+                    const unsigned int *indices, size_t indexCount);
+    CMeshSimplifier(const CMeshSimplifier &) = delete;
+    CMeshSimplifier &operator=(const CMeshSimplifier &) = delete;
+
+    // 在当前结果上继续折叠，直到索引数不超过 targetIndexCount，或剩余的折叠误差都超过 maxError
+    // 返回是否减少了三角形
+    bool Simplify(size_t targetIndexCount, float maxError);
+
+    const std::vector<unsigned int> &GetIndices() const { return m_indices; }
+    // 至今做过的折叠中的最大误差：与输入位置同单位的距离
+    float GetError() const { return m_error; }
+
+private:
+    // 对称 4x4 矩阵的二次型，w 为累积的面积权重（误差除以它得到均方距离）
+    struct Quadric
+    {
+        float a00, a11, a22, a10, a20, a21;
+        float b0, b1, b2;
+        float c;
+        float w;
+    };
+
+    enum VertexKind : uint8_t
+    {
+        KIND_MANIFOLD, // 内部顶点，可向任意邻居折叠
+        KIND_BORDER,   // 开放边界上，只能沿边界折叠
+        KIND_LOCKED,   // 接缝、非流形或已折叠掉的顶点
+    };
+
+    struct Collapse
+    {
+        uint32_t source;
+        uint32_t target;
+        float cost;
+    };
+
+    static void AddPlane(Quadric &q, const Vector3 &normal, float distance, float weight);
+    static void AddQuadric(Quadric &q, const Quadric &other);
+    static float Evaluate(const Quadric &q, const Vector3 &p);
+
+    bool HasEdge(uint32_t from, uint32_t to) const; // 位置组之间的有向边
+    void ClassifyVertices();
+    void BuildAdjacency();
+    float CollapseCost(uint32_t source, uint32_t target) const;
+    bool CanCollapse(uint32_t source, uint32_t target) const;
+    bool FlipsTriangle(uint32_t source, uint32_t target, const std::vector<uint32_t> &collapseTo) const;
+
+    std::vector<Vector3> m_positions;     // 归一化到单位立方体内，误差换算回原单位时乘 m_scale
+    std::vector<uint32_t> m_wedge;        // 同一位置的顶点中编号最小的一个，二次型记在它身上
+    std::vector<uint8_t> m_seam;          // 同一位置还有其他顶点
+    std::vector<Quadric> m_quadrics;      // 按 m_wedge 索引
+    std::vector<uint8_t> m_kind;
+    std::vector<uint32_t> m_borderNext;   // 边界顶点沿开放边的下一个 / 上一个顶点
+    std::vector<uint32_t> m_borderPrev;
+    std::vector<uint32_t> m_adjacencyOffsets; // 顶点 -> 所在三角形（CSR）
+    std::vector<uint32_t> m_adjacency;
+    std::vector<uint32_t> m_wedgeOffsets;     // 位置组 -> 所在三角形（CSR）
+    std::vector<uint32_t> m_wedgeTriangles;
+    std::vector<unsigned int> m_indices;
+
+    float m_scale = 1.0f;
+    float m_error = 0.0f;
+};
+
+#endif // __MESH_SIMPLIFIER_H__
@@ -0,0 +1,82 @@
+// ======================================================================
+#ifndef __NAME_INDEX_H__
+#define __NAME_INDEX_H__
+// ======================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+// ======================================================================
+
+// 场景级的名称/标签索引：驻留后的名称编号 -> 实体 ID 列表
+// - 名称与标签字符串全局驻留为 NameId，同一字符串始终得到同一编号，查询只比较整数
+// - 每个名称/标签一个桶，桶内实体 ID 连续存放；增删通过位置表 O(1) 完成（交换删除，桶内无序）
+// - 实体 ID 即 CEntity::GetID()（带代数），由 CEntity 在改名、挂接、摘除、销毁时维护
+// 非线程安全（驻留表为全局共享）
+class CNameIndex
+{
+public:
+    typedef uint32_t NameId;
+    static const NameId INVALID_NAME = 0;
+
+    // ======================================================================
+    // 字符串驻留
+    // ======================================================================
+    // 返回字符串的编号，首次出现时分配；空字符串为 INVALID_NAME
+    static NameId Intern(const std::wstring &name);
+    // 只查找不分配，未驻留过时返回 INVALID_NAME（此时也不可能有实体使用它）
+    static NameId FindName(const std::wstring &name);
+    // 驻留的字符串不会释放，返回的引用始终有效
+    static const std::wstring &GetString(NameId id);
+
+    // ======================================================================
+    // 索引
+    // ======================================================================
+    // INVALID_NAME（空名称）不进入索引，可以直接传入
+    void AddName(unsigned int entityID, NameId name)
+    {
+        if (name != INVALID_NAME)
+            Insert(m_names, Key(name, false, entityID), name, entityID);
+    }
+    void RemoveName(unsigned int entityID, NameId name)
+    {
+        if (name != INVALID_NAME)
+            Erase(m_names, Key(name, false, entityID), name);
+    }
+    void AddTag(unsigned int entityID, NameId tag) { Insert(m_tags, Key(tag, true, entityID), tag, entityID); }
+    void RemoveTag(unsigned int entityID, NameId tag) { Erase(m_tags, Key(tag, true, entityID), tag); }
+
+    // 名称对应的任意一个实体，没有时返回 0
+    unsigned int FindFirst(NameId name) const
+    {
+        const std::vector<unsigned int> &bucket = FindAll(name);
+        return bucket.empty() ? 0 : bucket[0];
+    }
+    // 同名的全部实体（顺序不定）；引用在下次修改索引前有效
+    const std::vector<unsigned int> &FindAll(NameId name) const { return Lookup(m_names, name); }
+    // 带某标签的全部实体（顺序不定）
+    const std::vector<unsigned int> &FindTagged(NameId tag) const { return Lookup(m_tags, tag); }
+
+    size_t GetEntryCount() const { return m_position.size(); }
+    void Clear();
+
+private:
+    typedef std::unordered_map<NameId, std::vector<unsigned int>> BucketMap;
+
+    static uint64_t Key(NameId id, bool isTag, unsigned int entityID)
+    {
+        return ((uint64_t)id << 33) | ((uint64_t)(isTag ? 1 : 0) << 32) | entityID;
+    }
+
+    void Insert(BucketMap &buckets, uint64_t key, NameId id, unsigned int entityID);
+    void Erase(BucketMap &buckets, uint64_t key, NameId id);
+    static const std::vector<unsigned int> &Lookup(const BucketMap &buckets, NameId id);
+
+    BucketMap m_names;
+    BucketMap m_tags;
+    std::unordered_map<uint64_t, uint32_t> m_position; // (编号, 类别, 实体) -> 桶内下标
+};
+
+#endif // __NAME_INDEX_H__
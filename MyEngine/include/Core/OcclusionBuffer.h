@@ -0,0 +1,122 @@
+// ======================================================================
+#ifndef __OCCLUSION_BUFFER_H__
+#define __OCCLUSION_BUFFER_H__
+// ======================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Math/AABB.h"
+#include "Math/Matrix4.h"
+// ======================================================================
+class CJobSystem;
+// ======================================================================
+
+// 遮挡剔除统计（最近一次 Rasterize / TestAABBs）
+struct OcclusionStats
+{
+    size_t occluders;  // 加入的遮挡体
+    size_t triangles;  // 遮挡体的三角形
+    size_t rasterized; // 经背面、近平面、屏幕外剔除后实际光栅化的三角形
+    size_t tested;     // 测试的包围盒
+    size_t occluded;   // 被完全遮住的包围盒
+};
+
+// 软件遮挡缓冲：在 CPU 上把选定的遮挡体（地形、大模型）光栅化成低分辨率深度图，再用它测试包围盒
+// - 深度为 NDC z 映射到 [0, 1]（0 近 1 远），清为 1；第 0 行在底部，与 glReadPixels 相同
+// - 深度图按 TILE_WIDTH x TILE_HEIGHT 分块存放：三角形先按屏幕包围矩形分到块里，
+//   各块互不相交，由任务系统并行光栅化，不需要同步；每块另记最远深度供测试时整块跳过
+// - 块内逐行按 SIMD 宽度（AVX 8 / SSE 4 像素）求边函数与深度，像素中心在三角形内（含边上）即覆盖
+// - 包围盒测试是保守的：八个角投影的屏幕矩形内所有像素都比盒子最近的深度更近时才算被遮住，
+//   盒子跨过近平面时总是可见；遮挡体按像素中心采样，只从不足一个缓冲像素的缝隙露出的物体可能被剔除
+// 用法：Begin(视图投影) -> AddOccluder... -> Rasterize -> IsOccluded / TestAABBs（可多线程同时调用）
+class COcclusionBuffer
+{
+public:
+    static const int TILE_WIDTH = 32;
+    static const int TILE_HEIGHT = 8;
+
+    // 宽高向上取整到块大小的整数倍
+    explicit COcclusionBuffer(int width = 320, int height = 192);
+    COcclusionBuffer(const COcclusionBuffer &) = delete;
+    COcclusionBuffer &operator=(const COcclusionBuffer &) = delete;
+
+    void Resize(int width, int height);
+    int GetWidth() const { return m_width; }
+    int GetHeight() const { return m_height; }
+
+    // 背面剔除：逆时针为正面（与 OpenGL 默认相同），默认开启
+    void SetBackfaceCulling(bool enable) { m_backfaceCulling = enable; }
+
+    // 开始新的一帧：清空遮挡体列表，viewProjection 为投影 * 观察
+    void Begin(const Matrix4 &viewProjection);
+
+    // 加入一个遮挡体：positions 指向第一个顶点位置的 x，stride 为相邻顶点的字节间隔，顶点经 world 变换
+    // 只记录指针，数据须保持有效到 Rasterize 返回
+    void AddOccluder(const float *positions, size_t vertexCount, size_t stride,
+                     const unsigned int *indices, size_t indexCount, const Matrix4 &world);
+
+    // 光栅化全部遮挡体；pJobs 为空时在调用线程上完成
+    void Rasterize(CJobSystem *pJobs = nullptr);
+
+    // 世界包围盒是否被完全遮住（Rasterize 之后调用，只读，可多线程同时调用）
+    bool IsOccluded(const AABB &bounds) const;
+    // 批量测试：occluded[i] 为 1 表示 bounds[i] 被遮住，返回被遮住的数量
+    size_t TestAABBs(const AABB *bounds, size_t count, uint8_t *occluded, CJobSystem *pJobs = nullptr);
+
+    // 调试读回：按行（从底部开始）写出 width * height 个深度值
+    void ReadDepth(float *out) const;
+    void ReadDepth(std::vector<float> &out) const;
+
+    const OcclusionStats &GetStats() const { return m_stats; }
+
+private:
+    struct Occluder
+    {
+        const float *positions;
+        size_t vertexCount;
+        size_t stride;
+        const unsigned int *indices;
+        size_t triangleCount;
+        Matrix4 transform;    // viewProjection * world
+        size_t firstVertex;   // 在 m_clipVertices 中的起点
+        size_t firstTriangle; // 全部遮挡体三角形中的序号
+    };
+
+    // 屏幕空间三角形：像素坐标下的三条边函数 a·x + b·y + c（内侧非负）、深度平面与覆盖的像素中心范围
+    struct ScreenTriangle
+    {
+        float edgeA[3], edgeB[3], edgeC[3];
+        float depthA, depthB, depthC;
+        int minX, minY, maxX, maxY;
+    };
+
+    struct ClipVertex
+    {
+        float x, y, z, w;
+    };
+
+    void TransformVertices(size_t chunk);
+    void SetupTriangles(size_t chunk);
+    void EmitTriangle(const ClipVertex &a, const ClipVertex &b, const ClipVertex &c, std::vector<ScreenTriangle> &out) const;
+    void RasterizeTile(size_t tile);
+
+    int m_width = 0, m_height = 0;
+    int m_tilesX = 0, m_tilesY = 0;
+    bool m_backfaceCulling = true;
+    Matrix4 m_viewProjection;
+
+    std::vector<float> m_depth;   // 按块存放，每块 TILE_WIDTH * TILE_HEIGHT，块内按行
+    std::vector<float> m_tileMax; // 每块的最远深度
+
+    std::vector<Occluder> m_occluders;
+    std::vector<ClipVertex> m_clipVertices;
+    std::vector<std::vector<ScreenTriangle>> m_chunkTriangles; // 每个三角形分段的输出
+    std::vector<const ScreenTriangle *> m_triangles;            // 合并后的全部三角形
+    std::vector<uint32_t> m_binOffsets;                         // 块 -> 三角形（CSR）
+    std::vector<uint32_t> m_bins;
+
+    OcclusionStats m_stats = {};
+};
+
+#endif // __OCCLUSION_BUFFER_H__
@@ -0,0 +1,123 @@
+// ======================================================================
+#ifndef __RENDER_QUEUE_H__
+#define __RENDER_QUEUE_H__
+// ======================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Math/Matrix4.h"
+#include "Math/Vector3.h"
+// ======================================================================
+class CMesh;
+// ======================================================================
+
+// 渲染层：排序键的最高位，按数值从小到大绘制
+enum class RenderPass : uint8_t
+{
+    Background = 0, // 天空盒等远景
+    World = 1,      // 场景物体
+    Overlay = 2,    // 叠加在场景之上的物体
+};
+
+// 渲染队列：场景遍历时收集绘制项，遍历结束后按 64 位排序键基数排序，再由 CRenderer::SubmitQueue 提交
+// 排序键（高位在前）：
+//   [63..61] 渲染层
+//   [60]     半透明标记（不透明物体先画）
+//   不透明：[59..44] 材质 [43..28] 纹理 [27..12] 网格 [11..10] 细节级别 [9..0] 深度
+//           —— 同材质、同纹理、同网格同级别的物体相邻，组内由近到远
+//   半透明：[59..36] 深度取反 [35..20] 材质 [19..4] 纹理          —— 由远到近，保证混合顺序正确
+// 深度为包围盒中心在观察空间中到相机的距离，按远裁剪面量化（不透明 10 位，半透明 24 位）
+// 键相同的绘制项保持加入顺序（排序稳定）
+// 排序后相邻、网格、细节级别与状态都相同的绘制项合成一个批次，提交时每批只设置一次状态，支持时用实例化一次画完
+class CRenderQueue
+{
+public:
+    struct Item
+    {
+        const CMesh *pMesh;
+        Matrix4 world;
+        uint32_t material; // CMesh::GetMaterialID，键中只保留低 16 位，提交时用完整值判断是否切换
+        uint32_t texture;  // OpenGL 纹理名，0 表示无纹理
+        uint32_t lod;      // 网格的细节级别（CMesh::GetLODIndices）
+        bool translucent;
+    };
+
+    // 批次：排序后下标 [first, first + count) 的绘制项网格、细节级别、材质、纹理、混合都相同
+    struct Batch
+    {
+        uint32_t first;
+        uint32_t count;
+    };
+
+    // 参与排序的键与绘制项下标
+    struct SortEntry
+    {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    CRenderQueue() = default;
+    CRenderQueue(const CRenderQueue &) = delete;
+    CRenderQueue &operator=(const CRenderQueue &) = delete;
+
+    // 相机观察矩阵与远裁剪面，计算深度用；每帧渲染前设置
+    void SetView(const Matrix4 &view, float farDistance);
+    const Matrix4 &GetView() const { return m_view; }
+
+    // 清空上一帧的绘制项，并设为当前队列（实体通过 GetActive 找到它）
+    void Begin();
+    // 排序、合批并取消当前队列
+    void End();
+
+    // meshID 参与排序（只取低 16 位），同一网格的绘制项由此相邻；center 为世界空间包围盒中心
+    // lod 小于 CMesh::MAX_LOD_LEVELS
+    void Add(const CMesh *pMesh, uint32_t meshID, const Matrix4 &world, const Vector3 &center,
+             uint32_t material, uint32_t texture, bool translucent, RenderPass pass = RenderPass::World, uint32_t lod = 0);
+
+    size_t GetCount() const { return m_order.size(); }
+    bool IsEmpty() const { return m_order.empty(); }
+    // 按排序后的顺序访问（End 之后有效）
+    const Item &GetSorted(size_t i) const { return m_items[m_order[i].index]; }
+    uint64_t GetSortedKey(size_t i) const { return m_order[i].key; }
+
+    // 批次与按排序后顺序排列的世界矩阵（实例数据，批次的 first 即其中的下标）
+    size_t GetBatchCount() const { return m_batches.size(); }
+    const Batch &GetBatch(size_t i) const { return m_batches[i]; }
+    const Matrix4 *GetInstanceMatrices() const { return m_instances.data(); }
+
+    // 正在收集绘制项的队列，没有时实体直接绘制
+    static CRenderQueue *GetActive() { return s_pActive; }
+
+    // depth01 为 [0, 1] 的归一化深度，超出范围时截断
+    static uint64_t MakeKey(RenderPass pass, bool translucent, uint32_t material, uint32_t texture, uint32_t meshID, float depth01,
+                            uint32_t lod = 0);
+
+    // 按 key 稳定排序：LSD 基数排序，每趟 8 位，所有键在某一字节上相同时跳过该趟；32 项以内用插入排序
+    // scratch 至少 count 个元素；结果写回 entries
+    static void SortEntries(SortEntry *entries, SortEntry *scratch, size_t count);
+
+private:
+    std::vector<Item> m_items;
+    std::vector<SortEntry> m_order;
+    std::vector<SortEntry> m_scratch;
+    std::vector<Batch> m_batches;
+    std::vector<Matrix4> m_instances;
+
+    Matrix4 m_view = Matrix4::Identity();
+    float m_invFar = 1.0f / 1000.0f;
+
+    static CRenderQueue *s_pActive;
+};
+
+// 一次提交的状态切换统计
+struct RenderQueueStats
+{
+    size_t draws;           // 绘制调用
+    size_t instances;       // 绘制的网格实例（不使用实例化时与 draws 相同）
+    size_t materialChanges; // glMaterial 组
+    size_t textureChanges;  // 纹理绑定
+    size_t blendChanges;    // 混合开关
+};
+
+#endif // __RENDER_QUEUE_H__
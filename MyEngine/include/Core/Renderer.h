@@ -8,9 +8,14 @@
 #include <chrono> // 现代时间库. 实现权衡的帧率计算
 #include <Windows.h>
 #include <GL/gl.h>
+#include "Core/MeshInstancer.h"
+#include "Core/StaticBatch.h"
 // ======================================================================
 
 class FontManager;
+class CGLStateCache;
+class CRenderQueue;
+struct RenderQueueStats;
 
 /**
  * @brief OpenGL渲染器类
@@ -31,6 +36,8 @@ private:
     BOOL m_VSyncEnabled;   // 垂直同步是否启用
 
     FontManager &m_FontManager;
+    CGLStateCache &m_StateCache; // OpenGL 状态影子，每帧开始时失效并清零统计
+    CMeshInstancer m_MeshInstancer; // 渲染队列批次的实例化绘制
     GLuint m_FontTexture;     // 字体纹理
     GLuint m_FontDisplayList; // 显示列表基
 
@@ -201,14 +208,41 @@ public:
     void PopState();   // 恢复保存的OpenGL状态
     void ResetState(); // 重置渲染器到默认状态
 
+    /**
+     * @brief 按排序后的顺序提交渲染队列
+     * @note 按批次提交：材质、纹理、混合只在与上一批不同时切换（经 CGLStateCache），顶点数组只启用一次；
+     *       支持实例化时两个以上实例的批次一次绘制完，否则逐实例加载矩阵绘制；
+     *       整个队列只保存恢复一次状态；绘制状态与 CModel::Draw 一致（关闭光照、白色）
+     * @return 本次提交的状态切换统计
+     */
+    RenderQueueStats SubmitQueue(const CRenderQueue &queue);
+
+    /**
+     * @brief 静态合批的顶点与索引上传到 OpenGL 缓冲（GL_STATIC_DRAW），缓冲名记录在 batch 中
+     * @note 场景构建合批后调用一次；失败时合批仍从内存数组绘制
+     */
+    void UploadStaticBatch(CStaticBatch &batch);
+    void ReleaseStaticBatch(CStaticBatch &batch); // 删除 UploadStaticBatch 创建的缓冲
+
+    /**
+     * @brief 绘制静态合批中的可见部分（CStaticBatch::CollectDraws 的结果）
+     * @note 顶点已在世界空间，模型视图保持为观察矩阵；材质、纹理只在组切换时设置，绘制状态与 SubmitQueue 一致
+     * @return 本次提交的状态切换统计（instances 由调用方填写）
+     */
+    RenderQueueStats SubmitStaticBatch(const CStaticBatch &batch, const std::vector<CStaticBatch::Draw> &draws);
+
     // 添加字体渲染
     BOOL InitializeFontSystem();
     void RenderText2D(const std::string &text, INT x, INT y,
                       const FLOAT color[4] = nullptr, FLOAT scale = 1.0f);
     void RenderText3D(const std::string &text, const Vector3 &position,
                       const FLOAT color[4] = nullptr, FLOAT scale = 1.0f);
+    // 屏幕左上角 (x, y) 处绘制灰度图，pixels 为 width * height 个 [0, 1] 的值，按行从底部开始（调试显示用）
+    void DrawImage2D(const FLOAT *pixels, INT width, INT height, INT x, INT y, FLOAT zoom = 1.0f);
 
     FontManager &GetFontManager() { return m_FontManager; }
+    CGLStateCache &GetStateCache() { return m_StateCache; }
+    BOOL IsInstancingSupported() const { return m_MeshInstancer.IsSupported(); }
 
     std::wstring GetGLInfo() const; // 获取OpenGL信息
     BOOL CreateSimpleFont();
@@ -0,0 +1,145 @@
+// ======================================================================
+#ifndef __SCENE_SNAPSHOT_H__
+#define __SCENE_SNAPSHOT_H__
+// ======================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+// ======================================================================
+
+// 二进制场景快照
+// 文件布局：文件头 | 实体记录数组 | 堆（字符串、标签数组、类型私有数据）| 重定位表
+// - 记录与文件头都是定长 POD，加载时整个文件映射进内存直接使用，不逐字段解析
+// - 指针字段在文件中存放相对文件起点的偏移，重定位表列出所有指针字段的位置，
+//   加载时逐项加上映射基址（写时复制映射，不修改磁盘文件）
+// - 本机格式：字节序（魔数）与 wchar_t 宽度不匹配时拒绝加载；快照是本机缓存，不是跨平台资源格式
+// 不依赖引擎其它模块
+
+// 快照中的指针：重定位前为文件内偏移（0 表示空），重定位后为实际地址
+template <typename T>
+struct SnapshotPtr
+{
+    uint64_t value;
+
+    const T *Get() const { return reinterpret_cast<const T *>(static_cast<uintptr_t>(value)); }
+    bool IsNull() const { return value == 0; }
+};
+
+struct SnapshotHeader
+{
+    uint32_t magic; // 按本机字节序写入，字节序不同时不匹配
+    uint16_t version;
+    uint8_t wcharSize;
+    uint8_t reserved;
+    uint64_t fileSize;
+    uint64_t entityOffset; // 实体记录数组
+    uint64_t relocationOffset;
+    uint32_t entityCount;
+    uint32_t relocationCount;
+};
+
+// 实体记录，数组按父先子后排列（父实体的下标总小于子实体）
+struct SnapshotEntity
+{
+    uint32_t type;   // 实体类型，见 EntityType
+    int32_t parent;  // 父实体下标，根为 -1
+    uint32_t flags;  // SNAPSHOT_FLAG_*
+    uint32_t tickGroup;
+    uint32_t tickInterval;
+    uint32_t tagCount;
+    uint32_t dataSize;
+    float groundOffset;
+    float position[3];
+    float rotation[4]; // x, y, z, w
+    float scale[3];
+    uint32_t reserved;
+    SnapshotPtr<wchar_t> name;              // 未命名时为空
+    SnapshotPtr<wchar_t> resource;          // 资源引用（模型路径、纹理路径、天空盒名等），可为空
+    SnapshotPtr<SnapshotPtr<wchar_t>> tags; // tagCount 个字符串
+    SnapshotPtr<uint8_t> data;              // 类型私有数据，dataSize 字节，按 8 字节对齐
+};
+
+const uint32_t SNAPSHOT_MAGIC = 0x4E53594Du; // "MYSN"
+const uint16_t SNAPSHOT_VERSION = 1;
+
+const uint32_t SNAPSHOT_FLAG_VISIBLE = 1u << 0;
+const uint32_t SNAPSHOT_FLAG_SLEEPING = 1u << 1;
+const uint32_t SNAPSHOT_FLAG_SNAP_TO_TERRAIN = 1u << 2;
+const uint32_t SNAPSHOT_FLAG_STATIC = 1u << 3;
+const uint32_t SNAPSHOT_FLAG_OCCLUDER = 1u << 4;
+
+// ======================================================================
+// 写入
+// ======================================================================
+class CSceneSnapshotWriter
+{
+public:
+    CSceneSnapshotWriter();
+
+    // 追加实体记录并返回下标；parent 必须是已追加的记录或 -1
+    uint32_t AddEntity(uint32_t type, int32_t parent);
+    // 定长字段直接修改返回的记录（引用在下次 AddEntity 前有效）；指针字段只能通过下面的接口设置
+    SnapshotEntity &GetEntity(uint32_t index) { return m_entities[index]; }
+    uint32_t GetEntityCount() const { return (uint32_t)m_entities.size(); }
+
+    void SetName(uint32_t index, const std::wstring &name);
+    void SetResource(uint32_t index, const std::wstring &resource);
+    void SetTags(uint32_t index, const std::vector<std::wstring> &tags);
+    // 复制 size 字节作为类型私有数据
+    void SetData(uint32_t index, const void *pData, size_t size);
+
+    // 生成完整文件内容
+    void Finish(std::vector<uint8_t> &out) const;
+    // 写入文件，path 为 UTF-8 编码
+    bool Save(const std::string &path) const;
+
+private:
+    uint64_t AddString(const std::wstring &str);
+    uint64_t Allocate(size_t size, size_t alignment);
+
+    std::vector<SnapshotEntity> m_entities;               // 指针字段暂存堆内偏移
+    std::vector<uint8_t> m_heap;                          // 以 8 个零字节开头，偏移 0 表示空指针
+    std::vector<uint64_t> m_heapPointers;                 // 堆内指针字段（标签数组）的位置
+    std::unordered_map<std::wstring, uint64_t> m_strings; // 相同字符串只存一份
+};
+
+// ======================================================================
+// 读取
+// ======================================================================
+class CSceneSnapshot
+{
+public:
+    CSceneSnapshot() = default;
+    ~CSceneSnapshot() { Close(); }
+
+    CSceneSnapshot(const CSceneSnapshot &) = delete;
+    CSceneSnapshot &operator=(const CSceneSnapshot &) = delete;
+
+    // 映射文件、校验结构并完成指针重定位；失败时返回 false 且不保留映射
+    // 只校验结构（文件头、偏移范围、父下标、数据范围），不校验字符串等内容
+    bool Load(const std::string &path);
+    void Close();
+
+    bool IsLoaded() const { return m_pBase != nullptr; }
+    uint32_t GetEntityCount() const { return m_entityCount; }
+    const SnapshotEntity *GetEntities() const { return m_pEntities; }
+    size_t GetFileSize() const { return m_size; }
+
+    // 对已在内存中的文件内容（可写）做同样的校验与重定位，供 Load 与测试使用
+    static bool Relocate(uint8_t *pBase, size_t size);
+
+private:
+    uint8_t *m_pBase = nullptr;
+    size_t m_size = 0;
+    const SnapshotEntity *m_pEntities = nullptr;
+    uint32_t m_entityCount = 0;
+#ifdef _WIN32
+    void *m_hFile = nullptr;
+    void *m_hMapping = nullptr;
+#endif
+};
+
+#endif // __SCENE_SNAPSHOT_H__
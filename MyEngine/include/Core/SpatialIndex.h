@@ -0,0 +1,91 @@
+// ======================================================================
+#ifndef __SPATIAL_INDEX_H__
+#define __SPATIAL_INDEX_H__
+// ======================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Core/DynamicBVH.h"
+#include "Core/TransformStore.h"
+// ======================================================================
+
+// 场景级的空间索引：实体世界包围盒 -> CDynamicBVH
+// - 每个登记的实体记录局部包围盒与 CTransformStore 节点，世界包围盒由世界矩阵变换局部包围盒得到
+// - Update 在 UpdateWorldMatrices 之后调用：只处理世界矩阵计算序号变化的节点，
+//   新包围盒仍在树中的放大盒内时不改动树
+// - 查询先在树中按放大盒筛选，再用紧包围盒精确判断，结果为实体 ID（CEntity::GetID()）
+// - 实体 ID 与局部包围盒由 CEntity 在挂接、摘除、销毁、包围盒变化时维护
+class CSpatialIndex
+{
+public:
+    typedef CDynamicBVH::ProxyId Handle;
+    static const Handle INVALID_HANDLE = CDynamicBVH::INVALID_PROXY;
+
+    explicit CSpatialIndex(CTransformStore &store = CTransformStore::GetInstance(), float margin = 0.1f);
+    CSpatialIndex(const CSpatialIndex &) = delete;
+    CSpatialIndex &operator=(const CSpatialIndex &) = delete;
+
+    // ======================================================================
+    // 登记
+    // ======================================================================
+    Handle Add(unsigned int entityID, CTransformStore::Handle transform, const AABB &localBounds);
+    void Remove(Handle handle);
+    void SetLocalBounds(Handle handle, const AABB &localBounds);
+
+    // 大量登记（如载入场景）前后调用，期间登记的实体在 EndBulk 时整体建树
+    void BeginBulk() { m_tree.BeginBulk(); }
+    void EndBulk() { m_tree.EndBulk(); }
+
+    // 每帧调用一次（世界矩阵更新之后），返回世界包围盒有变化的实体数
+    size_t Update();
+    // 上一次 Update 中重新插入树的实体数（统计用）
+    size_t GetLastReinsertedCount() const { return m_lastReinserted; }
+
+    // ======================================================================
+    // 查询：结果追加到 out（顺序不定）
+    // ======================================================================
+    void QueryAABB(const AABB &box, std::vector<unsigned int> &out) const;
+    void QuerySphere(const Vector3 &center, float radius, std::vector<unsigned int> &out) const;
+    // 树中整体在视锥内的子树直接接受，与视锥边界相交的候选再用 Math::Batch::CullAABBs 批量测试紧包围盒
+    void QueryFrustum(const Frustum &frustum, std::vector<unsigned int> &out) const;
+    // 射线与世界包围盒最近的交点，未命中返回 0；pDistance 非空时返回沿 direction 的距离
+    unsigned int RayCast(const Vector3 &origin, const Vector3 &direction, float maxDistance, float *pDistance = nullptr) const;
+
+    // 剔除帧号：场景每次做视锥剔除前递增，实体记录自己被标记可见时的帧号（0 表示尚未剔除过）
+    uint32_t BeginView() { return ++m_viewFrame; }
+    uint32_t GetViewFrame() const { return m_viewFrame; }
+
+    const AABB &GetWorldBounds(Handle handle) const { return m_bindings[handle].worldBounds; }
+    unsigned int GetEntityID(Handle handle) const { return m_bindings[handle].entityID; }
+    size_t GetCount() const { return m_live.size(); }
+    const CDynamicBVH &GetTree() const { return m_tree; }
+    void Clear();
+
+private:
+    struct Binding
+    {
+        unsigned int entityID;
+        CTransformStore::Handle transform;
+        AABB localBounds;
+        AABB worldBounds;
+        uint64_t stamp; // 计算 worldBounds 时的世界矩阵序号
+        uint32_t livePos; // 在 m_live 中的下标
+    };
+
+    void ComputeWorldBounds(Binding &binding);
+
+    CTransformStore &m_store;
+    CDynamicBVH m_tree;
+    std::vector<Binding> m_bindings; // 按代理号索引（代理号即树的叶子下标，可能不连续）
+    std::vector<Handle> m_live;      // 已登记的代理，Update 按此遍历
+    size_t m_lastReinserted = 0;
+    uint32_t m_viewFrame = 0;
+
+    // 视锥查询的临时数组（与视锥边界相交、需要逐个测试的候选）
+    mutable std::vector<unsigned int> m_candidateIDs;
+    mutable std::vector<AABB> m_candidateBounds;
+    mutable std::vector<uint8_t> m_candidateVisible;
+};
+
+#endif // __SPATIAL_INDEX_H__
@@ -0,0 +1,209 @@
+// ======================================================================
+#ifndef __STATIC_BATCH_H__
+#define __STATIC_BATCH_H__
+// ======================================================================
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Math/AABB.h"
+#include "Math/Matrix4.h"
+#include "Math/Vector2.h"
+#include "Math/Vector3.h"
+// ======================================================================
+class CMesh;
+// ======================================================================
+
+// 静态合批：场景加载后不再移动的实体，其网格预先变换到世界空间，按材质与纹理合并进一份共享的顶点/索引数据
+// - Add 收集子网格（一个实体的一个网格），Build 排序后写出合批数据；之后子网格不能再移动
+// - 同材质、同纹理的子网格组成一组，组内索引连续；组内子网格按包围盒中心的 Morton 码排列，
+//   空间上相邻的子网格在索引中也相邻
+// - 每个子网格保留自己的索引区间与世界包围盒，CollectDraws 跳过不可见的子网格，并把相邻的可见区间合成一次绘制
+// 顶点布局与 CMesh 的 Vertex 相同；OpenGL 缓冲由 CRenderer::UploadStaticBatch 创建，名称记录在这里
+class CStaticBatch
+{
+public:
+#pragma pack(push, 1)
+    struct Vertex
+    {
+        Vector3 Position;
+        Vector3 Normal;
+        Vector2 TexCoords;
+    };
+#pragma pack(pop)
+
+    // 一个子网格在合批数据中的索引区间
+    struct Range
+    {
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        unsigned int ownerID; // 所属实体，剔除时按它判断可见性
+        AABB bounds;          // 世界空间包围盒
+    };
+
+    // 材质、纹理相同的一组子网格：ranges 下标 [firstRange, firstRange + rangeCount)，索引区间连续
+    struct Group
+    {
+        const CMesh *pMesh; // 组内任一网格，提交时用它设置材质
+        uint32_t material;  // CMesh::GetMaterialID
+        uint32_t texture;   // OpenGL 纹理名，0 表示无纹理
+        uint32_t firstRange;
+        uint32_t rangeCount;
+        uint32_t firstIndex;
+        uint32_t indexCount;
+    };
+
+    // 一次绘制：某组内一段连续的索引
+    struct Draw
+    {
+        uint32_t group;
+        uint32_t firstIndex;
+        uint32_t indexCount;
+    };
+
+    CStaticBatch() = default;
+    CStaticBatch(const CStaticBatch &) = delete;
+    CStaticBatch &operator=(const CStaticBatch &) = delete;
+
+    // 清空合批数据与尚未 Build 的子网格；OpenGL 缓冲须先由 CRenderer::ReleaseStaticBatch 释放
+    void Clear();
+
+    // 加入一个子网格：顶点经 world 变换（法线用逆转置并归一化），索引为子网格内的局部下标
+    // V 需要 Position、Normal、TexCoords 三个成员（CMesh 的 Vertex）
+    template <typename V>
+    void Add(const V *vertices, size_t vertexCount, const unsigned int *indices, size_t indexCount,
+             const Matrix4 &world, const CMesh *pMesh, uint32_t material, uint32_t texture, unsigned int ownerID);
+
+    // 按材质、纹理与空间位置排序并写出合批数据，可多次 Add/Build 追加（已写出的部分保持不变）
+    void Build();
+
+    bool IsEmpty() const { return m_groups.empty(); }
+    const std::vector<Vertex> &GetVertices() const { return m_vertices; }
+    const std::vector<uint32_t> &GetIndices() const { return m_indices; }
+    const std::vector<Group> &GetGroups() const { return m_groups; }
+    const std::vector<Range> &GetRanges() const { return m_ranges; }
+
+    // 可见子网格的绘制列表（按组的顺序），相邻的可见子网格合成一次；返回可见子网格数
+    // isVisible(ownerID) 判断子网格所属实体是否可见
+    template <typename IsVisible>
+    size_t CollectDraws(IsVisible isVisible, std::vector<Draw> &draws) const;
+
+    // OpenGL 缓冲名（0 表示未上传，提交时直接使用内存中的数组）
+    void SetBuffers(uint32_t vertexBuffer, uint32_t indexBuffer)
+    {
+        m_vertexBuffer = vertexBuffer;
+        m_indexBuffer = indexBuffer;
+    }
+    uint32_t GetVertexBuffer() const { return m_vertexBuffer; }
+    uint32_t GetIndexBuffer() const { return m_indexBuffer; }
+
+private:
+    // Add 之后、Build 之前的子网格：顶点已变换，索引仍为局部下标
+    struct Pending
+    {
+        uint32_t firstVertex;
+        uint32_t vertexCount;
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        const CMesh *pMesh;
+        uint32_t material;
+        uint32_t texture;
+        unsigned int ownerID;
+        AABB bounds;
+        uint32_t morton;
+    };
+
+    std::vector<Vertex> m_vertices;
+    std::vector<uint32_t> m_indices;
+    std::vector<Group> m_groups;
+    std::vector<Range> m_ranges;
+
+    std::vector<Vertex> m_pendingVertices;
+    std::vector<uint32_t> m_pendingIndices;
+    std::vector<Pending> m_pending;
+
+    uint32_t m_vertexBuffer = 0;
+    uint32_t m_indexBuffer = 0;
+};
+
+// ======================================================================
+// 模板实现
+// ======================================================================
+template <typename V>
+void CStaticBatch::Add(const V *vertices, size_t vertexCount, const unsigned int *indices, size_t indexCount,
+                       const Matrix4 &world, const CMesh *pMesh, uint32_t material, uint32_t texture, unsigned int ownerID)
+{
+    if (vertexCount == 0 || indexCount == 0)
+        return;
+
+    // 法线矩阵：世界矩阵的逆转置（只用左上 3x3），非均匀缩放时法线仍垂直于表面
+    const Matrix4 normalMatrix = world.Inversed().Transposed();
+
+    Pending pending;
+    pending.firstVertex = (uint32_t)m_pendingVertices.size();
+    pending.vertexCount = (uint32_t)vertexCount;
+    pending.firstIndex = (uint32_t)m_pendingIndices.size();
+    pending.indexCount = (uint32_t)indexCount;
+    pending.pMesh = pMesh;
+    pending.material = material;
+    pending.texture = texture;
+    pending.ownerID = ownerID;
+    pending.morton = 0;
+
+    for (size_t i = 0; i < vertexCount; ++i)
+    {
+        const Vector3 &p = vertices[i].Position;
+        const Vector3 &n = vertices[i].Normal;
+        Vertex v;
+        v.Position = Vector3(world(0, 0) * p.x + world(0, 1) * p.y + world(0, 2) * p.z + world(0, 3),
+                             world(1, 0) * p.x + world(1, 1) * p.y + world(1, 2) * p.z + world(1, 3),
+                             world(2, 0) * p.x + world(2, 1) * p.y + world(2, 2) * p.z + world(2, 3));
+        Vector3 normal(normalMatrix(0, 0) * n.x + normalMatrix(0, 1) * n.y + normalMatrix(0, 2) * n.z,
+                       normalMatrix(1, 0) * n.x + normalMatrix(1, 1) * n.y + normalMatrix(1, 2) * n.z,
+                       normalMatrix(2, 0) * n.x + normalMatrix(2, 1) * n.y + normalMatrix(2, 2) * n.z);
+        float lengthSq = normal.LengthSquared();
+        v.Normal = lengthSq > 0.0f ? normal * (1.0f / std::sqrt(lengthSq)) : normal;
+        v.TexCoords = vertices[i].TexCoords;
+        pending.bounds.Expand(v.Position);
+        m_pendingVertices.push_back(v);
+    }
+
+    m_pendingIndices.insert(m_pendingIndices.end(), indices, indices + indexCount);
+    m_pending.push_back(pending);
+}
+
+template <typename IsVisible>
+size_t CStaticBatch::CollectDraws(IsVisible isVisible, std::vector<Draw> &draws) const
+{
+    size_t visible = 0;
+    for (uint32_t g = 0; g < (uint32_t)m_groups.size(); ++g)
+    {
+        const Group &group = m_groups[g];
+        bool open = false; // draws.back() 是本组中仍可向后延伸的一段
+        for (uint32_t r = group.firstRange; r < group.firstRange + group.rangeCount; ++r)
+        {
+            const Range &range = m_ranges[r];
+            if (!isVisible(range.ownerID))
+            {
+                open = false;
+                continue;
+            }
+            ++visible;
+            if (open)
+            {
+                draws.back().indexCount += range.indexCount;
+                continue;
+            }
+            Draw draw;
+            draw.group = g;
+            draw.firstIndex = range.firstIndex;
+            draw.indexCount = range.indexCount;
+            draws.push_back(draw);
+            open = true;
+        }
+    }
+    return visible;
+}
+
+#endif // __STATIC_BATCH_H__
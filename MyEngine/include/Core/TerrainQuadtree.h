@@ -0,0 +1,164 @@
+// ======================================================================
+#ifndef __TERRAIN_QUADTREE_H__
+#define __TERRAIN_QUADTREE_H__
+// ======================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Math/AABB.h"
+#include "Math/Frustum.h"
+#include "Math/Matrix4.h"
+// ======================================================================
+class CJobSystem;
+class CLODController;
+// ======================================================================
+
+// 地形顶点：位置与压缩到 [-127, 127] 的法线（按 GL_BYTE 法线数组直接使用），UV 由位置生成
+struct TerrainVertex
+{
+    float x, y, z;
+    int8_t nx, ny, nz, pad;
+};
+
+// 一个可见块的绘制参数
+struct TerrainChunkDraw
+{
+    uint32_t chunk;
+    uint16_t level; // 细节级别，0 为全分辨率
+    uint16_t edges; // CTerrainQuadtree::EDGE_* 的组合：该边的邻块粗一级，边上的顶点与之对齐
+};
+
+// 地形选择统计（最近一次 Select）
+struct TerrainStats
+{
+    size_t chunks;         // 全部块
+    size_t visible;        // 在视锥内的块
+    size_t reduced;        // 使用了 1 级及以上的可见块
+    size_t fullTriangles;  // 可见块全部按 0 级绘制时的三角形数
+    size_t drawnTriangles; // 实际选中级别的三角形数
+};
+
+// 分块地形：高度图切成 chunkCells x chunkCells 格的块，按四叉树组织
+// - 每块在级别 l 以 2^l 的步长取顶点（几何 mipmap），级别数为 log2(chunkCells) + 1；
+//   各块的局部顶点布局相同，所有块共用每级 16 种边缘组合的 16 位索引
+// - 每块每级预先算出相对全分辨率高度的最大偏差，选择时经 CLODController 换算成屏幕像素
+// - 相邻块的级别最多差 1（选择后按曼哈顿距离整理），较细的块把对着粗邻块的边上的奇数顶点
+//   折叠到相邻的偶数顶点上，边界顶点完全重合，不产生裂缝也不需要裙边
+// - 四叉树节点记录包围盒，视锥剔除整棵子树一次排除；可设置三角形预算，超出时优先加粗屏幕误差最小的块
+// - 高度图的格数不是块大小的整数倍时，最后一列 / 行的块超出部分压到边缘上（退化三角形）
+class CTerrainQuadtree
+{
+public:
+    static const int DEFAULT_CHUNK_CELLS = 64;
+
+    // 块的四条边（局部坐标 z 向下为行号）
+    enum Edge : uint16_t
+    {
+        EDGE_NEG_Z = 1u << 0,
+        EDGE_POS_X = 1u << 1,
+        EDGE_POS_Z = 1u << 2,
+        EDGE_NEG_X = 1u << 3,
+        EDGE_ALL = 0xF
+    };
+
+    CTerrainQuadtree() = default;
+    CTerrainQuadtree(const CTerrainQuadtree &) = delete;
+    CTerrainQuadtree &operator=(const CTerrainQuadtree &) = delete;
+
+    // heights 为 width * height 个高度（按行），顶点 (x, z) 的局部位置为 ((x - width/2)·cellSize, h, (z - height/2)·cellSize)
+    // chunkCells 为 2 的幂（2 ~ 128）；只记录 heights 指针，须保持有效到下一次 Build 或 Clear
+    // pJobs 为空时在调用线程上计算误差
+    bool Build(const float *heights, int width, int height, float cellSize,
+               int chunkCells = DEFAULT_CHUNK_CELLS, CJobSystem *pJobs = nullptr);
+    void Clear();
+
+    // ======================================================================
+    // 布局
+    // ======================================================================
+    int GetChunkCells() const { return m_chunkCells; }
+    int GetChunksX() const { return m_chunksX; }
+    int GetChunksZ() const { return m_chunksZ; }
+    size_t GetChunkCount() const { return (size_t)m_chunksX * m_chunksZ; }
+    int GetLevelCount() const { return m_levelCount; }
+    size_t GetVerticesPerChunk() const { return (size_t)(m_chunkCells + 1) * (m_chunkCells + 1); }
+
+    const AABB &GetBounds() const { return m_bounds; }                              // 整块地形的局部包围盒
+    const AABB &GetChunkBounds(size_t chunk) const { return m_chunkBounds[chunk]; } // 块的局部包围盒
+    // 块在该级相对全分辨率高度的最大偏差（局部单位），随级别单调不减，0 级为 0
+    float GetChunkError(size_t chunk, int level) const { return m_errors[chunk * m_levelCount + level]; }
+
+    // 块的 (chunkCells + 1)^2 个顶点（按行）写入 out，可多线程同时调用
+    void BuildChunkVertices(size_t chunk, TerrainVertex *out) const;
+
+    // 共享索引：各块的局部顶点编号，逆时针为正面（从上方看）
+    const std::vector<uint16_t> &GetIndices() const { return m_indices; }
+    size_t GetIndexOffset(int level, unsigned int edges) const { return m_indexSets[level * 16 + (edges & EDGE_ALL)].offset; }
+    size_t GetIndexCount(int level, unsigned int edges) const { return m_indexSets[level * 16 + (edges & EDGE_ALL)].count; }
+
+    // ======================================================================
+    // 选择
+    // ======================================================================
+    // 不低于该级别（强制降低细节），默认 0
+    void SetMinLevel(int level) { m_minLevel = level; }
+    int GetMinLevel() const { return m_minLevel; }
+    // 可见块的三角形数上限，0 为不限制；只靠加粗块满足，块数本身超出时可能达不到
+    void SetTriangleBudget(size_t triangles) { m_triangleBudget = triangles; }
+    size_t GetTriangleBudget() const { return m_triangleBudget; }
+
+    // 按相机选择各块级别并输出视锥内的块；world 为地形的世界矩阵，frustum 为世界空间视锥
+    // pLOD 为空时全部按最细级别（不低于 SetMinLevel）；上一次的级别作为 pLOD 的滞后依据
+    size_t Select(const Frustum &frustum, const Matrix4 &world, const CLODController *pLOD,
+                  std::vector<TerrainChunkDraw> &out);
+    // 最近一次 Select 中各块的级别（包括视锥外的块）
+    int GetChunkLevel(size_t chunk) const { return m_levels[chunk]; }
+    const TerrainStats &GetStats() const { return m_stats; }
+
+private:
+    struct IndexSet
+    {
+        size_t offset;
+        size_t count;
+    };
+
+    // 四叉树节点：覆盖块坐标 [x0, x1) x [z0, z1)，叶子只有一个块
+    struct Node
+    {
+        AABB bounds;
+        int x0, z0, x1, z1;
+        int32_t firstChild; // 四个子节点连续存放（可能少于四个），-1 为叶子
+        int32_t childCount;
+    };
+
+    float HeightAt(int x, int z) const; // 超出高度图时取边缘
+    void ComputeChunk(size_t chunk);
+    void BuildIndexSets();
+    void BuildNode(int32_t node); // 节点范围已填好，分出子节点并合并包围盒
+    void CollectVisible(int32_t node, const Frustum &frustum, const Matrix4 &world, uint32_t mask);
+    void BalanceLevels();
+    unsigned int GetEdges(size_t chunk) const; // 粗一级的邻块所在的边
+    size_t CountTriangles() const;
+
+    const float *m_heights = nullptr;
+    int m_width = 0, m_height = 0;
+    float m_cellSize = 1.0f;
+    int m_chunkCells = DEFAULT_CHUNK_CELLS;
+    int m_chunksX = 0, m_chunksZ = 0;
+    int m_levelCount = 0;
+
+    AABB m_bounds;
+    std::vector<AABB> m_chunkBounds;
+    std::vector<float> m_errors; // 块 x 级别
+    std::vector<uint16_t> m_indices;
+    std::vector<IndexSet> m_indexSets; // 级别 x 16 种边缘组合
+    std::vector<Node> m_nodes;
+
+    int m_minLevel = 0;
+    size_t m_triangleBudget = 0;
+    std::vector<int> m_levels;          // 各块当前级别
+    std::vector<uint32_t> m_visible;    // 视锥内的块
+    std::vector<float> m_pixelScale;    // 视锥内各块 1 单位误差的屏幕像素数
+    TerrainStats m_stats = {};
+};
+
+#endif // __TERRAIN_QUADTREE_H__
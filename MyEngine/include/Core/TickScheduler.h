@@ -0,0 +1,120 @@
+// ======================================================================
+#ifndef __TICK_SCHEDULER_H__
+#define __TICK_SCHEDULER_H__
+// ======================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+// ======================================================================
+
+// 更新组：按声明顺序执行，组内顺序不保证（依赖其它实体本帧结果的逻辑放到更靠后的组）
+enum class TickGroup : uint8_t
+{
+    PrePhysics, // 物理/贴地之前：输入驱动的移动等
+    Update,     // 常规逻辑
+    PostUpdate, // 物理/贴地之后：读取本帧最终位置的逻辑
+    LateCamera, // 相机跟随、震动，所有实体移动完成后执行
+    Count
+};
+
+// 按更新组与频率调度的逐帧更新
+// - 频率：每帧、每 N 帧（按登记号错开相位，分摊到不同帧），或按需（RequestTick 后的下一次执行一次）
+// - 按需或未激活（休眠）的登记项不在执行列表中，每帧没有任何开销
+// - 隔帧执行时回调收到距上次执行的累计时间，重新激活后从激活时刻开始累计；按需执行收到当帧时间
+// - 回调中可以增删、激活/休眠任意登记项（含自身），本帧新加入执行列表的项从下一帧开始执行
+// 层级关系（整棵子树休眠）由调用方维护，见 CEntity::Sleep
+// 非线程安全，只在主线程调用
+class CTickScheduler
+{
+public:
+    typedef uint32_t Handle;
+    typedef void (*TickFunc)(void *pOwner, float deltaTime);
+
+    static const Handle INVALID_HANDLE = 0xFFFFFFFFu;
+    static const uint32_t TICK_ON_DEMAND = 0; // 间隔取 0 表示按需
+
+    CTickScheduler() = default;
+    CTickScheduler(const CTickScheduler &) = delete;
+    CTickScheduler &operator=(const CTickScheduler &) = delete;
+
+    // ======================================================================
+    // 登记
+    // ======================================================================
+    // interval：1 每帧，N 每 N 帧，TICK_ON_DEMAND 按需；登记后即处于激活状态
+    Handle Register(void *pOwner, TickFunc func, TickGroup group, uint32_t interval);
+    void Unregister(Handle handle);
+
+    void SetGroup(Handle handle, TickGroup group);
+    void SetInterval(Handle handle, uint32_t interval);
+    // 未激活时不执行，RequestTick 也被忽略
+    void SetActive(Handle handle, bool active);
+    // 在下一次执行所在组时额外执行一次（本帧已按频率执行过则不重复）
+    void RequestTick(Handle handle);
+
+    bool IsActive(Handle handle) const { return m_slots[handle].active; }
+    uint32_t GetInterval(Handle handle) const { return m_slots[handle].interval; }
+
+    // ======================================================================
+    // 执行
+    // ======================================================================
+    // 开始新的一帧并依次执行所有组
+    void Tick(float deltaTime);
+    // 需要在组之间插入其它阶段时分开调用：先 BeginFrame，再按顺序 RunGroup
+    void BeginFrame(float deltaTime);
+    void RunGroup(TickGroup group);
+
+    uint64_t GetFrame() const { return m_frame; }
+    double GetTime() const { return m_time; }
+    size_t GetRegisteredCount() const { return m_slots.size() - m_freeCount; }
+    // 当前每帧可能执行的登记项数（不含按需与未激活的项）
+    size_t GetScheduledCount() const;
+    void Clear();
+
+private:
+    // 执行列表中的一项，回调所需数据就地存放
+    struct Entry
+    {
+        void *pOwner;
+        TickFunc func; // 为空表示已移出，组执行完毕后压缩
+        Handle handle;
+        uint32_t interval;
+        uint32_t phase;
+        double lastTime;
+    };
+
+    struct Slot
+    {
+        void *pOwner;
+        TickFunc func;
+        uint32_t interval;
+        uint32_t index; // 在所属组执行列表中的下标，不在列表中时为 INVALID_HANDLE
+        uint32_t nextFree;
+        TickGroup group;
+        bool active;
+        bool requested;
+        bool used;
+    };
+
+    bool IsDue(const Entry &entry) const { return entry.interval == 1 || (m_frame + entry.phase) % entry.interval == 0; }
+    bool ShouldSchedule(const Slot &slot) const { return slot.used && slot.active && slot.interval != TICK_ON_DEMAND; }
+    void Schedule(Handle handle);
+    void Unschedule(Handle handle);
+    void Compact(TickGroup group);
+
+    std::vector<Slot> m_slots;
+    uint32_t m_firstFree = INVALID_HANDLE;
+    size_t m_freeCount = 0;
+
+    std::vector<Entry> m_entries[(size_t)TickGroup::Count];
+    std::vector<Handle> m_requests[(size_t)TickGroup::Count];
+    bool m_hasHoles[(size_t)TickGroup::Count] = {};
+    size_t m_running = (size_t)TickGroup::Count; // 正在执行的组
+    std::vector<Handle> m_requestScratch;
+
+    uint64_t m_frame = 0;
+    double m_time = 0.0;
+    float m_deltaTime = 0.0f;
+};
+
+#endif // __TICK_SCHEDULER_H__
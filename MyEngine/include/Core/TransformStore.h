@@ -0,0 +1,119 @@
+// ======================================================================
+#ifndef __TRANSFORM_STORE_H__
+#define __TRANSFORM_STORE_H__
+// ======================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Math/Vector3.h"
+#include "Math/Matrix4.h"
+#include "Math/Quaternion.h"
+// ======================================================================
+
+class CJobSystem;
+
+// 扁平化的变换层级：局部 TRS、父索引、世界矩阵分别存放在连续数组中，
+// 并始终保持"父节点排在子节点之前"的顺序（拓扑序）
+// - 修改局部变换只标记该节点本身，O(1)，不再遍历子树
+// - UpdateWorldMatrices 每帧一次线性扫描，从第一个脏节点开始重算所有受影响的世界矩阵；
+//   传入任务系统时按层级拆分：找到第一层宽度足够的"拆分层"，其上的少数几层串行，
+//   拆分层各节点的子树互不依赖，连续存放并按节点数分组并行
+// - GetWorldMatrix 在两次扫描之间也保证正确：沿父索引向上找到最高的过期祖先再向下重算
+// 判定过期用计算序号：节点的世界矩阵比父节点旧（序号更小）即需重算
+// 句柄在节点生命周期内稳定，内部数组顺序可能因改父/销毁而重排
+class CTransformStore
+{
+public:
+    typedef uint32_t Handle;
+    static const Handle INVALID_HANDLE = 0xFFFFFFFFu;
+
+    CTransformStore() = default;
+    CTransformStore(const CTransformStore &) = delete;
+    CTransformStore &operator=(const CTransformStore &) = delete;
+
+    // 引擎默认的全局实例（CEntity 使用）
+    static CTransformStore &GetInstance();
+
+    // ======================================================================
+    // 节点管理
+    // ======================================================================
+    Handle Create();
+    // 销毁节点；仍挂在它下面的子节点在下次重排时变为根节点
+    void Destroy(Handle handle);
+    // parent 为 INVALID_HANDLE 时变为根节点；会形成环时不做修改并返回 false
+    bool SetParent(Handle handle, Handle parent);
+    Handle GetParent(Handle handle) const;
+
+    bool IsValid(Handle handle) const
+    {
+        return handle < m_denseOf.size() && m_denseOf[handle] != INVALID_HANDLE;
+    }
+    size_t GetCount() const { return m_liveCount; }
+
+    // ======================================================================
+    // 变换
+    // ======================================================================
+    void SetLocal(Handle handle, const Vector3 &position, const Quaternion &rotation, const Vector3 &scale);
+    void SetLocalPosition(Handle handle, const Vector3 &position);
+    void SetLocalRotation(Handle handle, const Quaternion &rotation);
+    void SetLocalScale(Handle handle, const Vector3 &scale);
+
+    const Vector3 &GetLocalPosition(Handle handle) const { return m_position[m_denseOf[handle]]; }
+    const Quaternion &GetLocalRotation(Handle handle) const { return m_rotation[m_denseOf[handle]]; }
+    const Vector3 &GetLocalScale(Handle handle) const { return m_scale[m_denseOf[handle]]; }
+
+    // 返回最新的世界矩阵（必要时沿父链补算）；引用在下次增删节点前有效
+    const Matrix4 &GetWorldMatrix(Handle handle);
+    // 世界矩阵的计算序号：UpdateWorldMatrices 之后与上次记录的值不同，说明世界矩阵已重算
+    uint64_t GetWorldStamp(Handle handle) const { return m_stamp[m_denseOf[handle]]; }
+
+    // 每帧调用一次：按数组顺序重算所有过期的世界矩阵
+    // pJobs 非空且节点数达到 PARALLEL_THRESHOLD 时按子树分组并行（层级结构变化后先重排一次）
+    void UpdateWorldMatrices(CJobSystem *pJobs = nullptr);
+
+    // 少于该节点数时并行调度的开销大于收益
+    static const size_t PARALLEL_THRESHOLD = 8192;
+    // 每组至少的节点数
+    static const size_t PARALLEL_GRAIN = 1024;
+    // 节点数达到该值的第一层作为拆分层
+    static const size_t SPLIT_MIN_WIDTH = 64;
+
+    // 最近一次重排得到的并行分组数（0 表示层级太窄，只能串行）
+    size_t GetParallelGroupCount() const { return m_groupSplit.empty() ? 0 : m_groupSplit.size() - 1; }
+
+    // 上一次 UpdateWorldMatrices 重算的节点数（统计用）
+    size_t GetLastUpdatedCount() const { return m_lastUpdated; }
+
+private:
+    void MarkDirty(uint32_t index);
+    void RebuildOrder();
+    void ComputeWorld(uint32_t index, uint64_t stamp);
+    size_t UpdateRange(uint32_t begin, uint32_t end, uint64_t stamp);
+
+    // 以下数组按拓扑序（dense 索引）排列
+    std::vector<Vector3> m_position;
+    std::vector<Quaternion> m_rotation;
+    std::vector<Vector3> m_scale;
+    std::vector<Matrix4> m_world;
+    std::vector<uint32_t> m_parent;   // 父节点 dense 索引，根节点为 INVALID_HANDLE
+    std::vector<uint64_t> m_stamp;    // 世界矩阵的计算序号
+    std::vector<uint8_t> m_dirty;     // 局部变换或父子关系已改变
+    std::vector<Handle> m_handleOf;   // dense -> 句柄，已销毁为 INVALID_HANDLE
+
+    std::vector<uint32_t> m_denseOf;  // 句柄 -> dense，空闲为 INVALID_HANDLE
+    std::vector<Handle> m_freeHandles;
+
+    // 第 g 组：拆分层节点 [m_groupSplit[g], m_groupSplit[g + 1])，其子树 [m_groupDesc[g], m_groupDesc[g + 1])
+    std::vector<uint32_t> m_groupSplit;
+    std::vector<uint32_t> m_groupDesc;
+    std::vector<uint32_t> m_scratch;  // 补算父链时的临时栈
+    uint64_t m_nextStamp = 1;
+    uint32_t m_firstDirty = INVALID_HANDLE; // 下次扫描的起点
+    size_t m_liveCount = 0;
+    size_t m_lastUpdated = 0;
+    bool m_bOrderDirty = false;  // 顺序被改父/销毁破坏，扫描前需重排
+    bool m_bGroupsDirty = false; // 新建/改父后分组失效，并行扫描前需重排
+};
+
+#endif // __TRANSFORM_STORE_H__
@@ -24,6 +24,8 @@ enum class CameraMode
 // 相机实体类
 class CCameraEntity : public CEntity
 {
+    template <typename>
+    friend class CPoolAllocator;
 
 public:
     virtual ~CCameraEntity() = default;
@@ -32,9 +34,7 @@ public:
     template <typename... Args>
     static std::shared_ptr<CCameraEntity> Create(Args &&...args)
     {
-        auto entity = std::shared_ptr<CCameraEntity>(new CCameraEntity(std::forward<Args>(args)...));
-        entity->m_uID = ++s_nextID;
-        return entity;
+        return Allocate<CCameraEntity>(std::forward<Args>(args)...);
     }
 
     // ======================================================================
@@ -54,6 +54,12 @@ public:
     virtual void Update(float deltaTime) override;
     void StartShake(float intensity, float duration);
 
+    // 场景快照（震动是瞬时状态，不保存）
+    virtual EntityType GetType() const override { return EntityType::Camera; }
+    virtual void WriteSnapshot(CSceneSnapshotWriter &writer, uint32_t index) const override;
+    virtual void ReadSnapshot(const SnapshotEntity &record) override;
+    static std::shared_ptr<CCameraEntity> CreateFromSnapshot(const SnapshotEntity &record);
+
     void SetMode(CameraMode mode) { m_Mode = mode; }
     CameraMode GetMode() const { return m_Mode; }
 
@@ -16,8 +16,8 @@ struct GridVertex
 
 class CGridEntity : public CEntity
 {
-private:
-    static unsigned int s_nextID;
+    template <typename>
+    friend class CPoolAllocator;
 
 public:
     virtual ~CGridEntity() = default;
@@ -26,9 +26,7 @@ public:
     template <typename... Args>
     static std::shared_ptr<CGridEntity> Create(Args &&...args)
     {
-        auto entity = std::shared_ptr<CGridEntity>(new CGridEntity(std::forward<Args>(args)...));
-        entity->m_uID = ++s_nextID;
-        return entity;
+        return Allocate<CGridEntity>(std::forward<Args>(args)...);
     }
 
     // 属性设置
@@ -40,8 +38,14 @@ public:
         m_SubColor = subColor;
     }
 
-    virtual void Update(float deltaTime) override;
     virtual void Render() override;
+
+    // 场景快照
+    virtual EntityType GetType() const override { return EntityType::Grid; }
+    virtual void WriteSnapshot(CSceneSnapshotWriter &writer, uint32_t index) const override;
+    virtual void ReadSnapshot(const SnapshotEntity &record) override;
+    static std::shared_ptr<CGridEntity> CreateFromSnapshot(const SnapshotEntity &record);
+
     void DrawFadingLine(float coord, BOOL isParallelToZ, const Vector3 &camPos, const Vector3 &color, float maxDist);
 
     // 世界坐标
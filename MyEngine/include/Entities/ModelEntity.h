@@ -11,25 +11,42 @@ class CModel; // 前向声明
 
 class CModelEntity : public CEntity
 {
+    template <typename>
+    friend class CPoolAllocator;
+
 public:
     virtual ~CModelEntity() = default;
 
     template <typename... Args>
     static std::shared_ptr<CModelEntity> Create(Args &&...args)
     {
-        auto entity = std::shared_ptr<CModelEntity>(new CModelEntity(std::forward<Args>(args)...));
-        entity->m_uID = ++s_nextID;
-        return entity;
+        return Allocate<CModelEntity>(std::forward<Args>(args)...);
     }
 
     // 实现基类的核心接口
     virtual void Update(float deltaTime) override;
     virtual void Render() override;
 
+    // 场景快照：模型以相对模型目录的路径引用
+    virtual EntityType GetType() const override { return EntityType::Model; }
+    virtual void WriteSnapshot(CSceneSnapshotWriter &writer, uint32_t index) const override;
+    virtual void ReadSnapshot(const SnapshotEntity &record) override;
+    static std::shared_ptr<CModelEntity> CreateFromSnapshot(const SnapshotEntity &record);
+
     // 模型特有操作
-    void SetModel(std::shared_ptr<CModel> pModel) { m_pModel = pModel; }
+    void SetModel(std::shared_ptr<CModel> pModel)
+    {
+        m_pModel = pModel;
+        RefreshBounds();
+    }
     std::shared_ptr<CModel> GetModel() const { return m_pModel; }
 
+    // 模型的局部包围盒
+    virtual BOOL GetLocalBounds(AABB &bounds) const override;
+
+    // 最近一次渲染选中的细节级别（静态合批中的实体总是 0 级）
+    size_t GetLODLevel() const { return m_uLODLevel; }
+
     // ======================================================================
     // 包围盒
     void SetDrawBoundingBox(BOOL bDraw) { m_bDrawBBox = bDraw; }
@@ -47,8 +64,14 @@ protected:
     // 构造函数受保护，强制使用 Create
     CModelEntity(std::shared_ptr<CModel> pModel);
 
+    // 静态时网格并入场景的静态合批（有半透明网格的模型除外）
+    virtual BOOL AddStaticGeometry(CStaticBatch &batch) const override;
+    // 作为遮挡体时用各网格的原始索引（遮挡体须保守，不能比实际网格大）
+    virtual BOOL AddOccluderGeometry(COcclusionBuffer &buffer) const override;
+
 private:
     std::shared_ptr<CModel> m_pModel; // 引用模型资源
+    size_t m_uLODLevel = 0;           // 上一帧的细节级别，选择时的滞后依据
 
     BOOL m_bDrawBBox = FALSE;
 
@@ -4,13 +4,13 @@
 #define __SKYBOX_ENTITY_H__
 // ======================================================================
 #include "Core/Entity.h"
-#include "Graphics/Camera/Camera.h"
 // ======================================================================
 
 class CSkyboxEntity : public CEntity
 {
-private:
-    static unsigned int s_nextID; // 静态ID计数器
+    template <typename>
+    friend class CPoolAllocator;
+
 public:
     virtual ~CSkyboxEntity() = default;
 
@@ -18,20 +18,32 @@ public:
     template <typename... Args>
     static std::shared_ptr<CSkyboxEntity> Create(Args &&...args)
     {
-        auto entity = std::shared_ptr<CSkyboxEntity>(new CSkyboxEntity(std::forward<Args>(args)...));
-        entity->m_uID = ++s_nextID;
-        return entity;
+        return Allocate<CSkyboxEntity>(std::forward<Args>(args)...);
     }
 
     // 设置立方体贴图 ID (通常从 ResourceManager 获取)
     void SetCubemapTexture(GLuint textureID) { m_uCubemapID = textureID; }
     void SetSize(FLOAT size) { m_fSize = size; }
-    void EnableRotation(BOOL enable) { m_bEnableRotation = enable; }
+    // 只有旋转时才需要逐帧更新，静止的天空盒不进入调度
+    void EnableRotation(BOOL enable)
+    {
+        m_bEnableRotation = enable;
+        SetTickInterval(enable ? 1 : CTickScheduler::TICK_ON_DEMAND);
+    }
     void SetRotationSpeed(FLOAT speed) { m_fRotationSpeed = speed; }
+    // 天空盒资源名（exp: day），写入场景快照用于重新加载贴图
+    void SetSkyboxName(const std::wstring &name) { m_skyboxName = name; }
+    const std::wstring &GetSkyboxName() const { return m_skyboxName; }
 
     virtual void Update(float deltaTime) override;
     virtual void Render() override;
 
+    // 场景快照
+    virtual EntityType GetType() const override { return EntityType::Skybox; }
+    virtual void WriteSnapshot(CSceneSnapshotWriter &writer, uint32_t index) const override;
+    virtual void ReadSnapshot(const SnapshotEntity &record) override;
+    static std::shared_ptr<CSkyboxEntity> CreateFromSnapshot(const SnapshotEntity &record);
+
 protected:
     CSkyboxEntity(GLuint textureID = 0);
 
@@ -41,6 +53,7 @@ private:
     BOOL m_bEnableRotation;
     FLOAT m_fRotationSpeed;
     FLOAT m_fCurrentRotation;
+    std::wstring m_skyboxName;
 
     void DrawCube(); // 内部辅助绘制 1x1x1 立方体
 };
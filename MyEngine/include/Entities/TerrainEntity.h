@@ -5,14 +5,15 @@
 // ======================================================================
 #include <vector>
 #include "Core/Entity.h"
+#include "Core/TerrainQuadtree.h"
 #include "Resources/Texture.h"
 // ======================================================================
 class Vector3;
 // ======================================================================
 class CTerrainEntity : public CEntity
 {
-private:
-    static unsigned int s_nextID;
+    template <typename>
+    friend class CPoolAllocator;
 
 public:
     virtual ~CTerrainEntity();
@@ -23,15 +24,27 @@ public:
                                                   float size, float maxHeight);
     static std::shared_ptr<CTerrainEntity> CreateProcedural(int width, int height, float size, float maxHeight);
 
-    virtual void Update(float deltaTime) override;
     virtual void Render() override;
 
+    // 场景快照：直接保存高度数据，读回时不再解码高度图
+    virtual EntityType GetType() const override { return EntityType::Terrain; }
+    virtual void WriteSnapshot(CSceneSnapshotWriter &writer, uint32_t index) const override;
+    virtual void ReadSnapshot(const SnapshotEntity &record) override;
+    static std::shared_ptr<CTerrainEntity> CreateFromSnapshot(const SnapshotEntity &record);
+
     // 地形查询功能
     float GetHeightAt(float worldX, float worldZ) const;
     float GetGroundHeight(const Vector3& worldPos) const;
     Vector3 GetNormalAt(float worldX, float worldZ) const;
     bool IsPositionOnTerrain(float worldX, float worldZ) const;
 
+    // 高度数据的局部包围盒，在生成顶点时更新
+    virtual BOOL GetLocalBounds(AABB &bounds) const override
+    {
+        bounds = m_localBounds;
+        return m_localBounds.IsValid();
+    }
+
     // 设置地形属性
     void SetTexture(std::shared_ptr<CTexture> pTexture)
     {
@@ -44,7 +57,16 @@ public:
     void SetColor(const Vector4 &color) { m_terrainColor = color; }
 
     void EnableWireframe(bool enable) { m_bWireframe = enable; }
-    void SetLODLevel(int lod) { m_iLODLevel = std::max(1, std::min(4, lod)); }
+    // 细节级别按块由屏幕误差选择；lod 为允许的最细顶点步长（1、2、4），对应块的最低级别
+    void SetLODLevel(int lod)
+    {
+        m_iLODLevel = std::max(1, std::min(4, lod));
+        m_quadtree.SetMinLevel(m_iLODLevel >= 4 ? 2 : (m_iLODLevel >= 2 ? 1 : 0));
+    }
+    // 可见块的三角形数上限，0 为不限制
+    void SetTriangleBudget(size_t triangles) { m_quadtree.SetTriangleBudget(triangles); }
+    // 最近一次渲染的块选择统计
+    const TerrainStats &GetTerrainStats() const { return m_quadtree.GetStats(); }
 
     // ======================================================================
     // 法线
@@ -63,26 +85,25 @@ protected:
     CTerrainEntity();
     BOOL LoadHeightmap(const std::wstring &path, float size, float maxHeight);
     void GenerateProceduralTerrain(int width, int height, float size, float maxHeight);
-    void CalculateNormals();
-    void GenerateIndices();
+    void GenerateOccluder(); // 由 m_heightData 生成遮挡用的粗网格
+    void BuildMesh();        // 由 m_heightData 生成分块、遮挡网格与 VBO
+
+    // 默认是遮挡体：光栅化粗网格
+    virtual BOOL AddOccluderGeometry(COcclusionBuffer &buffer) const override;
 
 private:
-    struct Vertex
-    {
-        Vector3 pos;
-        Vector2 uv;
-        Vector3 normal;
-        Vector4 color;
-    };
-
-    std::vector<Vertex> m_vertices;
-    std::vector<unsigned int> m_indices;
+    // 分块与各块的细节级别；顶点只在 VBO 中（不支持 VBO 时逐块临时生成）
+    CTerrainQuadtree m_quadtree;
+    std::vector<TerrainChunkDraw> m_chunkDraws; // 本帧可见的块
+    std::vector<TerrainVertex> m_chunkVertices; // 不使用 VBO 时的单块顶点
     std::shared_ptr<CTexture> m_pTexture;
     Vector4 m_terrainColor;
 
     int m_width, m_height; // 宽高
     float m_maxHeight;     // 最大高度
     float m_cellSize;
+    float m_fTextureRepeat = 1.0f; // UV 重复次数
+    AABB m_localBounds;            // 默认为空盒，BuildMesh 后有效
     BOOL m_bWireframe;
 
     int m_iLODLevel;
@@ -92,12 +113,18 @@ private:
 
     std::vector<float> m_heightData; // 高度图数据
 
+    // 遮挡用的粗网格：每个顶点取相邻粗格子内的最低高度，整体不高于真实地面，从上方看不会多挡
+    std::vector<Vector3> m_occluderVertices;
+    std::vector<unsigned int> m_occluderIndices;
+
     BOOL m_bDrawNormals = FALSE;    // 是否绘制法线开关
     float m_fNormalScale = 10.0f;   // 法线显示长度
     unsigned int m_uNormalStep = 5; // 法线步长
     void DrawNormalsImpl(float scale, unsigned int step);
 
     void CreateVBO();
+    void DeleteVBO();
+    void SetupTexGen() const; // 由局部位置生成 UV（与高度图格点对齐，重复 m_fTextureRepeat 次）
 };
 
 #endif // __TERRAIN_ENTITY_H__
\ No newline at end of file
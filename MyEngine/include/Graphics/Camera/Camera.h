@@ -21,6 +21,7 @@ enum class CameraMode
 // ======================================================================
 class Vector3;
 class Matrix4;
+class Frustum;
 
 // ======================================================================
 class CCamera
@@ -292,7 +293,8 @@ public:
 
     void GetViewMatrix(Matrix4 &matrix) const;           // 获取观察矩阵
     void GetProjectionMatrix(Matrix4 &matrix) const;     // 获取投影矩阵
-    void GetViewProjectionMatrix(Matrix4 &matrix) const; // 获取视图投影矩阵
+    void GetViewProjectionMatrix(Matrix4 &matrix) const; // 获取视图投影矩阵（投影 * 观察）
+    void GetFrustum(Frustum &frustum) const;             // 获取世界空间视锥体（由视图投影矩阵提取，剔除用）
 
     // ======================================================================
     // 更新和渲染
@@ -0,0 +1,81 @@
+// ======================================================================
+#ifndef __AABB_H__
+#define __AABB_H__
+// ======================================================================
+
+#include "Math/Vector3.h"
+// ======================================================================
+
+// 轴对齐包围盒
+class AABB
+{
+public:
+    Vector3 min;
+    Vector3 max;
+
+    // 构造函数：默认构造为空盒（min > max），Expand 后才有效
+    AABB() : min(Math::FLOAT_MAX, Math::FLOAT_MAX, Math::FLOAT_MAX),
+             max(Math::FLOAT_MIN, Math::FLOAT_MIN, Math::FLOAT_MIN) {}
+    AABB(const Vector3 &minPoint, const Vector3 &maxPoint) : min(minPoint), max(maxPoint) {}
+
+    static AABB FromCenterExtents(const Vector3 &center, const Vector3 &extents)
+    {
+        return AABB(center - extents, center + extents);
+    }
+
+    bool IsValid() const
+    {
+        return min.x <= max.x && min.y <= max.y && min.z <= max.z;
+    }
+
+    Vector3 GetCenter() const { return (min + max) * 0.5f; }
+    Vector3 GetExtents() const { return (max - min) * 0.5f; }
+    Vector3 GetSize() const { return max - min; }
+
+    // 表面积（BVH 的 SAH 代价用）
+    float GetSurfaceArea() const
+    {
+        Vector3 d = max - min;
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    void Expand(const Vector3 &point)
+    {
+        min = Vector3::Min(min, point);
+        max = Vector3::Max(max, point);
+    }
+
+    void Expand(const AABB &other)
+    {
+        min = Vector3::Min(min, other.min);
+        max = Vector3::Max(max, other.max);
+    }
+
+    AABB Merged(const AABB &other) const
+    {
+        return AABB(Vector3::Min(min, other.min), Vector3::Max(max, other.max));
+    }
+
+    bool Contains(const Vector3 &point) const
+    {
+        return point.x >= min.x && point.x <= max.x &&
+               point.y >= min.y && point.y <= max.y &&
+               point.z >= min.z && point.z <= max.z;
+    }
+
+    bool Contains(const AABB &other) const
+    {
+        return other.min.x >= min.x && other.max.x <= max.x &&
+               other.min.y >= min.y && other.max.y <= max.y &&
+               other.min.z >= min.z && other.max.z <= max.z;
+    }
+
+    bool Intersects(const AABB &other) const
+    {
+        return min.x <= other.max.x && max.x >= other.min.x &&
+               min.y <= other.max.y && max.y >= other.min.y &&
+               min.z <= other.max.z && max.z >= other.min.z;
+    }
+};
+
+#endif // __AABB_H__
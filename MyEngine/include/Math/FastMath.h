@@ -0,0 +1,314 @@
+// ======================================================================
+#ifndef __FAST_MATH_H__
+#define __FAST_MATH_H__
+// ======================================================================
+
+#include <cstddef>
+#include <cstring>
+#include "Math/MathUtils.h"
+#include "Math/MathSIMD.h"
+#include "Math/Vector3.h"
+// ======================================================================
+
+// 快速近似档：Math::Sin/Cos/Sqrt/InvSqrt/Atan2 仍是 libm 精确版本，
+// 对精度不敏感的热点（程序化地形、法线归一化、粒子更新）显式改用 Math::Fast
+// - Sin/Cos/SinCos: Cephes 单精度多项式 + π/4 象限规约，无 libm 调用
+// - InvSqrt/Sqrt: rsqrt 硬件近似 + 一次牛顿迭代（无 SSE 时用整数初值 + 两次迭代）
+// - Atan2: 11 次奇多项式 + 八分象限折叠
+// 标量、4 路（SSE）、8 路（AVX）使用同一套公式，误差上限见下方常量，
+// 由 MyBench/FastMathBench 对照 libm 验证
+namespace Math
+{
+namespace Fast
+{
+    // ======================================================================
+    // 误差上限
+    // ======================================================================
+    // Sin/Cos: |x| <= SIN_COS_MAX_INPUT 时的绝对误差
+    MATH_CONST FLOAT SIN_COS_MAX_INPUT = 8192.0f;
+    MATH_CONST FLOAT SIN_COS_MAX_ERROR = 2e-7f;
+    // InvSqrt/Sqrt: 有限正数输入的相对误差（SSE/AVX 路径实测约 3e-7，标量回退约 4.7e-6）
+    MATH_CONST FLOAT INV_SQRT_MAX_REL_ERROR = 5e-6f;
+    // Atan2: 绝对误差（弧度）
+    MATH_CONST FLOAT ATAN2_MAX_ERROR = 4e-6f;
+
+    // ======================================================================
+    // 标量
+    // ======================================================================
+    inline void SinCos(float x, float *outSin, float *outCos)
+    {
+        float sinSign = x < 0.0f ? -1.0f : 1.0f;
+        x = Abs(x);
+
+        // j = (int)(|x| * 4/π) 向上取偶，y 为对应的 π/4 倍数
+        int j = (int)(x * 1.27323954473516f);
+        j = (j + 1) & ~1;
+        float y = (float)j;
+
+        // 符号与多项式互换都用整数位运算求出，避免随机输入下的分支预测失败
+        float cosSign = (float)(1 - 2 * ((~(j - 2) >> 2) & 1));
+        sinSign *= (float)(1 - 2 * ((j >> 2) & 1));
+        bool swap = (j & 2) != 0;
+
+        // 扩展精度规约 x = |x| - y * π/4
+        x = x + y * -0.78515625f;
+        x = x + y * -2.4187564849853515625e-4f;
+        x = x + y * -3.77489497744594108e-8f;
+        float z = x * x;
+
+        float pc = ((2.443315711809948e-5f * z + -1.388731625493765e-3f) * z + 4.166664568298827e-2f) * z * z;
+        pc = pc - z * 0.5f + 1.0f;
+        float ps = ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z + -1.6666654611e-1f) * z * x + x;
+
+        *outSin = sinSign * (swap ? pc : ps);
+        *outCos = cosSign * (swap ? ps : pc);
+    }
+
+    inline float Sin(float x)
+    {
+        float s, c;
+        SinCos(x, &s, &c);
+        return s;
+    }
+
+    inline float Cos(float x)
+    {
+        float s, c;
+        SinCos(x, &s, &c);
+        return c;
+    }
+
+    // 输入须为有限正数（0 返回 +inf）
+    inline float InvSqrt(float x)
+    {
+#if defined(MATH_SIMD_SSE)
+        float y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+#else
+        int i;
+        memcpy(&i, &x, sizeof(i));
+        i = 0x5f375a86 - (i >> 1);
+        float y;
+        memcpy(&y, &i, sizeof(y));
+        y = y * (1.5f - 0.5f * x * y * y);
+#endif
+        return y * (1.5f - 0.5f * x * y * y);
+    }
+
+    // 非正数返回 0
+    inline float Sqrt(float x)
+    {
+        return x > 0.0f ? x * InvSqrt(x) : 0.0f;
+    }
+
+    inline float Atan2(float y, float x)
+    {
+        float ax = Abs(x);
+        float ay = Abs(y);
+        float mx = Max(ax, ay);
+        if (mx == 0.0f)
+            return 0.0f;
+
+        // atan(a), a = min/max ∈ [0, 1]
+        float a = Min(ax, ay) / mx;
+        float s = a * a;
+        float r = ((((-1.172120e-2f * s + 5.265332e-2f) * s + -1.1643287e-1f) * s + 1.9354346e-1f) * s + -3.3262347e-1f) * s;
+        r = r * a + 9.9997726e-1f * a;
+
+        if (ay > ax)
+            r = HALF_PI - r;
+        if (x < 0.0f)
+            r = PI - r;
+        return y < 0.0f ? -r : r;
+    }
+
+    // 零向量返回 (0, 0, 0)，与 Vector3::Normalized 一致
+    inline Vector3 Normalized(const Vector3 &v)
+    {
+        float lenSq = v.LengthSquared();
+        if (lenSq > EPSILON * EPSILON)
+            return v * InvSqrt(lenSq);
+        return Vector3(0.0f, 0.0f, 0.0f);
+    }
+
+    inline Vector3 &Normalize(Vector3 &v)
+    {
+        float lenSq = v.LengthSquared();
+        if (lenSq > EPSILON * EPSILON)
+            v *= InvSqrt(lenSq);
+        return v;
+    }
+
+#if defined(MATH_SIMD_SSE)
+    // ======================================================================
+    // 4 路（SSE）
+    // ======================================================================
+    inline void SinCos4(__m128 x, __m128 *outSin, __m128 *outCos)
+    {
+        SIMD::SinCos4(x, outSin, outCos);
+    }
+
+    inline __m128 Sin4(__m128 x)
+    {
+        __m128 s, c;
+        SIMD::SinCos4(x, &s, &c);
+        return s;
+    }
+
+    inline __m128 Cos4(__m128 x)
+    {
+        __m128 s, c;
+        SIMD::SinCos4(x, &s, &c);
+        return c;
+    }
+
+    inline __m128 InvSqrt4(__m128 x)
+    {
+        __m128 y = _mm_rsqrt_ps(x);
+        __m128 xyy = _mm_mul_ps(_mm_mul_ps(x, y), y);
+        return _mm_mul_ps(y, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(_mm_set1_ps(0.5f), xyy)));
+    }
+
+    inline __m128 Sqrt4(__m128 x)
+    {
+        __m128 positive = _mm_cmpgt_ps(x, _mm_setzero_ps());
+        return _mm_and_ps(positive, _mm_mul_ps(x, InvSqrt4(x)));
+    }
+
+    inline __m128 Atan2_4(__m128 y, __m128 x)
+    {
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        __m128 ax = _mm_andnot_ps(signMask, x);
+        __m128 ay = _mm_andnot_ps(signMask, y);
+        __m128 mx = _mm_max_ps(ax, ay);
+        __m128 a = _mm_div_ps(_mm_min_ps(ax, ay), mx);
+        a = _mm_and_ps(a, _mm_cmpgt_ps(mx, _mm_setzero_ps())); // 0/0 -> 0
+        __m128 s = _mm_mul_ps(a, a);
+
+        __m128 r = _mm_set1_ps(-1.172120e-2f);
+        r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(5.265332e-2f));
+        r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(-1.1643287e-1f));
+        r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(1.9354346e-1f));
+        r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(-3.3262347e-1f));
+        r = _mm_mul_ps(r, s);
+        r = _mm_add_ps(_mm_mul_ps(r, a), _mm_mul_ps(_mm_set1_ps(9.9997726e-1f), a));
+
+        __m128 swap = _mm_cmpgt_ps(ay, ax);
+        r = _mm_or_ps(_mm_and_ps(swap, _mm_sub_ps(_mm_set1_ps(HALF_PI), r)), _mm_andnot_ps(swap, r));
+        __m128 negX = _mm_cmplt_ps(x, _mm_setzero_ps());
+        r = _mm_or_ps(_mm_and_ps(negX, _mm_sub_ps(_mm_set1_ps(PI), r)), _mm_andnot_ps(negX, r));
+        __m128 negY = _mm_and_ps(_mm_cmplt_ps(y, _mm_setzero_ps()), signMask);
+        return _mm_xor_ps(r, negY);
+    }
+#endif
+
+#if defined(MATH_SIMD_AVX)
+    // ======================================================================
+    // 8 路（AVX）：AVX1 没有 256 位整数运算，象限判断全部在浮点域完成
+    // ======================================================================
+    inline void SinCos8(__m256 x, __m256 *outSin, __m256 *outCos)
+    {
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 half = _mm256_set1_ps(0.5f);
+        __m256 sinSign = _mm256_and_ps(x, signMask);
+        x = _mm256_andnot_ps(signMask, x);
+
+        // y = (int)(|x| * 4/π) 向上取偶，k = (y / 2) mod 4 为象限
+        __m256 y = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(1.27323954473516f)), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+        y = _mm256_floor_ps(_mm256_mul_ps(_mm256_add_ps(y, one), half));
+        y = _mm256_add_ps(y, y);
+        __m256 k = _mm256_sub_ps(_mm256_mul_ps(y, half), _mm256_mul_ps(_mm256_floor_ps(_mm256_mul_ps(y, _mm256_set1_ps(0.125f))), _mm256_set1_ps(4.0f)));
+
+        // k 为偶数时 sin/cos 多项式不互换；k >= 2 时 sin 取反；k 为 1、2 时 cos 取反
+        __m256 polyMask = _mm256_cmp_ps(_mm256_floor_ps(_mm256_mul_ps(k, half)), _mm256_mul_ps(k, half), _CMP_EQ_OQ);
+        sinSign = _mm256_xor_ps(sinSign, _mm256_and_ps(_mm256_cmp_ps(k, _mm256_set1_ps(2.0f), _CMP_GE_OQ), signMask));
+        __m256 kc = _mm256_andnot_ps(signMask, _mm256_sub_ps(k, _mm256_set1_ps(1.5f)));
+        __m256 cosSign = _mm256_and_ps(_mm256_cmp_ps(kc, one, _CMP_LT_OQ), signMask);
+
+        // 扩展精度规约 x = |x| - y * π/4
+        x = _mm256_add_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(-0.78515625f)));
+        x = _mm256_add_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(-2.4187564849853515625e-4f)));
+        x = _mm256_add_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(-3.77489497744594108e-8f)));
+        __m256 z = _mm256_mul_ps(x, x);
+
+        __m256 pc = _mm256_set1_ps(2.443315711809948e-5f);
+        pc = _mm256_add_ps(_mm256_mul_ps(pc, z), _mm256_set1_ps(-1.388731625493765e-3f));
+        pc = _mm256_add_ps(_mm256_mul_ps(pc, z), _mm256_set1_ps(4.166664568298827e-2f));
+        pc = _mm256_mul_ps(_mm256_mul_ps(pc, z), z);
+        pc = _mm256_sub_ps(pc, _mm256_mul_ps(z, half));
+        pc = _mm256_add_ps(pc, one);
+
+        __m256 ps = _mm256_set1_ps(-1.9515295891e-4f);
+        ps = _mm256_add_ps(_mm256_mul_ps(ps, z), _mm256_set1_ps(8.3321608736e-3f));
+        ps = _mm256_add_ps(_mm256_mul_ps(ps, z), _mm256_set1_ps(-1.6666654611e-1f));
+        ps = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(ps, z), x), x);
+
+        *outSin = _mm256_xor_ps(_mm256_blendv_ps(pc, ps, polyMask), sinSign);
+        *outCos = _mm256_xor_ps(_mm256_blendv_ps(ps, pc, polyMask), cosSign);
+    }
+
+    inline __m256 Sin8(__m256 x)
+    {
+        __m256 s, c;
+        SinCos8(x, &s, &c);
+        return s;
+    }
+
+    inline __m256 Cos8(__m256 x)
+    {
+        __m256 s, c;
+        SinCos8(x, &s, &c);
+        return c;
+    }
+
+    inline __m256 InvSqrt8(__m256 x)
+    {
+        __m256 y = _mm256_rsqrt_ps(x);
+        __m256 xyy = _mm256_mul_ps(_mm256_mul_ps(x, y), y);
+        return _mm256_mul_ps(y, _mm256_sub_ps(_mm256_set1_ps(1.5f), _mm256_mul_ps(_mm256_set1_ps(0.5f), xyy)));
+    }
+
+    inline __m256 Sqrt8(__m256 x)
+    {
+        __m256 positive = _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_GT_OQ);
+        return _mm256_and_ps(positive, _mm256_mul_ps(x, InvSqrt8(x)));
+    }
+
+    inline __m256 Atan2_8(__m256 y, __m256 x)
+    {
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+        const __m256 zero = _mm256_setzero_ps();
+        __m256 ax = _mm256_andnot_ps(signMask, x);
+        __m256 ay = _mm256_andnot_ps(signMask, y);
+        __m256 mx = _mm256_max_ps(ax, ay);
+        __m256 a = _mm256_div_ps(_mm256_min_ps(ax, ay), mx);
+        a = _mm256_and_ps(a, _mm256_cmp_ps(mx, zero, _CMP_GT_OQ)); // 0/0 -> 0
+        __m256 s = _mm256_mul_ps(a, a);
+
+        __m256 r = _mm256_set1_ps(-1.172120e-2f);
+        r = _mm256_add_ps(_mm256_mul_ps(r, s), _mm256_set1_ps(5.265332e-2f));
+        r = _mm256_add_ps(_mm256_mul_ps(r, s), _mm256_set1_ps(-1.1643287e-1f));
+        r = _mm256_add_ps(_mm256_mul_ps(r, s), _mm256_set1_ps(1.9354346e-1f));
+        r = _mm256_add_ps(_mm256_mul_ps(r, s), _mm256_set1_ps(-3.3262347e-1f));
+        r = _mm256_mul_ps(r, s);
+        r = _mm256_add_ps(_mm256_mul_ps(r, a), _mm256_mul_ps(_mm256_set1_ps(9.9997726e-1f), a));
+
+        r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(HALF_PI), r), _mm256_cmp_ps(ay, ax, _CMP_GT_OQ));
+        r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(PI), r), _mm256_cmp_ps(x, zero, _CMP_LT_OQ));
+        return _mm256_xor_ps(r, _mm256_and_ps(_mm256_cmp_ps(y, zero, _CMP_LT_OQ), signMask));
+    }
+#endif
+
+    // ======================================================================
+    // 数组版本：AVX 下每次 8 个，SSE 下每次 4 个，尾部走标量（out 可与 in 相同）
+    // ======================================================================
+    void Sin(const float *in, float *out, size_t count);
+    void Cos(const float *in, float *out, size_t count);
+    void SinCos(const float *in, float *outSin, float *outCos, size_t count);
+    void InvSqrt(const float *in, float *out, size_t count);
+    void Sqrt(const float *in, float *out, size_t count);
+    void Atan2(const float *y, const float *x, float *out, size_t count);
+}
+}
+
+#endif // __FAST_MATH_H__
@@ -0,0 +1,123 @@
+// ======================================================================
+#ifndef __FRUSTUM_H__
+#define __FRUSTUM_H__
+// ======================================================================
+
+#include <cstdint>
+#include "Math/AABB.h"
+#include "Math/Matrix4.h"
+#include "Math/Vector4.h"
+// ======================================================================
+
+// 视锥体：6 个平面 (nx, ny, nz, d)，法线指向内部，n·p + d >= 0 的点在平面内侧
+class Frustum
+{
+public:
+    enum PlaneIndex
+    {
+        Left,
+        Right,
+        Bottom,
+        Top,
+        Near,
+        Far,
+        PlaneCount
+    };
+
+    // 层级剔除用的平面掩码：第 i 位为 1 表示还需要对平面 i 测试
+    static const uint32_t ALL_PLANES = (1u << PlaneCount) - 1;
+
+    // 包围体与视锥体的关系
+    enum Result
+    {
+        Outside,
+        Intersecting,
+        Inside
+    };
+
+    Vector4 planes[PlaneCount];
+
+    Frustum() = default;
+
+    // 从 投影 * 视图 矩阵提取平面（列向量约定，OpenGL 裁剪空间 z ∈ [-w, w]），平面已归一化
+    static Frustum FromMatrix(const Matrix4 &viewProjection)
+    {
+        const Matrix4 &m = viewProjection;
+        Vector4 row0(m(0, 0), m(0, 1), m(0, 2), m(0, 3));
+        Vector4 row1(m(1, 0), m(1, 1), m(1, 2), m(1, 3));
+        Vector4 row2(m(2, 0), m(2, 1), m(2, 2), m(2, 3));
+        Vector4 row3(m(3, 0), m(3, 1), m(3, 2), m(3, 3));
+
+        Frustum frustum;
+        frustum.planes[Left] = row3 + row0;
+        frustum.planes[Right] = row3 - row0;
+        frustum.planes[Bottom] = row3 + row1;
+        frustum.planes[Top] = row3 - row1;
+        frustum.planes[Near] = row3 + row2;
+        frustum.planes[Far] = row3 - row2;
+        for (int i = 0; i < PlaneCount; ++i)
+        {
+            Vector4 &p = frustum.planes[i];
+            float length = sqrtf(p.x * p.x + p.y * p.y + p.z * p.z);
+            if (length > Math::EPSILON)
+                p = p * (1.0f / length);
+        }
+        return frustum;
+    }
+
+    float Distance(int plane, const Vector3 &point) const
+    {
+        const Vector4 &p = planes[plane];
+        return p.x * point.x + p.y * point.y + p.z * point.z + p.w;
+    }
+
+    bool Contains(const Vector3 &point) const
+    {
+        for (int i = 0; i < PlaneCount; ++i)
+        {
+            if (Distance(i, point) < 0.0f)
+                return false;
+        }
+        return true;
+    }
+
+    // 保守测试：可能把视锥角外侧附近的包围体判为相交，不会漏掉可见的
+    bool Intersects(const Vector3 &center, float radius) const
+    {
+        for (int i = 0; i < PlaneCount; ++i)
+        {
+            if (Distance(i, center) < -radius)
+                return false;
+        }
+        return true;
+    }
+
+    bool Intersects(const AABB &box) const
+    {
+        uint32_t mask = ALL_PLANES;
+        return Classify(box, mask) != Outside;
+    }
+
+    // 分类并更新平面掩码：包围盒完全在某个平面内侧时清除该位，子节点不再对它测试
+    Result Classify(const AABB &box, uint32_t &mask) const
+    {
+        Vector3 center = box.GetCenter();
+        Vector3 extents = box.GetExtents();
+        for (int i = 0; i < PlaneCount; ++i)
+        {
+            if (!(mask & (1u << i)))
+                continue;
+            const Vector4 &p = planes[i];
+            // 中心到平面的距离与包围盒在法线方向上的投影半径
+            float d = p.x * center.x + p.y * center.y + p.z * center.z + p.w;
+            float r = fabsf(p.x) * extents.x + fabsf(p.y) * extents.y + fabsf(p.z) * extents.z;
+            if (d < -r)
+                return Outside;
+            if (d >= r)
+                mask &= ~(1u << i);
+        }
+        return mask == 0 ? Inside : Intersecting;
+    }
+};
+
+#endif // __FRUSTUM_H__
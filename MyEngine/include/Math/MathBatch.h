@@ -0,0 +1,111 @@
+// ======================================================================
+#ifndef __MATH_BATCH_H__
+#define __MATH_BATCH_H__
+// ======================================================================
+
+#include <vector>
+#include <functional>
+#include "Math/Vector3.h"
+#include "Math/Matrix4.h"
+#include "Math/AABB.h"
+#include "Math/Frustum.h"
+// ======================================================================
+
+// 批量变换接口：一次处理一段连续数据，代替逐个 Matrix4 * Vector3
+// - AoS: Vector3 数组，内部每 4 个点转置成 SoA 后用 SIMD 计算
+// - SoA: Vector3SoA，x/y/z 分别连续存放，直接按 4/8 路向量化
+// - 数量超过 PARALLEL_THRESHOLD 时自动按区间拆分到多线程
+// 点变换按仿射矩阵处理（w = 1，不做透视除法），投影矩阵请逐个用 Matrix4::operator*
+namespace Math
+{
+namespace Batch
+{
+    // ======================================================================
+    // SoA 存储
+    // ======================================================================
+    struct Vector3SoA
+    {
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> z;
+
+        size_t Size() const { return x.size(); }
+
+        void Resize(size_t count)
+        {
+            x.resize(count);
+            y.resize(count);
+            z.resize(count);
+        }
+
+        void Set(size_t index, const Vector3 &v)
+        {
+            x[index] = v.x;
+            y[index] = v.y;
+            z[index] = v.z;
+        }
+
+        Vector3 Get(size_t index) const
+        {
+            return Vector3(x[index], y[index], z[index]);
+        }
+
+        void FromAoS(const Vector3 *src, size_t count);
+        void ToAoS(Vector3 *dst) const;
+    };
+
+    // ======================================================================
+    // 并行拆分
+    // ======================================================================
+    // 处理 [begin, end) 区间
+    typedef std::function<void(size_t begin, size_t end)> RangeFunc;
+    // 执行器：把 [0, count) 按不小于 grain 的粒度拆分后调用 func，返回前必须全部完成
+    typedef std::function<void(size_t count, size_t grain, const RangeFunc &func)> ParallelExecutor;
+
+    // 超过该数量才拆分到多线程（更小的批次线程开销大于收益）
+    const size_t PARALLEL_THRESHOLD = 16384;
+
+    // 安装执行器（如引擎任务系统）；传空则恢复为默认的 std::thread 拆分
+    void SetParallelExecutor(const ParallelExecutor &executor);
+    void ParallelFor(size_t count, size_t grain, const RangeFunc &func);
+    // 数量达到 PARALLEL_THRESHOLD 才走 ParallelFor，否则在当前线程执行
+    void Dispatch(size_t count, const RangeFunc &func);
+
+    // ======================================================================
+    // AoS 变换（in 与 out 可以是同一数组）
+    // ======================================================================
+    void TransformPoints(const Matrix4 &m, const Vector3 *in, Vector3 *out, size_t count);
+    void TransformDirections(const Matrix4 &m, const Vector3 *in, Vector3 *out, size_t count);
+    // 法线：使用左上 3x3 的逆转置并重新归一化，支持非均匀缩放
+    void TransformNormals(const Matrix4 &m, const Vector3 *in, Vector3 *out, size_t count);
+
+    // ======================================================================
+    // SoA 变换（out 会被调整为与 in 相同大小，可与 in 为同一对象）
+    // ======================================================================
+    void TransformPoints(const Matrix4 &m, const Vector3SoA &in, Vector3SoA &out);
+    void TransformDirections(const Matrix4 &m, const Vector3SoA &in, Vector3SoA &out);
+    void TransformNormals(const Matrix4 &m, const Vector3SoA &in, Vector3SoA &out);
+
+    // ======================================================================
+    // 包围盒
+    // ======================================================================
+    // 变换后的轴对齐包围盒（中心 + |M| * 半长，Arvo 方法）
+    AABB TransformAABB(const Matrix4 &m, const AABB &box);
+    void TransformAABBs(const Matrix4 &m, const AABB *in, AABB *out, size_t count);
+    // 点集包围盒
+    AABB ComputeBounds(const Vector3 *points, size_t count);
+    AABB ComputeBounds(const Vector3SoA &points);
+
+    // ======================================================================
+    // 视锥剔除：结果与 Frustum::Intersects 逐个测试一致（保守，不会剔除可见的）
+    // ======================================================================
+    // visible[i] = 1 表示球 (centers[i], radii[i]) 可能可见，0 表示完全在某个平面外侧；返回可见数量
+    // SoA 中心按 4/8 个球一组对 6 个平面测试
+    size_t CullSpheres(const Frustum &frustum, const Vector3SoA &centers, const float *radii, uint8_t *visible);
+    // visible[i] = 1 表示 boxes[i] 可能可见；返回可见数量
+    // 每个包围盒一次对全部平面测试（平面按 SoA 排列，补齐的平面恒在内侧）
+    size_t CullAABBs(const Frustum &frustum, const AABB *boxes, size_t count, uint8_t *visible);
+}
+}
+
+#endif // __MATH_BATCH_H__
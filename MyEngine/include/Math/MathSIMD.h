@@ -0,0 +1,490 @@
+// ======================================================================
+#ifndef __MATH_SIMD_H__
+#define __MATH_SIMD_H__
+// ======================================================================
+// SIMD 路径选择（编译期）
+//   MATH_FORCE_SCALAR      : 强制使用标量实现（调试/对比用）
+//   __AVX__                : AVX 路径（同时启用 SSE）
+//   __SSE2__ / _M_X64 / _M_IX86_FP >= 2 : SSE 路径
+// 其余平台自动回退到标量实现
+//
+// 精度约定:
+//   SIMD 与标量路径的累加顺序完全一致 ((a0*b0 + a1*b1) + a2*b2) + a3*b3，
+//   差异只来自编译器的 FMA 收缩，相对误差不超过 MATH_SIMD_EPSILON
+// ======================================================================
+
+#if !defined(MATH_FORCE_SCALAR)
+#if defined(__AVX__)
+#define MATH_SIMD_AVX 1
+#define MATH_SIMD_SSE 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MATH_SIMD_SSE 1
+#endif
+#endif
+
+#if defined(MATH_SIMD_AVX)
+#include <immintrin.h>
+#elif defined(MATH_SIMD_SSE)
+#include <emmintrin.h>
+#endif
+
+// SIMD 与标量结果允许的最大相对误差
+#define MATH_SIMD_EPSILON 1e-5f
+
+// ======================================================================
+namespace Math
+{
+namespace SIMD
+{
+    // 当前编译选用的路径名称（基准测试/日志用）
+    inline const char *PathName()
+    {
+#if defined(MATH_SIMD_AVX)
+        return "AVX";
+#elif defined(MATH_SIMD_SSE)
+        return "SSE";
+#else
+        return "Scalar";
+#endif
+    }
+
+    // ======================================================================
+    // 4x4 矩阵乘法 out = a * b（列优先，out 可与 a/b 重叠）
+    // ======================================================================
+    inline void MulMatrix4_Scalar(const float *a, const float *b, float *out)
+    {
+        float r[16];
+        for (int c = 0; c < 4; ++c)
+        {
+            const float *bc = b + c * 4;
+            for (int row = 0; row < 4; ++row)
+            {
+                r[c * 4 + row] = a[row] * bc[0] + a[4 + row] * bc[1] + a[8 + row] * bc[2] + a[12 + row] * bc[3];
+            }
+        }
+        for (int i = 0; i < 16; ++i)
+            out[i] = r[i];
+    }
+
+    inline void MulMatrix4(const float *a, const float *b, float *out)
+    {
+#if defined(MATH_SIMD_AVX)
+        // 两列一组：每个 128 位通道内广播 b 的同一行元素
+        __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a + 0));
+        __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a + 4));
+        __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a + 8));
+        __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a + 12));
+
+        __m256 b01 = _mm256_loadu_ps(b + 0);
+        __m256 b23 = _mm256_loadu_ps(b + 8);
+
+        __m256 r01 = _mm256_mul_ps(a0, _mm256_shuffle_ps(b01, b01, 0x00));
+        r01 = _mm256_add_ps(r01, _mm256_mul_ps(a1, _mm256_shuffle_ps(b01, b01, 0x55)));
+        r01 = _mm256_add_ps(r01, _mm256_mul_ps(a2, _mm256_shuffle_ps(b01, b01, 0xAA)));
+        r01 = _mm256_add_ps(r01, _mm256_mul_ps(a3, _mm256_shuffle_ps(b01, b01, 0xFF)));
+
+        __m256 r23 = _mm256_mul_ps(a0, _mm256_shuffle_ps(b23, b23, 0x00));
+        r23 = _mm256_add_ps(r23, _mm256_mul_ps(a1, _mm256_shuffle_ps(b23, b23, 0x55)));
+        r23 = _mm256_add_ps(r23, _mm256_mul_ps(a2, _mm256_shuffle_ps(b23, b23, 0xAA)));
+        r23 = _mm256_add_ps(r23, _mm256_mul_ps(a3, _mm256_shuffle_ps(b23, b23, 0xFF)));
+
+        _mm256_storeu_ps(out + 0, r01);
+        _mm256_storeu_ps(out + 8, r23);
+#elif defined(MATH_SIMD_SSE)
+        // 结果第 c 列 = a 的四列按 b 第 c 列的分量线性组合
+        __m128 a0 = _mm_loadu_ps(a + 0);
+        __m128 a1 = _mm_loadu_ps(a + 4);
+        __m128 a2 = _mm_loadu_ps(a + 8);
+        __m128 a3 = _mm_loadu_ps(a + 12);
+
+        __m128 r[4];
+        for (int c = 0; c < 4; ++c)
+        {
+            __m128 bc = _mm_loadu_ps(b + c * 4);
+            __m128 v = _mm_mul_ps(a0, _mm_shuffle_ps(bc, bc, 0x00));
+            v = _mm_add_ps(v, _mm_mul_ps(a1, _mm_shuffle_ps(bc, bc, 0x55)));
+            v = _mm_add_ps(v, _mm_mul_ps(a2, _mm_shuffle_ps(bc, bc, 0xAA)));
+            v = _mm_add_ps(v, _mm_mul_ps(a3, _mm_shuffle_ps(bc, bc, 0xFF)));
+            r[c] = v;
+        }
+        _mm_storeu_ps(out + 0, r[0]);
+        _mm_storeu_ps(out + 4, r[1]);
+        _mm_storeu_ps(out + 8, r[2]);
+        _mm_storeu_ps(out + 12, r[3]);
+#else
+        MulMatrix4_Scalar(a, b, out);
+#endif
+    }
+
+    // ======================================================================
+    // 4 分量变换 out = m * v（列优先，out 可与 v 重叠）
+    // ======================================================================
+    inline void TransformVec4_Scalar(const float *m, const float *v, float *out)
+    {
+        float x = v[0], y = v[1], z = v[2], w = v[3];
+        for (int row = 0; row < 4; ++row)
+            out[row] = m[row] * x + m[4 + row] * y + m[8 + row] * z + m[12 + row] * w;
+    }
+
+    inline void TransformVec4(const float *m, const float *v, float *out)
+    {
+#if defined(MATH_SIMD_SSE)
+        __m128 vv = _mm_loadu_ps(v);
+        __m128 r = _mm_mul_ps(_mm_loadu_ps(m + 0), _mm_shuffle_ps(vv, vv, 0x00));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m + 4), _mm_shuffle_ps(vv, vv, 0x55)));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m + 8), _mm_shuffle_ps(vv, vv, 0xAA)));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m + 12), _mm_shuffle_ps(vv, vv, 0xFF)));
+        _mm_storeu_ps(out, r);
+#else
+        TransformVec4_Scalar(m, v, out);
+#endif
+    }
+
+    // ======================================================================
+    // TRS 合成 out = T * R(q) * S，直接写出闭式结果，省去两次矩阵乘法
+    // q 按 (x, y, z, w) 排列
+    // ======================================================================
+    inline void ComposeTRS_Scalar(const float *t, const float *q, const float *s, float *out)
+    {
+        float xx = q[0] * q[0], yy = q[1] * q[1], zz = q[2] * q[2];
+        float xy = q[0] * q[1], xz = q[0] * q[2], yz = q[1] * q[2];
+        float wx = q[3] * q[0], wy = q[3] * q[1], wz = q[3] * q[2];
+
+        out[0] = (1.0f - 2.0f * (yy + zz)) * s[0];
+        out[1] = (2.0f * (xy + wz)) * s[0];
+        out[2] = (2.0f * (xz - wy)) * s[0];
+        out[3] = 0.0f;
+
+        out[4] = (2.0f * (xy - wz)) * s[1];
+        out[5] = (1.0f - 2.0f * (xx + zz)) * s[1];
+        out[6] = (2.0f * (yz + wx)) * s[1];
+        out[7] = 0.0f;
+
+        out[8] = (2.0f * (xz + wy)) * s[2];
+        out[9] = (2.0f * (yz - wx)) * s[2];
+        out[10] = (1.0f - 2.0f * (xx + yy)) * s[2];
+        out[11] = 0.0f;
+
+        out[12] = t[0];
+        out[13] = t[1];
+        out[14] = t[2];
+        out[15] = 1.0f;
+    }
+
+    inline void ComposeTRS(const float *t, const float *q, const float *s, float *out)
+    {
+#if defined(MATH_SIMD_SSE)
+        // 旋转矩阵三列先按标量算出，缩放与写回向量化
+        float xx = q[0] * q[0], yy = q[1] * q[1], zz = q[2] * q[2];
+        float xy = q[0] * q[1], xz = q[0] * q[2], yz = q[1] * q[2];
+        float wx = q[3] * q[0], wy = q[3] * q[1], wz = q[3] * q[2];
+
+        __m128 c0 = _mm_setr_ps(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy), 0.0f);
+        __m128 c1 = _mm_setr_ps(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx), 0.0f);
+        __m128 c2 = _mm_setr_ps(2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy), 0.0f);
+
+        _mm_storeu_ps(out + 0, _mm_mul_ps(c0, _mm_set1_ps(s[0])));
+        _mm_storeu_ps(out + 4, _mm_mul_ps(c1, _mm_set1_ps(s[1])));
+        _mm_storeu_ps(out + 8, _mm_mul_ps(c2, _mm_set1_ps(s[2])));
+        _mm_storeu_ps(out + 12, _mm_setr_ps(t[0], t[1], t[2], 1.0f));
+#else
+        ComposeTRS_Scalar(t, q, s, out);
+#endif
+    }
+
+    // ======================================================================
+    // 4x4 通用逆矩阵 out = m^-1，返回行列式（为 0 时不写 out）
+    // 由于 (M^T)^-1 = (M^-1)^T，同一套公式对行/列优先存储都成立
+    // ======================================================================
+    inline float InverseMatrix4_Scalar(const float *a, float *out)
+    {
+        float s0 = a[0] * a[5] - a[4] * a[1];
+        float s1 = a[0] * a[6] - a[4] * a[2];
+        float s2 = a[0] * a[7] - a[4] * a[3];
+        float s3 = a[1] * a[6] - a[5] * a[2];
+        float s4 = a[1] * a[7] - a[5] * a[3];
+        float s5 = a[2] * a[7] - a[6] * a[3];
+
+        float c5 = a[10] * a[15] - a[14] * a[11];
+        float c4 = a[9] * a[15] - a[13] * a[11];
+        float c3 = a[9] * a[14] - a[13] * a[10];
+        float c2 = a[8] * a[15] - a[12] * a[11];
+        float c1 = a[8] * a[14] - a[12] * a[10];
+        float c0 = a[8] * a[13] - a[12] * a[9];
+
+        float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        if (det == 0.0f)
+            return 0.0f;
+        float invDet = 1.0f / det;
+
+        float r[16];
+        r[0] = (a[5] * c5 - a[6] * c4 + a[7] * c3) * invDet;
+        r[1] = (-a[1] * c5 + a[2] * c4 - a[3] * c3) * invDet;
+        r[2] = (a[13] * s5 - a[14] * s4 + a[15] * s3) * invDet;
+        r[3] = (-a[9] * s5 + a[10] * s4 - a[11] * s3) * invDet;
+
+        r[4] = (-a[4] * c5 + a[6] * c2 - a[7] * c1) * invDet;
+        r[5] = (a[0] * c5 - a[2] * c2 + a[3] * c1) * invDet;
+        r[6] = (-a[12] * s5 + a[14] * s2 - a[15] * s1) * invDet;
+        r[7] = (a[8] * s5 - a[10] * s2 + a[11] * s1) * invDet;
+
+        r[8] = (a[4] * c4 - a[5] * c2 + a[7] * c0) * invDet;
+        r[9] = (-a[0] * c4 + a[1] * c2 - a[3] * c0) * invDet;
+        r[10] = (a[12] * s4 - a[13] * s2 + a[15] * s0) * invDet;
+        r[11] = (-a[8] * s4 + a[9] * s2 - a[11] * s0) * invDet;
+
+        r[12] = (-a[4] * c3 + a[5] * c1 - a[6] * c0) * invDet;
+        r[13] = (a[0] * c3 - a[1] * c1 + a[2] * c0) * invDet;
+        r[14] = (-a[12] * s3 + a[13] * s1 - a[14] * s0) * invDet;
+        r[15] = (a[8] * s3 - a[9] * s1 + a[10] * s0) * invDet;
+
+        for (int i = 0; i < 16; ++i)
+            out[i] = r[i];
+        return det;
+    }
+
+#if defined(MATH_SIMD_SSE)
+    // 2x2 分块辅助：每个 __m128 存一个 2x2 矩阵 (x y / z w)
+    // A * B
+    inline __m128 Mat2Mul(__m128 a, __m128 b)
+    {
+        return _mm_add_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 3, 0))),
+                          _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+    }
+
+    // adj(A) * B
+    inline __m128 Mat2AdjMul(__m128 a, __m128 b)
+    {
+        return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+                          _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+    }
+
+    // A * adj(B)
+    inline __m128 Mat2MulAdj(__m128 a, __m128 b)
+    {
+        return _mm_sub_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 0, 3))),
+                          _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+    }
+#endif
+
+    inline float InverseMatrix4(const float *m, float *out)
+    {
+#if defined(MATH_SIMD_SSE)
+        // 2x2 分块求逆：M = | A B |, M^-1 = 1/|M| * | X Y |
+        //                   | C D |                 | Z W |
+        __m128 v0 = _mm_loadu_ps(m + 0);
+        __m128 v1 = _mm_loadu_ps(m + 4);
+        __m128 v2 = _mm_loadu_ps(m + 8);
+        __m128 v3 = _mm_loadu_ps(m + 12);
+
+        __m128 A = _mm_movelh_ps(v0, v1);
+        __m128 B = _mm_movehl_ps(v1, v0);
+        __m128 C = _mm_movelh_ps(v2, v3);
+        __m128 D = _mm_movehl_ps(v3, v2);
+
+        // (|A| |B| |C| |D|)
+        __m128 detSub = _mm_sub_ps(
+            _mm_mul_ps(_mm_shuffle_ps(v0, v2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(v1, v3, _MM_SHUFFLE(3, 1, 3, 1))),
+            _mm_mul_ps(_mm_shuffle_ps(v0, v2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(v1, v3, _MM_SHUFFLE(2, 0, 2, 0))));
+        __m128 detA = _mm_shuffle_ps(detSub, detSub, 0x00);
+        __m128 detB = _mm_shuffle_ps(detSub, detSub, 0x55);
+        __m128 detC = _mm_shuffle_ps(detSub, detSub, 0xAA);
+        __m128 detD = _mm_shuffle_ps(detSub, detSub, 0xFF);
+
+        __m128 D_C = Mat2AdjMul(D, C);
+        __m128 A_B = Mat2AdjMul(A, B);
+        __m128 X_ = _mm_sub_ps(_mm_mul_ps(detD, A), Mat2Mul(B, D_C));
+        __m128 W_ = _mm_sub_ps(_mm_mul_ps(detA, D), Mat2Mul(C, A_B));
+        __m128 Y_ = _mm_sub_ps(_mm_mul_ps(detB, C), Mat2MulAdj(D, A_B));
+        __m128 Z_ = _mm_sub_ps(_mm_mul_ps(detC, B), Mat2MulAdj(A, D_C));
+
+        // |M| = |A||D| + |B||C| - tr(adj(A)B * adj(D)C)
+        __m128 tr = _mm_mul_ps(A_B, _mm_shuffle_ps(D_C, D_C, _MM_SHUFFLE(3, 1, 2, 0)));
+        tr = _mm_add_ps(tr, _mm_shuffle_ps(tr, tr, _MM_SHUFFLE(2, 3, 0, 1)));
+        tr = _mm_add_ps(tr, _mm_shuffle_ps(tr, tr, _MM_SHUFFLE(1, 0, 3, 2)));
+        __m128 detM = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), tr);
+
+        float det = _mm_cvtss_f32(detM);
+        if (det == 0.0f)
+            return 0.0f;
+
+        __m128 rDetM = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM);
+        X_ = _mm_mul_ps(X_, rDetM);
+        Y_ = _mm_mul_ps(Y_, rDetM);
+        Z_ = _mm_mul_ps(Z_, rDetM);
+        W_ = _mm_mul_ps(W_, rDetM);
+
+        // 伴随矩阵重排与写回合并为一次 shuffle
+        _mm_storeu_ps(out + 0, _mm_shuffle_ps(X_, Y_, _MM_SHUFFLE(1, 3, 1, 3)));
+        _mm_storeu_ps(out + 4, _mm_shuffle_ps(X_, Y_, _MM_SHUFFLE(0, 2, 0, 2)));
+        _mm_storeu_ps(out + 8, _mm_shuffle_ps(Z_, W_, _MM_SHUFFLE(1, 3, 1, 3)));
+        _mm_storeu_ps(out + 12, _mm_shuffle_ps(Z_, W_, _MM_SHUFFLE(0, 2, 0, 2)));
+        return det;
+#else
+        return InverseMatrix4_Scalar(m, out);
+#endif
+    }
+
+    // ======================================================================
+    // 仿射逆矩阵（最后一行为 0 0 0 1，适用于刚体/TRS/含切变的仿射矩阵）
+    // M = | L t |  =>  M^-1 = | L^-1  -L^-1 t |
+    //     | 0 1 |             | 0      1      |
+    // L^-1 的三行分别为 (c1 x c2, c2 x c0, c0 x c1) / det(L)，返回 det(L)
+    // ======================================================================
+    inline float InverseAffine_Scalar(const float *m, float *out)
+    {
+        const float *c0 = m + 0;
+        const float *c1 = m + 4;
+        const float *c2 = m + 8;
+
+        float r0[3] = {c1[1] * c2[2] - c1[2] * c2[1], c1[2] * c2[0] - c1[0] * c2[2], c1[0] * c2[1] - c1[1] * c2[0]};
+        float r1[3] = {c2[1] * c0[2] - c2[2] * c0[1], c2[2] * c0[0] - c2[0] * c0[2], c2[0] * c0[1] - c2[1] * c0[0]};
+        float r2[3] = {c0[1] * c1[2] - c0[2] * c1[1], c0[2] * c1[0] - c0[0] * c1[2], c0[0] * c1[1] - c0[1] * c1[0]};
+
+        float det = c0[0] * r0[0] + c0[1] * r0[1] + c0[2] * r0[2];
+        if (det == 0.0f)
+            return 0.0f;
+        float invDet = 1.0f / det;
+        float tx = m[12], ty = m[13], tz = m[14];
+
+        // 列优先写回：第 j 列为 (r0[j], r1[j], r2[j])
+        for (int j = 0; j < 3; ++j)
+        {
+            out[j * 4 + 0] = r0[j] * invDet;
+            out[j * 4 + 1] = r1[j] * invDet;
+            out[j * 4 + 2] = r2[j] * invDet;
+            out[j * 4 + 3] = 0.0f;
+        }
+        out[12] = -(out[0] * tx + out[4] * ty + out[8] * tz);
+        out[13] = -(out[1] * tx + out[5] * ty + out[9] * tz);
+        out[14] = -(out[2] * tx + out[6] * ty + out[10] * tz);
+        out[15] = 1.0f;
+        return det;
+    }
+
+    inline float InverseAffine(const float *m, float *out)
+    {
+#if defined(MATH_SIMD_SSE)
+        __m128 c0 = _mm_loadu_ps(m + 0);
+        __m128 c1 = _mm_loadu_ps(m + 4);
+        __m128 c2 = _mm_loadu_ps(m + 8);
+        __m128 t = _mm_loadu_ps(m + 12);
+
+        // cross(a, b) = a.yzx * b.zxy - a.zxy * b.yzx
+        __m128 c0_yzx = _mm_shuffle_ps(c0, c0, _MM_SHUFFLE(3, 0, 2, 1));
+        __m128 c1_yzx = _mm_shuffle_ps(c1, c1, _MM_SHUFFLE(3, 0, 2, 1));
+        __m128 c2_yzx = _mm_shuffle_ps(c2, c2, _MM_SHUFFLE(3, 0, 2, 1));
+        __m128 r0 = _mm_sub_ps(_mm_mul_ps(c1, c2_yzx), _mm_mul_ps(c1_yzx, c2));
+        __m128 r1 = _mm_sub_ps(_mm_mul_ps(c2, c0_yzx), _mm_mul_ps(c2_yzx, c0));
+        __m128 r2 = _mm_sub_ps(_mm_mul_ps(c0, c1_yzx), _mm_mul_ps(c0_yzx, c1));
+        r0 = _mm_shuffle_ps(r0, r0, _MM_SHUFFLE(3, 0, 2, 1));
+        r1 = _mm_shuffle_ps(r1, r1, _MM_SHUFFLE(3, 0, 2, 1));
+        r2 = _mm_shuffle_ps(r2, r2, _MM_SHUFFLE(3, 0, 2, 1));
+
+        __m128 d = _mm_mul_ps(c0, r0);
+        float det = _mm_cvtss_f32(d) + _mm_cvtss_f32(_mm_shuffle_ps(d, d, 0x55)) + _mm_cvtss_f32(_mm_shuffle_ps(d, d, 0xAA));
+        if (det == 0.0f)
+            return 0.0f;
+        __m128 invDet = _mm_set1_ps(1.0f / det);
+        r0 = _mm_mul_ps(r0, invDet);
+        r1 = _mm_mul_ps(r1, invDet);
+        r2 = _mm_mul_ps(r2, invDet);
+
+        // r0/r1/r2 为 L^-1 的行，转置成列（第 4 分量清零）
+        __m128 zero = _mm_setzero_ps();
+        __m128 lo01 = _mm_unpacklo_ps(r0, r1); // r0x r1x r0y r1y
+        __m128 hi01 = _mm_unpackhi_ps(r0, r1); // r0z r1z r0w r1w
+        __m128 lo2z = _mm_unpacklo_ps(r2, zero); // r2x 0 r2y 0
+        __m128 hi2z = _mm_unpackhi_ps(r2, zero); // r2z 0 r2w 0
+        __m128 o0 = _mm_movelh_ps(lo01, lo2z);
+        __m128 o1 = _mm_movehl_ps(lo2z, lo01);
+        __m128 o2 = _mm_movelh_ps(hi01, hi2z);
+
+        __m128 o3 = _mm_mul_ps(o0, _mm_shuffle_ps(t, t, 0x00));
+        o3 = _mm_add_ps(o3, _mm_mul_ps(o1, _mm_shuffle_ps(t, t, 0x55)));
+        o3 = _mm_add_ps(o3, _mm_mul_ps(o2, _mm_shuffle_ps(t, t, 0xAA)));
+        o3 = _mm_sub_ps(_mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f), o3);
+
+        _mm_storeu_ps(out + 0, o0);
+        _mm_storeu_ps(out + 4, o1);
+        _mm_storeu_ps(out + 8, o2);
+        _mm_storeu_ps(out + 12, o3);
+        return det;
+#else
+        return InverseAffine_Scalar(m, out);
+#endif
+    }
+
+#if defined(MATH_SIMD_SSE)
+    // ======================================================================
+    // 4 路 sin/cos（Cephes 单精度多项式，π/4 象限规约）
+    // |x| < 8192 时与 sinf/cosf 的误差在 1e-6 量级
+    // ======================================================================
+    inline void SinCos4(__m128 x, __m128 *outSin, __m128 *outCos)
+    {
+        const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000));
+        __m128 sinSign = _mm_and_ps(x, signMask);
+        x = _mm_andnot_ps(signMask, x);
+
+        // j = (int)(|x| * 4/π) 向上取偶，y 为对应的 π/4 倍数
+        __m128i j = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.27323954473516f)));
+        j = _mm_and_si128(_mm_add_epi32(j, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+        __m128 y = _mm_cvtepi32_ps(j);
+
+        // 象限决定符号以及 sin/cos 多项式是否互换
+        __m128 swapSinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, _mm_set1_epi32(4)), 29));
+        __m128 polyMask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, _mm_set1_epi32(2)), _mm_setzero_si128()));
+        __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(j, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+        sinSign = _mm_xor_ps(sinSign, swapSinSign);
+
+        // 扩展精度规约 x = |x| - y * π/4
+        x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-0.78515625f)));
+        x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-2.4187564849853515625e-4f)));
+        x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-3.77489497744594108e-8f)));
+        __m128 z = _mm_mul_ps(x, x);
+
+        // cos 多项式 [0, π/4]
+        __m128 pc = _mm_set1_ps(2.443315711809948e-5f);
+        pc = _mm_add_ps(_mm_mul_ps(pc, z), _mm_set1_ps(-1.388731625493765e-3f));
+        pc = _mm_add_ps(_mm_mul_ps(pc, z), _mm_set1_ps(4.166664568298827e-2f));
+        pc = _mm_mul_ps(_mm_mul_ps(pc, z), z);
+        pc = _mm_sub_ps(pc, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+        pc = _mm_add_ps(pc, _mm_set1_ps(1.0f));
+
+        // sin 多项式 [0, π/4]
+        __m128 ps = _mm_set1_ps(-1.9515295891e-4f);
+        ps = _mm_add_ps(_mm_mul_ps(ps, z), _mm_set1_ps(8.3321608736e-3f));
+        ps = _mm_add_ps(_mm_mul_ps(ps, z), _mm_set1_ps(-1.6666654611e-1f));
+        ps = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(ps, z), x), x);
+
+        __m128 sinVal = _mm_or_ps(_mm_and_ps(polyMask, ps), _mm_andnot_ps(polyMask, pc));
+        __m128 cosVal = _mm_or_ps(_mm_and_ps(polyMask, pc), _mm_andnot_ps(polyMask, ps));
+        *outSin = _mm_xor_ps(sinVal, sinSign);
+        *outCos = _mm_xor_ps(cosVal, cosSign);
+    }
+#endif
+
+    // ======================================================================
+    // 结果比较：|a - b| <= eps * max(1, |a|, |b|)
+    // ======================================================================
+    inline bool NearlyEqual(const float *a, const float *b, int count, float eps = MATH_SIMD_EPSILON)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            float fa = a[i] < 0 ? -a[i] : a[i];
+            float fb = b[i] < 0 ? -b[i] : b[i];
+            float scale = fa > fb ? fa : fb;
+            if (scale < 1.0f)
+                scale = 1.0f;
+            float diff = a[i] - b[i];
+            if (diff < 0)
+                diff = -diff;
+            if (diff > eps * scale)
+                return false;
+        }
+        return true;
+    }
+}
+}
+
+#endif // __MATH_SIMD_H__
@@ -13,47 +13,66 @@
 // ======================================================================
 #include <cmath>
 #include <limits>
-#include <random>
+// ======================================================================
+
+// 编译期计算支持：C++14 起 constexpr 函数允许局部变量与循环，
+// 数学类型的构造、常量与基础运算据此在编译期求值；旧编译器退化为普通 inline
+#if defined(_MSC_VER)
+#if _MSC_VER >= 1910 && _MSVC_LANG >= 201402L
+#define MATH_HAS_CONSTEXPR 1
+#endif
+#elif __cplusplus >= 201402L
+#define MATH_HAS_CONSTEXPR 1
+#endif
+
+#ifdef MATH_HAS_CONSTEXPR
+#define MATH_CONSTEXPR constexpr
+#define MATH_CONST constexpr
+#else
+#define MATH_HAS_CONSTEXPR 0
+#define MATH_CONSTEXPR inline
+#define MATH_CONST const
+#endif
 // ======================================================================
 
 namespace Math
 {
     // ======================================================================
     // 常数
-    const FLOAT PI = 3.14159265f;
+    MATH_CONST FLOAT PI = 3.14159265f;
     // const FLOAT PI = 3.14159265358979323846f;
     // const FLOAT TWO_PI = 2.0f * PI;
     // const FLOAT HALF_PI = 0.5f * PI;
-	const FLOAT TWO_PI = 6.2831853071f;
-	const FLOAT HALF_PI = 1.5707963267f;
-    const FLOAT DEG_TO_RAD = PI / 180.0f;
-    const FLOAT RAD_TO_DEG = 180.0f / PI;
+	MATH_CONST FLOAT TWO_PI = 6.2831853071f;
+	MATH_CONST FLOAT HALF_PI = 1.5707963267f;
+    MATH_CONST FLOAT DEG_TO_RAD = PI / 180.0f;
+    MATH_CONST FLOAT RAD_TO_DEG = 180.0f / PI;
 
-    const FLOAT EPSILON = 1e-6f;
-    const FLOAT FLOAT_MAX = std::numeric_limits<FLOAT>::max();
-    const FLOAT FLOAT_MIN = std::numeric_limits<FLOAT>::lowest();
+    MATH_CONST FLOAT EPSILON = 1e-6f;
+    MATH_CONST FLOAT FLOAT_MAX = std::numeric_limits<FLOAT>::max();
+    MATH_CONST FLOAT FLOAT_MIN = std::numeric_limits<FLOAT>::lowest();
 
     // ======================================================================
     // 基础运算
     // ======================================================================
     template <typename T>
-    inline T Abs(T value) { return value < 0 ? -value : value; }
+    MATH_CONSTEXPR T Abs(T value) { return value < 0 ? -value : value; }
 
     template <typename T>
-    inline T Min(T a, T b) { return a < b ? a : b; }
+    MATH_CONSTEXPR T Min(T a, T b) { return a < b ? a : b; }
 
     template <typename T>
-    inline T Max(T a, T b) { return a > b ? a : b; }
+    MATH_CONSTEXPR T Max(T a, T b) { return a > b ? a : b; }
 
     template <typename T>
-    inline T Clamp(T value, T min, T max)
+    MATH_CONSTEXPR T Clamp(T value, T min, T max)
     {
         return value < min ? min : (value > max ? max : value);
     }
 
     // 获取符号: 返回 -1 (负), 0 (零), 1 (正)
     template <typename T>
-    inline int Sign(T val)
+    MATH_CONSTEXPR int Sign(T val)
     {
         return (T(0) < val) - (val < T(0));
     }
@@ -61,20 +80,20 @@ namespace Math
     // ======================================================================
     // 插值与映射
     // ======================================================================
-    inline FLOAT Lerp(FLOAT a, FLOAT b, FLOAT t)
+    MATH_CONSTEXPR FLOAT Lerp(FLOAT a, FLOAT b, FLOAT t)
     {
         return a + t * (b - a);
     }
 
     // 平滑插值 (常用于相机跟随或平滑动画)
-    inline FLOAT SmoothStep(FLOAT edge0, FLOAT edge1, FLOAT x)
+    MATH_CONSTEXPR FLOAT SmoothStep(FLOAT edge0, FLOAT edge1, FLOAT x)
     {
         FLOAT t = Clamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f);
         return t * t * (3.0f - 2.0f * t);
     }
 
     // 将 value 从 [min1, max1] 映射到 [min2, max2]
-    inline FLOAT Map(FLOAT value, FLOAT min1, FLOAT max1, FLOAT min2, FLOAT max2)
+    MATH_CONSTEXPR FLOAT Map(FLOAT value, FLOAT min1, FLOAT max1, FLOAT min2, FLOAT max2)
     {
         return min2 + (value - min1) * (max2 - min2) / (max1 - min1);
     }
@@ -82,22 +101,22 @@ namespace Math
     // ======================================================================
     // 转换与比较
     // ======================================================================
-    inline FLOAT ToRadians(FLOAT degrees)
+    MATH_CONSTEXPR FLOAT ToRadians(FLOAT degrees)
     {
         return degrees * DEG_TO_RAD;
     }
 
-    inline FLOAT ToDegrees(FLOAT radians)
+    MATH_CONSTEXPR FLOAT ToDegrees(FLOAT radians)
     {
         return radians * RAD_TO_DEG;
     }
 
-    inline bool IsZero(FLOAT value)
+    MATH_CONSTEXPR bool IsZero(FLOAT value)
     {
         return Abs(value) < EPSILON;
     }
 
-    inline bool FloatEqual(FLOAT a, FLOAT b)
+    MATH_CONSTEXPR bool FloatEqual(FLOAT a, FLOAT b)
     {
         return Abs(a - b) < EPSILON;
     }
@@ -164,12 +183,8 @@ namespace Math
     // ======================================================================
     // 随机数
     // ======================================================================
-    inline FLOAT Random()
-    {
-        static std::mt19937 generator(std::random_device{}());
-        static std::uniform_real_distribution<FLOAT> distribution(0.0f, 1.0f);
-        return distribution(generator);
-    }
+    // 当前线程默认流的 [0, 1) 均匀分布（xoshiro128+，种子与批量接口见 Math/Random.h）
+    FLOAT Random();
 
     inline FLOAT Random(FLOAT min, FLOAT max)
     {
@@ -29,13 +29,26 @@ public:
         };
     };
 
-    // 构造函数
-    Matrix4();
-    explicit Matrix4(float diagonal);
-    Matrix4(float m00, float m01, float m02, float m03,
-            float m10, float m11, float m12, float m13,
-            float m20, float m21, float m22, float m23,
-            float m30, float m31, float m32, float m33);
+    // 构造函数（编译期只访问 m[]，保持联合体的活跃成员不变）
+    MATH_CONSTEXPR Matrix4()
+        : m{1.0f, 0.0f, 0.0f, 0.0f,
+            0.0f, 1.0f, 0.0f, 0.0f,
+            0.0f, 0.0f, 1.0f, 0.0f,
+            0.0f, 0.0f, 0.0f, 1.0f} {} // 单位矩阵
+    explicit MATH_CONSTEXPR Matrix4(float diagonal)
+        : m{diagonal, 0.0f, 0.0f, 0.0f,
+            0.0f, diagonal, 0.0f, 0.0f,
+            0.0f, 0.0f, diagonal, 0.0f,
+            0.0f, 0.0f, 0.0f, diagonal} {}
+    // 参数按行优先书写，存储为列优先
+    MATH_CONSTEXPR Matrix4(float _m00, float _m01, float _m02, float _m03,
+                           float _m10, float _m11, float _m12, float _m13,
+                           float _m20, float _m21, float _m22, float _m23,
+                           float _m30, float _m31, float _m32, float _m33)
+        : m{_m00, _m10, _m20, _m30,
+            _m01, _m11, _m21, _m31,
+            _m02, _m12, _m22, _m32,
+            _m03, _m13, _m23, _m33} {}
     Matrix4(const Matrix4 &other) = default;
 
     // 赋值运算符
@@ -47,9 +60,9 @@ public:
         return m4[col][row]; // 列优先
     }
 
-    const float &operator()(int row, int col) const
+    MATH_CONSTEXPR const float &operator()(int row, int col) const
     {
-        return m4[col][row];
+        return m[col * 4 + row];
     }
     
     const float* GetData() const
@@ -73,49 +86,183 @@ public:
     }
 
     // 矩阵运算
-    Matrix4 operator+(const Matrix4 &other) const;
-    Matrix4 operator-(const Matrix4 &other) const;
+    MATH_CONSTEXPR Matrix4 operator+(const Matrix4 &other) const
+    {
+        Matrix4 result;
+        for (int i = 0; i < 16; ++i)
+            result.m[i] = m[i] + other.m[i];
+        return result;
+    }
+
+    MATH_CONSTEXPR Matrix4 operator-(const Matrix4 &other) const
+    {
+        Matrix4 result;
+        for (int i = 0; i < 16; ++i)
+            result.m[i] = m[i] - other.m[i];
+        return result;
+    }
+
+    MATH_CONSTEXPR Matrix4 operator*(float scalar) const
+    {
+        Matrix4 result;
+        for (int i = 0; i < 16; ++i)
+            result.m[i] = m[i] * scalar;
+        return result;
+    }
+
+    // 矩阵乘法与向量变换走 SIMD 路径，仅运行期可用
     Matrix4 operator*(const Matrix4 &other) const;
-    Matrix4 operator*(float scalar) const;
     Vector4 operator*(const Vector4 &vec) const;
     Vector3 operator*(const Vector3 &vec) const;
 
     // 赋值运算
-    Matrix4 &operator+=(const Matrix4 &other);
-    Matrix4 &operator-=(const Matrix4 &other);
+    MATH_CONSTEXPR Matrix4 &operator+=(const Matrix4 &other)
+    {
+        for (int i = 0; i < 16; ++i)
+            m[i] += other.m[i];
+        return *this;
+    }
+
+    MATH_CONSTEXPR Matrix4 &operator-=(const Matrix4 &other)
+    {
+        for (int i = 0; i < 16; ++i)
+            m[i] -= other.m[i];
+        return *this;
+    }
+
+    MATH_CONSTEXPR Matrix4 &operator*=(float scalar)
+    {
+        for (int i = 0; i < 16; ++i)
+            m[i] *= scalar;
+        return *this;
+    }
+
     Matrix4 &operator*=(const Matrix4 &other);
-    Matrix4 &operator*=(float scalar);
 
     // 比较运算符
-    bool operator==(const Matrix4 &other) const;
-    bool operator!=(const Matrix4 &other) const;
+    MATH_CONSTEXPR bool operator==(const Matrix4 &other) const
+    {
+        for (int i = 0; i < 16; ++i)
+            if (!Math::FloatEqual(m[i], other.m[i]))
+                return false;
+        return true;
+    }
+
+    MATH_CONSTEXPR bool operator!=(const Matrix4 &other) const
+    {
+        return !(*this == other);
+    }
 
     // 矩阵操作
     float Determinant() const;
-    Matrix4 Transposed() const; // 转置
-    Matrix4 &Transpose();
+    MATH_CONSTEXPR Matrix4 Transposed() const // 转置
+    {
+        return Matrix4(
+            m[0], m[1], m[2], m[3],
+            m[4], m[5], m[6], m[7],
+            m[8], m[9], m[10], m[11],
+            m[12], m[13], m[14], m[15]);
+    }
+
+    MATH_CONSTEXPR Matrix4 &Transpose()
+    {
+        *this = this->Transposed();
+        return *this;
+    }
+
     Matrix4 Inversed() const;
     Matrix4 &Inverse();
-    bool IsIdentity() const;
-    bool IsZero() const;
+    Matrix4 InversedAffine() const; // 仿射逆（TRS/刚体变换），比通用逆快
+    Matrix4 &InverseAffine();
+
+    MATH_CONSTEXPR bool IsAffine() const
+    {
+        return m[3] == 0.0f && m[7] == 0.0f && m[11] == 0.0f && m[15] == 1.0f;
+    }
+
+    MATH_CONSTEXPR bool IsIdentity() const
+    {
+        return (*this == Identity());
+    }
+
+    MATH_CONSTEXPR bool IsZero() const
+    {
+        for (int i = 0; i < 16; ++i)
+            if (!Math::IsZero(m[i]))
+                return false;
+        return true;
+    }
 
     // 获取行/列
-    Vector4 GetRow(int row) const;
-    Vector4 GetColumn(int col) const;
-    void SetRow(int row, const Vector4 &vec);
-    void SetColumn(int col, const Vector4 &vec);
+    MATH_CONSTEXPR Vector4 GetRow(int row) const
+    {
+        return Vector4(m[row], m[4 + row], m[8 + row], m[12 + row]);
+    }
+
+    MATH_CONSTEXPR Vector4 GetColumn(int col) const
+    {
+        return Vector4(m[col * 4], m[col * 4 + 1], m[col * 4 + 2], m[col * 4 + 3]);
+    }
+
+    MATH_CONSTEXPR void SetRow(int row, const Vector4 &vec)
+    {
+        m[row] = vec.x;
+        m[4 + row] = vec.y;
+        m[8 + row] = vec.z;
+        m[12 + row] = vec.w;
+    }
+
+    MATH_CONSTEXPR void SetColumn(int col, const Vector4 &vec)
+    {
+        m[col * 4] = vec.x;
+        m[col * 4 + 1] = vec.y;
+        m[col * 4 + 2] = vec.z;
+        m[col * 4 + 3] = vec.w;
+    }
 
     // 变换矩阵
-    static Matrix4 Identity();
-    static Matrix4 Zero();
-    static Matrix4 Translation(const Vector3 &translation);
+    static MATH_CONSTEXPR Matrix4 Identity()
+    {
+        return Matrix4(
+            1.0f, 0.0f, 0.0f, 0.0f,
+            0.0f, 1.0f, 0.0f, 0.0f,
+            0.0f, 0.0f, 1.0f, 0.0f,
+            0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    static MATH_CONSTEXPR Matrix4 Zero()
+    {
+        return Matrix4(0.0f);
+    }
+
+    static MATH_CONSTEXPR Matrix4 Translation(const Vector3 &translation)
+    {
+        return Matrix4(
+            1.0f, 0.0f, 0.0f, translation.x,
+            0.0f, 1.0f, 0.0f, translation.y,
+            0.0f, 0.0f, 1.0f, translation.z,
+            0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
     static Matrix4 RotationX(float angle);
     static Matrix4 RotationY(float angle);
     static Matrix4 RotationZ(float angle);
     static Matrix4 Rotation(float angle, const Vector3 &axis);
     static Matrix4 Rotation(const Quaternion &q);
-    static Matrix4 Scale(const Vector3 &scale);
-    static Matrix4 Scale(float scale);
+
+    static MATH_CONSTEXPR Matrix4 Scale(const Vector3 &scale)
+    {
+        return Matrix4(
+            scale.x, 0.0f, 0.0f, 0.0f,
+            0.0f, scale.y, 0.0f, 0.0f,
+            0.0f, 0.0f, scale.z, 0.0f,
+            0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    static MATH_CONSTEXPR Matrix4 Scale(float scale)
+    {
+        return Scale(Vector3(scale, scale, scale));
+    }
 
     // TRS 矩阵（平移*旋转*缩放）
     static Matrix4 TRS(const Vector3& translation, const Quaternion& rotation, const Vector3& scale);
@@ -131,19 +278,26 @@ public:
     static Matrix4 Perspective(float left, float right, float bottom, float top, float nearClip, float farClip);
 
     // 分解矩阵
-    Vector3 GetTranslation() const;
+    MATH_CONSTEXPR Vector3 GetTranslation() const
+    {
+        return Vector3(m[12], m[13], m[14]);
+    }
+
     Quaternion GetRotation() const;
     Vector3 GetScale() const;
 
     // 插值
-    static Matrix4 Lerp(const Matrix4 &a, const Matrix4 &b, float t);
+    static MATH_CONSTEXPR Matrix4 Lerp(const Matrix4 &a, const Matrix4 &b, float t)
+    {
+        t = Math::Clamp(t, 0.0f, 1.0f);
+        Matrix4 result;
+        for (int i = 0; i < 16; ++i)
+            result.m[i] = a.m[i] + (b.m[i] - a.m[i]) * t;
+        return result;
+    }
 
     // 字符串表示
     std::string ToString() const;
-
-private:
-    float Minor(int r0, int r1, int r2, int c0, int c1, int c2) const;
-    float Cofactor(int row, int col) const;
 };
 
 #endif // __MATRIX4_H__
\ No newline at end of file
@@ -17,21 +17,57 @@ public:
     float x, y, z, w;
 
     // 构造函数
-    Quaternion();
-    Quaternion(float x, float y, float z, float w);
+    MATH_CONSTEXPR Quaternion() : x(0.0f), y(0.0f), z(0.0f), w(1.0f) {}
+    MATH_CONSTEXPR Quaternion(float _x, float _y, float _z, float _w)
+        : x(_x), y(_y), z(_z), w(_w) {}
     Quaternion(const Vector3 &axis, float angle);
     Quaternion(float pitch, float yaw, float roll);
 
     // 运算
-    Quaternion operator+(const Quaternion &other) const;
-    Quaternion operator-(const Quaternion &other) const;
-    Quaternion operator*(const Quaternion &other) const;
-    Quaternion operator*(float scalar) const;
-    Vector3 operator*(const Vector3 &vec) const;
+    MATH_CONSTEXPR Quaternion operator+(const Quaternion &other) const
+    {
+        return Quaternion(x + other.x, y + other.y, z + other.z, w + other.w);
+    }
+
+    MATH_CONSTEXPR Quaternion operator-(const Quaternion &other) const
+    {
+        return Quaternion(x - other.x, y - other.y, z - other.z, w - other.w);
+    }
+
+    MATH_CONSTEXPR Quaternion operator*(const Quaternion &other) const
+    {
+        return Quaternion(
+            w * other.x + x * other.w + y * other.z - z * other.y,
+            w * other.y + y * other.w + z * other.x - x * other.z,
+            w * other.z + z * other.w + x * other.y - y * other.x,
+            w * other.w - x * other.x - y * other.y - z * other.z);
+    }
+
+    MATH_CONSTEXPR Quaternion operator*(float scalar) const
+    {
+        return Quaternion(x * scalar, y * scalar, z * scalar, w * scalar);
+    }
+
+    MATH_CONSTEXPR Vector3 operator*(const Vector3 &vec) const
+    {
+        // 使用四元数旋转向量
+        Quaternion result = (*this) * Quaternion(vec.x, vec.y, vec.z, 0.0f) * Conjugate();
+        return Vector3(result.x, result.y, result.z);
+    }
 
     // 共轭/逆
-    Quaternion Conjugate() const;
-    Quaternion Inverse() const;
+    MATH_CONSTEXPR Quaternion Conjugate() const
+    {
+        return Quaternion(-x, -y, -z, w);
+    }
+
+    MATH_CONSTEXPR Quaternion Inverse() const
+    {
+        float lenSq = LengthSquared();
+        if (Math::IsZero(lenSq))
+            return Identity();
+        return Conjugate() * (1.0f / lenSq);
+    }
 
     // 归一化
     Quaternion Normalized() const;
@@ -39,14 +75,24 @@ public:
 
     // 长度
     float Length() const;
-    float LengthSquared() const;
+    MATH_CONSTEXPR float LengthSquared() const
+    {
+        return x * x + y * y + z * z + w * w;
+    }
 
     // 点积
-    float Dot(const Quaternion &other) const;
+    MATH_CONSTEXPR float Dot(const Quaternion &other) const
+    {
+        return x * other.x + y * other.y + z * other.z + w * other.w;
+    }
 
     // 插值
     static Quaternion Slerp(const Quaternion &q1, const Quaternion &q2, float t);
-    static Quaternion Lerp(const Quaternion &q1, const Quaternion &q2, float t);
+    static MATH_CONSTEXPR Quaternion Lerp(const Quaternion &q1, const Quaternion &q2, float t)
+    {
+        t = Math::Clamp(t, 0.0f, 1.0f);
+        return q1 + (q2 - q1) * t;
+    }
     static Quaternion Nlerp(const Quaternion &q1, const Quaternion &q2, float t);
 
     // 创建旋转
@@ -59,13 +105,40 @@ public:
     Matrix4 ToMatrix() const;
 
     // 常用四元数
-    static Quaternion Identity();
-    static Quaternion Zero();
+    static MATH_CONSTEXPR Quaternion Identity()
+    {
+        return Quaternion(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    static MATH_CONSTEXPR Quaternion Zero()
+    {
+        return Quaternion(0.0f, 0.0f, 0.0f, 0.0f);
+    }
 
     // 方向
-    static Vector3 Forward(const Quaternion &q);
-    static Vector3 Right(const Quaternion &q);
-    static Vector3 Up(const Quaternion &q);
+    static MATH_CONSTEXPR Vector3 Forward(const Quaternion &q)
+    {
+        return Vector3(
+            2.0f * (q.x * q.z + q.w * q.y),
+            2.0f * (q.y * q.z - q.w * q.x),
+            1.0f - 2.0f * (q.x * q.x + q.y * q.y));
+    }
+
+    static MATH_CONSTEXPR Vector3 Right(const Quaternion &q)
+    {
+        return Vector3(
+            1.0f - 2.0f * (q.y * q.y + q.z * q.z),
+            2.0f * (q.x * q.y + q.w * q.z),
+            2.0f * (q.x * q.z - q.w * q.y));
+    }
+
+    static MATH_CONSTEXPR Vector3 Up(const Quaternion &q)
+    {
+        return Vector3(
+            2.0f * (q.x * q.y - q.w * q.z),
+            1.0f - 2.0f * (q.x * q.x + q.z * q.z),
+            2.0f * (q.y * q.z + q.w * q.x));
+    }
 };
 
 #endif // __QUATERNION_H__
\ No newline at end of file
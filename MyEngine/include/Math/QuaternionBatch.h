@@ -0,0 +1,76 @@
+// ======================================================================
+#ifndef __QUATERNION_BATCH_H__
+#define __QUATERNION_BATCH_H__
+// ======================================================================
+
+#include <vector>
+#include "Math/Quaternion.h"
+#include "Math/Matrix4.h"
+#include "Math/MathBatch.h"
+// ======================================================================
+
+// 四元数批量运算：插值与转换一次处理 N 个，SSE 下每次 4 个
+// - Slerp 使用 Eberly 多项式近似（无 acos/sin），插值权重与 Quaternion::Slerp 误差 < 3e-5
+// - Nlerp/FromEuler/ToMatrix 与单个版本公式一致
+// - 数量超过 PARALLEL_THRESHOLD 时按 Math::Batch::ParallelFor 拆分
+namespace Math
+{
+namespace Batch
+{
+    // ======================================================================
+    // SoA 存储
+    // ======================================================================
+    struct QuaternionSoA
+    {
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> z;
+        std::vector<float> w;
+
+        size_t Size() const { return x.size(); }
+
+        void Resize(size_t count)
+        {
+            x.resize(count);
+            y.resize(count);
+            z.resize(count);
+            w.resize(count, 1.0f);
+        }
+
+        void Set(size_t index, const Quaternion &q)
+        {
+            x[index] = q.x;
+            y[index] = q.y;
+            z[index] = q.z;
+            w[index] = q.w;
+        }
+
+        Quaternion Get(size_t index) const
+        {
+            return Quaternion(x[index], y[index], z[index], w[index]);
+        }
+
+        void FromAoS(const Quaternion *src, size_t count);
+        void ToAoS(Quaternion *dst) const;
+    };
+
+    // ======================================================================
+    // 插值（a、b 大小必须相同，out 可与 a 或 b 为同一对象）
+    // ======================================================================
+    void Slerp(const QuaternionSoA &a, const QuaternionSoA &b, float t, QuaternionSoA &out);
+    void Slerp(const QuaternionSoA &a, const QuaternionSoA &b, const float *t, QuaternionSoA &out);
+    void Nlerp(const QuaternionSoA &a, const QuaternionSoA &b, float t, QuaternionSoA &out);
+    void Nlerp(const QuaternionSoA &a, const QuaternionSoA &b, const float *t, QuaternionSoA &out);
+
+    // ======================================================================
+    // 转换
+    // ======================================================================
+    void Normalize(QuaternionSoA &q);
+    // eulers.x/y/z 依次为 pitch/yaw/roll（弧度），与 Quaternion::FromEuler 一致
+    void FromEuler(const Vector3SoA &eulers, QuaternionSoA &out);
+    // 输出纯旋转矩阵，out 需容纳 q.Size() 个
+    void ToMatrix(const QuaternionSoA &q, Matrix4 *out);
+}
+}
+
+#endif // __QUATERNION_BATCH_H__
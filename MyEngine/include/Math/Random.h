@@ -0,0 +1,103 @@
+// ======================================================================
+#ifndef __MATH_RANDOM_H__
+#define __MATH_RANDOM_H__
+// ======================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include "Math/Vector3.h"
+// ======================================================================
+
+// xoshiro128+ 随机数生成器（Blackman & Vigna），用于替代 rand()/std::mt19937
+// - 显式种子：相同 (seed, stream) 在任何平台、任何 SIMD 路径下产生相同序列
+// - 流：同一种子下不同 stream 相隔 2^96 个输出，每个线程/任务各用一个流互不重叠
+// - 批量：Fill 系列使用流内 4 条相隔 2^64 的交错子流，SSE2 一次生成 4 个；
+//   与逐个调用 NextUInt 的序列相互独立，标量回退与 SIMD 结果逐位一致
+// 低位线性相关性较弱，浮点结果只取高 24 位
+namespace Math
+{
+    class RandomGenerator
+    {
+    public:
+        static const uint64_t DEFAULT_SEED = 0x853c49e6748fea9bULL;
+
+        explicit RandomGenerator(uint64_t seed = DEFAULT_SEED, uint32_t stream = 0)
+        {
+            Seed(seed, stream);
+        }
+
+        void Seed(uint64_t seed, uint32_t stream = 0);
+
+        // ======================================================================
+        // 单个
+        // ======================================================================
+        uint32_t NextUInt()
+        {
+            uint32_t result = m_state[0] + m_state[3];
+            uint32_t t = m_state[1] << 9;
+            m_state[2] ^= m_state[0];
+            m_state[3] ^= m_state[1];
+            m_state[1] ^= m_state[2];
+            m_state[0] ^= m_state[3];
+            m_state[2] ^= t;
+            m_state[3] = (m_state[3] << 11) | (m_state[3] >> 21);
+            return result;
+        }
+
+        // [0, 1)
+        float NextFloat()
+        {
+            return (float)(NextUInt() >> 8) * (1.0f / 16777216.0f);
+        }
+
+        // [min, max]
+        float NextFloat(float min, float max)
+        {
+            return min + NextFloat() * (max - min);
+        }
+
+        // [min, max)，max <= min 时返回 min
+        int NextInt(int min, int max)
+        {
+            if (max <= min)
+                return min;
+            uint32_t range = (uint32_t)((int64_t)max - min);
+            return (int)((int64_t)min + (int64_t)(((uint64_t)NextUInt() * range) >> 32));
+        }
+
+        // 各分量分别在 [min, max] 内
+        Vector3 NextVector3(const Vector3 &min, const Vector3 &max)
+        {
+            float x = NextFloat(min.x, max.x);
+            float y = NextFloat(min.y, max.y);
+            float z = NextFloat(min.z, max.z);
+            return Vector3(x, y, z);
+        }
+
+        // ======================================================================
+        // 批量（count 向上取整到 4 的倍数消耗随机数）
+        // ======================================================================
+        void FillUInt(uint32_t *out, size_t count);
+        // [0, 1)
+        void Fill(float *out, size_t count);
+        // [min, max]
+        void Fill(float *out, size_t count, float min, float max);
+        // 各分量分别在 [min, max] 内
+        void Fill(Vector3 *out, size_t count, const Vector3 &min, const Vector3 &max);
+
+        // ======================================================================
+        // 线程默认流
+        // ======================================================================
+        // 当前线程的生成器：首次使用时以全局种子分配下一个流号
+        static RandomGenerator &ThreadLocal();
+        // 重设全局种子：调用线程立即切换到流 0，之后首次使用的线程依次分配流 1, 2, ...
+        // （已创建的其它线程生成器不受影响，需要可复现时应在启动工作线程前调用）
+        static void SetGlobalSeed(uint64_t seed);
+
+    private:
+        uint32_t m_state[4];    // 单个生成使用的子流
+        uint32_t m_lanes[4][4]; // 批量生成的 4 条子流，按 [状态字][子流] 排列便于 SIMD 加载
+    };
+}
+
+#endif // __MATH_RANDOM_H__
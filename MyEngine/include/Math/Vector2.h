@@ -19,12 +19,12 @@ public:
     float x, y;
 
     // 构造函数
-    Vector2() : x(0.0f), y(0.0f) {}
-    Vector2(float x, float y) : x(x), y(y) {}
-    explicit Vector2(float scalar) : x(scalar), y(scalar) {}
+    MATH_CONSTEXPR Vector2() : x(0.0f), y(0.0f) {}
+    MATH_CONSTEXPR Vector2(float x, float y) : x(x), y(y) {}
+    explicit MATH_CONSTEXPR Vector2(float scalar) : x(scalar), y(scalar) {}
 
     // 拷贝构造函数
-    Vector2(const Vector2 &other) = default;
+    MATH_CONSTEXPR Vector2(const Vector2 &other) = default;
 
     // 赋值运算符
     Vector2 &operator=(const Vector2 &other) = default;
@@ -41,79 +41,79 @@ public:
     }
 
     // 向量运算
-    Vector2 operator-() const
+    MATH_CONSTEXPR Vector2 operator-() const
     {
         return Vector2(-x, -y);
     }
 
-    Vector2 operator+(const Vector2 &other) const
+    MATH_CONSTEXPR Vector2 operator+(const Vector2 &other) const
     {
         return Vector2(x + other.x, y + other.y);
     }
 
-    Vector2 operator-(const Vector2 &other) const
+    MATH_CONSTEXPR Vector2 operator-(const Vector2 &other) const
     {
         return Vector2(x - other.x, y - other.y);
     }
 
-    Vector2 operator*(const Vector2 &other) const
+    MATH_CONSTEXPR Vector2 operator*(const Vector2 &other) const
     {
         return Vector2(x * other.x, y * other.y);
     }
 
-    Vector2 operator/(const Vector2 &other) const
+    MATH_CONSTEXPR Vector2 operator/(const Vector2 &other) const
     {
         return Vector2(x / other.x, y / other.y);
     }
 
-    Vector2 operator*(float scalar) const
+    MATH_CONSTEXPR Vector2 operator*(float scalar) const
     {
         return Vector2(x * scalar, y * scalar);
     }
 
-    Vector2 operator/(float scalar) const
+    MATH_CONSTEXPR Vector2 operator/(float scalar) const
     {
         float invScalar = 1.0f / scalar;
         return Vector2(x * invScalar, y * invScalar);
     }
 
     // 赋值运算
-    Vector2 &operator+=(const Vector2 &other)
+    MATH_CONSTEXPR Vector2 &operator+=(const Vector2 &other)
     {
         x += other.x;
         y += other.y;
         return *this;
     }
 
-    Vector2 &operator-=(const Vector2 &other)
+    MATH_CONSTEXPR Vector2 &operator-=(const Vector2 &other)
     {
         x -= other.x;
         y -= other.y;
         return *this;
     }
 
-    Vector2 &operator*=(const Vector2 &other)
+    MATH_CONSTEXPR Vector2 &operator*=(const Vector2 &other)
     {
         x *= other.x;
         y *= other.y;
         return *this;
     }
 
-    Vector2 &operator/=(const Vector2 &other)
+    MATH_CONSTEXPR Vector2 &operator/=(const Vector2 &other)
     {
         x /= other.x;
         y /= other.y;
         return *this;
     }
 
-    Vector2 &operator*=(float scalar)
+    MATH_CONSTEXPR Vector2 &operator*=(float scalar)
     {
         x *= scalar;
         y *= scalar;
         return *this;
     }
 
-    Vector2 &operator/=(float scalar)
+    MATH_CONSTEXPR Vector2 &operator/=(float scalar)
     {
         float invScalar = 1.0f / scalar;
         x *= invScalar;
@@ -122,28 +122,28 @@ public:
     }
 
     // 比较运算符
-    bool operator==(const Vector2 &other) const
+    MATH_CONSTEXPR bool operator==(const Vector2 &other) const
     {
         return Math::FloatEqual(x, other.x) && Math::FloatEqual(y, other.y);
     }
 
-    bool operator!=(const Vector2 &other) const
+    MATH_CONSTEXPR bool operator!=(const Vector2 &other) const
     {
         return !(*this == other);
     }
 
     // 向量操作
-    float Dot(const Vector2 &other) const
+    MATH_CONSTEXPR float Dot(const Vector2 &other) const
     {
         return x * other.x + y * other.y;
     }
 
-    float Cross(const Vector2 &other) const
+    MATH_CONSTEXPR float Cross(const Vector2 &other) const
     {
         return x * other.y - y * other.x;
     }
 
-    float LengthSquared() const
+    MATH_CONSTEXPR float LengthSquared() const
     {
         return x * x + y * y;
     }
@@ -200,7 +200,7 @@ public:
     }
 
     // 是否为零向量
-    bool IsZero() const
+    MATH_CONSTEXPR bool IsZero() const
     {
         return Math::IsZero(x) && Math::IsZero(y);
     }
@@ -212,32 +212,32 @@ public:
     }
 
     // 静态方法
-    static Vector2 Zero()
+    static MATH_CONSTEXPR Vector2 Zero()
     {
         return Vector2(0.0f, 0.0f);
     }
 
-    static Vector2 One()
+    static MATH_CONSTEXPR Vector2 One()
     {
         return Vector2(1.0f, 1.0f);
     }
 
-    static Vector2 UnitX()
+    static MATH_CONSTEXPR Vector2 UnitX()
     {
         return Vector2(1.0f, 0.0f);
     }
 
-    static Vector2 UnitY()
+    static MATH_CONSTEXPR Vector2 UnitY()
     {
         return Vector2(0.0f, 1.0f);
     }
 
-    static float Dot(const Vector2 &a, const Vector2 &b)
+    static MATH_CONSTEXPR float Dot(const Vector2 &a, const Vector2 &b)
     {
         return a.Dot(b);
     }
 
-    static float Cross(const Vector2 &a, const Vector2 &b)
+    static MATH_CONSTEXPR float Cross(const Vector2 &a, const Vector2 &b)
     {
         return a.Cross(b);
     }
@@ -248,7 +248,7 @@ public:
     }
 
     // 线性插值
-    static Vector2 Lerp(const Vector2 &a, const Vector2 &b, float t)
+    static MATH_CONSTEXPR Vector2 Lerp(const Vector2 &a, const Vector2 &b, float t)
     {
         return a + (b - a) * Math::Clamp(t, 0.0f, 1.0f);
     }
@@ -277,7 +277,7 @@ public:
 };
 
 // 标量乘法（左乘）
-inline Vector2 operator*(float scalar, const Vector2 &vec)
+MATH_CONSTEXPR Vector2 operator*(float scalar, const Vector2 &vec)
 {
     return vec * scalar;
 }
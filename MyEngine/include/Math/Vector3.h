@@ -13,10 +13,10 @@ public:
     float x, y, z;
 
     // 构造函数
-    Vector3() : x(0.0f), y(0.0f), z(0.0f) {}
-    Vector3(float x, float y, float z) : x(x), y(y), z(z) {}
-    Vector3(const Vector2 &vec2, float z = 0.0f) : x(vec2.x), y(vec2.y), z(z) {}
-    explicit Vector3(float scalar) : x(scalar), y(scalar), z(scalar) {}
+    MATH_CONSTEXPR Vector3() : x(0.0f), y(0.0f), z(0.0f) {}
+    MATH_CONSTEXPR Vector3(float x, float y, float z) : x(x), y(y), z(z) {}
+    MATH_CONSTEXPR Vector3(const Vector2 &vec2, float z = 0.0f) : x(vec2.x), y(vec2.y), z(z) {}
+    explicit MATH_CONSTEXPR Vector3(float scalar) : x(scalar), y(scalar), z(scalar) {}
 
     // 添加：获取底层数据指针的方法（用于 OpenGL 函数）
     const float *GetData() const
@@ -51,44 +51,44 @@ public:
     }
 
     // 向量运算
-    Vector3 operator-() const
+    MATH_CONSTEXPR Vector3 operator-() const
     {
         return Vector3(-x, -y, -z);
     }
 
-    Vector3 operator+(const Vector3 &other) const
+    MATH_CONSTEXPR Vector3 operator+(const Vector3 &other) const
     {
         return Vector3(x + other.x, y + other.y, z + other.z);
     }
 
-    Vector3 operator-(const Vector3 &other) const
+    MATH_CONSTEXPR Vector3 operator-(const Vector3 &other) const
     {
         return Vector3(x - other.x, y - other.y, z - other.z);
     }
 
-    Vector3 operator*(const Vector3 &other) const
+    MATH_CONSTEXPR Vector3 operator*(const Vector3 &other) const
     {
         return Vector3(x * other.x, y * other.y, z * other.z);
     }
 
-    Vector3 operator/(const Vector3 &other) const
+    MATH_CONSTEXPR Vector3 operator/(const Vector3 &other) const
     {
         return Vector3(x / other.x, y / other.y, z / other.z);
     }
 
-    Vector3 operator*(float scalar) const
+    MATH_CONSTEXPR Vector3 operator*(float scalar) const
     {
         return Vector3(x * scalar, y * scalar, z * scalar);
     }
 
-    Vector3 operator/(float scalar) const
+    MATH_CONSTEXPR Vector3 operator/(float scalar) const
     {
         float invScalar = 1.0f / scalar;
         return Vector3(x * invScalar, y * invScalar, z * invScalar);
     }
 
     // 赋值运算
-    Vector3 &operator+=(const Vector3 &other)
+    MATH_CONSTEXPR Vector3 &operator+=(const Vector3 &other)
     {
         x += other.x;
         y += other.y;
@@ -96,7 +96,7 @@ public:
         return *this;
     }
 
-    Vector3 &operator-=(const Vector3 &other)
+    MATH_CONSTEXPR Vector3 &operator-=(const Vector3 &other)
     {
         x -= other.x;
         y -= other.y;
@@ -104,7 +104,7 @@ public:
         return *this;
     }
 
-    Vector3 &operator*=(const Vector3 &other)
+    MATH_CONSTEXPR Vector3 &operator*=(const Vector3 &other)
     {
         x *= other.x;
         y *= other.y;
@@ -112,7 +112,7 @@ public:
         return *this;
     }
 
-    Vector3 &operator/=(const Vector3 &other)
+    MATH_CONSTEXPR Vector3 &operator/=(const Vector3 &other)
     {
         x /= other.x;
         y /= other.y;
@@ -120,7 +120,7 @@ public:
         return *this;
     }
 
-    Vector3 &operator*=(float scalar)
+    MATH_CONSTEXPR Vector3 &operator*=(float scalar)
     {
         x *= scalar;
         y *= scalar;
@@ -128,7 +128,7 @@ public:
         return *this;
     }
 
-    Vector3 &operator/=(float scalar)
+    MATH_CONSTEXPR Vector3 &operator/=(float scalar)
     {
         float invScalar = 1.0f / scalar;
         x *= invScalar;
@@ -138,32 +138,32 @@ public:
     }
 
     // 比较运算符
-    bool operator==(const Vector3 &other) const
+    MATH_CONSTEXPR bool operator==(const Vector3 &other) const
     {
         return Math::FloatEqual(x, other.x) &&
                Math::FloatEqual(y, other.y) &&
                Math::FloatEqual(z, other.z);
     }
 
-    bool operator!=(const Vector3 &other) const
+    MATH_CONSTEXPR bool operator!=(const Vector3 &other) const
     {
         return !(*this == other);
     }
 
     // 向量操作
-    float Dot(const Vector3 &other) const
+    MATH_CONSTEXPR float Dot(const Vector3 &other) const
     {
         return x * other.x + y * other.y + z * other.z;
     }
 
-    Vector3 Cross(const Vector3 &other) const
+    MATH_CONSTEXPR Vector3 Cross(const Vector3 &other) const
     {
         return Vector3(y * other.z - z * other.y,
                        z * other.x - x * other.z,
                        x * other.y - y * other.x);
     }
 
-    float LengthSquared() const
+    MATH_CONSTEXPR float LengthSquared() const
     {
         return x * x + y * y + z * z;
     }
@@ -229,7 +229,7 @@ public:
         return Math::Acos(Math::Clamp(dot / lenProduct, -1.0f, 1.0f));
     }
 
-    bool IsZero() const
+    MATH_CONSTEXPR bool IsZero() const
     {
         return Math::IsZero(x) && Math::IsZero(y) && Math::IsZero(z);
     }
@@ -240,83 +240,83 @@ public:
     }
 
     // 转换为Vector2
-    Vector2 XY() const
+    MATH_CONSTEXPR Vector2 XY() const
     {
         return Vector2(x, y);
     }
 
-    Vector2 XZ() const
+    MATH_CONSTEXPR Vector2 XZ() const
     {
         return Vector2(x, z);
     }
 
-    Vector2 YZ() const
+    MATH_CONSTEXPR Vector2 YZ() const
     {
         return Vector2(y, z);
     }
 
     // 静态方法
-    static Vector3 Zero()
+    static MATH_CONSTEXPR Vector3 Zero()
     {
         return Vector3(0.0f, 0.0f, 0.0f);
     }
 
-    static Vector3 One()
+    static MATH_CONSTEXPR Vector3 One()
     {
         return Vector3(1.0f, 1.0f, 1.0f);
     }
 
-    static Vector3 UnitX()
+    static MATH_CONSTEXPR Vector3 UnitX()
     {
         return Vector3(1.0f, 0.0f, 0.0f);
     }
 
-    static Vector3 UnitY()
+    static MATH_CONSTEXPR Vector3 UnitY()
     {
         return Vector3(0.0f, 1.0f, 0.0f);
     }
 
-    static Vector3 UnitZ()
+    static MATH_CONSTEXPR Vector3 UnitZ()
     {
         return Vector3(0.0f, 0.0f, 1.0f);
     }
 
-    static Vector3 Up()
+    static MATH_CONSTEXPR Vector3 Up()
     {
         return Vector3(0.0f, 1.0f, 0.0f);
     }
 
-    static Vector3 Down()
+    static MATH_CONSTEXPR Vector3 Down()
     {
         return Vector3(0.0f, -1.0f, 0.0f);
     }
 
-    static Vector3 Right()
+    static MATH_CONSTEXPR Vector3 Right()
     {
         return Vector3(1.0f, 0.0f, 0.0f);
     }
 
-    static Vector3 Left()
+    static MATH_CONSTEXPR Vector3 Left()
     {
         return Vector3(-1.0f, 0.0f, 0.0f);
     }
 
-    static Vector3 Forward()
+    static MATH_CONSTEXPR Vector3 Forward()
     {
         return Vector3(0.0f, 0.0f, 1.0f);
     }
 
-    static Vector3 Backward()
+    static MATH_CONSTEXPR Vector3 Backward()
     {
         return Vector3(0.0f, 0.0f, -1.0f);
     }
 
-    static float Dot(const Vector3 &a, const Vector3 &b)
+    static MATH_CONSTEXPR float Dot(const Vector3 &a, const Vector3 &b)
     {
         return a.Dot(b);
     }
 
-    static Vector3 Cross(const Vector3 &a, const Vector3 &b)
+    static MATH_CONSTEXPR Vector3 Cross(const Vector3 &a, const Vector3 &b)
     {
         return a.Cross(b);
     }
@@ -326,7 +326,7 @@ public:
         return a.Distance(b);
     }
 
-    static Vector3 Lerp(const Vector3 &a, const Vector3 &b, float t)
+    static MATH_CONSTEXPR Vector3 Lerp(const Vector3 &a, const Vector3 &b, float t)
     {
         return a + (b - a) * Math::Clamp(t, 0.0f, 1.0f);
     }
@@ -340,12 +340,12 @@ public:
         return a * Math::Cos(theta) + relative * Math::Sin(theta);
     }
 
-    static Vector3 Min(const Vector3 &a, const Vector3 &b)
+    static MATH_CONSTEXPR Vector3 Min(const Vector3 &a, const Vector3 &b)
     {
         return Vector3(Math::Min(a.x, b.x), Math::Min(a.y, b.y), Math::Min(a.z, b.z));
     }
 
-    static Vector3 Max(const Vector3 &a, const Vector3 &b)
+    static MATH_CONSTEXPR Vector3 Max(const Vector3 &a, const Vector3 &b)
     {
         return Vector3(Math::Max(a.x, b.x), Math::Max(a.y, b.y), Math::Max(a.z, b.z));
     }
@@ -359,7 +359,7 @@ public:
 };
 
 // 标量乘法（左乘）
-inline Vector3 operator*(float scalar, const Vector3 &vec)
+MATH_CONSTEXPR Vector3 operator*(float scalar, const Vector3 &vec)
 {
     return vec * scalar;
 }
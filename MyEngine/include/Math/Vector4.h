@@ -18,10 +18,10 @@ public:
     float x, y, z, w;
 
     // 构造函数
-    Vector4() : x(0.0f), y(0.0f), z(0.0f), w(0.0f) {}
-    Vector4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
-    Vector4(const Vector3 &vec3, float w = 0.0f) : x(vec3.x), y(vec3.y), z(vec3.z), w(w) {}
-    explicit Vector4(float scalar) : x(scalar), y(scalar), z(scalar), w(scalar) {}
+    MATH_CONSTEXPR Vector4() : x(0.0f), y(0.0f), z(0.0f), w(0.0f) {}
+    MATH_CONSTEXPR Vector4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+    MATH_CONSTEXPR Vector4(const Vector3 &vec3, float w = 0.0f) : x(vec3.x), y(vec3.y), z(vec3.z), w(w) {}
+    explicit MATH_CONSTEXPR Vector4(float scalar) : x(scalar), y(scalar), z(scalar), w(scalar) {}
 
     // 访问运算符
     float &operator[](int index)
@@ -35,44 +35,44 @@ public:
     }
 
     // 向量运算
-    Vector4 operator-() const
+    MATH_CONSTEXPR Vector4 operator-() const
     {
         return Vector4(-x, -y, -z, -w);
     }
 
-    Vector4 operator+(const Vector4 &other) const
+    MATH_CONSTEXPR Vector4 operator+(const Vector4 &other) const
     {
         return Vector4(x + other.x, y + other.y, z + other.z, w + other.w);
     }
 
-    Vector4 operator-(const Vector4 &other) const
+    MATH_CONSTEXPR Vector4 operator-(const Vector4 &other) const
     {
         return Vector4(x - other.x, y - other.y, z - other.z, w - other.w);
     }
 
-    Vector4 operator*(const Vector4 &other) const
+    MATH_CONSTEXPR Vector4 operator*(const Vector4 &other) const
     {
         return Vector4(x * other.x, y * other.y, z * other.z, w * other.w);
     }
 
-    Vector4 operator/(const Vector4 &other) const
+    MATH_CONSTEXPR Vector4 operator/(const Vector4 &other) const
     {
         return Vector4(x / other.x, y / other.y, z / other.z, w / other.w);
     }
 
-    Vector4 operator*(float scalar) const
+    MATH_CONSTEXPR Vector4 operator*(float scalar) const
     {
         return Vector4(x * scalar, y * scalar, z * scalar, w * scalar);
     }
 
-    Vector4 operator/(float scalar) const
+    MATH_CONSTEXPR Vector4 operator/(float scalar) const
     {
         float invScalar = 1.0f / scalar;
         return Vector4(x * invScalar, y * invScalar, z * invScalar, w * invScalar);
     }
 
     // 赋值运算
-    Vector4 &operator+=(const Vector4 &other)
+    MATH_CONSTEXPR Vector4 &operator+=(const Vector4 &other)
     {
         x += other.x;
         y += other.y;
@@ -81,7 +81,7 @@ public:
         return *this;
     }
 
-    Vector4 &operator-=(const Vector4 &other)
+    MATH_CONSTEXPR Vector4 &operator-=(const Vector4 &other)
     {
         x -= other.x;
         y -= other.y;
@@ -90,7 +90,7 @@ public:
         return *this;
     }
 
-    Vector4 &operator*=(const Vector4 &other)
+    MATH_CONSTEXPR Vector4 &operator*=(const Vector4 &other)
     {
         x *= other.x;
         y *= other.y;
@@ -99,7 +99,7 @@ public:
         return *this;
     }
 
-    Vector4 &operator/=(const Vector4 &other)
+    MATH_CONSTEXPR Vector4 &operator/=(const Vector4 &other)
     {
         x /= other.x;
         y /= other.y;
@@ -108,7 +108,7 @@ public:
         return *this;
     }
 
-    Vector4 &operator*=(float scalar)
+    MATH_CONSTEXPR Vector4 &operator*=(float scalar)
     {
         x *= scalar;
         y *= scalar;
@@ -117,7 +117,7 @@ public:
         return *this;
     }
 
-    Vector4 &operator/=(float scalar)
+    MATH_CONSTEXPR Vector4 &operator/=(float scalar)
     {
         float invScalar = 1.0f / scalar;
         x *= invScalar;
@@ -128,7 +128,7 @@ public:
     }
 
     // 比较运算符
-    bool operator==(const Vector4 &other) const
+    MATH_CONSTEXPR bool operator==(const Vector4 &other) const
     {
         return Math::FloatEqual(x, other.x) &&
                Math::FloatEqual(y, other.y) &&
@@ -136,18 +136,18 @@ public:
                Math::FloatEqual(w, other.w);
     }
 
-    bool operator!=(const Vector4 &other) const
+    MATH_CONSTEXPR bool operator!=(const Vector4 &other) const
     {
         return !(*this == other);
     }
 
     // 向量操作
-    float Dot(const Vector4 &other) const
+    MATH_CONSTEXPR float Dot(const Vector4 &other) const
     {
         return x * other.x + y * other.y + z * other.z + w * other.w;
     }
 
-    float LengthSquared() const
+    MATH_CONSTEXPR float LengthSquared() const
     {
         return x * x + y * y + z * z + w * w;
     }
@@ -192,7 +192,7 @@ public:
         return *this;
     }
 
-    bool IsZero() const
+    MATH_CONSTEXPR bool IsZero() const
     {
         return Math::IsZero(x) && Math::IsZero(y) &&
                Math::IsZero(z) && Math::IsZero(w);
@@ -204,12 +204,12 @@ public:
     }
 
     // 转换为Vector3
-    Vector3 XYZ() const
+    MATH_CONSTEXPR Vector3 XYZ() const
     {
         return Vector3(x, y, z);
     }
 
-    Vector3 RGB() const
+    MATH_CONSTEXPR Vector3 RGB() const
     {
         return Vector3(x, y, z);
     }
@@ -249,37 +249,37 @@ public:
     }
 
     // 静态方法
-    static Vector4 Zero()
+    static MATH_CONSTEXPR Vector4 Zero()
     {
         return Vector4(0.0f, 0.0f, 0.0f, 0.0f);
     }
 
-    static Vector4 One()
+    static MATH_CONSTEXPR Vector4 One()
     {
         return Vector4(1.0f, 1.0f, 1.0f, 1.0f);
     }
 
-    static Vector4 UnitX()
+    static MATH_CONSTEXPR Vector4 UnitX()
     {
         return Vector4(1.0f, 0.0f, 0.0f, 0.0f);
     }
 
-    static Vector4 UnitY()
+    static MATH_CONSTEXPR Vector4 UnitY()
     {
         return Vector4(0.0f, 1.0f, 0.0f, 0.0f);
     }
 
-    static Vector4 UnitZ()
+    static MATH_CONSTEXPR Vector4 UnitZ()
     {
         return Vector4(0.0f, 0.0f, 1.0f, 0.0f);
     }
 
-    static Vector4 UnitW()
+    static MATH_CONSTEXPR Vector4 UnitW()
     {
         return Vector4(0.0f, 0.0f, 0.0f, 1.0f);
     }
 
-    static float Dot(const Vector4 &a, const Vector4 &b)
+    static MATH_CONSTEXPR float Dot(const Vector4 &a, const Vector4 &b)
     {
         return a.Dot(b);
     }
@@ -289,7 +289,7 @@ public:
         return a.Distance(b);
     }
 
-    static Vector4 Lerp(const Vector4 &a, const Vector4 &b, float t)
+    static MATH_CONSTEXPR Vector4 Lerp(const Vector4 &a, const Vector4 &b, float t)
     {
         return a + (b - a) * Math::Clamp(t, 0.0f, 1.0f);
     }
@@ -303,7 +303,7 @@ public:
 };
 
 // 标量乘法（左乘）
-inline Vector4 operator*(float scalar, const Vector4 &vec)
+MATH_CONSTEXPR Vector4 operator*(float scalar, const Vector4 &vec)
 {
     return vec * scalar;
 }
@@ -4,6 +4,7 @@
 #define __MESH_H__
 // ======================================================================
 #include <Windows.h>
+#include <cstdint>
 #include <string>
 #include <sstream>
 #include <vector>
@@ -72,15 +73,15 @@ public:
     };
 
     // 设置材质名称
-    void SetMaterialName(const std::wstring &name) { m_material.name = name; }
+    void SetMaterialName(const std::wstring &name) { m_material.name = name; m_materialID = 0; }
     const std::wstring &GetMaterialName() const { return m_material.name; }
 
     // 完整材质设置
-    void SetMaterial(const SimpleMaterial &material) { m_material = material; }
+    void SetMaterial(const SimpleMaterial &material) { m_material = material; m_materialID = 0; }
     const SimpleMaterial &GetMaterial() const { return m_material; }
 
     // 设置透明度
-    void SetOpacity(float opacity) { m_material.opacity = opacity; }
+    void SetOpacity(float opacity) { m_material.opacity = opacity; m_materialID = 0; }
     float GetOpacity() const { return m_material.opacity; }
 
     // 纹理相关
@@ -109,8 +110,31 @@ public:
           std::shared_ptr<CTexture> pTexture = nullptr);
     ~CMesh();
 
-    // 渲染网格
-    void Draw() const;
+    // 渲染网格：状态经 CGLStateCache 设置，不保存也不恢复，由调用方负责；lod 为细节级别（见 GenerateLODs）
+    void Draw(size_t lod = 0) const;
+
+    // 分步绘制（渲染队列提交时使用，状态切换由调用方按需进行）
+    void ApplyMaterial() const;               // 材质与混合开关（经 CGLStateCache）
+    void DrawGeometry(size_t lod = 0) const;  // 设置顶点指针并绘制，调用方负责启用顶点数组
+    // 同 DrawGeometry，一次绘制 instanceCount 个实例（glDrawElementsInstanced），实例属性由调用方设置
+    void DrawGeometryInstanced(GLsizei instanceCount, size_t lod = 0) const;
+    uint32_t GetMeshID() const { return m_meshID; } // 创建顺序编号（从 1 开始），渲染队列按此合批
+    uint32_t GetMaterialID() const; // 材质内容的编号（从 1 开始），内容相同的网格编号相同
+    GLuint GetTextureID() const;    // 有效纹理的 OpenGL 名称，无纹理时为 0
+
+    // ======================================================================
+    // 细节级别：各级共用顶点数组，只有索引不同；0 级为原始网格
+    // ======================================================================
+    static const size_t MAX_LOD_LEVELS = 4; // 渲染队列排序键中 LOD 占 2 位
+
+    // 导入时用 QEM 边折叠逐级简化（CMeshSimplifier），每级目标为上一级三角形数的 reduction 倍；
+    // 折叠误差超过 maxError（相对包围盒半径）、三角形太少或减少不到 1/4 时停止
+    void GenerateLODs(size_t maxLevels = MAX_LOD_LEVELS, float reduction = 0.5f, float maxError = 0.1f);
+    size_t GetLODCount() const { return 1 + m_lodLevels.size(); }
+    // 超出范围的级别取最粗的一级
+    const std::vector<unsigned int> &GetLODIndices(size_t lod) const;
+    float GetLODError(size_t lod) const; // 该级相对原始网格的几何误差（模型空间距离），0 级为 0
+    size_t GetLODTriangleCount(size_t lod) const { return GetLODIndices(lod).size() / 3; }
 
     const std::vector<Vertex> &GetVertices() const { return m_vertices; }     // 获取顶点数据
     const std::vector<unsigned int> &GetIndices() const { return m_indices; } // 获取索引数据
@@ -131,10 +155,19 @@ private:
     std::vector<Vertex> m_vertices;
     std::vector<unsigned int> m_indices;
 
+    struct LODLevel
+    {
+        std::vector<unsigned int> indices;
+        float error;
+    };
+    std::vector<LODLevel> m_lodLevels; // 1 级及以后
+
     std::shared_ptr<CTexture> m_pTexture;
     SimpleMaterial m_material;
+    mutable uint32_t m_materialID = 0; // 0 表示材质变化后尚未重新编号
 
     int m_subMeshID = -1; // 在模型中的子网格ID
+    uint32_t m_meshID;
 
     void CalculateBoundingBox();
     BoundingBox m_boundingBox;
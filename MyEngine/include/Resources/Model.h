@@ -12,10 +12,15 @@
 #include "Resources/Mesh.h"
 #include "Math/Matrix4.h"
 #include "Math/Quaternion.h"
+#include "Math/AABB.h"
 #include "EngineConfig.h"
 // ======================================================================
 
 class CResourceManager;
+class CRenderQueue;
+class CStaticBatch;
+class COcclusionBuffer;
+class CLODController;
 
 class CModel
 {
@@ -27,8 +32,15 @@ public:
     BOOL LoadFromFile(const std::wstring &filePath, CResourceManager *pResMgr);
     void Unload();
 
-    // 模型绘制
-    void Draw() const;
+    // 模型绘制，lod 为细节级别（网格级别数不足时取其最粗一级）
+    void Draw(size_t lod = 0) const;
+    // 各网格加入渲染队列，parentWorld 为所属实体的世界矩阵（模型自身变换在其后）
+    void Enqueue(CRenderQueue &queue, const Matrix4 &parentWorld, size_t lod = 0) const;
+    // 各网格预先变换后并入静态合批，ownerID 为所属实体；有半透明网格时不加入（需要逐帧排序），返回 FALSE
+    BOOL AddToStaticBatch(CStaticBatch &batch, const Matrix4 &parentWorld, unsigned int ownerID) const;
+    // 不透明网格以原始（0 级）索引加入遮挡缓冲，返回是否加入了网格
+    // 简化网格的顶点可能外移到原表面之外，遮住实际看得见的物体，所以不用细节级别
+    BOOL AddToOcclusion(COcclusionBuffer &buffer, const Matrix4 &parentWorld) const;
     void AddMesh(std::shared_ptr<CMesh> pMesh);
 
     // 模型参数统计
@@ -36,21 +48,33 @@ public:
     size_t GetTriangleCount() const { return m_totalTriangles; }
     size_t GetMeshCount() const { return m_meshes.size(); }
 
+    // 细节级别：网格导入时生成（CMesh::GenerateLODs），模型的级别数取各网格的最大值
+    // 每级误差取各网格该级误差的最大值，三角形数为各网格该级之和
+    size_t GetLODCount() const { return m_lodErrors.size(); }
+    float GetLODError(size_t lod) const { return m_lodErrors.empty() ? 0.0f : m_lodErrors[std::min(lod, m_lodErrors.size() - 1)]; }
+    size_t GetLODTriangleCount(size_t lod) const { return m_lodTriangles.empty() ? 0 : m_lodTriangles[std::min(lod, m_lodTriangles.size() - 1)]; }
+    // 按包围球的屏幕投影选择级别并记入控制器统计；current 为上一帧的级别（滞后用）
+    size_t SelectLOD(CLODController &controller, const Matrix4 &parentWorld, size_t current) const;
+
     // 名称相关
     void SetName(const std::wstring &name) { m_name = name; }
     const std::wstring &GetName() const { return m_name; }
+    const std::wstring &GetFilePath() const { return m_filePath; }
 
     // 模型变换
     void SetPosition(const Vector3 &position);
     void SetRotation(const Vector3 &eulerAngles);
     void SetScale(const Vector3 &scale);
     const Matrix4 &GetWorldMatrix() const;
+    const Matrix4 &GetInverseWorldMatrix() const; // 按需计算并缓存
 
     // 边界框
     const Vector3 &GetMinBounds() const { return m_minBounds; }
     const Vector3 &GetMaxBounds() const { return m_maxBounds; }
     const Vector3 &GetCenter() const { return m_center; }
     float GetRadius() const { return m_radius; }
+    AABB GetLocalBounds() const { return AABB(m_minBounds, m_maxBounds); }
+    AABB GetWorldBounds() const; // 局部包围盒经世界矩阵变换后的 AABB
     void DrawBoundingBox(const Vector3& color = Vector3(0, 1, 0)) const;
 
     BOOL IsPointInside(const Vector3 &point) const;
@@ -66,6 +90,9 @@ private:
     size_t m_totalVertices = 0; // 顶点数
     size_t m_totalTriangles = 0; // 三角面数
 
+    std::vector<float> m_lodErrors;     // 各级误差
+    std::vector<size_t> m_lodTriangles; // 各级三角形数
+
     // "Resources/Models/ANBY/"
     std::wstring m_directory; // 模型所在目录，用于纹理查找
     // "Resources/Models/ANBY/Anby.obj"
@@ -86,7 +113,8 @@ private:
     Vector3 m_center;
     float m_radius = 0.0f;
 
-    mutable Matrix4 m_invTransform; // 缓存逆矩阵
+    mutable Matrix4 m_invTransform;   // 缓存逆矩阵
+    mutable BOOL m_isInvDirty = TRUE; // 逆矩阵是否需要重新计算
 
     void ProcessNode(aiNode *node, const aiScene *scene, CResourceManager *pResMgr);    // 递归处理 Assimp 节点
     std::shared_ptr<CMesh> ProcessMesh(aiMesh *mesh, const aiScene *scene, CResourceManager *pResMgr); // 转换网格数据 将 Assimp 的网格转换为我们的 CMesh
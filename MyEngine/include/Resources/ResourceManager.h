@@ -69,6 +69,7 @@ public:
     // 天空盒
     void SetSkyboxPath(const std::wstring &path) { m_SkyboxPath = path; }
     std::wstring GetFullSkyboxPath(const std::wstring &filename) { return m_SkyboxPath + filename; }
+    // 按名称缓存，纹理由资源管理器持有，Shutdown 时释放
     GLuint LoadSkybox(const std::wstring& skyboxName);
     // ======================================================================
     // 清理资源
@@ -84,6 +85,7 @@ private:
     std::unordered_map<std::wstring, std::weak_ptr<CTexture>> m_Textures;
     std::unordered_map<std::wstring, std::weak_ptr<CModel>> m_Models;
     std::unordered_map<std::wstring, std::weak_ptr<CShader>> m_Shaders;
+    std::unordered_map<std::wstring, GLuint> m_Skyboxes; // 天空盒名 -> 立方体贴图
 
     // 兜底资源：当加载失败时返回，防止引擎崩溃
     std::shared_ptr<CTexture> m_DefaultTexture;
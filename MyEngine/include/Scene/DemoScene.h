@@ -28,6 +28,9 @@ public:
     void SetupGlobalLighting();
     void CleanupTextureState();
 
+protected:
+    virtual void OnSnapshotLoaded(const std::vector<std::shared_ptr<CEntity>> &entities) override;
+
 private:
     // 将关键实体存为成员，避免每帧 FindChild
     std::shared_ptr<CSkyboxEntity> m_pSkybox;
@@ -35,8 +38,8 @@ private:
     std::shared_ptr<CGridEntity> m_pGrid;
     std::shared_ptr<CModelEntity> m_pPossessedEntity;
 
-    // 动态实体列表
-    std::vector<std::shared_ptr<CEntity>> m_DynamicSnapEntities;
+    // 动态贴地实体存放在 m_Components 中（EntityLink + TerrainSnap）
+    std::vector<CComponentStore::Entity> m_StaleSnapLinks; // 对应实体已销毁，待移除
     void RegisterEntityForSnapping(std::shared_ptr<CEntity> pEntity, BOOL isDynamic);
 
     GLuint LoadSkybox();
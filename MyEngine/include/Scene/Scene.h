@@ -8,8 +8,23 @@
 #include <vector>
 #include <memory>
 #include "Core/Entity.h"
+#include "Core/ComponentStore.h"
+#include "Core/RenderQueue.h"
+#include "Core/StaticBatch.h"
+#include "Core/LODController.h"
+#include "Core/OcclusionBuffer.h"
 // ======================================================================
 
+// 视锥与遮挡剔除统计（最近一次 CullEntities）
+struct CullStats
+{
+    size_t tested;    // 参与剔除的实体（有包围盒的）
+    size_t visible;   // 最终可见
+    size_t culled;    // 在视锥外
+    size_t occluded;  // 在视锥内但被遮挡体完全挡住
+    size_t occluders; // 画进遮挡缓冲的遮挡体
+};
+
 class CScene
 {
 protected:
@@ -18,11 +33,39 @@ protected:
     BOOL m_bIsActive = FALSE;    // 是否激活状态
     BOOL m_bIsPaused = FALSE;    // 是否暂停状态
 
+    // 以下三个成员声明在 m_pRootEntity 之前，按逆序析构时晚于实体销毁，实体析构时还能从中注销；
+    // 不能把它们移到 m_pRootEntity 之后
+    CNameIndex m_NameIndex;                 // 根实体子树的名称/标签索引
+    CTickScheduler m_TickScheduler;         // 根实体子树的逐帧更新调度
+    CSpatialIndex m_SpatialIndex;           // 根实体子树的世界包围盒层次
     std::shared_ptr<CEntity> m_pRootEntity; // 根实体
+    CComponentStore m_Components;           // 批量处理的组件数据，通过 EntityLink 关联到实体
+    std::vector<unsigned int> m_VisibleIDs; // 视锥剔除的临时结果
+    CullStats m_CullStats = {};
+    CRenderQueue m_RenderQueue;             // 实体遍历时收集的网格绘制项
+    RenderQueueStats m_RenderStats = {};
+    CStaticBatch m_StaticBatch;                     // 静态实体预先合并的几何
+    std::vector<CStaticBatch::Draw> m_StaticDraws;  // 每帧可见部分的绘制列表
+    RenderQueueStats m_StaticStats = {};
+    CLODController m_LODController;                 // 模型细节级别的选择与统计
+    COcclusionBuffer m_OcclusionBuffer;             // 遮挡体光栅化的深度图
+    BOOL m_bOcclusionCulling = TRUE;
+    std::vector<AABB> m_OccludeeBounds;             // 遮挡测试的临时数据，与 m_OccludeeIDs 一一对应
+    std::vector<unsigned int> m_OccludeeIDs;
+    std::vector<uint8_t> m_OccludeeResults;
 
 public:
     CScene(const std::string &name) : m_Name(name) {}
-    virtual ~CScene() = default;
+    virtual ~CScene()
+    {
+        // 场景外仍持有的实体离开索引与调度，避免指向已销毁的 m_NameIndex / m_TickScheduler
+        if (m_pRootEntity)
+        {
+            m_pRootEntity->SetNameIndex(nullptr);
+            m_pRootEntity->SetTickScheduler(nullptr);
+            m_pRootEntity->SetSpatialIndex(nullptr);
+        }
+    }
 
     // 禁止拷贝
     CScene(const CScene &) = delete;
@@ -34,22 +77,132 @@ public:
     BOOL IsActive() const { return m_bIsActive; }         // 检查场景是否激活
     BOOL IsPaused() const { return m_bIsPaused; }         // 检查场景是否暂停
 
+    CComponentStore &GetComponents() { return m_Components; }      // 场景的组件仓库
+    CTickScheduler &GetTickScheduler() { return m_TickScheduler; } // 场景的逐帧更新调度
+    CSpatialIndex &GetSpatialIndex() { return m_SpatialIndex; }    // 场景的空间索引
+
+    // ======================================================================
+    // 实体查找：O(1) 走名称/标签索引，不遍历层级
+    // ======================================================================
+    // 根实体子树登记到场景的名称索引、空间索引与更新调度
+    void SetRootEntity(std::shared_ptr<CEntity> pRoot)
+    {
+        if (m_pRootEntity)
+        {
+            m_pRootEntity->SetNameIndex(nullptr);
+            m_pRootEntity->SetTickScheduler(nullptr);
+            m_pRootEntity->SetSpatialIndex(nullptr);
+        }
+        m_pRootEntity = pRoot;
+        if (m_pRootEntity)
+        {
+            m_pRootEntity->SetNameIndex(&m_NameIndex);
+            m_pRootEntity->SetTickScheduler(&m_TickScheduler);
+            // 整棵子树一次性建树，比逐个插入快且树更紧凑
+            m_SpatialIndex.BeginBulk();
+            m_pRootEntity->SetSpatialIndex(&m_SpatialIndex);
+            m_SpatialIndex.EndBulk();
+        }
+    }
+    std::shared_ptr<CEntity> GetRootEntity() const { return m_pRootEntity; }
+
+    // 按名称查找任意一个实体（同名时不保证是哪一个）
+    std::shared_ptr<CEntity> FindEntityByName(const std::wstring &name) const
+    {
+        return FindEntityByName(CNameIndex::FindName(name));
+    }
+    // 频繁查询时可缓存 CNameIndex::Intern 的结果，省去字符串哈希
+    std::shared_ptr<CEntity> FindEntityByName(CNameIndex::NameId nameId) const
+    {
+        CEntity *pEntity = CEntity::Find(m_NameIndex.FindFirst(nameId));
+        return pEntity ? pEntity->shared_from_this() : nullptr;
+    }
+
+    // 带标签的全部实体，追加到 out；返回找到的数量
+    size_t FindEntitiesWithTag(const std::wstring &tag, std::vector<std::shared_ptr<CEntity>> &out) const
+    {
+        const std::vector<unsigned int> &ids = m_NameIndex.FindTagged(CNameIndex::FindName(tag));
+        size_t found = 0;
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            if (CEntity *pEntity = CEntity::Find(ids[i]))
+            {
+                out.push_back(pEntity->shared_from_this());
+                ++found;
+            }
+        }
+        return found;
+    }
+
+    // ======================================================================
+    // 空间查询：走场景的 CSpatialIndex，只包含有包围盒的实体
+    // ======================================================================
+    // 每帧在世界矩阵更新之后调用，同步移动过的实体的世界包围盒
+    void UpdateBounds() { m_SpatialIndex.Update(); }
+
+    // 视锥剔除：每帧渲染前调用，标记视锥内的实体，Render 时跳过其余有包围盒的实体及其子树
+    // 没有包围盒的实体（天空盒、网格等）不参与剔除
+    // 给出 pViewProjection（相机的投影 * 观察）且开启遮挡剔除时，视锥内的遮挡体（CEntity::SetOccluder）
+    // 先在任务系统上光栅化，视锥内被它们完全挡住的实体同样不标记
+    const CullStats &CullEntities(const Frustum &frustum, const Matrix4 *pViewProjection = nullptr);
+    const CullStats &GetCullStats() const { return m_CullStats; }
+
+    void SetOcclusionCulling(BOOL enable) { m_bOcclusionCulling = enable; }
+    BOOL IsOcclusionCullingEnabled() const { return m_bOcclusionCulling; }
+    // 最近一次 CullEntities 的遮挡缓冲（调试显示深度用）
+    const COcclusionBuffer &GetOcclusionBuffer() const { return m_OcclusionBuffer; }
+
+    // 渲染队列：每帧渲染前设置相机（SetView），RenderEntities 遍历实体收集网格，排序后提交
+    CRenderQueue &GetRenderQueue() { return m_RenderQueue; }
+    const RenderQueueStats &GetRenderStats() const { return m_RenderStats; }
+
+    // 静态合批：根实体子树中的静态实体（CEntity::SetStatic）按材质合并进共享缓冲，之后不再单独绘制
+    // 场景放置完成后调用；静态实体移动或增删后重新调用。RenderEntities 按实体的剔除结果只画可见部分
+    void BuildStaticBatch();
+    void ReleaseStaticBatch(); // 释放合批与 OpenGL 缓冲，静态实体恢复单独绘制；场景 Shutdown 时调用
+    const CStaticBatch &GetStaticBatch() const { return m_StaticBatch; }
+    const RenderQueueStats &GetStaticStats() const { return m_StaticStats; }
+
+    // 细节级别：每帧渲染前设置相机（SetView），RenderEntities 期间模型实体按屏幕误差选择级别
+    CLODController &GetLODController() { return m_LODController; }
+
+    // 世界包围盒与球相交的实体，追加到 out；返回找到的数量
+    size_t FindEntitiesInRadius(const Vector3 &center, float radius, std::vector<std::shared_ptr<CEntity>> &out) const
+    {
+        std::vector<unsigned int> ids;
+        m_SpatialIndex.QuerySphere(center, radius, ids);
+        size_t found = 0;
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            if (CEntity *pEntity = CEntity::Find(ids[i]))
+            {
+                out.push_back(pEntity->shared_from_this());
+                ++found;
+            }
+        }
+        return found;
+    }
+
+    // 射线最先碰到的实体（按世界包围盒），没有时返回空；pDistance 返回沿 direction 的距离
+    std::shared_ptr<CEntity> PickEntity(const Vector3 &origin, const Vector3 &direction, float maxDistance, float *pDistance = nullptr) const
+    {
+        CEntity *pEntity = CEntity::Find(m_SpatialIndex.RayCast(origin, direction, maxDistance, pDistance));
+        return pEntity ? pEntity->shared_from_this() : nullptr;
+    }
+
     // ======================================================================
     // 生命周期方法
     // ======================================================================
     virtual BOOL Initialize() = 0; // 初始化场景
     virtual void Shutdown() = 0;   // 关闭场景
 
-    virtual void Render()
-    {
-        if (m_pRootEntity)
-            m_pRootEntity->Render();
-    }
+    virtual void Render() { RenderEntities(); }
 
+    // 按更新组依次调用实体的 Update，休眠、隐藏与按需的实体不产生开销
     virtual void Update(float deltaTime)
     {
-        if (m_pRootEntity && !m_bIsPaused)
-            m_pRootEntity->Update(deltaTime);
+        if (!m_bIsPaused)
+            m_TickScheduler.Tick(deltaTime);
     }
 
     virtual void OnActivate() {}   // 场景激活时调用
@@ -58,6 +211,22 @@ public:
     virtual void OnResume() {}     // 场景恢复时调用
 
     virtual void ProcessInput(FLOAT deltaTime) {} // 处理输入
+
+    // ======================================================================
+    // 场景快照（格式见 Core/SceneSnapshot.h）
+    // ======================================================================
+    // 按先序写出根实体子树
+    BOOL SaveSnapshot(const std::wstring &path) const;
+    // 映射快照文件并重建实体树；成功后关闭旧场景、替换根实体并调用 OnSnapshotLoaded
+    // 失败时旧场景保持不变
+    BOOL LoadSnapshot(const std::wstring &path);
+
+protected:
+    // 渲染根实体子树：模型网格进入渲染队列，其余实体仍按树的顺序直接绘制，遍历结束后先画静态合批再提交队列
+    void RenderEntities();
+
+    // 快照重建完成后调用，entities 与快照记录一一对应；子类在此恢复成员指针、组件等运行时状态
+    virtual void OnSnapshotLoaded(const std::vector<std::shared_ptr<CEntity>> &entities) { m_bInitialized = TRUE; }
 };
 
 #endif // __SCENE_H__
\ No newline at end of file
@@ -25,6 +25,7 @@ private:
 
     BOOL m_Initialized = FALSE;        // 是否已初始化
     BOOL m_SceneChangePending = FALSE; // 是否有场景切换请求
+    BOOL m_RestartPending = FALSE;     // 过渡中的切换是重启当前场景
     BOOL m_Paused = FALSE;             // 管理器是否暂停
     BOOL m_UpdateEnabled = TRUE;       // 是否启用更新
     BOOL m_RenderEnabled = TRUE;       // 是否启用渲染
@@ -48,6 +49,11 @@ private:
     void UpdateTransition(FLOAT deltaTime); // 更新场景过渡效果
     void RenderTransition();                // 渲染场景过渡效果
 
+    // 场景快照：初始状态在场景首次初始化后保存，重启时直接映射读回
+    std::wstring GetSnapshotPath(const std::string &sceneName, BOOL initial) const;
+    void SaveInitialSnapshot(std::shared_ptr<CScene> scene);
+    BOOL RestoreInitialState(std::shared_ptr<CScene> scene);
+
 public:
     std::shared_ptr<CTexture> m_texture;
     CSceneManager();
@@ -0,0 +1,289 @@
+#include "stdafx.h"
+#include "Core/ComponentStore.h"
+#include <cassert>
+#include <cstdlib>
+#include <mutex>
+
+const CComponentStore::Entity CComponentStore::INVALID_ENTITY;
+const uint32_t CComponentStore::MAX_COMPONENT_TYPES;
+const size_t CComponentStore::CHUNK_SIZE;
+
+namespace
+{
+    // 所有列按 16 字节对齐，满足任何允许的组件类型
+    const size_t COLUMN_ALIGNMENT = 16;
+
+    size_t AlignUp(size_t value)
+    {
+        return (value + COLUMN_ALIGNMENT - 1) / COLUMN_ALIGNMENT * COLUMN_ALIGNMENT;
+    }
+
+    struct TypeTable
+    {
+        std::mutex mutex;
+        std::vector<size_t> sizes;
+    };
+
+    TypeTable &GetTypeTable()
+    {
+        static TypeTable s_table;
+        return s_table;
+    }
+}
+
+CComponentStore::CComponentStore()
+{
+    // 0 号原型为不带任何组件的空原型
+    FindOrCreateArchetype(0);
+}
+
+CComponentStore::~CComponentStore()
+{
+    for (size_t a = 0; a < m_archetypes.size(); ++a)
+    {
+        for (size_t c = 0; c < m_archetypes[a].chunks.size(); ++c)
+            ::operator delete(m_archetypes[a].chunks[c]);
+    }
+}
+
+// ======================================================================
+// 组件类型
+// ======================================================================
+uint32_t CComponentStore::RegisterType(size_t size)
+{
+    TypeTable &table = GetTypeTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    // 类型数超过掩码位数是编程错误，发布版同样立即终止
+    assert(table.sizes.size() < MAX_COMPONENT_TYPES && "组件类型超过 MAX_COMPONENT_TYPES");
+    if (table.sizes.size() >= MAX_COMPONENT_TYPES)
+        abort();
+    table.sizes.push_back(size);
+    return (uint32_t)table.sizes.size() - 1;
+}
+
+size_t CComponentStore::GetTypeSize(uint32_t type)
+{
+    TypeTable &table = GetTypeTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    return table.sizes[type];
+}
+
+// ======================================================================
+// 原型
+// ======================================================================
+uint32_t CComponentStore::FindOrCreateArchetype(ComponentMask mask)
+{
+    auto it = m_archetypeOf.find(mask);
+    if (it != m_archetypeOf.end())
+        return it->second;
+
+    Archetype arch;
+    arch.mask = mask;
+    arch.count = 0;
+    memset(arch.columnOf, -1, sizeof(arch.columnOf));
+
+    size_t rowBytes = sizeof(Entity);
+    for (uint32_t type = 0; type < MAX_COMPONENT_TYPES; ++type)
+    {
+        if (!(mask & (ComponentMask(1) << type)))
+            continue;
+        Column column = {type, (uint32_t)GetTypeSize(type), 0};
+        arch.columnOf[type] = (int8_t)arch.columns.size();
+        arch.columns.push_back(column);
+        rowBytes += column.size;
+    }
+
+    // 先按无填充估算每块行数，再按列对齐排布，放不下就逐行减少
+    size_t capacity = CHUNK_SIZE / rowBytes;
+    if (capacity == 0)
+        capacity = 1;
+    for (;;)
+    {
+        size_t offset = AlignUp(capacity * sizeof(Entity));
+        for (size_t c = 0; c < arch.columns.size(); ++c)
+        {
+            arch.columns[c].offset = offset;
+            offset = AlignUp(offset + capacity * arch.columns[c].size);
+        }
+        if (offset <= CHUNK_SIZE || capacity == 1)
+        {
+            arch.chunkBytes = offset > CHUNK_SIZE ? offset : CHUNK_SIZE;
+            break;
+        }
+        --capacity;
+    }
+    arch.capacity = (uint32_t)capacity;
+
+    uint32_t index = (uint32_t)m_archetypes.size();
+    m_archetypes.push_back(std::move(arch));
+    m_archetypeOf[mask] = index;
+    return index;
+}
+
+size_t CComponentStore::GetChunkCount() const
+{
+    size_t count = 0;
+    for (size_t a = 0; a < m_archetypes.size(); ++a)
+        count += m_archetypes[a].chunks.size();
+    return count;
+}
+
+uint32_t CComponentStore::AllocateRow(Archetype &arch, Entity entity)
+{
+    uint32_t row = (uint32_t)arch.count;
+    if (row / arch.capacity >= arch.chunks.size())
+        arch.chunks.push_back(static_cast<uint8_t *>(::operator new(arch.chunkBytes)));
+    ++arch.count;
+    *EntityAddress(arch, row) = entity;
+    return row;
+}
+
+void CComponentStore::RemoveRow(Archetype &arch, uint32_t row)
+{
+    // 用最后一行填补空位，保持所有行连续
+    uint32_t last = (uint32_t)arch.count - 1;
+    if (row != last)
+    {
+        Entity moved = *EntityAddress(arch, last);
+        *EntityAddress(arch, row) = moved;
+        for (size_t c = 0; c < arch.columns.size(); ++c)
+            memcpy(ColumnAddress(arch, row, arch.columns[c]), ColumnAddress(arch, last, arch.columns[c]), arch.columns[c].size);
+        m_records[moved & INDEX_MASK].row = row;
+    }
+    --arch.count;
+}
+
+void CComponentStore::MoveToArchetype(Entity entity, uint32_t archetype)
+{
+    Record &record = m_records[entity & INDEX_MASK];
+    Archetype &src = m_archetypes[record.archetype];
+    Archetype &dst = m_archetypes[archetype];
+    uint32_t srcRow = record.row;
+    uint32_t dstRow = AllocateRow(dst, entity);
+
+    // 两个原型共有的组件按字节搬过去，新增的组件由调用方写入
+    for (size_t c = 0; c < dst.columns.size(); ++c)
+    {
+        int8_t srcColumn = src.columnOf[dst.columns[c].type];
+        if (srcColumn >= 0)
+            memcpy(ColumnAddress(dst, dstRow, dst.columns[c]), ColumnAddress(src, srcRow, src.columns[srcColumn]), dst.columns[c].size);
+    }
+
+    RemoveRow(src, srcRow);
+    record.archetype = archetype;
+    record.row = dstRow;
+}
+
+// ======================================================================
+// 实体
+// ======================================================================
+CComponentStore::Entity CComponentStore::Create()
+{
+    return CreateInArchetype(0);
+}
+
+CComponentStore::Entity CComponentStore::CreateInArchetype(uint32_t archetype)
+{
+    uint32_t index;
+    if (m_freeHead != NO_SLOT)
+    {
+        index = m_freeHead;
+        m_freeHead = m_records[index].nextFree;
+    }
+    else
+    {
+        index = (uint32_t)m_records.size();
+        Record record = {NO_ARCHETYPE, 0, 1, NO_SLOT};
+        m_records.push_back(record);
+    }
+
+    Record &record = m_records[index];
+    Entity entity = (record.generation << INDEX_BITS) | index;
+    record.archetype = archetype;
+    record.row = AllocateRow(m_archetypes[archetype], entity);
+    record.nextFree = NO_SLOT;
+    ++m_entityCount;
+    return entity;
+}
+
+void CComponentStore::Destroy(Entity entity)
+{
+    if (!IsAlive(entity))
+        return;
+
+    uint32_t index = entity & INDEX_MASK;
+    Record &record = m_records[index];
+    RemoveRow(m_archetypes[record.archetype], record.row);
+
+    record.archetype = NO_ARCHETYPE;
+    record.generation = (record.generation + 1) & GENERATION_MASK;
+    if (record.generation == 0)
+        record.generation = 1;
+    record.nextFree = m_freeHead;
+    m_freeHead = index;
+    --m_entityCount;
+}
+
+void CComponentStore::Clear()
+{
+    // 块与原型保留以便复用，所有实体 ID 失效
+    for (size_t a = 0; a < m_archetypes.size(); ++a)
+        m_archetypes[a].count = 0;
+    for (uint32_t i = 0; i < (uint32_t)m_records.size(); ++i)
+    {
+        Record &record = m_records[i];
+        if (record.archetype == NO_ARCHETYPE)
+            continue;
+        record.archetype = NO_ARCHETYPE;
+        record.generation = (record.generation + 1) & GENERATION_MASK;
+        if (record.generation == 0)
+            record.generation = 1;
+        record.nextFree = m_freeHead;
+        m_freeHead = i;
+    }
+    m_entityCount = 0;
+}
+
+// ======================================================================
+// 组件
+// ======================================================================
+CComponentStore::ComponentMask CComponentStore::GetMask(Entity entity) const
+{
+    if (!IsAlive(entity))
+        return 0;
+    return m_archetypes[m_records[entity & INDEX_MASK].archetype].mask;
+}
+
+void *CComponentStore::GetComponent(Entity entity, uint32_t type)
+{
+    if (!IsAlive(entity))
+        return nullptr;
+    const Record &record = m_records[entity & INDEX_MASK];
+    Archetype &arch = m_archetypes[record.archetype];
+    int8_t column = arch.columnOf[type];
+    return column < 0 ? nullptr : ColumnAddress(arch, record.row, arch.columns[column]);
+}
+
+void *CComponentStore::AddComponent(Entity entity, uint32_t type)
+{
+    if (!IsAlive(entity))
+        return nullptr;
+
+    const Record &record = m_records[entity & INDEX_MASK];
+    ComponentMask mask = m_archetypes[record.archetype].mask | (ComponentMask(1) << type);
+    if (mask != m_archetypes[record.archetype].mask)
+        MoveToArchetype(entity, FindOrCreateArchetype(mask));
+    return GetComponent(entity, type);
+}
+
+void CComponentStore::RemoveComponent(Entity entity, uint32_t type)
+{
+    if (!IsAlive(entity))
+        return;
+
+    const Record &record = m_records[entity & INDEX_MASK];
+    ComponentMask bit = ComponentMask(1) << type;
+    ComponentMask mask = m_archetypes[record.archetype].mask;
+    if (mask & bit)
+        MoveToArchetype(entity, FindOrCreateArchetype(mask & ~bit));
+}
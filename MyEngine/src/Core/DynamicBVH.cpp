@@ -0,0 +1,599 @@
+#include "stdafx.h"
+#include "Core/DynamicBVH.h"
+#include <algorithm>
+
+const CDynamicBVH::ProxyId CDynamicBVH::INVALID_PROXY;
+const uint32_t CDynamicBVH::NULL_NODE;
+
+namespace
+{
+    const int SAH_BINS = 16;
+
+    // 外扩的预测系数：沿位移方向多留出几帧的余量
+    const float DISPLACEMENT_MULTIPLIER = 4.0f;
+
+    float Axis(const Vector3 &v, int axis) { return axis == 0 ? v.x : (axis == 1 ? v.y : v.z); }
+}
+
+// ======================================================================
+// 节点分配
+// ======================================================================
+uint32_t CDynamicBVH::AllocateNode()
+{
+    uint32_t node;
+    if (m_freeList != NULL_NODE)
+    {
+        node = m_freeList;
+        m_freeList = m_nodes[node].parent;
+    }
+    else
+    {
+        node = (uint32_t)m_nodes.size();
+        m_nodes.push_back(Node());
+    }
+
+    Node &n = m_nodes[node];
+    n.parent = NULL_NODE;
+    n.child1 = NULL_NODE;
+    n.child2 = NULL_NODE;
+    n.height = 0;
+    n.userData = 0;
+    n.pending = false;
+    return node;
+}
+
+void CDynamicBVH::FreeNode(uint32_t node)
+{
+    m_nodes[node].parent = m_freeList;
+    m_nodes[node].height = -1;
+    m_freeList = node;
+}
+
+AABB CDynamicBVH::Fatten(const AABB &box, const Vector3 &displacement) const
+{
+    Vector3 margin(m_margin, m_margin, m_margin);
+    AABB fat(box.min - margin, box.max + margin);
+
+    Vector3 d = displacement * DISPLACEMENT_MULTIPLIER;
+    if (d.x < 0.0f) fat.min.x += d.x; else fat.max.x += d.x;
+    if (d.y < 0.0f) fat.min.y += d.y; else fat.max.y += d.y;
+    if (d.z < 0.0f) fat.min.z += d.z; else fat.max.z += d.z;
+    return fat;
+}
+
+// ======================================================================
+// 代理
+// ======================================================================
+CDynamicBVH::ProxyId CDynamicBVH::CreateProxy(const AABB &box, uint32_t userData)
+{
+    uint32_t leaf = AllocateNode();
+    Node &node = m_nodes[leaf];
+    node.box = Fatten(box, Vector3::Zero());
+    node.userData = userData;
+    ++m_proxyCount;
+
+    if (m_bBulk)
+    {
+        node.pending = true;
+        m_pending.push_back(leaf);
+    }
+    else
+        InsertLeaf(leaf);
+    return leaf;
+}
+
+void CDynamicBVH::DestroyProxy(ProxyId proxy)
+{
+    if (m_nodes[proxy].pending)
+        m_pending.erase(std::find(m_pending.begin(), m_pending.end(), proxy));
+    else
+        RemoveLeaf(proxy);
+    FreeNode(proxy);
+    --m_proxyCount;
+}
+
+bool CDynamicBVH::MoveProxy(ProxyId proxy, const AABB &box, const Vector3 &displacement)
+{
+    Node &node = m_nodes[proxy];
+    if (node.box.Contains(box))
+        return false;
+
+    node.box = Fatten(box, displacement);
+    if (node.pending)
+        return false;
+
+    RemoveLeaf(proxy);
+    InsertLeaf(proxy);
+    return true;
+}
+
+// ======================================================================
+// 增量插入与删除
+// ======================================================================
+void CDynamicBVH::InsertLeaf(uint32_t leaf)
+{
+    if (m_root == NULL_NODE)
+    {
+        m_root = leaf;
+        m_nodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    // 1. 自上而下选择兄弟节点：比较"在此处成为兄弟"与"继续下降到某个子节点"的表面积代价
+    const AABB leafBox = m_nodes[leaf].box;
+    uint32_t index = m_root;
+    while (!m_nodes[index].IsLeaf())
+    {
+        const Node &node = m_nodes[index];
+        float area = node.box.GetSurfaceArea();
+        float combinedArea = node.box.Merged(leafBox).GetSurfaceArea();
+
+        // 在这里新建父节点的代价；下降时祖先包围盒都要扩大，扩大部分计入继承代价
+        float cost = 2.0f * combinedArea;
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        float childCost[2];
+        uint32_t children[2] = {node.child1, node.child2};
+        for (int i = 0; i < 2; ++i)
+        {
+            const Node &child = m_nodes[children[i]];
+            float merged = child.box.Merged(leafBox).GetSurfaceArea();
+            childCost[i] = (child.IsLeaf() ? merged : merged - child.box.GetSurfaceArea()) + inheritanceCost;
+        }
+
+        if (cost < childCost[0] && cost < childCost[1])
+            break;
+        index = childCost[0] < childCost[1] ? children[0] : children[1];
+    }
+    uint32_t sibling = index;
+
+    // 2. 新建父节点替换兄弟节点的位置
+    uint32_t oldParent = m_nodes[sibling].parent;
+    uint32_t newParent = AllocateNode();
+    Node &parent = m_nodes[newParent];
+    parent.parent = oldParent;
+    parent.box = leafBox.Merged(m_nodes[sibling].box);
+    parent.height = m_nodes[sibling].height + 1;
+    parent.child1 = sibling;
+    parent.child2 = leaf;
+    m_nodes[sibling].parent = newParent;
+    m_nodes[leaf].parent = newParent;
+
+    if (oldParent != NULL_NODE)
+    {
+        if (m_nodes[oldParent].child1 == sibling)
+            m_nodes[oldParent].child1 = newParent;
+        else
+            m_nodes[oldParent].child2 = newParent;
+    }
+    else
+        m_root = newParent;
+
+    // 3. 向上修正包围盒与高度
+    RefitUpwards(m_nodes[leaf].parent);
+}
+
+void CDynamicBVH::RemoveLeaf(uint32_t leaf)
+{
+    if (leaf == m_root)
+    {
+        m_root = NULL_NODE;
+        return;
+    }
+
+    // 父节点由兄弟节点顶替
+    uint32_t parent = m_nodes[leaf].parent;
+    uint32_t grandParent = m_nodes[parent].parent;
+    uint32_t sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+    if (grandParent != NULL_NODE)
+    {
+        if (m_nodes[grandParent].child1 == parent)
+            m_nodes[grandParent].child1 = sibling;
+        else
+            m_nodes[grandParent].child2 = sibling;
+        m_nodes[sibling].parent = grandParent;
+        FreeNode(parent);
+        RefitUpwards(grandParent);
+    }
+    else
+    {
+        m_root = sibling;
+        m_nodes[sibling].parent = NULL_NODE;
+        FreeNode(parent);
+    }
+    m_nodes[leaf].parent = NULL_NODE;
+}
+
+void CDynamicBVH::RefitUpwards(uint32_t index)
+{
+    while (index != NULL_NODE)
+    {
+        index = Balance(index);
+
+        Node &node = m_nodes[index];
+        const Node &child1 = m_nodes[node.child1];
+        const Node &child2 = m_nodes[node.child2];
+        node.height = 1 + std::max(child1.height, child2.height);
+        node.box = child1.box.Merged(child2.box);
+        index = node.parent;
+    }
+}
+
+// 子树高度差超过 1 时把较高的子节点旋转上来，返回旋转后位于该位置的节点
+uint32_t CDynamicBVH::Balance(uint32_t iA)
+{
+    Node *A = &m_nodes[iA];
+    if (A->IsLeaf() || A->height < 2)
+        return iA;
+
+    uint32_t iB = A->child1;
+    uint32_t iC = A->child2;
+    Node *B = &m_nodes[iB];
+    Node *C = &m_nodes[iC];
+    int balance = C->height - B->height;
+
+    if (balance > 1)
+    {
+        // C 上移
+        uint32_t iF = C->child1;
+        uint32_t iG = C->child2;
+        Node *F = &m_nodes[iF];
+        Node *G = &m_nodes[iG];
+
+        C->child1 = iA;
+        C->parent = A->parent;
+        A->parent = iC;
+        if (C->parent != NULL_NODE)
+        {
+            if (m_nodes[C->parent].child1 == iA)
+                m_nodes[C->parent].child1 = iC;
+            else
+                m_nodes[C->parent].child2 = iC;
+        }
+        else
+            m_root = iC;
+
+        // 较高的孙节点留在 C 下，较矮的交给 A
+        if (F->height > G->height)
+        {
+            C->child2 = iF;
+            A->child2 = iG;
+            G->parent = iA;
+            A->box = B->box.Merged(G->box);
+            C->box = A->box.Merged(F->box);
+            A->height = 1 + std::max(B->height, G->height);
+            C->height = 1 + std::max(A->height, F->height);
+        }
+        else
+        {
+            C->child2 = iG;
+            A->child2 = iF;
+            F->parent = iA;
+            A->box = B->box.Merged(F->box);
+            C->box = A->box.Merged(G->box);
+            A->height = 1 + std::max(B->height, F->height);
+            C->height = 1 + std::max(A->height, G->height);
+        }
+        return iC;
+    }
+
+    if (balance < -1)
+    {
+        // B 上移
+        uint32_t iD = B->child1;
+        uint32_t iE = B->child2;
+        Node *D = &m_nodes[iD];
+        Node *E = &m_nodes[iE];
+
+        B->child1 = iA;
+        B->parent = A->parent;
+        A->parent = iB;
+        if (B->parent != NULL_NODE)
+        {
+            if (m_nodes[B->parent].child1 == iA)
+                m_nodes[B->parent].child1 = iB;
+            else
+                m_nodes[B->parent].child2 = iB;
+        }
+        else
+            m_root = iB;
+
+        if (D->height > E->height)
+        {
+            B->child2 = iD;
+            A->child1 = iE;
+            E->parent = iA;
+            A->box = C->box.Merged(E->box);
+            B->box = A->box.Merged(D->box);
+            A->height = 1 + std::max(C->height, E->height);
+            B->height = 1 + std::max(A->height, D->height);
+        }
+        else
+        {
+            B->child2 = iE;
+            A->child1 = iD;
+            D->parent = iA;
+            A->box = C->box.Merged(D->box);
+            B->box = A->box.Merged(E->box);
+            A->height = 1 + std::max(C->height, D->height);
+            B->height = 1 + std::max(A->height, E->height);
+        }
+        return iB;
+    }
+
+    return iA;
+}
+
+// ======================================================================
+// 批量构建
+// ======================================================================
+void CDynamicBVH::EndBulk()
+{
+    m_bBulk = false;
+    if (m_pending.empty())
+        return;
+
+    // 待入树的叶子不少于已有叶子时整树重建，否则逐个插入更省
+    size_t existing = m_proxyCount - m_pending.size();
+    if (m_pending.size() >= existing)
+    {
+        Rebuild();
+        return;
+    }
+
+    for (size_t i = 0; i < m_pending.size(); ++i)
+    {
+        m_nodes[m_pending[i]].pending = false;
+        InsertLeaf(m_pending[i]);
+    }
+    m_pending.clear();
+}
+
+void CDynamicBVH::Rebuild()
+{
+    // 1. 收集全部叶子（含待入树的），释放所有内部节点
+    std::vector<uint32_t> leaves;
+    leaves.reserve(m_proxyCount);
+    for (uint32_t i = 0; i < (uint32_t)m_nodes.size(); ++i)
+    {
+        Node &node = m_nodes[i];
+        if (node.height < 0)
+            continue;
+        if (node.IsLeaf())
+        {
+            node.parent = NULL_NODE;
+            node.pending = false;
+            leaves.push_back(i);
+        }
+        else
+            FreeNode(i);
+    }
+    m_pending.clear();
+
+    m_root = leaves.empty() ? NULL_NODE : BuildTopDown(leaves);
+}
+
+// 分箱 SAH 自顶向下构建，用显式栈代替递归（SAH 可能切出很深的链）
+uint32_t CDynamicBVH::BuildTopDown(std::vector<uint32_t> &leaves)
+{
+    struct Task
+    {
+        uint32_t begin;
+        uint32_t end;
+        uint32_t parent;
+        bool first; // 作为 parent 的 child1
+    };
+
+    std::vector<Vector3> centers(m_nodes.size());
+    for (size_t i = 0; i < leaves.size(); ++i)
+        centers[leaves[i]] = m_nodes[leaves[i]].box.GetCenter();
+
+    m_buildOrder.clear();
+    uint32_t root = NULL_NODE;
+    std::vector<Task> tasks;
+    Task first = {0, (uint32_t)leaves.size(), NULL_NODE, true};
+    tasks.push_back(first);
+
+    while (!tasks.empty())
+    {
+        Task task = tasks.back();
+        tasks.pop_back();
+
+        uint32_t node;
+        uint32_t count = task.end - task.begin;
+        if (count == 1)
+        {
+            node = leaves[task.begin];
+        }
+        else
+        {
+            // 1. 质心范围，取最长轴
+            AABB centroidBounds;
+            for (uint32_t i = task.begin; i < task.end; ++i)
+                centroidBounds.Expand(centers[leaves[i]]);
+            Vector3 extent = centroidBounds.GetSize();
+            int axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : (extent.y >= extent.z ? 1 : 2);
+            float axisMin = Axis(centroidBounds.min, axis);
+            float axisExtent = Axis(extent, axis);
+
+            uint32_t mid = task.begin + count / 2;
+            if (axisExtent > 0.0f)
+            {
+                // 2. 分箱并扫描每个切分位置的代价：左右表面积 * 数量
+                AABB binBox[SAH_BINS];
+                uint32_t binCount[SAH_BINS] = {};
+                const float scale = SAH_BINS / axisExtent;
+                auto binOf = [&](uint32_t leaf) {
+                    int b = (int)((Axis(centers[leaf], axis) - axisMin) * scale);
+                    return std::min(std::max(b, 0), SAH_BINS - 1);
+                };
+                for (uint32_t i = task.begin; i < task.end; ++i)
+                {
+                    int b = binOf(leaves[i]);
+                    ++binCount[b];
+                    binBox[b].Expand(m_nodes[leaves[i]].box);
+                }
+
+                float rightArea[SAH_BINS];
+                uint32_t rightCount[SAH_BINS];
+                AABB accum;
+                uint32_t accumCount = 0;
+                for (int b = SAH_BINS - 1; b > 0; --b)
+                {
+                    accum.Expand(binBox[b]);
+                    accumCount += binCount[b];
+                    rightArea[b] = accumCount ? accum.GetSurfaceArea() : 0.0f;
+                    rightCount[b] = accumCount;
+                }
+
+                float bestCost = Math::FLOAT_MAX;
+                int bestSplit = -1;
+                accum = AABB();
+                accumCount = 0;
+                for (int b = 0; b < SAH_BINS - 1; ++b)
+                {
+                    accum.Expand(binBox[b]);
+                    accumCount += binCount[b];
+                    if (accumCount == 0 || rightCount[b + 1] == 0)
+                        continue;
+                    float cost = accum.GetSurfaceArea() * accumCount + rightArea[b + 1] * rightCount[b + 1];
+                    if (cost < bestCost)
+                    {
+                        bestCost = cost;
+                        bestSplit = b;
+                    }
+                }
+
+                if (bestSplit >= 0)
+                {
+                    uint32_t *pMid = std::partition(&leaves[task.begin], &leaves[0] + task.end,
+                                                    [&](uint32_t leaf) { return binOf(leaf) <= bestSplit; });
+                    mid = (uint32_t)(pMid - &leaves[0]);
+                }
+                else
+                {
+                    // 质心落在同一个箱内：按中位数切分
+                    std::nth_element(&leaves[task.begin], &leaves[mid], &leaves[0] + task.end,
+                                     [&](uint32_t a, uint32_t b) { return Axis(centers[a], axis) < Axis(centers[b], axis); });
+                }
+            }
+
+            node = AllocateNode();
+            m_buildOrder.push_back(node);
+            Task left = {task.begin, mid, node, true};
+            Task right = {mid, task.end, node, false};
+            tasks.push_back(right);
+            tasks.push_back(left);
+        }
+
+        m_nodes[node].parent = task.parent;
+        if (task.parent == NULL_NODE)
+            root = node;
+        else if (task.first)
+            m_nodes[task.parent].child1 = node;
+        else
+            m_nodes[task.parent].child2 = node;
+    }
+
+    // 子节点总在父节点之后分配，逆序即可自底向上计算包围盒与高度
+    for (size_t i = m_buildOrder.size(); i-- > 0;)
+    {
+        Node &node = m_nodes[m_buildOrder[i]];
+        const Node &child1 = m_nodes[node.child1];
+        const Node &child2 = m_nodes[node.child2];
+        node.box = child1.box.Merged(child2.box);
+        node.height = 1 + std::max(child1.height, child2.height);
+    }
+    return root;
+}
+
+// ======================================================================
+// 统计与校验
+// ======================================================================
+float CDynamicBVH::GetAreaRatio() const
+{
+    if (m_root == NULL_NODE)
+        return 0.0f;
+
+    float total = 0.0f;
+    for (size_t i = 0; i < m_nodes.size(); ++i)
+    {
+        const Node &node = m_nodes[i];
+        if (node.height > 0)
+            total += node.box.GetSurfaceArea();
+    }
+    float rootArea = m_nodes[m_root].box.GetSurfaceArea();
+    return rootArea > 0.0f ? total / rootArea : 0.0f;
+}
+
+int CDynamicBVH::ValidateNode(uint32_t index, uint32_t parent, size_t &leafCount) const
+{
+    const Node &node = m_nodes[index];
+    if (node.parent != parent || node.height < 0 || node.pending)
+        return -1;
+    if (node.IsLeaf())
+    {
+        ++leafCount;
+        return node.height == 0 ? 0 : -1;
+    }
+
+    int h1 = ValidateNode(node.child1, index, leafCount);
+    int h2 = ValidateNode(node.child2, index, leafCount);
+    if (h1 < 0 || h2 < 0 || node.height != 1 + std::max(h1, h2))
+        return -1;
+    if (!node.box.Contains(m_nodes[node.child1].box) || !node.box.Contains(m_nodes[node.child2].box))
+        return -1;
+    return node.height;
+}
+
+bool CDynamicBVH::Validate() const
+{
+    size_t leafCount = 0;
+    if (m_root != NULL_NODE && ValidateNode(m_root, NULL_NODE, leafCount) < 0)
+        return false;
+    return leafCount + m_pending.size() == m_proxyCount;
+}
+
+void CDynamicBVH::Clear()
+{
+    m_nodes.clear();
+    m_root = NULL_NODE;
+    m_freeList = NULL_NODE;
+    m_proxyCount = 0;
+    m_bBulk = false;
+    m_pending.clear();
+}
+
+// ======================================================================
+// 相交测试
+// ======================================================================
+bool CDynamicBVH::RayHitsBox(const AABB &box, const Vector3 &origin, const Vector3 &invDirection, float maxDistance, float &enter)
+{
+    float t1 = (box.min.x - origin.x) * invDirection.x;
+    float t2 = (box.max.x - origin.x) * invDirection.x;
+    float tMin = std::min(t1, t2);
+    float tMax = std::max(t1, t2);
+
+    t1 = (box.min.y - origin.y) * invDirection.y;
+    t2 = (box.max.y - origin.y) * invDirection.y;
+    tMin = std::max(tMin, std::min(t1, t2));
+    tMax = std::min(tMax, std::max(t1, t2));
+
+    t1 = (box.min.z - origin.z) * invDirection.z;
+    t2 = (box.max.z - origin.z) * invDirection.z;
+    tMin = std::max(tMin, std::min(t1, t2));
+    tMax = std::min(tMax, std::max(t1, t2));
+
+    // 起点在盒内时进入距离为 0
+    tMin = std::max(tMin, 0.0f);
+    enter = tMin;
+    return tMin <= tMax && tMin <= maxDistance;
+}
+
+bool CDynamicBVH::SphereHitsBox(const AABB &box, const Vector3 &center, float radiusSq)
+{
+    // 盒上离球心最近的点
+    Vector3 closest = Vector3::Max(box.min, Vector3::Min(center, box.max));
+    return (closest - center).LengthSquared() <= radiusSq;
+}
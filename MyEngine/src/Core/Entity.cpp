@@ -1,26 +1,63 @@
 ﻿
 // ======================================================================
 #include "stdafx.h"
-#include <queue>
 #include "Core/Entity.h"
+#include "Core/SceneSnapshot.h"
 #include "Resources/Model.h"
 // ======================================================================
 
-// 静态变量初始化
-unsigned int CEntity::s_nextID = 0;
+CNameIndex::NameId CEntity::GetDefaultNameId()
+{
+    static const CNameIndex::NameId s_defaultName = CNameIndex::Intern(L"New Entity");
+    return s_defaultName;
+}
+
+CEntity::Registry &CEntity::GetRegistry()
+{
+    static Registry s_registry;
+    return s_registry;
+}
 
 CEntity::CEntity()
-    : m_uID(++s_nextID),                  //
-      m_name(L"New Entity"),              //
+    : m_uID(GetRegistry().Allocate(this)), //
       m_position(0.0f, 0.0f, 0.0f),       //
       m_rotation(Quaternion::Identity()), //
       m_scale(1.0f, 1.0f, 1.0f),          //
-      m_bWorldDirty(TRUE),                //
       m_bVisible(TRUE),                   //
       m_bSnapToTerrain(FALSE),            //
-      m_fTerrainOffset(0.0f)              //
+      m_fTerrainOffset(0.0f),             //
+      m_hTransform(CTransformStore::GetInstance().Create())
 {
-    m_cachedWorldMatrix = Matrix4::Identity();
+}
+
+CEntity::~CEntity()
+{
+    // 从场景索引中移除自己；仍存活的子节点离开场景
+    if (m_pNameIndex)
+    {
+        m_pNameIndex->RemoveName(m_uID, m_nameId);
+        for (size_t i = 0; i < m_tags.size(); ++i)
+            m_pNameIndex->RemoveTag(m_uID, m_tags[i]);
+        for (auto &pChild : m_children)
+            pChild->SetNameIndex(nullptr);
+    }
+    if (m_pTickScheduler)
+    {
+        m_pTickScheduler->Unregister(m_hTick);
+        for (auto &pChild : m_children)
+            pChild->SetTickContext(nullptr, FALSE);
+    }
+    if (m_pSpatialIndex)
+    {
+        if (m_hSpatial != CSpatialIndex::INVALID_HANDLE)
+            m_pSpatialIndex->Remove(m_hSpatial);
+        for (auto &pChild : m_children)
+            pChild->SetSpatialIndex(nullptr);
+    }
+
+    // 仍存活的子节点在变换层级中变为根节点，与 m_pParent 失效后的行为一致
+    CTransformStore::GetInstance().Destroy(m_hTransform);
+    GetRegistry().Release(m_uID);
 }
 
 void CEntity::SetParent(std::shared_ptr<CEntity> pParent)
@@ -30,6 +67,10 @@ void CEntity::SetParent(std::shared_ptr<CEntity> pParent)
     if (pCurrentParent == pParent)
         return;
 
+    // 新父节点是自己或自己的后代时忽略，避免形成环
+    if (!CTransformStore::GetInstance().SetParent(m_hTransform, pParent ? pParent->m_hTransform : CTransformStore::INVALID_HANDLE))
+        return;
+
     // 2. 如果存在旧父节点，先从旧父节点的子列表中移除自己
     if (pCurrentParent)
     {
@@ -49,7 +90,10 @@ void CEntity::SetParent(std::shared_ptr<CEntity> pParent)
         m_pParent.reset();
     }
 
-    MarkDirty();
+    // 4. 子树跟随新父节点进入/离开场景索引与更新调度，并继承父节点的休眠状态
+    SetNameIndex(pParent ? pParent->m_pNameIndex : nullptr);
+    SetSpatialIndex(pParent ? pParent->m_pSpatialIndex : nullptr);
+    SetTickContext(pParent ? pParent->m_pTickScheduler : nullptr, pParent ? !pParent->IsTickEnabled() : FALSE);
 }
 
 void CEntity::AddChild(std::shared_ptr<CEntity> pChild)
@@ -62,20 +106,20 @@ void CEntity::AddChild(std::shared_ptr<CEntity> pChild)
 
 BOOL CEntity::RemoveChild(unsigned int id)
 {
-    auto itMap = m_childrenMap.find(id);
-    if (itMap != m_childrenMap.end())
+    auto it = std::find_if(m_children.begin(), m_children.end(),
+                           [id](const std::shared_ptr<CEntity> &pChild) { return pChild->m_uID == id; });
+    if (it != m_children.end())
     {
-        std::shared_ptr<CEntity> pChild = itMap->second;
-
-        // 1. 从 Map 移除
-        m_childrenMap.erase(itMap);
-
-        // 2. 从 Vector 移除
-        m_children.erase(std::remove(m_children.begin(), m_children.end(), pChild), m_children.end());
+        // 1. 从 Vector 移除（保持其余子节点顺序）
+        std::shared_ptr<CEntity> pChild = *it;
+        m_children.erase(it);
 
-        // 3. 重置子节点的父指针
+        // 2. 重置子节点的父指针
         pChild->m_pParent.reset();
-        pChild->MarkDirty();
+        CTransformStore::GetInstance().SetParent(pChild->m_hTransform, CTransformStore::INVALID_HANDLE);
+        pChild->SetNameIndex(nullptr);
+        pChild->SetSpatialIndex(nullptr);
+        pChild->SetTickContext(nullptr, FALSE);
 
         return TRUE;
     }
@@ -84,21 +128,20 @@ BOOL CEntity::RemoveChild(unsigned int id)
 
 void CEntity::InternalAddChild(std::shared_ptr<CEntity> pChild)
 {
-    if (pChild && m_childrenMap.find(pChild->GetID()) == m_childrenMap.end())
-    {
-        m_children.push_back(pChild);
-        m_childrenMap[pChild->GetID()] = pChild;
-    }
+    // SetParent 已排除重复挂接（父节点未变时直接返回），这里无需再查重
+    if (pChild)
+        m_children.push_back(std::move(pChild));
 }
 
 void CEntity::InternalRemoveChild(unsigned int uID)
 {
-    auto it = m_childrenMap.find(uID);
-    if (it != m_childrenMap.end())
+    for (auto it = m_children.begin(); it != m_children.end(); ++it)
     {
-        auto pChild = it->second;
-        m_childrenMap.erase(it);
-        m_children.erase(std::remove(m_children.begin(), m_children.end(), pChild), m_children.end());
+        if ((*it)->m_uID == uID)
+        {
+            m_children.erase(it);
+            return;
+        }
     }
 }
 
@@ -108,11 +151,41 @@ std::shared_ptr<CEntity> CEntity::GetChild(size_t index) const
         return m_children[index];
     return nullptr;
 }
-// 递归查找子实体
+// 查找子树中的同名实体
 std::shared_ptr<CEntity> CEntity::FindChildByName(const std::wstring &name)
+{
+    // 从未驻留过的名称不可能有实体使用；空名称不进入索引，也不参与查找
+    CNameIndex::NameId nameId = CNameIndex::FindName(name);
+    if (nameId == CNameIndex::INVALID_NAME)
+        return nullptr;
+
+    if (!m_pNameIndex)
+        return FindChildByNameId(nameId);
+
+    // 在场景中：取同名实体，确认位于本子树内（本节点是场景根时无需确认）
+    BOOL isRoot = m_pParent.expired();
+    const std::vector<unsigned int> &candidates = m_pNameIndex->FindAll(nameId);
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+        CEntity *pCandidate = Find(candidates[i]);
+        if (!pCandidate)
+            continue;
+        std::shared_ptr<CEntity> pFound = pCandidate->shared_from_this();
+        if (isRoot)
+            return pFound;
+        for (std::shared_ptr<CEntity> p = pFound; p; p = p->m_pParent.lock())
+        {
+            if (p.get() == this)
+                return pFound;
+        }
+    }
+    return nullptr;
+}
+
+std::shared_ptr<CEntity> CEntity::FindChildByNameId(CNameIndex::NameId nameId)
 {
     // 1. 检查自己是不是
-    if (m_name == name)
+    if (m_nameId == nameId)
     {
         return shared_from_this();
     }
@@ -120,7 +193,7 @@ std::shared_ptr<CEntity> CEntity::FindChildByName(const std::wstring &name)
     // 2. 递归查找子节点
     for (auto &child : m_children)
     {
-        auto found = child->FindChildByName(name);
+        auto found = child->FindChildByNameId(nameId);
         if (found)
             return found;
     }
@@ -128,44 +201,314 @@ std::shared_ptr<CEntity> CEntity::FindChildByName(const std::wstring &name)
     return nullptr;
 }
 
-void CEntity::Update(float deltaTime)
+void CEntity::SetName(const std::wstring &name)
+{
+    CNameIndex::NameId nameId = CNameIndex::Intern(name);
+    if (nameId == m_nameId)
+        return;
+
+    if (m_pNameIndex)
+    {
+        m_pNameIndex->RemoveName(m_uID, m_nameId);
+        m_pNameIndex->AddName(m_uID, nameId);
+    }
+    m_nameId = nameId;
+}
+
+void CEntity::AddTag(const std::wstring &tag)
+{
+    CNameIndex::NameId tagId = CNameIndex::Intern(tag);
+    if (tagId == CNameIndex::INVALID_NAME || std::find(m_tags.begin(), m_tags.end(), tagId) != m_tags.end())
+        return;
+
+    m_tags.push_back(tagId);
+    if (m_pNameIndex)
+        m_pNameIndex->AddTag(m_uID, tagId);
+}
+
+void CEntity::RemoveTag(const std::wstring &tag)
+{
+    CNameIndex::NameId tagId = CNameIndex::FindName(tag);
+    auto it = std::find(m_tags.begin(), m_tags.end(), tagId);
+    if (tagId == CNameIndex::INVALID_NAME || it == m_tags.end())
+        return;
+
+    m_tags.erase(it);
+    if (m_pNameIndex)
+        m_pNameIndex->RemoveTag(m_uID, tagId);
+}
+
+BOOL CEntity::HasTag(const std::wstring &tag) const
+{
+    CNameIndex::NameId tagId = CNameIndex::FindName(tag);
+    return tagId != CNameIndex::INVALID_NAME && std::find(m_tags.begin(), m_tags.end(), tagId) != m_tags.end();
+}
+
+void CEntity::SetNameIndex(CNameIndex *pIndex)
+{
+    if (m_pNameIndex == pIndex)
+        return;
+
+    if (m_pNameIndex)
+    {
+        m_pNameIndex->RemoveName(m_uID, m_nameId);
+        for (size_t i = 0; i < m_tags.size(); ++i)
+            m_pNameIndex->RemoveTag(m_uID, m_tags[i]);
+    }
+
+    m_pNameIndex = pIndex;
+    if (m_pNameIndex)
+    {
+        m_pNameIndex->AddName(m_uID, m_nameId);
+        for (size_t i = 0; i < m_tags.size(); ++i)
+            m_pNameIndex->AddTag(m_uID, m_tags[i]);
+    }
+
+    // 子节点始终与父节点在同一个索引中
+    for (auto &pChild : m_children)
+        pChild->SetNameIndex(pIndex);
+}
+
+void CEntity::SetSpatialIndex(CSpatialIndex *pIndex)
+{
+    if (m_pSpatialIndex == pIndex)
+        return;
+
+    if (m_hSpatial != CSpatialIndex::INVALID_HANDLE)
+    {
+        m_pSpatialIndex->Remove(m_hSpatial);
+        m_hSpatial = CSpatialIndex::INVALID_HANDLE;
+    }
+
+    m_pSpatialIndex = pIndex;
+    RefreshBounds();
+
+    for (auto &pChild : m_children)
+        pChild->SetSpatialIndex(pIndex);
+}
+
+void CEntity::MarkInView(uint32_t frame)
+{
+    m_uViewFrame = frame;
+
+    // 祖先已被标记时其上的链也已标记过
+    CEntity *pEntity = this;
+    while (pEntity && pEntity->m_uSubtreeViewFrame != frame)
+    {
+        pEntity->m_uSubtreeViewFrame = frame;
+        auto pParent = pEntity->m_pParent.lock();
+        pEntity = pParent.get();
+    }
+}
+
+void CEntity::RenderChildren()
+{
+    for (auto &pChild : m_children)
+    {
+        if (pChild && pChild->IsSubtreeInView())
+            pChild->Render();
+    }
+}
+
+void CEntity::CollectStaticBatch(CStaticBatch *pBatch)
+{
+    m_bStaticBatched = pBatch && m_bStatic && AddStaticGeometry(*pBatch);
+    for (auto &pChild : m_children)
+        pChild->CollectStaticBatch(pBatch);
+}
+
+BOOL CEntity::GetWorldBounds(AABB &bounds) const
+{
+    if (m_hSpatial == CSpatialIndex::INVALID_HANDLE)
+        return FALSE;
+    bounds = m_pSpatialIndex->GetWorldBounds(m_hSpatial);
+    return TRUE;
+}
+
+void CEntity::RefreshBounds()
+{
+    if (!m_pSpatialIndex)
+        return;
+
+    AABB bounds;
+    if (GetLocalBounds(bounds))
+    {
+        if (m_hSpatial == CSpatialIndex::INVALID_HANDLE)
+            m_hSpatial = m_pSpatialIndex->Add(m_uID, m_hTransform, bounds);
+        else
+            m_pSpatialIndex->SetLocalBounds(m_hSpatial, bounds);
+    }
+    else if (m_hSpatial != CSpatialIndex::INVALID_HANDLE)
+    {
+        m_pSpatialIndex->Remove(m_hSpatial);
+        m_hSpatial = CSpatialIndex::INVALID_HANDLE;
+    }
+}
+
+void CEntity::SetTickGroup(TickGroup group)
+{
+    m_tickGroup = group;
+    if (m_pTickScheduler)
+        m_pTickScheduler->SetGroup(m_hTick, group);
+}
+
+void CEntity::SetTickInterval(unsigned int frames)
+{
+    m_tickInterval = frames;
+    if (m_pTickScheduler)
+        m_pTickScheduler->SetInterval(m_hTick, frames);
+}
+
+void CEntity::RequestTick()
+{
+    if (m_pTickScheduler)
+        m_pTickScheduler->RequestTick(m_hTick);
+}
+
+void CEntity::SetVisible(BOOL visible)
+{
+    if (m_bVisible == visible)
+        return;
+
+    m_bVisible = visible;
+    RefreshTickState();
+}
+
+BOOL CEntity::IsVisibleInHierarchy() const
 {
     if (!m_bVisible)
+        return FALSE;
+    for (std::shared_ptr<CEntity> pParent = m_pParent.lock(); pParent; pParent = pParent->m_pParent.lock())
+    {
+        if (!pParent->m_bVisible)
+            return FALSE;
+    }
+    return TRUE;
+}
+
+void CEntity::SetSleeping(BOOL sleeping)
+{
+    if (m_bSleeping == sleeping)
         return;
 
-    // 递归更新所有子节点
+    m_bSleeping = sleeping;
+    RefreshTickState();
+}
+
+void CEntity::SetTickContext(CTickScheduler *pScheduler, BOOL parentPaused)
+{
+    // 调度器与祖先状态都没变时，整棵子树的状态也不会变
+    if (m_pTickScheduler == pScheduler && m_bParentPaused == parentPaused)
+        return;
+
+    if (m_pTickScheduler != pScheduler)
+    {
+        if (m_pTickScheduler)
+            m_pTickScheduler->Unregister(m_hTick);
+        m_hTick = pScheduler ? pScheduler->Register(this, &CEntity::TickThunk, m_tickGroup, m_tickInterval)
+                             : CTickScheduler::INVALID_HANDLE;
+        m_pTickScheduler = pScheduler;
+    }
+    m_bParentPaused = parentPaused;
+    RefreshTickState();
+}
+
+void CEntity::RefreshTickState()
+{
+    // 休眠的项移出执行列表，整棵子树每帧不再产生开销
+    BOOL enabled = IsTickEnabled();
+    if (m_pTickScheduler)
+        m_pTickScheduler->SetActive(m_hTick, enabled != FALSE);
+
     for (auto &pChild : m_children)
+        pChild->SetTickContext(m_pTickScheduler, !enabled);
+}
+
+// ======================================================================
+// 场景快照
+// ======================================================================
+void CEntity::WriteSnapshot(CSceneSnapshotWriter &writer, uint32_t index) const
+{
+    SnapshotEntity &record = writer.GetEntity(index);
+    record.flags = (m_bVisible ? SNAPSHOT_FLAG_VISIBLE : 0) |
+                   (m_bSleeping ? SNAPSHOT_FLAG_SLEEPING : 0) |
+                   (m_bSnapToTerrain ? SNAPSHOT_FLAG_SNAP_TO_TERRAIN : 0) |
+                   (m_bStatic ? SNAPSHOT_FLAG_STATIC : 0) |
+                   (m_bOccluder ? SNAPSHOT_FLAG_OCCLUDER : 0);
+    record.tickGroup = (uint32_t)m_tickGroup;
+    record.tickInterval = m_tickInterval;
+    record.groundOffset = m_fTerrainOffset;
+    record.position[0] = m_position.x;
+    record.position[1] = m_position.y;
+    record.position[2] = m_position.z;
+    record.rotation[0] = m_rotation.x;
+    record.rotation[1] = m_rotation.y;
+    record.rotation[2] = m_rotation.z;
+    record.rotation[3] = m_rotation.w;
+    record.scale[0] = m_scale.x;
+    record.scale[1] = m_scale.y;
+    record.scale[2] = m_scale.z;
+
+    // 名称总是写入，空名称写为空引用
+    writer.SetName(index, GetName());
+    if (!m_tags.empty())
     {
-        if (pChild)
-        {
-            pChild->Update(deltaTime);
-        }
+        std::vector<std::wstring> tags;
+        for (size_t i = 0; i < m_tags.size(); ++i)
+            tags.push_back(CNameIndex::GetString(m_tags[i]));
+        writer.SetTags(index, tags);
     }
 }
 
+void CEntity::ReadSnapshot(const SnapshotEntity &record)
+{
+    SetName(record.name.IsNull() ? std::wstring() : record.name.Get());
+    for (uint32_t i = 0; i < record.tagCount; ++i)
+        AddTag(record.tags.Get()[i].Get());
+
+    SetPosition(Vector3(record.position[0], record.position[1], record.position[2]));
+    SetRotation(Quaternion(record.rotation[0], record.rotation[1], record.rotation[2], record.rotation[3]));
+    SetScale(Vector3(record.scale[0], record.scale[1], record.scale[2]));
+
+    SetVisible((record.flags & SNAPSHOT_FLAG_VISIBLE) ? TRUE : FALSE);
+    SetSnapToTerrain((record.flags & SNAPSHOT_FLAG_SNAP_TO_TERRAIN) ? TRUE : FALSE, record.groundOffset);
+    SetStatic((record.flags & SNAPSHOT_FLAG_STATIC) ? TRUE : FALSE);
+    SetOccluder((record.flags & SNAPSHOT_FLAG_OCCLUDER) ? TRUE : FALSE);
+    SetTickGroup(record.tickGroup < (uint32_t)TickGroup::Count ? (TickGroup)record.tickGroup : TickGroup::Update);
+    SetTickInterval(record.tickInterval);
+    SetSleeping((record.flags & SNAPSHOT_FLAG_SLEEPING) ? TRUE : FALSE);
+}
+
+std::shared_ptr<CEntity> CEntity::CreateFromSnapshot(const SnapshotEntity &record)
+{
+    std::shared_ptr<CEntity> pEntity = Create();
+    pEntity->ReadSnapshot(record);
+    return pEntity;
+}
+
 void CEntity::SetPosition(const Vector3 &pos)
 {
     m_position = pos;
-    MarkDirty();
+    CTransformStore::GetInstance().SetLocalPosition(m_hTransform, m_position);
 }
 
 void CEntity::SetRotation(const Vector3 &euler)
 {
     // 将欧拉角转为四元数存储
     m_rotation = Quaternion::FromEuler(euler.x, euler.y, euler.z);
-    MarkDirty();
+    CTransformStore::GetInstance().SetLocalRotation(m_hTransform, m_rotation);
 }
 
 void CEntity::SetRotation(const Quaternion &quat)
 {
     m_rotation = quat;
-    MarkDirty();
+    CTransformStore::GetInstance().SetLocalRotation(m_hTransform, m_rotation);
 }
 
 void CEntity::SetScale(const Vector3 &scale)
 {
     m_scale = scale;
-    MarkDirty();
+    CTransformStore::GetInstance().SetLocalScale(m_hTransform, m_scale);
 }
 
 Vector3 CEntity::GetWorldPosition() const
@@ -175,23 +518,8 @@ Vector3 CEntity::GetWorldPosition() const
 
 Matrix4 CEntity::GetWorldMatrix() const
 {
-    if (m_bWorldDirty)
-    {
-        Matrix4 localMatrix = Matrix4::TRS(m_position, m_rotation, m_scale);
-
-        // 使用 lock() 安全获取父节点
-        if (auto pParent = m_pParent.lock())
-        {
-            m_cachedWorldMatrix = pParent->GetWorldMatrix() * localMatrix;
-        }
-        else
-        {
-            m_cachedWorldMatrix = localMatrix;
-        }
-
-        m_bWorldDirty = FALSE;
-    }
-    return m_cachedWorldMatrix;
+    // 父链上有过期节点时由 CTransformStore 沿父索引补算，无需逐级 lock() 父节点
+    return CTransformStore::GetInstance().GetWorldMatrix(m_hTransform);
 }
 
 void CEntity::ApplyTransform() const
@@ -201,34 +529,6 @@ void CEntity::ApplyTransform() const
     glMultMatrixf(mat.GetData());
 }
 
-void CEntity::MarkDirty()
-{
-    if (m_bWorldDirty)
-        return; // 已经脏了，避免重复传播
-
-    m_bWorldDirty = TRUE;
-
-    // 使用 BFS（广度优先）传播脏标记，避免深层级递归栈溢出
-    std::queue<CEntity *> queue;
-    for (auto &child : m_children)
-        if (child)
-            queue.push(child.get());
-
-    while (!queue.empty())
-    {
-        CEntity *current = queue.front();
-        queue.pop();
-
-        if (!current->m_bWorldDirty)
-        {
-            current->m_bWorldDirty = TRUE;
-            for (auto &child : current->m_children)
-                if (child)
-                    queue.push(child.get());
-        }
-    }
-}
-
 void CEntity::SetSnapToTerrain(BOOL enable, float offset)
 {
     m_bSnapToTerrain = enable;
@@ -0,0 +1,65 @@
+#include "stdafx.h"
+#include "Core/EntityPool.h"
+
+const size_t CBlockPool::DEFAULT_BLOCKS_PER_CHUNK;
+
+CBlockPool::CBlockPool(size_t blockSize, size_t alignment, size_t blocksPerChunk)
+    : m_alignment(alignment < alignof(FreeBlock) ? alignof(FreeBlock) : alignment),
+      m_blocksPerChunk(blocksPerChunk ? blocksPerChunk : 1)
+{
+    // 块内至少能放下空闲链表指针，并且块大小是对齐的整数倍
+    size_t size = blockSize < sizeof(FreeBlock) ? sizeof(FreeBlock) : blockSize;
+    m_blockSize = (size + m_alignment - 1) / m_alignment * m_alignment;
+}
+
+CBlockPool::~CBlockPool()
+{
+    for (size_t i = 0; i < m_chunks.size(); ++i)
+        ::operator delete(m_chunks[i]);
+}
+
+void *CBlockPool::Allocate()
+{
+    if (!m_freeList)
+        AddChunk();
+
+    FreeBlock *block = m_freeList;
+    m_freeList = block->next;
+    ++m_used;
+    return block;
+}
+
+void CBlockPool::Deallocate(void *p)
+{
+    if (!p)
+        return;
+
+    FreeBlock *block = static_cast<FreeBlock *>(p);
+    block->next = m_freeList;
+    m_freeList = block;
+    --m_used;
+}
+
+void CBlockPool::Reserve(size_t count)
+{
+    while (m_capacity < count)
+        AddChunk();
+}
+
+void CBlockPool::AddChunk()
+{
+    void *raw = ::operator new(m_blockSize * m_blocksPerChunk + m_alignment);
+    m_chunks.push_back(raw);
+
+    uintptr_t address = (uintptr_t)raw;
+    char *base = (char *)((address + m_alignment - 1) / m_alignment * m_alignment);
+
+    // 倒序压入链表，使连续创建的对象按地址递增排列
+    for (size_t i = m_blocksPerChunk; i > 0; --i)
+    {
+        FreeBlock *block = (FreeBlock *)(base + (i - 1) * m_blockSize);
+        block->next = m_freeList;
+        m_freeList = block;
+    }
+    m_capacity += m_blocksPerChunk;
+}
@@ -0,0 +1,252 @@
+#include "stdafx.h"
+#include "Core/GLStateCache.h"
+#include <cstring>
+
+namespace
+{
+    // 跟踪的开关，与 m_caps 下标对应
+    const GLenum TRACKED_CAPS[] = {
+        GL_BLEND, GL_DEPTH_TEST, GL_LIGHTING, GL_CULL_FACE, GL_COLOR_MATERIAL,
+        GL_FOG, GL_ALPHA_TEST, GL_NORMALIZE, GL_LIGHT0, GL_POLYGON_OFFSET_FILL,
+    };
+
+    const GLenum TRACKED_CLIENT_ARRAYS[] = {
+        GL_VERTEX_ARRAY, GL_NORMAL_ARRAY, GL_TEXTURE_COORD_ARRAY, GL_COLOR_ARRAY,
+    };
+
+    const int COLOR_MATERIAL_INDEX = 4;
+    const int COLOR_ARRAY_INDEX = 3;
+}
+
+CGLStateCache &CGLStateCache::GetInstance()
+{
+    static CGLStateCache s_instance;
+    return s_instance;
+}
+
+CGLStateCache::CGLStateCache()
+{
+    static_assert(sizeof(TRACKED_CAPS) / sizeof(TRACKED_CAPS[0]) == CAP_COUNT, "TRACKED_CAPS 与 CAP_COUNT 不一致");
+    static_assert(sizeof(TRACKED_CLIENT_ARRAYS) / sizeof(TRACKED_CLIENT_ARRAYS[0]) == CLIENT_ARRAY_COUNT,
+                  "TRACKED_CLIENT_ARRAYS 与 CLIENT_ARRAY_COUNT 不一致");
+    Invalidate();
+    ResetStats();
+}
+
+void CGLStateCache::Invalidate()
+{
+    std::memset(m_caps, STATE_UNKNOWN, sizeof(m_caps));
+    std::memset(m_clientArrays, STATE_UNKNOWN, sizeof(m_clientArrays));
+    m_activeUnit = -1;
+    for (int i = 0; i < MAX_TEXTURE_UNITS; ++i)
+    {
+        m_texture2D[i] = STATE_UNKNOWN;
+        m_boundTexture[i] = -1;
+        m_texEnvMode[i] = 0;
+    }
+    m_blendValid = false;
+    m_colorValid = false;
+    m_materialValid = false;
+    m_polygonMode = 0;
+}
+
+int CGLStateCache::CapIndex(GLenum cap)
+{
+    for (int i = 0; i < CAP_COUNT; ++i)
+    {
+        if (TRACKED_CAPS[i] == cap)
+            return i;
+    }
+    return -1;
+}
+
+int CGLStateCache::ClientArrayIndex(GLenum array)
+{
+    for (int i = 0; i < CLIENT_ARRAY_COUNT; ++i)
+    {
+        if (TRACKED_CLIENT_ARRAYS[i] == array)
+            return i;
+    }
+    return -1;
+}
+
+// ======================================================================
+// 开关
+// ======================================================================
+void CGLStateCache::SetEnabled(GLenum cap, bool enable)
+{
+    const int8_t wanted = enable ? STATE_ON : STATE_OFF;
+    int8_t *pState = nullptr;
+    if (cap == GL_TEXTURE_2D)
+    {
+        if (m_activeUnit >= 0)
+            pState = &m_texture2D[m_activeUnit];
+    }
+    else
+    {
+        int index = CapIndex(cap);
+        if (index >= 0)
+            pState = &m_caps[index];
+    }
+
+    if (pState && *pState == wanted)
+    {
+        Skip();
+        return;
+    }
+
+    if (enable)
+        glEnable(cap);
+    else
+        glDisable(cap);
+    Issue();
+    if (pState)
+        *pState = wanted;
+
+    // 开启颜色材质时当前颜色立即写入材质
+    if (cap == GL_COLOR_MATERIAL && enable)
+        m_materialValid = false;
+}
+
+void CGLStateCache::SetClientState(GLenum array, bool enable)
+{
+    const int8_t wanted = enable ? STATE_ON : STATE_OFF;
+    int index = ClientArrayIndex(array);
+    if (index >= 0 && m_clientArrays[index] == wanted)
+    {
+        Skip();
+        return;
+    }
+
+    if (enable)
+        glEnableClientState(array);
+    else
+        glDisableClientState(array);
+    Issue();
+    if (index >= 0)
+        m_clientArrays[index] = wanted;
+
+    // 使用颜色数组绘制之后当前颜色不确定
+    if (index == COLOR_ARRAY_INDEX)
+        m_colorValid = false;
+}
+
+// ======================================================================
+// 纹理
+// ======================================================================
+void CGLStateCache::ActiveTexture(GLenum unit)
+{
+    int index = (int)(unit - GL_TEXTURE0);
+    if (index >= 0 && index < MAX_TEXTURE_UNITS && index == m_activeUnit)
+    {
+        Skip();
+        return;
+    }
+
+    glActiveTexture(unit);
+    Issue();
+    m_activeUnit = (index >= 0 && index < MAX_TEXTURE_UNITS) ? index : -1;
+}
+
+void CGLStateCache::BindTexture(GLuint texture)
+{
+    if (m_activeUnit >= 0 && m_boundTexture[m_activeUnit] == (int64_t)texture)
+    {
+        Skip();
+        return;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+    Issue();
+    if (m_activeUnit >= 0)
+        m_boundTexture[m_activeUnit] = texture;
+}
+
+void CGLStateCache::SetTexEnvMode(GLint mode)
+{
+    if (m_activeUnit >= 0 && m_texEnvMode[m_activeUnit] == mode)
+    {
+        Skip();
+        return;
+    }
+
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, mode);
+    Issue();
+    if (m_activeUnit >= 0)
+        m_texEnvMode[m_activeUnit] = mode;
+}
+
+// ======================================================================
+// 混合、颜色、材质、多边形模式
+// ======================================================================
+void CGLStateCache::SetBlendFunc(GLenum src, GLenum dst)
+{
+    if (m_blendValid && m_blendSrc == src && m_blendDst == dst)
+    {
+        Skip();
+        return;
+    }
+
+    glBlendFunc(src, dst);
+    Issue();
+    m_blendValid = true;
+    m_blendSrc = src;
+    m_blendDst = dst;
+}
+
+void CGLStateCache::SetColor(float r, float g, float b, float a)
+{
+    // 颜色材质开启或未知时，glColor 同时改写材质
+    if (m_caps[COLOR_MATERIAL_INDEX] != STATE_OFF)
+        m_materialValid = false;
+
+    if (m_colorValid && m_color[0] == r && m_color[1] == g && m_color[2] == b && m_color[3] == a)
+    {
+        Skip();
+        return;
+    }
+
+    glColor4f(r, g, b, a);
+    Issue();
+    m_colorValid = true;
+    m_color[0] = r;
+    m_color[1] = g;
+    m_color[2] = b;
+    m_color[3] = a;
+}
+
+void CGLStateCache::SetMaterial(const float ambient[4], const float diffuse[4], const float specular[4], float shininess)
+{
+    float material[13];
+    std::memcpy(material, ambient, 4 * sizeof(float));
+    std::memcpy(material + 4, diffuse, 4 * sizeof(float));
+    std::memcpy(material + 8, specular, 4 * sizeof(float));
+    material[12] = shininess;
+
+    if (m_materialValid && std::memcmp(material, m_material, sizeof(material)) == 0)
+    {
+        Skip(4);
+        return;
+    }
+
+    glMaterialfv(GL_FRONT, GL_AMBIENT, ambient);
+    glMaterialfv(GL_FRONT, GL_DIFFUSE, diffuse);
+    glMaterialfv(GL_FRONT, GL_SPECULAR, specular);
+    glMaterialf(GL_FRONT, GL_SHININESS, shininess);
+    Issue(4);
+    m_materialValid = true;
+    std::memcpy(m_material, material, sizeof(material));
+}
+
+void CGLStateCache::SetPolygonMode(GLenum mode)
+{
+    if (m_polygonMode == mode)
+    {
+        Skip();
+        return;
+    }
+
+    glPolygonMode(GL_FRONT_AND_BACK, mode);
+    Issue();
+    m_polygonMode = mode;
+}
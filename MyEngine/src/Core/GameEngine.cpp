@@ -5,11 +5,15 @@
 #include "Utils/DebugUtils.h"
 #include "Core/Window.h"
 #include "Core/Renderer.h"
+#include "Core/GLStateCache.h"
 #include "Core/InputManager.h"
 #include "Graphics/Camera/Camera.h"
 #include "Graphics/UI/UIManager.h"
 #include "Resources/ResourceManager.h"
 #include "Scene/SceneManager.h"
+#include "Core/TransformStore.h"
+#include "Core/JobSystem.h"
+#include "Math/MathBatch.h"
 #include "Scene/DemoScene.h"
 // ======================================================================
 
@@ -32,6 +36,7 @@ CGameEngine::CGameEngine()
 {
     // 初始化引擎子系统
     // 成员变量初始化
+    m_JobSystem = std::make_unique<CJobSystem>(); // 工作线程数 = 硬件线程数 - 1
     m_Window = std::make_unique<CWindow>(); // 智能指针, 自动删除
     m_Renderer = std::make_unique<CRenderer>();
     m_InputManager = std::make_unique<CInputManager>();
@@ -52,6 +57,11 @@ BOOL CGameEngine::Initialize(HINSTANCE hInstance, const EngineConfig &config)
     if (m_Initialized)
         return TRUE;
 
+    // 批量数学的大批次改由任务系统拆分，不再每次临时创建线程
+    Math::Batch::SetParallelExecutor([this](size_t count, size_t grain, const Math::Batch::RangeFunc &func) {
+        m_JobSystem->ParallelFor(count, grain, func);
+    });
+
     // 1. 创建窗口
     if (!m_Window->Create(hInstance, config))
     {
@@ -249,6 +259,12 @@ INT CGameEngine::Run()
         m_pMainCamera->Update(deltaTime);
         m_SceneManager->Update(deltaTime);
 
+        // 7. 刷新变换层级：重算本帧所有过期的世界矩阵（大场景按层级分发到任务系统）
+        CTransformStore::GetInstance().UpdateWorldMatrices(m_JobSystem.get());
+        // 同步移动过的实体在空间索引中的包围盒（只处理世界矩阵有变化的）
+        if (auto pScene = m_SceneManager->GetCurrentScene())
+            pScene->UpdateBounds();
+
         // 渲染判断
         if (m_Window->IsActive() && !m_Window->IsMinimized())
         {
@@ -268,6 +284,21 @@ INT CGameEngine::Run()
                 // 渲染主场景
                 m_pMainCamera->ApplyProjectionMatrix();
                 m_pMainCamera->ApplyViewMatrix();
+                if (auto pScene = m_SceneManager->GetCurrentScene())
+                {
+                    Frustum frustum;
+                    m_pMainCamera->GetFrustum(frustum);
+                    Matrix4 viewProjection;
+                    m_pMainCamera->GetViewProjectionMatrix(viewProjection);
+                    pScene->CullEntities(frustum, &viewProjection);
+                    Matrix4 view;
+                    m_pMainCamera->GetViewMatrix(view);
+                    pScene->GetRenderQueue().SetView(view, m_pMainCamera->GetFar());
+                    Matrix4 projection;
+                    m_pMainCamera->GetProjectionMatrix(projection);
+                    pScene->GetLODController().SetView(m_pMainCamera->GetPosition(), projection,
+                                                       (float)m_Renderer->GetHeight());
+                }
                 m_SceneManager->Render();
 
                 // 渲染UI
@@ -275,6 +306,8 @@ INT CGameEngine::Run()
                 {
                     if (m_ShowDebugInfo)
                         DisplayDebugInfo();
+                    if (m_ShowOcclusionDepth)
+                        DisplayOcclusionDepth();
                 }
                 m_Renderer->PopState();
 
@@ -336,6 +369,10 @@ void CGameEngine::Shutdown()
     m_Renderer->Shutdown();
     m_Window->Destroy();
 
+    // 恢复默认执行器后停止工作线程
+    Math::Batch::SetParallelExecutor(nullptr);
+    m_JobSystem.reset();
+
     m_Initialized = FALSE;
 
     LogInfo(L"=--=--=--=--=--=--=--= 引擎已完全关闭 =--=--=--=--=--=--=--=\n");
@@ -361,6 +398,10 @@ void CGameEngine::ProcessInput(FLOAT deltaTime)
     {
         m_ShowDebugInfo = !m_ShowDebugInfo;
     }
+    if (m_InputManager->IsKeyPressed(VK_F2))
+    {
+        m_ShowOcclusionDepth = !m_ShowOcclusionDepth;
+    }
 
     // 2. ESC键退出时恢复输入法
     if (m_InputManager->IsKeyPressed(VK_ESCAPE))
@@ -502,6 +543,29 @@ void CGameEngine::ProcessUIInput(FLOAT deltaTime)
 {
 }
 
+void CGameEngine::DisplayOcclusionDepth()
+{
+    auto pScene = m_SceneManager->GetCurrentScene();
+    if (!pScene || !pScene->IsOcclusionCullingEnabled())
+        return;
+
+    // 深度是透视分布的，换回观察空间距离再按远裁切面归一化
+    const COcclusionBuffer &buffer = pScene->GetOcclusionBuffer();
+    buffer.ReadDepth(m_OcclusionPixels);
+    const float nearPlane = m_pMainCamera->GetNear(), farPlane = m_pMainCamera->GetFar();
+    for (float &depth : m_OcclusionPixels)
+    {
+        float ndc = depth * 2.0f - 1.0f;
+        float distance = 2.0f * nearPlane * farPlane / (farPlane + nearPlane - ndc * (farPlane - nearPlane));
+        depth = std::min(distance / farPlane, 1.0f);
+    }
+
+    const INT margin = 10;
+    m_Renderer->DrawImage2D(m_OcclusionPixels.data(), buffer.GetWidth(), buffer.GetHeight(),
+                            m_Renderer->GetWidth() - buffer.GetWidth() - margin,
+                            m_Renderer->GetHeight() - buffer.GetHeight() - margin);
+}
+
 void CGameEngine::DisplayDebugInfo()
 {
     if (!m_ShowDebugInfo)
@@ -549,6 +613,35 @@ void CGameEngine::DisplayDebugInfo()
                             " | Window: " + std::to_string(m_Renderer->GetWidth()) + "x" + std::to_string(m_Renderer->GetHeight());
     m_Renderer->RenderText2D(stateText, startX, startY + (lineHeight * row++), orange, 1.0f);
 
+    if (auto pScene = m_SceneManager->GetCurrentScene())
+    {
+        const CullStats &cull = pScene->GetCullStats();
+        std::string cullText = "Culling: " + std::to_string(cull.visible) + " visible / " +
+                               std::to_string(cull.tested) + " (" + std::to_string(cull.culled) + " culled, " +
+                               std::to_string(cull.occluded) + " occluded by " + std::to_string(cull.occluders) + ")";
+        m_Renderer->RenderText2D(cullText, startX, startY + (lineHeight * row++), orange, 1.0f);
+
+        const RenderQueueStats &draw = pScene->GetRenderStats();
+        std::string drawText = "Draws: " + std::to_string(draw.draws) + " / " + std::to_string(draw.instances) +
+                               (m_Renderer->IsInstancingSupported() ? " instanced" : " meshes") + " (material " + std::to_string(draw.materialChanges) +
+                               ", texture " + std::to_string(draw.textureChanges) + ", blend " + std::to_string(draw.blendChanges) + ")";
+        m_Renderer->RenderText2D(drawText, startX, startY + (lineHeight * row++), orange, 1.0f);
+
+        const RenderQueueStats &statics = pScene->GetStaticStats();
+        std::string staticText = "Static: " + std::to_string(statics.draws) + " draws / " + std::to_string(statics.instances) +
+                                 " of " + std::to_string(pScene->GetStaticBatch().GetRanges().size()) + " parts";
+        m_Renderer->RenderText2D(staticText, startX, startY + (lineHeight * row++), orange, 1.0f);
+
+        const LODStats &lod = pScene->GetLODController().GetStats();
+        std::string lodText = "LOD: " + std::to_string(lod.reduced) + " of " + std::to_string(lod.models) + " models reduced, " +
+                              std::to_string(lod.drawnTriangles) + " / " + std::to_string(lod.fullTriangles) + " tris";
+        m_Renderer->RenderText2D(lodText, startX, startY + (lineHeight * row++), orange, 1.0f);
+    }
+
+    const CGLStateCache::Stats &glStats = m_Renderer->GetStateCache().GetStats();
+    std::string glText = "GL state: " + std::to_string(glStats.issued) + " issued / " + std::to_string(glStats.skipped) + " skipped";
+    m_Renderer->RenderText2D(glText, startX, startY + (lineHeight * row++), orange, 1.0f);
+
     row++;
 
     // ======================================================================
@@ -607,6 +700,7 @@ void CGameEngine::DisplayDebugInfo()
     m_Renderer->RenderText2D("[ 快捷键 ]", rightX, rightY + (lineHeight * rRow++), black, 0.8f);
     m_Renderer->RenderText2D("ESC: 退出系统", rightX, rightY + (lineHeight * rRow++), gray, 0.75f);
     m_Renderer->RenderText2D("F1 : 切换信息显示", rightX, rightY + (lineHeight * rRow++), gray, 0.75f);
+    m_Renderer->RenderText2D("F2 : 显示遮挡深度", rightX, rightY + (lineHeight * rRow++), gray, 0.75f);
     m_Renderer->RenderText2D("F11: 切换全屏显示", rightX, rightY + (lineHeight * rRow++), gray, 0.75f);
     m_Renderer->RenderText2D("鼠标移动: 移动相机", rightX, rightY + (lineHeight * rRow++), gray, 0.75f);
     m_Renderer->RenderText2D("鼠标滚动: 缩放视野", rightX, rightY + (lineHeight * rRow++), gray, 0.75f);
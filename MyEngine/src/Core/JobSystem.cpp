@@ -0,0 +1,285 @@
+#include "stdafx.h"
+#include "Core/JobSystem.h"
+
+namespace
+{
+    // 当前线程所属的任务系统与槽位（外部线程为空，统一使用槽位 0）
+    thread_local CJobSystem *t_pJobSystem = nullptr;
+    thread_local unsigned t_slot = 0;
+
+    // 空闲时自旋让出的次数，超过后进入休眠
+    const int IDLE_SPIN_COUNT = 64;
+}
+
+CJobSystem::CJobSystem(unsigned workerCount)
+    : m_queued(0), //
+      m_bStop(false)
+{
+    if (workerCount == 0)
+    {
+        unsigned hw = std::thread::hardware_concurrency();
+        workerCount = hw > 1 ? hw - 1 : 1;
+    }
+
+    m_queues.resize(workerCount + 1);
+    for (size_t i = 0; i < m_queues.size(); ++i)
+        m_queues[i].reset(new WorkerQueue());
+
+    t_pJobSystem = this;
+    t_slot = 0;
+
+    m_workers.reserve(workerCount);
+    for (unsigned i = 1; i <= workerCount; ++i)
+        m_workers.push_back(std::thread(&CJobSystem::WorkerLoop, this, i));
+}
+
+CJobSystem::~CJobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_bStop.store(true);
+    }
+    m_wakeCondition.notify_all();
+    for (size_t i = 0; i < m_workers.size(); ++i)
+        m_workers[i].join();
+
+    if (t_pJobSystem == this)
+        t_pJobSystem = nullptr;
+}
+
+// ======================================================================
+// 提交
+// ======================================================================
+void CJobSystem::Schedule(JobFunc func, CJobCounter *counter)
+{
+    if (counter)
+        counter->m_count.fetch_add(1, std::memory_order_relaxed);
+    Job job = {std::move(func), counter};
+    Push(CurrentSlot(), std::move(job));
+    Wake(1);
+}
+
+void CJobSystem::ScheduleAfter(CJobCounter &dependency, JobFunc func, CJobCounter *counter)
+{
+    if (counter)
+        counter->m_count.fetch_add(1, std::memory_order_relaxed);
+    Job job = {std::move(func), counter};
+
+    // 在依赖的锁内判断是否已归零，与 Execute 中"归零后取走后续任务"互斥，不会丢失
+    {
+        std::lock_guard<std::mutex> lock(dependency.m_mutex);
+        if (dependency.m_count.load(std::memory_order_acquire) != 0)
+        {
+            dependency.m_continuations.push_back(std::move(job));
+            return;
+        }
+    }
+    Push(CurrentSlot(), std::move(job));
+    Wake(1);
+}
+
+void CJobSystem::Wait(CJobCounter &counter)
+{
+    unsigned slot = CurrentSlot();
+    int idle = 0;
+    while (!counter.IsDone())
+    {
+        Job job;
+        if (TryTake(slot, job))
+        {
+            Execute(job);
+            idle = 0;
+        }
+        else if (++idle > IDLE_SPIN_COUNT)
+        {
+            // 剩余任务正在其它线程上执行，让出时间片
+            std::this_thread::yield();
+        }
+    }
+
+    // 等最后一个任务释放计数器的锁，之后调用方可以安全销毁计数器
+    std::lock_guard<std::mutex> lock(counter.m_mutex);
+}
+
+void CJobSystem::ParallelFor(CJobSystem *pJobs, size_t count, size_t grain, const RangeFunc &func)
+{
+    if (pJobs)
+        pJobs->ParallelFor(count, grain, func);
+    else if (count > 0)
+        func(0, count);
+}
+
+void CJobSystem::ParallelFor(size_t count, size_t grain, const RangeFunc &func)
+{
+    if (count == 0)
+        return;
+    if (grain == 0)
+        grain = 1;
+
+    // 块数取线程数的 4 倍，让先完成的线程可以窃取剩余的块
+    size_t chunks = (count + grain - 1) / grain;
+    size_t maxChunks = (size_t)GetThreadCount() * 4;
+    if (chunks > maxChunks)
+        chunks = maxChunks;
+    if (chunks <= 1)
+    {
+        func(0, count);
+        return;
+    }
+
+    size_t chunkSize = (count + chunks - 1) / chunks;
+    chunks = (count + chunkSize - 1) / chunkSize;
+
+    // 除第一块外全部放进自己的队列，一次加锁；第一块由调用线程直接执行
+    CJobCounter counter;
+    counter.m_count.store((int)(chunks - 1), std::memory_order_relaxed);
+    unsigned slot = CurrentSlot();
+    {
+        WorkerQueue &queue = *m_queues[slot];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        for (size_t c = chunks - 1; c >= 1; --c)
+        {
+            size_t begin = c * chunkSize;
+            size_t end = begin + chunkSize < count ? begin + chunkSize : count;
+            Job job = {[&func, begin, end]() { func(begin, end); }, &counter};
+            queue.jobs.push_back(std::move(job));
+        }
+    }
+    m_queued.fetch_add((int)(chunks - 1), std::memory_order_release);
+    Wake(chunks - 1);
+
+    func(0, chunkSize);
+    Wait(counter);
+}
+
+// ======================================================================
+// 队列
+// ======================================================================
+unsigned CJobSystem::CurrentSlot() const
+{
+    return t_pJobSystem == this ? t_slot : 0;
+}
+
+void CJobSystem::Push(unsigned slot, Job &&job)
+{
+    {
+        WorkerQueue &queue = *m_queues[slot];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+    m_queued.fetch_add(1, std::memory_order_release);
+}
+
+bool CJobSystem::TryTake(unsigned slot, Job &job)
+{
+    if (m_queued.load(std::memory_order_acquire) <= 0)
+        return false;
+
+    // 1. 自己的队列：从尾部取
+    {
+        WorkerQueue &queue = *m_queues[slot];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty())
+        {
+            job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // 2. 依次从其它队列头部窃取（最早入队的任务通常是最大的一块）
+    const size_t count = m_queues.size();
+    for (size_t k = 1; k < count; ++k)
+    {
+        WorkerQueue &victim = *m_queues[(slot + k) % count];
+        std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || victim.jobs.empty())
+            continue;
+        job = std::move(victim.jobs.front());
+        victim.jobs.pop_front();
+        m_queued.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void CJobSystem::Execute(Job &job)
+{
+    job.func();
+
+    CJobCounter *counter = job.counter;
+    if (!counter)
+        return;
+
+    // 不是最后一个：无锁递减后不再访问计数器
+    int value = counter->m_count.load(std::memory_order_acquire);
+    while (value > 1 && !counter->m_count.compare_exchange_weak(value, value - 1, std::memory_order_acq_rel))
+    {
+    }
+    if (value > 1)
+        return;
+
+    // 最后一个：在锁内归零并取走后续任务。Wait 返回前会经过同一把锁，
+    // 保证等待方销毁计数器时这里已经不再访问它
+    std::vector<Job> continuations;
+    {
+        std::lock_guard<std::mutex> lock(counter->m_mutex);
+        counter->m_count.fetch_sub(1, std::memory_order_acq_rel);
+        continuations.swap(counter->m_continuations);
+    }
+    if (continuations.empty())
+        return;
+    unsigned slot = CurrentSlot();
+    for (size_t i = 0; i < continuations.size(); ++i)
+        Push(slot, std::move(continuations[i]));
+    Wake(continuations.size());
+}
+
+// ======================================================================
+// 工作线程
+// ======================================================================
+void CJobSystem::Wake(size_t count)
+{
+    // 先经过休眠锁，保证正在进入休眠的线程能看到新任务
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    if (count >= m_workers.size())
+        m_wakeCondition.notify_all();
+    else
+    {
+        for (size_t i = 0; i < count; ++i)
+            m_wakeCondition.notify_one();
+    }
+}
+
+void CJobSystem::WorkerLoop(unsigned index)
+{
+    t_pJobSystem = this;
+    t_slot = index;
+
+    int idle = 0;
+    while (!m_bStop.load(std::memory_order_acquire))
+    {
+        Job job;
+        if (TryTake(index, job))
+        {
+            Execute(job);
+            idle = 0;
+            continue;
+        }
+
+        if (++idle <= IDLE_SPIN_COUNT)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wakeCondition.wait(lock, [this]() {
+            return m_bStop.load(std::memory_order_acquire) || m_queued.load(std::memory_order_acquire) > 0;
+        });
+        idle = 0;
+    }
+}
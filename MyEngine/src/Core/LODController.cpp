@@ -0,0 +1,65 @@
+#include "stdafx.h"
+#include "Core/LODController.h"
+#include <algorithm>
+
+CLODController *CLODController::s_pActive = nullptr;
+
+namespace
+{
+    // 相机进入包围球后按这个距离计算，避免除零；此时总会选到 0 级
+    const float MIN_DISTANCE = 1e-3f;
+}
+
+void CLODController::SetView(const Vector3 &cameraPosition, const Matrix4 &projection, float viewportHeight)
+{
+    m_cameraPosition = cameraPosition;
+    // 裁剪空间 y 为 projection(1,1) · y / 距离，NDC [-1, 1] 对应视口高度
+    m_pixelScale = std::max(projection(1, 1), 0.0f) * viewportHeight * 0.5f;
+}
+
+void CLODController::Begin()
+{
+    m_stats = LODStats();
+    s_pActive = this;
+}
+
+void CLODController::End()
+{
+    if (s_pActive == this)
+        s_pActive = nullptr;
+}
+
+float CLODController::ErrorToPixels(const Matrix4 &world, const Vector3 &center, float radius) const
+{
+    Vector3 scale = world.GetScale();
+    float maxScale = std::max(scale.x, std::max(scale.y, scale.z));
+    float distance = (world * center - m_cameraPosition).Length() - radius * maxScale;
+    return m_pixelScale * maxScale / std::max(distance, MIN_DISTANCE);
+}
+
+size_t CLODController::Select(const float *errors, size_t levelCount, const Matrix4 &world, const Vector3 &center,
+                              float radius, size_t current) const
+{
+    if (levelCount < 2)
+        return 0;
+
+    const float pixels = ErrorToPixels(world, center, radius);
+    size_t level = std::min(current, levelCount - 1);
+
+    // 当前级别误差超过阈值时逐级变细；之后只有误差明显低于阈值的更粗级别才会切换过去
+    while (level > 0 && errors[level] * pixels > m_threshold)
+        --level;
+    const float coarsen = m_threshold * (1.0f - m_hysteresis);
+    while (level + 1 < levelCount && errors[level + 1] * pixels <= coarsen)
+        ++level;
+    return level;
+}
+
+void CLODController::Record(size_t level, size_t fullTriangles, size_t drawnTriangles)
+{
+    ++m_stats.models;
+    if (level > 0)
+        ++m_stats.reduced;
+    m_stats.fullTriangles += fullTriangles;
+    m_stats.drawnTriangles += drawnTriangles;
+}
@@ -0,0 +1,231 @@
+#include "stdafx.h"
+#include "Core/MeshInstancer.h"
+#include "Resources/Mesh.h"
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    // 实例矩阵占用的顶点属性（mat4 按列占 4 个位置）；避开固定管线属性常见的别名位置 0/2/3/8
+    const GLuint INSTANCE_ATTRIB = 4;
+
+    const char *VERTEX_SHADER =
+        "#version 120\n"
+        "attribute mat4 a_world;\n"
+        "void main()\n"
+        "{\n"
+        "    vec4 world = a_world * gl_Vertex;\n"
+        "    gl_Position = gl_ModelViewProjectionMatrix * world;\n"
+        "    gl_FogFragCoord = abs((gl_ModelViewMatrix * world).z);\n"
+        "    gl_FrontColor = gl_Color;\n"
+        "    gl_TexCoord[0] = gl_TextureMatrix[0] * gl_MultiTexCoord0;\n"
+        "}\n";
+
+    const char *FRAGMENT_SHADER =
+        "#version 120\n"
+        "uniform sampler2D u_texture;\n"
+        "uniform bool u_useTexture;\n"
+        "uniform int u_fogMode;\n" // 0 关闭，1 GL_LINEAR，2 GL_EXP，3 GL_EXP2
+        "void main()\n"
+        "{\n"
+        "    vec4 color = gl_Color;\n"
+        "    if (u_useTexture)\n"
+        "        color *= texture2D(u_texture, gl_TexCoord[0].st);\n"
+        "    if (u_fogMode != 0)\n"
+        "    {\n"
+        "        float z = gl_FogFragCoord;\n"
+        "        float f;\n"
+        "        if (u_fogMode == 1)\n"
+        "            f = (gl_Fog.end - z) * gl_Fog.scale;\n"
+        "        else if (u_fogMode == 2)\n"
+        "            f = exp(-gl_Fog.density * z);\n"
+        "        else\n"
+        "            f = exp(-(gl_Fog.density * z) * (gl_Fog.density * z));\n"
+        "        color.rgb = mix(gl_Fog.color.rgb, color.rgb, clamp(f, 0.0, 1.0));\n"
+        "    }\n"
+        "    gl_FragColor = color;\n"
+        "}\n";
+}
+
+CMeshInstancer::CMeshInstancer()
+    : m_program(0),
+      m_instanceBuffer(0),
+      m_useTextureLocation(-1),
+      m_fogModeLocation(-1),
+      m_textured(-1)
+{
+    static_assert(sizeof(Matrix4) == 16 * sizeof(float), "实例缓冲直接上传 Matrix4 数组");
+}
+
+CMeshInstancer::~CMeshInstancer()
+{
+    // OpenGL 对象由 CRenderer::Shutdown 在上下文销毁前释放，这里不再调用 OpenGL
+}
+
+bool CMeshInstancer::CheckSupport()
+{
+    int major = 0, minor = 0;
+    const char *version = reinterpret_cast<const char *>(glGetString(GL_VERSION));
+    if (!version || sscanf(version, "%d.%d", &major, &minor) != 2)
+        return false;
+    if (major > 3 || (major == 3 && minor >= 3))
+        return true;
+
+    // 2.x 上需要 GLSL 与两个实例化扩展
+    const char *extensions = reinterpret_cast<const char *>(glGetString(GL_EXTENSIONS));
+    return major >= 2 && extensions &&
+           strstr(extensions, "GL_ARB_draw_instanced") &&
+           strstr(extensions, "GL_ARB_instanced_arrays");
+}
+
+GLuint CMeshInstancer::CompileShader(GLenum type, const char *source)
+{
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+
+    GLint compiled = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+    if (!compiled)
+    {
+        char log[512] = {};
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        LogWarning(L"实例化着色器编译失败: %hs\n", log);
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+bool CMeshInstancer::Initialize()
+{
+    Shutdown();
+    if (!CheckSupport())
+    {
+        LogInfo(L"不支持实例化绘制，渲染队列逐个加载矩阵\n");
+        return false;
+    }
+
+    GLuint vertexShader = CompileShader(GL_VERTEX_SHADER, VERTEX_SHADER);
+    GLuint fragmentShader = CompileShader(GL_FRAGMENT_SHADER, FRAGMENT_SHADER);
+    if (vertexShader && fragmentShader)
+    {
+        GLuint program = glCreateProgram();
+        glAttachShader(program, vertexShader);
+        glAttachShader(program, fragmentShader);
+        glBindAttribLocation(program, INSTANCE_ATTRIB, "a_world");
+        glLinkProgram(program);
+
+        GLint linked = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (linked)
+        {
+            m_program = program;
+        }
+        else
+        {
+            LogWarning(L"实例化着色器链接失败\n");
+            glDeleteProgram(program);
+        }
+    }
+    // 程序链接后着色器对象不再需要
+    if (vertexShader)
+        glDeleteShader(vertexShader);
+    if (fragmentShader)
+        glDeleteShader(fragmentShader);
+
+    if (!m_program)
+        return false;
+
+    m_useTextureLocation = glGetUniformLocation(m_program, "u_useTexture");
+    m_fogModeLocation = glGetUniformLocation(m_program, "u_fogMode");
+    glUseProgram(m_program);
+    glUniform1i(glGetUniformLocation(m_program, "u_texture"), 0);
+    glUseProgram(0);
+
+    glGenBuffers(1, &m_instanceBuffer);
+    LogInfo(L"实例化绘制已启用\n");
+    return true;
+}
+
+void CMeshInstancer::Shutdown()
+{
+    if (m_instanceBuffer)
+    {
+        glDeleteBuffers(1, &m_instanceBuffer);
+        m_instanceBuffer = 0;
+    }
+    if (m_program)
+    {
+        glDeleteProgram(m_program);
+        m_program = 0;
+    }
+    m_useTextureLocation = -1;
+    m_fogModeLocation = -1;
+}
+
+void CMeshInstancer::Upload(const Matrix4 *matrices, size_t count)
+{
+    if (!m_program || count == 0)
+        return;
+
+    // 每帧整体重新指定数据，驱动可另分配存储，不必等待上一帧的绘制读完
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, count * sizeof(Matrix4), matrices, GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void CMeshInstancer::Begin()
+{
+    glUseProgram(m_program);
+    for (GLuint c = 0; c < 4; ++c)
+    {
+        glEnableVertexAttribArray(INSTANCE_ATTRIB + c);
+        glVertexAttribDivisor(INSTANCE_ATTRIB + c, 1);
+    }
+    m_textured = -1;
+
+    // 雾参数由着色器经 gl_Fog 读取，模式与开关须另行告知；每次提交取一次当前状态
+    GLint fogMode = 0;
+    if (glIsEnabled(GL_FOG))
+    {
+        GLint mode = GL_EXP;
+        glGetIntegerv(GL_FOG_MODE, &mode);
+        fogMode = mode == GL_LINEAR ? 1 : (mode == GL_EXP ? 2 : 3);
+    }
+    glUniform1i(m_fogModeLocation, fogMode);
+}
+
+void CMeshInstancer::SetTextured(bool textured)
+{
+    if (m_textured == (textured ? 1 : 0))
+        return;
+    glUniform1i(m_useTextureLocation, textured ? 1 : 0);
+    m_textured = textured ? 1 : 0;
+}
+
+void CMeshInstancer::Draw(const CMesh &mesh, uint32_t first, uint32_t count, size_t lod)
+{
+    // 没有 baseInstance（GL 4.2），每批把实例属性指向缓冲中该批的起点
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+    const size_t offset = (size_t)first * sizeof(Matrix4);
+    for (GLuint c = 0; c < 4; ++c)
+    {
+        glVertexAttribPointer(INSTANCE_ATTRIB + c, 4, GL_FLOAT, GL_FALSE, sizeof(Matrix4),
+                              reinterpret_cast<const GLvoid *>(offset + c * 4 * sizeof(float)));
+    }
+    // 网格顶点仍是客户端数组，须解绑缓冲
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    mesh.DrawGeometryInstanced((GLsizei)count, lod);
+}
+
+void CMeshInstancer::End()
+{
+    for (GLuint c = 0; c < 4; ++c)
+    {
+        glVertexAttribDivisor(INSTANCE_ATTRIB + c, 0);
+        glDisableVertexAttribArray(INSTANCE_ATTRIB + c);
+    }
+    glUseProgram(0);
+}
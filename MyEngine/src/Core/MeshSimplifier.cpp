@@ -0,0 +1,394 @@
+#include "stdafx.h"
+#include "Core/MeshSimplifier.h"
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+
+namespace
+{
+    const uint32_t INVALID_VERTEX = 0xFFFFFFFFu;
+
+    // 边界平面的权重（乘以边长的平方），越大轮廓保持得越紧
+    const float BORDER_WEIGHT = 10.0f;
+
+    // 折叠后相邻三角形法线与原法线的夹角余弦低于此值视为翻转（约 75°）
+    const float FLIP_COS = 0.25f;
+
+    uint32_t FloatBits(float f)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        return bits;
+    }
+
+    // 按 key(顶点) 分组的三角形列表（CSR）：offsets[k]..offsets[k + 1] 为 key 为 k 的三角形
+    template <typename Key>
+    void BuildTriangleLists(const std::vector<unsigned int> &indices, size_t keyCount, Key key,
+                            std::vector<uint32_t> &offsets, std::vector<uint32_t> &triangles)
+    {
+        offsets.assign(keyCount + 1, 0);
+        for (size_t i = 0; i < indices.size(); ++i)
+            ++offsets[key(indices[i]) + 1];
+        for (size_t k = 0; k < keyCount; ++k)
+            offsets[k + 1] += offsets[k];
+
+        triangles.resize(indices.size());
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); ++i)
+            triangles[fill[key(indices[i])]++] = (uint32_t)(i / 3);
+    }
+}
+
+CMeshSimplifier::CMeshSimplifier(const float *positions, size_t vertexCount, size_t stride,
+                                 const unsigned int *indices, size_t indexCount)
+{
+    // 1. 位置归一化到单位立方体，误差与容差在这个尺度下计算
+    m_positions.resize(vertexCount);
+    Vector3 minBounds(FLT_MAX, FLT_MAX, FLT_MAX), maxBounds(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (size_t i = 0; i < vertexCount; ++i)
+    {
+        const float *p = reinterpret_cast<const float *>(reinterpret_cast<const char *>(positions) + i * stride);
+        m_positions[i] = Vector3(p[0], p[1], p[2]);
+        minBounds = Vector3(std::min(minBounds.x, p[0]), std::min(minBounds.y, p[1]), std::min(minBounds.z, p[2]));
+        maxBounds = Vector3(std::max(maxBounds.x, p[0]), std::max(maxBounds.y, p[1]), std::max(maxBounds.z, p[2]));
+    }
+    if (vertexCount > 0)
+    {
+        Vector3 size = maxBounds - minBounds;
+        float extent = std::max(size.x, std::max(size.y, size.z));
+        m_scale = extent > 0.0f ? extent : 1.0f;
+        const float invScale = 1.0f / m_scale;
+        for (size_t i = 0; i < vertexCount; ++i)
+            m_positions[i] = (m_positions[i] - minBounds) * invScale;
+    }
+
+    // 2. 去掉越界与退化的三角形
+    m_indices.reserve(indexCount);
+    for (size_t t = 0; t + 2 < indexCount; t += 3)
+    {
+        unsigned int a = indices[t], b = indices[t + 1], c = indices[t + 2];
+        if (a >= vertexCount || b >= vertexCount || c >= vertexCount || a == b || b == c || a == c)
+            continue;
+        m_indices.push_back(a);
+        m_indices.push_back(b);
+        m_indices.push_back(c);
+    }
+
+    // 3. 位置完全相同的顶点归为一组（按位比较），组内编号最小的代表整组
+    std::vector<uint32_t> order(vertexCount);
+    for (size_t i = 0; i < vertexCount; ++i)
+        order[i] = (uint32_t)i;
+    auto samePosition = [this](uint32_t a, uint32_t b) {
+        const Vector3 &pa = m_positions[a], &pb = m_positions[b];
+        return FloatBits(pa.x) == FloatBits(pb.x) && FloatBits(pa.y) == FloatBits(pb.y) && FloatBits(pa.z) == FloatBits(pb.z);
+    };
+    auto less = [this](uint32_t a, uint32_t b) {
+        const Vector3 &pa = m_positions[a], &pb = m_positions[b];
+        if (FloatBits(pa.x) != FloatBits(pb.x))
+            return FloatBits(pa.x) < FloatBits(pb.x);
+        if (FloatBits(pa.y) != FloatBits(pb.y))
+            return FloatBits(pa.y) < FloatBits(pb.y);
+        if (FloatBits(pa.z) != FloatBits(pb.z))
+            return FloatBits(pa.z) < FloatBits(pb.z);
+        return a < b;
+    };
+    std::sort(order.begin(), order.end(), less);
+
+    m_wedge.resize(vertexCount);
+    m_seam.assign(vertexCount, 0);
+    for (size_t i = 0; i < vertexCount;)
+    {
+        size_t end = i + 1;
+        while (end < vertexCount && samePosition(order[i], order[end]))
+            ++end;
+        for (size_t k = i; k < end; ++k)
+        {
+            m_wedge[order[k]] = order[i];
+            m_seam[order[k]] = end - i > 1 ? 1 : 0;
+        }
+        i = end;
+    }
+
+    // 4. 每个三角形的平面按面积加权累加到三个角上
+    Quadric zero;
+    std::memset(&zero, 0, sizeof(zero));
+    m_quadrics.assign(vertexCount, zero);
+    for (size_t t = 0; t < m_indices.size(); t += 3)
+    {
+        const Vector3 &p0 = m_positions[m_indices[t]];
+        Vector3 normal = (m_positions[m_indices[t + 1]] - p0).Cross(m_positions[m_indices[t + 2]] - p0);
+        float length = normal.Length();
+        if (length <= 0.0f)
+            continue;
+        normal = normal * (1.0f / length);
+        const float distance = -normal.Dot(p0);
+        for (int k = 0; k < 3; ++k)
+            AddPlane(m_quadrics[m_wedge[m_indices[t + k]]], normal, distance, length * 0.5f);
+    }
+
+    // 5. 开放边界：沿边界、垂直于所在三角形的平面，边界顶点偏离轮廓时代价增大
+    m_kind.assign(vertexCount, KIND_LOCKED);
+    m_borderNext.assign(vertexCount, INVALID_VERTEX);
+    m_borderPrev.assign(vertexCount, INVALID_VERTEX);
+    ClassifyVertices();
+    for (size_t t = 0; t < m_indices.size(); t += 3)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            uint32_t a = m_indices[t + k], b = m_indices[t + (k + 1) % 3];
+            if (m_kind[a] != KIND_BORDER || m_borderNext[a] != b)
+                continue;
+            const Vector3 &p0 = m_positions[m_indices[t]];
+            Vector3 faceNormal = (m_positions[m_indices[t + 1]] - p0).Cross(m_positions[m_indices[t + 2]] - p0);
+            Vector3 edge = m_positions[b] - m_positions[a];
+            Vector3 normal = edge.Cross(faceNormal);
+            float length = normal.Length();
+            if (length <= 0.0f)
+                continue;
+            normal = normal * (1.0f / length);
+            const float distance = -normal.Dot(m_positions[a]);
+            const float weight = edge.LengthSquared() * BORDER_WEIGHT;
+            AddPlane(m_quadrics[m_wedge[a]], normal, distance, weight);
+            AddPlane(m_quadrics[m_wedge[b]], normal, distance, weight);
+        }
+    }
+}
+
+// ======================================================================
+// 二次型
+// ======================================================================
+void CMeshSimplifier::AddPlane(Quadric &q, const Vector3 &n, float d, float w)
+{
+    q.a00 += w * n.x * n.x;
+    q.a11 += w * n.y * n.y;
+    q.a22 += w * n.z * n.z;
+    q.a10 += w * n.y * n.x;
+    q.a20 += w * n.z * n.x;
+    q.a21 += w * n.z * n.y;
+    q.b0 += w * d * n.x;
+    q.b1 += w * d * n.y;
+    q.b2 += w * d * n.z;
+    q.c += w * d * d;
+    q.w += w;
+}
+
+void CMeshSimplifier::AddQuadric(Quadric &q, const Quadric &o)
+{
+    q.a00 += o.a00;
+    q.a11 += o.a11;
+    q.a22 += o.a22;
+    q.a10 += o.a10;
+    q.a20 += o.a20;
+    q.a21 += o.a21;
+    q.b0 += o.b0;
+    q.b1 += o.b1;
+    q.b2 += o.b2;
+    q.c += o.c;
+    q.w += o.w;
+}
+
+float CMeshSimplifier::Evaluate(const Quadric &q, const Vector3 &p)
+{
+    float rx = q.a00 * p.x + q.a10 * p.y + q.a20 * p.z;
+    float ry = q.a10 * p.x + q.a11 * p.y + q.a21 * p.z;
+    float rz = q.a20 * p.x + q.a21 * p.y + q.a22 * p.z;
+    return rx * p.x + ry * p.y + rz * p.z + 2.0f * (q.b0 * p.x + q.b1 * p.y + q.b2 * p.z) + q.c;
+}
+
+// ======================================================================
+// 拓扑
+// ======================================================================
+bool CMeshSimplifier::HasEdge(uint32_t from, uint32_t to) const
+{
+    for (uint32_t k = m_wedgeOffsets[from]; k < m_wedgeOffsets[from + 1]; ++k)
+    {
+        const unsigned int *tri = &m_indices[m_wedgeTriangles[k] * 3];
+        for (int j = 0; j < 3; ++j)
+        {
+            if (m_wedge[tri[j]] == from && m_wedge[tri[(j + 1) % 3]] == to)
+                return true;
+        }
+    }
+    return false;
+}
+
+void CMeshSimplifier::ClassifyVertices()
+{
+    // 开放边：反向边不存在的有向边；按位置组比较，接缝两侧的边不算开放
+    const size_t vertexCount = m_positions.size();
+    BuildTriangleLists(m_indices, vertexCount, [this](unsigned int v) { return m_wedge[v]; },
+                       m_wedgeOffsets, m_wedgeTriangles);
+
+    std::vector<uint8_t> used(vertexCount, 0), openOut(vertexCount, 0), openIn(vertexCount, 0);
+    for (size_t t = 0; t < m_indices.size(); t += 3)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            uint32_t a = m_indices[t + k], b = m_indices[t + (k + 1) % 3];
+            used[a] = 1;
+            if (HasEdge(m_wedge[b], m_wedge[a]))
+                continue;
+            m_borderNext[a] = b;
+            m_borderPrev[b] = a;
+            openOut[a] = (uint8_t)std::min(openOut[a] + 1, 2);
+            openIn[b] = (uint8_t)std::min(openIn[b] + 1, 2);
+        }
+    }
+
+    for (size_t v = 0; v < vertexCount; ++v)
+    {
+        if (!used[v] || m_seam[v])
+            m_kind[v] = KIND_LOCKED;
+        else if (openOut[v] == 0 && openIn[v] == 0)
+            m_kind[v] = KIND_MANIFOLD;
+        else if (openOut[v] == 1 && openIn[v] == 1)
+            m_kind[v] = KIND_BORDER;
+        else
+            m_kind[v] = KIND_LOCKED;
+    }
+}
+
+void CMeshSimplifier::BuildAdjacency()
+{
+    BuildTriangleLists(m_indices, m_positions.size(), [](unsigned int v) { return v; }, m_adjacencyOffsets, m_adjacency);
+}
+
+// ======================================================================
+// 折叠
+// ======================================================================
+bool CMeshSimplifier::CanCollapse(uint32_t source, uint32_t target) const
+{
+    if (m_kind[source] == KIND_MANIFOLD)
+        return true;
+    if (m_kind[source] == KIND_BORDER)
+        return target == m_borderNext[source] || target == m_borderPrev[source];
+    return false;
+}
+
+float CMeshSimplifier::CollapseCost(uint32_t source, uint32_t target) const
+{
+    Quadric q = m_quadrics[m_wedge[source]];
+    AddQuadric(q, m_quadrics[m_wedge[target]]);
+    if (q.w <= 0.0f)
+        return 0.0f;
+    return std::max(Evaluate(q, m_positions[target]), 0.0f) / q.w;
+}
+
+bool CMeshSimplifier::FlipsTriangle(uint32_t source, uint32_t target, const std::vector<uint32_t> &collapseTo) const
+{
+    const Vector3 &moved = m_positions[target];
+    for (uint32_t k = m_adjacencyOffsets[source]; k < m_adjacencyOffsets[source + 1]; ++k)
+    {
+        // 邻接三角形按本轮已做的折叠重映射（源顶点本身尚未折叠）
+        const unsigned int *tri = &m_indices[m_adjacency[k] * 3];
+        uint32_t v[3] = {collapseTo[tri[0]], collapseTo[tri[1]], collapseTo[tri[2]]};
+        if (v[0] == target || v[1] == target || v[2] == target)
+            continue; // 折叠后退化，被删除
+        if (v[0] == v[1] || v[1] == v[2] || v[0] == v[2])
+            continue; // 本轮已经退化
+
+        // 从 source 开始取另外两个顶点，保持绕序
+        int s = v[0] == source ? 0 : (v[1] == source ? 1 : 2);
+        const Vector3 &p1 = m_positions[v[(s + 1) % 3]];
+        const Vector3 &p2 = m_positions[v[(s + 2) % 3]];
+        Vector3 before = (p1 - m_positions[source]).Cross(p2 - m_positions[source]);
+        Vector3 after = (p1 - moved).Cross(p2 - moved);
+        float limit = FLIP_COS * std::sqrt(before.LengthSquared() * after.LengthSquared());
+        if (after.LengthSquared() <= 0.0f || before.Dot(after) <= limit)
+            return true;
+    }
+    return false;
+}
+
+bool CMeshSimplifier::Simplify(size_t targetIndexCount, float maxError)
+{
+    const size_t before = m_indices.size();
+    const size_t vertexCount = m_positions.size();
+    const float limit = maxError / m_scale;
+    const float costLimit = limit * limit;
+
+    std::vector<Collapse> candidates;
+    std::vector<uint32_t> collapseTo;
+    std::vector<uint8_t> locked;
+
+    while (m_indices.size() > targetIndexCount)
+    {
+        ClassifyVertices();
+        BuildAdjacency();
+
+        // 1. 每个可移动的顶点取代价最小的邻居作为候选
+        Collapse none = {INVALID_VERTEX, INVALID_VERTEX, FLT_MAX};
+        candidates.assign(vertexCount, none);
+        for (size_t t = 0; t < m_indices.size(); t += 3)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                uint32_t a = m_indices[t + k], b = m_indices[t + (k + 1) % 3];
+                for (int direction = 0; direction < 2; ++direction)
+                {
+                    uint32_t source = direction ? b : a, target = direction ? a : b;
+                    if (!CanCollapse(source, target))
+                        continue;
+                    float cost = CollapseCost(source, target);
+                    if (cost < candidates[source].cost)
+                        candidates[source] = {source, target, cost};
+                }
+            }
+        }
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                        [costLimit](const Collapse &c) { return !(c.cost <= costLimit); }),
+                         candidates.end());
+        if (candidates.empty())
+            break;
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const Collapse &x, const Collapse &y) { return x.cost < y.cost; });
+
+        // 2. 从代价最小的开始折叠；源与目标本轮锁定，同一轮里一个顶点只参与一次折叠
+        collapseTo.resize(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v)
+            collapseTo[v] = (uint32_t)v;
+        locked.assign(vertexCount, 0);
+
+        const size_t trianglesToRemove = (m_indices.size() - targetIndexCount + 2) / 3;
+        size_t removed = 0, collapses = 0;
+        for (size_t i = 0; i < candidates.size() && removed < trianglesToRemove; ++i)
+        {
+            const Collapse &collapse = candidates[i];
+            if (locked[collapse.source] || locked[collapse.target] ||
+                FlipsTriangle(collapse.source, collapse.target, collapseTo))
+                continue;
+
+            collapseTo[collapse.source] = collapse.target;
+            AddQuadric(m_quadrics[m_wedge[collapse.target]], m_quadrics[m_wedge[collapse.source]]);
+            m_error = std::max(m_error, std::sqrt(collapse.cost) * m_scale);
+            locked[collapse.source] = locked[collapse.target] = 1;
+            ++collapses;
+
+            // 源顶点的三角形中另有一角落在目标上的随之退化（源与目标都已锁定，之前不会已退化到目标）
+            for (uint32_t k = m_adjacencyOffsets[collapse.source]; k < m_adjacencyOffsets[collapse.source + 1]; ++k)
+            {
+                const unsigned int *tri = &m_indices[m_adjacency[k] * 3];
+                int hits = (collapseTo[tri[0]] == collapse.target) + (collapseTo[tri[1]] == collapse.target) +
+                           (collapseTo[tri[2]] == collapse.target);
+                if (hits >= 2)
+                    ++removed;
+            }
+        }
+        if (collapses == 0)
+            break;
+
+        // 3. 重写索引并去掉退化三角形
+        size_t write = 0;
+        for (size_t t = 0; t < m_indices.size(); t += 3)
+        {
+            unsigned int a = collapseTo[m_indices[t]], b = collapseTo[m_indices[t + 1]], c = collapseTo[m_indices[t + 2]];
+            if (a == b || b == c || a == c)
+                continue;
+            m_indices[write++] = a;
+            m_indices[write++] = b;
+            m_indices[write++] = c;
+        }
+        m_indices.resize(write);
+    }
+    return m_indices.size() < before;
+}
@@ -0,0 +1,103 @@
+#include "stdafx.h"
+#include "Core/NameIndex.h"
+#include <deque>
+
+const CNameIndex::NameId CNameIndex::INVALID_NAME;
+
+namespace
+{
+    struct InternTable
+    {
+        std::unordered_map<std::wstring, CNameIndex::NameId> idOf;
+        std::deque<std::wstring> strings; // deque 扩容不搬移元素，GetString 返回的引用长期有效
+
+        InternTable() { strings.push_back(std::wstring()); } // 0 号为 INVALID_NAME
+    };
+
+    InternTable &GetInternTable()
+    {
+        static InternTable s_table;
+        return s_table;
+    }
+
+    const std::vector<unsigned int> s_emptyBucket;
+}
+
+// ======================================================================
+// 字符串驻留
+// ======================================================================
+CNameIndex::NameId CNameIndex::Intern(const std::wstring &name)
+{
+    if (name.empty())
+        return INVALID_NAME;
+
+    InternTable &table = GetInternTable();
+    auto it = table.idOf.find(name);
+    if (it != table.idOf.end())
+        return it->second;
+
+    NameId id = (NameId)table.strings.size();
+    table.strings.push_back(name);
+    table.idOf.emplace(name, id);
+    return id;
+}
+
+CNameIndex::NameId CNameIndex::FindName(const std::wstring &name)
+{
+    InternTable &table = GetInternTable();
+    auto it = table.idOf.find(name);
+    return it == table.idOf.end() ? INVALID_NAME : it->second;
+}
+
+const std::wstring &CNameIndex::GetString(NameId id)
+{
+    InternTable &table = GetInternTable();
+    return id < table.strings.size() ? table.strings[id] : table.strings[0];
+}
+
+// ======================================================================
+// 索引
+// ======================================================================
+void CNameIndex::Insert(BucketMap &buckets, uint64_t key, NameId id, unsigned int entityID)
+{
+    if (id == INVALID_NAME || entityID == 0)
+        return;
+
+    std::vector<unsigned int> &bucket = buckets[id];
+    if (!m_position.emplace(key, (uint32_t)bucket.size()).second)
+        return; // 已在索引中
+    bucket.push_back(entityID);
+}
+
+void CNameIndex::Erase(BucketMap &buckets, uint64_t key, NameId id)
+{
+    auto it = m_position.find(key);
+    if (it == m_position.end())
+        return;
+
+    uint32_t index = it->second;
+    m_position.erase(it);
+
+    // 桶内最后一个元素搬到空位，并更新它的位置
+    std::vector<unsigned int> &bucket = buckets[id];
+    unsigned int last = bucket.back();
+    bucket.pop_back();
+    if (index < bucket.size())
+    {
+        bucket[index] = last;
+        m_position[(key & ~(uint64_t)0xFFFFFFFFu) | last] = index;
+    }
+}
+
+const std::vector<unsigned int> &CNameIndex::Lookup(const BucketMap &buckets, NameId id)
+{
+    auto it = buckets.find(id);
+    return it == buckets.end() ? s_emptyBucket : it->second;
+}
+
+void CNameIndex::Clear()
+{
+    m_names.clear();
+    m_tags.clear();
+    m_position.clear();
+}
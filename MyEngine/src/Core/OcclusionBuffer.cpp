@@ -0,0 +1,499 @@
+#include "stdafx.h"
+#include "Core/OcclusionBuffer.h"
+#include "Core/JobSystem.h"
+#include "Math/MathSIMD.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // 顶点变换与三角形准备按固定大小分段，各段输出互不干扰
+    const size_t VERTEX_CHUNK = 4096;
+    const size_t TRIANGLE_CHUNK = 2048;
+    const size_t TEST_GRAIN = 256;
+
+    // 包围盒的角离近平面比这更近（或在相机后方）时按可见处理
+    const float MIN_W = 1e-5f;
+
+    // ======================================================================
+    // 像素行的 SIMD 运算：AVX 一次 8 个像素，SSE 与标量一次 4 个
+    // ======================================================================
+#if defined(MATH_SIMD_AVX)
+    const int LANES = 8;
+    typedef __m256 Lane;
+    inline Lane Set1(float v) { return _mm256_set1_ps(v); }
+    inline Lane Ramp(float first) { return _mm256_add_ps(_mm256_set1_ps(first), _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7)); }
+    inline Lane Load(const float *p) { return _mm256_loadu_ps(p); }
+    inline void Store(float *p, Lane v) { _mm256_storeu_ps(p, v); }
+    inline Lane Add(Lane a, Lane b) { return _mm256_add_ps(a, b); }
+    inline Lane Mul(Lane a, Lane b) { return _mm256_mul_ps(a, b); }
+    inline Lane Min(Lane a, Lane b) { return _mm256_min_ps(a, b); }
+    inline Lane Max(Lane a, Lane b) { return _mm256_max_ps(a, b); }
+    inline Lane GreaterEqual(Lane a, Lane b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    inline Lane LessEqual(Lane a, Lane b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    inline Lane And(Lane a, Lane b) { return _mm256_and_ps(a, b); }
+    inline Lane Select(Lane mask, Lane a, Lane b) { return _mm256_blendv_ps(b, a, mask); }
+    inline bool Any(Lane mask) { return _mm256_movemask_ps(mask) != 0; }
+    inline float HorizontalMax(Lane v)
+    {
+        __m128 m = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        m = _mm_max_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)));
+        m = _mm_max_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtss_f32(m);
+    }
+#elif defined(MATH_SIMD_SSE)
+    const int LANES = 4;
+    typedef __m128 Lane;
+    inline Lane Set1(float v) { return _mm_set1_ps(v); }
+    inline Lane Ramp(float first) { return _mm_add_ps(_mm_set1_ps(first), _mm_setr_ps(0, 1, 2, 3)); }
+    inline Lane Load(const float *p) { return _mm_loadu_ps(p); }
+    inline void Store(float *p, Lane v) { _mm_storeu_ps(p, v); }
+    inline Lane Add(Lane a, Lane b) { return _mm_add_ps(a, b); }
+    inline Lane Mul(Lane a, Lane b) { return _mm_mul_ps(a, b); }
+    inline Lane Min(Lane a, Lane b) { return _mm_min_ps(a, b); }
+    inline Lane Max(Lane a, Lane b) { return _mm_max_ps(a, b); }
+    inline Lane GreaterEqual(Lane a, Lane b) { return _mm_cmpge_ps(a, b); }
+    inline Lane LessEqual(Lane a, Lane b) { return _mm_cmple_ps(a, b); }
+    inline Lane And(Lane a, Lane b) { return _mm_and_ps(a, b); }
+    inline Lane Select(Lane mask, Lane a, Lane b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+    inline bool Any(Lane mask) { return _mm_movemask_ps(mask) != 0; }
+    inline float HorizontalMax(Lane v)
+    {
+        v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+        v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtss_f32(v);
+    }
+#else
+    const int LANES = 4;
+    struct Lane
+    {
+        float v[4];
+    };
+    inline Lane Set1(float v) { return {{v, v, v, v}}; }
+    inline Lane Ramp(float first) { return {{first, first + 1.0f, first + 2.0f, first + 3.0f}}; }
+    inline Lane Load(const float *p) { return {{p[0], p[1], p[2], p[3]}}; }
+    inline void Store(float *p, Lane v)
+    {
+        for (int i = 0; i < 4; ++i)
+            p[i] = v.v[i];
+    }
+    template <typename Op>
+    inline Lane Apply(Lane a, Lane b, Op op)
+    {
+        Lane r;
+        for (int i = 0; i < 4; ++i)
+            r.v[i] = op(a.v[i], b.v[i]);
+        return r;
+    }
+    inline Lane Add(Lane a, Lane b) { return Apply(a, b, [](float x, float y) { return x + y; }); }
+    inline Lane Mul(Lane a, Lane b) { return Apply(a, b, [](float x, float y) { return x * y; }); }
+    inline Lane Min(Lane a, Lane b) { return Apply(a, b, [](float x, float y) { return y < x ? y : x; }); }
+    inline Lane Max(Lane a, Lane b) { return Apply(a, b, [](float x, float y) { return y > x ? y : x; }); }
+    // 掩码用 1 / 0 表示
+    inline Lane GreaterEqual(Lane a, Lane b) { return Apply(a, b, [](float x, float y) { return x >= y ? 1.0f : 0.0f; }); }
+    inline Lane LessEqual(Lane a, Lane b) { return Apply(a, b, [](float x, float y) { return x <= y ? 1.0f : 0.0f; }); }
+    inline Lane And(Lane a, Lane b) { return Mul(a, b); }
+    inline Lane Select(Lane mask, Lane a, Lane b)
+    {
+        Lane r;
+        for (int i = 0; i < 4; ++i)
+            r.v[i] = mask.v[i] != 0.0f ? a.v[i] : b.v[i];
+        return r;
+    }
+    inline bool Any(Lane mask) { return mask.v[0] != 0.0f || mask.v[1] != 0.0f || mask.v[2] != 0.0f || mask.v[3] != 0.0f; }
+    inline float HorizontalMax(Lane v) { return std::max(std::max(v.v[0], v.v[1]), std::max(v.v[2], v.v[3])); }
+#endif
+
+    // 块内按行存放，行宽必须是 SIMD 宽度的整数倍
+    static_assert(COcclusionBuffer::TILE_WIDTH % 8 == 0, "tile width must be a multiple of the SIMD width");
+
+    // 线段 a-b 与近平面 z = -w 的交点
+    template <typename V>
+    V ClipNear(const V &a, const V &b)
+    {
+        float da = a.z + a.w, db = b.z + b.w;
+        float t = da / (da - db);
+        V r = {a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t, a.w + (b.w - a.w) * t};
+        return r;
+    }
+}
+
+COcclusionBuffer::COcclusionBuffer(int width, int height)
+{
+    Resize(width, height);
+}
+
+void COcclusionBuffer::Resize(int width, int height)
+{
+    m_tilesX = std::max(1, (width + TILE_WIDTH - 1) / TILE_WIDTH);
+    m_tilesY = std::max(1, (height + TILE_HEIGHT - 1) / TILE_HEIGHT);
+    m_width = m_tilesX * TILE_WIDTH;
+    m_height = m_tilesY * TILE_HEIGHT;
+    m_depth.assign((size_t)m_width * m_height, 1.0f);
+    m_tileMax.assign((size_t)m_tilesX * m_tilesY, 1.0f);
+}
+
+void COcclusionBuffer::Begin(const Matrix4 &viewProjection)
+{
+    m_viewProjection = viewProjection;
+    m_occluders.clear();
+    m_stats = OcclusionStats();
+}
+
+void COcclusionBuffer::AddOccluder(const float *positions, size_t vertexCount, size_t stride,
+                                   const unsigned int *indices, size_t indexCount, const Matrix4 &world)
+{
+    if (!positions || !indices || vertexCount == 0 || indexCount < 3)
+        return;
+
+    Occluder occluder;
+    occluder.positions = positions;
+    occluder.vertexCount = vertexCount;
+    occluder.stride = stride;
+    occluder.indices = indices;
+    occluder.triangleCount = indexCount / 3;
+    occluder.transform = m_viewProjection * world;
+    occluder.firstVertex = m_occluders.empty() ? 0 : m_occluders.back().firstVertex + m_occluders.back().vertexCount;
+    occluder.firstTriangle = m_stats.triangles;
+    m_occluders.push_back(occluder);
+
+    ++m_stats.occluders;
+    m_stats.triangles += occluder.triangleCount;
+}
+
+// ======================================================================
+// 光栅化
+// ======================================================================
+void COcclusionBuffer::Rasterize(CJobSystem *pJobs)
+{
+    // 1. 顶点变换到裁剪空间
+    size_t vertexCount = m_occluders.empty() ? 0 : m_occluders.back().firstVertex + m_occluders.back().vertexCount;
+    m_clipVertices.resize(vertexCount);
+    size_t vertexChunks = (vertexCount + VERTEX_CHUNK - 1) / VERTEX_CHUNK;
+    CJobSystem::ParallelFor(pJobs, vertexChunks, 1, [this](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c)
+            TransformVertices(c);
+    });
+
+    // 2. 裁剪、剔除并换算成屏幕空间的边函数，每段输出到自己的列表
+    size_t triangleChunks = (m_stats.triangles + TRIANGLE_CHUNK - 1) / TRIANGLE_CHUNK;
+    m_chunkTriangles.resize(std::max(m_chunkTriangles.size(), triangleChunks));
+    CJobSystem::ParallelFor(pJobs, triangleChunks, 1, [this](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c)
+            SetupTriangles(c);
+    });
+
+    // 3. 按屏幕包围矩形分到块里（CSR），块内保持提交顺序
+    m_triangles.clear();
+    for (size_t c = 0; c < triangleChunks; ++c)
+    {
+        for (size_t i = 0; i < m_chunkTriangles[c].size(); ++i)
+            m_triangles.push_back(&m_chunkTriangles[c][i]);
+    }
+    m_stats.rasterized = m_triangles.size();
+
+    const size_t tileCount = (size_t)m_tilesX * m_tilesY;
+    m_binOffsets.assign(tileCount + 1, 0);
+    for (size_t t = 0; t < m_triangles.size(); ++t)
+    {
+        const ScreenTriangle &tri = *m_triangles[t];
+        for (int ty = tri.minY / TILE_HEIGHT; ty <= tri.maxY / TILE_HEIGHT; ++ty)
+            for (int tx = tri.minX / TILE_WIDTH; tx <= tri.maxX / TILE_WIDTH; ++tx)
+                ++m_binOffsets[(size_t)ty * m_tilesX + tx + 1];
+    }
+    for (size_t i = 0; i < tileCount; ++i)
+        m_binOffsets[i + 1] += m_binOffsets[i];
+
+    m_bins.resize(m_binOffsets[tileCount]);
+    std::vector<uint32_t> fill(m_binOffsets.begin(), m_binOffsets.end() - 1);
+    for (size_t t = 0; t < m_triangles.size(); ++t)
+    {
+        const ScreenTriangle &tri = *m_triangles[t];
+        for (int ty = tri.minY / TILE_HEIGHT; ty <= tri.maxY / TILE_HEIGHT; ++ty)
+            for (int tx = tri.minX / TILE_WIDTH; tx <= tri.maxX / TILE_WIDTH; ++tx)
+                m_bins[fill[(size_t)ty * m_tilesX + tx]++] = (uint32_t)t;
+    }
+
+    // 4. 各块独立光栅化
+    CJobSystem::ParallelFor(pJobs, tileCount, 1, [this](size_t begin, size_t end) {
+        for (size_t tile = begin; tile < end; ++tile)
+            RasterizeTile(tile);
+    });
+}
+
+void COcclusionBuffer::TransformVertices(size_t chunk)
+{
+    const size_t begin = chunk * VERTEX_CHUNK;
+    const size_t end = std::min(m_clipVertices.size(), begin + VERTEX_CHUNK);
+
+    // 段内第一个顶点所属的遮挡体
+    size_t o = std::upper_bound(m_occluders.begin(), m_occluders.end(), begin,
+                                [](size_t v, const Occluder &occluder) { return v < occluder.firstVertex; }) -
+               m_occluders.begin() - 1;
+    for (size_t v = begin; v < end; ++v)
+    {
+        while (v >= m_occluders[o].firstVertex + m_occluders[o].vertexCount)
+            ++o;
+        const Occluder &occluder = m_occluders[o];
+        const float *p = reinterpret_cast<const float *>(reinterpret_cast<const char *>(occluder.positions) +
+                                                         (v - occluder.firstVertex) * occluder.stride);
+        float in[4] = {p[0], p[1], p[2], 1.0f};
+        Math::SIMD::TransformVec4(occluder.transform, in, &m_clipVertices[v].x);
+    }
+}
+
+void COcclusionBuffer::SetupTriangles(size_t chunk)
+{
+    std::vector<ScreenTriangle> &out = m_chunkTriangles[chunk];
+    out.clear();
+
+    const size_t begin = chunk * TRIANGLE_CHUNK;
+    const size_t end = std::min(m_stats.triangles, begin + TRIANGLE_CHUNK);
+    size_t o = std::upper_bound(m_occluders.begin(), m_occluders.end(), begin,
+                                [](size_t t, const Occluder &occluder) { return t < occluder.firstTriangle; }) -
+               m_occluders.begin() - 1;
+    for (size_t t = begin; t < end; ++t)
+    {
+        while (t >= m_occluders[o].firstTriangle + m_occluders[o].triangleCount)
+            ++o;
+        const Occluder &occluder = m_occluders[o];
+        const unsigned int *tri = occluder.indices + (t - occluder.firstTriangle) * 3;
+        if (tri[0] >= occluder.vertexCount || tri[1] >= occluder.vertexCount || tri[2] >= occluder.vertexCount)
+            continue;
+        const ClipVertex *v[3] = {&m_clipVertices[occluder.firstVertex + tri[0]],
+                                  &m_clipVertices[occluder.firstVertex + tri[1]],
+                                  &m_clipVertices[occluder.firstVertex + tri[2]]};
+
+        // 整个三角形在某个裁剪平面外侧时直接丢弃
+        int outside[6] = {0, 0, 0, 0, 0, 0};
+        int behind = 0;
+        for (int k = 0; k < 3; ++k)
+        {
+            outside[0] += v[k]->x < -v[k]->w;
+            outside[1] += v[k]->x > v[k]->w;
+            outside[2] += v[k]->y < -v[k]->w;
+            outside[3] += v[k]->y > v[k]->w;
+            outside[4] += v[k]->z > v[k]->w;
+            behind += v[k]->z < -v[k]->w;
+        }
+        if (behind == 3 || *std::max_element(outside, outside + 6) == 3)
+            continue;
+        if (behind == 0)
+        {
+            EmitTriangle(*v[0], *v[1], *v[2], out);
+            continue;
+        }
+
+        // 与近平面相交：裁成 3 或 4 个顶点的多边形，按扇形输出
+        ClipVertex polygon[4];
+        int count = 0;
+        for (int k = 0; k < 3; ++k)
+        {
+            const ClipVertex &a = *v[k], &b = *v[(k + 1) % 3];
+            bool aInside = a.z >= -a.w, bInside = b.z >= -b.w;
+            if (aInside)
+                polygon[count++] = a;
+            if (aInside != bInside)
+                polygon[count++] = ClipNear(a, b);
+        }
+        for (int k = 2; k < count; ++k)
+            EmitTriangle(polygon[0], polygon[k - 1], polygon[k], out);
+    }
+}
+
+void COcclusionBuffer::EmitTriangle(const ClipVertex &a, const ClipVertex &b, const ClipVertex &c,
+                                    std::vector<ScreenTriangle> &out) const
+{
+    // 透视除法后换算到像素坐标与 [0, 1] 深度
+    const ClipVertex *v[3] = {&a, &b, &c};
+    float x[3], y[3], z[3];
+    for (int k = 0; k < 3; ++k)
+    {
+        if (v[k]->w <= 0.0f)
+            return;
+        float invW = 1.0f / v[k]->w;
+        x[k] = (v[k]->x * invW * 0.5f + 0.5f) * (float)m_width;
+        y[k] = (v[k]->y * invW * 0.5f + 0.5f) * (float)m_height;
+        z[k] = v[k]->z * invW * 0.5f + 0.5f;
+    }
+
+    float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+    if (area == 0.0f || (m_backfaceCulling && area < 0.0f))
+        return;
+    if (area < 0.0f)
+    {
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+        std::swap(z[1], z[2]);
+        area = -area;
+    }
+
+    // 像素中心 (i + 0.5) 落在包围矩形内的范围
+    ScreenTriangle tri;
+    tri.minX = std::max(0, (int)std::ceil(std::min(x[0], std::min(x[1], x[2])) - 0.5f));
+    tri.minY = std::max(0, (int)std::ceil(std::min(y[0], std::min(y[1], y[2])) - 0.5f));
+    tri.maxX = std::min(m_width - 1, (int)std::floor(std::max(x[0], std::max(x[1], x[2])) - 0.5f));
+    tri.maxY = std::min(m_height - 1, (int)std::floor(std::max(y[0], std::max(y[1], y[2])) - 0.5f));
+    if (tri.minX > tri.maxX || tri.minY > tri.maxY)
+        return;
+
+    // 边 k 从顶点 k 到 k+1，逆时针时内侧在左边
+    for (int k = 0; k < 3; ++k)
+    {
+        int n = (k + 1) % 3;
+        tri.edgeA[k] = y[k] - y[n];
+        tri.edgeB[k] = x[n] - x[k];
+        tri.edgeC[k] = -(tri.edgeA[k] * x[k] + tri.edgeB[k] * y[k]);
+    }
+
+    float invArea = 1.0f / area;
+    tri.depthA = ((z[1] - z[0]) * (y[2] - y[0]) - (z[2] - z[0]) * (y[1] - y[0])) * invArea;
+    tri.depthB = ((z[2] - z[0]) * (x[1] - x[0]) - (z[1] - z[0]) * (x[2] - x[0])) * invArea;
+    tri.depthC = z[0] - tri.depthA * x[0] - tri.depthB * y[0];
+    out.push_back(tri);
+}
+
+void COcclusionBuffer::RasterizeTile(size_t tile)
+{
+    const int tileX = (int)(tile % m_tilesX) * TILE_WIDTH;
+    const int tileY = (int)(tile / m_tilesX) * TILE_HEIGHT;
+    float *depth = &m_depth[tile * TILE_WIDTH * TILE_HEIGHT];
+    std::fill(depth, depth + TILE_WIDTH * TILE_HEIGHT, 1.0f);
+
+    const Lane zero = Set1(0.0f);
+    for (uint32_t i = m_binOffsets[tile]; i < m_binOffsets[tile + 1]; ++i)
+    {
+        const ScreenTriangle &tri = *m_triangles[m_bins[i]];
+        const int x0 = std::max(tri.minX, tileX), x1 = std::min(tri.maxX, tileX + TILE_WIDTH - 1);
+        const int y0 = std::max(tri.minY, tileY), y1 = std::min(tri.maxY, tileY + TILE_HEIGHT - 1);
+        // 从对齐到 SIMD 宽度的列开始，矩形外的像素中心一定在三角形外
+        const int startX = tileX + ((x0 - tileX) & ~(LANES - 1));
+
+        const Lane a0 = Set1(tri.edgeA[0]), a1 = Set1(tri.edgeA[1]), a2 = Set1(tri.edgeA[2]);
+        const Lane depthA = Set1(tri.depthA);
+        for (int y = y0; y <= y1; ++y)
+        {
+            const float cy = (float)y + 0.5f;
+            const Lane r0 = Set1(tri.edgeB[0] * cy + tri.edgeC[0]);
+            const Lane r1 = Set1(tri.edgeB[1] * cy + tri.edgeC[1]);
+            const Lane r2 = Set1(tri.edgeB[2] * cy + tri.edgeC[2]);
+            const Lane rz = Set1(tri.depthB * cy + tri.depthC);
+            float *row = depth + (y - tileY) * TILE_WIDTH - tileX;
+
+            for (int x = startX; x <= x1; x += LANES)
+            {
+                Lane cx = Ramp((float)x + 0.5f);
+                Lane inside = And(And(GreaterEqual(Add(Mul(a0, cx), r0), zero), GreaterEqual(Add(Mul(a1, cx), r1), zero)),
+                                  GreaterEqual(Add(Mul(a2, cx), r2), zero));
+                if (!Any(inside))
+                    continue;
+                Lane old = Load(row + x);
+                Lane z = Add(Mul(depthA, cx), rz);
+                Store(row + x, Select(inside, Min(old, z), old));
+            }
+        }
+    }
+
+    Lane farthest = Load(depth);
+    for (int i = LANES; i < TILE_WIDTH * TILE_HEIGHT; i += LANES)
+        farthest = Max(farthest, Load(depth + i));
+    m_tileMax[tile] = HorizontalMax(farthest);
+}
+
+// ======================================================================
+// 测试
+// ======================================================================
+bool COcclusionBuffer::IsOccluded(const AABB &bounds) const
+{
+    if (!bounds.IsValid())
+        return false;
+
+    // 1. 八个角投影到屏幕，取矩形与最近深度
+    float minX = 1e30f, minY = 1e30f, maxX = -1e30f, maxY = -1e30f, nearest = 1e30f;
+    for (int k = 0; k < 8; ++k)
+    {
+        float corner[4] = {(k & 1) ? bounds.max.x : bounds.min.x, (k & 2) ? bounds.max.y : bounds.min.y,
+                           (k & 4) ? bounds.max.z : bounds.min.z, 1.0f};
+        float clip[4];
+        Math::SIMD::TransformVec4(m_viewProjection, corner, clip);
+        if (clip[3] <= MIN_W || clip[2] < -clip[3])
+            return false;
+        float invW = 1.0f / clip[3];
+        float x = (clip[0] * invW * 0.5f + 0.5f) * (float)m_width;
+        float y = (clip[1] * invW * 0.5f + 0.5f) * (float)m_height;
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+        nearest = std::min(nearest, clip[2] * invW * 0.5f + 0.5f);
+    }
+    if (maxX < 0.0f || maxY < 0.0f || minX > (float)m_width || minY > (float)m_height)
+        return false;
+
+    // 2. 矩形碰到的像素，逐块比较；块内所有像素都更近时整块跳过
+    const int px0 = std::max(0, (int)std::floor(minX)), px1 = std::min(m_width - 1, (int)std::floor(maxX));
+    const int py0 = std::max(0, (int)std::floor(minY)), py1 = std::min(m_height - 1, (int)std::floor(maxY));
+    const Lane boxDepth = Set1(nearest);
+    const Lane first = Set1((float)px0), last = Set1((float)px1);
+    for (int ty = py0 / TILE_HEIGHT; ty <= py1 / TILE_HEIGHT; ++ty)
+    {
+        for (int tx = px0 / TILE_WIDTH; tx <= px1 / TILE_WIDTH; ++tx)
+        {
+            const size_t tile = (size_t)ty * m_tilesX + tx;
+            if (nearest > m_tileMax[tile])
+                continue;
+
+            const int tileX = tx * TILE_WIDTH, tileY = ty * TILE_HEIGHT;
+            const int x0 = std::max(px0, tileX), x1 = std::min(px1, tileX + TILE_WIDTH - 1);
+            const int y0 = std::max(py0, tileY), y1 = std::min(py1, tileY + TILE_HEIGHT - 1);
+            const int startX = tileX + ((x0 - tileX) & ~(LANES - 1));
+            const float *depth = &m_depth[tile * TILE_WIDTH * TILE_HEIGHT] - tileX;
+            for (int y = y0; y <= y1; ++y)
+            {
+                const float *row = depth + (y - tileY) * TILE_WIDTH;
+                for (int x = startX; x <= x1; x += LANES)
+                {
+                    Lane column = Ramp((float)x);
+                    Lane covered = And(GreaterEqual(column, first), LessEqual(column, last));
+                    if (Any(And(covered, GreaterEqual(Load(row + x), boxDepth))))
+                        return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+size_t COcclusionBuffer::TestAABBs(const AABB *bounds, size_t count, uint8_t *occluded, CJobSystem *pJobs)
+{
+    CJobSystem::ParallelFor(pJobs, count, TEST_GRAIN, [this, bounds, occluded](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            occluded[i] = IsOccluded(bounds[i]) ? 1 : 0;
+    });
+
+    size_t hidden = 0;
+    for (size_t i = 0; i < count; ++i)
+        hidden += occluded[i];
+    m_stats.tested += count;
+    m_stats.occluded += hidden;
+    return hidden;
+}
+
+void COcclusionBuffer::ReadDepth(float *out) const
+{
+    for (int y = 0; y < m_height; ++y)
+    {
+        for (int x = 0; x < m_width; x += TILE_WIDTH)
+        {
+            size_t tile = (size_t)(y / TILE_HEIGHT) * m_tilesX + x / TILE_WIDTH;
+            const float *row = &m_depth[tile * TILE_WIDTH * TILE_HEIGHT + (y % TILE_HEIGHT) * TILE_WIDTH];
+            std::copy(row, row + TILE_WIDTH, out + (size_t)y * m_width + x);
+        }
+    }
+}
+
+void COcclusionBuffer::ReadDepth(std::vector<float> &out) const
+{
+    out.resize((size_t)m_width * m_height);
+    ReadDepth(out.data());
+}
@@ -0,0 +1,164 @@
+#include "stdafx.h"
+#include "Core/RenderQueue.h"
+#include <algorithm>
+#include <cstring>
+
+CRenderQueue *CRenderQueue::s_pActive = nullptr;
+
+namespace
+{
+    const uint32_t DEPTH_MAX = (1u << 24) - 1;       // 半透明深度
+    const uint32_t OPAQUE_DEPTH_MAX = (1u << 10) - 1; // 不透明深度（网格与细节级别之后，只用于组内排序）
+}
+
+void CRenderQueue::SetView(const Matrix4 &view, float farDistance)
+{
+    m_view = view;
+    m_invFar = farDistance > 0.0f ? 1.0f / farDistance : 0.0f;
+}
+
+void CRenderQueue::Begin()
+{
+    m_items.clear();
+    m_order.clear();
+    m_batches.clear();
+    m_instances.clear();
+    s_pActive = this;
+}
+
+void CRenderQueue::End()
+{
+    if (s_pActive == this)
+        s_pActive = nullptr;
+
+    const size_t count = m_order.size();
+    m_scratch.resize(count);
+    SortEntries(m_order.data(), m_scratch.data(), count);
+
+    // 相邻且网格、细节级别、材质、纹理、混合都相同的绘制项合批，世界矩阵按排序后的顺序排成实例数据
+    m_instances.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Item &item = m_items[m_order[i].index];
+        m_instances[i] = item.world;
+
+        if (i > 0)
+        {
+            const Item &prev = m_items[m_order[i - 1].index];
+            if (item.pMesh == prev.pMesh && item.lod == prev.lod && item.material == prev.material &&
+                item.texture == prev.texture && item.translucent == prev.translucent)
+            {
+                ++m_batches.back().count;
+                continue;
+            }
+        }
+        Batch batch;
+        batch.first = (uint32_t)i;
+        batch.count = 1;
+        m_batches.push_back(batch);
+    }
+}
+
+void CRenderQueue::Add(const CMesh *pMesh, uint32_t meshID, const Matrix4 &world, const Vector3 &center,
+                       uint32_t material, uint32_t texture, bool translucent, RenderPass pass, uint32_t lod)
+{
+    // 观察空间中相机看向 -Z
+    float viewZ = m_view(2, 0) * center.x + m_view(2, 1) * center.y + m_view(2, 2) * center.z + m_view(2, 3);
+    float depth01 = -viewZ * m_invFar;
+
+    SortEntry entry;
+    entry.key = MakeKey(pass, translucent, material, texture, meshID, depth01, lod);
+    entry.index = (uint32_t)m_items.size();
+    m_order.push_back(entry);
+
+    Item item;
+    item.pMesh = pMesh;
+    item.world = world;
+    item.material = material;
+    item.texture = texture;
+    item.lod = lod;
+    item.translucent = translucent;
+    m_items.push_back(item);
+}
+
+uint64_t CRenderQueue::MakeKey(RenderPass pass, bool translucent, uint32_t material, uint32_t texture, uint32_t meshID, float depth01,
+                               uint32_t lod)
+{
+    // 写成 !(x > 0) 的形式，NaN 也落到 0
+    float clamped = !(depth01 > 0.0f) ? 0.0f : std::min(depth01, 1.0f);
+    uint64_t mat = material & 0xFFFFu;
+    uint64_t tex = texture & 0xFFFFu;
+
+    uint64_t key = (uint64_t)((uint32_t)pass & 0x7u) << 61;
+    if (translucent)
+    {
+        uint64_t depth = (uint64_t)(clamped * (float)DEPTH_MAX);
+        key |= (1ull << 60) | ((DEPTH_MAX - depth) << 36) | (mat << 20) | (tex << 4);
+    }
+    else
+    {
+        uint64_t depth = (uint64_t)(clamped * (float)OPAQUE_DEPTH_MAX);
+        uint64_t mesh = meshID & 0xFFFFu;
+        key |= (mat << 44) | (tex << 28) | (mesh << 12) | ((uint64_t)(lod & 0x3u) << 10) | depth;
+    }
+    return key;
+}
+
+void CRenderQueue::SortEntries(SortEntry *entries, SortEntry *scratch, size_t count)
+{
+    if (count < 2)
+        return;
+
+    // 很少的绘制项直接插入排序，省去直方图的固定开销
+    if (count <= 32)
+    {
+        for (size_t i = 1; i < count; ++i)
+        {
+            SortEntry entry = entries[i];
+            size_t j = i;
+            for (; j > 0 && entries[j - 1].key > entry.key; --j)
+                entries[j] = entries[j - 1];
+            entries[j] = entry;
+        }
+        return;
+    }
+
+    // 一次遍历统计 8 个字节的直方图
+    uint32_t histogram[8][256];
+    std::memset(histogram, 0, sizeof(histogram));
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint64_t key = entries[i].key;
+        for (int b = 0; b < 8; ++b)
+            ++histogram[b][(key >> (b * 8)) & 0xFF];
+    }
+
+    SortEntry *src = entries;
+    SortEntry *dst = scratch;
+    for (int b = 0; b < 8; ++b)
+    {
+        uint32_t *counts = histogram[b];
+        // 该字节所有键都相同（常见于层、半透明位与空闲的低位），本趟不改变顺序
+        if (counts[(src[0].key >> (b * 8)) & 0xFF] == count)
+            continue;
+
+        uint32_t offset = 0;
+        for (int d = 0; d < 256; ++d)
+        {
+            uint32_t c = counts[d];
+            counts[d] = offset;
+            offset += c;
+        }
+
+        const int shift = b * 8;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const SortEntry &entry = src[i];
+            dst[counts[(entry.key >> shift) & 0xFF]++] = entry;
+        }
+        std::swap(src, dst);
+    }
+
+    if (src != entries)
+        std::memcpy(entries, src, count * sizeof(SortEntry));
+}
@@ -3,9 +3,13 @@
 #include "stdafx.h"
 #include <sstream>
 #include <cassert>
+#include <cstddef>
 #include <iomanip>
 #include "Math/MathUtils.h"
 #include "Core/Renderer.h"
+#include "Core/GLStateCache.h"
+#include "Core/RenderQueue.h"
+#include "Resources/Mesh.h"
 #include "Graphics/UI/FontManager.h"
 #include "Utils/StringUtils.h"
 // ======================================================================
@@ -32,7 +36,8 @@ CRenderer::CRenderer()
       m_DeltaTime(0.0f),                // 帧间隔时间
       m_MinDeltaTime(0.0f),             // 最小帧时间
       m_MaxDeltaTime(0.1f),             // 最大帧时间, 100ms 阈值
-      m_FontManager(FontManager::GetInstance())
+      m_FontManager(FontManager::GetInstance()),
+      m_StateCache(CGLStateCache::GetInstance())
 {
     // TODO: 初始化清除颜色
     // m_ClearColor[0] = 0.2f; // R
@@ -107,6 +112,7 @@ BOOL CRenderer::Initialize(HWND hWnd)
 
     // 7. 设置渲染状态
     SetupRenderState();
+    m_MeshInstancer.Initialize();
 
     // 8. 获取窗口客户区大小
     RECT clientRect = {};
@@ -168,6 +174,9 @@ void CRenderer::Shutdown()
 {
     if (m_GLInitialized)
     {
+        // 上下文销毁前释放 OpenGL 对象
+        m_MeshInstancer.Shutdown();
+
         // 重置渲染上下文
         wglMakeCurrent(nullptr, nullptr);
 
@@ -199,6 +208,10 @@ void CRenderer::BeginFrame()
     if (!m_GLInitialized)
         return;
 
+    // 上一帧结束时的状态影子不可信（其他代码直接调用 OpenGL），统计按帧清零
+    m_StateCache.Invalidate();
+    m_StateCache.ResetStats();
+
     glViewport(0, 0, m_Width, m_Height);
 
     // 1. 确保写入权限开启（防止 Clear 无效）
@@ -525,6 +538,221 @@ void CRenderer::ResetState()
     CheckGLError("ResetState");
 }
 
+RenderQueueStats CRenderer::SubmitQueue(const CRenderQueue &queue)
+{
+    RenderQueueStats stats = {};
+    if (queue.IsEmpty())
+        return stats;
+
+    // 整个队列只保存恢复一次状态，队列内的状态切换经影子缓存去重
+    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+    glMatrixMode(GL_MODELVIEW);
+
+    CGLStateCache &state = m_StateCache;
+    state.Invalidate();
+    state.Disable(GL_LIGHTING);
+    state.SetColor(1.0f, 1.0f, 1.0f, 1.0f);
+    state.Disable(GL_BLEND);
+    state.SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    state.ActiveTexture(GL_TEXTURE0);
+    state.Disable(GL_TEXTURE_2D);
+    state.SetTexEnvMode(GL_MODULATE);
+
+    state.SetClientState(GL_VERTEX_ARRAY, true);
+    state.SetClientState(GL_NORMAL_ARRAY, true);
+    state.SetClientState(GL_TEXTURE_COORD_ARRAY, true);
+
+    // 有批次能合并时整帧走实例化（单个实例的批次也一样画，省去切换着色器），实例矩阵整体上传一次
+    const Matrix4 *instances = queue.GetInstanceMatrices();
+    const bool instancing = m_MeshInstancer.IsSupported() && queue.GetBatchCount() < queue.GetCount();
+    if (instancing)
+    {
+        m_MeshInstancer.Upload(instances, queue.GetCount());
+        m_MeshInstancer.Begin();
+    }
+
+    // 不支持实例化时逐实例直接加载 观察 × 世界，省去每个实例的压栈出栈；结束后恢复为观察矩阵
+    const Matrix4 &view = queue.GetView();
+    glPushMatrix();
+
+    // 按批次记录材质编号、纹理与混合，只在与上一批不同时设置
+    uint32_t currentMaterial = 0; // 材质编号从 1 开始，0 表示尚未设置
+    GLuint currentTexture = 0;
+    bool blending = false;
+
+    for (size_t b = 0; b < queue.GetBatchCount(); ++b)
+    {
+        const CRenderQueue::Batch &batch = queue.GetBatch(b);
+        const CRenderQueue::Item &item = queue.GetSorted(batch.first);
+
+        if (item.translucent != blending)
+        {
+            blending = item.translucent;
+            state.SetEnabled(GL_BLEND, blending);
+            ++stats.blendChanges;
+        }
+
+        if (item.material != currentMaterial)
+        {
+            currentMaterial = item.material;
+            item.pMesh->ApplyMaterial();
+            ++stats.materialChanges;
+        }
+
+        if (item.texture != currentTexture)
+        {
+            state.SetEnabled(GL_TEXTURE_2D, item.texture != 0);
+            if (item.texture != 0)
+                state.BindTexture(item.texture);
+            currentTexture = item.texture;
+            ++stats.textureChanges;
+        }
+
+        if (instancing)
+        {
+            m_MeshInstancer.SetTextured(item.texture != 0);
+            m_MeshInstancer.Draw(*item.pMesh, batch.first, batch.count, item.lod);
+            ++stats.draws;
+        }
+        else
+        {
+            for (uint32_t i = batch.first; i < batch.first + batch.count; ++i)
+            {
+                glLoadMatrixf((view * instances[i]).GetData());
+                item.pMesh->DrawGeometry(item.lod);
+            }
+            stats.draws += batch.count;
+        }
+        stats.instances += batch.count;
+    }
+
+    glPopMatrix();
+    if (instancing)
+        m_MeshInstancer.End();
+
+    glPopClientAttrib();
+    glPopAttrib();
+    // 恢复后的状态影子不知道
+    state.Invalidate();
+    CheckGLError("SubmitQueue");
+    return stats;
+}
+
+void CRenderer::UploadStaticBatch(CStaticBatch &batch)
+{
+    ReleaseStaticBatch(batch);
+    if (batch.IsEmpty())
+        return;
+
+    GLuint buffers[2] = {0, 0};
+    glGenBuffers(2, buffers);
+    glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+    glBufferData(GL_ARRAY_BUFFER, batch.GetVertices().size() * sizeof(CStaticBatch::Vertex),
+                 batch.GetVertices().data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, batch.GetIndices().size() * sizeof(uint32_t),
+                 batch.GetIndices().data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    if (CheckGLError("UploadStaticBatch"))
+    {
+        glDeleteBuffers(2, buffers);
+        return;
+    }
+    batch.SetBuffers(buffers[0], buffers[1]);
+}
+
+void CRenderer::ReleaseStaticBatch(CStaticBatch &batch)
+{
+    GLuint buffers[2] = {batch.GetVertexBuffer(), batch.GetIndexBuffer()};
+    if (m_GLInitialized && (buffers[0] || buffers[1]))
+        glDeleteBuffers(2, buffers);
+    batch.SetBuffers(0, 0);
+}
+
+RenderQueueStats CRenderer::SubmitStaticBatch(const CStaticBatch &batch, const std::vector<CStaticBatch::Draw> &draws)
+{
+    RenderQueueStats stats = {};
+    if (draws.empty())
+        return stats;
+
+    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+
+    CGLStateCache &state = m_StateCache;
+    state.Invalidate();
+    state.Disable(GL_LIGHTING);
+    state.SetColor(1.0f, 1.0f, 1.0f, 1.0f);
+    state.Disable(GL_BLEND);
+
+    state.ActiveTexture(GL_TEXTURE0);
+    state.Disable(GL_TEXTURE_2D);
+    state.SetTexEnvMode(GL_MODULATE);
+
+    state.SetClientState(GL_VERTEX_ARRAY, true);
+    state.SetClientState(GL_NORMAL_ARRAY, true);
+    state.SetClientState(GL_TEXTURE_COORD_ARRAY, true);
+
+    // 已上传时指针为缓冲内的偏移，否则直接指向内存中的数组
+    const BOOL useBuffers = batch.GetVertexBuffer() != 0;
+    const uintptr_t vertexBase = useBuffers ? 0 : reinterpret_cast<uintptr_t>(batch.GetVertices().data());
+    const uintptr_t indexBase = useBuffers ? 0 : reinterpret_cast<uintptr_t>(batch.GetIndices().data());
+    if (useBuffers)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, batch.GetVertexBuffer());
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch.GetIndexBuffer());
+    }
+
+    const GLsizei stride = sizeof(CStaticBatch::Vertex);
+    glVertexPointer(3, GL_FLOAT, stride, reinterpret_cast<const GLvoid *>(vertexBase + offsetof(CStaticBatch::Vertex, Position)));
+    glNormalPointer(GL_FLOAT, stride, reinterpret_cast<const GLvoid *>(vertexBase + offsetof(CStaticBatch::Vertex, Normal)));
+    glTexCoordPointer(2, GL_FLOAT, stride, reinterpret_cast<const GLvoid *>(vertexBase + offsetof(CStaticBatch::Vertex, TexCoords)));
+
+    uint32_t currentMaterial = 0;
+    GLuint currentTexture = 0;
+    const std::vector<CStaticBatch::Group> &groups = batch.GetGroups();
+    for (size_t i = 0; i < draws.size(); ++i)
+    {
+        const CStaticBatch::Draw &draw = draws[i];
+        const CStaticBatch::Group &group = groups[draw.group];
+
+        if (group.material != currentMaterial)
+        {
+            currentMaterial = group.material;
+            group.pMesh->ApplyMaterial();
+            ++stats.materialChanges;
+        }
+
+        if (group.texture != currentTexture)
+        {
+            state.SetEnabled(GL_TEXTURE_2D, group.texture != 0);
+            if (group.texture != 0)
+                state.BindTexture(group.texture);
+            currentTexture = group.texture;
+            ++stats.textureChanges;
+        }
+
+        glDrawElements(GL_TRIANGLES, (GLsizei)draw.indexCount, GL_UNSIGNED_INT,
+                       reinterpret_cast<const GLvoid *>(indexBase + (uintptr_t)draw.firstIndex * sizeof(uint32_t)));
+        ++stats.draws;
+    }
+
+    if (useBuffers)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+
+    glPopClientAttrib();
+    glPopAttrib();
+    state.Invalidate();
+    CheckGLError("SubmitStaticBatch");
+    return stats;
+}
+
 void CRenderer::RenderText2D(const std::string &text, INT x, INT y,
                              const FLOAT color[4], FLOAT scale)
 {
@@ -618,6 +846,39 @@ void CRenderer::RenderText2D(const std::string &text, INT x, INT y,
     glPopAttrib();
 }
 
+void CRenderer::DrawImage2D(const FLOAT *pixels, INT width, INT height, INT x, INT y, FLOAT zoom)
+{
+    if (!pixels || width <= 0 || height <= 0)
+        return;
+    glPushAttrib(GL_ALL_ATTRIB_BITS);
+
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho(0, m_Width, m_Height, 0, -1, 1);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_LIGHTING);
+    glDisable(GL_BLEND);
+    glDisable(GL_TEXTURE_2D);
+
+    // glDrawPixels 从光栅位置向上绘制，光栅位置取图像左下角
+    glRasterPos2f((float)x, (float)y + height * zoom);
+    glPixelZoom(zoom, zoom);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glDrawPixels(width, height, GL_LUMINANCE, GL_FLOAT, pixels);
+    glPixelZoom(1.0f, 1.0f);
+
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+    glPopMatrix();
+    glPopAttrib();
+}
+
 BOOL CRenderer::CreateSimpleFont()
 {
     // OutputDebugStringA("创建简单字体...\n");
@@ -0,0 +1,357 @@
+#include "stdafx.h"
+#include "Core/SceneSnapshot.h"
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const size_t POINTER_FIELDS[] = {
+        offsetof(SnapshotEntity, name),
+        offsetof(SnapshotEntity, resource),
+        offsetof(SnapshotEntity, tags),
+        offsetof(SnapshotEntity, data),
+    };
+
+    size_t AlignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    uint64_t ReadU64(const uint8_t *p)
+    {
+        uint64_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    void WriteU64(uint8_t *p, uint64_t value)
+    {
+        memcpy(p, &value, sizeof(value));
+    }
+
+#ifdef _WIN32
+    std::wstring Utf8ToWide(const std::string &str)
+    {
+        int length = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), (int)str.size(), nullptr, 0);
+        std::wstring wide(length, L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, str.c_str(), (int)str.size(), &wide[0], length);
+        return wide;
+    }
+#endif
+}
+
+// ======================================================================
+// 写入
+// ======================================================================
+CSceneSnapshotWriter::CSceneSnapshotWriter()
+    : m_heap(8, 0)
+{
+}
+
+uint32_t CSceneSnapshotWriter::AddEntity(uint32_t type, int32_t parent)
+{
+    SnapshotEntity record;
+    memset(&record, 0, sizeof(record));
+    record.type = type;
+    record.parent = parent;
+    record.flags = SNAPSHOT_FLAG_VISIBLE;
+    record.rotation[3] = 1.0f;
+    record.scale[0] = record.scale[1] = record.scale[2] = 1.0f;
+    m_entities.push_back(record);
+    return (uint32_t)m_entities.size() - 1;
+}
+
+uint64_t CSceneSnapshotWriter::Allocate(size_t size, size_t alignment)
+{
+    size_t offset = AlignUp(m_heap.size(), alignment);
+    m_heap.resize(offset + size, 0);
+    return offset;
+}
+
+uint64_t CSceneSnapshotWriter::AddString(const std::wstring &str)
+{
+    if (str.empty())
+        return 0;
+
+    auto it = m_strings.find(str);
+    if (it != m_strings.end())
+        return it->second;
+
+    size_t bytes = (str.size() + 1) * sizeof(wchar_t);
+    uint64_t offset = Allocate(bytes, sizeof(wchar_t));
+    memcpy(&m_heap[offset], str.c_str(), bytes);
+    m_strings.emplace(str, offset);
+    return offset;
+}
+
+void CSceneSnapshotWriter::SetName(uint32_t index, const std::wstring &name)
+{
+    m_entities[index].name.value = AddString(name);
+}
+
+void CSceneSnapshotWriter::SetResource(uint32_t index, const std::wstring &resource)
+{
+    m_entities[index].resource.value = AddString(resource);
+}
+
+void CSceneSnapshotWriter::SetTags(uint32_t index, const std::vector<std::wstring> &tags)
+{
+    // 先驻留字符串再分配数组，数组内只有非空标签
+    std::vector<uint64_t> strings;
+    for (size_t i = 0; i < tags.size(); ++i)
+    {
+        if (!tags[i].empty())
+            strings.push_back(AddString(tags[i]));
+    }
+
+    SnapshotEntity &record = m_entities[index];
+    record.tagCount = (uint32_t)strings.size();
+    record.tags.value = 0;
+    if (strings.empty())
+        return;
+
+    uint64_t offset = Allocate(strings.size() * sizeof(uint64_t), sizeof(uint64_t));
+    for (size_t i = 0; i < strings.size(); ++i)
+    {
+        WriteU64(&m_heap[offset + i * sizeof(uint64_t)], strings[i]);
+        m_heapPointers.push_back(offset + i * sizeof(uint64_t));
+    }
+    record.tags.value = offset;
+}
+
+void CSceneSnapshotWriter::SetData(uint32_t index, const void *pData, size_t size)
+{
+    SnapshotEntity &record = m_entities[index];
+    record.dataSize = (uint32_t)size;
+    record.data.value = 0;
+    if (size == 0)
+        return;
+
+    uint64_t offset = Allocate(size, 8);
+    memcpy(&m_heap[offset], pData, size);
+    record.data.value = offset;
+}
+
+void CSceneSnapshotWriter::Finish(std::vector<uint8_t> &out) const
+{
+    const size_t entityOffset = AlignUp(sizeof(SnapshotHeader), 8);
+    const size_t heapOffset = AlignUp(entityOffset + m_entities.size() * sizeof(SnapshotEntity), 8);
+    const size_t relocationOffset = AlignUp(heapOffset + m_heap.size(), 8);
+
+    // 指针字段由堆内偏移换算为文件内偏移，同时记录位置
+    std::vector<SnapshotEntity> entities(m_entities);
+    std::vector<uint8_t> heap(m_heap);
+    std::vector<uint64_t> relocations;
+    for (size_t i = 0; i < entities.size(); ++i)
+    {
+        uint8_t *pRecord = reinterpret_cast<uint8_t *>(&entities[i]);
+        for (size_t f = 0; f < sizeof(POINTER_FIELDS) / sizeof(POINTER_FIELDS[0]); ++f)
+        {
+            uint64_t value = ReadU64(pRecord + POINTER_FIELDS[f]);
+            if (value == 0)
+                continue;
+            WriteU64(pRecord + POINTER_FIELDS[f], value + heapOffset);
+            relocations.push_back(entityOffset + i * sizeof(SnapshotEntity) + POINTER_FIELDS[f]);
+        }
+    }
+    for (size_t i = 0; i < m_heapPointers.size(); ++i)
+    {
+        uint64_t position = m_heapPointers[i];
+        WriteU64(&heap[position], ReadU64(&heap[position]) + heapOffset);
+        relocations.push_back(heapOffset + position);
+    }
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.wcharSize = (uint8_t)sizeof(wchar_t);
+    header.fileSize = relocationOffset + relocations.size() * sizeof(uint64_t);
+    header.entityOffset = entityOffset;
+    header.relocationOffset = relocationOffset;
+    header.entityCount = (uint32_t)entities.size();
+    header.relocationCount = (uint32_t)relocations.size();
+
+    out.assign((size_t)header.fileSize, 0);
+    memcpy(&out[0], &header, sizeof(header));
+    if (!entities.empty())
+        memcpy(&out[entityOffset], entities.data(), entities.size() * sizeof(SnapshotEntity));
+    memcpy(&out[heapOffset], heap.data(), heap.size());
+    if (!relocations.empty())
+        memcpy(&out[relocationOffset], relocations.data(), relocations.size() * sizeof(uint64_t));
+}
+
+bool CSceneSnapshotWriter::Save(const std::string &path) const
+{
+    std::vector<uint8_t> bytes;
+    Finish(bytes);
+
+#ifdef _WIN32
+    FILE *pFile = _wfopen(Utf8ToWide(path).c_str(), L"wb");
+#else
+    FILE *pFile = fopen(path.c_str(), "wb");
+#endif
+    if (!pFile)
+        return false;
+
+    bool ok = fwrite(bytes.data(), 1, bytes.size(), pFile) == bytes.size();
+    ok = fclose(pFile) == 0 && ok;
+    return ok;
+}
+
+// ======================================================================
+// 读取
+// ======================================================================
+bool CSceneSnapshot::Relocate(uint8_t *pBase, size_t size)
+{
+    // 1. 文件头
+    if (size < sizeof(SnapshotHeader))
+        return false;
+    SnapshotHeader header;
+    memcpy(&header, pBase, sizeof(header));
+    if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION ||
+        header.wcharSize != sizeof(wchar_t) || header.fileSize != size)
+        return false;
+
+    // 2. 实体数组与重定位表的范围（先比较数量，避免乘法溢出）
+    if (header.entityOffset % 8 != 0 || header.entityOffset > size ||
+        header.entityCount > (size - header.entityOffset) / sizeof(SnapshotEntity))
+        return false;
+    if (header.relocationOffset % 8 != 0 || header.relocationOffset > size ||
+        header.relocationCount > (size - header.relocationOffset) / sizeof(uint64_t))
+        return false;
+
+    // 3. 重定位：每个指针字段加上映射基址；字段必须位于文件头之后、重定位表之前
+    const uint64_t base = (uint64_t)(uintptr_t)pBase;
+    const uint8_t *pRelocations = pBase + header.relocationOffset;
+    for (uint32_t i = 0; i < header.relocationCount; ++i)
+    {
+        uint64_t position = ReadU64(pRelocations + i * sizeof(uint64_t));
+        if (position % 8 != 0 || position < sizeof(SnapshotHeader) || position + sizeof(uint64_t) > header.relocationOffset)
+            return false;
+        uint64_t value = ReadU64(pBase + position);
+        if (value == 0 || value >= size)
+            return false;
+        WriteU64(pBase + position, value + base);
+    }
+
+    // 4. 记录：父先子后，指针与数据都落在文件内（同一字段被重定位两次也会在这里超出范围）
+    const uint64_t end = base + size;
+    auto inRange = [&](uint64_t address, uint64_t bytes) {
+        return address >= base && address <= end && bytes <= end - address;
+    };
+    const SnapshotEntity *pEntities = reinterpret_cast<const SnapshotEntity *>(pBase + header.entityOffset);
+    for (uint32_t i = 0; i < header.entityCount; ++i)
+    {
+        const SnapshotEntity &record = pEntities[i];
+        if (record.parent < -1 || record.parent >= (int32_t)i)
+            return false;
+        if ((!record.name.IsNull() && !inRange(record.name.value, sizeof(wchar_t))) ||
+            (!record.resource.IsNull() && !inRange(record.resource.value, sizeof(wchar_t))))
+            return false;
+        if (record.dataSize > 0 && (record.data.IsNull() || !inRange(record.data.value, record.dataSize)))
+            return false;
+        if (record.tagCount > 0)
+        {
+            if (record.tags.IsNull() || record.tags.value % 8 != 0 ||
+                !inRange(record.tags.value, (uint64_t)record.tagCount * sizeof(uint64_t)))
+                return false;
+            for (uint32_t t = 0; t < record.tagCount; ++t)
+            {
+                if (record.tags.Get()[t].IsNull() || !inRange(record.tags.Get()[t].value, sizeof(wchar_t)))
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool CSceneSnapshot::Load(const std::string &path)
+{
+    Close();
+
+#ifdef _WIN32
+    HANDLE hFile = CreateFileW(Utf8ToWide(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                               OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(SnapshotHeader))
+    {
+        CloseHandle(hFile);
+        return false;
+    }
+    // 写时复制映射：重定位只修改本进程的页面
+    HANDLE hMapping = CreateFileMappingW(hFile, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    void *pView = hMapping ? MapViewOfFile(hMapping, FILE_MAP_COPY, 0, 0, 0) : nullptr;
+    if (!pView)
+    {
+        if (hMapping)
+            CloseHandle(hMapping);
+        CloseHandle(hFile);
+        return false;
+    }
+    m_hFile = hFile;
+    m_hMapping = hMapping;
+    m_pBase = static_cast<uint8_t *>(pView);
+    m_size = (size_t)fileSize.QuadPart;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(SnapshotHeader))
+    {
+        close(fd);
+        return false;
+    }
+    // 私有映射：重定位只修改本进程的页面
+    void *pView = mmap(nullptr, (size_t)info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (pView == MAP_FAILED)
+        return false;
+    m_pBase = static_cast<uint8_t *>(pView);
+    m_size = (size_t)info.st_size;
+#endif
+
+    if (!Relocate(m_pBase, m_size))
+    {
+        Close();
+        return false;
+    }
+
+    SnapshotHeader header;
+    memcpy(&header, m_pBase, sizeof(header));
+    m_pEntities = reinterpret_cast<const SnapshotEntity *>(m_pBase + header.entityOffset);
+    m_entityCount = header.entityCount;
+    return true;
+}
+
+void CSceneSnapshot::Close()
+{
+    if (m_pBase)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(m_pBase);
+        CloseHandle((HANDLE)m_hMapping);
+        CloseHandle((HANDLE)m_hFile);
+        m_hMapping = nullptr;
+        m_hFile = nullptr;
+#else
+        munmap(m_pBase, m_size);
+#endif
+    }
+    m_pBase = nullptr;
+    m_size = 0;
+    m_pEntities = nullptr;
+    m_entityCount = 0;
+}
@@ -0,0 +1,186 @@
+#include "stdafx.h"
+#include "Core/SpatialIndex.h"
+#include "Math/MathBatch.h"
+#include <algorithm>
+
+const CSpatialIndex::Handle CSpatialIndex::INVALID_HANDLE;
+
+namespace
+{
+    // 射线与包围盒的进入距离（起点在盒内为 0），不相交返回 -1
+    float RayEnter(const AABB &box, const Vector3 &origin, const Vector3 &invDirection)
+    {
+        float t1 = (box.min.x - origin.x) * invDirection.x;
+        float t2 = (box.max.x - origin.x) * invDirection.x;
+        float tMin = std::min(t1, t2);
+        float tMax = std::max(t1, t2);
+
+        t1 = (box.min.y - origin.y) * invDirection.y;
+        t2 = (box.max.y - origin.y) * invDirection.y;
+        tMin = std::max(tMin, std::min(t1, t2));
+        tMax = std::min(tMax, std::max(t1, t2));
+
+        t1 = (box.min.z - origin.z) * invDirection.z;
+        t2 = (box.max.z - origin.z) * invDirection.z;
+        tMin = std::max(tMin, std::min(t1, t2));
+        tMax = std::min(tMax, std::max(t1, t2));
+
+        tMin = std::max(tMin, 0.0f);
+        return tMin <= tMax ? tMin : -1.0f;
+    }
+}
+
+CSpatialIndex::CSpatialIndex(CTransformStore &store, float margin)
+    : m_store(store), m_tree(margin)
+{
+}
+
+void CSpatialIndex::ComputeWorldBounds(Binding &binding)
+{
+    binding.worldBounds = Math::Batch::TransformAABB(m_store.GetWorldMatrix(binding.transform), binding.localBounds);
+    // GetWorldMatrix 可能补算了世界矩阵，序号在其后读取
+    binding.stamp = m_store.GetWorldStamp(binding.transform);
+}
+
+// ======================================================================
+// 登记
+// ======================================================================
+CSpatialIndex::Handle CSpatialIndex::Add(unsigned int entityID, CTransformStore::Handle transform, const AABB &localBounds)
+{
+    Binding binding;
+    binding.entityID = entityID;
+    binding.transform = transform;
+    binding.localBounds = localBounds;
+    binding.livePos = (uint32_t)m_live.size();
+    ComputeWorldBounds(binding);
+
+    Handle handle = m_tree.CreateProxy(binding.worldBounds, entityID);
+    if (handle >= m_bindings.size())
+        m_bindings.resize(handle + 1);
+    m_bindings[handle] = binding;
+    m_live.push_back(handle);
+    return handle;
+}
+
+void CSpatialIndex::Remove(Handle handle)
+{
+    // 交换删除
+    uint32_t pos = m_bindings[handle].livePos;
+    Handle last = m_live.back();
+    m_live[pos] = last;
+    m_bindings[last].livePos = pos;
+    m_live.pop_back();
+
+    m_tree.DestroyProxy(handle);
+}
+
+void CSpatialIndex::SetLocalBounds(Handle handle, const AABB &localBounds)
+{
+    Binding &binding = m_bindings[handle];
+    Vector3 oldCenter = binding.worldBounds.GetCenter();
+    binding.localBounds = localBounds;
+    ComputeWorldBounds(binding);
+    m_tree.MoveProxy(handle, binding.worldBounds, binding.worldBounds.GetCenter() - oldCenter);
+}
+
+size_t CSpatialIndex::Update()
+{
+    size_t changed = 0;
+    m_lastReinserted = 0;
+    for (size_t i = 0; i < m_live.size(); ++i)
+    {
+        Handle handle = m_live[i];
+        Binding &binding = m_bindings[handle];
+        if (m_store.GetWorldStamp(binding.transform) == binding.stamp)
+            continue;
+
+        Vector3 oldCenter = binding.worldBounds.GetCenter();
+        ComputeWorldBounds(binding);
+        if (m_tree.MoveProxy(handle, binding.worldBounds, binding.worldBounds.GetCenter() - oldCenter))
+            ++m_lastReinserted;
+        ++changed;
+    }
+    return changed;
+}
+
+void CSpatialIndex::Clear()
+{
+    m_tree.Clear();
+    m_bindings.clear();
+    m_live.clear();
+    m_lastReinserted = 0;
+}
+
+// ======================================================================
+// 查询
+// ======================================================================
+void CSpatialIndex::QueryAABB(const AABB &box, std::vector<unsigned int> &out) const
+{
+    m_tree.QueryAABB(box, [&](Handle handle) {
+        const Binding &binding = m_bindings[handle];
+        if (binding.worldBounds.Intersects(box))
+            out.push_back(binding.entityID);
+        return true;
+    });
+}
+
+void CSpatialIndex::QuerySphere(const Vector3 &center, float radius, std::vector<unsigned int> &out) const
+{
+    const float radiusSq = radius * radius;
+    m_tree.QuerySphere(center, radius, [&](Handle handle) {
+        const Binding &binding = m_bindings[handle];
+        Vector3 closest = Vector3::Max(binding.worldBounds.min, Vector3::Min(center, binding.worldBounds.max));
+        if ((closest - center).LengthSquared() <= radiusSq)
+            out.push_back(binding.entityID);
+        return true;
+    });
+}
+
+void CSpatialIndex::QueryFrustum(const Frustum &frustum, std::vector<unsigned int> &out) const
+{
+    m_candidateIDs.clear();
+    m_candidateBounds.clear();
+    m_tree.QueryFrustum(frustum, [&](Handle handle, bool fullyInside) {
+        const Binding &binding = m_bindings[handle];
+        // 放大盒整体在视锥内时紧包围盒必然也在
+        if (fullyInside)
+        {
+            out.push_back(binding.entityID);
+        }
+        else
+        {
+            m_candidateIDs.push_back(binding.entityID);
+            m_candidateBounds.push_back(binding.worldBounds);
+        }
+        return true;
+    });
+
+    m_candidateVisible.resize(m_candidateIDs.size());
+    Math::Batch::CullAABBs(frustum, m_candidateBounds.data(), m_candidateBounds.size(), m_candidateVisible.data());
+    for (size_t i = 0; i < m_candidateIDs.size(); ++i)
+    {
+        if (m_candidateVisible[i])
+            out.push_back(m_candidateIDs[i]);
+    }
+}
+
+unsigned int CSpatialIndex::RayCast(const Vector3 &origin, const Vector3 &direction, float maxDistance, float *pDistance) const
+{
+    Vector3 invDirection(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+    unsigned int hitID = 0;
+    float best = maxDistance;
+    m_tree.RayCast(origin, direction, maxDistance, [&](Handle handle, float) {
+        const Binding &binding = m_bindings[handle];
+        float enter = RayEnter(binding.worldBounds, origin, invDirection);
+        if (enter < 0.0f || enter > best)
+            return -1.0f;
+        best = enter;
+        hitID = binding.entityID;
+        // 收缩射线；为 0 时（起点在包围盒内）不会有更近的交点，直接结束
+        return enter;
+    });
+
+    if (hitID && pDistance)
+        *pDistance = best;
+    return hitID;
+}
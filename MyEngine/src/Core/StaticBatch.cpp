@@ -0,0 +1,107 @@
+#include "stdafx.h"
+#include "Core/StaticBatch.h"
+#include <algorithm>
+
+namespace
+{
+    // 10 位整数的各位之间插入两个 0
+    uint32_t SpreadBits(uint32_t x)
+    {
+        x &= 0x3FF;
+        x = (x | (x << 16)) & 0x030000FF;
+        x = (x | (x << 8)) & 0x0300F00F;
+        x = (x | (x << 4)) & 0x030C30C3;
+        x = (x | (x << 2)) & 0x09249249;
+        return x;
+    }
+
+    uint32_t Quantize(float value, float minValue, float invExtent)
+    {
+        float t = (value - minValue) * invExtent;
+        t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+        return (uint32_t)(t * 1023.0f);
+    }
+}
+
+void CStaticBatch::Clear()
+{
+    m_vertices.clear();
+    m_indices.clear();
+    m_groups.clear();
+    m_ranges.clear();
+    m_pendingVertices.clear();
+    m_pendingIndices.clear();
+    m_pending.clear();
+    m_vertexBuffer = m_indexBuffer = 0;
+}
+
+void CStaticBatch::Build()
+{
+    if (m_pending.empty())
+        return;
+
+    // 1. 子网格包围盒中心在全部子网格范围内的 Morton 码
+    AABB all;
+    for (size_t i = 0; i < m_pending.size(); ++i)
+        all.Expand(m_pending[i].bounds);
+    Vector3 size = all.GetSize();
+    Vector3 invSize(size.x > 0.0f ? 1.0f / size.x : 0.0f, size.y > 0.0f ? 1.0f / size.y : 0.0f,
+                    size.z > 0.0f ? 1.0f / size.z : 0.0f);
+    for (size_t i = 0; i < m_pending.size(); ++i)
+    {
+        Vector3 c = m_pending[i].bounds.GetCenter();
+        m_pending[i].morton = (SpreadBits(Quantize(c.x, all.min.x, invSize.x)) << 2) |
+                              (SpreadBits(Quantize(c.y, all.min.y, invSize.y)) << 1) |
+                              SpreadBits(Quantize(c.z, all.min.z, invSize.z));
+    }
+
+    // 2. 按材质、纹理分组，组内按空间位置
+    std::stable_sort(m_pending.begin(), m_pending.end(), [](const Pending &a, const Pending &b) {
+        if (a.material != b.material)
+            return a.material < b.material;
+        if (a.texture != b.texture)
+            return a.texture < b.texture;
+        return a.morton < b.morton;
+    });
+
+    // 3. 依次写出顶点与重定位后的索引
+    m_vertices.reserve(m_vertices.size() + m_pendingVertices.size());
+    m_indices.reserve(m_indices.size() + m_pendingIndices.size());
+    for (size_t i = 0; i < m_pending.size(); ++i)
+    {
+        const Pending &pending = m_pending[i];
+        if (i == 0 || pending.material != m_pending[i - 1].material || pending.texture != m_pending[i - 1].texture)
+        {
+            Group group;
+            group.pMesh = pending.pMesh;
+            group.material = pending.material;
+            group.texture = pending.texture;
+            group.firstRange = (uint32_t)m_ranges.size();
+            group.rangeCount = 0;
+            group.firstIndex = (uint32_t)m_indices.size();
+            group.indexCount = 0;
+            m_groups.push_back(group);
+        }
+
+        Range range;
+        range.firstIndex = (uint32_t)m_indices.size();
+        range.indexCount = pending.indexCount;
+        range.ownerID = pending.ownerID;
+        range.bounds = pending.bounds;
+        m_ranges.push_back(range);
+
+        const uint32_t base = (uint32_t)m_vertices.size();
+        m_vertices.insert(m_vertices.end(), m_pendingVertices.begin() + pending.firstVertex,
+                          m_pendingVertices.begin() + pending.firstVertex + pending.vertexCount);
+        for (uint32_t k = 0; k < pending.indexCount; ++k)
+            m_indices.push_back(base + m_pendingIndices[pending.firstIndex + k]);
+
+        Group &group = m_groups.back();
+        ++group.rangeCount;
+        group.indexCount += pending.indexCount;
+    }
+
+    m_pendingVertices.clear();
+    m_pendingIndices.clear();
+    m_pending.clear();
+}
@@ -0,0 +1,414 @@
+#include "stdafx.h"
+#include "Core/TerrainQuadtree.h"
+#include "Core/JobSystem.h"
+#include "Core/LODController.h"
+#include "Math/MathBatch.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const size_t CHUNK_GRAIN = 4;
+
+    int8_t PackNormal(float v)
+    {
+        return (int8_t)std::lround(std::max(-1.0f, std::min(1.0f, v)) * 127.0f);
+    }
+}
+
+bool CTerrainQuadtree::Build(const float *heights, int width, int height, float cellSize, int chunkCells, CJobSystem *pJobs)
+{
+    Clear();
+    // 16 位索引要求 (chunkCells + 1)^2 <= 65536
+    if (!heights || width < 2 || height < 2 || !(cellSize > 0.0f) ||
+        chunkCells < 2 || chunkCells > 128 || (chunkCells & (chunkCells - 1)) != 0)
+        return false;
+
+    m_heights = heights;
+    m_width = width;
+    m_height = height;
+    m_cellSize = cellSize;
+    m_chunkCells = chunkCells;
+    m_chunksX = (width - 1 + chunkCells - 1) / chunkCells;
+    m_chunksZ = (height - 1 + chunkCells - 1) / chunkCells;
+    m_levelCount = 1;
+    while ((1 << (m_levelCount - 1)) < chunkCells)
+        ++m_levelCount;
+
+    const size_t chunkCount = GetChunkCount();
+    m_chunkBounds.resize(chunkCount);
+    m_errors.assign(chunkCount * m_levelCount, 0.0f);
+    m_levels.assign(chunkCount, 0);
+
+    // 各块的包围盒与误差互不相关
+    CJobSystem::ParallelFor(pJobs, chunkCount, CHUNK_GRAIN, [this](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c)
+            ComputeChunk(c);
+    });
+    for (size_t c = 0; c < chunkCount; ++c)
+        m_bounds.Expand(m_chunkBounds[c]);
+
+    BuildIndexSets();
+
+    m_nodes.reserve(chunkCount * 2);
+    m_nodes.push_back(Node{AABB(), 0, 0, m_chunksX, m_chunksZ, -1, 0});
+    BuildNode(0);
+    return true;
+}
+
+void CTerrainQuadtree::Clear()
+{
+    m_heights = nullptr;
+    m_width = m_height = 0;
+    m_chunksX = m_chunksZ = 0;
+    m_levelCount = 0;
+    m_bounds = AABB();
+    m_chunkBounds.clear();
+    m_errors.clear();
+    m_indices.clear();
+    m_indexSets.clear();
+    m_nodes.clear();
+    m_levels.clear();
+    m_visible.clear();
+    m_pixelScale.clear();
+    m_stats = TerrainStats();
+}
+
+float CTerrainQuadtree::HeightAt(int x, int z) const
+{
+    x = std::max(0, std::min(x, m_width - 1));
+    z = std::max(0, std::min(z, m_height - 1));
+    return m_heights[(size_t)z * m_width + x];
+}
+
+void CTerrainQuadtree::ComputeChunk(size_t chunk)
+{
+    const int C = m_chunkCells;
+    const int baseX = (int)(chunk % m_chunksX) * C, baseZ = (int)(chunk / m_chunksX) * C;
+
+    // 包围盒：全分辨率顶点（各级都是它的子集）
+    AABB bounds;
+    for (int j = 0; j <= C; ++j)
+    {
+        const int z = std::min(baseZ + j, m_height - 1);
+        for (int i = 0; i <= C; ++i)
+        {
+            const int x = std::min(baseX + i, m_width - 1);
+            bounds.Expand(Vector3((x - m_width * 0.5f) * m_cellSize, HeightAt(x, z), (z - m_height * 0.5f) * m_cellSize));
+        }
+    }
+    m_chunkBounds[chunk] = bounds;
+
+    // 误差：级别 l 的每个粗格子按索引的对角线（(x, z+s) - (x+s, z)）分成两个三角形插值，
+    // 与格子内全分辨率高度比较；与前一级取最大值保证单调
+    float *errors = &m_errors[chunk * m_levelCount];
+    for (int level = 1; level < m_levelCount; ++level)
+    {
+        const int s = 1 << level;
+        const float inv = 1.0f / (float)s;
+        float worst = errors[level - 1];
+        for (int cz = 0; cz < C; cz += s)
+        {
+            for (int cx = 0; cx < C; cx += s)
+            {
+                const int x0 = baseX + cx, z0 = baseZ + cz;
+                const float h00 = HeightAt(x0, z0), h10 = HeightAt(x0 + s, z0);
+                const float h01 = HeightAt(x0, z0 + s), h11 = HeightAt(x0 + s, z0 + s);
+                for (int dz = 0; dz <= s; ++dz)
+                {
+                    for (int dx = 0; dx <= s; ++dx)
+                    {
+                        float h = (dx + dz <= s) ? h00 + ((h10 - h00) * dx + (h01 - h00) * dz) * inv
+                                                 : h11 + ((h01 - h11) * (s - dx) + (h10 - h11) * (s - dz)) * inv;
+                        worst = std::max(worst, std::fabs(h - HeightAt(x0 + dx, z0 + dz)));
+                    }
+                }
+            }
+        }
+        errors[level] = worst;
+    }
+}
+
+void CTerrainQuadtree::BuildChunkVertices(size_t chunk, TerrainVertex *out) const
+{
+    const int C = m_chunkCells;
+    const int baseX = (int)(chunk % m_chunksX) * C, baseZ = (int)(chunk / m_chunksX) * C;
+    for (int j = 0; j <= C; ++j)
+    {
+        const int z = std::min(baseZ + j, m_height - 1);
+        const int zPrev = std::max(z - 1, 0), zNext = std::min(z + 1, m_height - 1);
+        for (int i = 0; i <= C; ++i)
+        {
+            const int x = std::min(baseX + i, m_width - 1);
+            const int xPrev = std::max(x - 1, 0), xNext = std::min(x + 1, m_width - 1);
+
+            // 法线取全局高度的中心差分，相邻块共用的边上完全一致
+            float slopeX = (HeightAt(xNext, z) - HeightAt(xPrev, z)) / ((xNext - xPrev) * m_cellSize);
+            float slopeZ = (HeightAt(x, zNext) - HeightAt(x, zPrev)) / ((zNext - zPrev) * m_cellSize);
+            float invLength = 1.0f / std::sqrt(slopeX * slopeX + slopeZ * slopeZ + 1.0f);
+
+            TerrainVertex &v = *out++;
+            v.x = (x - m_width * 0.5f) * m_cellSize;
+            v.y = HeightAt(x, z);
+            v.z = (z - m_height * 0.5f) * m_cellSize;
+            v.nx = PackNormal(-slopeX * invLength);
+            v.ny = PackNormal(invLength);
+            v.nz = PackNormal(-slopeZ * invLength);
+            v.pad = 0;
+        }
+    }
+}
+
+void CTerrainQuadtree::BuildIndexSets()
+{
+    const int C = m_chunkCells, stride = C + 1;
+    m_indexSets.assign((size_t)m_levelCount * 16, IndexSet{0, 0});
+
+    for (int level = 0; level < m_levelCount; ++level)
+    {
+        const int s = 1 << level;
+        for (unsigned int edges = 0; edges < 16; ++edges)
+        {
+            // 最粗一级没有更粗的邻块
+            if (edges != 0 && level + 1 == m_levelCount)
+            {
+                m_indexSets[level * 16 + edges] = m_indexSets[level * 16];
+                continue;
+            }
+
+            // 对着粗邻块的边上，奇数位置（按本级步长）的顶点折叠到前一个偶数顶点，
+            // 相邻三角形随之拉伸填满，边上只剩与邻块相同的顶点
+            auto vertex = [&](int x, int z) -> uint16_t {
+                if (z == 0 && (edges & EDGE_NEG_Z) && x % (2 * s) == s)
+                    x -= s;
+                else if (z == C && (edges & EDGE_POS_Z) && x % (2 * s) == s)
+                    x -= s;
+                if (x == 0 && (edges & EDGE_NEG_X) && z % (2 * s) == s)
+                    z -= s;
+                else if (x == C && (edges & EDGE_POS_X) && z % (2 * s) == s)
+                    z -= s;
+                return (uint16_t)(z * stride + x);
+            };
+            auto emit = [this](uint16_t a, uint16_t b, uint16_t c) {
+                if (a != b && b != c && a != c)
+                {
+                    m_indices.push_back(a);
+                    m_indices.push_back(b);
+                    m_indices.push_back(c);
+                }
+            };
+
+            const size_t offset = m_indices.size();
+            for (int z = 0; z < C; z += s)
+            {
+                for (int x = 0; x < C; x += s)
+                {
+                    // 与原地形相同的绕序：(x,z) (x,z+s) (x+s,z) / (x+s,z) (x,z+s) (x+s,z+s)
+                    uint16_t i0 = vertex(x, z), i1 = vertex(x, z + s), i2 = vertex(x + s, z), i3 = vertex(x + s, z + s);
+                    emit(i0, i1, i2);
+                    emit(i2, i1, i3);
+                }
+            }
+            m_indexSets[level * 16 + edges] = IndexSet{offset, m_indices.size() - offset};
+        }
+    }
+}
+
+void CTerrainQuadtree::BuildNode(int32_t node)
+{
+    const int x0 = m_nodes[node].x0, z0 = m_nodes[node].z0, x1 = m_nodes[node].x1, z1 = m_nodes[node].z1;
+    if (x1 - x0 == 1 && z1 - z0 == 1)
+    {
+        m_nodes[node].bounds = m_chunkBounds[(size_t)z0 * m_chunksX + x0];
+        return;
+    }
+
+    // 按中线切成至多四块，先占好连续的位置再递归
+    const int mx = (x1 - x0 > 1) ? (x0 + x1) / 2 : x1;
+    const int mz = (z1 - z0 > 1) ? (z0 + z1) / 2 : z1;
+    const int32_t first = (int32_t)m_nodes.size();
+    const int xs[3] = {x0, mx, x1}, zs[3] = {z0, mz, z1};
+    for (int j = 0; j < 2; ++j)
+    {
+        for (int i = 0; i < 2; ++i)
+        {
+            if (xs[i] < xs[i + 1] && zs[j] < zs[j + 1])
+                m_nodes.push_back(Node{AABB(), xs[i], zs[j], xs[i + 1], zs[j + 1], -1, 0});
+        }
+    }
+    const int32_t count = (int32_t)m_nodes.size() - first;
+    m_nodes[node].firstChild = first;
+    m_nodes[node].childCount = count;
+
+    AABB bounds;
+    for (int32_t c = 0; c < count; ++c)
+    {
+        BuildNode(first + c);
+        bounds.Expand(m_nodes[first + c].bounds);
+    }
+    m_nodes[node].bounds = bounds;
+}
+
+void CTerrainQuadtree::CollectVisible(int32_t node, const Frustum &frustum, const Matrix4 &world, uint32_t mask)
+{
+    const Node &n = m_nodes[node];
+    // 已完全在视锥内的子树不再测试
+    if (mask != 0 && frustum.Classify(Math::Batch::TransformAABB(world, n.bounds), mask) == Frustum::Outside)
+        return;
+
+    if (n.firstChild < 0)
+    {
+        m_visible.push_back((uint32_t)((size_t)n.z0 * m_chunksX + n.x0));
+        return;
+    }
+    for (int32_t c = 0; c < n.childCount; ++c)
+        CollectVisible(n.firstChild + c, frustum, world, mask);
+}
+
+void CTerrainQuadtree::BalanceLevels()
+{
+    // 级别 = min(自身, 邻块 + 1) 对整个网格成立，等价于曼哈顿距离变换：正反两遍扫描即可
+    const int cx = m_chunksX, cz = m_chunksZ;
+    for (int z = 0; z < cz; ++z)
+    {
+        for (int x = 0; x < cx; ++x)
+        {
+            int &level = m_levels[(size_t)z * cx + x];
+            if (x > 0)
+                level = std::min(level, m_levels[(size_t)z * cx + x - 1] + 1);
+            if (z > 0)
+                level = std::min(level, m_levels[(size_t)(z - 1) * cx + x] + 1);
+        }
+    }
+    for (int z = cz - 1; z >= 0; --z)
+    {
+        for (int x = cx - 1; x >= 0; --x)
+        {
+            int &level = m_levels[(size_t)z * cx + x];
+            if (x + 1 < cx)
+                level = std::min(level, m_levels[(size_t)z * cx + x + 1] + 1);
+            if (z + 1 < cz)
+                level = std::min(level, m_levels[(size_t)(z + 1) * cx + x] + 1);
+        }
+    }
+}
+
+unsigned int CTerrainQuadtree::GetEdges(size_t chunk) const
+{
+    const int x = (int)(chunk % m_chunksX), z = (int)(chunk / m_chunksX);
+    const int level = m_levels[chunk];
+    unsigned int edges = 0;
+    if (z > 0 && m_levels[chunk - m_chunksX] > level)
+        edges |= EDGE_NEG_Z;
+    if (x + 1 < m_chunksX && m_levels[chunk + 1] > level)
+        edges |= EDGE_POS_X;
+    if (z + 1 < m_chunksZ && m_levels[chunk + m_chunksX] > level)
+        edges |= EDGE_POS_Z;
+    if (x > 0 && m_levels[chunk - 1] > level)
+        edges |= EDGE_NEG_X;
+    return edges;
+}
+
+size_t CTerrainQuadtree::CountTriangles() const
+{
+    size_t triangles = 0;
+    for (size_t i = 0; i < m_visible.size(); ++i)
+        triangles += GetIndexCount(m_levels[m_visible[i]], GetEdges(m_visible[i])) / 3;
+    return triangles;
+}
+
+size_t CTerrainQuadtree::Select(const Frustum &frustum, const Matrix4 &world, const CLODController *pLOD,
+                                std::vector<TerrainChunkDraw> &out)
+{
+    out.clear();
+    m_visible.clear();
+    m_stats = TerrainStats();
+    if (m_nodes.empty())
+        return 0;
+
+    CollectVisible(0, frustum, world, Frustum::ALL_PLANES);
+
+    // 1. 每块按屏幕误差选级别（视锥外的块也要选，整理级别时作为邻块）
+    const int minLevel = std::max(0, std::min(m_minLevel, m_levelCount - 1));
+    const size_t chunkCount = GetChunkCount();
+    for (size_t c = 0; c < chunkCount; ++c)
+    {
+        int level = 0;
+        if (pLOD)
+        {
+            const AABB &bounds = m_chunkBounds[c];
+            level = (int)pLOD->Select(&m_errors[c * m_levelCount], m_levelCount, world, bounds.GetCenter(),
+                                      bounds.GetExtents().Length(), (size_t)m_levels[c]);
+        }
+        m_levels[c] = std::max(level, minLevel);
+    }
+    BalanceLevels();
+
+    // 2. 超出预算时，视锥外的块与屏幕误差最小的可见块依次加粗一级，重新整理后再检查
+    if (m_triangleBudget > 0 && pLOD)
+    {
+        m_pixelScale.resize(m_visible.size());
+        for (size_t i = 0; i < m_visible.size(); ++i)
+        {
+            const AABB &bounds = m_chunkBounds[m_visible[i]];
+            m_pixelScale[i] = pLOD->ErrorToPixels(world, bounds.GetCenter(), bounds.GetExtents().Length());
+        }
+
+        std::vector<uint8_t> inView(chunkCount, 0);
+        for (size_t i = 0; i < m_visible.size(); ++i)
+            inView[m_visible[i]] = 1;
+
+        std::vector<std::pair<float, uint32_t>> candidates;
+        for (int pass = 0; pass < m_levelCount; ++pass)
+        {
+            size_t triangles = CountTriangles();
+            if (triangles <= m_triangleBudget)
+                break;
+
+            candidates.clear();
+            for (size_t c = 0; c < chunkCount; ++c)
+            {
+                if (!inView[c] && m_levels[c] + 1 < m_levelCount)
+                    candidates.push_back(std::make_pair(-1.0f, (uint32_t)c));
+            }
+            for (size_t i = 0; i < m_visible.size(); ++i)
+            {
+                const uint32_t c = m_visible[i];
+                if (m_levels[c] + 1 < m_levelCount)
+                    candidates.push_back(std::make_pair(GetChunkError(c, m_levels[c] + 1) * m_pixelScale[i], c));
+            }
+            if (candidates.empty())
+                break;
+            std::sort(candidates.begin(), candidates.end());
+
+            for (size_t i = 0; i < candidates.size(); ++i)
+            {
+                const uint32_t c = candidates[i].second;
+                if (candidates[i].first >= 0.0f)
+                {
+                    if (triangles <= m_triangleBudget)
+                        break;
+                    // 按无拼接的索引估算，整理后再精确统计
+                    triangles -= GetIndexCount(m_levels[c], 0) / 3 - GetIndexCount(m_levels[c] + 1, 0) / 3;
+                }
+                ++m_levels[c];
+            }
+            BalanceLevels();
+        }
+    }
+
+    // 3. 输出视锥内的块
+    out.reserve(m_visible.size());
+    for (size_t i = 0; i < m_visible.size(); ++i)
+    {
+        const uint32_t c = m_visible[i];
+        const TerrainChunkDraw draw = {c, (uint16_t)m_levels[c], (uint16_t)GetEdges(c)};
+        out.push_back(draw);
+        m_stats.reduced += draw.level > 0;
+        m_stats.fullTriangles += GetIndexCount(0, 0) / 3;
+        m_stats.drawnTriangles += GetIndexCount(draw.level, draw.edges) / 3;
+    }
+    m_stats.chunks = chunkCount;
+    m_stats.visible = m_visible.size();
+    return out.size();
+}
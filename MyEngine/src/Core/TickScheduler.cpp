@@ -0,0 +1,255 @@
+#include "stdafx.h"
+#include "Core/TickScheduler.h"
+
+const CTickScheduler::Handle CTickScheduler::INVALID_HANDLE;
+const uint32_t CTickScheduler::TICK_ON_DEMAND;
+
+namespace
+{
+    const size_t NOT_RUNNING = (size_t)TickGroup::Count;
+}
+
+// ======================================================================
+// 登记
+// ======================================================================
+CTickScheduler::Handle CTickScheduler::Register(void *pOwner, TickFunc func, TickGroup group, uint32_t interval)
+{
+    Handle handle;
+    if (m_firstFree != INVALID_HANDLE)
+    {
+        handle = m_firstFree;
+        m_firstFree = m_slots[handle].nextFree;
+        --m_freeCount;
+    }
+    else
+    {
+        handle = (Handle)m_slots.size();
+        m_slots.push_back(Slot());
+    }
+
+    Slot &slot = m_slots[handle];
+    slot.pOwner = pOwner;
+    slot.func = func;
+    slot.interval = interval;
+    slot.index = INVALID_HANDLE;
+    slot.nextFree = INVALID_HANDLE;
+    slot.group = group;
+    slot.active = true;
+    slot.requested = false;
+    slot.used = true;
+
+    if (ShouldSchedule(slot))
+        Schedule(handle);
+    return handle;
+}
+
+void CTickScheduler::Unregister(Handle handle)
+{
+    if (handle >= m_slots.size() || !m_slots[handle].used)
+        return;
+
+    Unschedule(handle);
+    Slot &slot = m_slots[handle];
+    slot.used = false;
+    slot.requested = false;
+    slot.nextFree = m_firstFree;
+    m_firstFree = handle;
+    ++m_freeCount;
+}
+
+void CTickScheduler::SetGroup(Handle handle, TickGroup group)
+{
+    Slot &slot = m_slots[handle];
+    if (slot.group == group)
+        return;
+
+    bool scheduled = slot.index != INVALID_HANDLE;
+    if (scheduled)
+        Unschedule(handle);
+    slot.group = group;
+    if (scheduled)
+        Schedule(handle);
+    if (slot.requested)
+        m_requests[(size_t)group].push_back(handle); // 旧组中的请求在执行时按组号跳过
+}
+
+void CTickScheduler::SetInterval(Handle handle, uint32_t interval)
+{
+    Slot &slot = m_slots[handle];
+    if (slot.interval == interval)
+        return;
+
+    slot.interval = interval;
+    if (slot.index != INVALID_HANDLE && interval != TICK_ON_DEMAND)
+    {
+        Entry &entry = m_entries[(size_t)slot.group][slot.index];
+        entry.interval = interval;
+        entry.phase = handle % interval;
+    }
+    else if (ShouldSchedule(slot))
+        Schedule(handle);
+    else
+        Unschedule(handle);
+}
+
+void CTickScheduler::SetActive(Handle handle, bool active)
+{
+    Slot &slot = m_slots[handle];
+    if (slot.active == active)
+        return;
+
+    slot.active = active;
+    if (ShouldSchedule(slot))
+        Schedule(handle);
+    else
+        Unschedule(handle);
+}
+
+void CTickScheduler::RequestTick(Handle handle)
+{
+    Slot &slot = m_slots[handle];
+    if (!slot.used || !slot.active || slot.requested)
+        return;
+
+    slot.requested = true;
+    m_requests[(size_t)slot.group].push_back(handle);
+}
+
+void CTickScheduler::Schedule(Handle handle)
+{
+    Slot &slot = m_slots[handle];
+    if (slot.index != INVALID_HANDLE)
+        return;
+
+    std::vector<Entry> &entries = m_entries[(size_t)slot.group];
+    Entry entry = {slot.pOwner, slot.func, handle, slot.interval, handle % slot.interval, m_time};
+    slot.index = (uint32_t)entries.size();
+    entries.push_back(entry);
+}
+
+void CTickScheduler::Unschedule(Handle handle)
+{
+    Slot &slot = m_slots[handle];
+    if (slot.index == INVALID_HANDLE)
+        return;
+
+    size_t group = (size_t)slot.group;
+    std::vector<Entry> &entries = m_entries[group];
+    if (m_running == group)
+    {
+        // 正在执行该组：只留空位，组执行完后再压缩，避免打乱尚未执行的项
+        entries[slot.index].func = nullptr;
+        m_hasHoles[group] = true;
+    }
+    else
+    {
+        // 最后一项搬到空位
+        Entry &last = entries.back();
+        m_slots[last.handle].index = slot.index;
+        entries[slot.index] = last;
+        entries.pop_back();
+    }
+    slot.index = INVALID_HANDLE;
+}
+
+void CTickScheduler::Compact(TickGroup group)
+{
+    std::vector<Entry> &entries = m_entries[(size_t)group];
+    size_t out = 0;
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        if (!entries[i].func)
+            continue;
+        m_slots[entries[i].handle].index = (uint32_t)out;
+        entries[out++] = entries[i];
+    }
+    entries.resize(out);
+    m_hasHoles[(size_t)group] = false;
+}
+
+// ======================================================================
+// 执行
+// ======================================================================
+void CTickScheduler::Tick(float deltaTime)
+{
+    BeginFrame(deltaTime);
+    for (size_t group = 0; group < (size_t)TickGroup::Count; ++group)
+        RunGroup((TickGroup)group);
+}
+
+void CTickScheduler::BeginFrame(float deltaTime)
+{
+    ++m_frame;
+    m_time += deltaTime;
+    m_deltaTime = deltaTime;
+}
+
+void CTickScheduler::RunGroup(TickGroup group)
+{
+    size_t g = (size_t)group;
+    m_running = g;
+
+    // 1. 按频率执行；回调可能让列表扩容，每次都重新取元素，且不持有引用跨过回调
+    std::vector<Entry> &entries = m_entries[g];
+    size_t count = entries.size();
+    for (size_t i = 0; i < count; ++i)
+    {
+        Entry &entry = entries[i];
+        if (!entry.func || !IsDue(entry))
+            continue;
+
+        float deltaTime = entry.interval == 1 ? m_deltaTime : (float)(m_time - entry.lastTime);
+        entry.lastTime = m_time;
+        void *pOwner = entry.pOwner;
+        TickFunc func = entry.func;
+        func(pOwner, deltaTime);
+    }
+
+    // 2. 按需请求：执行期间新增的请求留到下一帧
+    m_requestScratch.clear();
+    m_requestScratch.swap(m_requests[g]);
+    for (size_t i = 0; i < m_requestScratch.size(); ++i)
+    {
+        Handle handle = m_requestScratch[i];
+        Slot &slot = m_slots[handle];
+        if (!slot.requested || slot.group != group)
+            continue; // 已注销、已执行过或已换组
+        slot.requested = false;
+        if (!slot.active)
+            continue;
+        if (slot.index != INVALID_HANDLE && IsDue(m_entries[g][slot.index]))
+            continue; // 本帧已按频率执行
+
+        void *pOwner = slot.pOwner;
+        TickFunc func = slot.func;
+        func(pOwner, m_deltaTime);
+    }
+
+    m_running = NOT_RUNNING;
+    if (m_hasHoles[g])
+        Compact(group);
+}
+
+size_t CTickScheduler::GetScheduledCount() const
+{
+    size_t count = 0;
+    for (size_t group = 0; group < (size_t)TickGroup::Count; ++group)
+        count += m_entries[group].size();
+    return count;
+}
+
+void CTickScheduler::Clear()
+{
+    m_slots.clear();
+    m_firstFree = INVALID_HANDLE;
+    m_freeCount = 0;
+    for (size_t group = 0; group < (size_t)TickGroup::Count; ++group)
+    {
+        m_entries[group].clear();
+        m_requests[group].clear();
+        m_hasHoles[group] = false;
+    }
+    m_frame = 0;
+    m_time = 0.0;
+    m_deltaTime = 0.0f;
+}
@@ -0,0 +1,371 @@
+#include "stdafx.h"
+#include "Core/TransformStore.h"
+#include "Core/JobSystem.h"
+#include <atomic>
+
+const CTransformStore::Handle CTransformStore::INVALID_HANDLE;
+const size_t CTransformStore::PARALLEL_THRESHOLD;
+const size_t CTransformStore::PARALLEL_GRAIN;
+const size_t CTransformStore::SPLIT_MIN_WIDTH;
+
+namespace
+{
+    // 按新长度重建数组但保留原容量：重排后再新建节点不必重新扩容
+    template <typename T>
+    void AllocateLike(std::vector<T> &out, const std::vector<T> &like, size_t size)
+    {
+        out.reserve(like.capacity());
+        out.resize(size);
+    }
+}
+
+CTransformStore &CTransformStore::GetInstance()
+{
+    static CTransformStore s_instance;
+    return s_instance;
+}
+
+// ======================================================================
+// 节点管理
+// ======================================================================
+CTransformStore::Handle CTransformStore::Create()
+{
+    Handle handle;
+    if (!m_freeHandles.empty())
+    {
+        handle = m_freeHandles.back();
+        m_freeHandles.pop_back();
+    }
+    else
+    {
+        handle = (Handle)m_denseOf.size();
+        m_denseOf.push_back(INVALID_HANDLE);
+    }
+
+    // 新节点是根节点，追加到末尾不破坏拓扑序；单位变换的世界矩阵无需计算
+    uint32_t index = (uint32_t)m_handleOf.size();
+    m_position.push_back(Vector3::Zero());
+    m_rotation.push_back(Quaternion::Identity());
+    m_scale.push_back(Vector3::One());
+    m_world.push_back(Matrix4::Identity());
+    m_parent.push_back(INVALID_HANDLE);
+    m_stamp.push_back(m_nextStamp++);
+    m_dirty.push_back(0);
+    m_handleOf.push_back(handle);
+
+    m_denseOf[handle] = index;
+    ++m_liveCount;
+    m_bGroupsDirty = true;
+    return handle;
+}
+
+void CTransformStore::Destroy(Handle handle)
+{
+    if (!IsValid(handle))
+        return;
+
+    // 只做标记，数组在下次扫描前统一压缩；
+    // 刷新序号让子节点看到"父节点已变化"，补算时按根节点处理
+    uint32_t index = m_denseOf[handle];
+    m_handleOf[index] = INVALID_HANDLE;
+    m_stamp[index] = m_nextStamp++;
+    m_denseOf[handle] = INVALID_HANDLE;
+    m_freeHandles.push_back(handle);
+    --m_liveCount;
+    m_bOrderDirty = true;
+    if (index < m_firstDirty)
+        m_firstDirty = index;
+}
+
+bool CTransformStore::SetParent(Handle handle, Handle parent)
+{
+    if (!IsValid(handle))
+        return false;
+
+    uint32_t index = m_denseOf[handle];
+    uint32_t parentIndex = IsValid(parent) ? m_denseOf[parent] : INVALID_HANDLE;
+    if (m_parent[index] == parentIndex)
+        return true;
+
+    // 新父节点不能是自己或自己的后代
+    for (uint32_t i = parentIndex; i != INVALID_HANDLE && m_handleOf[i] != INVALID_HANDLE; i = m_parent[i])
+    {
+        if (i == index)
+            return false;
+    }
+
+    m_parent[index] = parentIndex;
+    MarkDirty(index);
+    m_bGroupsDirty = true;
+    if (parentIndex != INVALID_HANDLE && parentIndex > index)
+        m_bOrderDirty = true;
+    return true;
+}
+
+CTransformStore::Handle CTransformStore::GetParent(Handle handle) const
+{
+    if (!IsValid(handle))
+        return INVALID_HANDLE;
+    uint32_t parentIndex = m_parent[m_denseOf[handle]];
+    return parentIndex == INVALID_HANDLE ? INVALID_HANDLE : m_handleOf[parentIndex];
+}
+
+// ======================================================================
+// 变换
+// ======================================================================
+void CTransformStore::SetLocal(Handle handle, const Vector3 &position, const Quaternion &rotation, const Vector3 &scale)
+{
+    uint32_t index = m_denseOf[handle];
+    m_position[index] = position;
+    m_rotation[index] = rotation;
+    m_scale[index] = scale;
+    MarkDirty(index);
+}
+
+void CTransformStore::SetLocalPosition(Handle handle, const Vector3 &position)
+{
+    uint32_t index = m_denseOf[handle];
+    m_position[index] = position;
+    MarkDirty(index);
+}
+
+void CTransformStore::SetLocalRotation(Handle handle, const Quaternion &rotation)
+{
+    uint32_t index = m_denseOf[handle];
+    m_rotation[index] = rotation;
+    MarkDirty(index);
+}
+
+void CTransformStore::SetLocalScale(Handle handle, const Vector3 &scale)
+{
+    uint32_t index = m_denseOf[handle];
+    m_scale[index] = scale;
+    MarkDirty(index);
+}
+
+void CTransformStore::MarkDirty(uint32_t index)
+{
+    m_dirty[index] = 1;
+    if (index < m_firstDirty)
+        m_firstDirty = index;
+}
+
+void CTransformStore::ComputeWorld(uint32_t index, uint64_t stamp)
+{
+    Matrix4 local = Matrix4::TRS(m_position[index], m_rotation[index], m_scale[index]);
+    uint32_t parent = m_parent[index];
+    if (parent != INVALID_HANDLE && m_handleOf[parent] != INVALID_HANDLE)
+        m_world[index] = m_world[parent] * local;
+    else
+        m_world[index] = local;
+    m_stamp[index] = stamp;
+    m_dirty[index] = 0;
+}
+
+const Matrix4 &CTransformStore::GetWorldMatrix(Handle handle)
+{
+    uint32_t index = m_denseOf[handle];
+    if (m_firstDirty == INVALID_HANDLE)
+        return m_world[index]; // 上次扫描后没有任何修改
+
+    // 收集父链，从最上层的祖先开始向下补算过期的节点
+    m_scratch.clear();
+    for (uint32_t i = index; i != INVALID_HANDLE && m_handleOf[i] != INVALID_HANDLE; i = m_parent[i])
+        m_scratch.push_back(i);
+
+    for (size_t k = m_scratch.size(); k-- > 0;)
+    {
+        uint32_t i = m_scratch[k];
+        uint32_t parent = m_parent[i];
+        if (m_dirty[i] || (parent != INVALID_HANDLE && m_stamp[parent] > m_stamp[i]))
+            ComputeWorld(i, m_nextStamp++);
+    }
+    return m_world[index];
+}
+
+size_t CTransformStore::UpdateRange(uint32_t begin, uint32_t end, uint64_t stamp)
+{
+    // 父节点总在前面（或在已完成的上一层）：到达子节点时父节点的序号已是最新
+    const uint32_t *parents = m_parent.data();
+    const uint64_t *stamps = m_stamp.data();
+    size_t updated = 0;
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        uint32_t parent = parents[i];
+        if (m_dirty[i] || (parent != INVALID_HANDLE && stamps[parent] > stamps[i]))
+        {
+            ComputeWorld(i, stamp);
+            ++updated;
+        }
+    }
+    return updated;
+}
+
+void CTransformStore::UpdateWorldMatrices(CJobSystem *pJobs)
+{
+    bool parallel = pJobs != nullptr && m_handleOf.size() >= PARALLEL_THRESHOLD;
+    if (m_bOrderDirty || (parallel && m_bGroupsDirty))
+        RebuildOrder();
+    parallel = parallel && GetParallelGroupCount() > 1;
+
+    m_lastUpdated = 0;
+    if (m_firstDirty == INVALID_HANDLE)
+        return;
+
+    // 本次扫描重算的节点共用一个序号：它比之前所有序号都新，
+    // 同一次扫描中父子序号相等也不会误判为过期
+    const uint64_t stamp = m_nextStamp++;
+    const uint32_t count = (uint32_t)m_handleOf.size();
+    if (!parallel)
+    {
+        m_lastUpdated = UpdateRange(m_firstDirty, count, stamp);
+        m_firstDirty = INVALID_HANDLE;
+        return;
+    }
+
+    // 拆分层以上的几层串行，各组子树并行；每组先算拆分层节点再算其子树
+    const uint32_t first = m_firstDirty;
+    const size_t groups = GetParallelGroupCount();
+    std::atomic<size_t> updated(UpdateRange(first, first > m_groupSplit[0] ? first : m_groupSplit[0], stamp));
+    pJobs->ParallelFor(groups, 1, [&](size_t begin, size_t end) {
+        size_t local = 0;
+        for (size_t g = begin; g < end; ++g)
+        {
+            local += UpdateRange(first > m_groupSplit[g] ? first : m_groupSplit[g], m_groupSplit[g + 1], stamp);
+            local += UpdateRange(first > m_groupDesc[g] ? first : m_groupDesc[g], m_groupDesc[g + 1], stamp);
+        }
+        updated.fetch_add(local, std::memory_order_relaxed);
+    });
+    m_lastUpdated = updated.load();
+    m_firstDirty = INVALID_HANDLE;
+}
+
+// ======================================================================
+// 重排：剔除已销毁节点，拆分层以上按层序、拆分层各节点的子树按先序连续排列
+// ======================================================================
+void CTransformStore::RebuildOrder()
+{
+    const uint32_t count = (uint32_t)m_handleOf.size();
+
+    // 1. 按父节点统计子节点（CSR），父节点已销毁的视为根
+    std::vector<uint32_t> childStart(count + 1, 0);
+    std::vector<uint32_t> roots;
+    roots.reserve(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (m_handleOf[i] == INVALID_HANDLE)
+            continue;
+        uint32_t parent = m_parent[i];
+        if (parent == INVALID_HANDLE || m_handleOf[parent] == INVALID_HANDLE)
+            roots.push_back(i);
+        else
+            ++childStart[parent + 1];
+    }
+    for (uint32_t i = 0; i < count; ++i)
+        childStart[i + 1] += childStart[i];
+
+    std::vector<uint32_t> children(childStart[count]);
+    std::vector<uint32_t> cursor(childStart.begin(), childStart.end() - 1);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        uint32_t parent = m_parent[i];
+        if (m_handleOf[i] != INVALID_HANDLE && parent != INVALID_HANDLE && m_handleOf[parent] != INVALID_HANDLE)
+            children[cursor[parent]++] = i;
+    }
+
+    // 2. 从根节点开始逐层展开，直到某层节点数达到 SPLIT_MIN_WIDTH（拆分层）
+    std::vector<uint32_t> order(roots);
+    order.reserve(m_liveCount);
+    size_t levelBegin = 0;
+    while (levelBegin < order.size() && order.size() - levelBegin < SPLIT_MIN_WIDTH)
+    {
+        size_t levelEnd = order.size();
+        for (size_t k = levelBegin; k < levelEnd; ++k)
+        {
+            uint32_t i = order[k];
+            order.insert(order.end(), children.begin() + childStart[i], children.begin() + childStart[i + 1]);
+        }
+        levelBegin = levelEnd;
+    }
+
+    // 3. 拆分层每个节点的子树按先序追加，子树之间互不依赖；按节点数累计成组
+    const size_t splitEnd = order.size();
+    m_groupSplit.assign(1, (uint32_t)levelBegin);
+    m_groupDesc.assign(1, (uint32_t)splitEnd);
+    std::vector<uint32_t> stack;
+    size_t groupSize = 0;
+    for (size_t k = levelBegin; k < splitEnd; ++k)
+    {
+        size_t subtreeBegin = order.size();
+        for (uint32_t c = childStart[order[k] + 1]; c-- > childStart[order[k]];)
+            stack.push_back(children[c]);
+        while (!stack.empty())
+        {
+            uint32_t i = stack.back();
+            stack.pop_back();
+            order.push_back(i);
+            for (uint32_t c = childStart[i + 1]; c-- > childStart[i];)
+                stack.push_back(children[c]);
+        }
+
+        groupSize += 1 + order.size() - subtreeBegin;
+        if (groupSize >= PARALLEL_GRAIN || k + 1 == splitEnd)
+        {
+            m_groupSplit.push_back((uint32_t)(k + 1));
+            m_groupDesc.push_back((uint32_t)order.size());
+            groupSize = 0;
+        }
+    }
+
+    // 4. 按新顺序搬移所有数组
+    std::vector<uint32_t> remap(count, INVALID_HANDLE);
+    for (uint32_t k = 0; k < (uint32_t)order.size(); ++k)
+        remap[order[k]] = k;
+
+    const size_t live = order.size();
+    std::vector<Vector3> position, scale;
+    std::vector<Quaternion> rotation;
+    std::vector<Matrix4> world;
+    std::vector<uint32_t> parent;
+    std::vector<uint64_t> stamp;
+    std::vector<uint8_t> dirty;
+    std::vector<Handle> handleOf;
+    AllocateLike(position, m_position, live);
+    AllocateLike(scale, m_scale, live);
+    AllocateLike(rotation, m_rotation, live);
+    AllocateLike(world, m_world, live);
+    AllocateLike(parent, m_parent, live);
+    AllocateLike(stamp, m_stamp, live);
+    AllocateLike(dirty, m_dirty, live);
+    AllocateLike(handleOf, m_handleOf, live);
+    for (size_t k = 0; k < live; ++k)
+    {
+        uint32_t i = order[k];
+        uint32_t oldParent = m_parent[i];
+        bool orphan = oldParent != INVALID_HANDLE && m_handleOf[oldParent] == INVALID_HANDLE;
+
+        position[k] = m_position[i];
+        rotation[k] = m_rotation[i];
+        scale[k] = m_scale[i];
+        world[k] = m_world[i];
+        parent[k] = oldParent == INVALID_HANDLE ? INVALID_HANDLE : remap[oldParent];
+        stamp[k] = m_stamp[i];
+        dirty[k] = (uint8_t)(m_dirty[i] | (orphan ? 1 : 0));
+        handleOf[k] = m_handleOf[i];
+        m_denseOf[m_handleOf[i]] = (uint32_t)k;
+    }
+
+    m_position.swap(position);
+    m_rotation.swap(rotation);
+    m_scale.swap(scale);
+    m_world.swap(world);
+    m_parent.swap(parent);
+    m_stamp.swap(stamp);
+    m_dirty.swap(dirty);
+    m_handleOf.swap(handleOf);
+
+    // 顺序已变，保守地从头扫描（未过期的节点只做比较）
+    m_firstDirty = 0;
+    m_bOrderDirty = false;
+    m_bGroupsDirty = false;
+}
@@ -5,8 +5,28 @@
 #include "Core/GameEngine.h"
 #include "Core/Renderer.h"
 #include "Core/Entity.h"
+#include "Core/SceneSnapshot.h"
+#include "Math/Random.h"
 // ======================================================================
 
+namespace
+{
+    // 快照中的私有数据
+    struct CameraSnapshotData
+    {
+        uint32_t mode; // CameraMode
+        float fov;
+        float aspect;
+        float nearPlane;
+        float farPlane;
+        float yaw;
+        float pitch;
+        float maxPitch;
+        float sensitivity;
+        uint32_t reserved;
+    };
+}
+
 CCameraEntity::CCameraEntity()
     : CEntity(),                    //
       m_Mode(CameraMode::FreeLook), //
@@ -24,6 +44,10 @@ CCameraEntity::CCameraEntity()
 {
     SetName(L"MainCamera");
 
+    // 所有实体移动完成后再跟随，每帧更新
+    SetTickGroup(TickGroup::LateCamera);
+    SetTickInterval(1);
+
     // 修正：正确初始化旋转（看向-Z方向）
     // 默认欧拉角：偏航角-90度（看向-Z轴），俯仰角0度（水平）
     m_rotation = Quaternion::FromEuler(m_CurrentPitch, m_CurrentYaw, 0.0f);
@@ -37,7 +61,7 @@ Matrix4 CCameraEntity::GetViewMatrix() const
 {
     // 核心逻辑：View矩阵 = 相机世界变换矩阵的逆
     Matrix4 view = GetWorldMatrix();
-    view.Inverse();
+    view.InverseAffine();
 
     // 叠加震动偏移（仅影响视图，不修改实体实际位置）
     if (m_ShakeEnabled)
@@ -165,14 +189,10 @@ void CCameraEntity::Update(float deltaTime)
         else
         {
             // 产生随机震动
-            m_ShakeOffset.x = ((rand() % 100) / 50.0f - 1.0f) * m_ShakeIntensity;
-            m_ShakeOffset.y = ((rand() % 100) / 50.0f - 1.0f) * m_ShakeIntensity;
-            m_ShakeOffset.z = ((rand() % 100) / 50.0f - 1.0f) * m_ShakeIntensity;
+            Vector3 extent(m_ShakeIntensity, m_ShakeIntensity, m_ShakeIntensity);
+            m_ShakeOffset = Math::RandomGenerator::ThreadLocal().NextVector3(-extent, extent);
         }
     }
-
-    // 3. 调用基类 Update，递归计算整个场景树的世界矩阵
-    CEntity::Update(deltaTime);
 }
 
 void CCameraEntity::StartShake(float intensity, float duration)
@@ -264,4 +284,52 @@ void CCameraEntity::ProcessMouseWheel(INT delta)
         // 例如：m_Distance -= zoomAmount;
         break;
     }
-}
\ No newline at end of file
+}
+// ======================================================================
+// 场景快照
+// ======================================================================
+void CCameraEntity::WriteSnapshot(CSceneSnapshotWriter &writer, uint32_t index) const
+{
+    CEntity::WriteSnapshot(writer, index);
+
+    CameraSnapshotData data = {};
+    data.mode = (uint32_t)m_Mode;
+    data.fov = m_Fov;
+    data.aspect = m_Aspect;
+    data.nearPlane = m_Near;
+    data.farPlane = m_Far;
+    data.yaw = m_CurrentYaw;
+    data.pitch = m_CurrentPitch;
+    data.maxPitch = m_MaxPitchAngle;
+    data.sensitivity = m_MouseSensitivity;
+    writer.SetData(index, &data, sizeof(data));
+}
+
+void CCameraEntity::ReadSnapshot(const SnapshotEntity &record)
+{
+    CEntity::ReadSnapshot(record);
+    // 相机自己维护的朝向与实体旋转保持一致
+    m_rotation = CEntity::m_rotation;
+
+    if (record.dataSize >= sizeof(CameraSnapshotData))
+    {
+        const CameraSnapshotData &data = *reinterpret_cast<const CameraSnapshotData *>(record.data.Get());
+        if (data.mode <= (uint32_t)CameraMode::Orbital)
+            m_Mode = (CameraMode)data.mode;
+        m_Fov = data.fov;
+        m_Aspect = data.aspect;
+        m_Near = data.nearPlane;
+        m_Far = data.farPlane;
+        m_CurrentYaw = data.yaw;
+        m_CurrentPitch = data.pitch;
+        m_MaxPitchAngle = data.maxPitch;
+        m_MouseSensitivity = data.sensitivity;
+    }
+}
+
+std::shared_ptr<CCameraEntity> CCameraEntity::CreateFromSnapshot(const SnapshotEntity &record)
+{
+    auto pEntity = Create();
+    pEntity->ReadSnapshot(record);
+    return pEntity;
+}
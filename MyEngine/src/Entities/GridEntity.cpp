@@ -2,10 +2,25 @@
 #include "stdafx.h"
 #include "Entities/GridEntity.h"
 #include "Core/GameEngine.h"
+#include "Core/SceneSnapshot.h"
 #include "Graphics/Camera/Camera.h"
 // ======================================================================
 
-unsigned int CGridEntity::s_nextID = 2000; // 网格实体起始ID段
+namespace
+{
+    // 快照中的私有数据
+    struct GridSnapshotData
+    {
+        float size;
+        float step;
+        float mainColor[3];
+        float subColor[3];
+        uint32_t flags; // 1: 坐标轴，2: 距离淡出
+        float minorFadeDist;
+        float majorFadeDist;
+        uint32_t reserved;
+    };
+}
 
 CGridEntity::CGridEntity(FLOAT size, FLOAT step)
     : m_fSize(size),                          //
@@ -147,12 +162,6 @@ BOOL CGridEntity::ShouldRebuildLOD() const
     return false;
 }
 
-void CGridEntity::Update(float deltaTime)
-{
-    // 网格通常是静态的，直接调用基类更新矩阵计算
-    CEntity::Update(deltaTime);
-}
-
 void CGridEntity::Render()
 {
     if (!m_bVisible)
@@ -348,4 +357,53 @@ void CGridEntity::DrawFadingLine(float coord, BOOL isParallelToZ, const Vector3
     {
         DrawSegmentWithAlpha(t, Math::Min(t + renderStep, m_fSize));
     }
-}
\ No newline at end of file
+}
+// ======================================================================
+// 场景快照
+// ======================================================================
+void CGridEntity::WriteSnapshot(CSceneSnapshotWriter &writer, uint32_t index) const
+{
+    CEntity::WriteSnapshot(writer, index);
+
+    GridSnapshotData data = {};
+    data.size = m_fSize;
+    data.step = m_fStep;
+    data.mainColor[0] = m_MainColor.x;
+    data.mainColor[1] = m_MainColor.y;
+    data.mainColor[2] = m_MainColor.z;
+    data.subColor[0] = m_SubColor.x;
+    data.subColor[1] = m_SubColor.y;
+    data.subColor[2] = m_SubColor.z;
+    data.flags = (m_bShowAxes ? 1u : 0u) | (m_bEnableFade ? 2u : 0u);
+    data.minorFadeDist = m_fMinorFadeDist;
+    data.majorFadeDist = m_fMajorFadeDist;
+    writer.SetData(index, &data, sizeof(data));
+}
+
+void CGridEntity::ReadSnapshot(const SnapshotEntity &record)
+{
+    CEntity::ReadSnapshot(record);
+
+    if (record.dataSize < sizeof(GridSnapshotData))
+        return;
+    const GridSnapshotData &data = *reinterpret_cast<const GridSnapshotData *>(record.data.Get());
+    if (data.step <= 0.0f)
+        return;
+
+    m_fSize = data.size;
+    m_fStep = data.step;
+    m_MainColor = Vector3(data.mainColor[0], data.mainColor[1], data.mainColor[2]);
+    m_SubColor = Vector3(data.subColor[0], data.subColor[1], data.subColor[2]);
+    m_bShowAxes = (data.flags & 1u) ? TRUE : FALSE;
+    m_bEnableFade = (data.flags & 2u) ? TRUE : FALSE;
+    m_fMinorFadeDist = data.minorFadeDist;
+    m_fMajorFadeDist = data.majorFadeDist;
+    BuildGeometry();
+}
+
+std::shared_ptr<CGridEntity> CGridEntity::CreateFromSnapshot(const SnapshotEntity &record)
+{
+    auto pEntity = Create();
+    pEntity->ReadSnapshot(record);
+    return pEntity;
+}
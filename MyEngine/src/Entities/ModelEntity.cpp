@@ -2,73 +2,157 @@
 // ======================================================================
 #include "stdafx.h"
 #include "Entities/ModelEntity.h"
+#include "Core/GameEngine.h"
+#include "Core/LODController.h"
+#include "Core/RenderQueue.h"
+#include "Core/SceneSnapshot.h"
 #include "Resources/Model.h"
+#include "Resources/ResourceManager.h"
 // ======================================================================
 
+namespace
+{
+    // 快照中的私有数据
+    struct ModelSnapshotData
+    {
+        uint32_t flags; // 1: 包围盒，2: 法线
+        float normalScale;
+        uint32_t normalStep;
+        uint32_t reserved;
+    };
+}
+
 CModelEntity::CModelEntity(std::shared_ptr<CModel> pModel)
     : m_pModel(pModel)
 {
     // 初始化默认属性
-    m_name = L"Model Entity";
+    SetName(L"Model Entity");
     m_bDrawBBox = FALSE;
 }
 
-void CModelEntity::Update(FLOAT deltaTime)
+BOOL CModelEntity::GetLocalBounds(AABB &bounds) const
+{
+    if (!m_pModel)
+        return FALSE;
+    bounds = m_pModel->GetLocalBounds();
+    return bounds.IsValid();
+}
+
+BOOL CModelEntity::AddStaticGeometry(CStaticBatch &batch) const
 {
-    // 调用基类 Update 以确保子节点的递归更新
-    CEntity::Update(deltaTime);
+    return m_pModel && m_pModel->AddToStaticBatch(batch, GetWorldMatrix(), m_uID);
+}
+
+BOOL CModelEntity::AddOccluderGeometry(COcclusionBuffer &buffer) const
+{
+    return m_pModel && m_pModel->AddToOcclusion(buffer, GetWorldMatrix());
+}
 
+void CModelEntity::Update(FLOAT deltaTime)
+{
     // TODO: 此处可添加模型特有逻辑，例如骨骼动画更新等
+    // 添加后需在构造时 SetTickInterval(1)，默认按需的实体不会被逐帧调用
 }
 
 void CModelEntity::Render()
 {
     if (!m_bVisible || !m_pModel)
         return;
-        
-    // 1. 保存当前 OpenGL 矩阵状态
-    glPushAttrib(GL_ALL_ATTRIB_BITS);
-    glPushMatrix();
 
-    // 2. 禁用光照
-    glDisable(GL_LIGHTING);
+    // 不在视锥内时只处理子节点
+    if (!IsInView())
+    {
+        RenderChildren();
+        return;
+    }
+
+    // 1. 场景正在收集渲染队列时只加入队列，由场景排序后统一提交；已在静态合批中的由场景一并绘制
+    CRenderQueue *pQueue = CRenderQueue::GetActive();
+    const BOOL drawModel = !m_bStaticBatched;
 
-    // 3. 设置纯白色，确保模型纹理正常显示
-    glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+    // 按包围球的屏幕投影选择细节级别；静态合批里是原始网格，不参与选择
+    CLODController *pLOD = CLODController::GetActive();
+    if (pLOD && drawModel)
+        m_uLODLevel = m_pModel->SelectLOD(*pLOD, GetWorldMatrix(), m_uLODLevel);
+    else
+        m_uLODLevel = 0;
 
-    // 2. 应用变换逻辑
-    ApplyTransform();
+    if (pQueue && drawModel)
+        m_pModel->Enqueue(*pQueue, GetWorldMatrix(), m_uLODLevel);
 
-    GLint currentTexture;
-    glGetIntegerv(GL_TEXTURE_BINDING_2D, &currentTexture);
-    // LogDebug(L"模型渲染前绑定的纹理: %d.\n", currentTexture);
+    if ((!pQueue && drawModel) || m_bDrawBBox || m_bDrawNormals)
+    {
+        glPushMatrix();
+        ApplyTransform();
 
-    // 3. 真正绘制模型数据
-    m_pModel->Draw();
+        // 2. 直接绘制（CModel::Draw 关闭光照、使用白色，并自行保存恢复状态）
+        if (!pQueue && drawModel)
+            m_pModel->Draw(m_uLODLevel);
 
-    // 检查渲染后的纹理状态
-    glGetIntegerv(GL_TEXTURE_BINDING_2D, &currentTexture);
-    // LogDebug(L"渲染后绑定的纹理: %d.\n", currentTexture);
+        // 3. 包围盒与法线：调试绘制不在热路径上，整体保存恢复状态
+        if (m_bDrawBBox || m_bDrawNormals)
+        {
+            glPushAttrib(GL_ALL_ATTRIB_BITS);
+            if (m_bDrawBBox)
+                m_pModel->DrawBoundingBox();
+            if (m_bDrawNormals)
+                m_pModel->DrawNormals(m_fNormalScale, m_uNormalStep);
+            glPopAttrib();
+        }
 
-    // 4. 绘制包围盒
-    if (m_bDrawBBox) {
-        m_pModel->DrawBoundingBox(); 
+        glPopMatrix();
     }
 
-    // 5. 绘制法线
-    if (m_bDrawNormals) {
-        m_pModel->DrawNormals(m_fNormalScale, m_uNormalStep);
+    // 4. 递归渲染子节点
+    RenderChildren();
+}
+// ======================================================================
+// 场景快照
+// ======================================================================
+void CModelEntity::WriteSnapshot(CSceneSnapshotWriter &writer, uint32_t index) const
+{
+    CEntity::WriteSnapshot(writer, index);
+
+    // 加载失败时使用的默认模型没有路径，读回时同样取默认模型
+    if (m_pModel)
+    {
+        std::wstring path = m_pModel->GetFilePath();
+        std::wstring modelDir = ResourceConfig().GetModelPath();
+        if (path.compare(0, modelDir.size(), modelDir) == 0)
+            path = path.substr(modelDir.size());
+        writer.SetResource(index, path);
     }
 
-    // 4. 恢复矩阵状态
-    glPopMatrix();
-    glPopAttrib();
+    ModelSnapshotData data = {};
+    data.flags = (m_bDrawBBox ? 1u : 0u) | (m_bDrawNormals ? 2u : 0u);
+    data.normalScale = m_fNormalScale;
+    data.normalStep = m_uNormalStep;
+    writer.SetData(index, &data, sizeof(data));
+}
 
+void CModelEntity::ReadSnapshot(const SnapshotEntity &record)
+{
+    CEntity::ReadSnapshot(record);
 
-    // 5. 递归渲染子节点
-    for (auto &pChild : m_children)
+    if (record.dataSize >= sizeof(ModelSnapshotData))
     {
-        if (pChild)
-            pChild->Render();
+        const ModelSnapshotData &data = *reinterpret_cast<const ModelSnapshotData *>(record.data.Get());
+        m_bDrawBBox = (data.flags & 1u) ? TRUE : FALSE;
+        m_bDrawNormals = (data.flags & 2u) ? TRUE : FALSE;
+        m_fNormalScale = data.normalScale;
+        m_uNormalStep = data.normalStep;
     }
-}
\ No newline at end of file
+}
+
+std::shared_ptr<CModelEntity> CModelEntity::CreateFromSnapshot(const SnapshotEntity &record)
+{
+    // 模型经资源管理器缓存，场景重载时旧场景仍持有的模型直接复用
+    std::shared_ptr<CModel> pModel;
+    auto pResMgr = CGameEngine::GetInstance().GetResourceManager();
+    if (pResMgr)
+        pModel = record.resource.IsNull() ? pResMgr->GetDefaultModel() : pResMgr->GetModel(record.resource.Get());
+
+    auto pEntity = Create(pModel);
+    pEntity->ReadSnapshot(record);
+    return pEntity;
+}
@@ -3,9 +3,22 @@
 #include "stdafx.h"
 #include "Entities/SkyboxEntity.h"
 #include "Core/GameEngine.h"
+#include "Core/SceneSnapshot.h"
+#include "Graphics/Camera/Camera.h"
+#include "Resources/ResourceManager.h"
 // ======================================================================
 
-unsigned int CSkyboxEntity::s_nextID = 0;
+namespace
+{
+    // 快照中的私有数据
+    struct SkyboxSnapshotData
+    {
+        float size;
+        float rotationSpeed;
+        float currentRotation;
+        uint32_t enableRotation;
+    };
+}
 
 CSkyboxEntity::CSkyboxEntity(GLuint textureID)
     : m_uCubemapID(textureID),
@@ -19,9 +32,6 @@ CSkyboxEntity::CSkyboxEntity(GLuint textureID)
 
 void CSkyboxEntity::Update(float deltaTime)
 {
-    // 调用基类更新
-    CEntity::Update(deltaTime);
-
     // 更新天空盒旋转
     if (m_bEnableRotation)
     {
@@ -161,4 +171,50 @@ void CSkyboxEntity::DrawCube()
         glVertex3f(-half, half, -half);
     }
     glEnd();
-}
\ No newline at end of file
+}
+// ======================================================================
+// 场景快照
+// ======================================================================
+void CSkyboxEntity::WriteSnapshot(CSceneSnapshotWriter &writer, uint32_t index) const
+{
+    CEntity::WriteSnapshot(writer, index);
+
+    if (!m_skyboxName.empty())
+        writer.SetResource(index, m_skyboxName);
+
+    SkyboxSnapshotData data = {};
+    data.size = m_fSize;
+    data.rotationSpeed = m_fRotationSpeed;
+    data.currentRotation = m_fCurrentRotation;
+    data.enableRotation = m_bEnableRotation ? 1u : 0u;
+    writer.SetData(index, &data, sizeof(data));
+}
+
+void CSkyboxEntity::ReadSnapshot(const SnapshotEntity &record)
+{
+    CEntity::ReadSnapshot(record);
+
+    if (!record.resource.IsNull())
+        m_skyboxName = record.resource.Get();
+
+    // 调度间隔已由基类读回，这里只恢复旋转参数
+    if (record.dataSize >= sizeof(SkyboxSnapshotData))
+    {
+        const SkyboxSnapshotData &data = *reinterpret_cast<const SkyboxSnapshotData *>(record.data.Get());
+        m_fSize = data.size;
+        m_fRotationSpeed = data.rotationSpeed;
+        m_fCurrentRotation = data.currentRotation;
+        m_bEnableRotation = data.enableRotation ? TRUE : FALSE;
+    }
+}
+
+std::shared_ptr<CSkyboxEntity> CSkyboxEntity::CreateFromSnapshot(const SnapshotEntity &record)
+{
+    auto pEntity = Create();
+    pEntity->ReadSnapshot(record);
+
+    auto pResMgr = CGameEngine::GetInstance().GetResourceManager();
+    if (pResMgr && !pEntity->m_skyboxName.empty())
+        pEntity->SetCubemapTexture(pResMgr->LoadSkybox(pEntity->m_skyboxName));
+    return pEntity;
+}
@@ -4,13 +4,36 @@
 #include "EngineConfig.h"
 #include "Entities/TerrainEntity.h"
 #include "Core/GameEngine.h"
+#include "Core/GLStateCache.h"
+#include "Core/JobSystem.h"
+#include "Core/LODController.h"
+#include "Core/OcclusionBuffer.h"
+#include "Core/SceneSnapshot.h"
 #include "Graphics/Camera/Camera.h"
+#include "Math/FastMath.h"
 #include "Resources/ResourceManager.h"
 #include "Utils/StringUtils.h"
 #include "Utils/stb_image.h"
 // ======================================================================
 
-unsigned int CTerrainEntity::s_nextID = 3000;
+namespace
+{
+    // 快照中的私有数据，其后紧跟 width * height 个高度值
+    struct TerrainSnapshotData
+    {
+        int32_t width;
+        int32_t height;
+        float cellSize;
+        float maxHeight;
+        float textureRepeat;
+        float color[4];
+        int32_t lodLevel;
+        uint32_t flags; // 1: 线框，2: 法线
+        float normalScale;
+        uint32_t normalStep;
+        uint32_t reserved;
+    };
+}
 
 CTerrainEntity::CTerrainEntity()
     : m_pTexture(nullptr),                    // 纹理
@@ -29,26 +52,30 @@ CTerrainEntity::CTerrainEntity()
       m_fNormalScale(10.0f)                   // 法线长度
 {
     SetName(L"Terrain");
+    SetOccluder(TRUE);
 }
 
 CTerrainEntity::~CTerrainEntity()
 {
     // 清理 VBO
-    if (m_bUseVBO)
-    {
-        if (m_vertexBuffer)
-            glDeleteBuffers(1, &m_vertexBuffer);
-        if (m_indexBuffer)
-            glDeleteBuffers(1, &m_indexBuffer);
-    }
+    DeleteVBO();
+}
+
+void CTerrainEntity::DeleteVBO()
+{
+    if (m_vertexBuffer)
+        glDeleteBuffers(1, &m_vertexBuffer);
+    if (m_indexBuffer)
+        glDeleteBuffers(1, &m_indexBuffer);
+    m_vertexBuffer = 0;
+    m_indexBuffer = 0;
 }
 
 std::shared_ptr<CTerrainEntity> CTerrainEntity::Create(const std::wstring &heightmapPath, const std::wstring &texturePath, float size, float maxHeight)
 {
     ResourceConfig conofig;
 
-    auto entity = std::shared_ptr<CTerrainEntity>(new CTerrainEntity());
-    entity->m_uID = ++s_nextID;
+    auto entity = Allocate<CTerrainEntity>();
 
     std::wstring fullHeightmapPath = conofig.GetTexturePath() + heightmapPath;
     std::wstring fullTexturePath = conofig.GetTexturePath() + texturePath;
@@ -71,8 +98,7 @@ std::shared_ptr<CTerrainEntity> CTerrainEntity::Create(const std::wstring &heigh
 
 std::shared_ptr<CTerrainEntity> CTerrainEntity::CreateProcedural(int width, int height, float size, float maxHeight)
 {
-    auto entity = std::shared_ptr<CTerrainEntity>(new CTerrainEntity());
-    entity->m_uID = ++s_nextID;
+    auto entity = Allocate<CTerrainEntity>();
     entity->GenerateProceduralTerrain(width, height, size, maxHeight);
     return entity;
 }
@@ -107,45 +133,16 @@ BOOL CTerrainEntity::LoadHeightmap(const std::wstring &path, float size, float m
     // 确保分母不为0
     m_cellSize = (m_width > 1) ? size / (m_width - 1) : size;
 
-    // 6. 生成顶点数据
-    m_vertices.clear();
-    m_vertices.resize(m_width * m_height);
+    // 从灰度值转换高度 (0-255 -> 0.0-maxHeight)
+    for (int i = 0; i < m_width * m_height; ++i)
+        m_heightData[i] = (float)data[i] / 255.0f * m_maxHeight;
 
-    for (int z = 0; z < m_height; ++z)
-    {
-        for (int x = 0; x < m_width; ++x)
-        {
-            int index = z * m_width + x;
-            Vertex &v = m_vertices[index];
-
-            // 计算世界空间位置（中心对齐）
-            v.pos.x = (x - m_width * 0.5f) * m_cellSize;
-            v.pos.z = (z - m_height * 0.5f) * m_cellSize;
-
-            // 从灰度值转换高度 (0-255 -> 0.0-maxHeight)
-            float h = (float)data[index] / 255.0f * m_maxHeight;
-            v.pos.y = h;
-            m_heightData[index] = h;
-
-            // UV坐标：设置纹理重复次数
-            float textureRepeat = 20.0f;
-            v.uv.x = ((float)x / (m_width - 1)) * textureRepeat;
-            v.uv.y = ((float)z / (m_height - 1)) * textureRepeat;
-
-            // 设置初始属性
-            v.color = m_terrainColor;
-            v.normal = Vector3(0, 1, 0); // 稍后在 CalculateNormals 计算
-        }
-    }
-    // 7. 释放原始图片内存
+    // 6. 释放原始图片内存
     stbi_image_free(data);
 
-    // 计算法线和生成索引
-    GenerateIndices();
-    CalculateNormals();
-
-    // 尝试创建VBO
-    CreateVBO();
+    // 7. 生成分块与 VBO（UV 设置纹理重复次数）
+    m_fTextureRepeat = 20.0f;
+    BuildMesh();
 
     LogInfo(L"地形加载成功: %ls. 分辨率: %dx%d, 实际尺寸: %.1fx%.1f\n",
             path.c_str(), m_width, m_height, size, size);
@@ -160,110 +157,127 @@ void CTerrainEntity::GenerateProceduralTerrain(int width, int height, float size
     m_cellSize = size / (width - 1);
 
     // 生成程序化地形（使用柏林噪声或正弦波）
-    m_vertices.resize(m_width * m_height);
     m_heightData.resize(m_width * m_height);
 
+    // 每个噪声项只依赖 x 或 z：按列/行预先算好正弦表（快速近似档，误差 < 2e-7）
+    std::vector<float> args(Math::Max(m_width, m_height));
+    std::vector<float> sinX1(m_width), sinX2(m_width), cosZ1(m_height), cosZ3(m_height);
+    for (int x = 0; x < m_width; ++x)
+        args[x] = (x - m_width * 0.5f) * m_cellSize * 0.1f;
+    Math::Fast::Sin(args.data(), sinX1.data(), m_width);
+    for (int x = 0; x < m_width; ++x)
+        args[x] = (x - m_width * 0.5f) * m_cellSize * 0.05f;
+    Math::Fast::Sin(args.data(), sinX2.data(), m_width);
+    for (int z = 0; z < m_height; ++z)
+        args[z] = (z - m_height * 0.5f) * m_cellSize * 0.1f;
+    Math::Fast::Cos(args.data(), cosZ1.data(), m_height);
+    for (int z = 0; z < m_height; ++z)
+        args[z] = (z - m_height * 0.5f) * m_cellSize * 0.03f;
+    Math::Fast::Cos(args.data(), cosZ3.data(), m_height);
+
     for (int z = 0; z < m_height; ++z)
     {
         for (int x = 0; x < m_width; ++x)
         {
-            int index = z * m_width + x;
-            Vertex &v = m_vertices[index];
-
-            v.pos.x = (x - m_width * 0.5f) * m_cellSize;
-            v.pos.z = (z - m_height * 0.5f) * m_cellSize;
-
             // 使用多种噪声组合创建有趣的地形
-            float noise1 = sin(v.pos.x * 0.1f) * cos(v.pos.z * 0.1f) * 2.0f;
-            float noise2 = sin(v.pos.x * 0.05f) * 1.5f;
-            float noise3 = cos(v.pos.z * 0.03f) * 1.2f;
+            float noise1 = sinX1[x] * cosZ1[z] * 2.0f;
+            float noise2 = sinX2[x] * 1.5f;
+            float noise3 = cosZ3[z] * 1.2f;
 
-            v.pos.y = (noise1 + noise2 + noise3) * m_maxHeight * 0.1f;
-            m_heightData[index] = v.pos.y;
-
-            v.uv.x = (float)x / (m_width - 1);
-            v.uv.y = (float)z / (m_height - 1);
-            v.color = m_terrainColor;
-            v.normal = Vector3(0, 1, 0);
+            m_heightData[z * m_width + x] = (noise1 + noise2 + noise3) * m_maxHeight * 0.1f;
         }
     }
 
-    CalculateNormals();
-    GenerateIndices();
-    CreateVBO();
+    m_fTextureRepeat = 1.0f;
+    BuildMesh();
 }
 
-void CTerrainEntity::CalculateNormals()
+void CTerrainEntity::BuildMesh()
 {
-    // 先清零所有法线
-    for (auto &v : m_vertices)
-    {
-        v.normal = Vector3(0, 0, 0);
-    }
+    // 分块、误差与共享索引；四叉树引用 m_heightData，高度数据变化后须重新调用
+    m_quadtree.Build(m_heightData.data(), m_width, m_height, m_cellSize, CTerrainQuadtree::DEFAULT_CHUNK_CELLS,
+                     CGameEngine::GetInstance().GetJobSystem());
+    m_localBounds = m_quadtree.GetBounds();
 
-    // 计算每个面的法线并累加到顶点
-    for (size_t i = 0; i < m_indices.size(); i += 3)
-    {
-        unsigned int i1 = m_indices[i];
-        unsigned int i2 = m_indices[i + 1];
-        unsigned int i3 = m_indices[i + 2];
+    // 已在场景中时（如重新载入高度数据）同步空间索引
+    RefreshBounds();
+    GenerateOccluder();
 
-        Vector3 v1 = m_vertices[i1].pos;
-        Vector3 v2 = m_vertices[i2].pos;
-        Vector3 v3 = m_vertices[i3].pos;
+    // 尝试创建VBO
+    CreateVBO();
+}
 
-        Vector3 edge1 = v2 - v1;
-        Vector3 edge2 = v3 - v1;
-        Vector3 normal = Vector3::Cross(edge1, edge2).Normalized();
+void CTerrainEntity::GenerateOccluder()
+{
+    // 粗网格约 OCCLUDER_CELLS x OCCLUDER_CELLS 格，最后一列 / 行对齐到高度图边缘
+    const int OCCLUDER_CELLS = 64;
+    m_occluderVertices.clear();
+    m_occluderIndices.clear();
+    if (m_width < 2 || m_height < 2)
+        return;
 
-        m_vertices[i1].normal += normal;
-        m_vertices[i2].normal += normal;
-        m_vertices[i3].normal += normal;
-    }
+    const int step = std::max(1, (std::max(m_width, m_height) - 1 + OCCLUDER_CELLS - 1) / OCCLUDER_CELLS);
+    std::vector<int> columns, rows;
+    for (int x = 0; x < m_width - 1; x += step)
+        columns.push_back(x);
+    columns.push_back(m_width - 1);
+    for (int z = 0; z < m_height - 1; z += step)
+        rows.push_back(z);
+    rows.push_back(m_height - 1);
 
-    // 归一化所有法线
-    for (auto &v : m_vertices)
+    const int nx = (int)columns.size(), nz = (int)rows.size();
+    m_occluderVertices.reserve(nx * nz);
+    for (int j = 0; j < nz; ++j)
     {
-        v.normal.Normalize();
+        // 粗顶点管辖的范围是前后两个粗格子：格子内的真实地面都不低于四角中最低的一个
+        const int z0 = rows[std::max(0, j - 1)], z1 = rows[std::min(nz - 1, j + 1)];
+        for (int i = 0; i < nx; ++i)
+        {
+            const int x0 = columns[std::max(0, i - 1)], x1 = columns[std::min(nx - 1, i + 1)];
+            float lowest = m_heightData[z0 * m_width + x0];
+            for (int z = z0; z <= z1; ++z)
+            {
+                for (int x = x0; x <= x1; ++x)
+                    lowest = std::min(lowest, m_heightData[z * m_width + x]);
+            }
+            m_occluderVertices.push_back(Vector3((columns[i] - m_width * 0.5f) * m_cellSize, lowest,
+                                                 (rows[j] - m_height * 0.5f) * m_cellSize));
+        }
     }
 
-    // for (int i = 0; i < 5 && i < m_vertices.size(); ++i)
-    // {
-    //     LogDebug(L"Vertex %d Normal: %.2f, %.2f, %.2f.\n", i, m_vertices[i].normal.x, m_vertices[i].normal.y, m_vertices[i].normal.z);
-    // }
-}
-
-void CTerrainEntity::GenerateIndices()
-{
-    m_indices.clear();
-    m_indices.reserve((m_width - 1) * (m_height - 1) * 6);
-
-    // 根据LOD级别跳过一些顶点
-    int step = m_iLODLevel;
-
-    for (int z = 0; z < m_height - 1; z += step)
+    // 与地形块相同的绕序（从上方看逆时针）
+    m_occluderIndices.reserve((nx - 1) * (nz - 1) * 6);
+    for (int j = 0; j < nz - 1; ++j)
     {
-        for (int x = 0; x < m_width - 1; x += step)
+        for (int i = 0; i < nx - 1; ++i)
         {
-            int i0 = z * m_width + x;
-            int i1 = (z + step) * m_width + x;
-            int i2 = z * m_width + (x + step);
-            int i3 = (z + step) * m_width + (x + step);
-
-            // 两个三角形组成一个四边形
-            m_indices.push_back(i0);
-            m_indices.push_back(i1);
-            m_indices.push_back(i2);
-
-            m_indices.push_back(i2);
-            m_indices.push_back(i1);
-            m_indices.push_back(i3);
+            unsigned int i0 = j * nx + i, i1 = (j + 1) * nx + i, i2 = i0 + 1, i3 = i1 + 1;
+            m_occluderIndices.push_back(i0);
+            m_occluderIndices.push_back(i1);
+            m_occluderIndices.push_back(i2);
+            m_occluderIndices.push_back(i2);
+            m_occluderIndices.push_back(i1);
+            m_occluderIndices.push_back(i3);
         }
     }
 }
 
+BOOL CTerrainEntity::AddOccluderGeometry(COcclusionBuffer &buffer) const
+{
+    if (m_occluderIndices.empty())
+        return FALSE;
+    buffer.AddOccluder(&m_occluderVertices[0].x, m_occluderVertices.size(), sizeof(Vector3),
+                       m_occluderIndices.data(), m_occluderIndices.size(), GetWorldMatrix());
+    return TRUE;
+}
+
 void CTerrainEntity::CreateVBO()
 {
+    // 重新生成时先释放旧的缓冲区
+    DeleteVBO();
+    if (m_quadtree.GetChunkCount() == 0)
+        return;
+
     // 检查OpenGL扩展支持
     // 直接检查版本字符串
     const char *versionStr = (const char *)glGetString(GL_VERSION);
@@ -308,17 +322,36 @@ void CTerrainEntity::CreateVBO()
         return;
     }
 
-    // 创建顶点缓冲区
+    // 创建顶点缓冲区：各块的顶点依次存放，按批生成后上传，内存中不保留整份顶点
+    const size_t chunkCount = m_quadtree.GetChunkCount();
+    const size_t chunkVertices = m_quadtree.GetVerticesPerChunk();
+    const size_t chunkBytes = chunkVertices * sizeof(TerrainVertex);
     glGenBuffers(1, &m_vertexBuffer);
     glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
-    glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(Vertex),
-                 m_vertices.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, chunkCount * chunkBytes, nullptr, GL_STATIC_DRAW);
 
-    // 创建索引缓冲区
+    const size_t UPLOAD_CHUNKS = 64;
+    std::vector<TerrainVertex> staging(std::min(UPLOAD_CHUNKS, chunkCount) * chunkVertices);
+    CJobSystem *pJobs = CGameEngine::GetInstance().GetJobSystem();
+    for (size_t first = 0; first < chunkCount; first += UPLOAD_CHUNKS)
+    {
+        const size_t count = std::min(UPLOAD_CHUNKS, chunkCount - first);
+        auto buildRange = [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+                m_quadtree.BuildChunkVertices(first + i, &staging[i * chunkVertices]);
+        };
+        CJobSystem::ParallelFor(pJobs, count, 1, buildRange);
+        glBufferSubData(GL_ARRAY_BUFFER, first * chunkBytes, count * chunkBytes, staging.data());
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // 创建索引缓冲区：所有块共用 16 位局部索引
+    const std::vector<uint16_t> &indices = m_quadtree.GetIndices();
     glGenBuffers(1, &m_indexBuffer);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size() * sizeof(unsigned int),
-                 m_indices.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint16_t), indices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
     // 检查OpenGL错误
     GLenum error = glGetError();
@@ -328,54 +361,66 @@ void CTerrainEntity::CreateVBO()
         m_bUseVBO = FALSE;
 
         // 清理已创建的缓冲区
-        if (m_vertexBuffer)
-            glDeleteBuffers(1, &m_vertexBuffer);
-        if (m_indexBuffer)
-            glDeleteBuffers(1, &m_indexBuffer);
+        DeleteVBO();
         return;
     }
 
-    LogDebug(L"地形VBO创建成功, 顶点数: %d, 三角形数: %d.\n",
-             m_vertices.size(), m_indices.size() / 3);
+    LogDebug(L"地形VBO创建成功, 块数: %u, 顶点数: %u, 索引数: %u.\n",
+             (unsigned int)chunkCount, (unsigned int)(chunkCount * chunkVertices), (unsigned int)indices.size());
 }
 
-void CTerrainEntity::Update(float deltaTime)
+void CTerrainEntity::SetupTexGen() const
 {
-    CEntity::Update(deltaTime);
-    // 可以在这里添加地形的动态更新逻辑
+    // 顶点 (x, z) 的 UV 为 (x / (width - 1), z / (height - 1)) · 重复次数，换算成局部位置的线性函数
+    const float su = m_fTextureRepeat / (float)std::max(1, m_width - 1);
+    const float sv = m_fTextureRepeat / (float)std::max(1, m_height - 1);
+    const GLfloat planeS[] = {su / m_cellSize, 0.0f, 0.0f, m_width * 0.5f * su};
+    const GLfloat planeT[] = {0.0f, 0.0f, sv / m_cellSize, m_height * 0.5f * sv};
+
+    glTexGeni(GL_S, GL_TEXTURE_GEN_MODE, GL_OBJECT_LINEAR);
+    glTexGeni(GL_T, GL_TEXTURE_GEN_MODE, GL_OBJECT_LINEAR);
+    glTexGenfv(GL_S, GL_OBJECT_PLANE, planeS);
+    glTexGenfv(GL_T, GL_OBJECT_PLANE, planeT);
+    CGLStateCache &state = CGLStateCache::GetInstance();
+    state.Enable(GL_TEXTURE_GEN_S);
+    state.Enable(GL_TEXTURE_GEN_T);
 }
 
 void CTerrainEntity::Render()
 {
-    if (!m_bVisible || m_vertices.empty())
+    if (!m_bVisible || m_quadtree.GetChunkCount() == 0)
         return;
 
+    // 不在视锥内时只处理子节点
+    if (!IsInView())
+    {
+        CEntity::Render();
+        return;
+    }
+
     // GLint currentTexture;
     // glGetIntegerv(GL_TEXTURE_BINDING_2D, &currentTexture);
     // LogDebug(L"地形渲染前强制清理纹理: %d -> 0.\n", currentTexture);
 
-    glPushAttrib(GL_ENABLE_BIT | GL_POLYGON_BIT | GL_LIGHTING_BIT | GL_TEXTURE_BIT);
+    // 每帧一次；块内的状态设置经影子缓存，结束后恢复并让影子失效
+    glPushAttrib(GL_ENABLE_BIT | GL_POLYGON_BIT | GL_LIGHTING_BIT | GL_TEXTURE_BIT | GL_CURRENT_BIT);
+    glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+    CGLStateCache &state = CGLStateCache::GetInstance();
+    state.Invalidate();
 
     // 设置渲染状态
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_LIGHTING);
+    state.Enable(GL_DEPTH_TEST);
+    state.Enable(GL_LIGHTING);
     // ?: 测试光源
     // glEnable(GL_LIGHT0); // 启用默认光源
     // glDisable(GL_LIGHTING);  // 先关闭光照, 看地形是否显示
-    glEnable(GL_COLOR_MATERIAL); // CAUTION: 关键：让顶点颜色生效
     glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
+    state.Enable(GL_COLOR_MATERIAL); // CAUTION: 关键：让顶点颜色生效
 
     // 如果没有光源, 这行可以让你看清地形（但失去阴影感）
     // glLightModeli(GL_LIGHT_MODEL_TWO_SIDE, GL_TRUE);
 
-    if (m_bWireframe)
-    {
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-    }
-    else
-    {
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-    }
+    state.SetPolygonMode(m_bWireframe ? GL_LINE : GL_FILL);
 
     glPushMatrix();
     ApplyTransform();
@@ -405,24 +450,17 @@ void CTerrainEntity::Render()
     // GLfloat matSpecular[] = {0.1f, 0.2f, 0.05f, 1.0f};  // 弱绿色高光
     // GLfloat matShininess[] = {5.0f};                    // 非常粗糙
 
-    glMaterialfv(GL_FRONT, GL_AMBIENT, matAmbient);
-    glMaterialfv(GL_FRONT, GL_DIFFUSE, matDiffuse);
-    glMaterialfv(GL_FRONT, GL_SPECULAR, matSpecular);
-    glMaterialfv(GL_FRONT, GL_SHININESS, matShininess);
+    state.SetMaterial(matAmbient, matDiffuse, matSpecular, matShininess[0]);
 
-    // 绑定纹理
-    glActiveTexture(GL_TEXTURE0);
+    // 绑定纹理（GL_REPEAT 环绕是纹理对象的状态，CTexture 创建时已设置，不必每帧重设）
+    state.ActiveTexture(GL_TEXTURE0);
     if (m_pTexture && m_pTexture->GetID() != 0)
     {
         // LogDebug(L"绑定地形纹理: %d.\n", m_uTextureID);
 
-        glEnable(GL_TEXTURE_2D);
-        glBindTexture(GL_TEXTURE_2D, m_pTexture->GetID());
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-        glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+        state.Enable(GL_TEXTURE_2D);
+        state.BindTexture(m_pTexture->GetID());
+        state.SetTexEnvMode(GL_MODULATE);
 
         // 检查纹理绑定状态
         // GLint boundTexture;
@@ -431,61 +469,75 @@ void CTerrainEntity::Render()
     }
     else
     {
-        glDisable(GL_TEXTURE_2D);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        state.Disable(GL_TEXTURE_2D);
+        state.BindTexture(0);
         LogWarning(L"地形纹理ID为0, 使用颜色渲染\n");
     }
 
-    glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+    // 颜色材质取地形颜色（与纹理相乘），UV 由位置生成
+    state.SetColor(m_terrainColor.x, m_terrainColor.y, m_terrainColor.z, m_terrainColor.w);
+    SetupTexGen();
+
+    // 选择可见块与各块级别：视锥在世界空间，没有相机时全部可见
+    Frustum frustum;
+    if (CCamera *pCamera = CGameEngine::GetInstance().GetMainCamera())
+        pCamera->GetFrustum(frustum);
+    else
+    {
+        for (int i = 0; i < Frustum::PlaneCount; ++i)
+            frustum.planes[i] = Vector4(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+    CLODController *pLOD = CLODController::GetActive();
+    m_quadtree.Select(frustum, GetWorldMatrix(), pLOD, m_chunkDraws);
+    if (pLOD)
+    {
+        const TerrainStats &stats = m_quadtree.GetStats();
+        pLOD->Record(stats.reduced > 0 ? 1 : 0, stats.fullTriangles, stats.drawnTriangles);
+    }
+
+    const size_t chunkVertices = m_quadtree.GetVerticesPerChunk();
+    state.SetClientState(GL_VERTEX_ARRAY, true);
+    state.SetClientState(GL_NORMAL_ARRAY, true);
 
     if (m_bUseVBO && m_vertexBuffer != 0 && m_indexBuffer != 0)
     {
-        // 使用VBO渲染（最高质量）
+        // 使用VBO渲染：每块一次绘制，顶点指针指向该块的顶点，索引按级别与边缘组合取共享的一段
         glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
 
-        // 设置顶点指针
-        glEnableClientState(GL_VERTEX_ARRAY);
-        glEnableClientState(GL_NORMAL_ARRAY);
-        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-        glEnableClientState(GL_COLOR_ARRAY);
-
-        glVertexPointer(3, GL_FLOAT, sizeof(Vertex), (void *)offsetof(Vertex, pos));
-        glNormalPointer(GL_FLOAT, sizeof(Vertex), (void *)offsetof(Vertex, normal));
-        glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), (void *)offsetof(Vertex, uv));
-        glColorPointer(4, GL_FLOAT, sizeof(Vertex), (void *)offsetof(Vertex, color));
-
-        glDrawElements(GL_TRIANGLES, (GLsizei)m_indices.size(), GL_UNSIGNED_INT, 0);
-
-        glDisableClientState(GL_VERTEX_ARRAY);
-        glDisableClientState(GL_NORMAL_ARRAY);
-        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-        glDisableClientState(GL_COLOR_ARRAY);
+        for (const TerrainChunkDraw &draw : m_chunkDraws)
+        {
+            const size_t base = draw.chunk * chunkVertices * sizeof(TerrainVertex);
+            glVertexPointer(3, GL_FLOAT, sizeof(TerrainVertex), (void *)(base + offsetof(TerrainVertex, x)));
+            glNormalPointer(GL_BYTE, sizeof(TerrainVertex), (void *)(base + offsetof(TerrainVertex, nx)));
+            glDrawElements(GL_TRIANGLES, (GLsizei)m_quadtree.GetIndexCount(draw.level, draw.edges), GL_UNSIGNED_SHORT,
+                           (void *)(m_quadtree.GetIndexOffset(draw.level, draw.edges) * sizeof(uint16_t)));
+        }
 
+        // 顶点数组开关由 glPopClientAttrib 恢复
         glBindBuffer(GL_ARRAY_BUFFER, 0);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-        glDisableClientState(GL_VERTEX_ARRAY); // CAUTION: 必要
     }
     else
     {
         static bool warned = false;
         if (!warned)
         {
-            LogWarning(L"警告：地形正在使用低效率的立即模式渲染！");
+            LogWarning(L"警告：地形未使用VBO, 每帧逐块生成顶点！");
             warned = true;
         }
 
-        // 使用立即模式渲染（支持LOD）
-        glBegin(GL_TRIANGLES);
-        for (size_t i = 0; i < m_indices.size(); ++i)
+        // 客户端数组：逐块生成顶点后绘制
+        const uint16_t *pIndices = m_quadtree.GetIndices().data();
+        m_chunkVertices.resize(chunkVertices);
+        glVertexPointer(3, GL_FLOAT, sizeof(TerrainVertex), &m_chunkVertices[0].x);
+        glNormalPointer(GL_BYTE, sizeof(TerrainVertex), &m_chunkVertices[0].nx);
+        for (const TerrainChunkDraw &draw : m_chunkDraws)
         {
-            const Vertex &v = m_vertices[m_indices[i]];
-            glNormal3f(v.normal.x, v.normal.y, v.normal.z);
-            glTexCoord2f(v.uv.x, v.uv.y);
-            // glColor4f(v.color.x, v.color.y, v.color.z, v.color.w);
-            glVertex3f(v.pos.x, v.pos.y, v.pos.z);
+            m_quadtree.BuildChunkVertices(draw.chunk, m_chunkVertices.data());
+            glDrawElements(GL_TRIANGLES, (GLsizei)m_quadtree.GetIndexCount(draw.level, draw.edges), GL_UNSIGNED_SHORT,
+                           pIndices + m_quadtree.GetIndexOffset(draw.level, draw.edges));
         }
-        glEnd();
     }
 
     // 渲染法线
@@ -494,15 +546,11 @@ void CTerrainEntity::Render()
         DrawNormals(m_fNormalScale, m_uNormalStep);
     }
 
-    // 解绑纹理
-    if (m_pTexture && m_pTexture->GetID() != 0)
-    {
-        glBindTexture(GL_TEXTURE_2D, 0);
-        glDisable(GL_TEXTURE_2D);
-    }
-
+    // 纹理绑定与开关由 glPopAttrib 恢复
     glPopMatrix();
+    glPopClientAttrib();
     glPopAttrib();
+    state.Invalidate();
 
     // 渲染子实体
     CEntity::Render();
@@ -554,11 +602,20 @@ float CTerrainEntity::GetGroundHeight(const Vector3 &worldPos) const
 
 void CTerrainEntity::RenderSimpleGeometry()
 {
+    // 全分辨率，逐块生成顶点
+    const std::vector<uint16_t> &indices = m_quadtree.GetIndices();
+    const size_t offset = m_quadtree.GetIndexOffset(0, 0), count = m_quadtree.GetIndexCount(0, 0);
+    m_chunkVertices.resize(m_quadtree.GetVerticesPerChunk());
+
     glBegin(GL_TRIANGLES);
-    for (size_t i = 0; i < m_indices.size(); ++i)
+    for (size_t chunk = 0; chunk < m_quadtree.GetChunkCount(); ++chunk)
     {
-        const Vertex &v = m_vertices[m_indices[i]];
-        glVertex3f(v.pos.x, v.pos.y, v.pos.z);
+        m_quadtree.BuildChunkVertices(chunk, m_chunkVertices.data());
+        for (size_t i = offset; i < offset + count; ++i)
+        {
+            const TerrainVertex &v = m_chunkVertices[indices[i]];
+            glVertex3f(v.x, v.y, v.z);
+        }
     }
     glEnd();
 }
@@ -574,11 +631,8 @@ void CTerrainEntity::DrawNormals(float scale, unsigned int step)
 
 void CTerrainEntity::DrawNormalsImpl(float scale, unsigned int step)
 {
-    if (m_vertices.empty())
-    {
-        LogWarning(L"无法绘制法线：顶点数据为空.\n");
+    if (m_chunkDraws.empty())
         return;
-    }
 
     // 保存OpenGL状态
     glPushAttrib(GL_ENABLE_BIT | GL_CURRENT_BIT | GL_LINE_BIT);
@@ -597,19 +651,26 @@ void CTerrainEntity::DrawNormalsImpl(float scale, unsigned int step)
     glColor3f(1.0f, 0.2f, 0.2f);
     glLineWidth(1.0f);
 
-    // 绘制法线线条
+    // 绘制法线线条：只画本帧可见的块，块内按行列取步长
+    const int rowVertices = m_quadtree.GetChunkCells() + 1;
+    const int stride = (int)std::max(1u, step);
+    m_chunkVertices.resize(m_quadtree.GetVerticesPerChunk());
     glBegin(GL_LINES);
-    size_t vertexCount = m_vertices.size();
-    for (size_t i = 0; i < vertexCount; i += step)
+    for (const TerrainChunkDraw &draw : m_chunkDraws)
     {
-        const Vertex &v = m_vertices[i];
-
-        if (v.normal.Length() < 0.1f)
-            continue; // 跳过无效法线
-        Vector3 endPos = v.pos + v.normal * scale;
+        m_quadtree.BuildChunkVertices(draw.chunk, m_chunkVertices.data());
+        for (int z = 0; z < rowVertices; z += stride)
+        {
+            for (int x = 0; x < rowVertices; x += stride)
+            {
+                const TerrainVertex &v = m_chunkVertices[z * rowVertices + x];
+                Vector3 normal(v.nx / 127.0f, v.ny / 127.0f, v.nz / 127.0f);
+                Vector3 endPos = Vector3(v.x, v.y, v.z) + normal * scale;
 
-        glVertex3f(v.pos.x, v.pos.y, v.pos.z);
-        glVertex3f(endPos.x, endPos.y, endPos.z);
+                glVertex3f(v.x, v.y, v.z);
+                glVertex3f(endPos.x, endPos.y, endPos.z);
+            }
+        }
     }
     glEnd();
 
@@ -617,7 +678,82 @@ void CTerrainEntity::DrawNormalsImpl(float scale, unsigned int step)
     glLineWidth(1.0f);
     glColor4fv(currentColor);
     glPopAttrib();
+}
+// ======================================================================
+// 场景快照
+// ======================================================================
+void CTerrainEntity::WriteSnapshot(CSceneSnapshotWriter &writer, uint32_t index) const
+{
+    CEntity::WriteSnapshot(writer, index);
+
+    if (m_pTexture)
+        writer.SetResource(index, m_pTexture->GetPath());
+
+    // 定长参数与高度数据写在一起，读回时一次拷贝
+    size_t heightBytes = m_heightData.size() * sizeof(float);
+    std::vector<uint8_t> buffer(sizeof(TerrainSnapshotData) + heightBytes);
+    TerrainSnapshotData &data = *reinterpret_cast<TerrainSnapshotData *>(buffer.data());
+    data.width = m_width;
+    data.height = m_height;
+    data.cellSize = m_cellSize;
+    data.maxHeight = m_maxHeight;
+    data.textureRepeat = m_fTextureRepeat;
+    data.color[0] = m_terrainColor.x;
+    data.color[1] = m_terrainColor.y;
+    data.color[2] = m_terrainColor.z;
+    data.color[3] = m_terrainColor.w;
+    data.lodLevel = m_iLODLevel;
+    data.flags = (m_bWireframe ? 1u : 0u) | (m_bDrawNormals ? 2u : 0u);
+    data.normalScale = m_fNormalScale;
+    data.normalStep = m_uNormalStep;
+    data.reserved = 0;
+    if (heightBytes)
+        memcpy(buffer.data() + sizeof(TerrainSnapshotData), m_heightData.data(), heightBytes);
+    writer.SetData(index, buffer.data(), buffer.size());
+}
+
+void CTerrainEntity::ReadSnapshot(const SnapshotEntity &record)
+{
+    CEntity::ReadSnapshot(record);
+
+    if (record.dataSize < sizeof(TerrainSnapshotData))
+        return;
+    const TerrainSnapshotData &data = *reinterpret_cast<const TerrainSnapshotData *>(record.data.Get());
+    size_t count = (data.width > 1 && data.height > 1) ? (size_t)data.width * (size_t)data.height : 0;
+    if (count == 0 || record.dataSize < sizeof(TerrainSnapshotData) + count * sizeof(float))
+    {
+        LogError(L"地形快照数据不完整: %ls.\n", GetName().c_str());
+        return;
+    }
+
+    m_width = data.width;
+    m_height = data.height;
+    m_cellSize = data.cellSize;
+    m_maxHeight = data.maxHeight;
+    m_fTextureRepeat = data.textureRepeat;
+    m_terrainColor = Vector4(data.color[0], data.color[1], data.color[2], data.color[3]);
+    SetLODLevel(data.lodLevel);
+    m_bWireframe = (data.flags & 1u) ? TRUE : FALSE;
+    m_bDrawNormals = (data.flags & 2u) ? TRUE : FALSE;
+    m_fNormalScale = data.normalScale;
+    m_uNormalStep = data.normalStep;
+
+    const float *pHeights = reinterpret_cast<const float *>(record.data.Get() + sizeof(TerrainSnapshotData));
+    m_heightData.assign(pHeights, pHeights + count);
+
+    BuildMesh();
+}
+
+std::shared_ptr<CTerrainEntity> CTerrainEntity::CreateFromSnapshot(const SnapshotEntity &record)
+{
+    auto entity = Allocate<CTerrainEntity>();
+    entity->ReadSnapshot(record);
 
-    // LogDebug(L"绘制了 %d 条法线, 缩放: %.1f, 步长: %d.\n",
-    //          m_vertices.size() / step, scale, step);
-}
\ No newline at end of file
+    if (!record.resource.IsNull())
+    {
+        auto pResMgr = CGameEngine::GetInstance().GetResourceManager();
+        if (pResMgr)
+            entity->SetTexture(pResMgr->GetTexture(record.resource.Get(), CResourceManager::PathType::Absolute));
+    }
+    return entity;
+}
@@ -2,6 +2,8 @@
 // ======================================================================
 #include "stdafx.h"
 #include "Graphics/Camera/Camera.h"
+#include "Math/Frustum.h"
+#include "Math/Random.h"
 // ======================================================================
 
 using namespace Math;
@@ -549,11 +551,9 @@ void CCamera::StopShake()
 
 void CCamera::GenerateShakeOffset()
 {
-    FLOAT x = (static_cast<FLOAT>(rand()) / RAND_MAX * 2.0f - 1.0f) * m_ShakeIntensity;
-    FLOAT y = (static_cast<FLOAT>(rand()) / RAND_MAX * 2.0f - 1.0f) * m_ShakeIntensity;
-    FLOAT z = (static_cast<FLOAT>(rand()) / RAND_MAX * 2.0f - 1.0f) * m_ShakeIntensity;
-
-    m_ShakeOffset = Vector3(x, y, z);
+    // 线程默认随机流，设置全局种子后可复现
+    Vector3 extent(m_ShakeIntensity, m_ShakeIntensity, m_ShakeIntensity);
+    m_ShakeOffset = Math::RandomGenerator::ThreadLocal().NextVector3(-extent, extent);
 }
 
 void CCamera::SetPitchLimits(FLOAT minPitch, FLOAT maxPitch)
@@ -614,11 +614,17 @@ void CCamera::GetViewProjectionMatrix(Matrix4 &matrix) const
         m_ProjDirty = FALSE;
     }
 
-    // 计算 matrix = proj * view
-    // 在列优先布局下，matrix[c][r] = sum(proj[k][r] * view[c][k])
-    // 其中 c 为列索引，r 为行索引
+    // 列向量约定：先观察后投影，matrix = proj * view
+    Matrix4 view;
+    GetViewMatrix(view);
+    matrix = m_CachedProj * view;
+}
 
-    matrix = m_CachedProj;
+void CCamera::GetFrustum(Frustum &frustum) const
+{
+    Matrix4 viewProjection;
+    GetViewProjectionMatrix(viewProjection);
+    frustum = Frustum::FromMatrix(viewProjection);
 }
 
 void CCamera::Update(FLOAT deltaTime)
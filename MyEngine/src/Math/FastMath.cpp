@@ -0,0 +1,108 @@
+#include "stdafx.h"
+#include "Math/FastMath.h"
+
+namespace Math
+{
+namespace Fast
+{
+    void Sin(const float *in, float *out, size_t count)
+    {
+        size_t i = 0;
+#if defined(MATH_SIMD_AVX)
+        for (; i + 8 <= count; i += 8)
+            _mm256_storeu_ps(out + i, Sin8(_mm256_loadu_ps(in + i)));
+#endif
+#if defined(MATH_SIMD_SSE)
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_ps(out + i, Sin4(_mm_loadu_ps(in + i)));
+#endif
+        for (; i < count; ++i)
+            out[i] = Sin(in[i]);
+    }
+
+    void Cos(const float *in, float *out, size_t count)
+    {
+        size_t i = 0;
+#if defined(MATH_SIMD_AVX)
+        for (; i + 8 <= count; i += 8)
+            _mm256_storeu_ps(out + i, Cos8(_mm256_loadu_ps(in + i)));
+#endif
+#if defined(MATH_SIMD_SSE)
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_ps(out + i, Cos4(_mm_loadu_ps(in + i)));
+#endif
+        for (; i < count; ++i)
+            out[i] = Cos(in[i]);
+    }
+
+    void SinCos(const float *in, float *outSin, float *outCos, size_t count)
+    {
+        size_t i = 0;
+#if defined(MATH_SIMD_AVX)
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 s, c;
+            SinCos8(_mm256_loadu_ps(in + i), &s, &c);
+            _mm256_storeu_ps(outSin + i, s);
+            _mm256_storeu_ps(outCos + i, c);
+        }
+#endif
+#if defined(MATH_SIMD_SSE)
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 s, c;
+            SinCos4(_mm_loadu_ps(in + i), &s, &c);
+            _mm_storeu_ps(outSin + i, s);
+            _mm_storeu_ps(outCos + i, c);
+        }
+#endif
+        for (; i < count; ++i)
+            SinCos(in[i], &outSin[i], &outCos[i]);
+    }
+
+    void InvSqrt(const float *in, float *out, size_t count)
+    {
+        size_t i = 0;
+#if defined(MATH_SIMD_AVX)
+        for (; i + 8 <= count; i += 8)
+            _mm256_storeu_ps(out + i, InvSqrt8(_mm256_loadu_ps(in + i)));
+#endif
+#if defined(MATH_SIMD_SSE)
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_ps(out + i, InvSqrt4(_mm_loadu_ps(in + i)));
+#endif
+        for (; i < count; ++i)
+            out[i] = InvSqrt(in[i]);
+    }
+
+    void Sqrt(const float *in, float *out, size_t count)
+    {
+        size_t i = 0;
+#if defined(MATH_SIMD_AVX)
+        for (; i + 8 <= count; i += 8)
+            _mm256_storeu_ps(out + i, Sqrt8(_mm256_loadu_ps(in + i)));
+#endif
+#if defined(MATH_SIMD_SSE)
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_ps(out + i, Sqrt4(_mm_loadu_ps(in + i)));
+#endif
+        for (; i < count; ++i)
+            out[i] = Sqrt(in[i]);
+    }
+
+    void Atan2(const float *y, const float *x, float *out, size_t count)
+    {
+        size_t i = 0;
+#if defined(MATH_SIMD_AVX)
+        for (; i + 8 <= count; i += 8)
+            _mm256_storeu_ps(out + i, Atan2_8(_mm256_loadu_ps(y + i), _mm256_loadu_ps(x + i)));
+#endif
+#if defined(MATH_SIMD_SSE)
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_ps(out + i, Atan2_4(_mm_loadu_ps(y + i), _mm_loadu_ps(x + i)));
+#endif
+        for (; i < count; ++i)
+            out[i] = Atan2(y[i], x[i]);
+    }
+}
+}
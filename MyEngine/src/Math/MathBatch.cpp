@@ -0,0 +1,564 @@
+#include "stdafx.h"
+#include "Math/MathBatch.h"
+#include "Math/MathSIMD.h"
+#include <thread>
+
+static_assert(sizeof(Vector3) == 3 * sizeof(float), "Vector3 必须紧密排列才能按 float 数组批量读写");
+
+namespace Math
+{
+namespace Batch
+{
+    // ======================================================================
+    // SoA 存储
+    // ======================================================================
+    void Vector3SoA::FromAoS(const Vector3 *src, size_t count)
+    {
+        Resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            x[i] = src[i].x;
+            y[i] = src[i].y;
+            z[i] = src[i].z;
+        }
+    }
+
+    void Vector3SoA::ToAoS(Vector3 *dst) const
+    {
+        for (size_t i = 0; i < x.size(); ++i)
+            dst[i] = Vector3(x[i], y[i], z[i]);
+    }
+
+    // ======================================================================
+    // 并行拆分
+    // ======================================================================
+    namespace
+    {
+        // 默认执行器：按硬件线程数切块，调用线程自己处理最后一块
+        void DefaultExecutor(size_t count, size_t grain, const RangeFunc &func)
+        {
+            size_t hw = std::thread::hardware_concurrency();
+            if (hw == 0)
+                hw = 1;
+            if (grain == 0)
+                grain = 1;
+
+            size_t chunks = (count + grain - 1) / grain;
+            if (chunks > hw)
+                chunks = hw;
+            if (chunks <= 1)
+            {
+                func(0, count);
+                return;
+            }
+
+            size_t chunkSize = (count + chunks - 1) / chunks;
+            std::vector<std::thread> workers;
+            workers.reserve(chunks - 1);
+            for (size_t c = 0; c + 1 < chunks; ++c)
+            {
+                size_t begin = c * chunkSize;
+                size_t end = begin + chunkSize;
+                workers.push_back(std::thread([&func, begin, end]() { func(begin, end); }));
+            }
+            func((chunks - 1) * chunkSize, count);
+
+            for (size_t i = 0; i < workers.size(); ++i)
+                workers[i].join();
+        }
+
+        ParallelExecutor &Executor()
+        {
+            static ParallelExecutor s_executor = DefaultExecutor;
+            return s_executor;
+        }
+    }
+
+    void SetParallelExecutor(const ParallelExecutor &executor)
+    {
+        Executor() = executor ? executor : ParallelExecutor(DefaultExecutor);
+    }
+
+    void ParallelFor(size_t count, size_t grain, const RangeFunc &func)
+    {
+        if (count == 0)
+            return;
+        Executor()(count, grain, func);
+    }
+
+    void Dispatch(size_t count, const RangeFunc &func)
+    {
+        // 小批量直接在当前线程执行
+        if (count >= PARALLEL_THRESHOLD)
+            ParallelFor(count, PARALLEL_THRESHOLD / 4, func);
+        else if (count > 0)
+            func(0, count);
+    }
+
+    // ======================================================================
+    // 内核：AoS 区间变换
+    // translate = false 时忽略平移（方向向量）
+    // ======================================================================
+    namespace
+    {
+        void TransformAoSRange(const float *m, const Vector3 *in, Vector3 *out, size_t begin, size_t end, bool translate)
+        {
+            const float tx = translate ? m[12] : 0.0f;
+            const float ty = translate ? m[13] : 0.0f;
+            const float tz = translate ? m[14] : 0.0f;
+            size_t i = begin;
+
+#if defined(MATH_SIMD_SSE)
+            const __m128 m00 = _mm_set1_ps(m[0]), m10 = _mm_set1_ps(m[1]), m20 = _mm_set1_ps(m[2]);
+            const __m128 m01 = _mm_set1_ps(m[4]), m11 = _mm_set1_ps(m[5]), m21 = _mm_set1_ps(m[6]);
+            const __m128 m02 = _mm_set1_ps(m[8]), m12 = _mm_set1_ps(m[9]), m22 = _mm_set1_ps(m[10]);
+            const __m128 vtx = _mm_set1_ps(tx), vty = _mm_set1_ps(ty), vtz = _mm_set1_ps(tz);
+
+            for (; i + 4 <= end; i += 4)
+            {
+                const float *src = &in[i].x;
+                // (x0 y0 z0 x1) (y1 z1 x2 y2) (z2 x3 y3 z3) -> x/y/z 各 4 个
+                __m128 a = _mm_loadu_ps(src + 0);
+                __m128 b = _mm_loadu_ps(src + 4);
+                __m128 c = _mm_loadu_ps(src + 8);
+
+                __m128 bc = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 0, 3, 2)); // x2 y2 z2 x3
+                __m128 ab = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1)); // y0 z0 y1 z1
+                __m128 bb = _mm_shuffle_ps(b, c, _MM_SHUFFLE(3, 2, 3, 3)); // y2 y2 y3 z3
+                __m128 x = _mm_shuffle_ps(a, bc, _MM_SHUFFLE(3, 0, 3, 0));
+                __m128 y = _mm_shuffle_ps(ab, bb, _MM_SHUFFLE(2, 0, 2, 0));
+                __m128 z = _mm_shuffle_ps(ab, c, _MM_SHUFFLE(3, 0, 3, 1));
+
+                __m128 ox = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, x), _mm_mul_ps(m01, y)), _mm_mul_ps(m02, z)), vtx);
+                __m128 oy = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m10, x), _mm_mul_ps(m11, y)), _mm_mul_ps(m12, z)), vty);
+                __m128 oz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m20, x), _mm_mul_ps(m21, y)), _mm_mul_ps(m22, z)), vtz);
+
+                // x/y/z -> AoS
+                __m128 xyLo = _mm_unpacklo_ps(ox, oy);                         // x0 y0 x1 y1
+                __m128 xyHi = _mm_unpackhi_ps(ox, oy);                         // x2 y2 x3 y3
+                __m128 zxLo = _mm_shuffle_ps(oz, ox, _MM_SHUFFLE(1, 1, 0, 0)); // z0 z0 x1 x1
+                __m128 yzMid = _mm_shuffle_ps(oy, oz, _MM_SHUFFLE(1, 1, 1, 1)); // y1 y1 z1 z1
+                __m128 zxHi = _mm_shuffle_ps(oz, ox, _MM_SHUFFLE(3, 3, 2, 2)); // z2 z2 x3 x3
+                __m128 yzHi = _mm_shuffle_ps(oy, oz, _MM_SHUFFLE(3, 3, 3, 3)); // y3 y3 z3 z3
+
+                float *dst = &out[i].x;
+                _mm_storeu_ps(dst + 0, _mm_shuffle_ps(xyLo, zxLo, _MM_SHUFFLE(2, 0, 1, 0)));
+                _mm_storeu_ps(dst + 4, _mm_shuffle_ps(yzMid, xyHi, _MM_SHUFFLE(1, 0, 2, 0)));
+                _mm_storeu_ps(dst + 8, _mm_shuffle_ps(zxHi, yzHi, _MM_SHUFFLE(2, 0, 2, 0)));
+            }
+#endif
+            for (; i < end; ++i)
+            {
+                float x = in[i].x, y = in[i].y, z = in[i].z;
+                out[i] = Vector3(m[0] * x + m[4] * y + m[8] * z + tx,
+                                 m[1] * x + m[5] * y + m[9] * z + ty,
+                                 m[2] * x + m[6] * y + m[10] * z + tz);
+            }
+        }
+
+        // ======================================================================
+        // 内核：SoA 区间变换
+        // ======================================================================
+        void TransformSoARange(const float *m, const float *ix, const float *iy, const float *iz,
+                               float *ox, float *oy, float *oz, size_t begin, size_t end, bool translate)
+        {
+            const float tx = translate ? m[12] : 0.0f;
+            const float ty = translate ? m[13] : 0.0f;
+            const float tz = translate ? m[14] : 0.0f;
+            size_t i = begin;
+
+#if defined(MATH_SIMD_AVX)
+            {
+                const __m256 m00 = _mm256_set1_ps(m[0]), m10 = _mm256_set1_ps(m[1]), m20 = _mm256_set1_ps(m[2]);
+                const __m256 m01 = _mm256_set1_ps(m[4]), m11 = _mm256_set1_ps(m[5]), m21 = _mm256_set1_ps(m[6]);
+                const __m256 m02 = _mm256_set1_ps(m[8]), m12 = _mm256_set1_ps(m[9]), m22 = _mm256_set1_ps(m[10]);
+                const __m256 vtx = _mm256_set1_ps(tx), vty = _mm256_set1_ps(ty), vtz = _mm256_set1_ps(tz);
+                for (; i + 8 <= end; i += 8)
+                {
+                    __m256 x = _mm256_loadu_ps(ix + i);
+                    __m256 y = _mm256_loadu_ps(iy + i);
+                    __m256 z = _mm256_loadu_ps(iz + i);
+                    __m256 rx = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m00, x), _mm256_mul_ps(m01, y)), _mm256_mul_ps(m02, z)), vtx);
+                    __m256 ry = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m10, x), _mm256_mul_ps(m11, y)), _mm256_mul_ps(m12, z)), vty);
+                    __m256 rz = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m20, x), _mm256_mul_ps(m21, y)), _mm256_mul_ps(m22, z)), vtz);
+                    _mm256_storeu_ps(ox + i, rx);
+                    _mm256_storeu_ps(oy + i, ry);
+                    _mm256_storeu_ps(oz + i, rz);
+                }
+            }
+#endif
+#if defined(MATH_SIMD_SSE)
+            {
+                const __m128 m00 = _mm_set1_ps(m[0]), m10 = _mm_set1_ps(m[1]), m20 = _mm_set1_ps(m[2]);
+                const __m128 m01 = _mm_set1_ps(m[4]), m11 = _mm_set1_ps(m[5]), m21 = _mm_set1_ps(m[6]);
+                const __m128 m02 = _mm_set1_ps(m[8]), m12 = _mm_set1_ps(m[9]), m22 = _mm_set1_ps(m[10]);
+                const __m128 vtx = _mm_set1_ps(tx), vty = _mm_set1_ps(ty), vtz = _mm_set1_ps(tz);
+                for (; i + 4 <= end; i += 4)
+                {
+                    __m128 x = _mm_loadu_ps(ix + i);
+                    __m128 y = _mm_loadu_ps(iy + i);
+                    __m128 z = _mm_loadu_ps(iz + i);
+                    __m128 rx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, x), _mm_mul_ps(m01, y)), _mm_mul_ps(m02, z)), vtx);
+                    __m128 ry = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m10, x), _mm_mul_ps(m11, y)), _mm_mul_ps(m12, z)), vty);
+                    __m128 rz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m20, x), _mm_mul_ps(m21, y)), _mm_mul_ps(m22, z)), vtz);
+                    _mm_storeu_ps(ox + i, rx);
+                    _mm_storeu_ps(oy + i, ry);
+                    _mm_storeu_ps(oz + i, rz);
+                }
+            }
+#endif
+            for (; i < end; ++i)
+            {
+                float x = ix[i], y = iy[i], z = iz[i];
+                ox[i] = m[0] * x + m[4] * y + m[8] * z + tx;
+                oy[i] = m[1] * x + m[5] * y + m[9] * z + ty;
+                oz[i] = m[2] * x + m[6] * y + m[10] * z + tz;
+            }
+        }
+
+        // SoA 区间归一化（长度过小时置零，与 Vector3::Normalized 一致）
+        void NormalizeSoARange(float *x, float *y, float *z, size_t begin, size_t end)
+        {
+            size_t i = begin;
+#if defined(MATH_SIMD_SSE)
+            const __m128 eps = _mm_set1_ps(Math::EPSILON);
+            const __m128 one = _mm_set1_ps(1.0f);
+            for (; i + 4 <= end; i += 4)
+            {
+                __m128 vx = _mm_loadu_ps(x + i);
+                __m128 vy = _mm_loadu_ps(y + i);
+                __m128 vz = _mm_loadu_ps(z + i);
+                __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz)));
+                __m128 inv = _mm_and_ps(_mm_div_ps(one, len), _mm_cmpgt_ps(len, eps));
+                _mm_storeu_ps(x + i, _mm_mul_ps(vx, inv));
+                _mm_storeu_ps(y + i, _mm_mul_ps(vy, inv));
+                _mm_storeu_ps(z + i, _mm_mul_ps(vz, inv));
+            }
+#endif
+            for (; i < end; ++i)
+            {
+                Vector3 v = Vector3(x[i], y[i], z[i]).Normalized();
+                x[i] = v.x;
+                y[i] = v.y;
+                z[i] = v.z;
+            }
+        }
+
+        // 法线矩阵：左上 3x3 的逆转置（平移列清零）
+        Matrix4 NormalMatrix(const Matrix4 &m)
+        {
+            Matrix4 affine = m;
+            affine.m[3] = affine.m[7] = affine.m[11] = 0.0f;
+            affine.m[12] = affine.m[13] = affine.m[14] = 0.0f;
+            affine.m[15] = 1.0f;
+            return affine.InversedAffine().Transposed();
+        }
+    }
+
+    // ======================================================================
+    // AoS 变换
+    // ======================================================================
+    void TransformPoints(const Matrix4 &m, const Vector3 *in, Vector3 *out, size_t count)
+    {
+        Dispatch(count, [&](size_t begin, size_t end) {
+            TransformAoSRange(m.m, in, out, begin, end, true);
+        });
+    }
+
+    void TransformDirections(const Matrix4 &m, const Vector3 *in, Vector3 *out, size_t count)
+    {
+        Dispatch(count, [&](size_t begin, size_t end) {
+            TransformAoSRange(m.m, in, out, begin, end, false);
+        });
+    }
+
+    void TransformNormals(const Matrix4 &m, const Vector3 *in, Vector3 *out, size_t count)
+    {
+        Matrix4 normalMat = NormalMatrix(m);
+        Dispatch(count, [&](size_t begin, size_t end) {
+            TransformAoSRange(normalMat.m, in, out, begin, end, false);
+            for (size_t i = begin; i < end; ++i)
+                out[i].Normalize();
+        });
+    }
+
+    // ======================================================================
+    // SoA 变换
+    // ======================================================================
+    void TransformPoints(const Matrix4 &m, const Vector3SoA &in, Vector3SoA &out)
+    {
+        out.Resize(in.Size());
+        Dispatch(in.Size(), [&](size_t begin, size_t end) {
+            TransformSoARange(m.m, in.x.data(), in.y.data(), in.z.data(),
+                              out.x.data(), out.y.data(), out.z.data(), begin, end, true);
+        });
+    }
+
+    void TransformDirections(const Matrix4 &m, const Vector3SoA &in, Vector3SoA &out)
+    {
+        out.Resize(in.Size());
+        Dispatch(in.Size(), [&](size_t begin, size_t end) {
+            TransformSoARange(m.m, in.x.data(), in.y.data(), in.z.data(),
+                              out.x.data(), out.y.data(), out.z.data(), begin, end, false);
+        });
+    }
+
+    void TransformNormals(const Matrix4 &m, const Vector3SoA &in, Vector3SoA &out)
+    {
+        Matrix4 normalMat = NormalMatrix(m);
+        out.Resize(in.Size());
+        Dispatch(in.Size(), [&](size_t begin, size_t end) {
+            TransformSoARange(normalMat.m, in.x.data(), in.y.data(), in.z.data(),
+                              out.x.data(), out.y.data(), out.z.data(), begin, end, false);
+            NormalizeSoARange(out.x.data(), out.y.data(), out.z.data(), begin, end);
+        });
+    }
+
+    // ======================================================================
+    // 包围盒
+    // ======================================================================
+    AABB TransformAABB(const Matrix4 &m, const AABB &box)
+    {
+        if (!box.IsValid())
+            return box;
+
+        Vector3 c = box.GetCenter();
+        Vector3 e = box.GetExtents();
+#if defined(MATH_SIMD_SSE)
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        __m128 c0 = _mm_loadu_ps(m.m + 0);
+        __m128 c1 = _mm_loadu_ps(m.m + 4);
+        __m128 c2 = _mm_loadu_ps(m.m + 8);
+        __m128 c3 = _mm_loadu_ps(m.m + 12);
+
+        __m128 center = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(c.x)), _mm_mul_ps(c1, _mm_set1_ps(c.y))),
+                                              _mm_mul_ps(c2, _mm_set1_ps(c.z))), c3);
+        __m128 extents = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_and_ps(c0, absMask), _mm_set1_ps(e.x)),
+                                               _mm_mul_ps(_mm_and_ps(c1, absMask), _mm_set1_ps(e.y))),
+                                    _mm_mul_ps(_mm_and_ps(c2, absMask), _mm_set1_ps(e.z)));
+        float lo[4], hi[4];
+        _mm_storeu_ps(lo, _mm_sub_ps(center, extents));
+        _mm_storeu_ps(hi, _mm_add_ps(center, extents));
+        return AABB(Vector3(lo[0], lo[1], lo[2]), Vector3(hi[0], hi[1], hi[2]));
+#else
+        const float *a = m.m;
+        Vector3 center(a[0] * c.x + a[4] * c.y + a[8] * c.z + a[12],
+                       a[1] * c.x + a[5] * c.y + a[9] * c.z + a[13],
+                       a[2] * c.x + a[6] * c.y + a[10] * c.z + a[14]);
+        Vector3 extents(Math::Abs(a[0]) * e.x + Math::Abs(a[4]) * e.y + Math::Abs(a[8]) * e.z,
+                        Math::Abs(a[1]) * e.x + Math::Abs(a[5]) * e.y + Math::Abs(a[9]) * e.z,
+                        Math::Abs(a[2]) * e.x + Math::Abs(a[6]) * e.y + Math::Abs(a[10]) * e.z);
+        return AABB(center - extents, center + extents);
+#endif
+    }
+
+    void TransformAABBs(const Matrix4 &m, const AABB *in, AABB *out, size_t count)
+    {
+        Dispatch(count, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                out[i] = TransformAABB(m, in[i]);
+        });
+    }
+
+    AABB ComputeBounds(const Vector3 *points, size_t count)
+    {
+        AABB box;
+        for (size_t i = 0; i < count; ++i)
+            box.Expand(points[i]);
+        return box;
+    }
+
+    AABB ComputeBounds(const Vector3SoA &points)
+    {
+        AABB box;
+        size_t count = points.Size();
+        if (count == 0)
+            return box;
+
+        size_t i = 0;
+        float lo[3] = {box.min.x, box.min.y, box.min.z};
+        float hi[3] = {box.max.x, box.max.y, box.max.z};
+#if defined(MATH_SIMD_SSE)
+        if (count >= 4)
+        {
+            __m128 minX = _mm_set1_ps(lo[0]), minY = _mm_set1_ps(lo[1]), minZ = _mm_set1_ps(lo[2]);
+            __m128 maxX = _mm_set1_ps(hi[0]), maxY = _mm_set1_ps(hi[1]), maxZ = _mm_set1_ps(hi[2]);
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 x = _mm_loadu_ps(&points.x[i]);
+                __m128 y = _mm_loadu_ps(&points.y[i]);
+                __m128 z = _mm_loadu_ps(&points.z[i]);
+                minX = _mm_min_ps(minX, x);
+                minY = _mm_min_ps(minY, y);
+                minZ = _mm_min_ps(minZ, z);
+                maxX = _mm_max_ps(maxX, x);
+                maxY = _mm_max_ps(maxY, y);
+                maxZ = _mm_max_ps(maxZ, z);
+            }
+            float t[6][4];
+            _mm_storeu_ps(t[0], minX);
+            _mm_storeu_ps(t[1], minY);
+            _mm_storeu_ps(t[2], minZ);
+            _mm_storeu_ps(t[3], maxX);
+            _mm_storeu_ps(t[4], maxY);
+            _mm_storeu_ps(t[5], maxZ);
+            for (int k = 0; k < 4; ++k)
+            {
+                for (int a = 0; a < 3; ++a)
+                {
+                    lo[a] = Math::Min(lo[a], t[a][k]);
+                    hi[a] = Math::Max(hi[a], t[3 + a][k]);
+                }
+            }
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            lo[0] = Math::Min(lo[0], points.x[i]);
+            lo[1] = Math::Min(lo[1], points.y[i]);
+            lo[2] = Math::Min(lo[2], points.z[i]);
+            hi[0] = Math::Max(hi[0], points.x[i]);
+            hi[1] = Math::Max(hi[1], points.y[i]);
+            hi[2] = Math::Max(hi[2], points.z[i]);
+        }
+        return AABB(Vector3(lo[0], lo[1], lo[2]), Vector3(hi[0], hi[1], hi[2]));
+    }
+
+    // ======================================================================
+    // 视锥剔除
+    // ======================================================================
+    size_t CullSpheres(const Frustum &frustum, const Vector3SoA &centers, const float *radii, uint8_t *visible)
+    {
+        const size_t count = centers.Size();
+        const float *cx = centers.x.data();
+        const float *cy = centers.y.data();
+        const float *cz = centers.z.data();
+        size_t visibleCount = 0;
+        size_t i = 0;
+
+        // 距离的累加顺序与 Frustum::Distance 相同：((nx * x + ny * y) + nz * z) + d
+#if defined(MATH_SIMD_SSE) // AVX 时也有定义
+        const Vector4 *planes = frustum.planes;
+#endif
+#if defined(MATH_SIMD_AVX)
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 x = _mm256_loadu_ps(cx + i);
+            __m256 y = _mm256_loadu_ps(cy + i);
+            __m256 z = _mm256_loadu_ps(cz + i);
+            __m256 negR = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(radii + i));
+            __m256 outside = _mm256_setzero_ps();
+            for (int p = 0; p < Frustum::PlaneCount; ++p)
+            {
+                __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(planes[p].x), x),
+                                                                     _mm256_mul_ps(_mm256_set1_ps(planes[p].y), y)),
+                                                       _mm256_mul_ps(_mm256_set1_ps(planes[p].z), z)),
+                                         _mm256_set1_ps(planes[p].w));
+                outside = _mm256_or_ps(outside, _mm256_cmp_ps(d, negR, _CMP_LT_OQ));
+            }
+            int mask = ~_mm256_movemask_ps(outside) & 0xFF;
+            for (int k = 0; k < 8; ++k)
+            {
+                visible[i + k] = (uint8_t)((mask >> k) & 1);
+                visibleCount += (mask >> k) & 1;
+            }
+        }
+#endif
+#if defined(MATH_SIMD_SSE)
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 x = _mm_loadu_ps(cx + i);
+            __m128 y = _mm_loadu_ps(cy + i);
+            __m128 z = _mm_loadu_ps(cz + i);
+            __m128 negR = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radii + i));
+            __m128 outside = _mm_setzero_ps();
+            for (int p = 0; p < Frustum::PlaneCount; ++p)
+            {
+                __m128 d = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes[p].x), x),
+                                                            _mm_mul_ps(_mm_set1_ps(planes[p].y), y)),
+                                                 _mm_mul_ps(_mm_set1_ps(planes[p].z), z)),
+                                      _mm_set1_ps(planes[p].w));
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(d, negR));
+            }
+            int mask = ~_mm_movemask_ps(outside) & 0xF;
+            for (int k = 0; k < 4; ++k)
+            {
+                visible[i + k] = (uint8_t)((mask >> k) & 1);
+                visibleCount += (mask >> k) & 1;
+            }
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            visible[i] = frustum.Intersects(Vector3(cx[i], cy[i], cz[i]), radii[i]) ? 1 : 0;
+            visibleCount += visible[i];
+        }
+        return visibleCount;
+    }
+
+    size_t CullAABBs(const Frustum &frustum, const AABB *boxes, size_t count, uint8_t *visible)
+    {
+        size_t visibleCount = 0;
+#if defined(MATH_SIMD_SSE)
+        // 平面转置为 SoA 并补齐到 8 个：补齐的平面 (0, 0, 0, 1) 对任何包围盒都在内侧
+        alignas(32) float px[8], py[8], pz[8], pw[8], ax[8], ay[8], az[8];
+        for (int p = 0; p < 8; ++p)
+        {
+            const Vector4 plane = p < Frustum::PlaneCount ? frustum.planes[p] : Vector4(0.0f, 0.0f, 0.0f, 1.0f);
+            px[p] = plane.x;
+            py[p] = plane.y;
+            pz[p] = plane.z;
+            pw[p] = plane.w;
+            ax[p] = Math::Abs(plane.x);
+            ay[p] = Math::Abs(plane.y);
+            az[p] = Math::Abs(plane.z);
+        }
+
+        // 与 Frustum::Classify 相同：中心距离 d 与投影半径 r，d < -r 即在该平面外侧
+#if defined(MATH_SIMD_AVX)
+        const __m256 vpx = _mm256_load_ps(px), vpy = _mm256_load_ps(py), vpz = _mm256_load_ps(pz), vpw = _mm256_load_ps(pw);
+        const __m256 vax = _mm256_load_ps(ax), vay = _mm256_load_ps(ay), vaz = _mm256_load_ps(az);
+        for (size_t i = 0; i < count; ++i)
+        {
+            Vector3 c = boxes[i].GetCenter();
+            Vector3 e = boxes[i].GetExtents();
+            __m256 cx = _mm256_set1_ps(c.x), cy = _mm256_set1_ps(c.y), cz = _mm256_set1_ps(c.z);
+            __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vpx, cx), _mm256_mul_ps(vpy, cy)), _mm256_mul_ps(vpz, cz)), vpw);
+            __m256 r = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vax, _mm256_set1_ps(e.x)), _mm256_mul_ps(vay, _mm256_set1_ps(e.y))),
+                                     _mm256_mul_ps(vaz, _mm256_set1_ps(e.z)));
+            __m256 outside = _mm256_cmp_ps(d, _mm256_sub_ps(_mm256_setzero_ps(), r), _CMP_LT_OQ);
+            visible[i] = _mm256_movemask_ps(outside) == 0 ? 1 : 0;
+            visibleCount += visible[i];
+        }
+#else
+        const __m128 px0 = _mm_load_ps(px), py0 = _mm_load_ps(py), pz0 = _mm_load_ps(pz), pw0 = _mm_load_ps(pw);
+        const __m128 px1 = _mm_load_ps(px + 4), py1 = _mm_load_ps(py + 4), pz1 = _mm_load_ps(pz + 4), pw1 = _mm_load_ps(pw + 4);
+        const __m128 ax0 = _mm_load_ps(ax), ay0 = _mm_load_ps(ay), az0 = _mm_load_ps(az);
+        const __m128 ax1 = _mm_load_ps(ax + 4), ay1 = _mm_load_ps(ay + 4), az1 = _mm_load_ps(az + 4);
+        for (size_t i = 0; i < count; ++i)
+        {
+            Vector3 c = boxes[i].GetCenter();
+            Vector3 e = boxes[i].GetExtents();
+            __m128 cx = _mm_set1_ps(c.x), cy = _mm_set1_ps(c.y), cz = _mm_set1_ps(c.z);
+            __m128 ex = _mm_set1_ps(e.x), ey = _mm_set1_ps(e.y), ez = _mm_set1_ps(e.z);
+            __m128 d0 = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(px0, cx), _mm_mul_ps(py0, cy)), _mm_mul_ps(pz0, cz)), pw0);
+            __m128 d1 = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(px1, cx), _mm_mul_ps(py1, cy)), _mm_mul_ps(pz1, cz)), pw1);
+            __m128 r0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax0, ex), _mm_mul_ps(ay0, ey)), _mm_mul_ps(az0, ez));
+            __m128 r1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax1, ex), _mm_mul_ps(ay1, ey)), _mm_mul_ps(az1, ez));
+            __m128 outside = _mm_or_ps(_mm_cmplt_ps(d0, _mm_sub_ps(_mm_setzero_ps(), r0)),
+                                       _mm_cmplt_ps(d1, _mm_sub_ps(_mm_setzero_ps(), r1)));
+            visible[i] = _mm_movemask_ps(outside) == 0 ? 1 : 0;
+            visibleCount += visible[i];
+        }
+#endif
+#else
+        for (size_t i = 0; i < count; ++i)
+        {
+            visible[i] = frustum.Intersects(boxes[i]) ? 1 : 0;
+            visibleCount += visible[i];
+        }
+#endif
+        return visibleCount;
+    }
+}
+}
@@ -1,200 +1,72 @@
 ﻿#include "stdafx.h"
 #include "Math/MathUtils.h"
 #include "Math/Matrix4.h"
+#include "Math/MathSIMD.h"
 #include <sstream>
-#include <cstring>
-
-// 构造函数
-Matrix4::Matrix4()
-{
-    memset(m, 0, sizeof(m));
-    m00 = m11 = m22 = m33 = 1.0f; // 单位矩阵
-}
-
-Matrix4::Matrix4(float diagonal)
-{
-    memset(m, 0, sizeof(m));
-    m00 = m11 = m22 = m33 = diagonal;
-}
-
-Matrix4::Matrix4(float _m00, float _m01, float _m02, float _m03,
-                 float _m10, float _m11, float _m12, float _m13,
-                 float _m20, float _m21, float _m22, float _m23,
-                 float _m30, float _m31, float _m32, float _m33)
-{
-    m00 = _m00;m01 = _m01;m02 = _m02;m03 = _m03; //
-    m10 = _m10;m11 = _m11;m12 = _m12;m13 = _m13; //
-    m20 = _m20;m21 = _m21;m22 = _m22;m23 = _m23; //
-    m30 = _m30;m31 = _m31;m32 = _m32;m33 = _m33; //
-    }
 
 // 矩阵运算
-Matrix4 Matrix4::operator+(const Matrix4 &other) const
-{
-    Matrix4 result;
-    for (int i = 0; i < 16; ++i)
-        result.m[i] = m[i] + other.m[i];
-    return result;
-}
-
-Matrix4 Matrix4::operator-(const Matrix4 &other) const
-{
-    Matrix4 result;
-    for (int i = 0; i < 16; ++i)
-        result.m[i] = m[i] - other.m[i];
-    return result;
-}
-
 Matrix4 Matrix4::operator*(const Matrix4 &other) const
 {
     Matrix4 result;
-    result.m00 = m00 * other.m00 + m01 * other.m10 + m02 * other.m20 + m03 * other.m30;
-    result.m01 = m00 * other.m01 + m01 * other.m11 + m02 * other.m21 + m03 * other.m31;
-    result.m02 = m00 * other.m02 + m01 * other.m12 + m02 * other.m22 + m03 * other.m32;
-    result.m03 = m00 * other.m03 + m01 * other.m13 + m02 * other.m23 + m03 * other.m33;
-
-    result.m10 = m10 * other.m00 + m11 * other.m10 + m12 * other.m20 + m13 * other.m30;
-    result.m11 = m10 * other.m01 + m11 * other.m11 + m12 * other.m21 + m13 * other.m31;
-    result.m12 = m10 * other.m02 + m11 * other.m12 + m12 * other.m22 + m13 * other.m32;
-    result.m13 = m10 * other.m03 + m11 * other.m13 + m12 * other.m23 + m13 * other.m33;
-
-    result.m20 = m20 * other.m00 + m21 * other.m10 + m22 * other.m20 + m23 * other.m30;
-    result.m21 = m20 * other.m01 + m21 * other.m11 + m22 * other.m21 + m23 * other.m31;
-    result.m22 = m20 * other.m02 + m21 * other.m12 + m22 * other.m22 + m23 * other.m32;
-    result.m23 = m20 * other.m03 + m21 * other.m13 + m22 * other.m23 + m23 * other.m33;
-
-    result.m30 = m30 * other.m00 + m31 * other.m10 + m32 * other.m20 + m33 * other.m30;
-    result.m31 = m30 * other.m01 + m31 * other.m11 + m32 * other.m21 + m33 * other.m31;
-    result.m32 = m30 * other.m02 + m31 * other.m12 + m32 * other.m22 + m33 * other.m32;
-    result.m33 = m30 * other.m03 + m31 * other.m13 + m32 * other.m23 + m33 * other.m33;
-
-    return result;
-}
-
-Matrix4 Matrix4::operator*(float scalar) const
-{
-    Matrix4 result;
-    for (int i = 0; i < 16; ++i)
-        result.m[i] = m[i] * scalar;
+    Math::SIMD::MulMatrix4(m, other.m, result.m);
     return result;
 }
 
 Vector4 Matrix4::operator*(const Vector4 &vec) const
 {
-    return Vector4(
-        m00 * vec.x + m01 * vec.y + m02 * vec.z + m03 * vec.w,
-        m10 * vec.x + m11 * vec.y + m12 * vec.z + m13 * vec.w,
-        m20 * vec.x + m21 * vec.y + m22 * vec.z + m23 * vec.w,
-        m30 * vec.x + m31 * vec.y + m32 * vec.z + m33 * vec.w);
+    float v[4] = {vec.x, vec.y, vec.z, vec.w};
+    float r[4];
+    Math::SIMD::TransformVec4(m, v, r);
+    return Vector4(r[0], r[1], r[2], r[3]);
 }
 
 Vector3 Matrix4::operator*(const Vector3 &vec) const
 {
     // 假设向量的w分量为1（点）
-    float w = m30 * vec.x + m31 * vec.y + m32 * vec.z + m33;
+    float v[4] = {vec.x, vec.y, vec.z, 1.0f};
+    float r[4];
+    Math::SIMD::TransformVec4(m, v, r);
+
+    float w = r[3];
     if (Math::IsZero(w))
         w = 1.0f;
-    return Vector3(
-        (m00 * vec.x + m01 * vec.y + m02 * vec.z + m03) / w,
-        (m10 * vec.x + m11 * vec.y + m12 * vec.z + m13) / w,
-        (m20 * vec.x + m21 * vec.y + m22 * vec.z + m23) / w);
+    return Vector3(r[0] / w, r[1] / w, r[2] / w);
 }
 
 // 赋值运算
-Matrix4 &Matrix4::operator+=(const Matrix4 &other)
-{
-    for (int i = 0; i < 16; ++i)
-        m[i] += other.m[i];
-    return *this;
-}
-
-Matrix4 &Matrix4::operator-=(const Matrix4 &other)
-{
-    for (int i = 0; i < 16; ++i)
-        m[i] -= other.m[i];
-    return *this;
-}
-
 Matrix4 &Matrix4::operator*=(const Matrix4 &other)
 {
     *this = *this * other;
     return *this;
 }
 
-Matrix4 &Matrix4::operator*=(float scalar)
-{
-    for (int i = 0; i < 16; ++i)
-        m[i] *= scalar;
-    return *this;
-}
-
-// 比较运算符
-bool Matrix4::operator==(const Matrix4 &other) const
-{
-    for (int i = 0; i < 16; ++i)
-        if (!Math::FloatEqual(m[i], other.m[i]))
-            return false;
-    return true;
-}
-
-bool Matrix4::operator!=(const Matrix4 &other) const
-{
-    return !(*this == other);
-}
-
 // 矩阵操作
-float Matrix4::Minor(int r0, int r1, int r2, int c0, int c1, int c2) const
-{
-    return m[r0 * 4 + c0] * (m[r1 * 4 + c1] * m[r2 * 4 + c2] - m[r2 * 4 + c1] * m[r1 * 4 + c2]) - m[r0 * 4 + c1] * (m[r1 * 4 + c0] * m[r2 * 4 + c2] - m[r2 * 4 + c0] * m[r1 * 4 + c2]) + m[r0 * 4 + c2] * (m[r1 * 4 + c0] * m[r2 * 4 + c1] - m[r2 * 4 + c0] * m[r1 * 4 + c1]);
-}
-
-float Matrix4::Cofactor(int row, int col) const
-{
-    int r0 = (row == 0) ? 1 : 0;
-    int r1 = (row <= 1) ? 2 : 1;
-    int r2 = (row <= 2) ? 3 : 2;
-
-    int c0 = (col == 0) ? 1 : 0;
-    int c1 = (col <= 1) ? 2 : 1;
-    int c2 = (col <= 2) ? 3 : 2;
-
-    float minor = Minor(r0, r1, r2, c0, c1, c2);
-    return ((row + col) % 2 == 0) ? minor : -minor;
-}
-
 float Matrix4::Determinant() const
 {
-    return m00 * Cofactor(0, 0) + m01 * Cofactor(0, 1) + m02 * Cofactor(0, 2) + m03 * Cofactor(0, 3);
-}
+    // 2x2 子式展开（Laplace），与 InverseMatrix4 使用同一组子式
+    float s0 = m[0] * m[5] - m[4] * m[1];
+    float s1 = m[0] * m[6] - m[4] * m[2];
+    float s2 = m[0] * m[7] - m[4] * m[3];
+    float s3 = m[1] * m[6] - m[5] * m[2];
+    float s4 = m[1] * m[7] - m[5] * m[3];
+    float s5 = m[2] * m[7] - m[6] * m[3];
 
-Matrix4 Matrix4::Transposed() const
-{
-    return Matrix4(
-        m00, m10, m20, m30,
-        m01, m11, m21, m31,
-        m02, m12, m22, m32,
-        m03, m13, m23, m33);
-}
+    float c5 = m[10] * m[15] - m[14] * m[11];
+    float c4 = m[9] * m[15] - m[13] * m[11];
+    float c3 = m[9] * m[14] - m[13] * m[10];
+    float c2 = m[8] * m[15] - m[12] * m[11];
+    float c1 = m[8] * m[14] - m[12] * m[10];
+    float c0 = m[8] * m[13] - m[12] * m[9];
 
-Matrix4 &Matrix4::Transpose()
-{
-    *this = this->Transposed();
-    return *this;
+    return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
 }
 
 Matrix4 Matrix4::Inversed() const
 {
-    float det = Determinant();
-    if (Math::IsZero(det))
-        return Identity();
-
-    float invDet = 1.0f / det;
     Matrix4 result;
-
-    for (int i = 0; i < 4; ++i)
-        for (int j = 0; j < 4; ++j)
-            result(i, j) = Cofactor(j, i) * invDet; // 注意：转置伴随矩阵
-
+    float det = Math::SIMD::InverseMatrix4(m, result.m);
+    if (det == 0.0f) // 奇异矩阵
+        return Identity();
     return result;
 }
 
@@ -204,74 +76,23 @@ Matrix4 &Matrix4::Inverse()
     return *this;
 }
 
-bool Matrix4::IsIdentity() const
+Matrix4 Matrix4::InversedAffine() const
 {
-    return (*this == Identity());
-}
-
-bool Matrix4::IsZero() const
-{
-    for (int i = 0; i < 16; ++i)
-        if (!Math::IsZero(m[i]))
-            return false;
-    return true;
-}
-
-// 获取行/列
-Vector4 Matrix4::GetRow(int row) const
-{
-    return Vector4(m4[0][row], m4[1][row], m4[2][row], m4[3][row]);
-}
-
-Vector4 Matrix4::GetColumn(int col) const
-{
-    return Vector4(m4[col][0], m4[col][1], m4[col][2], m4[col][3]);
-}
-
-void Matrix4::SetRow(int row, const Vector4 &vec)
-{
-    m4[0][row] = vec.x;
-    m4[1][row] = vec.y;
-    m4[2][row] = vec.z;
-    m4[3][row] = vec.w;
+    // 仅适用于最后一行为 (0, 0, 0, 1) 的矩阵（TRS/刚体/视图），投影矩阵请用 Inversed()
+    Matrix4 result;
+    float det = Math::SIMD::InverseAffine(m, result.m);
+    if (det == 0.0f) // 奇异矩阵
+        return Identity();
+    return result;
 }
 
-void Matrix4::SetColumn(int col, const Vector4 &vec)
+Matrix4 &Matrix4::InverseAffine()
 {
-    m4[col][0] = vec.x;
-    m4[col][1] = vec.y;
-    m4[col][2] = vec.z;
-    m4[col][3] = vec.w;
+    *this = this->InversedAffine();
+    return *this;
 }
 
 // 变换矩阵
-Matrix4 Matrix4::Identity()
-{
-    return Matrix4(
-        1.0f, 0.0f, 0.0f, 0.0f,
-        0.0f, 1.0f, 0.0f, 0.0f,
-        0.0f, 0.0f, 1.0f, 0.0f,
-        0.0f, 0.0f, 0.0f, 1.0f);
-}
-
-Matrix4 Matrix4::Zero()
-{
-    return Matrix4(
-        0.0f, 0.0f, 0.0f, 0.0f,
-        0.0f, 0.0f, 0.0f, 0.0f,
-        0.0f, 0.0f, 0.0f, 0.0f,
-        0.0f, 0.0f, 0.0f, 0.0f);
-}
-
-Matrix4 Matrix4::Translation(const Vector3 &translation)
-{
-    return Matrix4(
-        1.0f, 0.0f, 0.0f, translation.x,
-        0.0f, 1.0f, 0.0f, translation.y,
-        0.0f, 0.0f, 1.0f, translation.z,
-        0.0f, 0.0f, 0.0f, 1.0f);
-}
-
 Matrix4 Matrix4::RotationX(float angle)
 {
     float c = cosf(angle);
@@ -346,20 +167,6 @@ Matrix4 Matrix4::Rotation(const Quaternion &q)
         0.0f, 0.0f, 0.0f, 1.0f);
 }
 
-Matrix4 Matrix4::Scale(const Vector3 &scale)
-{
-    return Matrix4(
-        scale.x, 0.0f, 0.0f, 0.0f,
-        0.0f, scale.y, 0.0f, 0.0f,
-        0.0f, 0.0f, scale.z, 0.0f,
-        0.0f, 0.0f, 0.0f, 1.0f);
-}
-
-Matrix4 Matrix4::Scale(float scale)
-{
-    return Scale(Vector3(scale, scale, scale));
-}
-
 // 视图矩阵
 Matrix4 Matrix4::LookAt(const Vector3 &eye, const Vector3 &target, const Vector3 &up)
 {
@@ -387,10 +194,14 @@ Matrix4 Matrix4::LookAt(const Vector3 &eye, const Vector3 &target, const Vector3
 // TRS 矩阵（平移*旋转*缩放）
 Matrix4 Matrix4::TRS(const Vector3& translation, const Quaternion& rotation, const Vector3& scale)
 {
-    Matrix4 s = Scale(scale);
-    Matrix4 r = Rotation(rotation);
-    Matrix4 t = Translation(translation);
-    return t * r * s;  // OpenGL: 先缩放，再旋转，最后平移
+    // OpenGL: 先缩放，再旋转，最后平移；等价于 Translation * Rotation * Scale 的闭式展开
+    float t[3] = {translation.x, translation.y, translation.z};
+    float q[4] = {rotation.x, rotation.y, rotation.z, rotation.w};
+    float s[3] = {scale.x, scale.y, scale.z};
+
+    Matrix4 result;
+    Math::SIMD::ComposeTRS(t, q, s, result.m);
+    return result;
 }
 
 // 投影矩阵
@@ -433,11 +244,6 @@ Matrix4 Matrix4::Perspective(float fovY, float aspect, float nearClip, float far
 }
 
 // 分解矩阵
-Vector3 Matrix4::GetTranslation() const
-{
-    return Vector3(m03, m13, m23);
-}
-
 Vector3 Matrix4::GetScale() const
 {
     return Vector3(
@@ -446,16 +252,6 @@ Vector3 Matrix4::GetScale() const
         Vector3(m02, m12, m22).Length());
 }
 
-// 插值
-Matrix4 Matrix4::Lerp(const Matrix4 &a, const Matrix4 &b, float t)
-{
-    t = Math::Clamp(t, 0.0f, 1.0f);
-    Matrix4 result;
-    for (int i = 0; i < 16; ++i)
-        result.m[i] = a.m[i] + (b.m[i] - a.m[i]) * t;
-    return result;
-}
-
 // 字符串表示
 std::string Matrix4::ToString() const
 {
@@ -466,4 +262,32 @@ std::string Matrix4::ToString() const
     ss << "[" << m20 << ", " << m21 << ", " << m22 << ", " << m23 << "]" << std::endl;
     ss << "[" << m30 << ", " << m31 << ", " << m32 << ", " << m33 << "]" << std::endl;
     return ss.str();
-}
\ No newline at end of file
+}
+
+// ======================================================================
+// 编译期自检：常量变换在编译期折叠，存储顺序与行优先构造参数一致
+// ======================================================================
+#if MATH_HAS_CONSTEXPR
+namespace
+{
+    constexpr Vector3 kAxisSum = Vector3::UnitX() + Vector3::UnitY() * 2.0f + 3.0f * Vector3::UnitZ();
+    static_assert(kAxisSum == Vector3(1.0f, 2.0f, 3.0f), "Vector3 arithmetic");
+    static_assert(Vector3::Cross(Vector3::Right(), Vector3::Up()) == Vector3(0.0f, 0.0f, 1.0f), "Vector3::Cross");
+    static_assert(Vector3::Dot(kAxisSum, kAxisSum) == 14.0f, "Vector3::Dot");
+    static_assert(Vector3::Lerp(Vector3::Zero(), kAxisSum, 0.5f) == Vector3(0.5f, 1.0f, 1.5f), "Vector3::Lerp");
+    static_assert(Vector4(kAxisSum, 1.0f).XYZ() == kAxisSum, "Vector4::XYZ");
+    static_assert(Vector2(3.0f, 4.0f).LengthSquared() == 25.0f, "Vector2::LengthSquared");
+
+    constexpr Matrix4 kTranslation = Matrix4::Translation(Vector3(1.0f, 2.0f, 3.0f));
+    static_assert(kTranslation.m[12] == 1.0f && kTranslation.m[13] == 2.0f && kTranslation.m[14] == 3.0f,
+                  "Matrix4 column-major storage");
+    static_assert(kTranslation(0, 3) == 1.0f && kTranslation(3, 3) == 1.0f, "Matrix4::operator()");
+    static_assert(kTranslation.GetTranslation() == Vector3(1.0f, 2.0f, 3.0f), "Matrix4::GetTranslation");
+    static_assert(kTranslation.GetColumn(3) == Vector4(1.0f, 2.0f, 3.0f, 1.0f), "Matrix4::GetColumn");
+    static_assert(kTranslation.Transposed().GetRow(3) == Vector4(1.0f, 2.0f, 3.0f, 1.0f), "Matrix4::Transposed");
+    static_assert(kTranslation.IsAffine() && !kTranslation.IsIdentity(), "Matrix4::IsAffine");
+    static_assert(Matrix4().IsIdentity() && Matrix4::Zero().IsZero(), "Matrix4 Identity/Zero");
+    static_assert(Matrix4(3.0f) - Matrix4(1.0f) == Matrix4(2.0f) && Matrix4(1.0f) * 2.0f == Matrix4(2.0f), "Matrix4 add/sub/scale");
+    static_assert(Matrix4::Lerp(Matrix4::Zero(), Matrix4::Identity() * 2.0f, 0.5f).IsIdentity(), "Matrix4::Lerp");
+}
+#endif
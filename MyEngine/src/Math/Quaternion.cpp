@@ -4,11 +4,6 @@
 #include <sstream>
 
 // 构造函数
-Quaternion::Quaternion() : x(0), y(0), z(0), w(1) {}
-
-Quaternion::Quaternion(float _x, float _y, float _z, float _w) 
-    : x(_x), y(_y), z(_z), w(_w) {}
-
 Quaternion::Quaternion(const Vector3& axis, float angle)
 {
     float halfAngle = angle * 0.5f;
@@ -38,57 +33,6 @@ Quaternion::Quaternion(float pitch, float yaw, float roll)
     z = cy * cp * sr - sy * sp * cr;
 }
 
-// 运算
-Quaternion Quaternion::operator+(const Quaternion& other) const
-{
-    return Quaternion(x + other.x, y + other.y, z + other.z, w + other.w);
-}
-
-Quaternion Quaternion::operator-(const Quaternion& other) const
-{
-    return Quaternion(x - other.x, y - other.y, z - other.z, w - other.w);
-}
-
-Quaternion Quaternion::operator*(const Quaternion& other) const
-{
-    return Quaternion(
-        w * other.x + x * other.w + y * other.z - z * other.y,
-        w * other.y + y * other.w + z * other.x - x * other.z,
-        w * other.z + z * other.w + x * other.y - y * other.x,
-        w * other.w - x * other.x - y * other.y - z * other.z
-    );
-}
-
-Quaternion Quaternion::operator*(float scalar) const
-{
-    return Quaternion(x * scalar, y * scalar, z * scalar, w * scalar);
-}
-
-Vector3 Quaternion::operator*(const Vector3& vec) const
-{
-    // 使用四元数旋转向量
-    Quaternion v(vec.x, vec.y, vec.z, 0.0f);
-    Quaternion conjugate = Conjugate();
-    Quaternion result = (*this) * v * conjugate;
-    return Vector3(result.x, result.y, result.z);
-}
-
-// 共轭/逆
-Quaternion Quaternion::Conjugate() const
-{
-    return Quaternion(-x, -y, -z, w);
-}
-
-Quaternion Quaternion::Inverse() const
-{
-    float lenSq = LengthSquared();
-    if (Math::IsZero(lenSq))
-        return Identity();
-    
-    float invLenSq = 1.0f / lenSq;
-    return Conjugate() * invLenSq;
-}
-
 // 归一化
 Quaternion Quaternion::Normalized() const
 {
@@ -125,17 +69,6 @@ float Quaternion::Length() const
     return sqrtf(LengthSquared());
 }
 
-float Quaternion::LengthSquared() const
-{
-    return x * x + y * y + z * z + w * w;
-}
-
-// 点积
-float Quaternion::Dot(const Quaternion& other) const
-{
-    return x * other.x + y * other.y + z * other.z + w * other.w;
-}
-
 // 插值
 Quaternion Quaternion::Slerp(const Quaternion& q1, const Quaternion& q2, float t)
 {
@@ -166,12 +99,6 @@ Quaternion Quaternion::Slerp(const Quaternion& q1, const Quaternion& q2, float t
     return q1 * ratioA + q2_temp * ratioB;
 }
 
-Quaternion Quaternion::Lerp(const Quaternion& q1, const Quaternion& q2, float t)
-{
-    t = Math::Clamp(t, 0.0f, 1.0f);
-    return q1 + (q2 - q1) * t;
-}
-
 Quaternion Quaternion::Nlerp(const Quaternion& q1, const Quaternion& q2, float t)
 {
     return Lerp(q1, q2, t).Normalized();
@@ -264,41 +191,21 @@ Matrix4 Quaternion::ToMatrix() const
     return Matrix4::Rotation(*this);
 }
 
-// 常用四元数
-Quaternion Quaternion::Identity()
-{
-    return Quaternion(0.0f, 0.0f, 0.0f, 1.0f);
-}
-
-Quaternion Quaternion::Zero()
+// ======================================================================
+// 编译期自检
+// ======================================================================
+#if MATH_HAS_CONSTEXPR
+namespace
 {
-    return Quaternion(0.0f, 0.0f, 0.0f, 0.0f);
-}
+    // 绕 Z 轴 90 度：(0, 0, sin45, cos45)
+    constexpr float kHalfSqrt2 = 0.70710678f;
+    constexpr Quaternion kRotZ90(0.0f, 0.0f, kHalfSqrt2, kHalfSqrt2);
 
-// 方向
-Vector3 Quaternion::Forward(const Quaternion& q)
-{
-    return Vector3(
-        2.0f * (q.x * q.z + q.w * q.y),
-        2.0f * (q.y * q.z - q.w * q.x),
-        1.0f - 2.0f * (q.x * q.x + q.y * q.y)
-    );
+    static_assert(Quaternion().Dot(Quaternion::Identity()) == 1.0f, "Quaternion default is identity");
+    static_assert((kRotZ90 * kRotZ90).z == 2.0f * kHalfSqrt2 * kHalfSqrt2, "Quaternion::operator*");
+    static_assert((kRotZ90 * Vector3::UnitX() - Vector3::UnitY()).LengthSquared() < 1e-10f, "Quaternion rotates vector");
+    static_assert((Quaternion::Right(kRotZ90) - Vector3::UnitY()).LengthSquared() < 1e-10f, "Quaternion::Right");
+    static_assert((kRotZ90 * kRotZ90.Inverse()).Dot(Quaternion::Identity()) > 1.0f - Math::EPSILON, "Quaternion::Inverse");
+    static_assert(Quaternion::Lerp(Quaternion::Zero(), Quaternion::Identity(), 0.5f).w == 0.5f, "Quaternion::Lerp");
 }
-
-Vector3 Quaternion::Right(const Quaternion& q)
-{
-    return Vector3(
-        1.0f - 2.0f * (q.y * q.y + q.z * q.z),
-        2.0f * (q.x * q.y + q.w * q.z),
-        2.0f * (q.x * q.z - q.w * q.y)
-    );
-}
-
-Vector3 Quaternion::Up(const Quaternion& q)
-{
-    return Vector3(
-        2.0f * (q.x * q.y - q.w * q.z),
-        1.0f - 2.0f * (q.x * q.x + q.z * q.z),
-        2.0f * (q.y * q.z + q.w * q.x)
-    );
-}
\ No newline at end of file
+#endif
@@ -0,0 +1,323 @@
+#include "stdafx.h"
+#include "Math/QuaternionBatch.h"
+#include "Math/MathSIMD.h"
+
+namespace Math
+{
+namespace Batch
+{
+    // ======================================================================
+    // SoA 存储
+    // ======================================================================
+    void QuaternionSoA::FromAoS(const Quaternion *src, size_t count)
+    {
+        Resize(count);
+        for (size_t i = 0; i < count; ++i)
+            Set(i, src[i]);
+    }
+
+    void QuaternionSoA::ToAoS(Quaternion *dst) const
+    {
+        for (size_t i = 0; i < x.size(); ++i)
+            dst[i] = Get(i);
+    }
+
+    namespace
+    {
+        // ======================================================================
+        // Eberly 多项式 Slerp 系数
+        // sin(tθ)/sin(θ) 在 cosθ = 1 处的级数展开，末项用 (1 + μ) 修正截断误差
+        // ======================================================================
+        const int SLERP_TERMS = 8;
+        const float SLERP_ONE_PLUS_MU = 1.90110745351730037f;
+        const float SLERP_U[SLERP_TERMS] = {
+            1.0f / (1 * 3), 1.0f / (2 * 5), 1.0f / (3 * 7), 1.0f / (4 * 9),
+            1.0f / (5 * 11), 1.0f / (6 * 13), 1.0f / (7 * 15), SLERP_ONE_PLUS_MU / (8 * 17)};
+        const float SLERP_V[SLERP_TERMS] = {
+            1.0f / 3, 2.0f / 5, 3.0f / 7, 4.0f / 9,
+            5.0f / 11, 6.0f / 13, 7.0f / 15, SLERP_ONE_PLUS_MU * 8 / 17};
+
+        // 单个元素的 Slerp 权重（标量回退与尾部元素使用，与 SIMD 路径同一公式）
+        void SlerpWeights(float cs, float t, float &f0, float &f1)
+        {
+            float sign = 1.0f;
+            if (cs < 0.0f)
+            {
+                cs = -cs;
+                sign = -1.0f;
+            }
+            float csm1 = cs - 1.0f;
+            float term0 = 1.0f - t;
+            float term1 = t;
+            float sqr0 = term0 * term0;
+            float sqr1 = term1 * term1;
+            f0 = term0;
+            f1 = term1;
+            for (int i = 0; i < SLERP_TERMS; ++i)
+            {
+                term0 *= (SLERP_U[i] * sqr0 - SLERP_V[i]) * csm1;
+                term1 *= (SLERP_U[i] * sqr1 - SLERP_V[i]) * csm1;
+                f0 += term0;
+                f1 += term1;
+            }
+            f1 *= sign;
+        }
+
+        // ======================================================================
+        // 区间内核
+        // t 为 nullptr 时使用统一的 uniformT
+        // ======================================================================
+        void SlerpRange(const QuaternionSoA &a, const QuaternionSoA &b, const float *t, float uniformT,
+                        QuaternionSoA &out, size_t begin, size_t end)
+        {
+            size_t i = begin;
+#if defined(MATH_SIMD_SSE)
+            const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000));
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 zero = _mm_setzero_ps();
+            for (; i + 4 <= end; i += 4)
+            {
+                __m128 ax = _mm_loadu_ps(&a.x[i]), ay = _mm_loadu_ps(&a.y[i]), az = _mm_loadu_ps(&a.z[i]), aw = _mm_loadu_ps(&a.w[i]);
+                __m128 bx = _mm_loadu_ps(&b.x[i]), by = _mm_loadu_ps(&b.y[i]), bz = _mm_loadu_ps(&b.z[i]), bw = _mm_loadu_ps(&b.w[i]);
+                __m128 vt = t ? _mm_loadu_ps(t + i) : _mm_set1_ps(uniformT);
+                vt = _mm_min_ps(_mm_max_ps(vt, zero), one);
+
+                __m128 cs = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)),
+                                       _mm_add_ps(_mm_mul_ps(az, bz), _mm_mul_ps(aw, bw)));
+                // 点积为负时取反 b，走最短路径
+                __m128 sign = _mm_and_ps(cs, signMask);
+                cs = _mm_xor_ps(cs, sign);
+                __m128 csm1 = _mm_sub_ps(cs, one);
+
+                __m128 term0 = _mm_sub_ps(one, vt);
+                __m128 term1 = vt;
+                __m128 sqr0 = _mm_mul_ps(term0, term0);
+                __m128 sqr1 = _mm_mul_ps(term1, term1);
+                __m128 f0 = term0;
+                __m128 f1 = term1;
+                for (int k = 0; k < SLERP_TERMS; ++k)
+                {
+                    __m128 u = _mm_set1_ps(SLERP_U[k]);
+                    __m128 v = _mm_set1_ps(SLERP_V[k]);
+                    term0 = _mm_mul_ps(term0, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(u, sqr0), v), csm1));
+                    term1 = _mm_mul_ps(term1, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(u, sqr1), v), csm1));
+                    f0 = _mm_add_ps(f0, term0);
+                    f1 = _mm_add_ps(f1, term1);
+                }
+                f1 = _mm_xor_ps(f1, sign);
+
+                _mm_storeu_ps(&out.x[i], _mm_add_ps(_mm_mul_ps(ax, f0), _mm_mul_ps(bx, f1)));
+                _mm_storeu_ps(&out.y[i], _mm_add_ps(_mm_mul_ps(ay, f0), _mm_mul_ps(by, f1)));
+                _mm_storeu_ps(&out.z[i], _mm_add_ps(_mm_mul_ps(az, f0), _mm_mul_ps(bz, f1)));
+                _mm_storeu_ps(&out.w[i], _mm_add_ps(_mm_mul_ps(aw, f0), _mm_mul_ps(bw, f1)));
+            }
+#endif
+            for (; i < end; ++i)
+            {
+                float ti = Math::Clamp(t ? t[i] : uniformT, 0.0f, 1.0f);
+                float cs = a.x[i] * b.x[i] + a.y[i] * b.y[i] + a.z[i] * b.z[i] + a.w[i] * b.w[i];
+                float f0, f1;
+                SlerpWeights(cs, ti, f0, f1);
+                float rx = a.x[i] * f0 + b.x[i] * f1;
+                float ry = a.y[i] * f0 + b.y[i] * f1;
+                float rz = a.z[i] * f0 + b.z[i] * f1;
+                float rw = a.w[i] * f0 + b.w[i] * f1;
+                out.x[i] = rx;
+                out.y[i] = ry;
+                out.z[i] = rz;
+                out.w[i] = rw;
+            }
+        }
+
+        // 归一化；长度过小时置为单位四元数，与 Quaternion::Normalized 一致
+        void NormalizeRange(float *x, float *y, float *z, float *w, size_t begin, size_t end)
+        {
+            size_t i = begin;
+#if defined(MATH_SIMD_SSE)
+            const __m128 eps = _mm_set1_ps(Math::EPSILON);
+            const __m128 one = _mm_set1_ps(1.0f);
+            for (; i + 4 <= end; i += 4)
+            {
+                __m128 vx = _mm_loadu_ps(x + i), vy = _mm_loadu_ps(y + i), vz = _mm_loadu_ps(z + i), vw = _mm_loadu_ps(w + i);
+                __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)),
+                                                    _mm_add_ps(_mm_mul_ps(vz, vz), _mm_mul_ps(vw, vw))));
+                __m128 valid = _mm_cmpgt_ps(len, eps);
+                __m128 inv = _mm_and_ps(_mm_div_ps(one, len), valid);
+                _mm_storeu_ps(x + i, _mm_mul_ps(vx, inv));
+                _mm_storeu_ps(y + i, _mm_mul_ps(vy, inv));
+                _mm_storeu_ps(z + i, _mm_mul_ps(vz, inv));
+                _mm_storeu_ps(w + i, _mm_or_ps(_mm_mul_ps(vw, inv), _mm_andnot_ps(valid, one)));
+            }
+#endif
+            for (; i < end; ++i)
+            {
+                Quaternion q = Quaternion(x[i], y[i], z[i], w[i]).Normalized();
+                x[i] = q.x;
+                y[i] = q.y;
+                z[i] = q.z;
+                w[i] = q.w;
+            }
+        }
+
+        void NlerpRange(const QuaternionSoA &a, const QuaternionSoA &b, const float *t, float uniformT,
+                        QuaternionSoA &out, size_t begin, size_t end)
+        {
+            size_t i = begin;
+#if defined(MATH_SIMD_SSE)
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 zero = _mm_setzero_ps();
+            for (; i + 4 <= end; i += 4)
+            {
+                __m128 vt = t ? _mm_loadu_ps(t + i) : _mm_set1_ps(uniformT);
+                vt = _mm_min_ps(_mm_max_ps(vt, zero), one);
+                __m128 ax = _mm_loadu_ps(&a.x[i]), ay = _mm_loadu_ps(&a.y[i]), az = _mm_loadu_ps(&a.z[i]), aw = _mm_loadu_ps(&a.w[i]);
+                _mm_storeu_ps(&out.x[i], _mm_add_ps(ax, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&b.x[i]), ax), vt)));
+                _mm_storeu_ps(&out.y[i], _mm_add_ps(ay, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&b.y[i]), ay), vt)));
+                _mm_storeu_ps(&out.z[i], _mm_add_ps(az, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&b.z[i]), az), vt)));
+                _mm_storeu_ps(&out.w[i], _mm_add_ps(aw, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&b.w[i]), aw), vt)));
+            }
+#endif
+            for (; i < end; ++i)
+            {
+                float ti = Math::Clamp(t ? t[i] : uniformT, 0.0f, 1.0f);
+                out.x[i] = a.x[i] + (b.x[i] - a.x[i]) * ti;
+                out.y[i] = a.y[i] + (b.y[i] - a.y[i]) * ti;
+                out.z[i] = a.z[i] + (b.z[i] - a.z[i]) * ti;
+                out.w[i] = a.w[i] + (b.w[i] - a.w[i]) * ti;
+            }
+            NormalizeRange(&out.x[0], &out.y[0], &out.z[0], &out.w[0], begin, end);
+        }
+
+        void FromEulerRange(const Vector3SoA &eulers, QuaternionSoA &out, size_t begin, size_t end)
+        {
+            size_t i = begin;
+#if defined(MATH_SIMD_SSE)
+            const __m128 half = _mm_set1_ps(0.5f);
+            for (; i + 4 <= end; i += 4)
+            {
+                __m128 sp, cp, sy, cy, sr, cr;
+                SIMD::SinCos4(_mm_mul_ps(_mm_loadu_ps(&eulers.x[i]), half), &sp, &cp);
+                SIMD::SinCos4(_mm_mul_ps(_mm_loadu_ps(&eulers.y[i]), half), &sy, &cy);
+                SIMD::SinCos4(_mm_mul_ps(_mm_loadu_ps(&eulers.z[i]), half), &sr, &cr);
+
+                __m128 cycp = _mm_mul_ps(cy, cp), sysp = _mm_mul_ps(sy, sp);
+                __m128 cysp = _mm_mul_ps(cy, sp), sycp = _mm_mul_ps(sy, cp);
+
+                _mm_storeu_ps(&out.w[i], _mm_add_ps(_mm_mul_ps(cycp, cr), _mm_mul_ps(sysp, sr)));
+                _mm_storeu_ps(&out.x[i], _mm_add_ps(_mm_mul_ps(cysp, cr), _mm_mul_ps(sycp, sr)));
+                _mm_storeu_ps(&out.y[i], _mm_sub_ps(_mm_mul_ps(sycp, cr), _mm_mul_ps(cysp, sr)));
+                _mm_storeu_ps(&out.z[i], _mm_sub_ps(_mm_mul_ps(cycp, sr), _mm_mul_ps(sysp, cr)));
+            }
+#endif
+            for (; i < end; ++i)
+                out.Set(i, Quaternion::FromEuler(eulers.x[i], eulers.y[i], eulers.z[i]));
+        }
+
+        void ToMatrixRange(const QuaternionSoA &q, Matrix4 *out, size_t begin, size_t end)
+        {
+            size_t i = begin;
+#if defined(MATH_SIMD_SSE)
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 two = _mm_set1_ps(2.0f);
+            const __m128 lastColumn = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+            for (; i + 4 <= end; i += 4)
+            {
+                __m128 x = _mm_loadu_ps(&q.x[i]), y = _mm_loadu_ps(&q.y[i]), z = _mm_loadu_ps(&q.z[i]), w = _mm_loadu_ps(&q.w[i]);
+                __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+                __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+                __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+                // 与 Matrix4::Rotation(const Quaternion&) 相同的 9 个元素（每个寄存器 4 个四元数）
+                __m128 c0[4] = {_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))),
+                                _mm_mul_ps(two, _mm_add_ps(xy, wz)),
+                                _mm_mul_ps(two, _mm_sub_ps(xz, wy)),
+                                _mm_setzero_ps()};
+                __m128 c1[4] = {_mm_mul_ps(two, _mm_sub_ps(xy, wz)),
+                                _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))),
+                                _mm_mul_ps(two, _mm_add_ps(yz, wx)),
+                                _mm_setzero_ps()};
+                __m128 c2[4] = {_mm_mul_ps(two, _mm_add_ps(xz, wy)),
+                                _mm_mul_ps(two, _mm_sub_ps(yz, wx)),
+                                _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))),
+                                _mm_setzero_ps()};
+
+                // 转置后第 k 个寄存器即第 k 个矩阵的该列
+                _MM_TRANSPOSE4_PS(c0[0], c0[1], c0[2], c0[3]);
+                _MM_TRANSPOSE4_PS(c1[0], c1[1], c1[2], c1[3]);
+                _MM_TRANSPOSE4_PS(c2[0], c2[1], c2[2], c2[3]);
+                for (int k = 0; k < 4; ++k)
+                {
+                    float *m = out[i + k].m;
+                    _mm_storeu_ps(m + 0, c0[k]);
+                    _mm_storeu_ps(m + 4, c1[k]);
+                    _mm_storeu_ps(m + 8, c2[k]);
+                    _mm_storeu_ps(m + 12, lastColumn);
+                }
+            }
+#endif
+            for (; i < end; ++i)
+                out[i] = Matrix4::Rotation(q.Get(i));
+        }
+    }
+
+    // ======================================================================
+    // 插值
+    // ======================================================================
+    void Slerp(const QuaternionSoA &a, const QuaternionSoA &b, float t, QuaternionSoA &out)
+    {
+        out.Resize(a.Size());
+        Dispatch(a.Size(), [&](size_t begin, size_t end) {
+            SlerpRange(a, b, nullptr, t, out, begin, end);
+        });
+    }
+
+    void Slerp(const QuaternionSoA &a, const QuaternionSoA &b, const float *t, QuaternionSoA &out)
+    {
+        out.Resize(a.Size());
+        Dispatch(a.Size(), [&](size_t begin, size_t end) {
+            SlerpRange(a, b, t, 0.0f, out, begin, end);
+        });
+    }
+
+    void Nlerp(const QuaternionSoA &a, const QuaternionSoA &b, float t, QuaternionSoA &out)
+    {
+        out.Resize(a.Size());
+        Dispatch(a.Size(), [&](size_t begin, size_t end) {
+            NlerpRange(a, b, nullptr, t, out, begin, end);
+        });
+    }
+
+    void Nlerp(const QuaternionSoA &a, const QuaternionSoA &b, const float *t, QuaternionSoA &out)
+    {
+        out.Resize(a.Size());
+        Dispatch(a.Size(), [&](size_t begin, size_t end) {
+            NlerpRange(a, b, t, 0.0f, out, begin, end);
+        });
+    }
+
+    // ======================================================================
+    // 转换
+    // ======================================================================
+    void Normalize(QuaternionSoA &q)
+    {
+        Dispatch(q.Size(), [&](size_t begin, size_t end) {
+            NormalizeRange(&q.x[0], &q.y[0], &q.z[0], &q.w[0], begin, end);
+        });
+    }
+
+    void FromEuler(const Vector3SoA &eulers, QuaternionSoA &out)
+    {
+        out.Resize(eulers.Size());
+        Dispatch(eulers.Size(), [&](size_t begin, size_t end) {
+            FromEulerRange(eulers, out, begin, end);
+        });
+    }
+
+    void ToMatrix(const QuaternionSoA &q, Matrix4 *out)
+    {
+        Dispatch(q.Size(), [&](size_t begin, size_t end) {
+            ToMatrixRange(q, out, begin, end);
+        });
+    }
+}
+}
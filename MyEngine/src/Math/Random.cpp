@@ -0,0 +1,283 @@
+#include "stdafx.h"
+#include "Math/Random.h"
+#include "Math/MathSIMD.h"
+#include <atomic>
+
+namespace Math
+{
+    namespace
+    {
+        // 前进 2^64 / 2^96 步的跳跃多项式（xoshiro128 参考实现）
+        const uint32_t JUMP[4] = {0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b};
+        const uint32_t LONG_JUMP[4] = {0xb523952e, 0x0b6f099f, 0xccf5a0ef, 0x1c580662};
+
+        uint64_t SplitMix64(uint64_t &x)
+        {
+            uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31);
+        }
+
+        void Step(uint32_t s[4])
+        {
+            uint32_t t = s[1] << 9;
+            s[2] ^= s[0];
+            s[3] ^= s[1];
+            s[1] ^= s[2];
+            s[0] ^= s[3];
+            s[2] ^= t;
+            s[3] = (s[3] << 11) | (s[3] >> 21);
+        }
+
+        void Jump(uint32_t s[4], const uint32_t poly[4])
+        {
+            uint32_t r[4] = {0, 0, 0, 0};
+            for (int i = 0; i < 4; ++i)
+            {
+                for (int b = 0; b < 32; ++b)
+                {
+                    if (poly[i] & (1u << b))
+                    {
+                        r[0] ^= s[0];
+                        r[1] ^= s[1];
+                        r[2] ^= s[2];
+                        r[3] ^= s[3];
+                    }
+                    Step(s);
+                }
+            }
+            s[0] = r[0];
+            s[1] = r[1];
+            s[2] = r[2];
+            s[3] = r[3];
+        }
+
+        // ======================================================================
+        // 4 路交错生成：第 i 个结果来自子流 i % 4 的第 i / 4 次输出
+        // ======================================================================
+#if defined(MATH_SIMD_SSE)
+        inline __m128i NextLanes(__m128i s[4])
+        {
+            __m128i result = _mm_add_epi32(s[0], s[3]);
+            __m128i t = _mm_slli_epi32(s[1], 9);
+            s[2] = _mm_xor_si128(s[2], s[0]);
+            s[3] = _mm_xor_si128(s[3], s[1]);
+            s[1] = _mm_xor_si128(s[1], s[2]);
+            s[0] = _mm_xor_si128(s[0], s[3]);
+            s[2] = _mm_xor_si128(s[2], t);
+            s[3] = _mm_or_si128(_mm_slli_epi32(s[3], 11), _mm_srli_epi32(s[3], 21));
+            return result;
+        }
+#endif
+
+        inline void NextLanes(uint32_t lanes[4][4], uint32_t out[4])
+        {
+            for (int k = 0; k < 4; ++k)
+            {
+                uint32_t s[4] = {lanes[0][k], lanes[1][k], lanes[2][k], lanes[3][k]};
+                out[k] = s[0] + s[3];
+                Step(s);
+                lanes[0][k] = s[0];
+                lanes[1][k] = s[1];
+                lanes[2][k] = s[2];
+                lanes[3][k] = s[3];
+            }
+        }
+
+        // op.Store4(i, bits) 写出完整的 4 个；op.Store(i, bits, n) 写出尾部 n 个
+        template <typename Op>
+        void Generate(uint32_t lanes[4][4], size_t count, const Op &op)
+        {
+            size_t i = 0;
+#if defined(MATH_SIMD_SSE)
+            __m128i s[4];
+            for (int w = 0; w < 4; ++w)
+                s[w] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lanes[w]));
+            for (; i + 4 <= count; i += 4)
+                op.Store4(i, NextLanes(s));
+            if (i < count)
+            {
+                uint32_t bits[4];
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(bits), NextLanes(s));
+                op.Store(i, bits, count - i);
+            }
+            for (int w = 0; w < 4; ++w)
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes[w]), s[w]);
+#else
+            for (; i < count; i += 4)
+            {
+                uint32_t bits[4];
+                NextLanes(lanes, bits);
+                op.Store(i, bits, count - i < 4 ? count - i : 4);
+            }
+#endif
+        }
+
+        struct UIntOp
+        {
+            uint32_t *out;
+
+#if defined(MATH_SIMD_SSE)
+            void Store4(size_t i, __m128i bits) const
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), bits);
+            }
+#endif
+            void Store(size_t i, const uint32_t *bits, size_t n) const
+            {
+                for (size_t k = 0; k < n; ++k)
+                    out[i + k] = bits[k];
+            }
+        };
+
+        // out = min + (bits >> 8) * 2^-24 * (max - min)
+        struct FloatOp
+        {
+            float *out;
+            float min;
+            float range;
+
+#if defined(MATH_SIMD_SSE)
+            void Store4(size_t i, __m128i bits) const
+            {
+                __m128 u = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(bits, 8)), _mm_set1_ps(1.0f / 16777216.0f));
+                _mm_storeu_ps(out + i, _mm_add_ps(_mm_set1_ps(min), _mm_mul_ps(u, _mm_set1_ps(range))));
+            }
+#endif
+            void Store(size_t i, const uint32_t *bits, size_t n) const
+            {
+                for (size_t k = 0; k < n; ++k)
+                    out[i + k] = min + (float)(bits[k] >> 8) * (1.0f / 16777216.0f) * range;
+            }
+        };
+
+        // Vector3 按 float 数组生成：第 j 个 float 属于分量 j % 3，每 12 个 float（3 组）循环一次
+        struct Vector3Op
+        {
+            float *out;
+            float min[3];
+            float range[3];
+#if defined(MATH_SIMD_SSE)
+            __m128 lo[3];
+            __m128 scale[3];
+            mutable int group; // 下一组 4 个 float 的起始分量
+
+            void Init()
+            {
+                for (int g = 0; g < 3; ++g)
+                {
+                    lo[g] = _mm_setr_ps(min[g], min[(g + 1) % 3], min[(g + 2) % 3], min[g]);
+                    scale[g] = _mm_setr_ps(range[g], range[(g + 1) % 3], range[(g + 2) % 3], range[g]);
+                }
+                group = 0;
+            }
+
+            void Store4(size_t i, __m128i bits) const
+            {
+                __m128 u = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(bits, 8)), _mm_set1_ps(1.0f / 16777216.0f));
+                _mm_storeu_ps(out + i, _mm_add_ps(lo[group], _mm_mul_ps(u, scale[group])));
+                group = group == 2 ? 0 : group + 1;
+            }
+#else
+            void Init() {}
+#endif
+            void Store(size_t i, const uint32_t *bits, size_t n) const
+            {
+                for (size_t k = 0; k < n; ++k)
+                {
+                    size_t c = (i + k) % 3;
+                    out[i + k] = min[c] + (float)(bits[k] >> 8) * (1.0f / 16777216.0f) * range[c];
+                }
+            }
+        };
+
+        // 线程默认流
+        std::atomic<uint64_t> g_globalSeed(RandomGenerator::DEFAULT_SEED);
+        std::atomic<uint32_t> g_nextStream(0);
+    }
+
+    const uint64_t RandomGenerator::DEFAULT_SEED;
+
+    void RandomGenerator::Seed(uint64_t seed, uint32_t stream)
+    {
+        uint64_t x = seed;
+        uint64_t a = SplitMix64(x);
+        uint64_t b = SplitMix64(x);
+        m_state[0] = (uint32_t)a;
+        m_state[1] = (uint32_t)(a >> 32);
+        m_state[2] = (uint32_t)b;
+        m_state[3] = (uint32_t)(b >> 32);
+        if ((m_state[0] | m_state[1] | m_state[2] | m_state[3]) == 0)
+            m_state[0] = 1; // 全零状态不可用
+
+        for (uint32_t i = 0; i < stream; ++i)
+            Jump(m_state, LONG_JUMP);
+
+        // 批量子流依次位于单个子流之后 1~4 个 2^64
+        uint32_t s[4] = {m_state[0], m_state[1], m_state[2], m_state[3]};
+        for (int k = 0; k < 4; ++k)
+        {
+            Jump(s, JUMP);
+            for (int w = 0; w < 4; ++w)
+                m_lanes[w][k] = s[w];
+        }
+    }
+
+    // ======================================================================
+    // 批量
+    // ======================================================================
+    void RandomGenerator::FillUInt(uint32_t *out, size_t count)
+    {
+        UIntOp op = {out};
+        Generate(m_lanes, count, op);
+    }
+
+    void RandomGenerator::Fill(float *out, size_t count)
+    {
+        Fill(out, count, 0.0f, 1.0f);
+    }
+
+    void RandomGenerator::Fill(float *out, size_t count, float min, float max)
+    {
+        FloatOp op = {out, min, max - min};
+        Generate(m_lanes, count, op);
+    }
+
+    void RandomGenerator::Fill(Vector3 *out, size_t count, const Vector3 &min, const Vector3 &max)
+    {
+        static_assert(sizeof(Vector3) == 3 * sizeof(float), "Vector3 必须紧密排列");
+        Vector3Op op;
+        op.out = reinterpret_cast<float *>(out);
+        op.min[0] = min.x;
+        op.min[1] = min.y;
+        op.min[2] = min.z;
+        op.range[0] = max.x - min.x;
+        op.range[1] = max.y - min.y;
+        op.range[2] = max.z - min.z;
+        op.Init();
+        Generate(m_lanes, count * 3, op);
+    }
+
+    // ======================================================================
+    // 线程默认流
+    // ======================================================================
+    RandomGenerator &RandomGenerator::ThreadLocal()
+    {
+        thread_local RandomGenerator generator(g_globalSeed.load(), g_nextStream.fetch_add(1));
+        return generator;
+    }
+
+    void RandomGenerator::SetGlobalSeed(uint64_t seed)
+    {
+        RandomGenerator &generator = ThreadLocal();
+        g_globalSeed.store(seed);
+        g_nextStream.store(1);
+        generator.Seed(seed, 0);
+    }
+
+    FLOAT Random()
+    {
+        return RandomGenerator::ThreadLocal().NextFloat();
+    }
+}
@@ -2,14 +2,29 @@
 // ======================================================================
 #include "stdafx.h"
 #include <cfloat>
+#include <atomic>
+#include <unordered_map>
 #include "Resources/Mesh.h"
 #include "Resources/Texture.h"
+#include "Core/GLStateCache.h"
+#include "Core/MeshSimplifier.h"
+#include "Math/MathBatch.h"
 // ======================================================================
 
+namespace
+{
+    std::atomic<uint32_t> s_nextMeshID(1); // 模型可能在工作线程中加载
+
+    // 三角形少于此数的网格不再生成更粗的级别
+    const size_t MIN_LOD_TRIANGLES = 32;
+}
+
+const size_t CMesh::MAX_LOD_LEVELS;
+
 CMesh::CMesh(const std::vector<Vertex> &vertices,
              const std::vector<unsigned int> &indices,
              std::shared_ptr<CTexture> pTexture)
-    : m_vertices(vertices), m_indices(indices), m_pTexture(pTexture)
+    : m_vertices(vertices), m_indices(indices), m_pTexture(pTexture), m_meshID(s_nextMeshID++)
 {
     if (m_vertices.empty())
     {
@@ -28,62 +43,60 @@ CMesh::~CMesh()
     // vector 会自动析构，shared_ptr 会自动减引用
 }
 
-void CMesh::Draw() const
+void CMesh::Draw(size_t lod) const
 {
     if (m_vertices.empty() || m_indices.empty())
         return;
 
-    // 保存当前OpenGL状态
-    glPushAttrib(GL_ENABLE_BIT | GL_TEXTURE_BIT | GL_CURRENT_BIT);
+    // 只设置本网格需要的状态，相邻网格相同的状态由缓存跳过；
+    // 保存与恢复由调用方负责（CModel::Draw 每个模型一次），这里不再逐网格 glPushAttrib
+    CGLStateCache &state = CGLStateCache::GetInstance();
 
-    // 0. 应用材质
-    glMaterialfv(GL_FRONT, GL_AMBIENT, m_material.ambient.GetData());
-    glMaterialfv(GL_FRONT, GL_DIFFUSE, m_material.diffuse.GetData());
-    glMaterialfv(GL_FRONT, GL_SPECULAR, m_material.specular.GetData());
-    glMaterialf(GL_FRONT, GL_SHININESS, m_material.shininess);
-
-    // 0.1 处理透明度（如果需要）
-    if (m_material.opacity < 1.0f)
-    {
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-        // 设置材质透明度
-        float ambientWithAlpha[] = {m_material.ambient.x, m_material.ambient.y,
-                                    m_material.ambient.z, m_material.opacity};
-        float diffuseWithAlpha[] = {m_material.diffuse.x, m_material.diffuse.y,
-                                    m_material.diffuse.z, m_material.opacity};
-        float specularWithAlpha[] = {m_material.specular.x, m_material.specular.y,
-                                     m_material.specular.z, m_material.opacity};
-
-        glMaterialfv(GL_FRONT, GL_AMBIENT, ambientWithAlpha);
-        glMaterialfv(GL_FRONT, GL_DIFFUSE, diffuseWithAlpha);
-        glMaterialfv(GL_FRONT, GL_SPECULAR, specularWithAlpha);
-    }
+    // 0. 应用材质（同时设置混合）
+    ApplyMaterial();
 
     // 1. 绑定纹理
+    state.ActiveTexture(GL_TEXTURE0);
     if (m_pTexture && m_pTexture->IsValid())
     {
-        glActiveTexture(GL_TEXTURE0); // 明确指定纹理单元
-        glEnable(GL_TEXTURE_2D);
-        m_pTexture->Bind(GL_TEXTURE0); // 传递纹理单元参数
-
-        // 设置纹理环境
-        glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+        state.Enable(GL_TEXTURE_2D);
+        state.BindTexture(m_pTexture->GetID());
+        state.SetTexEnvMode(GL_MODULATE);
     }
     else
     {
-        glActiveTexture(GL_TEXTURE0);
-        glDisable(GL_TEXTURE_2D);
-        glBindTexture(GL_TEXTURE_2D, 0); // 确保解绑
+        state.Disable(GL_TEXTURE_2D);
     }
 
     // 2. 启用顶点数组状态
-    glEnableClientState(GL_VERTEX_ARRAY);
-    glEnableClientState(GL_NORMAL_ARRAY);
-    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    state.SetClientState(GL_VERTEX_ARRAY, true);
+    state.SetClientState(GL_NORMAL_ARRAY, true);
+    state.SetClientState(GL_TEXTURE_COORD_ARRAY, true);
+
+    // 3. 设置指针并绘图
+    DrawGeometry(lod);
+}
+
+void CMesh::ApplyMaterial() const
+{
+    CGLStateCache &state = CGLStateCache::GetInstance();
+    state.SetEnabled(GL_BLEND, m_material.opacity < 1.0f);
+    if (m_material.opacity < 1.0f)
+        state.SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // 各分量的 alpha 取材质透明度
+    float ambient[] = {m_material.ambient.x, m_material.ambient.y, m_material.ambient.z, m_material.opacity};
+    float diffuse[] = {m_material.diffuse.x, m_material.diffuse.y, m_material.diffuse.z, m_material.opacity};
+    float specular[] = {m_material.specular.x, m_material.specular.y, m_material.specular.z, m_material.opacity};
+    state.SetMaterial(ambient, diffuse, specular, m_material.shininess);
+}
+
+void CMesh::DrawGeometry(size_t lod) const
+{
+    const std::vector<unsigned int> &indices = GetLODIndices(lod);
+    if (m_vertices.empty() || indices.empty())
+        return;
 
-    // 3. 设置指针
     // 注意：利用 sizeof(Vertex) 作为步长，并指向结构体成员的地址
     const GLsizei stride = sizeof(Vertex);
 
@@ -91,32 +104,87 @@ void CMesh::Draw() const
     glNormalPointer(GL_FLOAT, stride, &m_vertices[0].Normal);
     glTexCoordPointer(2, GL_FLOAT, stride, &m_vertices[0].TexCoords);
 
-    // 4. 绘图
-    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_indices.size()),
-                   GL_UNSIGNED_INT, m_indices.data());
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()),
+                   GL_UNSIGNED_INT, indices.data());
+}
+
+void CMesh::DrawGeometryInstanced(GLsizei instanceCount, size_t lod) const
+{
+    const std::vector<unsigned int> &indices = GetLODIndices(lod);
+    if (m_vertices.empty() || indices.empty() || instanceCount <= 0)
+        return;
+
+    const GLsizei stride = sizeof(Vertex);
+
+    glVertexPointer(3, GL_FLOAT, stride, &m_vertices[0].Position);
+    glNormalPointer(GL_FLOAT, stride, &m_vertices[0].Normal);
+    glTexCoordPointer(2, GL_FLOAT, stride, &m_vertices[0].TexCoords);
+
+    glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(indices.size()),
+                            GL_UNSIGNED_INT, indices.data(), instanceCount);
+}
 
-    // 5. 关闭状态
-    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-    glDisableClientState(GL_NORMAL_ARRAY);
-    glDisableClientState(GL_VERTEX_ARRAY);
+void CMesh::GenerateLODs(size_t maxLevels, float reduction, float maxError)
+{
+    m_lodLevels.clear();
+    maxLevels = std::min(maxLevels, MAX_LOD_LEVELS);
+    if (maxLevels < 2 || m_indices.size() / 3 < MIN_LOD_TRIANGLES * 2)
+        return;
 
-    // 6. 清理纹理状态
-    glActiveTexture(GL_TEXTURE0);
-    if (m_pTexture)
+    // 同一个简化器逐级继续折叠，误差沿链累积，每级都相对原始网格
+    const float radius = m_boundingBox.size.Length() * 0.5f;
+    CMeshSimplifier simplifier(&m_vertices[0].Position.x, m_vertices.size(), sizeof(Vertex),
+                               m_indices.data(), m_indices.size());
+    size_t previous = m_indices.size();
+    while (GetLODCount() < maxLevels)
     {
-        m_pTexture->Unbind(GL_TEXTURE0); // 解绑纹理
+        size_t target = (size_t)(previous / 3 * reduction) * 3;
+        if (target / 3 < MIN_LOD_TRIANGLES)
+            break;
+        simplifier.Simplify(target, maxError * radius);
+
+        // 减少不到 1/4 的级别不值得单独保存（多半被接缝、边界或误差上限卡住）
+        size_t count = simplifier.GetIndices().size();
+        if (count * 4 > previous * 3)
+            break;
+
+        LODLevel level;
+        level.indices = simplifier.GetIndices();
+        level.error = simplifier.GetError();
+        m_lodLevels.push_back(std::move(level));
+        previous = count;
     }
-    glBindTexture(GL_TEXTURE_2D, 0); // 双重保险
-    glDisable(GL_TEXTURE_2D);
+}
 
-    
-    // 6. 关闭混合（如果开启了）
-    if (m_material.opacity < 1.0f)
+const std::vector<unsigned int> &CMesh::GetLODIndices(size_t lod) const
+{
+    if (lod == 0 || m_lodLevels.empty())
+        return m_indices;
+    return m_lodLevels[std::min(lod, m_lodLevels.size()) - 1].indices;
+}
+
+float CMesh::GetLODError(size_t lod) const
+{
+    if (lod == 0 || m_lodLevels.empty())
+        return 0.0f;
+    return m_lodLevels[std::min(lod, m_lodLevels.size()) - 1].error;
+}
+
+uint32_t CMesh::GetMaterialID() const
+{
+    // 内容相同的材质共用一个编号，渲染队列按编号排序并跳过重复的 glMaterial
+    static std::unordered_map<std::wstring, uint32_t> s_materialIDs;
+    if (m_materialID == 0)
     {
-        glDisable(GL_BLEND);
+        auto result = s_materialIDs.emplace(m_material.GetHash(), (uint32_t)s_materialIDs.size() + 1);
+        m_materialID = result.first->second;
     }
-    
-    glPopAttrib();
+    return m_materialID;
+}
+
+GLuint CMesh::GetTextureID() const
+{
+    return m_pTexture && m_pTexture->IsValid() ? m_pTexture->GetID() : 0;
 }
 
 void CMesh::CalculateBoundingBox()
@@ -169,25 +237,33 @@ void CMesh::DrawNormals(float scale, unsigned int step, const Vector3 &color) co
     // 如果希望法线永远显示在模型前面（透视效果），取消下面这行的注释
     // glDisable(GL_DEPTH_TEST);
 
-    // 3. 开始绘制
+    // 3. 取出采样顶点，法线整段批量缩放为线段偏移
+    const size_t count = (m_vertices.size() + step - 1) / step;
+    std::vector<Vector3> starts(count), offsets(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        starts[i] = m_vertices[i * step].Position;
+        offsets[i] = m_vertices[i * step].Normal;
+    }
+    Math::Batch::TransformDirections(Matrix4::Scale(scale), offsets.data(), offsets.data(), count);
+
+    // 4. 开始绘制
     glLineWidth(1.0f);
     glBegin(GL_LINES);
-    for (size_t i = 0; i < m_vertices.size(); i += step)
+    for (size_t i = 0; i < count; ++i)
     {
-        const auto &v = m_vertices[i];
+        const Vector3 end = starts[i] + offsets[i];
 
         // 起点：红色
         glColor3f(color.x, color.y, color.z);
-        glVertex3f(v.Position.x, v.Position.y, v.Position.z);
+        glVertex3f(starts[i].x, starts[i].y, starts[i].z);
 
         // 终点：黄色
         glColor3f(1.0f, 1.0f, 0.0f);
-        glVertex3f(v.Position.x + v.Normal.x * scale,
-                   v.Position.y + v.Normal.y * scale,
-                   v.Position.z + v.Normal.z * scale);
+        glVertex3f(end.x, end.y, end.z);
     }
     glEnd();
 
-    // 4. 恢复状态
+    // 5. 恢复状态
     glPopAttrib();
 }
\ No newline at end of file
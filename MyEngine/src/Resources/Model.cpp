@@ -6,7 +6,13 @@
 #include "Resources/Model.h"
 #include "Resources/Mesh.h"
 #include "Resources/ResourceManager.h"
+#include "Core/GLStateCache.h"
+#include "Core/LODController.h"
+#include "Core/OcclusionBuffer.h"
+#include "Core/RenderQueue.h"
+#include "Core/StaticBatch.h"
 #include "Math/MathConverter.h"
+#include "Math/MathBatch.h"
 #include "Utils/StringUtils.h"
 // ======================================================================
 
@@ -89,7 +95,7 @@ BOOL CModel::LoadFromFile(const std::wstring &filePath, CResourceManager *pResMg
     else
         m_name = fullPath;
 
-    LogDebug(L"模型加载成功: %ls, 网格数: %d.\n", m_name.c_str(), (int)m_meshes.size());
+    LogDebug(L"模型加载成功: %ls, 网格数: %d, 细节级别: %d.\n", m_name.c_str(), (int)m_meshes.size(), (int)GetLODCount());
 
     return TRUE;
 }
@@ -103,6 +109,8 @@ void CModel::Unload()
     // 重置统计数据
     m_totalVertices = 0;
     m_totalTriangles = 0;
+    m_lodErrors.clear();
+    m_lodTriangles.clear();
 
     m_minBounds = Vector3(FLT_MAX, FLT_MAX, FLT_MAX);
     m_maxBounds = Vector3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
@@ -127,6 +135,24 @@ void CModel::AddMesh(std::shared_ptr<CMesh> pMesh)
     m_totalVertices += pMesh->GetVertexCount();
     m_totalTriangles += pMesh->GetTriangleCount();
 
+    // 级别数增加时，已有网格在新级别上取各自最粗的一级，正好等于原来最后一级的汇总
+    const size_t lodCount = pMesh->GetLODCount();
+    if (m_lodErrors.empty())
+    {
+        m_lodErrors.assign(lodCount, 0.0f);
+        m_lodTriangles.assign(lodCount, 0);
+    }
+    else if (lodCount > m_lodErrors.size())
+    {
+        m_lodErrors.resize(lodCount, m_lodErrors.back());
+        m_lodTriangles.resize(lodCount, m_lodTriangles.back());
+    }
+    for (size_t lod = 0; lod < m_lodErrors.size(); ++lod)
+    {
+        m_lodErrors[lod] = Math::Max(m_lodErrors[lod], pMesh->GetLODError(lod));
+        m_lodTriangles[lod] += pMesh->GetLODTriangleCount(lod);
+    }
+
     // 只需要拿 CMesh 的 Min/Max 更新 CModel 的 Min/Max
     const Vector3 &meshMin = pMesh->GetMinBounds();
     const Vector3 &meshMax = pMesh->GetMaxBounds();
@@ -311,6 +337,9 @@ std::shared_ptr<CMesh> CModel::ProcessMesh(aiMesh *mesh, const aiScene *scene, C
     // 7. 设置材质
     pMesh->SetMaterial(material);
 
+    // 8. 生成细节级别（只换索引，顶点共用）
+    pMesh->GenerateLODs();
+
     // 创建网格ID
     pMesh->SetSubMeshID(mesh->mMaterialIndex);
 
@@ -360,13 +389,14 @@ std::shared_ptr<CTexture> CModel::LoadMaterialTexture(aiMaterial *mat, aiTexture
     return pResMgr->GetTexture(fullPath, CResourceManager::PathType::Absolute);
 }
 
-void CModel::Draw() const
+void CModel::Draw(size_t lod) const
 {
     if (m_meshes.empty())
         return;
 
-    // 保存所有相关状态
-    glPushAttrib(GL_TEXTURE_BIT | GL_ENABLE_BIT | GL_CURRENT_BIT);
+    // 整个模型只保存一次网格会改动的状态（开关、颜色、纹理、材质、混合函数、顶点数组）
+    glPushAttrib(GL_TEXTURE_BIT | GL_ENABLE_BIT | GL_CURRENT_BIT | GL_LIGHTING_BIT | GL_COLOR_BUFFER_BIT);
+    glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
 
     // 保存当前矩阵
     glPushMatrix();
@@ -375,25 +405,83 @@ void CModel::Draw() const
     const Matrix4 &worldMat = GetWorldMatrix();
     glMultMatrixf(worldMat.GetData());
 
+    // 外部代码直接改动过状态，影子从未知开始；之后网格之间相同的状态不再重复设置
+    CGLStateCache &state = CGLStateCache::GetInstance();
+    state.Invalidate();
+
+    // 模型不受光照，纯白色确保纹理 1:1 输出
+    state.Disable(GL_LIGHTING);
+    state.SetColor(1.0f, 1.0f, 1.0f, 1.0f);
+
+    for (const auto &mesh : m_meshes)
+        mesh->Draw(lod);
+
+    // 恢复矩阵与状态，恢复后的状态影子不知道
+    glPopMatrix();
+    glPopClientAttrib();
+    glPopAttrib();
+    state.Invalidate();
+}
+
+void CModel::Enqueue(CRenderQueue &queue, const Matrix4 &parentWorld, size_t lod) const
+{
+    if (m_meshes.empty())
+        return;
+
+    Matrix4 world = parentWorld * GetWorldMatrix();
     for (const auto &mesh : m_meshes)
     {
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        Vector3 center = world * mesh->GetBoundingBox().center;
+        queue.Add(mesh.get(), mesh->GetMeshID(), world, center, mesh->GetMaterialID(), mesh->GetTextureID(), mesh->GetOpacity() < 1.0f,
+                  RenderPass::World, (uint32_t)std::min(lod, mesh->GetLODCount() - 1));
+    }
+}
 
-        mesh->Draw();
+size_t CModel::SelectLOD(CLODController &controller, const Matrix4 &parentWorld, size_t current) const
+{
+    size_t lod = controller.Select(m_lodErrors.data(), m_lodErrors.size(), parentWorld * GetWorldMatrix(),
+                                   m_center, m_radius, current);
+    controller.Record(lod, m_totalTriangles, GetLODTriangleCount(lod));
+    return lod;
+}
 
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, 0);
-        glDisable(GL_TEXTURE_2D);
+BOOL CModel::AddToStaticBatch(CStaticBatch &batch, const Matrix4 &parentWorld, unsigned int ownerID) const
+{
+    if (m_meshes.empty())
+        return FALSE;
+    for (const auto &mesh : m_meshes)
+    {
+        if (mesh->GetOpacity() < 1.0f)
+            return FALSE;
     }
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glDisable(GL_TEXTURE_2D);
+    Matrix4 world = parentWorld * GetWorldMatrix();
+    for (const auto &mesh : m_meshes)
+    {
+        const std::vector<Vertex> &vertices = mesh->GetVertices();
+        const std::vector<unsigned int> &indices = mesh->GetIndices();
+        batch.Add(vertices.data(), vertices.size(), indices.data(), indices.size(), world,
+                  mesh.get(), mesh->GetMaterialID(), mesh->GetTextureID(), ownerID);
+    }
+    return TRUE;
+}
 
-    // 恢复矩阵
-    glPopMatrix();
-    glPopAttrib(); // 恢复纹理状态
+BOOL CModel::AddToOcclusion(COcclusionBuffer &buffer, const Matrix4 &parentWorld) const
+{
+    Matrix4 world = parentWorld * GetWorldMatrix();
+    BOOL added = FALSE;
+    for (const auto &mesh : m_meshes)
+    {
+        if (mesh->GetOpacity() < 1.0f)
+            continue;
+        const std::vector<Vertex> &vertices = mesh->GetVertices();
+        const std::vector<unsigned int> &indices = mesh->GetLODIndices(0);
+        if (vertices.empty() || indices.empty())
+            continue;
+        buffer.AddOccluder(&vertices[0].Position.x, vertices.size(), sizeof(Vertex), indices.data(), indices.size(), world);
+        added = TRUE;
+    }
+    return added;
 }
 
 void CModel::SetPosition(const Vector3 &position)
@@ -421,12 +509,23 @@ const Matrix4 &CModel::GetWorldMatrix() const
         // 矩阵合成顺序：缩放 -> 旋转 -> 平移 (TRS)
         // 注意：矩阵乘法顺序取决于你的 Matrix4 实现，通常是 T * R * S
         m_transform = Matrix4::TRS(m_position, m_rotation, m_scale);
-        m_invTransform = m_transform.Inversed(); // 预先算好逆矩阵
         m_isDirty = FALSE;
+        m_isInvDirty = TRUE; // 逆矩阵延迟到查询时再算
     }
     return m_transform;
 }
 
+const Matrix4 &CModel::GetInverseWorldMatrix() const
+{
+    const Matrix4 &world = GetWorldMatrix();
+    if (m_isInvDirty)
+    {
+        m_invTransform = world.InversedAffine(); // TRS 必为仿射矩阵
+        m_isInvDirty = FALSE;
+    }
+    return m_invTransform;
+}
+
 void CModel::CalculateBoundingBox()
 {
     m_minBounds = Vector3(FLT_MAX, FLT_MAX, FLT_MAX);
@@ -458,12 +557,14 @@ void CModel::CalculateBoundingBox()
     m_radius = (m_maxBounds - m_minBounds).Length() * 0.5f;
 }
 
-BOOL CModel::IsPointInside(const Vector3 &point) const
+AABB CModel::GetWorldBounds() const
 {
-    Matrix4 invWorld = GetWorldMatrix().Inversed();
+    return Math::Batch::TransformAABB(GetWorldMatrix(), GetLocalBounds());
+}
 
-    Vector3 localPoint = invWorld * point;
-    // Vector3 localPoint = GetWorldMatrix().Invert().MultiplyPoint(point);
+BOOL CModel::IsPointInside(const Vector3 &point) const
+{
+    Vector3 localPoint = GetInverseWorldMatrix() * point;
 
     // 简单AABB检测
     return (localPoint.x >= m_minBounds.x && localPoint.x <= m_maxBounds.x &&
@@ -38,6 +38,9 @@ void CResourceManager::Shutdown()
 
     // 2. 清空所有弱引用容器
     m_Textures.clear();
+    for (auto &skybox : m_Skyboxes)
+        glDeleteTextures(1, &skybox.second);
+    m_Skyboxes.clear();
     m_Models.clear();
     m_Shaders.clear();
 
@@ -248,16 +251,7 @@ GLuint CResourceManager::LoadTexture(const std::wstring& filepath)
 
 std::shared_ptr<CModel> CResourceManager::GetModel(const std::wstring &filepath, PathType pathType)
 {
-    // 提取文件名
-    std::wstring fileName = filepath;
-    size_t lastSlash = filepath.find_last_of(L"/\\");
-    if (lastSlash != std::wstring::npos)
-    {
-        fileName = filepath.substr(lastSlash + 1);
-    }
-    // filename = Duck.obj
-
-    // 1. 缓存查找
+    // 1. 缓存查找（以传入路径为键，exp: Duck/Duck.obj）
     auto it = m_Models.find(filepath);
     if (it != m_Models.end())
     {
@@ -281,7 +275,7 @@ std::shared_ptr<CModel> CResourceManager::GetModel(const std::wstring &filepath,
     // 传入 this，允许 CModel 在加载过程中调用 GetTexture
     if (newModel->LoadFromFile(fullPath, this))
     {
-        m_Models[fileName] = newModel;
+        m_Models[filepath] = newModel;
         return newModel;
     }
 
@@ -442,6 +436,11 @@ GLuint CResourceManager::LoadSkybox(const std::wstring &skyboxName)
         L"nz.png"  // - negtive Z
     };
 
+    // 同名天空盒只加载一次（场景重启、读取快照时直接复用）
+    auto it = m_Skyboxes.find(skyboxName);
+    if (it != m_Skyboxes.end())
+        return it->second;
+
     std::wstring skyboxFolder = GetFullSkyboxPath(skyboxName + L"/");
 
     std::vector<std::wstring> fullPaths;
@@ -451,5 +450,8 @@ GLuint CResourceManager::LoadSkybox(const std::wstring &skyboxName)
         fullPaths.push_back(skyboxFolder + face);
     }
 
-    return LoadCubemapTexture(fullPaths);
+    GLuint textureID = LoadCubemapTexture(fullPaths);
+    if (textureID != 0)
+        m_Skyboxes[skyboxName] = textureID;
+    return textureID;
 }
\ No newline at end of file
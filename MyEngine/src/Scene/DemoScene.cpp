@@ -7,6 +7,7 @@
 #include "Core/GameEngine.h"
 #include "Core/InputManager.h"
 #include "Core/Entity.h"
+#include "Core/EntityComponents.h"
 #include "Graphics/Camera/Camera.h"
 #include "Resources/ResourceManager.h"
 #include "Entities/ModelEntity.h"
@@ -208,7 +209,7 @@ BOOL CDemoScene::Initialize()
 
     // ======================================================================
     // 1. 创建根实体
-    m_pRootEntity = CEntity::Create();
+    SetRootEntity(CEntity::Create());
     m_pRootEntity->SetName(L"DemoSceneRoot");
 
     // ======================================================================
@@ -218,6 +219,7 @@ BOOL CDemoScene::Initialize()
     {
         m_pSkybox = CSkyboxEntity::Create(skyboxTexture);
         m_pSkybox->SetName(L"WorldSkybox");
+        m_pSkybox->SetSkyboxName(L"day");
         m_pSkybox->SetSize(500.0f);        // 设置天空盒大小
         m_pSkybox->EnableRotation(TRUE);   // 启用旋转
         m_pSkybox->SetRotationSpeed(2.0f); // 设置旋转速度
@@ -286,6 +288,10 @@ BOOL CDemoScene::Initialize()
         m_pPossessedEntity = pDuckEntity;
     }
 
+    // ======================================================================
+    // 静态实体放置完毕，合并几何
+    BuildStaticBatch();
+
     // ======================================================================
     // 场景配置
     SetupFog(); // 启用雾化
@@ -305,11 +311,17 @@ void CDemoScene::Update(float deltaTime)
     // 1. 处理输入
     ProcessInput(deltaTime);
 
-    // 2. 驱动层更新
-    m_pRootEntity->Update(deltaTime);
+    // 2. 实体更新：贴地前后分组执行
+    m_TickScheduler.BeginFrame(deltaTime);
+    m_TickScheduler.RunGroup(TickGroup::PrePhysics);
+    m_TickScheduler.RunGroup(TickGroup::Update);
 
     // 3.实体更新逻辑
     UpdateLogic(deltaTime);
+
+    // 4. 贴地之后的逻辑与相机跟随
+    m_TickScheduler.RunGroup(TickGroup::PostUpdate);
+    m_TickScheduler.RunGroup(TickGroup::LateCamera);
 }
 
 // ======================================================================
@@ -342,11 +354,8 @@ void CDemoScene::Render()
     }
 
     // 驱动层级系统渲染
-    if (m_pRootEntity)
-    {
-        // 建议在 CSkyboxEntity::Render 内部手动关闭和开启雾
-        m_pRootEntity->Render();
-    }
+    // 建议在 CSkyboxEntity::Render 内部手动关闭和开启雾
+    RenderEntities();
 
     // DrawColorCube();    // 测试渲染
     // DrawTexturedCube(); // 测试贴图
@@ -354,11 +363,34 @@ void CDemoScene::Render()
 
 void CDemoScene::Shutdown()
 {
+    ReleaseStaticBatch();
     if (m_pRootEntity)
     {
         // 递归清理实体持有的资源或断开连接
-        m_pRootEntity = nullptr;
+        SetRootEntity(nullptr);
     }
+    m_Components.Clear();
+}
+
+void CDemoScene::OnSnapshotLoaded(const std::vector<std::shared_ptr<CEntity>> &entities)
+{
+    // 关键实体按名称找回（与 Initialize 中的命名一致）
+    m_pSkybox = std::dynamic_pointer_cast<CSkyboxEntity>(FindEntityByName(L"WorldSkybox"));
+    m_pTerrain = std::dynamic_pointer_cast<CTerrainEntity>(FindEntityByName(L"WorldTerrain"));
+    m_pGrid = std::dynamic_pointer_cast<CGridEntity>(FindEntityByName(L"WorldGrid"));
+    m_pPossessedEntity = std::dynamic_pointer_cast<CModelEntity>(FindEntityByName(L"MainDuck"));
+
+    // 组件不进快照，按实体的贴地开关重新登记
+    for (size_t i = 0; i < entities.size(); ++i)
+    {
+        if (entities[i]->IsAutoSnapEnabled())
+            RegisterEntityForSnapping(entities[i], TRUE);
+    }
+    // 静态标记随快照保存，静态实体的位置已是贴地后的结果
+    BuildStaticBatch();
+
+    SetupFog();
+    m_bInitialized = TRUE;
 }
 
 GLuint CDemoScene::LoadSkybox()
@@ -579,39 +611,59 @@ void CDemoScene::RegisterEntityForSnapping(std::shared_ptr<CEntity> pEntity, BOO
 
     if (isDynamic)
     {
-        auto it = std::find(m_DynamicSnapEntities.begin(), m_DynamicSnapEntities.end(), pEntity);
-        if (it == m_DynamicSnapEntities.end())
+        BOOL registered = FALSE;
+        unsigned int id = pEntity->GetID();
+        m_Components.Each<EntityLink, TerrainSnap>([&](EntityLink &link, TerrainSnap &) {
+            if (link.entityID == id)
+                registered = TRUE;
+        });
+        if (!registered)
         {
-            m_DynamicSnapEntities.push_back(pEntity);
+            // 上次贴地位置给个极大值，确保第一帧必执行
+            EntityLink link = {id, pEntity->GetTransformHandle()};
+            TerrainSnap snap = {99999.0f, 99999.0f};
+            m_Components.Create(link, snap);
             // LogInfo(L"已注册动态贴地实体: %s\n", pEntity->GetName().c_str());
         }
     }
     else
     {
-        // 静态物体：直接执行一次贴地，后续不再计算
+        // 静态物体：直接执行一次贴地，后续不再计算，并参与静态合批（BuildStaticBatch）
         Vector3 pos = pEntity->GetPosition();
         float h = m_pTerrain->GetGroundHeight(pos);
         pEntity->SetPosition(Vector3(pos.x, h + pEntity->GetGroundOffset(), pos.z));
+        pEntity->SetStatic(TRUE);
     }
 }
 
 void CDemoScene::UpdateAutoSnapping()
 {
-    if (!m_pTerrain || m_DynamicSnapEntities.empty())
+    if (!m_pTerrain)
         return;
 
     const float moveThresholdSq = 0.1f * 0.1f;
+    CTransformStore &transforms = CTransformStore::GetInstance();
 
-    for (auto &pEntity : m_DynamicSnapEntities)
-    {
-        if (pEntity && pEntity->IsAutoSnapEnabled())
+    // 按块线性遍历贴地组件，位置直接从 CTransformStore 读取
+    // 开关与偏移每帧从实体读取：关闭贴地的实体保留关联、只是跳过，重新开启后继续贴地
+    m_StaleSnapLinks.clear();
+    m_Components.EachChunk<EntityLink, TerrainSnap>([&](size_t count, const CComponentStore::Entity *entities, EntityLink *links, TerrainSnap *snaps) {
+        for (size_t i = 0; i < count; ++i)
         {
-            Vector3 currentPos = pEntity->GetPosition();
-            Vector3 lastPos = pEntity->GetLastSnapPos();
+            CEntity *pEntity = CEntity::Find(links[i].entityID);
+            if (!pEntity)
+            {
+                m_StaleSnapLinks.push_back(entities[i]);
+                continue;
+            }
+            if (!pEntity->IsAutoSnapEnabled())
+                continue;
+
+            Vector3 currentPos = transforms.GetLocalPosition(links[i].transform);
 
             // 计算水平面(X,Z)上的位移平方
-            float dx = currentPos.x - lastPos.x;
-            float dz = currentPos.z - lastPos.z;
+            float dx = currentPos.x - snaps[i].lastX;
+            float dz = currentPos.z - snaps[i].lastZ;
             float distSq = dx * dx + dz * dz;
 
             // 位移阈值判断
@@ -623,8 +675,13 @@ void CDemoScene::UpdateAutoSnapping()
                 pEntity->SetPosition(Vector3(currentPos.x, h + pEntity->GetGroundOffset(), currentPos.z));
 
                 // 【关键修复】：更新最后记录的位置，防止下一帧重复进入
-                pEntity->SetLastSnapPos(currentPos);
+                snaps[i].lastX = currentPos.x;
+                snaps[i].lastZ = currentPos.z;
             }
         }
-    }
+    });
+
+    // 遍历中不能增删，结束后再移除已失效的关联
+    for (size_t i = 0; i < m_StaleSnapLinks.size(); ++i)
+        m_Components.Destroy(m_StaleSnapLinks[i]);
 }
\ No newline at end of file
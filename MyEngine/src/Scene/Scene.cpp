@@ -0,0 +1,217 @@
+// ======================================================================
+#include "stdafx.h"
+#include "Scene/Scene.h"
+#include "Core/GameEngine.h"
+#include "Core/Renderer.h"
+#include "Core/SceneSnapshot.h"
+#include "Entities/CameraEntity.h"
+#include "Entities/GridEntity.h"
+#include "Entities/ModelEntity.h"
+#include "Entities/SkyboxEntity.h"
+#include "Entities/TerrainEntity.h"
+#include "Utils/StringUtils.h"
+// ======================================================================
+
+namespace
+{
+    void WriteSubtree(const CEntity *pEntity, int32_t parent, CSceneSnapshotWriter &writer)
+    {
+        uint32_t index = writer.AddEntity((uint32_t)pEntity->GetType(), parent);
+        pEntity->WriteSnapshot(writer, index);
+
+        const std::vector<std::shared_ptr<CEntity>> &children = pEntity->GetChildren();
+        for (size_t i = 0; i < children.size(); ++i)
+            WriteSubtree(children[i].get(), (int32_t)index, writer);
+    }
+
+    std::shared_ptr<CEntity> CreateEntity(const SnapshotEntity &record)
+    {
+        switch ((EntityType)record.type)
+        {
+        case EntityType::Model:
+            return CModelEntity::CreateFromSnapshot(record);
+        case EntityType::Terrain:
+            return CTerrainEntity::CreateFromSnapshot(record);
+        case EntityType::Grid:
+            return CGridEntity::CreateFromSnapshot(record);
+        case EntityType::Skybox:
+            return CSkyboxEntity::CreateFromSnapshot(record);
+        case EntityType::Camera:
+            return CCameraEntity::CreateFromSnapshot(record);
+        case EntityType::Entity:
+            return CEntity::CreateFromSnapshot(record);
+        }
+        LogWarning(L"快照中未知的实体类型: %u, 按普通实体处理.\n", record.type);
+        return CEntity::CreateFromSnapshot(record);
+    }
+}
+
+const CullStats &CScene::CullEntities(const Frustum &frustum, const Matrix4 *pViewProjection)
+{
+    // 帧号递增后，上一帧的标记全部失效，不需要逐个清除
+    uint32_t frame = m_SpatialIndex.BeginView();
+    m_VisibleIDs.clear();
+    m_SpatialIndex.QueryFrustum(frustum, m_VisibleIDs);
+
+    m_CullStats.tested = m_SpatialIndex.GetCount();
+    m_CullStats.culled = m_CullStats.tested - m_VisibleIDs.size();
+    m_CullStats.occluded = 0;
+    m_CullStats.occluders = 0;
+
+    if (!pViewProjection || !m_bOcclusionCulling)
+    {
+        for (size_t i = 0; i < m_VisibleIDs.size(); ++i)
+        {
+            if (CEntity *pEntity = CEntity::Find(m_VisibleIDs[i]))
+                pEntity->MarkInView(frame);
+        }
+        m_CullStats.visible = m_VisibleIDs.size();
+        return m_CullStats;
+    }
+
+    // 1. 视锥内的遮挡体画进深度图（几何由实体持有，光栅化期间不变）；隐藏的子树不画也不遮挡
+    CJobSystem *pJobs = CGameEngine::GetInstance().GetJobSystem();
+    m_OcclusionBuffer.Begin(*pViewProjection);
+    m_OccludeeBounds.clear();
+    m_OccludeeIDs.clear();
+    for (size_t i = 0; i < m_VisibleIDs.size(); ++i)
+    {
+        CEntity *pEntity = CEntity::Find(m_VisibleIDs[i]);
+        if (!pEntity)
+            continue;
+        if (pEntity->IsOccluder() && pEntity->IsVisibleInHierarchy() && pEntity->AddOccluder(m_OcclusionBuffer))
+            ++m_CullStats.occluders;
+
+        AABB bounds;
+        if (pEntity->GetWorldBounds(bounds))
+        {
+            m_OccludeeBounds.push_back(bounds);
+            m_OccludeeIDs.push_back(m_VisibleIDs[i]);
+        }
+    }
+    m_OcclusionBuffer.Rasterize(pJobs);
+
+    // 2. 视锥内的实体（包括遮挡体自身）逐个测试，没有被挡住的才标记
+    m_OccludeeResults.resize(m_OccludeeIDs.size());
+    if (!m_OccludeeIDs.empty())
+        m_CullStats.occluded = m_OcclusionBuffer.TestAABBs(m_OccludeeBounds.data(), m_OccludeeBounds.size(), m_OccludeeResults.data(), pJobs);
+    for (size_t i = 0; i < m_OccludeeIDs.size(); ++i)
+    {
+        if (m_OccludeeResults[i])
+            continue;
+        if (CEntity *pEntity = CEntity::Find(m_OccludeeIDs[i]))
+            pEntity->MarkInView(frame);
+    }
+    m_CullStats.visible = m_VisibleIDs.size() - m_CullStats.occluded;
+    return m_CullStats;
+}
+
+void CScene::RenderEntities()
+{
+    if (!m_pRootEntity)
+        return;
+
+    m_RenderQueue.Begin();
+    m_LODController.Begin();
+    m_pRootEntity->Render();
+    m_LODController.End();
+    m_RenderQueue.End();
+
+    // 静态合批只画所属实体（连同祖先）可见且在视锥内的部件（合批中只有不透明网格，先于队列绘制）
+    m_StaticDraws.clear();
+    size_t parts = m_StaticBatch.CollectDraws([](unsigned int id) {
+        CEntity *pEntity = CEntity::Find(id);
+        return pEntity && pEntity->IsInView() && pEntity->IsVisibleInHierarchy();
+    }, m_StaticDraws);
+
+    if (CRenderer *pRenderer = CGameEngine::GetInstance().GetRenderer())
+    {
+        m_StaticStats = pRenderer->SubmitStaticBatch(m_StaticBatch, m_StaticDraws);
+        m_StaticStats.instances = parts;
+        m_RenderStats = pRenderer->SubmitQueue(m_RenderQueue);
+    }
+}
+
+void CScene::BuildStaticBatch()
+{
+    ReleaseStaticBatch();
+    if (!m_pRootEntity)
+        return;
+
+    m_pRootEntity->CollectStaticBatch(&m_StaticBatch);
+    m_StaticBatch.Build();
+    if (m_StaticBatch.IsEmpty())
+        return;
+
+    if (CRenderer *pRenderer = CGameEngine::GetInstance().GetRenderer())
+        pRenderer->UploadStaticBatch(m_StaticBatch);
+    LogInfo(L"静态合批: %u 个部件, %u 组, %u 个三角形\n", (unsigned)m_StaticBatch.GetRanges().size(),
+            (unsigned)m_StaticBatch.GetGroups().size(), (unsigned)(m_StaticBatch.GetIndices().size() / 3));
+}
+
+void CScene::ReleaseStaticBatch()
+{
+    if (CRenderer *pRenderer = CGameEngine::GetInstance().GetRenderer())
+        pRenderer->ReleaseStaticBatch(m_StaticBatch);
+    m_StaticBatch.Clear();
+    m_StaticStats = {};
+    if (m_pRootEntity)
+        m_pRootEntity->CollectStaticBatch(nullptr);
+}
+
+BOOL CScene::SaveSnapshot(const std::wstring &path) const
+{
+    if (!m_pRootEntity)
+        return FALSE;
+
+    CSceneSnapshotWriter writer;
+    WriteSubtree(m_pRootEntity.get(), -1, writer);
+    if (!writer.Save(CStringUtils::WStringToString(path, CP_UTF8)))
+    {
+        LogError(L"场景快照保存失败: %ls.\n", path.c_str());
+        return FALSE;
+    }
+
+    LogInfo(L"场景快照已保存: %ls. 实体数: %u\n", path.c_str(), writer.GetEntityCount());
+    return TRUE;
+}
+
+BOOL CScene::LoadSnapshot(const std::wstring &path)
+{
+    CSceneSnapshot snapshot;
+    if (!snapshot.Load(CStringUtils::WStringToString(path, CP_UTF8)))
+    {
+        LogWarning(L"场景快照无法加载: %ls.\n", path.c_str());
+        return FALSE;
+    }
+
+    // 1. 先建新树再关旧场景：旧场景持有的模型、纹理仍在资源缓存中，可以直接复用
+    // 记录父先子后，按记录顺序挂接即可保持子节点顺序
+    uint32_t count = snapshot.GetEntityCount();
+    const SnapshotEntity *pRecords = snapshot.GetEntities();
+    std::vector<std::shared_ptr<CEntity>> entities(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        entities[i] = CreateEntity(pRecords[i]);
+        if (pRecords[i].parent >= 0)
+            entities[pRecords[i].parent]->AddChild(entities[i]);
+    }
+
+    // 2. 替换根实体
+    std::shared_ptr<CEntity> pRoot;
+    if (count > 0 && pRecords[0].parent < 0)
+        pRoot = entities[0];
+    if (!pRoot)
+    {
+        LogWarning(L"场景快照中没有根实体: %ls.\n", path.c_str());
+        return FALSE;
+    }
+
+    Shutdown();
+    SetRootEntity(pRoot);
+    OnSnapshotLoaded(entities);
+
+    LogInfo(L"场景快照已加载: %ls. 实体数: %u, 文件大小: %u 字节\n",
+            path.c_str(), count, (unsigned int)snapshot.GetFileSize());
+    return TRUE;
+}
@@ -8,8 +8,13 @@
 #include "Resources/ResourceManager.h"
 #include "Resources/Model.h"
 #include "Core/Entity.h"
+#include "Utils/StringUtils.h"
 // ======================================================================
 
+namespace
+{
+    const wchar_t *SNAPSHOT_DIR = L"saves";
+}
 
 // ======================================================================
 // =========================== 公有方法 ==================================
@@ -43,6 +48,7 @@ BOOL CSceneManager::Initialize()
     m_CurrentScene = nullptr;
     m_NextScene = nullptr;
     m_SceneChangePending = FALSE;
+    m_RestartPending = FALSE;
     m_Paused = FALSE;
     m_UpdateEnabled = TRUE;
     m_RenderEnabled = TRUE;
@@ -200,6 +206,7 @@ BOOL CSceneManager::ChangeSceneImmediate(const std::string &sceneName)
         {
             return FALSE;
         }
+        SaveInitialSnapshot(newScene);
     }
 
     // 切换到新场景
@@ -274,7 +281,17 @@ void CSceneManager::RestartCurrentScene(BOOL withTransition)
     if (!m_CurrentScene)
         return;
 
-    ChangeScene(m_CurrentScene->GetName(), withTransition);
+    if (withTransition)
+    {
+        // 黑屏时在 PerformSceneChange 中恢复初始状态
+        if (ChangeScene(m_CurrentScene->GetName(), TRUE))
+            m_RestartPending = TRUE;
+        return;
+    }
+
+    m_CurrentScene->OnDeactivate();
+    RestoreInitialState(m_CurrentScene);
+    m_CurrentScene->OnActivate();
 }
 
 void CSceneManager::PerformSceneChange()
@@ -288,6 +305,13 @@ void CSceneManager::PerformSceneChange()
         m_CurrentScene->OnDeactivate();
     }
 
+    // 重启：恢复初始状态
+    if (m_RestartPending && m_NextScene == m_CurrentScene)
+    {
+        RestoreInitialState(m_NextScene);
+    }
+    m_RestartPending = FALSE;
+
     // 初始化新场景（如果尚未初始化）
     if (!m_NextScene->IsInitialized())
     {
@@ -303,6 +327,7 @@ void CSceneManager::PerformSceneChange()
             m_TransitionState = TransitionState::None;
             return;
         }
+        SaveInitialSnapshot(m_NextScene);
     }
 
     // 切换到新场景
@@ -334,7 +359,11 @@ void CSceneManager::ReloadCurrentScene()
     if (!m_CurrentScene)
         return;
 
-    // m_CurrentScene->Reload();
+    // 优先读回保存的状态，没有时回到初始状态
+    m_CurrentScene->OnDeactivate();
+    if (!m_CurrentScene->LoadSnapshot(GetSnapshotPath(m_CurrentScene->GetName(), FALSE)))
+        RestoreInitialState(m_CurrentScene);
+    m_CurrentScene->OnActivate();
 }
 
 void CSceneManager::Update(FLOAT deltaTime)
@@ -511,15 +540,51 @@ void CSceneManager::CleanupUnusedScenes()
 
 BOOL CSceneManager::SaveCurrentSceneState()
 {
-    // 这是一个占位函数，具体实现取决于场景的设计
-    // 子类可以重写此函数来实现具体的状态保存逻辑
-    return TRUE;
+    if (!m_CurrentScene)
+        return FALSE;
+
+    CreateDirectoryW(SNAPSHOT_DIR, nullptr);
+    return m_CurrentScene->SaveSnapshot(GetSnapshotPath(m_CurrentScene->GetName(), FALSE));
 }
 
 BOOL CSceneManager::LoadSavedSceneState()
 {
-    // 这是一个占位函数，具体实现取决于场景的设计
-    // 子类可以重写此函数来实现具体的状态加载逻辑
+    if (!m_CurrentScene)
+        return FALSE;
+
+    m_CurrentScene->OnDeactivate();
+    BOOL loaded = m_CurrentScene->LoadSnapshot(GetSnapshotPath(m_CurrentScene->GetName(), FALSE));
+    m_CurrentScene->OnActivate();
+    return loaded;
+}
+
+// ======================================================================
+// 场景快照
+// ======================================================================
+std::wstring CSceneManager::GetSnapshotPath(const std::string &sceneName, BOOL initial) const
+{
+    // exp: saves/DemoScene.snap, saves/DemoScene.initial.snap
+    std::wstring path = std::wstring(SNAPSHOT_DIR) + L"/" + CStringUtils::StringToWString(sceneName);
+    return path + (initial ? L".initial.snap" : L".snap");
+}
+
+void CSceneManager::SaveInitialSnapshot(std::shared_ptr<CScene> scene)
+{
+    // 每次运行首次初始化时重写，资源或场景代码改动后不会读到过期内容
+    CreateDirectoryW(SNAPSHOT_DIR, nullptr);
+    scene->SaveSnapshot(GetSnapshotPath(scene->GetName(), TRUE));
+}
+
+BOOL CSceneManager::RestoreInitialState(std::shared_ptr<CScene> scene)
+{
+    if (scene->LoadSnapshot(GetSnapshotPath(scene->GetName(), TRUE)))
+        return TRUE;
+
+    // 没有可用的初始快照：重新初始化
+    scene->Shutdown();
+    if (!scene->Initialize())
+        return FALSE;
+    SaveInitialSnapshot(scene);
     return TRUE;
 }
 